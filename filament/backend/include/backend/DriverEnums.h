@@ -541,6 +541,7 @@ enum class TextureUsage : uint8_t {
     UPLOADABLE          = 0x8,                      //!< Data can be uploaded into this texture (default)
     SAMPLEABLE          = 0x10,                     //!< Texture can be sampled (default)
     SUBPASS_INPUT       = 0x20,                     //!< Texture can be used as a subpass input
+    TRANSIENT           = 0x40,                     //!< Texture content doesn't persist across frames, backends may alias its memory
     DEFAULT             = UPLOADABLE | SAMPLEABLE   //!< Default texture usage
 };
 
@@ -970,6 +971,25 @@ enum class Workaround : uint16_t {
     SPLIT_EASU
 };
 
+/**
+ * Usage of the driver's handle arena, one entry per size-class pool plus the heap
+ * overflow map used when a pool is exhausted. Counts are in handles. The counters are
+ * not synchronized with the allocating threads, so the values are approximate.
+ *
+ * @see Engine::getHandleAllocatorStats()
+ */
+struct HandleAllocatorStats {
+    static constexpr size_t POOL_COUNT = 3;
+    struct Pool {
+        uint32_t elementSize = 0;       //!< size class, in bytes
+        uint32_t capacity = 0;          //!< number of handles the pool can hold
+        uint32_t used = 0;              //!< handles currently allocated
+        uint32_t highWatermark = 0;     //!< most handles ever allocated simultaneously
+    } pools[POOL_COUNT];
+    uint32_t overflowUsed = 0;          //!< handles currently in the (slow) heap map
+    uint32_t overflowHighWatermark = 0; //!< most handles ever in the heap map
+};
+
 } // namespace backend
 } // namespace filament
 
@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_BACKEND_PRIVATE_CAPTURESTREAM_H
+#define TNT_FILAMENT_BACKEND_PRIVATE_CAPTURESTREAM_H
+
+#include <backend/BufferDescriptor.h>
+#include <backend/DriverEnums.h>
+#include <backend/Handle.h>
+#include <backend/PipelineState.h>
+#include <backend/PixelBufferDescriptor.h>
+#include <backend/TargetBufferInfo.h>
+
+#include "private/backend/Program.h"
+#include "private/backend/SamplerGroup.h"
+
+#include <utils/compiler.h>
+#include <utils/CString.h>
+
+#include <tsl/robin_map.h>
+
+#include <deque>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+namespace filament {
+namespace backend {
+
+class CommandStream;
+
+/*
+ * Identifies one DriverApi method in a capture file. The values are generated from
+ * DriverAPI.inc, so captures can only be replayed by a build with the same API list --
+ * the capture format is a debugging/profiling artifact, not an interchange format.
+ */
+enum class CaptureCommand : uint16_t {
+#define DECL_DRIVER_API(methodName, paramsDecl, params) methodName,
+#define DECL_DRIVER_API_SYNCHRONOUS(RetType, methodName, paramsDecl, params)
+#define DECL_DRIVER_API_RETURN(RetType, methodName, paramsDecl, params) methodName,
+#include "DriverAPI.inc"
+    COUNT
+};
+
+/*
+ * CaptureRecorder serializes the asynchronous command stream to a file, so that a
+ * workload can be replayed later against any backend (see CaptureReplayer). Attach it
+ * with CommandStream::setCapturer(); every command written afterwards is appended to the
+ * capture, including the full payload of buffer updates, texture uploads, sampler groups
+ * and programs. Handles are recorded by id and translated back at replay time.
+ *
+ * A capture is only self-contained if recording starts before any resource is created,
+ * i.e. when the recorder is attached during engine initialization. There is no "initial
+ * state" snapshot: commands that reference resources created before the recorder was
+ * attached replay as null handles.
+ *
+ * The file format is a small header (magic, version) followed by one record per command:
+ * a CaptureCommand id, the payload size, and the arguments in declaration order. Each
+ * record of a method that returns a handle stores the returned id before the arguments.
+ *
+ * Synchronous driver methods (queries, fences) and custom commands are not part of the
+ * capture; neither are commands that reference process-local state such as callbacks,
+ * external images or client-owned read-back buffers (see isSkipped()).
+ */
+class CaptureRecorder {
+public:
+    /*
+     * Opens `path` for writing and records until `frameCount` commit() commands have
+     * been seen, or until finish() is called when frameCount is 0. Check isOpen() to
+     * find out whether the file could be created.
+     */
+    CaptureRecorder(const char* path, uint32_t frameCount);
+    ~CaptureRecorder() noexcept;
+
+    CaptureRecorder(CaptureRecorder const&) = delete;
+    CaptureRecorder& operator=(CaptureRecorder const&) = delete;
+
+    bool isOpen() const noexcept { return mFile != nullptr; }
+    bool isFinished() const noexcept { return mFinished; }
+    uint32_t getRecordedFrameCount() const noexcept { return mRecordedFrames; }
+
+    // Closes the capture file. Subsequent record() calls are ignored. Called
+    // automatically once the requested number of frames has been recorded.
+    void finish() noexcept;
+
+    /*
+     * Appends one command to the capture. Called by CommandStream for every asynchronous
+     * driver command; must be called from the thread that writes the command stream.
+     */
+    template<typename... ARGS>
+    void record(CaptureCommand command, ARGS const&... args) {
+        if (UTILS_UNLIKELY(mFinished || isSkipped(command))) {
+            return;
+        }
+        mScratch.clear();
+        (writeArg(args), ...);
+        endRecord(command);
+    }
+
+private:
+    // Commands that reference process-local state (callbacks, external images,
+    // client-owned read-back buffers) can't be reproduced and are left out.
+    static bool isSkipped(CaptureCommand command) noexcept;
+
+    // trivially copyable arguments (scalars, enums, POD structs) are stored verbatim
+    template<typename T, typename = std::enable_if_t<std::is_trivially_copyable<T>::value>>
+    void writeArg(T const& value) { writeBytes(&value, sizeof(T)); }
+
+    // handles and handle-carrying structs are stored as HandleIds
+    void writeArg(HandleBase const& handle);
+    void writeArg(FaceOffsets const& offsets); // POD in all but the formal sense
+    void writeArg(TargetBufferInfo const& info);
+    void writeArg(MRT const& mrt);
+    void writeArg(PipelineState const& state);
+
+    // buffer-like arguments are stored with their full payload
+    void writeArg(BufferDescriptor const& buffer);
+    void writeArg(PixelBufferDescriptor const& buffer);
+    void writeArg(SamplerGroup const& group);
+    void writeArg(Program const& program);
+
+    void writeArg(utils::CString const& string);
+    void writeArg(const char* string);
+    void writeArg(void* nativeWindow) {} // substituted at replay time, see CaptureReplayer
+
+    void writeBytes(void const* data, size_t size);
+    void endRecord(CaptureCommand command) noexcept;
+
+    FILE* mFile = nullptr;
+    std::vector<uint8_t> mScratch;
+    uint32_t mFrameLimit = 0;
+    uint32_t mRecordedFrames = 0;
+    bool mFinished = true;
+};
+
+/*
+ * CaptureReplayer reads a capture file produced by CaptureRecorder and re-issues its
+ * commands into a DriverApi, one frame at a time. Handle ids recorded in the file are
+ * translated to the handles returned by the replaying driver as creation commands are
+ * replayed, so a capture taken on one backend can be played against another.
+ *
+ * Commands are written to the CommandStream but not executed; the caller is responsible
+ * for flushing and executing the command buffer after each frame, exactly as the engine
+ * does for its own commands (see tools/capreplay for a complete example).
+ */
+class CaptureReplayer {
+public:
+    CaptureReplayer() noexcept = default;
+    ~CaptureReplayer() noexcept;
+
+    CaptureReplayer(CaptureReplayer const&) = delete;
+    CaptureReplayer& operator=(CaptureReplayer const&) = delete;
+
+    /*
+     * Substitute for the native window that was recorded with createSwapChain(). When
+     * left null, swap chains replay as headless swap chains of the given size.
+     */
+    void setNativeWindow(void* window) noexcept { mNativeWindow = window; }
+    void setHeadlessSize(uint32_t width, uint32_t height) noexcept {
+        mHeadlessWidth = width;
+        mHeadlessHeight = height;
+    }
+
+    // Opens a capture file. Returns false if the file can't be read or has the wrong
+    // format version.
+    bool open(const char* path);
+
+    /*
+     * Replays commands up to and including the next commit(). Returns false when the
+     * capture is exhausted or a read error occurred.
+     */
+    bool replayFrame(CommandStream& api);
+
+    uint32_t getReplayedFrameCount() const noexcept { return mReplayedFrames; }
+
+private:
+    template<typename R, typename... ARGS>
+    void replayApi(R (CommandStream::*method)(ARGS...), CommandStream& api);
+
+    template<typename T>
+    T readArg();
+
+    // translates a recorded handle id to the id returned by the replaying driver
+    HandleBase::HandleId mapHandle(HandleBase::HandleId recorded) noexcept;
+
+    template<typename H>
+    H remapHandle() {
+        HandleBase::HandleId const id = mapHandle(read<HandleBase::HandleId>());
+        return id == HandleBase::nullid ? H{} : H{ id };
+    }
+
+    template<typename T>
+    T read() {
+        static_assert(std::is_trivially_copyable<T>::value);
+        T value{};
+        readBytes(&value, sizeof(T));
+        return value;
+    }
+
+    bool readBytes(void* data, size_t size) noexcept;
+
+    FILE* mFile = nullptr;
+    bool mError = false;
+    uint32_t mReplayedFrames = 0;
+    void* mNativeWindow = nullptr;
+    uint32_t mHeadlessWidth = 1920;
+    uint32_t mHeadlessHeight = 1080;
+    tsl::robin_map<HandleBase::HandleId, HandleBase::HandleId> mHandleMap;
+    // backing store for `const char*` arguments of the record being replayed
+    // (std::deque: growth doesn't invalidate references to existing elements)
+    std::deque<std::string> mStrings;
+};
+
+} // namespace backend
+} // namespace filament
+
+#endif // TNT_FILAMENT_BACKEND_PRIVATE_CAPTURESTREAM_H
@@ -64,18 +64,28 @@ public:
 
     void* getTail() const noexcept { return mTail; }
 
+    // incremented each time the buffer is circularized; allows clients to detect that
+    // previously allocated storage may no longer be appended to (e.g. it's been handed
+    // off to the consumer)
+    uint32_t getGeneration() const noexcept { return mGeneration; }
+
     // call at least once every getRequiredSize() bytes allocated from the buffer
     void circularize() noexcept;
 
+    // Remaps the buffer with a new capacity. This invalidates every pointer previously
+    // returned by allocate(), so it may only be called when the buffer is empty and the
+    // consumer no longer references any slice of it.
+    void resize(size_t bufferSize) noexcept;
+
 private:
     void* alloc(size_t size) noexcept;
     void dealloc() noexcept;
 
-    // pointer to the beginning of the circular buffer (constant)
+    // pointer to the beginning of the circular buffer (only changes in resize())
     void* mData = nullptr;
     int mUsesAshmem = -1;
 
-    // size of the circular buffer (constant)
+    // size of the circular buffer (only changes in resize())
     size_t mSize = 0;
 
     // pointer to the beginning of recorded data
@@ -83,6 +93,9 @@ private:
 
     // pointer to the next available command
     void* mHead = nullptr;
+
+    // see getGeneration()
+    uint32_t mGeneration = 0;
 };
 
 } // namespace backend
@@ -23,13 +23,20 @@
 #include <utils/Condition.h>
 #include <utils/Mutex.h>
 
+#include <atomic>
 #include <vector>
 
 namespace filament {
 namespace backend {
 
 /*
- * A producer-consumer command queue that uses a CircularBuffer as main storage
+ * A producer-consumer command queue that uses a CircularBuffer as main storage.
+ *
+ * There is a single producer (the main thread) and a single consumer (the backend
+ * thread), so slices are published through a lock-free SPSC ring with atomic
+ * head/tail indices; the mutex and condition below are only used to park/unpark
+ * either thread (consumer waiting for commands, producer waiting for free space or
+ * a full ring), never on the fast path.
  */
 class CommandBufferQueue {
     struct Slice {
@@ -39,16 +46,33 @@ class CommandBufferQueue {
 
     const size_t mRequiredSize;
 
+    // growth cap for the circular buffer; guards against runaway growth if the
+    // application leaks commands
+    const size_t mMaxBufferSize;
+
     CircularBuffer mCircularBuffer;
 
+    // SPSC slice ring; sized so the consumer can lag many flushes behind before the
+    // producer ever has to block.
+    static constexpr uint32_t SLICE_COUNT = 32;
+    mutable Slice mSlices[SLICE_COUNT];
+    mutable std::atomic<uint32_t> mSliceHead = { 0 };   // written by the producer
+    mutable std::atomic<uint32_t> mSliceTail = { 0 };   // written by the consumer
+
     // space available in the circular buffer
+    std::atomic<size_t> mFreeSpace = { 0 };
 
     mutable utils::Mutex mLock;
     mutable utils::Condition mCondition;
-    mutable std::vector<Slice> mCommandBuffersToExecute;
-    size_t mFreeSpace = 0;
+    mutable std::atomic<bool> mConsumerParked = { false };
+    std::atomic<bool> mProducerWaiting = { false };
+    std::atomic<uint32_t> mExitRequested = { 0 };
+
+    // occupancy telemetry, written by the producer in flush()
     size_t mHighWatermark = 0;
-    uint32_t mExitRequested = 0;
+    size_t mLastOccupancy = 0;
+    size_t mPendingBufferSize = 0;
+    uint32_t mGrowthCount = 0;
 
     static constexpr uint32_t EXIT_REQUESTED = 0x31415926;
 
@@ -61,6 +85,18 @@ public:
 
     size_t getHighWatermark() const noexcept { return mHighWatermark; }
 
+    // Occupancy of the circular buffer, updated by each flush(). Must be read from the
+    // producer thread.
+    struct Occupancy {
+        size_t bufferSize;      //!< current ring capacity; can grow over time
+        size_t used;            //!< bytes in flight after the last flush()
+        size_t highWatermark;   //!< highest bytes-in-flight observed
+        uint32_t growthCount;   //!< number of times the ring was remapped larger
+    };
+    Occupancy getOccupancy() const noexcept {
+        return { mCircularBuffer.size(), mLastOccupancy, mHighWatermark, mGrowthCount };
+    }
+
     // wait for commands to be available and returns an array containing these commands
     std::vector<Slice> waitForCommands() const;
 
@@ -28,6 +28,7 @@
 #include <backend/PresentCallable.h>
 #include <backend/TargetBufferInfo.h>
 
+#include "private/backend/CaptureStream.h"
 #include "private/backend/Program.h"
 #include "private/backend/SamplerGroup.h"
 
@@ -40,6 +41,7 @@
 #include <utils/compiler.h>
 
 #include <functional>
+#include <new>
 #include <tuple>
 #include <thread>
 #include <utility>
@@ -72,7 +74,8 @@ class Dispatcher {
 public:
     using Execute = void (*)(Driver& driver, CommandBase* self, intptr_t* next);
 #define DECL_DRIVER_API_SYNCHRONOUS(RetType, methodName, paramsDecl, params)
-#define DECL_DRIVER_API(methodName, paramsDecl, params)                     Execute methodName##_;
+#define DECL_DRIVER_API(methodName, paramsDecl, params)                     Execute methodName##_; \
+                                                                            Execute methodName##Batch_;
 #define DECL_DRIVER_API_RETURN(RetType, methodName, paramsDecl, params)     Execute methodName##_;
 #include "DriverAPI.inc"
 };
@@ -110,6 +113,23 @@ private:
 
 // ------------------------------------------------------------------------------------------------
 
+/*
+ * Common base of all batched commands (see CommandType<>::BatchCommand below). Only exists
+ * so that CommandStream can grow the current run without knowing its concrete type.
+ */
+class BatchCommandBase : public CommandBase {
+protected:
+    uint32_t mCount;
+    inline explicit constexpr BatchCommandBase(Execute execute) noexcept
+            : CommandBase(execute), mCount(0) {
+    }
+public:
+    // one more element was appended to this run
+    inline void grow() noexcept { ++mCount; }
+};
+
+// ------------------------------------------------------------------------------------------------
+
 template<typename T, typename Type, typename D, typename ... ARGS>
 constexpr decltype(auto) invoke(Type T::* m, D&& d, ARGS&& ... args) {
     static_assert(std::is_base_of<T, std::decay_t<D>>::value,
@@ -182,11 +202,55 @@ struct CommandType<void (Driver::*)(ARGS...)> {
             return ptr;
         }
     };
+
+    /*
+     * BatchCommand packs a run of commands targeting the same Driver method into a single
+     * buffer entry: one header followed by the saved arguments of each call, back-to-back
+     * at a fixed stride. The run pays a single dispatch through mExecute and is replayed
+     * by a tight loop, instead of one CommandBase + one indirect call per command.
+     * CommandStream appends to the run in place as long as the same method is recorded
+     * consecutively (see CommandStream::allocateBatchElement()).
+     */
+    template<void(Driver::*)(ARGS...)>
+    class BatchCommand : public BatchCommandBase {
+    public:
+        using SavedParameters = std::tuple<std::remove_reference_t<ARGS>...>;
+
+        static constexpr size_t HEADER_SIZE = align(sizeof(BatchCommandBase));
+        static constexpr size_t ELEMENT_SIZE = align(sizeof(SavedParameters));
+
+        template<typename M, typename D>
+        static inline void execute(M&& method, D&& driver, CommandBase* base, intptr_t* next) noexcept {
+            BatchCommand* self = static_cast<BatchCommand*>(base);
+            uint32_t const count = self->mCount;
+            *next = intptr_t(HEADER_SIZE + count * ELEMENT_SIZE);
+            char* p = reinterpret_cast<char*>(base) + HEADER_SIZE;
+            for (uint32_t i = 0; i < count; i++, p += ELEMENT_SIZE) {
+                SavedParameters* const args = reinterpret_cast<SavedParameters*>(p);
+                apply(std::forward<M>(method), std::forward<D>(driver), std::move(*args));
+                args->~SavedParameters();
+            }
+            self->~BatchCommand();
+        }
+
+        inline explicit constexpr BatchCommand(Execute execute) noexcept
+                : BatchCommandBase(execute) {
+        }
+
+        // placement new declared as "throw" to avoid the compiler's null-check
+        inline void* operator new(std::size_t size, void* ptr) {
+            assert_invariant(ptr);
+            return ptr;
+        }
+    };
 };
 
 // convert an method of "class Driver" into a Command<> type
 #define COMMAND_TYPE(method) CommandType<decltype(&Driver::method)>::Command<&Driver::method>
 
+// same, for the batched (coalesced) form of the command
+#define BATCH_COMMAND_TYPE(method) CommandType<decltype(&Driver::method)>::BatchCommand<&Driver::method>
+
 // ------------------------------------------------------------------------------------------------
 
 class CustomCommand : public CommandBase {
@@ -228,6 +292,7 @@ class CommandStream {
     Dispatcher* mDispatcher = nullptr;
     Driver* mDriver = nullptr;
     CircularBuffer* UTILS_RESTRICT mCurrentBuffer = nullptr;
+    CaptureRecorder* mCapturer = nullptr;
 
 #ifndef NDEBUG
     // just for debugging...
@@ -247,9 +312,17 @@ public:
 #define DECL_DRIVER_API(methodName, paramsDecl, params)                                         \
     inline void methodName(paramsDecl) {                                                        \
         DEBUG_COMMAND_BEGIN(methodName, false, params);                                         \
-        using Cmd = COMMAND_TYPE(methodName);                                                   \
-        void* const p = allocateCommand(CommandBase::align(sizeof(Cmd)));                       \
-        new(p) Cmd(mDispatcher->methodName##_, APPLY(std::move, params));                       \
+        if (UTILS_UNLIKELY(mCapturer)) {                                                        \
+            mCapturer->record(CaptureCommand::methodName, params);                              \
+        }                                                                                       \
+        using Batch = BATCH_COMMAND_TYPE(methodName);                                           \
+        Dispatcher::Execute const execute = mDispatcher->methodName##Batch_;                    \
+        void* p = allocateBatchElement(execute, Batch::ELEMENT_SIZE);                           \
+        if (UTILS_UNLIKELY(!p)) {                                                               \
+            p = beginBatch(new(allocateCommand(Batch::HEADER_SIZE)) Batch(execute),             \
+                    execute, Batch::ELEMENT_SIZE);                                              \
+        }                                                                                       \
+        new(p) Batch::SavedParameters(APPLY(std::move, params));                                \
         DEBUG_COMMAND_END(methodName, false);                                                   \
     }
 
@@ -266,7 +339,11 @@ public:
     inline RetType methodName(paramsDecl) {                                                     \
         DEBUG_COMMAND_BEGIN(methodName, false, params);                                         \
         RetType result = mDriver->methodName##S();                                              \
+        if (UTILS_UNLIKELY(mCapturer)) {                                                        \
+            mCapturer->record(CaptureCommand::methodName, result, params);                      \
+        }                                                                                       \
         using Cmd = COMMAND_TYPE(methodName##R);                                                \
+        endBatch();                                                                             \
         void* const p = allocateCommand(CommandBase::align(sizeof(Cmd)));                       \
         new(p) Cmd(mDispatcher->methodName##_, RetType(result), APPLY(std::move, params));      \
         DEBUG_COMMAND_END(methodName, false);                                                   \
@@ -290,6 +367,15 @@ public:
 
     void execute(void* buffer);
 
+    /*
+     * Attaches (or detaches, with nullptr) a command capture recorder. Every asynchronous
+     * command written afterwards is also serialized to the recorder. Must be called from
+     * the thread that writes commands. The recorder is owned by the caller and must
+     * outlive its attachment.
+     */
+    void setCapturer(CaptureRecorder* capturer) noexcept { mCapturer = capturer; }
+    CaptureRecorder* getCapturer() const noexcept { return mCapturer; }
+
     /*
      * queueCommand() allows to queue a lambda function as a command.
      * This is much less efficient than using the Driver* API.
@@ -316,6 +402,45 @@ private:
         assert_invariant(mThreadId == std::this_thread::get_id());
         return mCurrentBuffer->allocate(size);
     }
+
+    /*
+     * Commands recorded through DECL_DRIVER_API are coalesced: consecutive calls to the
+     * same Driver method append their arguments to the currently open BatchCommand run
+     * instead of writing a new command header. The run is closed whenever a different
+     * method is recorded, anything else is allocated from the buffer, or the buffer is
+     * circularized (flush hands the storage to the backend thread, so it must not be
+     * grown anymore -- this is detected with CircularBuffer's generation counter).
+     */
+
+    // returns storage for one more element of the open run, or nullptr if the current
+    // command can't be coalesced
+    inline void* allocateBatchElement(Dispatcher::Execute execute, size_t elementSize) {
+        if (UTILS_LIKELY(mOpenBatch && mOpenBatchExecute == execute
+                && mOpenBatchGeneration == mCurrentBuffer->getGeneration())) {
+            mOpenBatch->grow();
+            return allocateCommand(elementSize);
+        }
+        return nullptr;
+    }
+
+    // makes `batch` the open run and returns storage for its first element
+    inline void* beginBatch(BatchCommandBase* batch,
+            Dispatcher::Execute execute, size_t elementSize) {
+        mOpenBatch = batch;
+        mOpenBatchExecute = execute;
+        mOpenBatchGeneration = mCurrentBuffer->getGeneration();
+        batch->grow();
+        return allocateCommand(elementSize);
+    }
+
+    // closes the open run, if any
+    inline void endBatch() noexcept {
+        mOpenBatch = nullptr;
+    }
+
+    BatchCommandBase* mOpenBatch = nullptr;
+    Dispatcher::Execute mOpenBatchExecute = nullptr;
+    uint32_t mOpenBatchGeneration = 0;
 };
 
 void* CommandStream::allocate(size_t size, size_t alignment) noexcept {
@@ -326,6 +451,7 @@ void* CommandStream::allocate(size_t size, size_t alignment) noexcept {
     const size_t s = CustomCommand::align(sizeof(NoopCommand) + size + alignment - 1);
 
     // allocate space in the command stream and insert a NoopCommand
+    endBatch();
     char* const p = (char *)allocateCommand(s);
     new(p) NoopCommand(p + s);
 
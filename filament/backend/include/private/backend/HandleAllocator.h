@@ -17,12 +17,15 @@
 #ifndef TNT_FILAMENT_BACKEND_PRIVATE_HANDLEALLOCATOR_H
 #define TNT_FILAMENT_BACKEND_PRIVATE_HANDLEALLOCATOR_H
 
+#include <backend/DriverEnums.h>
 #include <backend/Handle.h>
 
 #include <utils/Allocator.h>
 #include <utils/Log.h>
 #include <utils/compiler.h>
 #include <tsl/robin_map.h>
+
+#include <algorithm>
 #include <unordered_map>
 
 #if !defined(NDEBUG) && UTILS_HAS_RTTI
@@ -45,10 +48,22 @@ class HandleAllocator {
 public:
 
     HandleAllocator(const char* name, size_t size) noexcept;
+
+    /*
+     * Construct an allocator with an explicit capacity (in handles) for each size class,
+     * e.g. so the pools can be sized for the application's workload and never fall over
+     * to the (slow, locked) heap allocator.
+     */
+    HandleAllocator(const char* name,
+            size_t count0, size_t count1, size_t count2) noexcept;
+
     HandleAllocator(HandleAllocator const& rhs) = delete;
     HandleAllocator& operator=(HandleAllocator const& rhs) = delete;
     ~HandleAllocator();
 
+    // current and high-water usage of each pool and of the heap overflow map
+    HandleAllocatorStats getStats() const noexcept;
+
     /*
      * Constructs a D object and returns a Handle<D>
      *
@@ -216,26 +231,40 @@ private:
         utils::PoolAllocator<P0, 16>   mPool0;
         utils::PoolAllocator<P1, 16>   mPool1;
         utils::PoolAllocator<P2, 16>   mPool2;
+        // per-pool usage, in elements; updated under the arena's lock
+        uint32_t mCapacity[3] = {};
+        uint32_t mUsed[3] = {};
+        uint32_t mHighWatermark[3] = {};
         UTILS_UNUSED_IN_RELEASE const utils::AreaPolicy::HeapArea& mArea;
+
+        inline void onAlloc(size_t index) noexcept {
+            uint32_t const used = ++mUsed[index];
+            mHighWatermark[index] = std::max(mHighWatermark[index], used);
+        }
+
     public:
         static constexpr size_t MIN_ALIGNMENT_SHIFT = 4;
         explicit Allocator(const utils::AreaPolicy::HeapArea& area);
 
+        // splits the area so each pool holds exactly countN elements
+        Allocator(const utils::AreaPolicy::HeapArea& area,
+                size_t count0, size_t count1, size_t count2);
+
         // this is in fact always called with a constexpr size argument
         [[nodiscard]] inline void* alloc(size_t size, size_t alignment, size_t extra) noexcept {
             void* p = nullptr;
-                 if (size <= mPool0.getSize()) p = mPool0.alloc(size, 16, extra);
-            else if (size <= mPool1.getSize()) p = mPool1.alloc(size, 16, extra);
-            else if (size <= mPool2.getSize()) p = mPool2.alloc(size, 16, extra);
+                 if (size <= mPool0.getSize()) { p = mPool0.alloc(size, 16, extra); if (p) onAlloc(0); }
+            else if (size <= mPool1.getSize()) { p = mPool1.alloc(size, 16, extra); if (p) onAlloc(1); }
+            else if (size <= mPool2.getSize()) { p = mPool2.alloc(size, 16, extra); if (p) onAlloc(2); }
             return p;
         }
 
         // this is in fact always called with a constexpr size argument
         inline void free(void* p, size_t size) noexcept {
             assert_invariant(p >= mArea.begin() && (char*)p + size <= (char*)mArea.end());
-            if (size <= mPool0.getSize()) { mPool0.free(p); return; }
-            if (size <= mPool1.getSize()) { mPool1.free(p); return; }
-            if (size <= mPool2.getSize()) { mPool2.free(p); return; }
+            if (size <= mPool0.getSize()) { mPool0.free(p); --mUsed[0]; return; }
+            if (size <= mPool1.getSize()) { mPool1.free(p); --mUsed[1]; return; }
+            if (size <= mPool2.getSize()) { mPool2.free(p); --mUsed[2]; return; }
         }
     };
 
@@ -307,6 +336,7 @@ private:
     mutable utils::Mutex mLock;
     tsl::robin_map<HandleBase::HandleId, void*> mOverflowMap;
     HandleBase::HandleId mId = 0;
+    uint32_t mOverflowHighWatermark = 0;    // protected by mLock
 #if HANDLE_TYPE_SAFETY
     mutable std::unordered_map<const void*, const char*> mHandleTypeId;
 #endif
@@ -63,6 +63,12 @@ public:
     // swap draw buffers (i.e. for double-buffered rendering).
     virtual void commit(SwapChain* swapChain) noexcept = 0;
 
+    // Hints the region of the swap chain that changed this frame, using a bottom-left
+    // origin. Platforms that support partial present honor the hint at the next commit();
+    // the default implementation ignores it and presents the full frame.
+    virtual void setPresentFrameDamage(SwapChain* swapChain,
+            uint32_t left, uint32_t bottom, uint32_t width, uint32_t height) noexcept {}
+
     virtual void setPresentationTime(int64_t presentationTimeInNanosecond) noexcept = 0;
 
     virtual bool canCreateFence() noexcept { return false; }
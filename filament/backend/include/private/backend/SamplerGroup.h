@@ -70,6 +70,13 @@ public:
     // return if any samplers has been changed
     bool isDirty() const noexcept { return mDirty.any(); }
 
+    // bitset of the samplers changed since the last clean()
+    utils::bitset32 getDirty() const noexcept { return mDirty; }
+
+    // monotonic version, incremented each time the group's content is modified. Backends
+    // compare it against the version they last bound to detect redundant rebinds.
+    uint32_t getVersion() const noexcept { return mVersion; }
+
     // mark the whole group as clean (no modified uniforms)
     void clean() const noexcept { mDirty.reset(); }
 
@@ -149,6 +156,7 @@ private:
 
     static_vector<Sampler, backend::MAX_SAMPLER_COUNT> mBuffer;    // 128 bytes
     mutable utils::bitset32 mDirty;
+    uint32_t mVersion = 0;
 };
 
 } // namespace backend
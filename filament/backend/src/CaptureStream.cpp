@@ -0,0 +1,486 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "private/backend/CaptureStream.h"
+
+#include "private/backend/CommandStream.h"
+
+#include <utils/Log.h>
+
+#include <tuple>
+#include <utility>
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace utils;
+
+namespace filament {
+namespace backend {
+
+// capture file header: magic, format version
+static constexpr uint32_t CAPTURE_MAGIC = 0x50414346u;  // 'FCAP'
+static constexpr uint32_t CAPTURE_VERSION = 1u;
+
+// ------------------------------------------------------------------------------------------------
+// CaptureRecorder
+// ------------------------------------------------------------------------------------------------
+
+CaptureRecorder::CaptureRecorder(const char* path, uint32_t frameCount)
+        : mFrameLimit(frameCount) {
+    mFile = fopen(path, "wb");
+    if (mFile == nullptr) {
+        slog.e << "CaptureRecorder: can't open \"" << path << "\" for writing" << io::endl;
+        return;
+    }
+    uint32_t const header[2] = { CAPTURE_MAGIC, CAPTURE_VERSION };
+    fwrite(header, sizeof(header), 1, mFile);
+    mFinished = false;
+}
+
+CaptureRecorder::~CaptureRecorder() noexcept {
+    finish();
+}
+
+void CaptureRecorder::finish() noexcept {
+    if (mFile != nullptr) {
+        fclose(mFile);
+        mFile = nullptr;
+        slog.i << "CaptureRecorder: capture closed after "
+               << mRecordedFrames << " frames" << io::endl;
+    }
+    mFinished = true;
+}
+
+bool CaptureRecorder::isSkipped(CaptureCommand command) noexcept {
+    switch (command) {
+        // callbacks and user pointers are process-local
+        case CaptureCommand::setFrameScheduledCallback:
+        case CaptureCommand::setFrameCompletedCallback:
+        // external images, streams and imported textures reference objects that won't
+        // exist in the replaying process
+        case CaptureCommand::setExternalImage:
+        case CaptureCommand::setExternalImagePlane:
+        case CaptureCommand::setExternalStream:
+        case CaptureCommand::createStreamFromTextureId:
+        case CaptureCommand::importTexture:
+        // read-backs write into client-owned buffers and don't contribute to rendering
+        case CaptureCommand::readPixels:
+        case CaptureCommand::readStreamPixels:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void CaptureRecorder::writeBytes(void const* data, size_t size) {
+    uint8_t const* p = static_cast<uint8_t const*>(data);
+    mScratch.insert(mScratch.end(), p, p + size);
+}
+
+void CaptureRecorder::endRecord(CaptureCommand command) noexcept {
+    uint16_t const id = uint16_t(command);
+    uint32_t const size = uint32_t(mScratch.size());
+    fwrite(&id, sizeof(id), 1, mFile);
+    fwrite(&size, sizeof(size), 1, mFile);
+    if (size > 0) {
+        fwrite(mScratch.data(), 1, size, mFile);
+    }
+    if (UTILS_UNLIKELY(ferror(mFile))) {
+        slog.e << "CaptureRecorder: write error, capture aborted" << io::endl;
+        finish();
+        return;
+    }
+    if (UTILS_UNLIKELY(command == CaptureCommand::commit)) {
+        mRecordedFrames++;
+        if (mFrameLimit > 0 && mRecordedFrames >= mFrameLimit) {
+            finish();
+        }
+    }
+}
+
+void CaptureRecorder::writeArg(HandleBase const& handle) {
+    HandleBase::HandleId const id = handle.getId();
+    writeBytes(&id, sizeof(id));
+}
+
+void CaptureRecorder::writeArg(FaceOffsets const& offsets) {
+    writeBytes(offsets.offsets, sizeof(offsets.offsets));
+}
+
+void CaptureRecorder::writeArg(TargetBufferInfo const& info) {
+    writeArg(info.handle);
+    writeBytes(&info.level, sizeof(info.level));
+    writeBytes(&info.layer, sizeof(info.layer));
+}
+
+void CaptureRecorder::writeArg(MRT const& mrt) {
+    for (size_t i = 0; i < MRT::MAX_SUPPORTED_RENDER_TARGET_COUNT; i++) {
+        writeArg(mrt[i]);
+    }
+}
+
+void CaptureRecorder::writeArg(PipelineState const& state) {
+    writeArg(state.program);
+    writeBytes(&state.rasterState, sizeof(state.rasterState));
+    writeBytes(&state.polygonOffset, sizeof(state.polygonOffset));
+    writeBytes(&state.scissor, sizeof(state.scissor));
+}
+
+void CaptureRecorder::writeArg(BufferDescriptor const& buffer) {
+    uint64_t const size = buffer.size;
+    uint8_t const hasData = buffer.buffer != nullptr ? 1 : 0;
+    writeBytes(&size, sizeof(size));
+    writeBytes(&hasData, sizeof(hasData));
+    if (hasData && size > 0) {
+        writeBytes(buffer.buffer, size);
+    }
+}
+
+void CaptureRecorder::writeArg(PixelBufferDescriptor const& buffer) {
+    // bitfields and union members are copied into plain locals first
+    uint8_t const type = uint8_t(buffer.type);
+    uint8_t const alignment = buffer.alignment;
+    uint32_t strideOrImageSize;
+    uint32_t format;
+    if (buffer.type == PixelDataType::COMPRESSED) {
+        strideOrImageSize = buffer.imageSize;
+        format = uint32_t(buffer.compressedFormat);
+    } else {
+        strideOrImageSize = buffer.stride;
+        format = uint32_t(buffer.format);
+    }
+    writeBytes(&buffer.left, sizeof(buffer.left));
+    writeBytes(&buffer.top, sizeof(buffer.top));
+    writeBytes(&strideOrImageSize, sizeof(strideOrImageSize));
+    writeBytes(&format, sizeof(format));
+    writeBytes(&type, sizeof(type));
+    writeBytes(&alignment, sizeof(alignment));
+    writeArg(static_cast<BufferDescriptor const&>(buffer));
+}
+
+void CaptureRecorder::writeArg(SamplerGroup const& group) {
+    uint32_t const count = uint32_t(group.getSize());
+    writeBytes(&count, sizeof(count));
+    SamplerGroup::Sampler const* const samplers = group.getSamplers();
+    for (uint32_t i = 0; i < count; i++) {
+        writeArg(samplers[i].t);
+        writeBytes(&samplers[i].s, sizeof(samplers[i].s));
+    }
+}
+
+void CaptureRecorder::writeArg(Program const& program) {
+    writeArg(program.getName());
+    Variant const variant = program.getVariant();
+    writeBytes(&variant, sizeof(variant));
+    for (auto const& blob : program.getShadersSource()) {
+        uint64_t const size = blob.size();
+        writeBytes(&size, sizeof(size));
+        if (size > 0) {
+            writeBytes(blob.data(), size);
+        }
+    }
+    for (auto const& blockName : program.getUniformBlockInfo()) {
+        writeArg(blockName);
+    }
+    for (auto const& group : program.getSamplerGroupInfo()) {
+        writeBytes(&group.stageFlags, sizeof(group.stageFlags));
+        uint32_t const count = uint32_t(group.samplers.size());
+        writeBytes(&count, sizeof(count));
+        for (auto const& sampler : group.samplers) {
+            writeArg(sampler.name);
+            writeBytes(&sampler.binding, sizeof(sampler.binding));
+            uint8_t const strict = sampler.strict ? 1 : 0;
+            writeBytes(&strict, sizeof(strict));
+        }
+    }
+}
+
+void CaptureRecorder::writeArg(utils::CString const& string) {
+    uint32_t const length = uint32_t(string.size());
+    writeBytes(&length, sizeof(length));
+    if (length > 0) {
+        writeBytes(string.c_str(), length);
+    }
+}
+
+void CaptureRecorder::writeArg(const char* string) {
+    uint32_t const length = string != nullptr ? uint32_t(strlen(string)) : 0;
+    writeBytes(&length, sizeof(length));
+    if (length > 0) {
+        writeBytes(string, length);
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// CaptureReplayer
+// ------------------------------------------------------------------------------------------------
+
+namespace {
+template<typename T> struct is_handle : std::false_type {};
+template<typename U> struct is_handle<Handle<U>> : std::true_type {};
+} // anonymous namespace
+
+CaptureReplayer::~CaptureReplayer() noexcept {
+    if (mFile != nullptr) {
+        fclose(mFile);
+    }
+}
+
+bool CaptureReplayer::open(const char* path) {
+    mFile = fopen(path, "rb");
+    if (mFile == nullptr) {
+        slog.e << "CaptureReplayer: can't open \"" << path << "\"" << io::endl;
+        return false;
+    }
+    uint32_t header[2] = {};
+    if (fread(header, sizeof(header), 1, mFile) != 1
+            || header[0] != CAPTURE_MAGIC || header[1] != CAPTURE_VERSION) {
+        slog.e << "CaptureReplayer: \"" << path
+               << "\" is not a capture file of this version" << io::endl;
+        fclose(mFile);
+        mFile = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool CaptureReplayer::readBytes(void* data, size_t size) noexcept {
+    if (UTILS_UNLIKELY(mError)) {
+        return false;
+    }
+    if (size > 0 && fread(data, 1, size, mFile) != size) {
+        slog.e << "CaptureReplayer: unexpected end of capture" << io::endl;
+        mError = true;
+        return false;
+    }
+    return true;
+}
+
+HandleBase::HandleId CaptureReplayer::mapHandle(HandleBase::HandleId recorded) noexcept {
+    if (recorded == HandleBase::nullid) {
+        return HandleBase::nullid;
+    }
+    auto pos = mHandleMap.find(recorded);
+    if (UTILS_UNLIKELY(pos == mHandleMap.end())) {
+        // the resource was created before the capture started (or by a skipped command)
+        return HandleBase::nullid;
+    }
+    return pos->second;
+}
+
+template<typename T>
+T CaptureReplayer::readArg() {
+    if constexpr (is_handle<T>::value) {
+        return remapHandle<T>();
+    } else if constexpr (std::is_same<T, FaceOffsets>::value) {
+        FaceOffsets offsets;
+        readBytes(offsets.offsets, sizeof(offsets.offsets));
+        return offsets;
+    } else if constexpr (std::is_same<T, TargetBufferInfo>::value) {
+        TargetBufferInfo info;
+        info.handle = remapHandle<Handle<HwTexture>>();
+        info.level = read<uint8_t>();
+        info.layer = read<uint16_t>();
+        return info;
+    } else if constexpr (std::is_same<T, MRT>::value) {
+        MRT mrt;
+        for (size_t i = 0; i < MRT::MAX_SUPPORTED_RENDER_TARGET_COUNT; i++) {
+            mrt[i] = readArg<TargetBufferInfo>();
+        }
+        return mrt;
+    } else if constexpr (std::is_same<T, PipelineState>::value) {
+        PipelineState state;
+        state.program = remapHandle<Handle<HwProgram>>();
+        readBytes(&state.rasterState, sizeof(state.rasterState));
+        readBytes(&state.polygonOffset, sizeof(state.polygonOffset));
+        readBytes(&state.scissor, sizeof(state.scissor));
+        return state;
+    } else if constexpr (std::is_same<T, PixelBufferDescriptor>::value) {
+        uint32_t const left = read<uint32_t>();
+        uint32_t const top = read<uint32_t>();
+        uint32_t const strideOrImageSize = read<uint32_t>();
+        uint32_t const format = read<uint32_t>();
+        PixelDataType const type = PixelDataType(read<uint8_t>());
+        uint8_t const alignment = read<uint8_t>();
+        uint64_t const size = read<uint64_t>();
+        uint8_t const hasData = read<uint8_t>();
+        void* data = nullptr;
+        if (hasData && size > 0) {
+            data = malloc(size);
+            readBytes(data, size);
+        }
+        auto freeCallback = [](void* buffer, size_t, void*) { free(buffer); };
+        if (type == PixelDataType::COMPRESSED) {
+            return PixelBufferDescriptor(data, size,
+                    CompressedPixelDataType(format), strideOrImageSize, freeCallback);
+        }
+        return PixelBufferDescriptor(data, size,
+                PixelDataFormat(format), type, alignment, left, top, strideOrImageSize,
+                freeCallback);
+    } else if constexpr (std::is_same<T, BufferDescriptor>::value) {
+        uint64_t const size = read<uint64_t>();
+        uint8_t const hasData = read<uint8_t>();
+        void* data = nullptr;
+        if (hasData && size > 0) {
+            data = malloc(size);
+            readBytes(data, size);
+        }
+        return BufferDescriptor(data, size, [](void* buffer, size_t, void*) { free(buffer); });
+    } else if constexpr (std::is_same<T, SamplerGroup>::value) {
+        uint32_t const count = read<uint32_t>();
+        SamplerGroup group(count);
+        for (uint32_t i = 0; i < count; i++) {
+            auto const t = remapHandle<Handle<HwTexture>>();
+            auto const params = read<SamplerParams>();
+            group.setSampler(i, t, params);
+        }
+        return group;
+    } else if constexpr (std::is_same<T, Program>::value) {
+        Program program;
+        utils::CString name = readArg<utils::CString>();
+        Variant const variant = read<Variant>();
+        program.diagnostics(name, variant);
+        for (size_t i = 0; i < Program::SHADER_TYPE_COUNT; i++) {
+            uint64_t const size = read<uint64_t>();
+            if (size > 0) {
+                std::vector<uint8_t> blob(size);
+                readBytes(blob.data(), size);
+                program.shader(Program::Shader(i), blob.data(), size);
+            }
+        }
+        for (size_t i = 0; i < Program::BINDING_COUNT; i++) {
+            utils::CString blockName = readArg<utils::CString>();
+            if (!blockName.empty()) {
+                program.setUniformBlock(i, std::move(blockName));
+            }
+        }
+        for (size_t i = 0; i < Program::BINDING_COUNT; i++) {
+            auto const stageFlags = read<ShaderStageFlags>();
+            uint32_t const count = read<uint32_t>();
+            if (count > 0) {
+                std::vector<Program::Sampler> samplers(count);
+                for (uint32_t j = 0; j < count; j++) {
+                    samplers[j].name = readArg<utils::CString>();
+                    samplers[j].binding = read<uint16_t>();
+                    samplers[j].strict = read<uint8_t>() != 0;
+                }
+                program.setSamplerGroup(i, stageFlags, samplers.data(), count);
+            }
+        }
+        return program;
+    } else if constexpr (std::is_same<T, utils::CString>::value) {
+        uint32_t const length = read<uint32_t>();
+        if (length == 0) {
+            return utils::CString{};
+        }
+        std::vector<char> chars(length);
+        readBytes(chars.data(), length);
+        return utils::CString(chars.data(), length);
+    } else if constexpr (std::is_same<T, const char*>::value) {
+        uint32_t const length = read<uint32_t>();
+        mStrings.emplace_back();
+        std::string& storage = mStrings.back();
+        storage.resize(length);
+        if (length > 0) {
+            readBytes(&storage[0], length);
+        }
+        return storage.c_str();
+    } else if constexpr (std::is_same<T, void*>::value) {
+        return mNativeWindow;
+    } else {
+        return read<T>();
+    }
+}
+
+template<typename R, typename... ARGS>
+void CaptureReplayer::replayApi(R (CommandStream::*method)(ARGS...), CommandStream& api) {
+    // methods that return a handle have the returned id recorded before the arguments
+    HandleBase::HandleId recordedId = HandleBase::nullid;
+    if constexpr (!std::is_void<R>::value) {
+        recordedId = read<HandleBase::HandleId>();
+    }
+    // braced-init-list: the reads are sequenced left-to-right, i.e. in argument order
+    std::tuple<std::decay_t<ARGS>...> args{ readArg<std::decay_t<ARGS>>()... };
+    if (UTILS_UNLIKELY(mError)) {
+        return;
+    }
+    if constexpr (std::is_void<R>::value) {
+        std::apply([&](auto&... a) { (api.*method)(std::move(a)...); }, args);
+    } else {
+        R const result = std::apply([&](auto&... a) -> R {
+            return (api.*method)(std::move(a)...);
+        }, args);
+        if (recordedId != HandleBase::nullid) {
+            mHandleMap[recordedId] = result.getId();
+        }
+    }
+}
+
+bool CaptureReplayer::replayFrame(CommandStream& api) {
+    if (mFile == nullptr || mError) {
+        return false;
+    }
+    for (;;) {
+        uint16_t id;
+        if (fread(&id, sizeof(id), 1, mFile) != 1) {
+            return false; // end of capture
+        }
+        uint32_t const payloadSize = read<uint32_t>();
+        if (UTILS_UNLIKELY(mError || id >= uint16_t(CaptureCommand::COUNT))) {
+            mError = true;
+            return false;
+        }
+        mStrings.clear();
+        CaptureCommand const command = CaptureCommand(id);
+
+        // without a native window, swap chains are replayed as headless swap chains
+        if (UTILS_UNLIKELY(command == CaptureCommand::createSwapChain && !mNativeWindow)) {
+            auto const recordedId = read<HandleBase::HandleId>();
+            // the native window itself isn't stored (see CaptureRecorder::writeArg(void*))
+            auto const flags = read<uint64_t>();
+            auto const sch = api.createSwapChainHeadless(mHeadlessWidth, mHeadlessHeight, flags);
+            mHandleMap[recordedId] = sch.getId();
+        } else {
+            switch (command) {
+#define DECL_DRIVER_API(methodName, paramsDecl, params)                                         \
+                case CaptureCommand::methodName:                                                \
+                    replayApi(&CommandStream::methodName, api);                                 \
+                    break;
+#define DECL_DRIVER_API_SYNCHRONOUS(RetType, methodName, paramsDecl, params)
+#define DECL_DRIVER_API_RETURN(RetType, methodName, paramsDecl, params)                         \
+                case CaptureCommand::methodName:                                                \
+                    replayApi(&CommandStream::methodName, api);                                 \
+                    break;
+#include "private/backend/DriverAPI.inc"
+                default:
+                    // unknown record, skip its payload
+                    fseek(mFile, long(payloadSize), SEEK_CUR);
+                    break;
+            }
+        }
+        if (UTILS_UNLIKELY(mError)) {
+            return false;
+        }
+        if (command == CaptureCommand::commit) {
+            mReplayedFrames++;
+            return true;
+        }
+    }
+}
+
+} // namespace backend
+} // namespace filament
@@ -143,6 +143,18 @@ void CircularBuffer::dealloc() noexcept {
 }
 
 
+void CircularBuffer::resize(size_t bufferSize) noexcept {
+    // we're about to unmap the current region, so nothing -- on either thread -- may
+    // still point into it
+    assert_invariant(empty());
+    dealloc();
+    mData = alloc(bufferSize);
+    mSize = bufferSize;
+    mTail = mData;
+    mHead = mData;
+    mGeneration++;
+}
+
 void CircularBuffer::circularize() noexcept {
     if (mUsesAshmem > 0) {
         intptr_t overflow = intptr_t(mHead) - (intptr_t(mData) + ssize_t(mSize));
@@ -160,6 +172,7 @@ void CircularBuffer::circularize() noexcept {
         }
     }
     mTail = mHead;
+    mGeneration++;
 }
 
 } // namespace backend
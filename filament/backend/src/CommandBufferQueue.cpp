@@ -24,6 +24,8 @@
 #include "private/backend/BackendUtils.h"
 #include "private/backend/CommandStream.h"
 
+#include <algorithm>
+
 using namespace utils;
 
 namespace filament {
@@ -31,26 +33,27 @@ namespace backend {
 
 CommandBufferQueue::CommandBufferQueue(size_t requiredSize, size_t bufferSize)
         : mRequiredSize((requiredSize + CircularBuffer::BLOCK_MASK) & ~CircularBuffer::BLOCK_MASK),
+          mMaxBufferSize(bufferSize * 4),
           mCircularBuffer(bufferSize),
           mFreeSpace(mCircularBuffer.size()) {
     assert_invariant(mCircularBuffer.size() > requiredSize);
 }
 
 CommandBufferQueue::~CommandBufferQueue() {
-    assert_invariant(mCommandBuffersToExecute.empty());
+    assert_invariant(mSliceHead.load() == mSliceTail.load());
 }
 
 void CommandBufferQueue::requestExit() {
     std::lock_guard<utils::Mutex> lock(mLock);
-    mExitRequested = EXIT_REQUESTED;
-    mCondition.notify_one();
+    mExitRequested.store(EXIT_REQUESTED);
+    mCondition.notify_all();
 }
 
 bool CommandBufferQueue::isExitRequested() const {
-    std::lock_guard<utils::Mutex> lock(mLock);
-    ASSERT_PRECONDITION( mExitRequested == 0 || mExitRequested == EXIT_REQUESTED,
-            "mExitRequested is corrupted (value = 0x%08x)!", mExitRequested);
-    return (bool)mExitRequested;
+    uint32_t const exitRequested = mExitRequested.load();
+    ASSERT_PRECONDITION( exitRequested == 0 || exitRequested == EXIT_REQUESTED,
+            "mExitRequested is corrupted (value = 0x%08x)!", exitRequested);
+    return (bool)exitRequested;
 }
 
 
@@ -77,57 +80,139 @@ void CommandBufferQueue::flush() noexcept {
 
     circularBuffer.circularize();
 
-    std::unique_lock<utils::Mutex> lock(mLock);
-    mCommandBuffersToExecute.push_back({ tail, head });
+    // publish the slice to the consumer. This is lock-free in the common case; we only
+    // take the mutex if the ring is full, i.e. the backend thread is more than
+    // SLICE_COUNT-1 buffers behind us -- at that point blocking is the right thing to do.
+    uint32_t const sliceHead = mSliceHead.load(std::memory_order_relaxed);
+    uint32_t const sliceNext = (sliceHead + 1) % SLICE_COUNT;
+    if (UTILS_UNLIKELY(sliceNext == mSliceTail.load(std::memory_order_acquire))) {
+        SYSTRACE_NAME("waiting: CommandBufferQueue ring full");
+        std::unique_lock<utils::Mutex> lock(mLock);
+        mProducerWaiting.store(true);
+        mCondition.wait(lock, [this, sliceNext]() -> bool {
+            return sliceNext != mSliceTail.load();
+        });
+        mProducerWaiting.store(false);
+    }
+    mSlices[sliceHead] = { tail, head };
+    // seq_cst so this store can't be reordered with the mConsumerParked load below
+    mSliceHead.store(sliceNext);
+
+    size_t const freeSpaceBefore = mFreeSpace.fetch_sub(used);
 
     // circular buffer is too small, we corrupted the stream
-    ASSERT_POSTCONDITION(used <= mFreeSpace,
+    ASSERT_POSTCONDITION(used <= freeSpaceBefore,
             "Backend CommandStream overflow. Commands are corrupted and unrecoverable.\n"
             "Please increase FILAMENT_MIN_COMMAND_BUFFERS_SIZE_IN_MB (currently %u MiB).\n"
             "Space used at this time: %u bytes",
             (unsigned)FILAMENT_MIN_COMMAND_BUFFERS_SIZE_IN_MB, (unsigned)used);
 
-    // wait until there is enough space in the buffer
-    mFreeSpace -= used;
+    size_t const freeSpace = freeSpaceBefore - used;
     const size_t requiredSize = mRequiredSize;
 
-#ifndef NDEBUG
-    size_t totalUsed = circularBuffer.size() - mFreeSpace;
+    size_t const totalUsed = circularBuffer.size() - freeSpace;
+    mLastOccupancy = totalUsed;
     mHighWatermark = std::max(mHighWatermark, totalUsed);
+    SYSTRACE_VALUE32("CommandStream occupancy", uint32_t(totalUsed));
+
+    // soft overflow: we're using more space than flush() guarantees, which means the
+    // producer is about to block -- and a larger burst would corrupt the stream outright.
+    // Schedule a remap to a larger ring at the next safe point.
     if (UTILS_UNLIKELY(totalUsed > requiredSize)) {
+        if (circularBuffer.size() < mMaxBufferSize) {
+            mPendingBufferSize = std::min(circularBuffer.size() * 2, mMaxBufferSize);
+        }
+#ifndef NDEBUG
         slog.d << "CommandStream used too much space: " << totalUsed
             << ", out of " << requiredSize << " (will block)" << io::endl;
-    }
 #endif
+    }
 
-    mCondition.notify_one();
-    if (UTILS_LIKELY(mFreeSpace < requiredSize)) {
+    // wake the consumer, but only if it's actually parked on the condition variable;
+    // either it sees our mSliceHead store above, or we see it parked -- both stores
+    // are seq_cst, so at least one of these is guaranteed.
+    if (UTILS_UNLIKELY(mConsumerParked.load())) {
+        std::lock_guard<utils::Mutex> lock(mLock);
+        mCondition.notify_all();
+    }
+
+    // wait until there is enough space in the buffer
+    if (UTILS_UNLIKELY(freeSpace < requiredSize)) {
         SYSTRACE_NAME("waiting: CircularBuffer::flush()");
+        std::unique_lock<utils::Mutex> lock(mLock);
+        mProducerWaiting.store(true);
         mCondition.wait(lock, [this, requiredSize]() -> bool {
-            return mFreeSpace >= requiredSize;
+            return mFreeSpace.load() >= requiredSize;
         });
+        mProducerWaiting.store(false);
+    }
+
+    // grow the ring if a growth was scheduled and we're at a safe point: we have recorded
+    // nothing since circularize() above, and if the consumer has released every slice, no
+    // pointer into the old mapping is live on either thread.
+    if (UTILS_UNLIKELY(mPendingBufferSize != 0)) {
+        if (mFreeSpace.load() == circularBuffer.size()) {
+            size_t const newSize = mPendingBufferSize;
+            mPendingBufferSize = 0;
+            circularBuffer.resize(newSize);
+            mFreeSpace.store(circularBuffer.size());
+            mGrowthCount++;
+            slog.d << "CommandStream ring grown to "
+                   << (circularBuffer.size() / 1024) << " KiB" << io::endl;
+        }
     }
 }
 
 std::vector<CommandBufferQueue::Slice> CommandBufferQueue::waitForCommands() const {
-    if (!UTILS_HAS_THREADING) {
-        return std::move(mCommandBuffersToExecute);
-    }
-    std::unique_lock<utils::Mutex> lock(mLock);
-    while (mCommandBuffersToExecute.empty() && !mExitRequested) {
-        mCondition.wait(lock);
+    std::vector<Slice> buffers;
+    uint32_t tail = mSliceTail.load(std::memory_order_relaxed);
+
+    auto drain = [this, &buffers, &tail]() {
+        uint32_t const head = mSliceHead.load(); // seq_cst, see flush()
+        while (tail != head) {
+            buffers.push_back(mSlices[tail]);
+            tail = (tail + 1) % SLICE_COUNT;
+        }
+    };
+
+    drain();
+
+    if (UTILS_HAS_THREADING && buffers.empty() && !mExitRequested.load()) {
+        std::unique_lock<utils::Mutex> lock(mLock);
+        mConsumerParked.store(true);
+        drain();
+        while (buffers.empty() && !mExitRequested.load()) {
+            mCondition.wait(lock);
+            drain();
+        }
+        mConsumerParked.store(false);
     }
 
-    ASSERT_PRECONDITION( mExitRequested == 0 || mExitRequested == EXIT_REQUESTED,
-            "mExitRequested is corrupted (value = 0x%08x)!", mExitRequested);
+    uint32_t const exitRequested = mExitRequested.load();
+    ASSERT_PRECONDITION( exitRequested == 0 || exitRequested == EXIT_REQUESTED,
+            "mExitRequested is corrupted (value = 0x%08x)!", exitRequested);
+
+    // seq_cst so this store can't be reordered with the mProducerWaiting load below
+    mSliceTail.store(tail);
 
-    return std::move(mCommandBuffersToExecute);
+    // the producer may be blocked on a full ring
+    if (UTILS_UNLIKELY(mProducerWaiting.load())) {
+        std::lock_guard<utils::Mutex> lock(mLock);
+        mCondition.notify_all();
+    }
+
+    return buffers;
 }
 
 void CommandBufferQueue::releaseBuffer(CommandBufferQueue::Slice const& buffer) {
-    std::lock_guard<utils::Mutex> lock(mLock);
-    mFreeSpace += uintptr_t(buffer.end) - uintptr_t(buffer.begin);
-    mCondition.notify_one();
+    mFreeSpace.fetch_add(uintptr_t(buffer.end) - uintptr_t(buffer.begin));
+
+    // the producer checks mFreeSpace and parks under the lock, so either it sees the
+    // space we just released, or we see it waiting here.
+    if (UTILS_UNLIKELY(mProducerWaiting.load())) {
+        std::lock_guard<utils::Mutex> lock(mLock);
+        mCondition.notify_all();
+    }
 }
 
 } // namespace backend
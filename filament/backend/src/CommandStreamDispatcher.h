@@ -52,7 +52,8 @@ public:
     // initialize the dispatch table
     explicit ConcreteDispatcher() noexcept : Dispatcher() {
 #define DECL_DRIVER_API_SYNCHRONOUS(RetType, methodName, paramsDecl, params)
-#define DECL_DRIVER_API(methodName, paramsDecl, params)                 methodName##_ = &ConcreteDispatcher::methodName;
+#define DECL_DRIVER_API(methodName, paramsDecl, params)                 methodName##_ = &ConcreteDispatcher::methodName; \
+                                                                        methodName##Batch_ = &ConcreteDispatcher::methodName##Batch;
 #define DECL_DRIVER_API_RETURN(RetType, methodName, paramsDecl, params) methodName##_ = &ConcreteDispatcher::methodName;
 #include "private/backend/DriverAPI.inc"
     }
@@ -64,6 +65,12 @@ private:
         using Cmd = COMMAND_TYPE(methodName);                                                   \
         ConcreteDriver& concreteDriver = static_cast<ConcreteDriver&>(driver);                  \
         Cmd::execute(&ConcreteDriver::methodName, concreteDriver, base, next);                  \
+     }                                                                                          \
+    static void methodName##Batch(Driver& driver, CommandBase* base, intptr_t* next) {          \
+        SYSTRACE()                                                                              \
+        using Cmd = BATCH_COMMAND_TYPE(methodName);                                             \
+        ConcreteDriver& concreteDriver = static_cast<ConcreteDriver&>(driver);                  \
+        Cmd::execute(&ConcreteDriver::methodName, concreteDriver, base, next);                  \
      }
 #define DECL_DRIVER_API_RETURN(RetType, methodName, paramsDecl, params)                         \
     static void methodName(Driver& driver, CommandBase* base, intptr_t* next) {                 \
@@ -36,6 +36,27 @@ HandleAllocator<P0, P1, P2>::Allocator::Allocator(AreaPolicy::HeapArea const& ar
     mPool0 = PoolAllocator< P0, 16>(p, p + offsetPool1);
     mPool1 = PoolAllocator< P1, 16>(p + offsetPool1, p + offsetPool2);
     mPool2 = PoolAllocator< P2, 16>(p + offsetPool2, area.end());
+    mCapacity[0] = uint32_t(offsetPool1 / P0);
+    mCapacity[1] = uint32_t((offsetPool2 - offsetPool1) / P1);
+    mCapacity[2] = uint32_t((area.size() - offsetPool2) / P2);
+}
+
+template <size_t P0, size_t P1, size_t P2>
+UTILS_NOINLINE
+HandleAllocator<P0, P1, P2>::Allocator::Allocator(AreaPolicy::HeapArea const& area,
+        size_t count0, size_t count1, size_t count2)
+        : mArea(area) {
+    // P0/P1/P2 are multiples of the pool alignment, so these offsets are exact
+    const size_t offsetPool1 = count0 * P0;
+    const size_t offsetPool2 = offsetPool1 + count1 * P1;
+    assert_invariant(offsetPool2 + count2 * P2 <= area.size());
+    char* const p = (char*)area.begin();
+    mPool0 = PoolAllocator< P0, 16>(p, p + offsetPool1);
+    mPool1 = PoolAllocator< P1, 16>(p + offsetPool1, p + offsetPool2);
+    mPool2 = PoolAllocator< P2, 16>(p + offsetPool2, area.end());
+    mCapacity[0] = uint32_t(count0);
+    mCapacity[1] = uint32_t(count1);
+    mCapacity[2] = uint32_t(count2);
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -45,6 +66,32 @@ HandleAllocator<P0, P1, P2>::HandleAllocator(const char* name, size_t size) noex
     : mHandleArena(name, size) {
 }
 
+template <size_t P0, size_t P1, size_t P2>
+HandleAllocator<P0, P1, P2>::HandleAllocator(const char* name,
+        size_t count0, size_t count1, size_t count2) noexcept
+    : mHandleArena(name, count0 * P0 + count1 * P1 + count2 * P2,
+            count0, count1, count2) {
+}
+
+template <size_t P0, size_t P1, size_t P2>
+HandleAllocatorStats HandleAllocator<P0, P1, P2>::getStats() const noexcept {
+    // the pool counters are updated under the arena's lock but read without it here;
+    // this is for monitoring only, approximate values are fine.
+    Allocator const& allocator = mHandleArena.getAllocator();
+    HandleAllocatorStats stats;
+    constexpr uint32_t elementSizes[3] = { P0, P1, P2 };
+    for (size_t i = 0; i < HandleAllocatorStats::POOL_COUNT; i++) {
+        stats.pools[i].elementSize = elementSizes[i];
+        stats.pools[i].capacity = allocator.mCapacity[i];
+        stats.pools[i].used = allocator.mUsed[i];
+        stats.pools[i].highWatermark = allocator.mHighWatermark[i];
+    }
+    std::lock_guard lock(mLock);
+    stats.overflowUsed = uint32_t(mOverflowMap.size());
+    stats.overflowHighWatermark = mOverflowHighWatermark;
+    return stats;
+}
+
 template <size_t P0, size_t P1, size_t P2>
 HandleAllocator<P0, P1, P2>::~HandleAllocator() {
     auto& overflowMap = mOverflowMap;
@@ -75,6 +122,7 @@ HandleBase::HandleId HandleAllocator<P0, P1, P2>::allocateHandleSlow(size_t size
     std::unique_lock lock(mLock);
     HandleBase::HandleId id = (++mId) | HEAP_HANDLE_FLAG;
     mOverflowMap.emplace(id, p);
+    mOverflowHighWatermark = std::max(mOverflowHighWatermark, uint32_t(mOverflowMap.size()));
     lock.unlock();
 
     if (UTILS_UNLIKELY(id == (HEAP_HANDLE_FLAG|1u))) { // meaning id was zero
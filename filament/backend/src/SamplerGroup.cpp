@@ -27,7 +27,7 @@ SamplerGroup::SamplerGroup(size_t count) noexcept
 SamplerGroup::SamplerGroup(const SamplerGroup& rhs) noexcept = default;
 
 SamplerGroup::SamplerGroup(SamplerGroup&& rhs) noexcept
-        : mBuffer(rhs.mBuffer), mDirty(rhs.mDirty) {
+        : mBuffer(rhs.mBuffer), mDirty(rhs.mDirty), mVersion(rhs.mVersion) {
     rhs.clean();
 }
 
@@ -37,6 +37,7 @@ SamplerGroup& SamplerGroup::operator=(SamplerGroup&& rhs) noexcept {
     if (this != &rhs) {
         mBuffer = rhs.mBuffer;
         mDirty = rhs.mDirty;
+        mVersion = rhs.mVersion;
         rhs.clean();
     }
     return *this;
@@ -58,6 +59,7 @@ SamplerGroup& SamplerGroup::setSamplers(SamplerGroup const& rhs) noexcept {
     if (this != &rhs) {
         mBuffer = rhs.mBuffer;
         mDirty.setValue((1u << rhs.mBuffer.size()) - 1u);
+        mVersion++;
     }
     return *this;
 }
@@ -66,6 +68,7 @@ void SamplerGroup::setSampler(size_t index, Sampler sampler) noexcept {
     if (UTILS_LIKELY(index < mBuffer.size())) {
         mBuffer[index] = sampler;
         mDirty.set(index);
+        mVersion++;
     }
 }
 
@@ -41,6 +41,7 @@ namespace metal {
 class MetalDriver;
 class MetalBlitter;
 class MetalBufferPool;
+class MetalHeapPool;
 class MetalRenderTarget;
 class MetalSwapChain;
 class TimerQueryInterface;
@@ -61,6 +62,8 @@ struct MetalContext {
 
     // Supported features.
     bool supportsTextureSwizzling = false;
+    bool supportsTransientHeaps = false;
+    bool supportsMemorylessRenderTargets = false;
     uint8_t maxColorRenderTargets = 4;
     struct {
         uint8_t common;
@@ -83,6 +86,8 @@ struct MetalContext {
     UniformBufferState uniformState[VERTEX_BUFFER_START];
     CullModeStateTracker cullModeState;
     WindingStateTracker windingState;
+    VertexSamplerBindingTracker vertexSamplerBindings;
+    FragmentSamplerBindingTracker fragmentSamplerBindings;
 
     // State caches.
     DepthStencilStateCache depthStencilStateCache;
@@ -95,6 +100,7 @@ struct MetalContext {
     tsl::robin_set<MetalSamplerGroup*> samplerGroups;
 
     MetalBufferPool* bufferPool;
+    MetalHeapPool* heapPool;
 
     MetalSwapChain* currentDrawSwapChain = nil;
     MetalSwapChain* currentReadSwapChain = nil;
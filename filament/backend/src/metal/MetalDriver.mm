@@ -24,6 +24,7 @@
 #include "MetalDriverFactory.h"
 #include "MetalEnums.h"
 #include "MetalHandles.h"
+#include "MetalHeapPool.h"
 #include "MetalState.h"
 #include "MetalTimerQuery.h"
 
@@ -87,6 +88,16 @@ MetalDriver::MetalDriver(backend::MetalPlatform* platform) noexcept
             mContext->highestSupportedGpuFamily.mac   >= 2;     // newer macOS GPUs
     }
 
+    // Transient attachment heaps and memoryless attachments are only a win on TBDR (Apple
+    // family) GPUs, where transients can stay in tile memory or alias each other's memory.
+    // Heaps additionally require hazard tracking to synchronize aliased resources.
+    if (@available(iOS 13, macOS 10.15, *)) {
+        mContext->supportsTransientHeaps = mContext->highestSupportedGpuFamily.apple >= 1;
+    }
+    if (@available(iOS 10, macOS 11, *)) {
+        mContext->supportsMemorylessRenderTargets = mContext->highestSupportedGpuFamily.apple >= 1;
+    }
+
     mContext->maxColorRenderTargets = 4;
     if (mContext->highestSupportedGpuFamily.apple >= 2 ||
         mContext->highestSupportedGpuFamily.mac >= 1) {
@@ -105,6 +116,7 @@ MetalDriver::MetalDriver(backend::MetalPlatform* platform) noexcept
     mContext->depthStencilStateCache.setDevice(mContext->device);
     mContext->samplerStateCache.setDevice(mContext->device);
     mContext->bufferPool = new MetalBufferPool(*mContext);
+    mContext->heapPool = new MetalHeapPool(*mContext);
     mContext->blitter = new MetalBlitter(*mContext);
 
     if (@available(iOS 12, *)) {
@@ -134,6 +146,7 @@ MetalDriver::~MetalDriver() noexcept {
     mContext->emptyTexture = nil;
     CFRelease(mContext->textureCache);
     delete mContext->bufferPool;
+    delete mContext->heapPool;
     delete mContext->blitter;
     delete mContext->timerQueryImpl;
     delete mContext;
@@ -169,12 +182,16 @@ void MetalDriver::execute(std::function<void(void)> fn) noexcept {
 void MetalDriver::setPresentationTime(int64_t monotonic_clock_ns) {
 }
 
+void MetalDriver::setProgramBinaryCacheDirectory(utils::CString&& path) {
+}
+
 void MetalDriver::endFrame(uint32_t frameId) {
     // If we haven't committed the command buffer (if the frame was canceled), do it now. There may
     // be commands in it (like fence signaling) that need to execute.
     submitPendingCommands(mContext);
 
     mContext->bufferPool->gc();
+    mContext->heapPool->gc();
 
     // If we acquired a drawable for this frame, ensure that we release it here.
     if (mContext->currentDrawSwapChain) {
@@ -546,6 +563,7 @@ void MetalDriver::terminate() {
     finish();
 
     mContext->bufferPool->reset();
+    mContext->heapPool->reset();
     mContext->commandQueue = nil;
 
     MetalExternalImage::shutdown(*mContext);
@@ -671,6 +689,11 @@ bool MetalDriver::isFrameTimeSupported() {
     return false;
 }
 
+uint64_t MetalDriver::getMemoryPoolSize() {
+    // The Metal backend doesn't maintain its own memory pools.
+    return 0;
+}
+
 bool MetalDriver::isWorkaroundNeeded(Workaround workaround) {
     switch (workaround) {
         case Workaround::SPLIT_EASU:
@@ -690,6 +713,10 @@ uint8_t MetalDriver::getMaxDrawBuffers() {
     return std::min(mContext->maxColorRenderTargets, MRT::MAX_SUPPORTED_RENDER_TARGET_COUNT);
 }
 
+HandleAllocatorStats MetalDriver::getHandleAllocatorStats() {
+    return mHandleAllocator.getStats();
+}
+
 void MetalDriver::updateIndexBuffer(Handle<HwIndexBuffer> ibh, BufferDescriptor&& data,
         uint32_t byteOffset) {
     auto* ib = handle_cast<MetalIndexBuffer>(ibh);
@@ -847,6 +874,8 @@ void MetalDriver::beginRenderPass(Handle<HwRenderTarget> rth,
     mContext->depthStencilState.invalidate();
     mContext->cullModeState.invalidate();
     mContext->windingState.invalidate();
+    mContext->vertexSamplerBindings.invalidate();
+    mContext->fragmentSamplerBindings.invalidate();
 }
 
 void MetalDriver::nextSubpass(int dummy) {}
@@ -896,6 +925,11 @@ void MetalDriver::commit(Handle<HwSwapChain> sch) {
     swapChain->releaseDrawable();
 }
 
+void MetalDriver::setPresentFrameDamage(Handle<HwSwapChain> sch, uint32_t left, uint32_t bottom,
+        uint32_t width, uint32_t height) {
+    // Partial present is not supported on Metal; the full frame is always presented.
+}
+
 void MetalDriver::bindUniformBuffer(uint32_t index, Handle<HwBufferObject> boh) {
     auto* bo = handle_cast<MetalBufferObject>(boh);
     auto* currentBo = mContext->uniformState[index].buffer;
@@ -1149,7 +1183,8 @@ void MetalDriver::blit(TargetBufferFlags buffers,
     mContext->blitter->blit(getPendingCommandBuffer(mContext), args);
 }
 
-void MetalDriver::draw(backend::PipelineState ps, Handle<HwRenderPrimitive> rph) {
+void MetalDriver::draw(backend::PipelineState ps, Handle<HwRenderPrimitive> rph,
+        uint32_t instanceCount) {
     ASSERT_PRECONDITION(mContext->currentRenderPassEncoder != nullptr,
             "Attempted to draw without a valid command encoder.");
     auto primitive = handle_cast<MetalRenderPrimitive>(rph);
@@ -1287,11 +1322,10 @@ void MetalDriver::draw(backend::PipelineState ps, Handle<HwRenderPrimitive> rph)
         return mContext->samplerStateCache.getOrCreateState(s);
     };
 
-    id<MTLTexture> texturesToBindVertex[backend::MAX_VERTEX_SAMPLER_COUNT] = {};
-    id<MTLSamplerState> samplersToBindVertex[backend::MAX_VERTEX_SAMPLER_COUNT] = {};
+    TexturesAndSamplersState<backend::MAX_VERTEX_SAMPLER_COUNT> vertexBindings;
 
     enumerateSamplerGroups(program, ShaderType::VERTEX,
-            [this, &getTextureToBind, &getSamplerToBind, &texturesToBindVertex, &samplersToBindVertex](
+            [this, &getTextureToBind, &getSamplerToBind, &vertexBindings](
                     const SamplerGroup::Sampler* sampler, uint8_t binding) {
         // We currently only support a max of MAX_VERTEX_SAMPLER_COUNT samplers. Ignore any additional
         // samplers that may be bound.
@@ -1299,7 +1333,7 @@ void MetalDriver::draw(backend::PipelineState ps, Handle<HwRenderPrimitive> rph)
             return;
         }
 
-        auto& textureToBind = texturesToBindVertex[binding];
+        auto& textureToBind = vertexBindings.textures[binding];
         textureToBind = getTextureToBind(sampler);
         if (!textureToBind) {
             utils::slog.w << "Warning: no texture bound at binding point " << (size_t) binding
@@ -1307,29 +1341,32 @@ void MetalDriver::draw(backend::PipelineState ps, Handle<HwRenderPrimitive> rph)
             textureToBind = getOrCreateEmptyTexture(mContext);
         }
 
-        auto& samplerToBind = samplersToBindVertex[binding];
+        auto& samplerToBind = vertexBindings.samplers[binding];
         samplerToBind = getSamplerToBind(sampler);
     });
 
     // Assign a default sampler to empty slots, in case Filament hasn't bound all samplers.
     // Metal requires all samplers referenced in shaders to be bound.
-    for (auto& sampler : samplersToBindVertex) {
+    for (auto& sampler : vertexBindings.samplers) {
         if (!sampler) {
             sampler = mContext->samplerStateCache.getOrCreateState({});
         }
     }
 
-    NSRange vertexSamplerRange = NSMakeRange(0, backend::MAX_VERTEX_SAMPLER_COUNT);
-    [mContext->currentRenderPassEncoder setVertexTextures:texturesToBindVertex
-                                                withRange:vertexSamplerRange];
-    [mContext->currentRenderPassEncoder setVertexSamplerStates:samplersToBindVertex
-                                                     withRange:vertexSamplerRange];
+    // Only re-issue the encoder calls if the bindings have changed since the previous draw.
+    mContext->vertexSamplerBindings.updateState(vertexBindings);
+    if (mContext->vertexSamplerBindings.stateChanged()) {
+        NSRange vertexSamplerRange = NSMakeRange(0, backend::MAX_VERTEX_SAMPLER_COUNT);
+        [mContext->currentRenderPassEncoder setVertexTextures:vertexBindings.textures
+                                                    withRange:vertexSamplerRange];
+        [mContext->currentRenderPassEncoder setVertexSamplerStates:vertexBindings.samplers
+                                                         withRange:vertexSamplerRange];
+    }
 
-    id<MTLTexture> texturesToBindFragment[backend::MAX_FRAGMENT_SAMPLER_COUNT] = {};
-    id<MTLSamplerState> samplersToBindFragment[backend::MAX_FRAGMENT_SAMPLER_COUNT] = {};
+    TexturesAndSamplersState<backend::MAX_FRAGMENT_SAMPLER_COUNT> fragmentBindings;
 
     enumerateSamplerGroups(program, ShaderType::FRAGMENT,
-            [this, &getTextureToBind, &getSamplerToBind, &texturesToBindFragment, &samplersToBindFragment](
+            [this, &getTextureToBind, &getSamplerToBind, &fragmentBindings](
                     const SamplerGroup::Sampler* sampler, uint8_t binding) {
         // We currently only support a max of MAX_FRAGMENT_SAMPLER_COUNT samplers. Ignore any additional
         // samplers that may be bound.
@@ -1337,7 +1374,7 @@ void MetalDriver::draw(backend::PipelineState ps, Handle<HwRenderPrimitive> rph)
             return;
         }
 
-        auto& textureToBind = texturesToBindFragment[binding];
+        auto& textureToBind = fragmentBindings.textures[binding];
         textureToBind = getTextureToBind(sampler);
         if (!textureToBind) {
             utils::slog.w << "Warning: no texture bound at binding point " << (size_t) binding
@@ -1345,23 +1382,27 @@ void MetalDriver::draw(backend::PipelineState ps, Handle<HwRenderPrimitive> rph)
             textureToBind = getOrCreateEmptyTexture(mContext);
         }
 
-        auto& samplerToBind = samplersToBindFragment[binding];
+        auto& samplerToBind = fragmentBindings.samplers[binding];
         samplerToBind = getSamplerToBind(sampler);
     });
 
     // Assign a default sampler to empty slots, in case Filament hasn't bound all samplers.
     // Metal requires all samplers referenced in shaders to be bound.
-    for (auto& sampler : samplersToBindFragment) {
+    for (auto& sampler : fragmentBindings.samplers) {
         if (!sampler) {
             sampler = mContext->samplerStateCache.getOrCreateState({});
         }
     }
 
-    NSRange fragmentSamplerRange = NSMakeRange(0, backend::MAX_FRAGMENT_SAMPLER_COUNT);
-    [mContext->currentRenderPassEncoder setFragmentTextures:texturesToBindFragment
-                                                  withRange:fragmentSamplerRange];
-    [mContext->currentRenderPassEncoder setFragmentSamplerStates:samplersToBindFragment
-                                                       withRange:fragmentSamplerRange];
+    // Only re-issue the encoder calls if the bindings have changed since the previous draw.
+    mContext->fragmentSamplerBindings.updateState(fragmentBindings);
+    if (mContext->fragmentSamplerBindings.stateChanged()) {
+        NSRange fragmentSamplerRange = NSMakeRange(0, backend::MAX_FRAGMENT_SAMPLER_COUNT);
+        [mContext->currentRenderPassEncoder setFragmentTextures:fragmentBindings.textures
+                                                      withRange:fragmentSamplerRange];
+        [mContext->currentRenderPassEncoder setFragmentSamplerStates:fragmentBindings.samplers
+                                                           withRange:fragmentSamplerRange];
+    }
 
     // Bind the vertex buffers.
 
@@ -1402,7 +1443,8 @@ void MetalDriver::draw(backend::PipelineState ps, Handle<HwRenderPrimitive> rph)
                                                    indexCount:primitive->count
                                                     indexType:getIndexType(indexBuffer->elementSize)
                                                   indexBuffer:metalIndexBuffer
-                                            indexBufferOffset:primitive->offset + offset];
+                                            indexBufferOffset:primitive->offset + offset
+                                                instanceCount:instanceCount];
 }
 
 void MetalDriver::beginTimerQuery(Handle<HwTimerQuery> tqh) {
@@ -209,6 +209,10 @@ struct MetalTexture : public HwTexture {
 
     static MTLPixelFormat decidePixelFormat(MetalContext* context, TextureFormat format);
 
+    // Allocates the underlying MTLTexture, either from the transient heap pool or directly from
+    // the device.
+    id<MTLTexture> allocateTexture(MTLTextureDescriptor* descriptor);
+
     MetalContext& context;
     MetalExternalImage externalImage;
     id<MTLTexture> texture = nil;
@@ -226,6 +230,10 @@ struct MetalTexture : public HwTexture {
     MTLPixelFormat devicePixelFormat;
     uint32_t minLod = UINT_MAX;
     uint32_t maxLod = 0;
+
+    // True if "texture" was allocated from the transient heap pool, in which case its memory is
+    // made aliasable when this texture is destroyed.
+    bool heapAllocated = false;
 };
 
 struct MetalSamplerGroup : public HwSamplerGroup {
@@ -295,7 +303,7 @@ private:
 
     static MTLLoadAction getLoadAction(const RenderPassParams& params, TargetBufferFlags buffer);
     static MTLStoreAction getStoreAction(const RenderPassParams& params, TargetBufferFlags buffer);
-    static id<MTLTexture> createMultisampledTexture(id<MTLDevice> device, MTLPixelFormat format,
+    static id<MTLTexture> createMultisampledTexture(MetalContext* context, MTLPixelFormat format,
             uint32_t width, uint32_t height, uint8_t samples);
 
     MetalContext* context;
@@ -18,6 +18,7 @@
 
 #include "MetalBlitter.h"
 #include "MetalEnums.h"
+#include "MetalHeapPool.h"
 #include "MetalUtils.h"
 
 #include <filament/SwapChain.h>
@@ -472,8 +473,7 @@ MetalTexture::MetalTexture(MetalContext& context, SamplerType target, uint8_t le
             descriptor.sampleCount = multisampled ? samples : 1;
             descriptor.usage = getMetalTextureUsage(usage);
             descriptor.storageMode = MTLStorageModePrivate;
-            texture = [context.device newTextureWithDescriptor:descriptor];
-            ASSERT_POSTCONDITION(texture != nil, "Could not create Metal texture. Out of memory?");
+            texture = allocateTexture(descriptor);
             break;
         case SamplerType::SAMPLER_CUBEMAP:
             ASSERT_POSTCONDITION(!multisampled, "Multisampled cubemap faces not supported.");
@@ -484,8 +484,7 @@ MetalTexture::MetalTexture(MetalContext& context, SamplerType target, uint8_t le
             descriptor.mipmapLevelCount = levels;
             descriptor.usage = getMetalTextureUsage(usage);
             descriptor.storageMode = MTLStorageModePrivate;
-            texture = [context.device newTextureWithDescriptor:descriptor];
-            ASSERT_POSTCONDITION(texture != nil, "Could not create Metal texture. Out of memory?");
+            texture = allocateTexture(descriptor);
             break;
         case SamplerType::SAMPLER_3D:
             descriptor = [MTLTextureDescriptor new];
@@ -497,8 +496,7 @@ MetalTexture::MetalTexture(MetalContext& context, SamplerType target, uint8_t le
             descriptor.mipmapLevelCount = levels;
             descriptor.usage = getMetalTextureUsage(usage);
             descriptor.storageMode = MTLStorageModePrivate;
-            texture = [context.device newTextureWithDescriptor:descriptor];
-            ASSERT_POSTCONDITION(texture != nil, "Could not create Metal texture. Out of memory?");
+            texture = allocateTexture(descriptor);
             break;
         case SamplerType::SAMPLER_EXTERNAL:
             // If we're using external textures (CVPixelBufferRefs), we don't need to make any
@@ -538,6 +536,24 @@ MetalTexture::MetalTexture(MetalContext& context, SamplerType target, uint8_t le
 
 MetalTexture::~MetalTexture() {
     externalImage.set(nullptr);
+    if (heapAllocated) {
+        context.heapPool->releaseTexture(texture);
+    }
+}
+
+id<MTLTexture> MetalTexture::allocateTexture(MTLTextureDescriptor* descriptor) {
+    // Transient render target textures are placement-allocated from shared heaps when possible,
+    // so attachments with disjoint lifetimes within the frame can alias the same memory.
+    if (any(usage & TextureUsage::TRANSIENT)) {
+        id<MTLTexture> heapTexture = context.heapPool->createTexture(descriptor);
+        if (heapTexture) {
+            heapAllocated = true;
+            return heapTexture;
+        }
+    }
+    id<MTLTexture> deviceTexture = [context.device newTextureWithDescriptor:descriptor];
+    ASSERT_POSTCONDITION(deviceTexture != nil, "Could not create Metal texture. Out of memory?");
+    return deviceTexture;
 }
 
 
@@ -820,7 +836,7 @@ MetalRenderTarget::MetalRenderTarget(MetalContext* context, uint32_t width, uint
         if (samples > 1 && color[i].getSampleCount() == 1) {
             auto& sidecar = color[i].metalTexture->msaaSidecar;
             if (!sidecar) {
-                sidecar = createMultisampledTexture(context->device, color[i].getPixelFormat(),
+                sidecar = createMultisampledTexture(context, color[i].getPixelFormat(),
                         color[i].metalTexture->width, color[i].metalTexture->height, samples);
             }
         }
@@ -838,7 +854,7 @@ MetalRenderTarget::MetalRenderTarget(MetalContext* context, uint32_t width, uint
         if (samples > 1 && depth.getSampleCount() == 1) {
             auto& sidecar = depth.metalTexture->msaaSidecar;
             if (!sidecar) {
-                sidecar = createMultisampledTexture(context->device, depth.getPixelFormat(),
+                sidecar = createMultisampledTexture(context, depth.getPixelFormat(),
                         depth.metalTexture->width, depth.metalTexture->height, samples);
             }
         }
@@ -968,7 +984,7 @@ MTLStoreAction MetalRenderTarget::getStoreAction(const RenderPassParams& params,
     return MTLStoreActionStore;
 }
 
-id<MTLTexture> MetalRenderTarget::createMultisampledTexture(id<MTLDevice> device,
+id<MTLTexture> MetalRenderTarget::createMultisampledTexture(MetalContext* context,
         MTLPixelFormat format, uint32_t width, uint32_t height, uint8_t samples) {
     MTLTextureDescriptor* descriptor =
             [MTLTextureDescriptor texture2DDescriptorWithPixelFormat:format
@@ -978,9 +994,18 @@ id<MTLTexture> MetalRenderTarget::createMultisampledTexture(id<MTLDevice> device
     descriptor.textureType = MTLTextureType2DMultisample;
     descriptor.sampleCount = samples;
     descriptor.usage = MTLTextureUsageRenderTarget;
-    descriptor.resourceOptions = MTLResourceStorageModePrivate;
+    descriptor.storageMode = MTLStorageModePrivate;
+
+    // The sidecar is only ever rendered into and resolved from within a single render pass (its
+    // load action is never LOAD and it is never stored), so on TBDR GPUs it can live entirely in
+    // tile memory and doesn't need any system memory backing it.
+    if (context->supportsMemorylessRenderTargets) {
+        if (@available(iOS 10, macOS 11, *)) {
+            descriptor.storageMode = MTLStorageModeMemoryless;
+        }
+    }
 
-    return [device newTextureWithDescriptor:descriptor];
+    return [context->device newTextureWithDescriptor:descriptor];
 }
 
 MetalFence::MetalFence(MetalContext& context) : context(context), value(context.signalId++) { }
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_DRIVER_METALHEAPPOOL_H
+#define TNT_FILAMENT_DRIVER_METALHEAPPOOL_H
+
+#include <Metal/Metal.h>
+
+#include <mutex>
+#include <vector>
+
+namespace filament {
+namespace backend {
+namespace metal {
+
+struct MetalContext;
+
+// Sub-allocates transient render target textures from shared MTLHeaps, so that attachments with
+// disjoint lifetimes within a frame can alias the same memory.
+//
+// The frame graph devirtualizes and destroys its transient textures in the order computed by its
+// compile step, so allocation and release order already reflect resource lifetimes; the heaps'
+// automatic placement turns that ordering into memory aliasing. Heaps are created with hazard
+// tracking so aliased resources are synchronized by Metal.
+class MetalHeapPool {
+public:
+    explicit MetalHeapPool(MetalContext& context) noexcept : mContext(context) {}
+
+    // Allocates a texture from one of the pool's heaps, growing the pool if needed.
+    // Returns nil if heap allocation is unsupported or failed; the caller is expected to fall
+    // back to a regular device allocation.
+    id<MTLTexture> createTexture(MTLTextureDescriptor* descriptor);
+
+    // Marks the texture's heap memory as reusable once the GPU has finished the work currently
+    // queued on the pending command buffer.
+    void releaseTexture(id<MTLTexture> texture);
+
+    // Makes GPU-retired textures aliasable, evicts heaps that have been empty for a while, and
+    // bumps the current frame number.
+    void gc() noexcept;
+
+    // Destroys all heaps. All textures created from this pool must have been released, and all
+    // GPU work using them must have finished.
+    void reset() noexcept;
+
+private:
+    MetalContext& mContext;
+
+    struct HeapEntry {
+        id<MTLHeap> heap;
+        uint64_t lastUsed;
+    };
+    std::vector<HeapEntry> mHeaps;
+
+    // Synchronizes access to mRetiredTextures, which is filled from command buffer completion
+    // handlers (a Metal callback thread) and drained by gc() on the driver thread.
+    std::mutex mMutex;
+    std::vector<id<MTLTexture>> mRetiredTextures;
+
+    // Store the current "time" (really just a frame count) and LRU eviction parameters.
+    uint64_t mCurrentFrame = 0;
+    static constexpr uint32_t TIME_BEFORE_EVICTION = 10;
+
+    // Heaps are allocated in fixed-size blocks (or larger, if a single texture needs it).
+    static constexpr size_t HEAP_BLOCK_SIZE = 32 * 1024 * 1024;
+};
+
+} // namespace metal
+} // namespace backend
+} // namespace filament
+
+#endif // TNT_FILAMENT_DRIVER_METALHEAPPOOL_H
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "MetalHeapPool.h"
+
+#include "MetalContext.h"
+
+#include <algorithm>
+
+namespace filament {
+namespace backend {
+namespace metal {
+
+id<MTLTexture> MetalHeapPool::createTexture(MTLTextureDescriptor* descriptor) {
+    if (!mContext.supportsTransientHeaps) {
+        return nil;
+    }
+    if (@available(iOS 13, macOS 10.15, *)) {
+        const MTLSizeAndAlign sizeAndAlign =
+                [mContext.device heapTextureSizeAndAlignWithDescriptor:descriptor];
+
+        // Try existing heaps first, newest last: the most recent heap is the most likely to have
+        // freshly aliasable space.
+        for (auto it = mHeaps.rbegin(); it != mHeaps.rend(); ++it) {
+            if ([it->heap maxAvailableSizeWithAlignment:sizeAndAlign.align] < sizeAndAlign.size) {
+                continue;
+            }
+            id<MTLTexture> texture = [it->heap newTextureWithDescriptor:descriptor];
+            if (texture) {
+                it->lastUsed = mCurrentFrame;
+                return texture;
+            }
+        }
+
+        MTLHeapDescriptor* heapDescriptor = [MTLHeapDescriptor new];
+        heapDescriptor.size = std::max(HEAP_BLOCK_SIZE, (size_t) sizeAndAlign.size);
+        heapDescriptor.storageMode = MTLStorageModePrivate;
+        // Aliased resources must be synchronized by Metal, we don't fence them manually.
+        heapDescriptor.hazardTrackingMode = MTLHazardTrackingModeTracked;
+        id<MTLHeap> heap = [mContext.device newHeapWithDescriptor:heapDescriptor];
+        if (!heap) {
+            // Let the caller allocate from the device instead.
+            return nil;
+        }
+        mHeaps.push_back({ heap, mCurrentFrame });
+        return [heap newTextureWithDescriptor:descriptor];
+    }
+    return nil;
+}
+
+void MetalHeapPool::releaseTexture(id<MTLTexture> texture) {
+    // The texture might still be used by GPU work already encoded in the pending command buffer,
+    // so its memory can only be aliased after that work has retired.
+    [getPendingCommandBuffer(&mContext) addCompletedHandler:^(id<MTLCommandBuffer>) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mRetiredTextures.push_back(texture);
+    }];
+}
+
+void MetalHeapPool::gc() noexcept {
+    std::vector<id<MTLTexture>> retired;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        retired.swap(mRetiredTextures);
+    }
+    if (@available(iOS 13, macOS 10.15, *)) {
+        for (id<MTLTexture> texture : retired) {
+            // Subsequent heap allocations may now reuse this texture's memory.
+            [texture makeAliasable];
+        }
+        retired.clear();
+
+        const uint64_t evictionTime = mCurrentFrame++;
+        if (evictionTime < TIME_BEFORE_EVICTION) {
+            return;
+        }
+        for (auto it = mHeaps.begin(); it != mHeaps.end();) {
+            if (it->heap.usedSize == 0 && it->lastUsed < evictionTime - TIME_BEFORE_EVICTION) {
+                it = mHeaps.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+void MetalHeapPool::reset() noexcept {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mRetiredTextures.clear();
+    }
+    mHeaps.clear();
+}
+
+} // namespace metal
+} // namespace backend
+} // namespace filament
@@ -338,6 +338,32 @@ struct SamplerStateCreator {
 
 using SamplerStateCache = StateCache<SamplerState, id<MTLSamplerState>, SamplerStateCreator>;
 
+// Texture and sampler bindings
+
+// TexturesAndSamplersState represents the complete set of textures and sampler states bound to a
+// single shader stage. Tracking it lets the driver skip the per-draw setTextures /
+// setSamplerStates encoder calls when consecutive draws use the same bindings, which is the
+// common case when draw calls are sorted by material.
+template<NSUInteger N>
+struct TexturesAndSamplersState {
+    id<MTLTexture> textures[N] = {};
+    id<MTLSamplerState> samplers[N] = {};
+
+    bool operator==(const TexturesAndSamplersState& rhs) const noexcept {
+        return std::equal(textures, textures + N, rhs.textures) &&
+               std::equal(samplers, samplers + N, rhs.samplers);
+    }
+
+    bool operator!=(const TexturesAndSamplersState& rhs) const noexcept {
+        return !operator==(rhs);
+    }
+};
+
+using VertexSamplerBindingTracker =
+        StateTracker<TexturesAndSamplersState<backend::MAX_VERTEX_SAMPLER_COUNT>>;
+using FragmentSamplerBindingTracker =
+        StateTracker<TexturesAndSamplersState<backend::MAX_FRAGMENT_SAMPLER_COUNT>>;
+
 // Raster-related state
 
 using CullModeStateTracker = StateTracker<MTLCullMode>;
@@ -17,6 +17,15 @@
 #include "noop/NoopDriver.h"
 #include "CommandStreamDispatcher.h"
 
+#include <utils/Log.h>
+
+#include <thread>
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 namespace filament {
 
 using namespace backend;
@@ -26,6 +35,66 @@ Driver* NoopDriver::create() {
 }
 
 NoopDriver::NoopDriver() noexcept : DriverBase(new ConcreteDispatcher<NoopDriver>()) {
+    loadTimingModel();
+}
+
+void NoopDriver::loadTimingModel() noexcept {
+    const char* const path = getenv("FILAMENT_NOOP_TIMING_MODEL");
+    if (!path) {
+        return;
+    }
+    FILE* const file = fopen(path, "r");
+    if (!file) {
+        utils::slog.w << "NoopDriver: can't open timing model \""
+                      << path << "\"" << utils::io::endl;
+        return;
+    }
+    // one "<commandClass> = <nanoseconds>" entry per line, '#' starts a comment
+    char line[256];
+    while (fgets(line, sizeof(line), file)) {
+        char name[64];
+        uint64_t cost;
+        if (line[0] == '#' || sscanf(line, " %63[A-Za-z] = %" SCNu64, name, &cost) != 2) {
+            continue;
+        }
+        if (!strcmp(name, "draw")) {
+            mTimingModel.draw = cost;
+        } else if (!strcmp(name, "beginRenderPass")) {
+            mTimingModel.beginRenderPass = cost;
+        } else if (!strcmp(name, "endRenderPass")) {
+            mTimingModel.endRenderPass = cost;
+        } else if (!strcmp(name, "bind")) {
+            mTimingModel.bind = cost;
+        } else if (!strcmp(name, "updateBuffer")) {
+            mTimingModel.updateBuffer = cost;
+        } else if (!strcmp(name, "updateTexture")) {
+            mTimingModel.updateTexture = cost;
+        } else if (!strcmp(name, "uploadPerKiB")) {
+            mTimingModel.uploadPerKiB = cost;
+        } else if (!strcmp(name, "commit")) {
+            mTimingModel.commit = cost;
+        } else {
+            utils::slog.w << "NoopDriver: unknown timing model entry \""
+                          << name << "\"" << utils::io::endl;
+        }
+    }
+    fclose(file);
+    mTimingModel.enabled = true;
+    mModelEpoch = std::chrono::steady_clock::now();
+}
+
+UTILS_NOINLINE
+void NoopDriver::modelSlow(uint64_t costNs) noexcept {
+    mModeledTimeNs += costNs;
+    const int64_t elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - mModelEpoch).count();
+    const int64_t debtNs = int64_t(mModeledTimeNs) - elapsedNs;
+    if (debtNs < 0) {
+        // the driver thread was idle, idle time is not banked against future commands
+        mModeledTimeNs = uint64_t(elapsedNs);
+    } else if (debtNs > MODEL_SLEEP_GRANULARITY_NS) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(debtNs));
+    }
 }
 
 NoopDriver::~NoopDriver() noexcept = default;
@@ -64,6 +133,9 @@ void NoopDriver::setFrameCompletedCallback(Handle<HwSwapChain> sch,
 void NoopDriver::setPresentationTime(int64_t monotonic_clock_ns) {
 }
 
+void NoopDriver::setProgramBinaryCacheDirectory(utils::CString&& path) {
+}
+
 void NoopDriver::endFrame(uint32_t frameId) {
 }
 
@@ -180,13 +252,24 @@ uint8_t NoopDriver::getMaxDrawBuffers() {
     return backend::MRT::MAX_SUPPORTED_RENDER_TARGET_COUNT;
 }
 
+uint64_t NoopDriver::getMemoryPoolSize() {
+    return 0;
+}
+
+HandleAllocatorStats NoopDriver::getHandleAllocatorStats() {
+    // NoopDriver doesn't allocate any handles
+    return HandleAllocatorStats{};
+}
+
 void NoopDriver::updateIndexBuffer(Handle<HwIndexBuffer> ibh, BufferDescriptor&& p,
         uint32_t byteOffset) {
+    model(mTimingModel.updateBuffer + p.size * mTimingModel.uploadPerKiB / 1024u);
     scheduleDestroy(std::move(p));
 }
 
 void NoopDriver::updateBufferObject(Handle<HwBufferObject> ibh, BufferDescriptor&& p,
         uint32_t byteOffset) {
+    model(mTimingModel.updateBuffer + p.size * mTimingModel.uploadPerKiB / 1024u);
     scheduleDestroy(std::move(p));
 }
 
@@ -197,6 +280,7 @@ void NoopDriver::setVertexBufferObject(Handle<HwVertexBuffer> vbh, uint32_t inde
 void NoopDriver::update2DImage(Handle<HwTexture> th,
         uint32_t level, uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height,
         PixelBufferDescriptor&& data) {
+    model(mTimingModel.updateTexture + data.size * mTimingModel.uploadPerKiB / 1024u);
     scheduleDestroy(std::move(data));
 }
 
@@ -207,11 +291,13 @@ void NoopDriver::update3DImage(Handle<HwTexture> th,
         uint32_t level, uint32_t xoffset, uint32_t yoffset, uint32_t zoffset,
         uint32_t width, uint32_t height, uint32_t depth,
         PixelBufferDescriptor&& data) {
+    model(mTimingModel.updateTexture + data.size * mTimingModel.uploadPerKiB / 1024u);
     scheduleDestroy(std::move(data));
 }
 
 void NoopDriver::updateCubeImage(Handle<HwTexture> th, uint32_t level,
         PixelBufferDescriptor&& data, FaceOffsets faceOffsets) {
+    model(mTimingModel.updateTexture + data.size * mTimingModel.uploadPerKiB / 1024u);
     scheduleDestroy(std::move(data));
 }
 
@@ -249,9 +335,11 @@ void NoopDriver::updateSamplerGroup(Handle<HwSamplerGroup> sbh,
 }
 
 void NoopDriver::beginRenderPass(Handle<HwRenderTarget> rth, const RenderPassParams& params) {
+    model(mTimingModel.beginRenderPass);
 }
 
 void NoopDriver::endRenderPass(int) {
+    model(mTimingModel.endRenderPass);
 }
 
 void NoopDriver::nextSubpass(int) {
@@ -270,16 +358,24 @@ void NoopDriver::makeCurrent(Handle<HwSwapChain> drawSch, Handle<HwSwapChain> re
 }
 
 void NoopDriver::commit(Handle<HwSwapChain> sch) {
+    model(mTimingModel.commit);
+}
+
+void NoopDriver::setPresentFrameDamage(Handle<HwSwapChain> sch, uint32_t left, uint32_t bottom,
+        uint32_t width, uint32_t height) {
 }
 
 void NoopDriver::bindUniformBuffer(uint32_t index, Handle<HwBufferObject> ubh) {
+    model(mTimingModel.bind);
 }
 
 void NoopDriver::bindUniformBufferRange(uint32_t index, Handle<HwBufferObject> ubh,
         uint32_t offset, uint32_t size) {
+    model(mTimingModel.bind);
 }
 
 void NoopDriver::bindSamplers(uint32_t index, Handle<HwSamplerGroup> sbh) {
+    model(mTimingModel.bind);
 }
 
 void NoopDriver::insertEventMarker(char const* string, uint32_t len) {
@@ -314,7 +410,9 @@ void NoopDriver::blit(TargetBufferFlags buffers,
         SamplerMagFilter filter) {
 }
 
-void NoopDriver::draw(PipelineState pipelineState, Handle<HwRenderPrimitive> rph) {
+void NoopDriver::draw(PipelineState pipelineState, Handle<HwRenderPrimitive> rph,
+        uint32_t instanceCount) {
+    model(mTimingModel.draw);
 }
 
 void NoopDriver::beginTimerQuery(Handle<HwTimerQuery> tqh) {
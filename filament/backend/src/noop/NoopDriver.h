@@ -22,6 +22,10 @@
 
 #include <utils/compiler.h>
 
+#include <chrono>
+
+#include <stdint.h>
+
 namespace filament {
 
 class NoopDriver final : public backend::DriverBase {
@@ -34,6 +38,41 @@ public:
 private:
     backend::ShaderModel getShaderModel() const noexcept final;
 
+    // Optional timing model: per command-class costs in nanoseconds, measured on a real
+    // device and loaded from the file named by FILAMENT_NOOP_TIMING_MODEL (see
+    // loadTimingModel() for the format). When loaded, the driver thread sleeps to match
+    // the modeled cost of the commands it executes, which reproduces device driver-thread
+    // backpressure during headless CPU profiling. Without the variable, NoopDriver
+    // behaves as before and discards everything immediately.
+    struct TimingModel {
+        bool enabled = false;
+        uint64_t draw = 0;              // per draw call
+        uint64_t beginRenderPass = 0;   // per render pass begin
+        uint64_t endRenderPass = 0;     // per render pass end
+        uint64_t bind = 0;              // per uniform/sampler-group binding
+        uint64_t updateBuffer = 0;      // per buffer update
+        uint64_t updateTexture = 0;     // per texture update
+        uint64_t uploadPerKiB = 0;      // additional cost per KiB uploaded
+        uint64_t commit = 0;            // per swap-chain commit
+    };
+
+    // sleep in coarse chunks so we don't pay a syscall per command
+    static constexpr int64_t MODEL_SLEEP_GRANULARITY_NS = 200000;
+
+    void loadTimingModel() noexcept;
+
+    UTILS_ALWAYS_INLINE void model(uint64_t costNs) noexcept {
+        if (UTILS_UNLIKELY(mTimingModel.enabled)) {
+            modelSlow(costNs);
+        }
+    }
+
+    void modelSlow(uint64_t costNs) noexcept;
+
+    TimingModel mTimingModel;
+    uint64_t mModeledTimeNs = 0;
+    std::chrono::steady_clock::time_point mModelEpoch;
+
     /*
      * Driver interface
      */
@@ -276,6 +276,7 @@ bool OpenGLContext::hasExtension(ExtentionSet const& map, utils::StaticString ex
 void OpenGLContext::initExtensionsGLES(GLint major, GLint minor, ExtentionSet const& exts) {
     // figure out and initialize the extensions we need
     ext.APPLE_color_buffer_packed_float = hasExtension(exts, "GL_APPLE_color_buffer_packed_float");
+    ext.ARM_shader_framebuffer_fetch = hasExtension(exts, "GL_ARM_shader_framebuffer_fetch");
     ext.EXT_clip_control = hasExtension(exts, "GL_EXT_clip_control");
     ext.EXT_color_buffer_float = hasExtension(exts, "GL_EXT_color_buffer_float");
     ext.EXT_color_buffer_half_float = hasExtension(exts, "GL_EXT_color_buffer_half_float");
@@ -332,6 +333,9 @@ void OpenGLContext::bindBuffer(GLenum target, GLuint buffer) noexcept {
                 state.vao.p->elementArray = buffer;
             }
             glBindBuffer(target, buffer);
+            mStateChangeStats.issued++;
+        } else {
+            mStateChangeStats.filtered++;
         }
     } else {
         update_state(state.buffers.genericBinding[targetIndex], buffer, [&]() {
@@ -376,7 +380,10 @@ void OpenGLContext::pixelStore(GLenum pname, GLint param) noexcept {
         *pcur = param;
 default_case:
         glPixelStorei(pname, param);
+        mStateChangeStats.issued++;
+        return;
     }
+    mStateChangeStats.filtered++;
 }
 
 void OpenGLContext::unbindTexture(GLenum target, GLuint texture_id) noexcept {
@@ -133,6 +133,7 @@ public:
     struct {
         bool APPLE_color_buffer_packed_float = false;
         bool ARB_shading_language_packing = false;
+        bool ARM_shader_framebuffer_fetch = false;
         bool EXT_clip_control = false;
         bool EXT_color_buffer_float = false;
         bool EXT_color_buffer_half_float = false;
@@ -236,6 +237,23 @@ public:
                     ""},
     }};
 
+    // Counts of state-change requests since the last resetStateChangeStats() call (typically one
+    // frame): how many were issued to GL, and how many were filtered out because the shadowed
+    // state showed them to be redundant. The ratio is a good indicator of how much driver
+    // overhead the state cache is saving, which matters on tiler GPUs where the GL call overhead
+    // itself is significant.
+    struct StateChangeStats {
+        uint32_t issued = 0;
+        uint32_t filtered = 0;
+    };
+    StateChangeStats const& getStateChangeStats() const noexcept { return mStateChangeStats; }
+    void resetStateChangeStats() noexcept { mStateChangeStats = {}; }
+
+    // Monotonic count of effective texture-unit binding changes (textures and samplers).
+    // If it hasn't moved, the units still hold exactly what the last user bound, which lets
+    // OpenGLProgram skip redundant sampler walks (see OpenGLProgram::updateSamplers()).
+    uint32_t getTextureUnitEpoch() const noexcept { return mTextureUnitEpoch; }
+
     // state getters -- as needed.
     GLuint getDrawFbo() const noexcept { return state.draw_fbo; }
     vec4gli const& getViewport() const { return state.window.viewport; }
@@ -244,6 +262,7 @@ public:
     void updateTexImage(GLenum target, GLuint id) noexcept {
         const size_t index = getIndexForTextureTarget(target);
         state.textures.units[state.textures.active].targets[index].texture_id = id;
+        mTextureUnitEpoch++;
     }
     void resetProgram() noexcept { state.program.use = 0; }
 
@@ -337,11 +356,19 @@ private:
 
     RenderPrimitive mDefaultVAO;
 
+    StateChangeStats mStateChangeStats;
+
+    // starts at 1 so that a program's default epoch of 0 never matches
+    uint32_t mTextureUnitEpoch = 1;
+
     template <typename T, typename F>
-    static inline void update_state(T& state, T const& expected, F functor, bool force = false) noexcept {
+    inline void update_state(T& state, T const& expected, F functor, bool force = false) noexcept {
         if (UTILS_UNLIKELY(force || state != expected)) {
             state = expected;
             functor();
+            mStateChangeStats.issued++;
+        } else {
+            mStateChangeStats.filtered++;
         }
     }
 
@@ -423,6 +450,7 @@ void OpenGLContext::bindSampler(GLuint unit, GLuint sampler) noexcept {
     assert_invariant(unit < MAX_TEXTURE_UNIT_COUNT);
     update_state(state.textures.units[unit].sampler, sampler, [&]() {
         glBindSampler(unit, sampler);
+        mTextureUnitEpoch++;
     });
 }
 
@@ -476,6 +504,9 @@ void OpenGLContext::bindBufferRange(GLenum target, GLuint index, GLuint buffer,
         state.buffers.targets[targetIndex].buffers[index].size = size;
         state.buffers.genericBinding[targetIndex] = buffer;
         glBindBufferRange(target, index, buffer, offset, size);
+        mStateChangeStats.issued++;
+    } else {
+        mStateChangeStats.filtered++;
     }
 }
 
@@ -485,18 +516,27 @@ void OpenGLContext::bindFramebuffer(GLenum target, GLuint buffer) noexcept {
             if (state.draw_fbo != buffer || state.read_fbo != buffer) {
                 state.draw_fbo = state.read_fbo = buffer;
                 glBindFramebuffer(target, buffer);
+                mStateChangeStats.issued++;
+            } else {
+                mStateChangeStats.filtered++;
             }
             break;
         case GL_DRAW_FRAMEBUFFER:
             if (state.draw_fbo != buffer) {
                 state.draw_fbo = buffer;
                 glBindFramebuffer(target, buffer);
+                mStateChangeStats.issued++;
+            } else {
+                mStateChangeStats.filtered++;
             }
             break;
         case GL_READ_FRAMEBUFFER:
             if (state.read_fbo != buffer) {
                 state.read_fbo = buffer;
                 glBindFramebuffer(target, buffer);
+                mStateChangeStats.issued++;
+            } else {
+                mStateChangeStats.filtered++;
             }
             break;
         default:
@@ -510,6 +550,7 @@ void OpenGLContext::bindTexture(GLuint unit, GLuint target, GLuint texId, size_t
     update_state(state.textures.units[unit].targets[targetIndex].texture_id, texId, [&]() {
         activeTexture(unit);
         glBindTexture(target, texId);
+        mTextureUnitEpoch++;
     }, (target == GL_TEXTURE_EXTERNAL_OES) && bugs.texture_external_needs_rebind);
 }
 
@@ -529,6 +570,9 @@ void OpenGLContext::enableVertexAttribArray(GLuint index) noexcept {
     if (UTILS_UNLIKELY(!state.vao.p->vertexAttribArray[index])) {
         state.vao.p->vertexAttribArray.set(index);
         glEnableVertexAttribArray(index);
+        mStateChangeStats.issued++;
+    } else {
+        mStateChangeStats.filtered++;
     }
 }
 
@@ -538,6 +582,9 @@ void OpenGLContext::disableVertexAttribArray(GLuint index) noexcept {
     if (UTILS_UNLIKELY(state.vao.p->vertexAttribArray[index])) {
         state.vao.p->vertexAttribArray.unset(index);
         glDisableVertexAttribArray(index);
+        mStateChangeStats.issued++;
+    } else {
+        mStateChangeStats.filtered++;
     }
 }
 
@@ -546,6 +593,9 @@ void OpenGLContext::enable(GLenum cap) noexcept {
     if (UTILS_UNLIKELY(!state.enables.caps[index])) {
         state.enables.caps.set(index);
         glEnable(cap);
+        mStateChangeStats.issued++;
+    } else {
+        mStateChangeStats.filtered++;
     }
 }
 
@@ -554,6 +604,9 @@ void OpenGLContext::disable(GLenum cap) noexcept {
     if (UTILS_UNLIKELY(state.enables.caps[index])) {
         state.enables.caps.unset(index);
         glDisable(cap);
+        mStateChangeStats.issued++;
+    } else {
+        mStateChangeStats.filtered++;
     }
 }
 
@@ -578,6 +631,9 @@ void OpenGLContext::blendEquation(GLenum modeRGB, GLenum modeA) noexcept {
         state.raster.blendEquationRGB = modeRGB;
         state.raster.blendEquationA   = modeA;
         glBlendEquationSeparate(modeRGB, modeA);
+        mStateChangeStats.issued++;
+    } else {
+        mStateChangeStats.filtered++;
     }
 }
 
@@ -593,6 +649,9 @@ void OpenGLContext::blendFunction(GLenum srcRGB, GLenum srcA, GLenum dstRGB, GLe
         state.raster.blendFunctionDstRGB = dstRGB;
         state.raster.blendFunctionDstA = dstA;
         glBlendFuncSeparate(srcRGB, dstRGB, srcA, dstA);
+        mStateChangeStats.issued++;
+    } else {
+        mStateChangeStats.filtered++;
     }
 }
 
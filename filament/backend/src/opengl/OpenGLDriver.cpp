@@ -26,6 +26,7 @@
 #include "TimerQuery.h"
 #include "OpenGLContext.h"
 
+#include <utils/algorithm.h>
 #include <utils/compiler.h>
 #include <utils/Log.h>
 #include <utils/Panic.h>
@@ -227,6 +228,16 @@ void OpenGLDriver::terminate() {
         glDeleteSamplers(1, &item.second);
     }
     mSamplerMap.clear();
+
+    for (auto& item : mPixelBufferPool) {
+        glDeleteBuffers(1, &item.first);
+    }
+    mPixelBufferPool.clear();
+
+    for (auto& item : mBufferObjectPool) {
+        glDeleteBuffers(1, &item.first);
+    }
+    mBufferObjectPool.clear();
     if (mOpenGLBlitter) {
         mOpenGLBlitter->terminate();
     }
@@ -414,11 +425,11 @@ void OpenGLDriver::createIndexBufferR(
     auto& gl = mContext;
     uint8_t elementSize = static_cast<uint8_t>(getElementTypeSize(elementType));
     GLIndexBuffer* ib = construct<GLIndexBuffer>(ibh, elementSize, indexCount);
-    glGenBuffers(1, &ib->gl.buffer);
-    GLsizeiptr size = elementSize * indexCount;
+    ib->gl.capacity = uint32_t(elementSize * indexCount);
+    ib->gl.buffer = acquireBufferObject(ib->gl.capacity);
     gl.bindVertexArray(nullptr);
     gl.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, ib->gl.buffer);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, size, nullptr, getBufferUsage(usage));
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, ib->gl.capacity, nullptr, getBufferUsage(usage));
     CHECK_GL_ERROR(utils::slog.e)
 }
 
@@ -433,9 +444,12 @@ void OpenGLDriver::createBufferObjectR(Handle<HwBufferObject> boh,
     }
 
     GLBufferObject* bo = construct<GLBufferObject>(boh, byteCount, bindingType, usage);
-    glGenBuffers(1, &bo->gl.id);
+    bo->gl.capacity = byteCount;
+    bo->gl.id = acquireBufferObject(bo->gl.capacity);
     gl.bindBuffer(bo->gl.binding, bo->gl.id);
-    glBufferData(bo->gl.binding, byteCount, nullptr, getBufferUsage(usage));
+    // with a recycled buffer this orphans a store of the exact same size, which drivers
+    // satisfy from their own renamed-buffer cache instead of a fresh allocation
+    glBufferData(bo->gl.binding, bo->gl.capacity, nullptr, getBufferUsage(usage));
     CHECK_GL_ERROR(utils::slog.e)
 }
 
@@ -457,7 +471,8 @@ void OpenGLDriver::createProgramR(Handle<HwProgram> ph, Program&& program) {
 void OpenGLDriver::createSamplerGroupR(Handle<HwSamplerGroup> sbh, uint32_t size) {
     DEBUG_MARKER()
 
-    construct<GLSamplerGroup>(sbh, size);
+    GLSamplerGroup* const sb = construct<GLSamplerGroup>(sbh, size);
+    sb->serial = ++mSamplerGroupSerial;
 }
 
 UTILS_NOINLINE
@@ -1184,9 +1199,8 @@ void OpenGLDriver::destroyIndexBuffer(Handle<HwIndexBuffer> ibh) {
     DEBUG_MARKER()
 
     if (ibh) {
-        auto& gl = mContext;
         GLIndexBuffer const* ib = handle_cast<const GLIndexBuffer*>(ibh);
-        gl.deleteBuffers(1, &ib->gl.buffer, GL_ELEMENT_ARRAY_BUFFER);
+        releaseBufferObject(ib->gl.buffer, ib->gl.capacity, GL_ELEMENT_ARRAY_BUFFER);
         destruct(ibh, ib);
     }
 }
@@ -1194,9 +1208,8 @@ void OpenGLDriver::destroyIndexBuffer(Handle<HwIndexBuffer> ibh) {
 void OpenGLDriver::destroyBufferObject(Handle<HwBufferObject> boh) {
     DEBUG_MARKER()
     if (boh) {
-        auto& gl = mContext;
         GLBufferObject const* bo = handle_cast<const GLBufferObject*>(boh);
-        gl.deleteBuffers(1, &bo->gl.id, bo->gl.binding);
+        releaseBufferObject(bo->gl.id, bo->gl.capacity, bo->gl.binding);
         destruct(boh, bo);
     }
 }
@@ -1314,6 +1327,13 @@ void OpenGLDriver::destroyStream(Handle<HwStream> sh) {
             for (auto const& info : s->user_thread.infos) {
                 mPlatform.destroyExternalTextureStorage(info.ets);
             }
+        } else if (s->streamType == StreamType::ACQUIRED) {
+            // release any images still queued so their callbacks fire
+            for (auto& image : s->user_thread.pending) {
+                if (image.image) {
+                    scheduleRelease(image);
+                }
+            }
         }
         destruct(sh, s);
     }
@@ -1353,21 +1373,32 @@ Handle<HwStream> OpenGLDriver::createStreamAcquired() {
     return initHandle<GLStream>();
 }
 
-// Stashes an acquired external image and a release callback. The image is not bound to OpenGL until
-// the subsequent call to beginFrame (see updateStreamAcquired).
+// Queues an acquired external image and a release callback. The image is not bound to OpenGL until
+// a subsequent call to beginFrame (see updateStreamAcquired).
 //
-// setAcquiredImage should be called by the user outside of beginFrame / endFrame, and should be
-// called only once per frame. If the user pushes images to the same stream multiple times in a
-// single frame, we emit a warning and honor only the final image, but still invoke all callbacks.
+// setAcquiredImage should be called by the user outside of beginFrame / endFrame. The stream keeps
+// a small FIFO of queued images, so a producer (e.g. a video decoder) may run up to
+// PENDING_IMAGE_QUEUE_SIZE frames ahead of the renderer; each frame consumes the oldest queued
+// image. If the queue overflows we emit a warning and drop the oldest image, but still invoke all
+// callbacks.
 void OpenGLDriver::setAcquiredImage(Handle<HwStream> sh, void* hwbuffer,
         backend::CallbackHandler* handler, backend::StreamCallback cb, void* userData) {
     GLStream* glstream = handle_cast<GLStream*>(sh);
-    if (glstream->user_thread.pending.image) {
-        scheduleRelease(glstream->user_thread.pending);
-        slog.w << "Acquired image is set more than once per frame." << io::endl;
-    }
-    glstream->user_thread.pending = mPlatform.transformAcquiredImage({
+    auto& ut = glstream->user_thread;
+    if (ut.pendingCount == GLStream::PENDING_IMAGE_QUEUE_SIZE) {
+        // drop the oldest queued image to make room
+        size_t const tail =
+                (ut.pendingHead + GLStream::PENDING_IMAGE_QUEUE_SIZE - ut.pendingCount)
+                        % GLStream::PENDING_IMAGE_QUEUE_SIZE;
+        scheduleRelease(ut.pending[tail]);
+        ut.pending[tail] = {0};
+        ut.pendingCount--;
+        slog.w << "Acquired image queue overflowed, dropping the oldest frame." << io::endl;
+    }
+    ut.pending[ut.pendingHead] = mPlatform.transformAcquiredImage({
             hwbuffer, cb, userData, handler });
+    ut.pendingHead = uint8_t((ut.pendingHead + 1) % GLStream::PENDING_IMAGE_QUEUE_SIZE);
+    ut.pendingCount++;
 }
 
 void OpenGLDriver::updateStreams(DriverApi* driver) {
@@ -1550,17 +1581,27 @@ bool OpenGLDriver::isRenderTargetFormatSupported(TextureFormat format) {
 
 bool OpenGLDriver::isFrameBufferFetchSupported() {
     auto& gl = mContext;
-    return gl.ext.EXT_shader_framebuffer_fetch;
+    // Mali exposes framebuffer fetch as GL_ARM_shader_framebuffer_fetch; OpenGLProgram
+    // remaps the EXT-style shaders at compile time (see remapFramebufferFetchToARM()).
+    return gl.ext.EXT_shader_framebuffer_fetch || gl.ext.ARM_shader_framebuffer_fetch;
 }
 
 bool OpenGLDriver::isFrameBufferFetchMultiSampleSupported() {
-    return isFrameBufferFetchSupported();
+    // the ARM variant only exposes the resolved last fragment color, which can't
+    // implement the custom resolve, so multisample fetch stays EXT-only
+    auto& gl = mContext;
+    return gl.ext.EXT_shader_framebuffer_fetch;
 }
 
 bool OpenGLDriver::isFrameTimeSupported() {
     return mFrameTimeSupported;
 }
 
+uint64_t OpenGLDriver::getMemoryPoolSize() {
+    // OpenGL doesn't give us visibility into the driver's allocator.
+    return 0;
+}
+
 bool OpenGLDriver::isWorkaroundNeeded(Workaround workaround) {
     switch (workaround) {
         case Workaround::SPLIT_EASU:
@@ -1581,6 +1622,10 @@ uint8_t OpenGLDriver::getMaxDrawBuffers() {
     return std::min(MRT::MAX_SUPPORTED_RENDER_TARGET_COUNT, uint8_t(mContext.gets.max_draw_buffers));
 }
 
+HandleAllocatorStats OpenGLDriver::getHandleAllocatorStats() {
+    return mHandleAllocator.getStats();
+}
+
 // ------------------------------------------------------------------------------------------------
 // Swap chains
 // ------------------------------------------------------------------------------------------------
@@ -1601,6 +1646,14 @@ void OpenGLDriver::makeCurrent(Handle<HwSwapChain> schDraw, Handle<HwSwapChain>
     mPlatform.makeCurrent(scDraw->swapChain, scRead->swapChain);
 }
 
+void OpenGLDriver::setPresentFrameDamage(Handle<HwSwapChain> sch, uint32_t left, uint32_t bottom,
+        uint32_t width, uint32_t height) {
+    DEBUG_MARKER()
+
+    HwSwapChain* sc = handle_cast<HwSwapChain*>(sch);
+    mPlatform.setPresentFrameDamage(sc->swapChain, left, bottom, width, height);
+}
+
 // ------------------------------------------------------------------------------------------------
 // Updating driver objects
 // ------------------------------------------------------------------------------------------------
@@ -1750,7 +1803,14 @@ void OpenGLDriver::updateSamplerGroup(Handle<HwSamplerGroup> sbh,
     DEBUG_MARKER()
 
     GLSamplerGroup* sb = handle_cast<GLSamplerGroup *>(sbh);
+    // record which slots this update changes and at which version, so that programs can
+    // limit their next updateSamplers() walk to those slots
+    utils::bitset32 const dirty = samplerGroup.getDirty();
     *sb->sb = std::move(samplerGroup); // NOLINT(performance-move-const-arg)
+    uint32_t const version = sb->sb->getVersion();
+    dirty.forEachSetBit([sb, version](size_t index) {
+        sb->slotVersions[index] = version;
+    });
 }
 
 void OpenGLDriver::update2DImage(Handle<HwTexture> th,
@@ -2498,13 +2558,18 @@ void OpenGLDriver::updateStreamAcquired(GLTexture* gltexture, DriverApi* driver)
     // If there's no pending image, do nothing. Note that GL_OES_EGL_image does not let you pass
     // NULL to glEGLImageTargetTexture2DOES, and there is no concept of "detaching" an EGLimage from
     // a texture.
-    if (glstream->user_thread.pending.image == nullptr) {
+    auto& ut = glstream->user_thread;
+    if (ut.pendingCount == 0) {
         return;
     }
 
-    AcquiredImage previousImage = glstream->user_thread.acquired;
-    glstream->user_thread.acquired = glstream->user_thread.pending;
-    glstream->user_thread.pending = {0};
+    // consume the oldest queued image
+    size_t const tail = (ut.pendingHead + GLStream::PENDING_IMAGE_QUEUE_SIZE - ut.pendingCount)
+            % GLStream::PENDING_IMAGE_QUEUE_SIZE;
+    AcquiredImage previousImage = ut.acquired;
+    ut.acquired = ut.pending[tail];
+    ut.pending[tail] = {0};
+    ut.pendingCount--;
 
     // Bind the stashed EGLImage to its corresponding GL texture as soon as we start making the GL
     // calls for the upcoming frame.
@@ -2839,10 +2904,8 @@ void OpenGLDriver::readPixels(Handle<HwRenderTarget> src,
     GLRenderTarget const* s = handle_cast<GLRenderTarget const*>(src);
     gl.bindFramebuffer(GL_READ_FRAMEBUFFER, s->gl.fbo);
 
-    GLuint pbo;
-    glGenBuffers(1, &pbo);
-    gl.bindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
-    glBufferData(GL_PIXEL_PACK_BUFFER, p.size, nullptr, GL_STATIC_DRAW);
+    size_t capacity = p.size;
+    const GLuint pbo = acquirePixelBuffer(capacity);    // also binds the buffer
     glReadPixels(GLint(x), GLint(y), GLint(width), GLint(height), glFormat, glType, nullptr);
     gl.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
     CHECK_GL_ERROR(utils::slog.e)
@@ -2850,7 +2913,7 @@ void OpenGLDriver::readPixels(Handle<HwRenderTarget> src,
     // we're forced to make a copy on the heap because otherwise it deletes std::function<> copy
     // constructor.
     auto* pUserBuffer = new PixelBufferDescriptor(std::move(p));
-    whenGpuCommandsComplete([this, width, height, pbo, pUserBuffer]() mutable {
+    whenGpuCommandsComplete([this, width, height, pbo, capacity, pUserBuffer]() mutable {
         PixelBufferDescriptor& p = *pUserBuffer;
         auto& gl = mContext;
         gl.bindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
@@ -2872,13 +2935,90 @@ void OpenGLDriver::readPixels(Handle<HwRenderTarget> src,
             glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
         }
         gl.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
-        glDeleteBuffers(1, &pbo);
+        releasePixelBuffer(pbo, capacity);
         scheduleDestroy(std::move(p));
         delete pUserBuffer;
         CHECK_GL_ERROR(utils::slog.e)
     });
 }
 
+GLuint OpenGLDriver::acquirePixelBuffer(size_t& capacity) noexcept {
+    auto& gl = mContext;
+    auto& pool = mPixelBufferPool;
+
+    // best-fit: the smallest pooled buffer that is large enough
+    auto best = pool.end();
+    for (auto it = pool.begin(); it != pool.end(); ++it) {
+        if (it->second >= capacity && (best == pool.end() || it->second < best->second)) {
+            best = it;
+        }
+    }
+    if (best != pool.end()) {
+        const GLuint pbo = best->first;
+        capacity = best->second;
+        pool.erase(best);
+        gl.bindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+        return pbo;
+    }
+
+    GLuint pbo;
+    glGenBuffers(1, &pbo);
+    gl.bindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+    glBufferData(GL_PIXEL_PACK_BUFFER, GLsizeiptr(capacity), nullptr, GL_STREAM_READ);
+    CHECK_GL_ERROR(utils::slog.e)
+    return pbo;
+}
+
+void OpenGLDriver::releasePixelBuffer(GLuint pbo, size_t capacity) noexcept {
+    auto& pool = mPixelBufferPool;
+    if (pool.size() >= PIXEL_BUFFER_POOL_SIZE) {
+        // pool is full, keep the largest buffers
+        auto smallest = std::min_element(pool.begin(), pool.end(),
+                [](auto const& lhs, auto const& rhs) { return lhs.second < rhs.second; });
+        if (smallest->second >= capacity) {
+            glDeleteBuffers(1, &pbo);
+            return;
+        }
+        glDeleteBuffers(1, &smallest->first);
+        pool.erase(smallest);
+    }
+    pool.emplace_back(pbo, capacity);
+}
+
+GLuint OpenGLDriver::acquireBufferObject(uint32_t& capacity) noexcept {
+    // round the request up to a power-of-two size class, so that recycled buffers
+    // match later requests exactly and their store never needs to grow
+    uint32_t const size = std::max(capacity, 256u);
+    capacity = 1u << (32u - utils::clz(size - 1u));
+
+    auto& pool = mBufferObjectPool;
+    auto pos = std::find_if(pool.begin(), pool.end(),
+            [capacity](auto const& item) { return item.second == capacity; });
+    if (pos != pool.end()) {
+        GLuint const buffer = pos->first;
+        *pos = pool.back();
+        pool.pop_back();
+        return buffer;
+    }
+
+    GLuint buffer;
+    glGenBuffers(1, &buffer);
+    return buffer;
+}
+
+void OpenGLDriver::releaseBufferObject(GLuint buffer, uint32_t capacity, GLenum target) noexcept {
+    auto& pool = mBufferObjectPool;
+    if (pool.size() >= BUFFER_OBJECT_POOL_SIZE) {
+        // pool is full, just free this buffer. The buffer's real binding target matters
+        // here: deleteBuffers() scrubs the context's cached bindings for that target only,
+        // including the indexed GL_UNIFORM_BUFFER table -- a stale cached name would make
+        // a later bindBufferRange() with a recycled name filter out a needed rebind.
+        mContext.deleteBuffers(1, &buffer, target);
+        return;
+    }
+    pool.emplace_back(buffer, capacity);
+}
+
 void OpenGLDriver::whenGpuCommandsComplete(std::function<void()> fn) noexcept {
     GLsync sync = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
     mGpuCommandCompleteOps.emplace_back(sync, std::move(fn));
@@ -2962,9 +3102,23 @@ void OpenGLDriver::setPresentationTime(int64_t monotonic_clock_ns) {
     mPlatform.setPresentationTime(monotonic_clock_ns);
 }
 
+void OpenGLDriver::setProgramBinaryCacheDirectory(utils::CString&& path) {
+    mProgramBinaryCache.setDirectory(std::move(path));
+}
+
 void OpenGLDriver::endFrame(uint32_t frameId) {
     //SYSTRACE_NAME("glFinish");
     //glFinish();
+
+    // Publish the state-cache hit rate for this frame, then start the next frame's count.
+    // These counters show up in systrace next to the frame markers, which makes it easy to
+    // correlate a spike in issued GL calls with a specific frame's content.
+    auto& gl = mContext;
+    SYSTRACE_CONTEXT();
+    SYSTRACE_VALUE32("GL state changes issued", gl.getStateChangeStats().issued);
+    SYSTRACE_VALUE32("GL state changes filtered", gl.getStateChangeStats().filtered);
+    gl.resetStateChangeStats();
+
     insertEventMarker("endFrame");
 }
 
@@ -3135,7 +3289,8 @@ void OpenGLDriver::updateTextureLodRange(GLTexture* texture, int8_t targetLevel)
     }
 }
 
-void OpenGLDriver::draw(PipelineState state, Handle<HwRenderPrimitive> rph) {
+void OpenGLDriver::draw(PipelineState state, Handle<HwRenderPrimitive> rph,
+        uint32_t instanceCount) {
     DEBUG_MARKER()
     auto& gl = mContext;
 
@@ -3172,8 +3327,14 @@ void OpenGLDriver::draw(PipelineState state, Handle<HwRenderPrimitive> rph) {
 
     setViewportScissor(state.scissor);
 
-    glDrawRangeElements(GLenum(rp->type), rp->minIndex, rp->maxIndex, rp->count,
-            rp->gl.indicesType, reinterpret_cast<const void*>(rp->offset));
+    if (UTILS_LIKELY(instanceCount <= 1)) {
+        glDrawRangeElements(GLenum(rp->type), rp->minIndex, rp->maxIndex, rp->count,
+                rp->gl.indicesType, reinterpret_cast<const void*>(rp->offset));
+    } else {
+        glDrawElementsInstanced(GLenum(rp->type), rp->count,
+                rp->gl.indicesType, reinterpret_cast<const void*>(rp->offset),
+                GLsizei(instanceCount));
+    }
 
     CHECK_GL_ERROR(utils::slog.e)
 }
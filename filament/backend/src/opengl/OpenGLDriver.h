@@ -21,6 +21,7 @@
 #include "DriverBase.h"
 #include "GLUtils.h"
 #include "OpenGLContext.h"
+#include "OpenGLProgramBinaryCache.h"
 
 #include "private/backend/HandleAllocator.h"
 
@@ -77,6 +78,7 @@ public:
         struct {
             GLuint id = 0;
             GLenum binding = 0;
+            uint32_t capacity = 0;  // allocated GL store size, a power-of-two >= byteCount
         } gl;
         uint32_t base = 0;
         uint32_t size = 0;
@@ -95,11 +97,18 @@ public:
         using HwIndexBuffer::HwIndexBuffer;
         struct {
             GLuint buffer{};
+            uint32_t capacity{};    // allocated GL store size, a power-of-two >= byte size
         } gl;
     };
 
     struct GLSamplerGroup : public backend::HwSamplerGroup {
         using HwSamplerGroup::HwSamplerGroup;
+        // serial is unique per GLSamplerGroup object (it survives handle address reuse);
+        // slotVersions[i] records the group version at which slot i last changed. Together
+        // with SamplerGroup's version, they let OpenGLProgram::updateSamplers() limit its
+        // walk to the slots that actually changed since it last bound this group.
+        uint32_t serial = 0;
+        std::array<uint32_t, backend::MAX_SAMPLER_COUNT> slotVersions = {};
     };
 
     struct GLRenderPrimitive : public backend::HwRenderPrimitive {
@@ -145,6 +154,8 @@ public:
 
     struct GLStream : public backend::HwStream {
         static constexpr size_t ROUND_ROBIN_TEXTURE_COUNT = 3;      // 3 maximum
+        // depth of the ACQUIRED-stream image FIFO (how far a producer can run ahead)
+        static constexpr size_t PENDING_IMAGE_QUEUE_SIZE = 3;
         using HwStream::HwStream;
         struct Info {
             // storage for the read/write textures below
@@ -178,7 +189,13 @@ public:
             int64_t timestamp = 0;
             uint8_t cur = 0;
             backend::AcquiredImage acquired;
-            backend::AcquiredImage pending;
+
+            // FIFO of zero-copy external images queued by the producer and not yet bound.
+            // Lets a decoder run up to PENDING_IMAGE_QUEUE_SIZE frames ahead of the renderer
+            // without dropping frames; only overflow forces a drop (see setAcquiredImage).
+            backend::AcquiredImage pending[PENDING_IMAGE_QUEUE_SIZE];
+            uint8_t pendingHead = 0;    // next slot to write (enqueue)
+            uint8_t pendingCount = 0;   // number of queued images
         } user_thread;
     };
 
@@ -365,6 +382,8 @@ private:
     // sampler buffer binding points (nullptr if not used)
     std::array<backend::HwSamplerGroup*, backend::Program::BINDING_COUNT> mSamplerBindings = {};   // 8 pointers
 
+    uint32_t mSamplerGroupSerial = 0;       // see GLSamplerGroup::serial
+
     mutable tsl::robin_map<uint32_t, GLuint> mSamplerMap;
     mutable std::vector<GLTexture*> mExternalStreams;
 
@@ -374,6 +393,10 @@ private:
 
     backend::OpenGLPlatform& mPlatform;
 
+    // disk cache of linked program binaries, disabled until given a directory
+    OpenGLProgramBinaryCache mProgramBinaryCache;
+    OpenGLProgramBinaryCache& getProgramBinaryCache() noexcept { return mProgramBinaryCache; }
+
     OpenGLBlitter* mOpenGLBlitter = nullptr;
     void updateStreamTexId(GLTexture* t, backend::DriverApi* driver) noexcept;
     void updateStreamAcquired(GLTexture* t, backend::DriverApi* driver) noexcept;
@@ -393,6 +416,21 @@ private:
     void executeEveryNowAndThenOps() noexcept;
     std::vector<std::function<bool()>> mEveryNowAndThenOps;
 
+    // small ring of PBOs reused by readPixels(), so that continuous capture doesn't
+    // create and destroy a buffer on every call
+    static constexpr size_t PIXEL_BUFFER_POOL_SIZE = 4;
+    GLuint acquirePixelBuffer(size_t& capacity) noexcept;
+    void releasePixelBuffer(GLuint pbo, size_t capacity) noexcept;
+    std::vector<std::pair<GLuint, size_t>> mPixelBufferPool;    // (buffer, capacity)
+
+    // pool of retired vertex/index/uniform buffer objects, bucketed in power-of-two size
+    // classes, so that streaming scenes which create and destroy many buffers per frame
+    // don't continuously hit the driver's allocator
+    static constexpr size_t BUFFER_OBJECT_POOL_SIZE = 64;
+    GLuint acquireBufferObject(uint32_t& capacity) noexcept;
+    void releaseBufferObject(GLuint buffer, uint32_t capacity, GLenum target) noexcept;
+    std::vector<std::pair<GLuint, uint32_t>> mBufferObjectPool; // (buffer, capacity)
+
     // timer query implementation
     TimerQueryInterface* mTimerQueryImpl = nullptr;
     bool mFrameTimeSupported = false;
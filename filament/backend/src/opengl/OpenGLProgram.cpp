@@ -40,6 +40,8 @@ static void logCompilationError(utils::io::ostream& out,
 static void logProgramLinkError(utils::io::ostream& out,
         const char* name, GLuint program) noexcept;
 
+static bool remapFramebufferFetchToARM(std::string& shader) noexcept;
+
 OpenGLProgram::OpenGLProgram(OpenGLDriver* gl, const Program& programBuilder) noexcept
         :  HwProgram(programBuilder.getName()), mIsValid(false) {
 
@@ -48,9 +50,17 @@ OpenGLProgram::OpenGLProgram(OpenGLDriver* gl, const Program& programBuilder) no
     const auto& shadersSource = programBuilder.getShadersSource();
     OpenGLContext& context = gl->getContext();
 
-    // build all shaders
+    OpenGLProgramBinaryCache& binaryCache = gl->getProgramBinaryCache();
+    uint64_t binaryKey = 0;
+    GLuint program = 0;
+    if (UTILS_UNLIKELY(binaryCache.isEnabled())) {
+        binaryKey = binaryCache.computeKey(programBuilder);
+        program = binaryCache.retrieve(binaryKey);
+    }
+
+    // build all shaders, unless a cached binary already gave us a linked program
     #pragma nounroll
-    for (size_t i = 0; i < Program::SHADER_TYPE_COUNT; i++) {
+    for (size_t i = 0; program == 0 && i < Program::SHADER_TYPE_COUNT; i++) {
         GLenum glShaderType;
         Shader type = (Shader)i;
         switch (type) {
@@ -130,6 +140,19 @@ highp uint packHalf2x16(vec2 v) {
                 shaderView = temp;
             }
 
+            if (UTILS_UNLIKELY(type == Shader::FRAGMENT &&
+                    !context.ext.EXT_shader_framebuffer_fetch &&
+                    context.ext.ARM_shader_framebuffer_fetch)) {
+                // Our shaders use EXT-style framebuffer fetch; on Mali only the ARM
+                // variant is available, remap the source to it.
+                if (temp.empty()) {
+                    temp = shaderView; // copy string
+                }
+                if (remapFramebufferFetchToARM(temp)) {
+                    shaderView = temp;
+                }
+            }
+
             GLuint shaderId = glCreateShader(glShaderType);
             { // scope for source/length (we don't want them to leak out)
                 const char* const source = shaderView.data();
@@ -153,14 +176,20 @@ highp uint packHalf2x16(vec2 v) {
     // we need at least a vertex and fragment program
     const uint8_t validShaderSet = mValidShaderSet;
     const uint8_t mask = VERTEX_SHADER_BIT | FRAGMENT_SHADER_BIT;
-    if (UTILS_LIKELY((mValidShaderSet & mask) == mask)) {
+    if (program == 0 && UTILS_LIKELY((mValidShaderSet & mask) == mask)) {
         GLint status;
-        GLuint program = glCreateProgram();
+        program = glCreateProgram();
         for (size_t i = 0; i < Program::SHADER_TYPE_COUNT; i++) {
             if (validShaderSet & (1U << i)) {
                 glAttachShader(program, this->gl.shaders[i]);
             }
         }
+
+        if (UTILS_UNLIKELY(binaryCache.isEnabled())) {
+            // some drivers only retain the binary when asked to before linking
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        }
+
         glLinkProgram(program);
 
         glGetProgramiv(program, GL_LINK_STATUS, &status);
@@ -170,6 +199,12 @@ highp uint packHalf2x16(vec2 v) {
             return;
         }
 
+        if (UTILS_UNLIKELY(binaryCache.isEnabled())) {
+            binaryCache.insert(binaryKey, program);
+        }
+    }
+
+    if (UTILS_LIKELY(program)) {
         this->gl.program = program;
 
         // Associate each UniformBlock in the program to a known binding.
@@ -260,6 +295,7 @@ OpenGLProgram::~OpenGLProgram() noexcept {
 
 void OpenGLProgram::updateSamplers(OpenGLDriver* gld) noexcept {
     using GLTexture = OpenGLDriver::GLTexture;
+    using GLSamplerGroup = OpenGLDriver::GLSamplerGroup;
 
     // cache a few member variable locally, outside of the loop
     OpenGLContext& glc = gld->getContext();
@@ -269,6 +305,10 @@ void OpenGLProgram::updateSamplers(OpenGLDriver* gld) noexcept {
     auto const& UTILS_RESTRICT indicesRun = mIndicesRuns;
     auto const& UTILS_RESTRICT blockInfos = mBlockInfos;
 
+    // If no texture unit changed since our last walk, the units still hold exactly what we
+    // bound, and we only need to visit the slots whose sampler group content changed since.
+    const bool unitsUnchanged = glc.getTextureUnitEpoch() == mTextureUnitEpoch;
+
     UTILS_ASSUME(mUsedBindingsCount > 0);
     for (uint8_t i = 0, tmu = 0, n = mUsedBindingsCount; i < n; i++) {
         BlockInfo blockInfo = blockInfos[i];
@@ -278,11 +318,30 @@ void OpenGLProgram::updateSamplers(OpenGLDriver* gld) noexcept {
             continue;
         }
         SamplerGroup const& UTILS_RESTRICT sb = *(hwsb->sb);
+
+        GLSamplerGroup const* const glsb = static_cast<GLSamplerGroup const*>(hwsb);
+        BindingCache& cache = mBindingCaches[i];
+        // External textures can change out from under us (a stream update swaps the texture
+        // name and sets a fence), so groups holding one are always walked in full.
+        const bool sameGroup = unitsUnchanged
+                && cache.serial == glsb->serial && !cache.external;
+        if (sameGroup && cache.version == sb.getVersion()) {
+            // nothing changed in this group since we last bound it
+            tmu += blockInfo.count + 1;
+            continue;
+        }
+
+        bool external = false;
         SamplerGroup::Sampler const* const UTILS_RESTRICT samplers = sb.getSamplers();
         for (uint8_t j = 0, m = blockInfo.count ; j <= m; ++j, ++tmu) { // "<=" on purpose here
             const uint8_t index = indicesRun[tmu];
             assert_invariant(index < sb.getSize());
 
+            if (sameGroup && glsb->slotVersions[index] <= cache.version) {
+                // this slot hasn't changed since our last walk
+                continue;
+            }
+
             Handle<HwTexture> th = samplers[index].t;
             if (UTILS_UNLIKELY(!th)) {
 #ifndef NDEBUG
@@ -301,6 +360,7 @@ void OpenGLProgram::updateSamplers(OpenGLDriver* gld) noexcept {
 
             SamplerParams params{ samplers[index].s };
             if (UTILS_UNLIKELY(t->target == SamplerType::SAMPLER_EXTERNAL)) {
+                external = true;
                 // From OES_EGL_image_external spec:
                 // "The default s and t wrap modes are CLAMP_TO_EDGE and it is an INVALID_ENUM
                 //  error to set the wrap mode to any other value."
@@ -335,7 +395,13 @@ void OpenGLProgram::updateSamplers(OpenGLDriver* gld) noexcept {
             }
 #endif
         }
+        // the slots skipped above are known not to be external (a previous full walk
+        // would have set cache.external, and sameGroup would be false)
+        cache.serial = glsb->serial;
+        cache.version = sb.getVersion();
+        cache.external = external;
     }
+    mTextureUnitEpoch = glc.getTextureUnitEpoch();
     CHECK_GL_ERROR(utils::slog.e)
 }
 
@@ -376,6 +442,61 @@ void logCompilationError(io::ostream& out, Program::Shader shaderType,
     out << io::endl;
 }
 
+/*
+ * Remaps a fragment shader using EXT_shader_framebuffer_fetch to
+ * ARM_shader_framebuffer_fetch (Mali). The EXT variant reads the previous color
+ * through an "inout" output variable; the ARM variant only provides the read-only
+ * built-in gl_LastFragColorARM. Rather than rewriting the individual reads and
+ * writes, the inout output becomes a plain global seeded from the built-in before
+ * the original main() body runs and copied to a real output afterwards.
+ */
+UTILS_NOINLINE
+bool remapFramebufferFetchToARM(std::string& shader) noexcept {
+    using namespace std::literals;
+    constexpr auto EXT_DIRECTIVE = "GL_EXT_shader_framebuffer_fetch"sv;
+    constexpr auto ARM_DIRECTIVE = "GL_ARM_shader_framebuffer_fetch"sv;
+    static_assert(EXT_DIRECTIVE.size() == ARM_DIRECTIVE.size());
+    constexpr auto INOUT = ") inout "sv;
+    constexpr auto MAIN = "void main()"sv;
+
+    // find everything first, so a shader we don't understand is left untouched
+    size_t const extensionPos = shader.find(EXT_DIRECTIVE);
+    if (extensionPos == std::string::npos) {
+        return false;
+    }
+    // "layout(location = 0) inout <precision> vec4 <name>;" declares the fetched output
+    size_t const inoutPos = shader.find(INOUT);
+    size_t const mainPos = shader.find(MAIN);
+    if (inoutPos == std::string::npos || mainPos == std::string::npos) {
+        return false;
+    }
+    size_t const layoutPos = shader.rfind("layout", inoutPos);
+    size_t const declEnd = shader.find(';', inoutPos);
+    if (layoutPos == std::string::npos || declEnd == std::string::npos) {
+        return false;
+    }
+
+    // "<precision> vec4 <name>" and its two halves
+    std::string const decl =
+            shader.substr(inoutPos + INOUT.size(), declEnd - (inoutPos + INOUT.size()));
+    size_t const namePos = decl.rfind(' ');
+    if (namePos == std::string::npos) {
+        return false;
+    }
+    std::string const typeAndPrecision = decl.substr(0, namePos);
+    std::string const name = decl.substr(namePos + 1);
+
+    // mutate back to front so the positions found above stay valid
+    shader.append("\nvoid main() {\n    " + name + " = gl_LastFragColorARM;\n"
+                  "    filament_fetch_main();\n"
+                  "    filament_fetch_output = " + name + ";\n}\n");
+    shader.replace(mainPos, MAIN.size(), "void filament_fetch_main()");
+    shader.replace(layoutPos, declEnd + 1 - layoutPos,
+            decl + ";\nlayout(location = 0) out " + typeAndPrecision + " filament_fetch_output;");
+    shader.replace(extensionPos, EXT_DIRECTIVE.size(), ARM_DIRECTIVE);
+    return true;
+}
+
 UTILS_NOINLINE
 void logProgramLinkError(io::ostream& out, char const* name, GLuint program) noexcept {
     char error[1024];
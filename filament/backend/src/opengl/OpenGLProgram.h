@@ -45,18 +45,10 @@ public:
 
     void use(OpenGLDriver* const gl) noexcept {
         if (UTILS_UNLIKELY(mUsedBindingsCount)) {
-            // We rely on GL state tracking to avoid unnecessary glBindTexture / glBindSampler
-            // calls.
-
-            // we need to do this if:
-            // - the content of mSamplerBindings has changed
-            // - the content of any bound sampler buffer has changed
-            // ... since last time we used this program
-
-            // turns out the former might be relatively cheap to check, the later requires
-            // a bit less. Compared to what updateSamplers() actually does, which is
-            // pretty little, I'm not sure we'll get ahead.
-
+            // updateSamplers() skips the sampler groups whose content hasn't changed since
+            // we last bound them (provided nobody touched the texture units in between),
+            // and otherwise rebinds, relying on GL state tracking to avoid unnecessary
+            // glBindTexture / glBindSampler calls.
             updateSamplers(gl);
         }
     }
@@ -96,6 +88,16 @@ private:
     // runs of indices into SamplerGroup -- run start index and size given by BlockInfo
     std::array<uint8_t, TEXTURE_UNIT_COUNT> mIndicesRuns;    // 16 bytes
 
+    // what updateSamplers() last bound for each used sampler group, so redundant walks can
+    // be skipped entirely, or reduced to the slots that changed (see updateSamplers())
+    struct BindingCache {
+        uint32_t serial = 0;    // GLSamplerGroup::serial of the group last seen
+        uint32_t version = 0;   // the group's version at our last walk
+        bool external = false;  // the group held an external texture -- never skip those
+    };
+    std::array<BindingCache, backend::Program::BINDING_COUNT> mBindingCaches;   // 96 bytes
+    uint32_t mTextureUnitEpoch = 0; // context texture-unit epoch right after our last walk
+
     void updateSamplers(OpenGLDriver* gld) noexcept;
 };
 
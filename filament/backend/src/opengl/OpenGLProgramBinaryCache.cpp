@@ -0,0 +1,175 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "OpenGLProgramBinaryCache.h"
+
+#include <utils/compiler.h>
+#include <utils/Hash.h>
+
+#include <string_view>
+#include <vector>
+
+#include <stdio.h>
+
+namespace filament {
+
+using namespace backend;
+
+namespace {
+
+// bumped whenever the file layout below changes
+constexpr uint32_t BINARY_CACHE_MAGIC = 'F' | 'B' << 8u | 'P' << 16u | '1' << 24u;
+
+struct BinaryCacheHeader {
+    uint32_t magic;
+    uint32_t format;        // GLenum binaryFormat
+    uint32_t size;          // size of the binary payload in bytes
+};
+
+// hashes a byte blob into `seed`, without requiring word-sized or word-aligned data
+void combineBlob(size_t& seed, void const* data, size_t size) noexcept {
+    uint32_t const* words = static_cast<uint32_t const*>(data);
+    size_t const wordCount = size / sizeof(uint32_t);
+    if (wordCount) {
+        utils::hash::combine(seed, utils::hash::murmur3(words, wordCount, 0));
+    }
+    uint8_t const* tail = static_cast<uint8_t const*>(data) + wordCount * sizeof(uint32_t);
+    for (size_t i = 0, n = size % sizeof(uint32_t); i < n; i++) {
+        utils::hash::combine(seed, tail[i]);
+    }
+    utils::hash::combine(seed, size);
+}
+
+} // anonymous namespace
+
+void OpenGLProgramBinaryCache::setDirectory(utils::CString directory) noexcept {
+    mDirectory = std::move(directory);
+    mSupported = false;
+    if (mDirectory.empty()) {
+        return;
+    }
+
+    // the context must support at least one binary format (e.g. MacOS's GL 4.1 supports none)
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    if (formatCount <= 0) {
+        return;
+    }
+
+    // the driver identity participates in every key, so entries written by a
+    // different GPU or driver version are never loaded
+    size_t seed = 0;
+    for (GLenum name : { GL_VENDOR, GL_RENDERER, GL_VERSION }) {
+        char const* const s = reinterpret_cast<char const*>(glGetString(name));
+        utils::hash::combine(seed, std::string_view{ s ? s : "" });
+    }
+    mDriverIdHash = seed;
+    mSupported = true;
+}
+
+uint64_t OpenGLProgramBinaryCache::computeKey(Program const& program) const noexcept {
+    size_t seed = mDriverIdHash;
+    auto const& shadersSource = program.getShadersSource();
+    for (size_t i = 0; i < Program::SHADER_TYPE_COUNT; i++) {
+        Program::ShaderBlob const& blob = shadersSource[i];
+        utils::hash::combine(seed, i);
+        combineBlob(seed, blob.data(), blob.size());
+    }
+    return seed;
+}
+
+std::string OpenGLProgramBinaryCache::getPath(uint64_t key) const noexcept {
+    char name[32];
+    snprintf(name, sizeof(name), "/%016llx.bin", (unsigned long long)key);
+    return std::string{ mDirectory.c_str(), mDirectory.size() } + name;
+}
+
+GLuint OpenGLProgramBinaryCache::retrieve(uint64_t key) const noexcept {
+    std::string const path = getPath(key);
+    FILE* const file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return 0;
+    }
+
+    BinaryCacheHeader header;
+    std::vector<char> blob;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1
+            && header.magic == BINARY_CACHE_MAGIC
+            && header.size > 0;
+    if (valid) {
+        blob.resize(header.size);
+        valid = fread(blob.data(), 1, blob.size(), file) == blob.size();
+    }
+    fclose(file);
+
+    GLuint program = 0;
+    if (valid) {
+        program = glCreateProgram();
+        glProgramBinary(program, GLenum(header.format), blob.data(), GLsizei(blob.size()));
+        GLint status = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+        if (UTILS_UNLIKELY(status != GL_TRUE)) {
+            // the binary was rejected (e.g. stale format); fall back to compiling
+            glDeleteProgram(program);
+            program = 0;
+            valid = false;
+        }
+    }
+
+    if (UTILS_UNLIKELY(!valid)) {
+        // evict the entry, it will be rewritten after the program is rebuilt
+        remove(path.c_str());
+        while (glGetError() != GL_NO_ERROR) { } // clear any pending error
+    }
+    return program;
+}
+
+void OpenGLProgramBinaryCache::insert(uint64_t key, GLuint program) const noexcept {
+    GLint size = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &size);
+    if (size <= 0) {
+        return;
+    }
+
+    std::vector<char> blob(size_t(size), 0);
+    GLsizei written = 0;
+    GLenum format = 0;
+    glGetProgramBinary(program, size, &written, &format, blob.data());
+    if (written <= 0 || written > size) {
+        while (glGetError() != GL_NO_ERROR) { } // clear any pending error
+        return;
+    }
+
+    // write to a temporary file first, so a partial write (e.g. the process is
+    // killed) can never be mistaken for a valid entry
+    std::string const path = getPath(key);
+    std::string const temp = path + ".tmp";
+    FILE* const file = fopen(temp.c_str(), "wb");
+    if (!file) {
+        return;
+    }
+    BinaryCacheHeader const header{ BINARY_CACHE_MAGIC, uint32_t(format), uint32_t(written) };
+    bool const ok = fwrite(&header, sizeof(header), 1, file) == 1
+            && fwrite(blob.data(), 1, size_t(written), file) == size_t(written);
+    fclose(file);
+    if (ok) {
+        rename(temp.c_str(), path.c_str());
+    } else {
+        remove(temp.c_str());
+    }
+}
+
+} // namespace filament
@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_DRIVER_OPENGLPROGRAMBINARYCACHE_H
+#define TNT_FILAMENT_DRIVER_OPENGLPROGRAMBINARYCACHE_H
+
+#include "gl_headers.h"
+
+#include "private/backend/Program.h"
+
+#include <utils/CString.h>
+
+#include <string>
+
+#include <stdint.h>
+
+namespace filament {
+
+/*
+ * A disk-backed cache of linked program binaries (glGetProgramBinary /
+ * glProgramBinary), so that program compilation only pays the full GLSL
+ * compile and link cost the first time the application runs. This matters
+ * most on mobile drivers where compiling all the material variants of a
+ * scene can take seconds.
+ *
+ * The cache is disabled until the application provides a directory via
+ * Engine::setProgramBinaryCacheDirectory(). Entries are keyed by a hash of
+ * the program's shader sources combined with the driver's identity strings
+ * (GL_VENDOR, GL_RENDERER, GL_VERSION), so a driver update naturally
+ * invalidates all previous entries.
+ *
+ * All methods must be called from the backend thread, with the context
+ * current; there is no internal synchronization.
+ */
+class OpenGLProgramBinaryCache {
+public:
+    // Sets the directory where binaries are stored, and checks that the current
+    // context actually supports program binaries (e.g. it doesn't on MacOS).
+    // An empty directory disables the cache.
+    void setDirectory(utils::CString directory) noexcept;
+
+    bool isEnabled() const noexcept { return mSupported; }
+
+    // Computes the cache key for this program from its shader sources and the
+    // driver identity. Only meaningful when the cache is enabled.
+    uint64_t computeKey(backend::Program const& program) const noexcept;
+
+    // Returns a successfully linked program name from the cache, or 0 on a miss.
+    // Stale or corrupted entries are evicted and reported as a miss.
+    GLuint retrieve(uint64_t key) const noexcept;
+
+    // Stores the binary of a freshly linked program. Failures are silent; the
+    // program will simply be compiled again on the next run.
+    void insert(uint64_t key, GLuint program) const noexcept;
+
+private:
+    std::string getPath(uint64_t key) const noexcept;
+
+    utils::CString mDirectory;
+    uint64_t mDriverIdHash = 0;
+    bool mSupported = false;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_DRIVER_OPENGLPROGRAMBINARYCACHE_H
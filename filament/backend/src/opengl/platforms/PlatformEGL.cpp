@@ -38,6 +38,9 @@ UTILS_PRIVATE PFNEGLDESTROYSYNCKHRPROC eglDestroySyncKHR = {};
 UTILS_PRIVATE PFNEGLCLIENTWAITSYNCKHRPROC eglClientWaitSyncKHR = {};
 UTILS_PRIVATE PFNEGLCREATEIMAGEKHRPROC eglCreateImageKHR = {};
 UTILS_PRIVATE PFNEGLDESTROYIMAGEKHRPROC eglDestroyImageKHR = {};
+#ifdef EGL_KHR_swap_buffers_with_damage
+UTILS_PRIVATE PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC eglSwapBuffersWithDamageKHR = {};
+#endif
 }
 using namespace glext;
 
@@ -102,6 +105,13 @@ Driver* PlatformEGL::createDriver(void* sharedContext) noexcept {
     eglCreateImageKHR = (PFNEGLCREATEIMAGEKHRPROC) eglGetProcAddress("eglCreateImageKHR");
     eglDestroyImageKHR = (PFNEGLDESTROYIMAGEKHRPROC) eglGetProcAddress("eglDestroyImageKHR");
 
+#ifdef EGL_KHR_swap_buffers_with_damage
+    if (extensions.has("EGL_KHR_swap_buffers_with_damage")) {
+        eglSwapBuffersWithDamageKHR = (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC)
+                eglGetProcAddress("eglSwapBuffersWithDamageKHR");
+    }
+#endif
+
     EGLint configsCount;
     EGLint configAttribs[] = {
             EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT_KHR,        //  0
@@ -311,9 +321,27 @@ void PlatformEGL::makeCurrent(Platform::SwapChain* drawSwapChain,
     }
 }
 
+void PlatformEGL::setPresentFrameDamage(Platform::SwapChain* swapChain,
+        uint32_t left, uint32_t bottom, uint32_t width, uint32_t height) noexcept {
+    // EGL damage rectangles use the same bottom-left origin as the hint.
+    mPendingDamage[0] = EGLint(left);
+    mPendingDamage[1] = EGLint(bottom);
+    mPendingDamage[2] = EGLint(width);
+    mPendingDamage[3] = EGLint(height);
+    mHasPendingDamage = true;
+}
+
 void PlatformEGL::commit(Platform::SwapChain* swapChain) noexcept {
     EGLSurface sur = (EGLSurface) swapChain;
     if (sur != EGL_NO_SURFACE) {
+#ifdef EGL_KHR_swap_buffers_with_damage
+        if (mHasPendingDamage && eglSwapBuffersWithDamageKHR) {
+            mHasPendingDamage = false;
+            eglSwapBuffersWithDamageKHR(mEGLDisplay, sur, mPendingDamage, 1);
+            return;
+        }
+#endif
+        mHasPendingDamage = false;
         eglSwapBuffers(mEGLDisplay, sur);
     }
 }
@@ -41,6 +41,8 @@ public:
     void destroySwapChain(SwapChain* swapChain) noexcept override;
     void makeCurrent(SwapChain* drawSwapChain, SwapChain* readSwapChain) noexcept override;
     void commit(SwapChain* swapChain) noexcept override;
+    void setPresentFrameDamage(SwapChain* swapChain,
+            uint32_t left, uint32_t bottom, uint32_t width, uint32_t height) noexcept override;
 
     bool canCreateFence() noexcept override { return true; }
     Fence* createFence() noexcept override;
@@ -81,6 +83,10 @@ protected:
     EGLConfig mEGLConfig = EGL_NO_CONFIG_KHR;
     EGLConfig mEGLTransparentConfig = EGL_NO_CONFIG_KHR;
 
+    // damage hint for the next commit(), see setPresentFrameDamage()
+    EGLint mPendingDamage[4] = {};
+    bool mHasPendingDamage = false;
+
     // supported extensions detected at runtime
     struct {
         bool OES_EGL_image_external_essl3 = false;
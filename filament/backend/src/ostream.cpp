@@ -297,6 +297,7 @@ io::ostream& operator<<(io::ostream& out, TextureUsage usage) {
         CASE(TextureUsage, UPLOADABLE)
         CASE(TextureUsage, SAMPLEABLE)
         CASE(TextureUsage, SUBPASS_INPUT)
+        CASE(TextureUsage, TRANSIENT)
     }
     return out;
 }
@@ -19,27 +19,38 @@
 
 #include <utils/Panic.h>
 
+#include <algorithm>
+
 using namespace bluevk;
 
 namespace filament {
 namespace backend {
 
 VulkanBuffer::VulkanBuffer(VulkanContext& context, VulkanStagePool& stagePool,
-        VkBufferUsageFlags usage, uint32_t numBytes) : mUsage(usage) {
+        VkBufferUsageFlags usage, uint32_t numBytes) : mUsage(usage), mNumBytes(numBytes) {
 
     // for now make sure that only 1 bit is set in usage
     // (because loadFromCpu() assumes that somewhat)
     assert_invariant(usage && !(usage & (usage - 1)));
 
-    // Create the VkBuffer.
+    // Create the VkBuffer. When a dedicated transfer queue exists, uploads are recorded on it
+    // while rendering reads happen on the graphics queue, so the buffer is shared between the
+    // two families; CONCURRENT sharing has no measurable cost for buffers.
     VkBufferCreateInfo bufferInfo {
         .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
         .size = numBytes,
         .usage = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT
     };
+    if (context.sharedQueueFamilyCount > 1) {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = context.sharedQueueFamilyCount;
+        bufferInfo.pQueueFamilyIndices = context.sharedQueueFamilies;
+    }
 
     VmaAllocationCreateInfo allocInfo { .pool = context.vmaPoolGPU };
     vmaCreateBuffer(context.allocator, &bufferInfo, &allocInfo, &mGpuBuffer, &mGpuMemory, nullptr);
+
+    context.bufferRegistry.push_back(this);
 }
 
 VulkanBuffer::~VulkanBuffer() {
@@ -48,11 +59,40 @@ VulkanBuffer::~VulkanBuffer() {
 }
 
 void VulkanBuffer::terminate(VulkanContext& context) {
+    auto& registry = context.bufferRegistry;
+    registry.erase(std::remove(registry.begin(), registry.end(), this), registry.end());
+
     vmaDestroyBuffer(context.allocator, mGpuBuffer, mGpuMemory);
     mGpuMemory = VK_NULL_HANDLE;
     mGpuBuffer = VK_NULL_HANDLE;
 }
 
+void VulkanBuffer::rebind(VulkanContext& context) {
+    vkDestroyBuffer(context.device, mGpuBuffer, VKALLOC);
+
+    VkBufferCreateInfo bufferInfo {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = mNumBytes,
+        .usage = mUsage | VK_BUFFER_USAGE_TRANSFER_DST_BIT
+    };
+    if (context.sharedQueueFamilyCount > 1) {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = context.sharedQueueFamilyCount;
+        bufferInfo.pQueueFamilyIndices = context.sharedQueueFamilies;
+    }
+    UTILS_UNUSED_IN_RELEASE VkResult result = vkCreateBuffer(context.device, &bufferInfo, VKALLOC,
+            &mGpuBuffer);
+    assert_invariant(result == VK_SUCCESS);
+
+    // Silences a validation warning: the allocator binds with an implicit offset, which the
+    // validation layer only accepts after the requirements have been queried.
+    VkMemoryRequirements reqs = {};
+    vkGetBufferMemoryRequirements(context.device, mGpuBuffer, &reqs);
+
+    result = vmaBindBufferMemory(context.allocator, mGpuMemory, mGpuBuffer);
+    assert_invariant(result == VK_SUCCESS);
+}
+
 void VulkanBuffer::loadFromCpu(VulkanContext& context, VulkanStagePool& stagePool,
         const void* cpuData, uint32_t byteOffset, uint32_t numBytes) const {
     assert_invariant(byteOffset == 0);
@@ -63,11 +103,32 @@ void VulkanBuffer::loadFromCpu(VulkanContext& context, VulkanStagePool& stagePoo
     vmaUnmapMemory(context.allocator, stage->memory);
     vmaFlushAllocation(context.allocator, stage->memory, byteOffset, numBytes);
 
-    const VkCommandBuffer cmdbuffer = context.commands->get().cmdbuffer;
+    const VkCommandBuffer cmdbuffer = context.uploadCommands().get().cmdbuffer;
 
     VkBufferCopy region{ .size = numBytes };
     vkCmdCopyBuffer(cmdbuffer, stage->buffer, mGpuBuffer, 1, &region);
 
+    // On the dedicated transfer queue, graphics pipeline stages are not valid barrier targets
+    // (and not needed): the timeline-semaphore handoff in VulkanCommands makes the transfer
+    // writes available and visible to the graphics queue. Back-to-back uploads on the transfer
+    // queue itself are ordered with a transfer-to-transfer barrier instead.
+    if (&context.uploadCommands() == context.transferCommands) {
+        VkBufferMemoryBarrier barrier{
+                .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+                .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .buffer = mGpuBuffer,
+                .size = VK_WHOLE_SIZE
+        };
+        vkCmdPipelineBarrier(cmdbuffer,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_TRANSFER_BIT,
+                0, 0, nullptr, 1, &barrier, 0, nullptr);
+        return;
+    }
+
     // Firstly, ensure that the copy finishes before the next draw call.
     // Secondly, in case the user decides to upload another chunk (without ever using the first one)
     // we need to ensure that this upload completes first.
@@ -33,10 +33,19 @@ public:
     void loadFromCpu(VulkanContext& context, VulkanStagePool& stagePool,
             const void* cpuData, uint32_t byteOffset, uint32_t numBytes) const;
     VkBuffer getGpuBuffer() const { return mGpuBuffer; }
+    VmaAllocation getAllocation() const { return mGpuMemory; }
+    VkBufferUsageFlags getUsage() const { return mUsage; }
+
+    // Recreates the VkBuffer after the backing allocation has been moved by defragmentation.
+    // The old buffer is immutably bound to a stale memory region; the contents have already
+    // been copied to the new region by the allocator.
+    void rebind(VulkanContext& context);
+
 private:
     VmaAllocation mGpuMemory = VK_NULL_HANDLE;
     VkBuffer mGpuBuffer = VK_NULL_HANDLE;
     VkBufferUsageFlags mUsage = {};
+    uint32_t mNumBytes = 0;
 };
 
 } // namespace filament
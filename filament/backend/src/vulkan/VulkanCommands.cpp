@@ -52,7 +52,9 @@ VulkanCmdFence::~VulkanCmdFence() {
 
 CommandBufferObserver::~CommandBufferObserver() {}
 
-VulkanCommands::VulkanCommands(VkDevice device, uint32_t queueFamilyIndex) : mDevice(device) {
+VulkanCommands::VulkanCommands(VkDevice device, uint32_t queueFamilyIndex,
+        VulkanTimeline* timeline, bool isTransferQueue)
+        : mDevice(device), mTimeline(timeline), mIsTransferQueue(isTransferQueue) {
     VkCommandPoolCreateInfo createInfo = {};
     createInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
     createInfo.flags =
@@ -139,6 +141,13 @@ VulkanCommandBuffer const& VulkanCommands::get() {
 }
 
 bool VulkanCommands::flush() {
+    // Pending uploads on the transfer queue must be submitted first so that our timeline wait
+    // (see below) covers everything recorded before this submission. This is done even when we
+    // have no commands of our own, so that a flush always pushes outstanding uploads to the GPU.
+    if (mDependency) {
+        mDependency->flush();
+    }
+
     // It's perfectly fine to call flush when no commands have been written.
     if (mCurrent == nullptr) {
         return false;
@@ -155,16 +164,23 @@ bool VulkanCommands::flush() {
     // here and use VK_PIPELINE_STAGE_ALL_COMMANDS_BIT. This is a more aggressive stall, but it is
     // the only safe option because the previously submitted command buffer might have set up some
     // state that the new command buffer depends on.
-    VkPipelineStageFlags waitDestStageMasks[2] = {
+    VkPipelineStageFlags waitDestStageMasks[3] = {
+        VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
         VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
     };
 
-    VkSemaphore signals[2] = {
+    VkSemaphore signals[3] = {
+        VK_NULL_HANDLE,
         VK_NULL_HANDLE,
         VK_NULL_HANDLE,
     };
 
+    VkSemaphore signalSemaphores[2] = {
+        renderingFinished,
+        VK_NULL_HANDLE,
+    };
+
     VkSubmitInfo submitInfo {
         .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
         .waitSemaphoreCount = 0,
@@ -173,7 +189,7 @@ bool VulkanCommands::flush() {
         .commandBufferCount = 1,
         .pCommandBuffers = &mCurrent->cmdbuffer,
         .signalSemaphoreCount = 1u,
-        .pSignalSemaphores = &renderingFinished,
+        .pSignalSemaphores = signalSemaphores,
     };
 
     if (mSubmissionSignal) {
@@ -184,6 +200,33 @@ bool VulkanCommands::flush() {
         signals[submitInfo.waitSemaphoreCount++] = mInjectedSignal;
     }
 
+    // Chain this submission into the cross-queue timeline: wait for the other queue's latest
+    // submission and signal a fresh value. Binary semaphores in the wait list are given the
+    // placeholder value 0, which the spec requires timeline-aware submits to provide.
+    VkTimelineSemaphoreSubmitInfo timelineInfo {
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+    };
+    uint64_t waitValues[3] = { 0, 0, 0 };
+    uint64_t signalValues[2] = { 0, 0 };
+    uint64_t timelineSignalValue = 0;
+    if (mTimeline) {
+        const uint64_t waitFor = mIsTransferQueue ? mTimeline->lastGraphics
+                                                  : mTimeline->lastTransfer;
+        if (waitFor) {
+            waitValues[submitInfo.waitSemaphoreCount] = waitFor;
+            signals[submitInfo.waitSemaphoreCount++] = mTimeline->semaphore;
+        }
+        timelineSignalValue = mTimeline->nextValue++;
+        signalValues[submitInfo.signalSemaphoreCount] = timelineSignalValue;
+        signalSemaphores[submitInfo.signalSemaphoreCount++] = mTimeline->semaphore;
+
+        timelineInfo.waitSemaphoreValueCount = submitInfo.waitSemaphoreCount;
+        timelineInfo.pWaitSemaphoreValues = waitValues;
+        timelineInfo.signalSemaphoreValueCount = submitInfo.signalSemaphoreCount;
+        timelineInfo.pSignalSemaphoreValues = signalValues;
+        submitInfo.pNext = &timelineInfo;
+    }
+
     if (FILAMENT_VULKAN_VERBOSE) {
         slog.i << "Submitting cmdbuffer=" << mCurrent->cmdbuffer
             << " wait=(" << signals[0] << ", " << signals[1] << ") "
@@ -200,6 +243,11 @@ bool VulkanCommands::flush() {
 
     assert_invariant(result == VK_SUCCESS);
 
+    if (mTimeline) {
+        (mIsTransferQueue ? mTimeline->lastTransfer : mTimeline->lastGraphics) =
+                timelineSignalValue;
+    }
+
     mSubmissionSignal = renderingFinished;
     mInjectedSignal = VK_NULL_HANDLE;
     mCurrent = nullptr;
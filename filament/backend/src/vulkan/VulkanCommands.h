@@ -57,11 +57,27 @@ public:
     virtual ~CommandBufferObserver();
 };
 
+// Cross-queue synchronization state shared between the graphics queue and the dedicated
+// transfer queue. Every submission signals the next monotonic value; graphics submissions
+// wait for the latest transfer value and vice versa, which fully serializes the two queues'
+// submissions against each other. This is deliberately coarse: uploads are small relative to
+// a frame, and it sidesteps per-resource queue-family ownership transfers entirely.
+struct VulkanTimeline {
+    VkSemaphore semaphore = VK_NULL_HANDLE;
+    uint64_t nextValue = 1;
+    uint64_t lastGraphics = 0;
+    uint64_t lastTransfer = 0;
+};
+
 // Lazily creates command buffers and manages a set of submitted command buffers.
 // Submitted command buffers form a dependency chain using VkSemaphore.
 class VulkanCommands {
     public:
-        VulkanCommands(VkDevice device, uint32_t queueFamilyIndex);
+        // The timeline is optional; when given, every flush participates in the cross-queue
+        // ordering described above. "isTransferQueue" selects which side of the timeline this
+        // instance signals.
+        VulkanCommands(VkDevice device, uint32_t queueFamilyIndex,
+                VulkanTimeline* timeline = nullptr, bool isTransferQueue = false);
         ~VulkanCommands();
 
         // Creates a "current" command buffer if none exists, otherwise returns the current one.
@@ -93,11 +109,19 @@ class VulkanCommands {
         // The observer's event handler can only be called during get().
         void setObserver(CommandBufferObserver* observer) { mObserver = observer; }
 
+        // Declares another VulkanCommands instance whose pending work must be submitted before
+        // ours. Used by the graphics instance to submit outstanding uploads on the transfer
+        // queue first, so that the timeline wait described above covers them.
+        void setDependency(VulkanCommands* commands) { mDependency = commands; }
+
     private:
         static constexpr int CAPACITY = VK_MAX_COMMAND_BUFFERS;
         const VkDevice mDevice;
         VkQueue mQueue;
         VkCommandPool mPool;
+        VulkanTimeline* const mTimeline;
+        const bool mIsTransferQueue;
+        VulkanCommands* mDependency = nullptr;
         VulkanCommandBuffer* mCurrent = nullptr;
         VkSemaphore mSubmissionSignal = {};
         VkSemaphore mInjectedSignal = {};
@@ -56,6 +56,16 @@ constexpr static const int VK_REQUIRED_VERSION_MINOR = 0;
 // Controls the block size for the VkBuffer pools that we use for vertex buffers.
 constexpr static const uint64_t VMA_BUFFER_POOL_BLOCK_SIZE_IN_MB = 128;
 
+// Controls the block size for the VkImage pools. Sampleable textures and attachments live in
+// separate pools because their lifetimes are very different: attachments are recreated whenever
+// the swap chain is resized, while textures tend to live for the duration of the app.
+constexpr static const uint64_t VMA_IMAGE_POOL_BLOCK_SIZE_IN_MB = 64;
+
+// Number of garbage collection cycles (approximately frames) between fragmentation checks of the
+// GPU buffer pool. Defragmentation stalls the device, so we perform it rarely, and only when the
+// pool statistics show that compaction would actually give a block back to the driver.
+constexpr static const uint32_t VMA_DEFRAG_FRAME_INTERVAL = 1024;
+
 // Maximum number of VkCommandBuffer handles managed simultaneously by VulkanCommands.
 //
 // This includes the "current" command buffer that is being written into, as well as any command
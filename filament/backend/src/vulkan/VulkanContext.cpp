@@ -65,6 +65,7 @@ void VulkanContext::selectPhysicalDevice() {
         vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamiliesCount,
                 queueFamiliesProperties.data());
         graphicsQueueFamilyIndex = 0xffff;
+        transferQueueFamilyIndex = 0xffff;
         for (uint32_t j = 0; j < queueFamiliesCount; ++j) {
             VkQueueFamilyProperties props = queueFamiliesProperties[j];
             if (props.queueCount == 0) {
@@ -72,6 +73,11 @@ void VulkanContext::selectPhysicalDevice() {
             }
             if (props.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
                 graphicsQueueFamilyIndex = j;
+            } else if (props.queueFlags & VK_QUEUE_TRANSFER_BIT) {
+                // Transfer-only family (DMA engine on discrete GPUs), used to move texture and
+                // buffer uploads off the graphics queue. A family that also supports graphics
+                // would alias the same hardware queue, which defeats the purpose.
+                transferQueueFamilyIndex = j;
             }
         }
         if (graphicsQueueFamilyIndex == 0xffff) continue;
@@ -97,6 +103,9 @@ void VulkanContext::selectPhysicalDevice() {
             if (!strcmp(extensions[k].extensionName, VK_KHR_PORTABILITY_SUBSET_EXTENSION_NAME)) {
                 portabilitySubsetSupported = true;
             }
+            if (!strcmp(extensions[k].extensionName, VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME)) {
+                incrementalPresentSupported = true;
+            }
             if (!strcmp(extensions[k].extensionName, VK_KHR_MAINTENANCE1_EXTENSION_NAME)) {
                 maintenanceSupported[0] = true;
             }
@@ -113,6 +122,21 @@ void VulkanContext::selectPhysicalDevice() {
         vkGetPhysicalDeviceFeatures(physicalDevice, &physicalDeviceFeatures);
         vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
 
+        // The dedicated transfer queue relies on timeline semaphores (core in 1.2) for
+        // cross-queue ordering, so check for their support here.
+        timelineSemaphoresSupported = false;
+        if (vkGetPhysicalDeviceFeatures2 && (major > 1 || minor >= 2)) {
+            VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures = {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES,
+            };
+            VkPhysicalDeviceFeatures2 physicalDeviceFeatures2 = {
+                .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+                .pNext = &timelineFeatures,
+            };
+            vkGetPhysicalDeviceFeatures2(physicalDevice, &physicalDeviceFeatures2);
+            timelineSemaphoresSupported = timelineFeatures.timelineSemaphore == VK_TRUE;
+        }
+
         // Print some driver or MoltenVK information if it is available.
         if (vkGetPhysicalDeviceProperties2KHR) {
             VkPhysicalDeviceDriverProperties driverProperties = {
@@ -162,11 +186,11 @@ void VulkanContext::selectPhysicalDevice() {
 }
 
 void VulkanContext::createLogicalDevice() {
-    VkDeviceQueueCreateInfo deviceQueueCreateInfo[1] = {};
+    VkDeviceQueueCreateInfo deviceQueueCreateInfo[2] = {};
     const float queuePriority[] = {1.0f};
     VkDeviceCreateInfo deviceCreateInfo = {};
     FixedCapacityVector<const char*> deviceExtensionNames;
-    deviceExtensionNames.reserve(6);
+    deviceExtensionNames.reserve(7);
     deviceExtensionNames.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
     if (debugMarkersSupported && !debugUtilsSupported) {
         deviceExtensionNames.push_back(VK_EXT_DEBUG_MARKER_EXTENSION_NAME);
@@ -174,6 +198,9 @@ void VulkanContext::createLogicalDevice() {
     if (portabilitySubsetSupported) {
         deviceExtensionNames.push_back(VK_KHR_PORTABILITY_SUBSET_EXTENSION_NAME);
     }
+    if (incrementalPresentSupported) {
+        deviceExtensionNames.push_back(VK_KHR_INCREMENTAL_PRESENT_EXTENSION_NAME);
+    }
     if (maintenanceSupported[0]) {
         deviceExtensionNames.push_back(VK_KHR_MAINTENANCE1_EXTENSION_NAME);
     }
@@ -191,6 +218,16 @@ void VulkanContext::createLogicalDevice() {
     deviceCreateInfo.queueCreateInfoCount = 1;
     deviceCreateInfo.pQueueCreateInfos = deviceQueueCreateInfo;
 
+    // Without timeline semaphores we have no way to order uploads against rendering across
+    // queues, so the dedicated transfer queue is only requested when both are available.
+    const bool useTransferQueue =
+            transferQueueFamilyIndex != 0xffff && timelineSemaphoresSupported;
+    if (useTransferQueue) {
+        deviceQueueCreateInfo[1] = deviceQueueCreateInfo[0];
+        deviceQueueCreateInfo[1].queueFamilyIndex = transferQueueFamilyIndex;
+        deviceCreateInfo.queueCreateInfoCount = 2;
+    }
+
     // We could simply enable all supported features, but since that may have performance
     // consequences let's just enable the features we need.
     const auto& supportedFeatures = physicalDeviceFeatures;
@@ -214,11 +251,23 @@ void VulkanContext::createLogicalDevice() {
         deviceCreateInfo.pNext = &portability;
     }
 
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures = {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES,
+        .timelineSemaphore = VK_TRUE,
+    };
+    if (useTransferQueue) {
+        timelineFeatures.pNext = const_cast<void*>(deviceCreateInfo.pNext);
+        deviceCreateInfo.pNext = &timelineFeatures;
+    }
+
     VkResult result = vkCreateDevice(physicalDevice, &deviceCreateInfo, VKALLOC,
             &device);
     ASSERT_POSTCONDITION(result == VK_SUCCESS, "vkCreateDevice error.");
     vkGetDeviceQueue(device, graphicsQueueFamilyIndex, 0,
             &graphicsQueue);
+    if (useTransferQueue) {
+        vkGetDeviceQueue(device, transferQueueFamilyIndex, 0, &transferQueue);
+    }
 
     VkCommandPoolCreateInfo createInfo = {};
     createInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
@@ -301,7 +350,69 @@ void VulkanContext::createLogicalDevice() {
     res = vmaCreatePool(allocator, &cpuPoolInfo, &vmaPoolCPU);
     assert_invariant(res == VK_SUCCESS);
 
-    commands = new VulkanCommands(device, graphicsQueueFamilyIndex);
+    // Create two pools for VkImage objects, segregated by lifetime: one for sampleable textures,
+    // which typically live for the duration of the app, and one for attachments, which are
+    // recreated on every resize. Without this segregation, a long-running app slowly fragments
+    // device memory by punching attachment-sized holes into blocks of long-lived textures. The
+    // memory type is found using a representative image for each class; images whose type bits
+    // don't match the pool fall back to a dedicated allocation (see VulkanTexture).
+    const VkImageCreateInfo sampledImageInfo {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .imageType = VK_IMAGE_TYPE_2D,
+        .format = VK_FORMAT_R8G8B8A8_UNORM,
+        .extent = { 16, 16, 1 },
+        .mipLevels = 1,
+        .arrayLayers = 1,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+    };
+    memTypeIndex = UINT32_MAX;
+    res = vmaFindMemoryTypeIndexForImageInfo(allocator, &sampledImageInfo, &gpuInfo,
+            &memTypeIndex);
+    assert_invariant(res == VK_SUCCESS && memTypeIndex != UINT32_MAX);
+    const VmaPoolCreateInfo imagePoolInfo {
+        .memoryTypeIndex = memTypeIndex,
+        .blockSize = VMA_IMAGE_POOL_BLOCK_SIZE_IN_MB * 1024 * 1024,
+    };
+    res = vmaCreatePool(allocator, &imagePoolInfo, &vmaPoolImages);
+    assert_invariant(res == VK_SUCCESS);
+
+    VkImageCreateInfo attachmentImageInfo = sampledImageInfo;
+    attachmentImageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    memTypeIndex = UINT32_MAX;
+    res = vmaFindMemoryTypeIndexForImageInfo(allocator, &attachmentImageInfo, &gpuInfo,
+            &memTypeIndex);
+    assert_invariant(res == VK_SUCCESS && memTypeIndex != UINT32_MAX);
+    const VmaPoolCreateInfo attachmentPoolInfo {
+        .memoryTypeIndex = memTypeIndex,
+        .blockSize = VMA_IMAGE_POOL_BLOCK_SIZE_IN_MB * 1024 * 1024,
+    };
+    res = vmaCreatePool(allocator, &attachmentPoolInfo, &vmaPoolAttachments);
+    assert_invariant(res == VK_SUCCESS);
+
+    sharedQueueFamilies[0] = graphicsQueueFamilyIndex;
+    sharedQueueFamilyCount = 1;
+    if (useTransferQueue) {
+        const VkSemaphoreTypeCreateInfo timelineCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+            .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+            .initialValue = 0,
+        };
+        const VkSemaphoreCreateInfo semaphoreCreateInfo {
+            .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+            .pNext = &timelineCreateInfo,
+        };
+        result = vkCreateSemaphore(device, &semaphoreCreateInfo, VKALLOC, &timeline.semaphore);
+        ASSERT_POSTCONDITION(result == VK_SUCCESS, "vkCreateSemaphore error.");
+        transferCommands = new VulkanCommands(device, transferQueueFamilyIndex, &timeline, true);
+        sharedQueueFamilies[sharedQueueFamilyCount++] = transferQueueFamilyIndex;
+        utils::slog.i << "Texture and buffer uploads routed to transfer queue family "
+                << transferQueueFamilyIndex << utils::io::endl;
+    }
+
+    commands = new VulkanCommands(device, graphicsQueueFamilyIndex,
+            transferCommands ? &timeline : nullptr, false);
+    commands->setDependency(transferCommands);
 }
 
 uint32_t VulkanContext::selectMemoryType(uint32_t flags, VkFlags reqs) {
@@ -28,6 +28,8 @@
 #include <utils/Slice.h>
 #include <utils/Mutex.h>
 
+#include <vector>
+
 VK_DEFINE_HANDLE(VmaAllocator)
 VK_DEFINE_HANDLE(VmaPool)
 
@@ -37,6 +39,7 @@ namespace backend {
 struct VulkanRenderTarget;
 struct VulkanSwapChain;
 struct VulkanTexture;
+class VulkanBuffer;
 class VulkanStagePool;
 
 // TODO: make this as lean as possible, it makes VulkanRenderTarget very big (currently 880 bytes).
@@ -84,9 +87,26 @@ struct VulkanContext {
     VulkanTimestamps timestamps;
     uint32_t graphicsQueueFamilyIndex;
     VkQueue graphicsQueue;
+
+    // Dedicated transfer queue used for texture and buffer uploads, so that streaming does not
+    // consume graphics-queue time. Only available when the device exposes a transfer-only queue
+    // family and timeline semaphores (see VulkanTimeline); 0xffff / null otherwise, in which
+    // case uploads fall back to the graphics queue.
+    uint32_t transferQueueFamilyIndex = 0xffff;
+    VkQueue transferQueue = VK_NULL_HANDLE;
+    bool timelineSemaphoresSupported = false;
+    VulkanTimeline timeline;
+
+    // Queue families that upload targets (buffers, sampleable images, staging memory) are shared
+    // with when the transfer queue is available; used with VK_SHARING_MODE_CONCURRENT to avoid
+    // explicit queue-family ownership transfers.
+    uint32_t sharedQueueFamilies[2] = {};
+    uint32_t sharedQueueFamilyCount = 1;
+
     bool debugMarkersSupported = false;
     bool debugUtilsSupported = false;
     bool portabilitySubsetSupported = false;
+    bool incrementalPresentSupported = false;
     bool maintenanceSupported[3] = {};
     VulkanPipelineCache::RasterState rasterState;
     VulkanSwapChain* currentSurface;
@@ -96,8 +116,23 @@ struct VulkanContext {
     VmaAllocator allocator;
     VmaPool vmaPoolGPU;
     VmaPool vmaPoolCPU;
+    VmaPool vmaPoolImages;
+    VmaPool vmaPoolAttachments;
+
+    // Every live VulkanBuffer registers itself here so that the driver can enumerate the
+    // allocations in the GPU buffer pool when defragmenting it.
+    std::vector<VulkanBuffer*> bufferRegistry;
+
     VulkanTexture* emptyTexture = nullptr;
     VulkanCommands* commands = nullptr;
+    VulkanCommands* transferCommands = nullptr;
+
+    // The command stream that uploads should be recorded into: the dedicated transfer queue
+    // when available, the graphics queue otherwise.
+    VulkanCommands& uploadCommands() noexcept {
+        return transferCommands ? *transferCommands : *commands;
+    }
+
     std::string currentDebugMarker;
 };
 
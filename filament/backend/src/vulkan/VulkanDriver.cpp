@@ -320,6 +320,11 @@ void VulkanDriver::terminate() {
     }
 
     delete mContext.commands;
+    delete mContext.transferCommands;
+    if (mContext.timeline.semaphore) {
+        vkDestroySemaphore(mContext.device, mContext.timeline.semaphore, VKALLOC);
+        mContext.timeline.semaphore = VK_NULL_HANDLE;
+    }
     delete mContext.emptyTexture;
 
     mBlitter.shutdown();
@@ -335,6 +340,8 @@ void VulkanDriver::terminate() {
 
     vmaDestroyPool(mContext.allocator, mContext.vmaPoolGPU);
     vmaDestroyPool(mContext.allocator, mContext.vmaPoolCPU);
+    vmaDestroyPool(mContext.allocator, mContext.vmaPoolImages);
+    vmaDestroyPool(mContext.allocator, mContext.vmaPoolAttachments);
     vmaDestroyAllocator(mContext.allocator);
 
     vkDestroyQueryPool(mContext.device, mContext.timestamps.pool, VKALLOC);
@@ -353,6 +360,9 @@ void VulkanDriver::terminate() {
 
 void VulkanDriver::tick(int) {
     mContext.commands->updateFences();
+    if (mContext.transferCommands) {
+        mContext.transferCommands->updateFences();
+    }
 }
 
 // Garbage collection should not occur too frequently, only about once per frame. Internally, the
@@ -364,6 +374,88 @@ void VulkanDriver::collectGarbage() {
     mFramebufferCache.gc();
     mDisposer.gc();
     mContext.commands->gc();
+    if (mContext.transferCommands) {
+        mContext.transferCommands->gc();
+    }
+
+    // Periodically compact the GPU buffer pool. Long-running apps (e.g. signage) otherwise
+    // fragment device memory over days of buffer churn, until large allocations start to fail
+    // even though plenty of memory is free in aggregate. Defragmentation stalls the device, so
+    // it only kicks in when more than half of the pool's reserved memory sits unused across
+    // multiple blocks, i.e. when compaction would actually return a block to the driver;
+    // well-behaved apps never pay for it.
+    if (++mFramesSinceDefragCheck >= VMA_DEFRAG_FRAME_INTERVAL) {
+        mFramesSinceDefragCheck = 0;
+        VmaPoolStats stats = {};
+        vmaGetPoolStats(mContext.allocator, mContext.vmaPoolGPU, &stats);
+        if (stats.blockCount > 1 && stats.unusedSize > stats.size / 2) {
+            defragmentMemory();
+        }
+    }
+}
+
+// Compacts the GPU buffer pool using the allocator's defragmentation support. This waits for the
+// device to go idle, so callers should invoke it rarely, and only when the pool statistics show
+// actual fragmentation. Images are left alone: moving them would require recreating every cached
+// view and descriptor, so attachments are segregated into their own pool instead (the main cause
+// of image churn), which keeps the image pools from fragmenting in the first place.
+void VulkanDriver::defragmentMemory() {
+    auto const& buffers = mContext.bufferRegistry;
+    if (buffers.empty()) {
+        return;
+    }
+
+    std::vector<VmaAllocation> allocations(buffers.size());
+    std::vector<VkBool32> changed(buffers.size());
+    for (size_t i = 0; i < buffers.size(); i++) {
+        allocations[i] = buffers[i]->getAllocation();
+    }
+
+    // The allocator moves allocations with transfers, so nothing that references them may still
+    // be in flight.
+    mContext.commands->flush();
+    mContext.commands->wait();
+    if (mContext.transferCommands) {
+        mContext.transferCommands->wait();
+    }
+
+    VmaDefragmentationInfo2 defragInfo = {};
+    defragInfo.allocationCount = (uint32_t) allocations.size();
+    defragInfo.pAllocations = allocations.data();
+    defragInfo.pAllocationsChanged = changed.data();
+    defragInfo.maxGpuBytesToMove = VK_WHOLE_SIZE;
+    defragInfo.maxGpuAllocationsToMove = UINT32_MAX;
+    defragInfo.commandBuffer = mContext.commands->get().cmdbuffer;
+
+    VmaDefragmentationContext defragContext;
+    VmaDefragmentationStats stats = {};
+    vmaDefragmentationBegin(mContext.allocator, &defragInfo, &stats, &defragContext);
+
+    // Execute the copy commands that the allocator recorded, then let it release the old blocks.
+    mContext.commands->flush();
+    mContext.commands->wait();
+    if (mContext.transferCommands) {
+        mContext.transferCommands->wait();
+    }
+    vmaDefragmentationEnd(mContext.allocator, defragContext);
+
+    // VkBuffer objects are immutably bound to their memory region, so every buffer whose
+    // allocation moved must be recreated. Descriptor sets baked with the old VkBuffer handles
+    // must be evicted as well.
+    for (size_t i = 0; i < buffers.size(); i++) {
+        if (changed[i]) {
+            if (buffers[i]->getUsage() & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT) {
+                mPipelineCache.unbindUniformBuffer(buffers[i]->getGpuBuffer());
+            }
+            buffers[i]->rebind(mContext);
+        }
+    }
+
+#if FILAMENT_VULKAN_VERBOSE
+    utils::slog.d << "Defragmentation moved " << stats.allocationsMoved << " allocations ("
+            << stats.bytesMoved << " bytes), freed " << stats.deviceMemoryBlocksFreed
+            << " blocks." << utils::io::endl;
+#endif
 }
 
 void VulkanDriver::beginFrame(int64_t monotonic_clock_ns, uint32_t frameId) {
@@ -383,6 +475,10 @@ void VulkanDriver::setFrameCompletedCallback(Handle<HwSwapChain> sch,
 void VulkanDriver::setPresentationTime(int64_t monotonic_clock_ns) {
 }
 
+void VulkanDriver::setProgramBinaryCacheDirectory(utils::CString&& path) {
+    mPipelineCache.setCacheDirectory(std::move(path), mContext.physicalDeviceProperties);
+}
+
 void VulkanDriver::endFrame(uint32_t frameId) {
     if (mContext.commands->flush()) {
         collectGarbage();
@@ -838,12 +934,39 @@ uint8_t VulkanDriver::getMaxDrawBuffers() {
     return backend::MRT::MIN_SUPPORTED_RENDER_TARGET_COUNT; // TODO: query real value
 }
 
+HandleAllocatorStats VulkanDriver::getHandleAllocatorStats() {
+    return mHandleAllocator.getStats();
+}
+
+uint64_t VulkanDriver::getMemoryPoolSize() {
+    // This is called from the application thread rather than the driver thread, which is safe
+    // because the allocator synchronizes its internal state.
+    if (!mContext.allocator) {
+        // The device (and with it the allocator) is created lazily with the first swap chain.
+        return 0;
+    }
+    const VmaPool pools[] = {
+        mContext.vmaPoolGPU,
+        mContext.vmaPoolCPU,
+        mContext.vmaPoolImages,
+        mContext.vmaPoolAttachments,
+    };
+    uint64_t total = 0;
+    for (VmaPool pool : pools) {
+        VmaPoolStats stats = {};
+        vmaGetPoolStats(mContext.allocator, pool, &stats);
+        total += stats.size;
+    }
+    return total;
+}
+
 void VulkanDriver::setVertexBufferObject(Handle<HwVertexBuffer> vbh, uint32_t index,
         Handle<HwBufferObject> boh) {
     auto& vb = *handle_cast<VulkanVertexBuffer*>(vbh);
     auto& bo = *handle_cast<VulkanBufferObject*>(boh);
     assert_invariant(bo.bindingType == BufferObjectBinding::VERTEX);
     vb.buffers[index] = &bo.buffer;
+    vb.invalidateBindings();
 }
 
 void VulkanDriver::updateIndexBuffer(Handle<HwIndexBuffer> ibh, BufferDescriptor&& p,
@@ -978,6 +1101,15 @@ void VulkanDriver::updateSamplerGroup(Handle<HwSamplerGroup> sbh,
         SamplerGroup&& samplerGroup) {
     auto* sb = handle_cast<VulkanSamplerGroup*>(sbh);
     *sb->sb = samplerGroup;
+
+    // Intern the sampler object for each entry now, so that the draw loop can bind by index
+    // instead of performing a params hash lookup for every sampler of every draw call.
+    SamplerGroup const& group = *sb->sb;
+    SamplerGroup::Sampler const* samplers = group.getSamplers();
+    sb->vkSamplers.resize(group.getSize());
+    for (size_t i = 0, n = group.getSize(); i < n; i++) {
+        sb->vkSamplers[i] = mSamplerCache.getSampler(samplers[i].s);
+    }
 }
 
 void VulkanDriver::beginRenderPass(Handle<HwRenderTarget> rth, const RenderPassParams& params) {
@@ -1318,6 +1450,28 @@ void VulkanDriver::commit(Handle<HwSwapChain> sch) {
         .pSwapchains = &surface.swapchain,
         .pImageIndices = &surface.currentSwapIndex,
     };
+    // When the frame carries a damage hint and the device supports incremental present, tell
+    // the presentation engine which region actually changed so it can recompose only that.
+    VkRectLayerKHR damageRect;
+    VkPresentRegionKHR presentRegion;
+    VkPresentRegionsKHR presentRegions;
+    if (UTILS_UNLIKELY(surface.hasPendingDamage)) {
+        surface.hasPendingDamage = false;
+        if (mContext.incrementalPresentSupported) {
+            damageRect = surface.pendingDamage;
+            presentRegion = {
+                .rectangleCount = 1,
+                .pRectangles = &damageRect,
+            };
+            presentRegions = {
+                .sType = VK_STRUCTURE_TYPE_PRESENT_REGIONS_KHR,
+                .swapchainCount = 1,
+                .pRegions = &presentRegion,
+            };
+            presentInfo.pNext = &presentRegions;
+        }
+    }
+
     VkResult result = vkQueuePresentKHR(surface.presentQueue, &presentInfo);
 
     // On Android Q and above, a suboptimal surface is always reported after screen rotation:
@@ -1332,6 +1486,21 @@ void VulkanDriver::commit(Handle<HwSwapChain> sch) {
             result == VK_ERROR_OUT_OF_DATE_KHR);
 }
 
+void VulkanDriver::setPresentFrameDamage(Handle<HwSwapChain> sch, uint32_t left, uint32_t bottom,
+        uint32_t width, uint32_t height) {
+    VulkanSwapChain& surface = *handle_cast<VulkanSwapChain*>(sch);
+    // Convert from the viewport convention (bottom-left origin) to Vulkan surface
+    // coordinates (top-left origin).
+    const uint32_t surfaceHeight = surface.clientSize.height;
+    const uint32_t top = surfaceHeight >= bottom + height ? surfaceHeight - bottom - height : 0;
+    surface.pendingDamage = {
+        .offset = { int32_t(left), int32_t(top) },
+        .extent = { width, height },
+        .layer = 0,
+    };
+    surface.hasPendingDamage = true;
+}
+
 void VulkanDriver::bindUniformBuffer(uint32_t index, Handle<HwBufferObject> boh) {
     auto* bo = handle_cast<VulkanBufferObject*>(boh);
     // The driver API does not currently expose offset / range, but it will do so in the future.
@@ -1453,6 +1622,9 @@ void VulkanDriver::readPixels(Handle<HwRenderTarget> src, uint32_t x, uint32_t y
 
     mContext.commands->flush();
     mContext.commands->wait();
+    if (mContext.transferCommands) {
+        mContext.transferCommands->wait();
+    }
 
     // Transition the staging image layout.
 
@@ -1553,6 +1725,9 @@ void VulkanDriver::readPixels(Handle<HwRenderTarget> src, uint32_t x, uint32_t y
     // Flush and wait.
     mContext.commands->flush();
     mContext.commands->wait();
+    if (mContext.transferCommands) {
+        mContext.transferCommands->wait();
+    }
 
     VkImageSubresource subResource { .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT };
     VkSubresourceLayout subResourceLayout;
@@ -1630,7 +1805,8 @@ void VulkanDriver::blit(TargetBufferFlags buffers, Handle<HwRenderTarget> dst, V
     }
 }
 
-void VulkanDriver::draw(PipelineState pipelineState, Handle<HwRenderPrimitive> rph) {
+void VulkanDriver::draw(PipelineState pipelineState, Handle<HwRenderPrimitive> rph,
+        uint32_t instanceCount) {
     VulkanCommandBuffer const* commands = &mContext.commands->get();
     VkCommandBuffer cmdbuffer = commands->cmdbuffer;
     const VulkanRenderPrimitive& prim = *handle_cast<VulkanRenderPrimitive*>(rph);
@@ -1689,57 +1865,21 @@ void VulkanDriver::draw(PipelineState pipelineState, Handle<HwRenderPrimitive> r
 
     mContext.rasterState.colorTargetCount = rt->getColorTargetCount(mContext.currentRenderPass);
 
-    // Declare fixed-size arrays that get passed to the pipeCache and to vkCmdBindVertexBuffers.
-    VulkanPipelineCache::VertexArray varray = {};
-    VkBuffer buffers[backend::MAX_VERTEX_ATTRIBUTE_COUNT] = {};
-    VkDeviceSize offsets[backend::MAX_VERTEX_ATTRIBUTE_COUNT] = {};
-
-    // For each attribute, append to each of the above lists.
-    const uint32_t bufferCount = prim.vertexBuffer->attributes.size();
-    for (uint32_t attribIndex = 0; attribIndex < bufferCount; attribIndex++) {
-        Attribute attrib = prim.vertexBuffer->attributes[attribIndex];
-
-        const bool isInteger = attrib.flags & Attribute::FLAG_INTEGER_TARGET;
-        const bool isNormalized = attrib.flags & Attribute::FLAG_NORMALIZED;
-
-        VkFormat vkformat = getVkFormat(attrib.type, isNormalized, isInteger);
-
-        // HACK: Re-use the positions buffer as a dummy buffer for disabled attributes. Filament's
-        // vertex shaders declare all attributes as either vec4 or uvec4 (the latter for bone
-        // indices), and positions are always at least 32 bits per element. Therefore we can assign
-        // a dummy type of either R8G8B8A8_UINT or R8G8B8A8_SNORM, depending on whether the shader
-        // expects to receive floats or ints.
-        if (attrib.buffer == Attribute::BUFFER_UNUSED) {
-            vkformat = isInteger ? VK_FORMAT_R8G8B8A8_UINT : VK_FORMAT_R8G8B8A8_SNORM;
-            attrib = prim.vertexBuffer->attributes[0];
-        }
-
-        const VulkanBuffer* buffer = prim.vertexBuffer->buffers[attrib.buffer];
+    // Fetch the cached vertex binding state; it's only rebuilt when a constituent buffer
+    // object was (re)assigned.
+    VulkanVertexBuffer::Bindings const& bindings = prim.vertexBuffer->getBindings();
 
-        // If the vertex buffer is missing a constituent buffer object, skip the draw call.
-        // There is no need to emit an error message because this is not explicitly forbidden.
-        if (buffer == nullptr) {
-            return;
-        }
-
-        buffers[attribIndex] = buffer->getGpuBuffer();
-        offsets[attribIndex] = attrib.offset;
-        varray.attributes[attribIndex] = {
-            .location = attribIndex, // matches the GLSL layout specifier
-            .binding = attribIndex,  // matches the position within vkCmdBindVertexBuffers
-            .format = vkformat,
-        };
-        varray.buffers[attribIndex] = {
-            .binding = attribIndex,
-            .stride = attrib.stride,
-        };
+    // If the vertex buffer is missing a constituent buffer object, skip the draw call.
+    // There is no need to emit an error message because this is not explicitly forbidden.
+    if (UTILS_UNLIKELY(!bindings.valid)) {
+        return;
     }
 
     // Push state changes to the VulkanPipelineCache instance. This is fast and does not make VK calls.
     mPipelineCache.bindProgram(*program);
     mPipelineCache.bindRasterState(mContext.rasterState);
     mPipelineCache.bindPrimitiveTopology(prim.primitiveTopology);
-    mPipelineCache.bindVertexArray(varray);
+    mPipelineCache.bindVertexArray(bindings.varray);
 
     // Query the program for the mapping from (SamplerGroupBinding,Offset) to (SamplerBinding),
     // where "SamplerBinding" is the integer in the GLSL, and SamplerGroupBinding is the abstract
@@ -1785,8 +1925,14 @@ void VulkanDriver::draw(PipelineState pipelineState, Handle<HwRenderPrimitive> r
                 mDisposer.acquire(texture);
             }
 
-            const SamplerParams& samplerParams = boundSampler->s;
-            VkSampler vksampler = mSamplerCache.getSampler(samplerParams);
+            // The sampler object was interned when the group was last updated; fall back to a
+            // cache lookup only if the group is somehow bound without ever being updated.
+            VkSampler vksampler;
+            if (UTILS_LIKELY(samplerIdx <= vksb->vkSamplers.size())) {
+                vksampler = vksb->vkSamplers[samplerIdx - 1];
+            } else {
+                vksampler = mSamplerCache.getSampler(boundSampler->s);
+            }
 
             iInfo[bindingPoint] = {
                 .sampler = vksampler,
@@ -1835,13 +1981,13 @@ void VulkanDriver::draw(PipelineState pipelineState, Handle<HwRenderPrimitive> r
     // Next bind the vertex buffers and index buffer. One potential performance improvement is to
     // avoid rebinding these if they are already bound, but since we do not (yet) support subranges
     // it would be rare for a client to make consecutive draw calls with the same render primitive.
-    vkCmdBindVertexBuffers(cmdbuffer, 0, bufferCount, buffers, offsets);
+    vkCmdBindVertexBuffers(cmdbuffer, 0, uint32_t(prim.vertexBuffer->attributes.size()),
+            bindings.vkbuffers, bindings.offsets);
     vkCmdBindIndexBuffer(cmdbuffer, prim.indexBuffer->buffer.getGpuBuffer(), 0,
             prim.indexBuffer->indexType);
 
     // Finally, make the actual draw call. TODO: support subranges
     const uint32_t indexCount = prim.count;
-    const uint32_t instanceCount = 1;
     const uint32_t firstIndex = prim.offset / prim.indexBuffer->elementSize;
     const int32_t vertexOffset = 0;
     const uint32_t firstInstId = 1;
@@ -135,6 +135,7 @@ private:
 
     void refreshSwapChain();
     void collectGarbage();
+    void defragmentMemory();
 
     VulkanContext mContext = {};
     VulkanPipelineCache mPipelineCache;
@@ -147,6 +148,7 @@ private:
     VulkanSamplerGroup* mSamplerBindings[VulkanPipelineCache::SAMPLER_BINDING_COUNT] = {};
     VkDebugReportCallbackEXT mDebugCallback = VK_NULL_HANDLE;
     VkDebugUtilsMessengerEXT mDebugMessenger = VK_NULL_HANDLE;
+    uint32_t mFramesSinceDefragCheck = 0;
 };
 
 } // namespace backend
@@ -165,8 +165,11 @@ VulkanRenderTarget::VulkanRenderTarget(VulkanContext& context, uint32_t width, u
         if (texture && texture->samples == 1) {
             VulkanTexture* msTexture = texture->getSidecar();
             if (UTILS_UNLIKELY(msTexture == nullptr)) {
+                // The sidecar is resolved within the render pass and never stored, sampled, or
+                // blitted, so it can be transient (and thus lazily allocated on tiled GPUs).
                 msTexture = new VulkanTexture(context, texture->target, level,
-                        texture->format, samples, width, height, depth, texture->usage, stagePool);
+                        texture->format, samples, width, height, depth, texture->usage, stagePool,
+                        {}, /* transient = */ true);
                 texture->setSidecar(msTexture);
             }
             mMsaaAttachments[index] = createAttachment(context, { .texture = msTexture });
@@ -191,8 +194,12 @@ VulkanRenderTarget::VulkanRenderTarget(VulkanContext& context, uint32_t width, u
     // Create sidecar MSAA texture for the depth attachment.
     VulkanTexture* msTexture = depthTexture->getSidecar();
     if (UTILS_UNLIKELY(msTexture == nullptr)) {
+        // Like the color sidecars, the MSAA depth image never leaves the attachment path, so
+        // it is transient as well; if a pass does store it, lazily-allocated memory is simply
+        // committed by the driver at that point.
         msTexture = new VulkanTexture(context, depthTexture->target, level,
-                depthTexture->format, samples, width, height, depth, depthTexture->usage, stagePool);
+                depthTexture->format, samples, width, height, depth, depthTexture->usage, stagePool,
+                {}, /* transient = */ true);
         depthTexture->setSidecar(msTexture);
     }
     mMsaaDepthAttachment = createAttachment(context, {
@@ -265,6 +272,52 @@ VulkanVertexBuffer::VulkanVertexBuffer(VulkanContext& context, VulkanStagePool&
         HwVertexBuffer(bufferCount, attributeCount, elementCount, attribs),
         buffers(bufferCount, nullptr) {}
 
+void VulkanVertexBuffer::updateBindings() noexcept {
+    mBindingsDirty = false;
+    mBindings = {};
+    const uint32_t attribCount = attributes.size();
+    for (uint32_t attribIndex = 0; attribIndex < attribCount; attribIndex++) {
+        Attribute attrib = attributes[attribIndex];
+
+        const bool isInteger = attrib.flags & Attribute::FLAG_INTEGER_TARGET;
+        const bool isNormalized = attrib.flags & Attribute::FLAG_NORMALIZED;
+
+        VkFormat vkformat = getVkFormat(attrib.type, isNormalized, isInteger);
+
+        // HACK: Re-use the positions buffer as a dummy buffer for disabled attributes. Filament's
+        // vertex shaders declare all attributes as either vec4 or uvec4 (the latter for bone
+        // indices), and positions are always at least 32 bits per element. Therefore we can assign
+        // a dummy type of either R8G8B8A8_UINT or R8G8B8A8_SNORM, depending on whether the shader
+        // expects to receive floats or ints.
+        if (attrib.buffer == Attribute::BUFFER_UNUSED) {
+            vkformat = isInteger ? VK_FORMAT_R8G8B8A8_UINT : VK_FORMAT_R8G8B8A8_SNORM;
+            attrib = attributes[0];
+        }
+
+        VulkanBuffer const* buffer = buffers[attrib.buffer];
+
+        // If the vertex buffer is missing a constituent buffer object, draw calls are skipped
+        // until it is set. There is no need to emit an error message because this is not
+        // explicitly forbidden.
+        if (buffer == nullptr) {
+            return;
+        }
+
+        mBindings.vkbuffers[attribIndex] = buffer->getGpuBuffer();
+        mBindings.offsets[attribIndex] = attrib.offset;
+        mBindings.varray.attributes[attribIndex] = {
+            .location = attribIndex, // matches the GLSL layout specifier
+            .binding = attribIndex,  // matches the position within vkCmdBindVertexBuffers
+            .format = vkformat,
+        };
+        mBindings.varray.buffers[attribIndex] = {
+            .binding = attribIndex,
+            .stride = attrib.stride,
+        };
+    }
+    mBindings.valid = true;
+}
+
 
 VulkanBufferObject::VulkanBufferObject(VulkanContext& context, VulkanStagePool& stagePool,
         uint32_t byteCount, BufferObjectBinding bindingType, BufferUsage usage)
@@ -79,6 +79,30 @@ struct VulkanVertexBuffer : public HwVertexBuffer {
             uint8_t bufferCount, uint8_t attributeCount, uint32_t elementCount,
             AttributeArray const& attributes);
     utils::FixedCapacityVector<VulkanBuffer const*> buffers;
+
+    // Everything draw() needs to bind this vertex buffer, cached so the serial command encode
+    // doesn't redo the format translation and buffer handle gathering on every draw call.
+    struct Bindings {
+        VulkanPipelineCache::VertexArray varray;
+        VkBuffer vkbuffers[MAX_VERTEX_ATTRIBUTE_COUNT];
+        VkDeviceSize offsets[MAX_VERTEX_ATTRIBUTE_COUNT];
+        bool valid;     // false while a constituent buffer object hasn't been set
+    };
+
+    Bindings const& getBindings() noexcept {
+        if (UTILS_UNLIKELY(mBindingsDirty)) {
+            updateBindings();
+        }
+        return mBindings;
+    }
+
+    // must be called whenever a constituent buffer object is (re)assigned
+    void invalidateBindings() noexcept { mBindingsDirty = true; }
+
+private:
+    void updateBindings() noexcept;
+    Bindings mBindings = {};
+    bool mBindingsDirty = true;
 };
 
 struct VulkanIndexBuffer : public HwIndexBuffer {
@@ -102,6 +126,12 @@ struct VulkanBufferObject : public HwBufferObject {
 
 struct VulkanSamplerGroup : public HwSamplerGroup {
     VulkanSamplerGroup(uint32_t count) : HwSamplerGroup(count) {}
+
+    // Sampler objects interned from each entry's SamplerParams when the group is updated, so
+    // that the draw loop can bind by index instead of hashing the params for every sampler of
+    // every draw call. There are only a few dozen unique SamplerParams in practice, so the
+    // interned handles all come from VulkanSamplerCache.
+    std::vector<VkSampler> vkSamplers;
 };
 
 struct VulkanRenderPrimitive : public HwRenderPrimitive {
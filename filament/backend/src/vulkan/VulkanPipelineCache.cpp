@@ -20,6 +20,9 @@
 #include <utils/Log.h>
 #include <utils/Panic.h>
 
+#include <stdio.h>
+#include <string.h>
+
 #include "VulkanConstants.h"
 #include "VulkanHandles.h"
 #include "VulkanUtility.h"
@@ -104,6 +107,14 @@ void VulkanPipelineCache::setDevice(VkDevice device, VmaAllocator allocator) {
     mAllocator = allocator;
     mDescriptorPool = createDescriptorPool(mDescriptorPoolSize);
 
+    // All pipelines are created through a single VkPipelineCache, which lets the driver reuse
+    // baked state across similar pipelines, and is what gets serialized to disk when a cache
+    // directory has been provided (see setCacheDirectory).
+    VkPipelineCacheCreateInfo cacheInfo = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+    };
+    vkCreatePipelineCache(mDevice, &cacheInfo, VKALLOC, &mVkPipelineCache);
+
     // Formulate some dummy objects and dummy descriptor info used only for clearing out unused
     // bindings. This is especially crucial after a texture has been destroyed. Since core Vulkan
     // does not allow specifying VK_NULL_HANDLE without the robustness2 extension, we are forced to
@@ -141,16 +152,116 @@ void VulkanPipelineCache::setDevice(VkDevice device, VmaAllocator allocator) {
     vkCreateSampler(mDevice, &samplerInfo, VKALLOC, &mDummySamplerInfo.sampler);
 }
 
-bool VulkanPipelineCache::bindDescriptors(VkCommandBuffer cmdbuffer) noexcept {
-    DescriptorMap::iterator descriptorIter = mDescriptorSets.find(mDescriptorRequirements);
+std::string VulkanPipelineCache::getDiskCachePath() const noexcept {
+    return std::string{ mCacheDirectory.c_str(), mCacheDirectory.size() } + "/vk_pipelines.bin";
+}
+
+void VulkanPipelineCache::setCacheDirectory(utils::CString directory,
+        VkPhysicalDeviceProperties const& properties) noexcept {
+    assert_invariant(mDevice != VK_NULL_HANDLE);
+    mCacheDirectory = std::move(directory);
+    if (mCacheDirectory.empty()) {
+        return;
+    }
+
+    std::string const path = getDiskCachePath();
+    FILE* const file = fopen(path.c_str(), "rb");
+    if (!file) {
+        return;
+    }
+    fseek(file, 0, SEEK_END);
+    long const fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    std::vector<uint8_t> blob(fileSize > 0 ? size_t(fileSize) : 0u);
+    bool valid = !blob.empty() && fread(blob.data(), 1, blob.size(), file) == blob.size();
+    fclose(file);
+
+    // The spec requires the application to validate the blob's header before passing it back
+    // to the driver, so that entries written by a different GPU or driver version are never
+    // loaded. See VkPipelineCacheHeaderVersionOne.
+    struct {
+        uint32_t headerSize;
+        uint32_t headerVersion;
+        uint32_t vendorID;
+        uint32_t deviceID;
+        uint8_t pipelineCacheUUID[VK_UUID_SIZE];
+    } header;
+    valid = valid && blob.size() >= sizeof(header);
+    if (valid) {
+        memcpy(&header, blob.data(), sizeof(header));
+        valid = header.headerSize >= sizeof(header)
+                && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+                && header.vendorID == properties.vendorID
+                && header.deviceID == properties.deviceID
+                && !memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+    }
+    if (!valid) {
+        remove(path.c_str());
+        return;
+    }
+
+    VkPipelineCacheCreateInfo cacheInfo = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .initialDataSize = blob.size(),
+        .pInitialData = blob.data(),
+    };
+    VkPipelineCache restored;
+    if (vkCreatePipelineCache(mDevice, &cacheInfo, VKALLOC, &restored) != VK_SUCCESS) {
+        return;
+    }
+
+    // Fold in whatever was already created before the directory was provided.
+    if (mVkPipelineCache != VK_NULL_HANDLE) {
+        vkMergePipelineCaches(mDevice, restored, 1, &mVkPipelineCache);
+        vkDestroyPipelineCache(mDevice, mVkPipelineCache, VKALLOC);
+    }
+    mVkPipelineCache = restored;
+}
+
+void VulkanPipelineCache::saveDiskCache() noexcept {
+    if (mCacheDirectory.empty() || mVkPipelineCache == VK_NULL_HANDLE) {
+        return;
+    }
+
+    size_t size = 0;
+    if (vkGetPipelineCacheData(mDevice, mVkPipelineCache, &size, nullptr) != VK_SUCCESS || !size) {
+        return;
+    }
+    std::vector<uint8_t> blob(size);
+    if (vkGetPipelineCacheData(mDevice, mVkPipelineCache, &size, blob.data()) != VK_SUCCESS) {
+        return;
+    }
+
+    // Write to a temporary file first, so a partial write can never be mistaken for a
+    // valid cache.
+    std::string const path = getDiskCachePath();
+    std::string const temp = path + ".tmp";
+    FILE* const file = fopen(temp.c_str(), "wb");
+    if (!file) {
+        return;
+    }
+    bool const ok = fwrite(blob.data(), 1, size, file) == size;
+    fclose(file);
+    if (ok) {
+        rename(temp.c_str(), path.c_str());
+    } else {
+        remove(temp.c_str());
+    }
+}
 
-    // Check if the required descriptors are already bound.
-    if (DescEqual equals; UTILS_LIKELY(equals(mBoundDescriptor, mDescriptorRequirements))) {
-        assert_invariant(descriptorIter != mDescriptorSets.end());
-        descriptorIter.value().lastUsed = mCurrentTime;
+bool VulkanPipelineCache::bindDescriptors(VkCommandBuffer cmdbuffer) noexcept {
+    // Check if the required descriptors are already bound. This is the common case in
+    // draw-call-heavy scenes and it is serviced without hashing or probing the map.
+    if (DescEqual equals; UTILS_LIKELY(mBoundDescriptorEntry &&
+            equals(mBoundDescriptor, mDescriptorRequirements))) {
+        mBoundDescriptorEntry->lastUsed = mCurrentTime;
         return true;
     }
 
+    // The key is hashed only once per state change; the lookup below reuses the hash.
+    const size_t hash = DescHashFn{}(mDescriptorRequirements);
+    DescriptorMap::iterator descriptorIter = mDescriptorSets.find(mDescriptorRequirements, hash);
+
     // If a cached object exists, re-use it, otherwise create a new one.
     DescriptorCacheEntry* cacheEntry = UTILS_LIKELY(descriptorIter != mDescriptorSets.end()) ?
             &descriptorIter.value() : createDescriptorSets();
@@ -158,11 +269,13 @@ bool VulkanPipelineCache::bindDescriptors(VkCommandBuffer cmdbuffer) noexcept {
     // If a descriptor set overflow occurred, allow higher levels to handle it gracefully.
     assert_invariant(cacheEntry != nullptr);
     if (UTILS_UNLIKELY(cacheEntry == nullptr)) {
+        mBoundDescriptorEntry = nullptr;
         return false;
     }
 
     cacheEntry->lastUsed = mCurrentTime;
     mBoundDescriptor = mDescriptorRequirements;
+    mBoundDescriptorEntry = cacheEntry;
 
     vkCmdBindDescriptorSets(cmdbuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
             getOrCreatePipelineLayout()->handle, 0, VulkanPipelineCache::DESCRIPTOR_TYPE_COUNT,
@@ -172,15 +285,18 @@ bool VulkanPipelineCache::bindDescriptors(VkCommandBuffer cmdbuffer) noexcept {
 }
 
 bool VulkanPipelineCache::bindPipeline(VkCommandBuffer cmdbuffer) noexcept {
-    PipelineMap::iterator pipelineIter = mPipelines.find(mPipelineRequirements);
-
-    // Check if the required pipeline is already bound.
-    if (PipelineEqual equals; UTILS_LIKELY(equals(mBoundPipeline, mPipelineRequirements))) {
-        assert_invariant(pipelineIter != mPipelines.end());
-        pipelineIter.value().lastUsed = mCurrentTime;
+    // Check if the required pipeline is already bound. This is the common case in
+    // draw-call-heavy scenes and it is serviced without hashing or probing the map.
+    if (PipelineEqual equals; UTILS_LIKELY(mBoundPipelineEntry &&
+            equals(mBoundPipeline, mPipelineRequirements))) {
+        mBoundPipelineEntry->lastUsed = mCurrentTime;
         return true;
     }
 
+    // The key is hashed only once per state change; the lookup below reuses the hash.
+    const size_t hash = PipelineHashFn{}(mPipelineRequirements);
+    PipelineMap::iterator pipelineIter = mPipelines.find(mPipelineRequirements, hash);
+
     // If a cached object exists, re-use it, otherwise create a new one.
     PipelineCacheEntry* cacheEntry = UTILS_LIKELY(pipelineIter != mPipelines.end()) ?
             &pipelineIter.value() : createPipeline();
@@ -188,6 +304,7 @@ bool VulkanPipelineCache::bindPipeline(VkCommandBuffer cmdbuffer) noexcept {
     // If an error occurred, allow higher levels to handle it gracefully.
     assert_invariant(cacheEntry != nullptr);
     if (UTILS_UNLIKELY(cacheEntry == nullptr)) {
+        mBoundPipelineEntry = nullptr;
         return false;
     }
 
@@ -195,6 +312,7 @@ bool VulkanPipelineCache::bindPipeline(VkCommandBuffer cmdbuffer) noexcept {
     getOrCreatePipelineLayout()->lastUsed = mCurrentTime;
 
     mBoundPipeline = mPipelineRequirements;
+    mBoundPipelineEntry = cacheEntry;
     mBoundLayout = mLayoutRequirements;
 
     vkCmdBindPipeline(cmdbuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, cacheEntry->handle);
@@ -211,8 +329,9 @@ void VulkanPipelineCache::bindScissor(VkCommandBuffer cmdbuffer, VkRect2D scisso
 VulkanPipelineCache::DescriptorCacheEntry* VulkanPipelineCache::createDescriptorSets() noexcept {
     PipelineLayoutCacheEntry* layoutCacheEntry = getOrCreatePipelineLayout();
 
-    DescriptorCacheEntry& descriptorCacheEntry = mDescriptorSets.emplace(
-            std::make_pair(mDescriptorRequirements, DescriptorCacheEntry {})).first.value();
+    // Note that this is inserted into the cache at the bottom of this method, because a pool
+    // growth clears out the cache, which would invalidate the new entry.
+    DescriptorCacheEntry descriptorCacheEntry = {};
 
     descriptorCacheEntry.pipelineLayout = mLayoutRequirements;
 
@@ -318,7 +437,9 @@ VulkanPipelineCache::DescriptorCacheEntry* VulkanPipelineCache::createDescriptor
         writeInfo.dstBinding = binding;
     }
     vkUpdateDescriptorSets(mDevice, nwrites, writes, 0, nullptr);
-    return &descriptorCacheEntry;
+
+    return &mDescriptorSets.emplace(
+            std::make_pair(mDescriptorRequirements, descriptorCacheEntry)).first.value();
 }
 
 VulkanPipelineCache::PipelineCacheEntry* VulkanPipelineCache::createPipeline() noexcept {
@@ -470,7 +591,7 @@ VulkanPipelineCache::PipelineCacheEntry* VulkanPipelineCache::createPipeline() n
     utils::slog.d << "vkCreateGraphicsPipelines with shaders = ("
             << shaderStages[0].module << ", " << shaderStages[1].module << ")" << utils::io::endl;
     #endif
-    VkResult error = vkCreateGraphicsPipelines(mDevice, VK_NULL_HANDLE, 1, &pipelineCreateInfo,
+    VkResult error = vkCreateGraphicsPipelines(mDevice, mVkPipelineCache, 1, &pipelineCreateInfo,
             VKALLOC, &bundle.handle);
     assert_invariant(error == VK_SUCCESS);
     if (error != VK_SUCCESS) {
@@ -629,6 +750,13 @@ void VulkanPipelineCache::bindInputAttachment(uint32_t bindingIndex,
 }
 
 void VulkanPipelineCache::destroyCache() noexcept {
+    // Give the disk cache a chance to see everything created during this run.
+    saveDiskCache();
+    if (mVkPipelineCache != VK_NULL_HANDLE) {
+        vkDestroyPipelineCache(mDevice, mVkPipelineCache, VKALLOC);
+        mVkPipelineCache = VK_NULL_HANDLE;
+    }
+
     // Symmetric to createLayoutsAndDescriptors.
     destroyLayoutsAndDescriptors();
     for (auto& iter : mPipelines) {
@@ -636,6 +764,7 @@ void VulkanPipelineCache::destroyCache() noexcept {
     }
     mPipelines.clear();
     mBoundPipeline = {};
+    mBoundPipelineEntry = nullptr;
     if (mDummySamplerInfo.sampler) {
         vkDestroySampler(mDevice, mDummySamplerInfo.sampler, VKALLOC);
         mDummySamplerInfo.sampler = VK_NULL_HANDLE;
@@ -653,10 +782,13 @@ void VulkanPipelineCache::onCommandBuffer(const VulkanCommandBuffer& cmdbuffer)
     ++mCurrentTime;
 
     // The Vulkan spec says: "When a command buffer begins recording, all state in that command
-    // buffer is undefined." Therefore we need to clear all bindings at this time.
+    // buffer is undefined." Therefore we need to clear all bindings at this time. The cached
+    // entry pointers must go too, since the eviction loops below can shuffle the maps around.
     mBoundPipeline = {};
     mBoundLayout = {};
     mBoundDescriptor = {};
+    mBoundPipelineEntry = nullptr;
+    mBoundDescriptorEntry = nullptr;
     mCurrentScissor = {};
 
     // NOTE: Due to robin_map restrictions, we cannot use auto or range-based loops.
@@ -788,6 +920,7 @@ void VulkanPipelineCache::destroyLayoutsAndDescriptors() noexcept {
     mExtinctDescriptorBundles.clear();
 
     mBoundDescriptor = {};
+    mBoundDescriptorEntry = nullptr;
 }
 
 void VulkanPipelineCache::growDescriptorPool() noexcept {
@@ -814,6 +947,10 @@ void VulkanPipelineCache::growDescriptorPool() noexcept {
         mExtinctDescriptorBundles.push_back(iter.value());
     }
     mDescriptorSets.clear();
+
+    // The currently bound descriptors just went extinct with everything else.
+    mBoundDescriptor = {};
+    mBoundDescriptorEntry = nullptr;
 }
 
 size_t VulkanPipelineCache::PipelineLayoutKeyHashFn::operator()(const PipelineLayoutKey& key) const {
@@ -29,6 +29,7 @@
 #include <utils/Hash.h>
 
 #include <tsl/robin_map.h>
+#include <string>
 #include <type_traits>
 #include <vector>
 
@@ -133,6 +134,13 @@ public:
     ~VulkanPipelineCache();
     void setDevice(VkDevice device, VmaAllocator allocator);
 
+    // Loads a VkPipelineCache blob previously written by this cache from the given directory,
+    // and arranges for the blob to be written back when the cache is destroyed. The blob's
+    // header is validated against the physical device, so entries produced by a different GPU
+    // or driver version are simply discarded. An empty directory disables persistence.
+    void setCacheDirectory(utils::CString directory,
+            VkPhysicalDeviceProperties const& properties) noexcept;
+
     // Clients should initialize their copy of the raster state using this method. They can then
     // mutate their copy and pass it back through bindRasterState().
     const RasterState& getDefaultRasterState() const { return mDefaultRasterState; }
@@ -347,6 +355,8 @@ private:
     void destroyLayoutsAndDescriptors() noexcept;
     VkDescriptorPool createDescriptorPool(uint32_t size) const;
     void growDescriptorPool() noexcept;
+    std::string getDiskCachePath() const noexcept;
+    void saveDiskCache() noexcept;
 
     // Immutable state.
     VkDevice mDevice = VK_NULL_HANDLE;
@@ -363,6 +373,19 @@ private:
     PipelineKey mBoundPipeline = {};
     DescriptorKey mBoundDescriptor = {};
 
+    // Cache entries for the currently bound pipeline and descriptor sets. These allow the
+    // per-draw fast path to refresh the entries' timestamps without hashing the large keys
+    // and probing the maps. They are only dereferenced while the bound keys above match the
+    // requirements, and must be reset whenever the maps are mutated from the outside.
+    PipelineCacheEntry* mBoundPipelineEntry = nullptr;
+    DescriptorCacheEntry* mBoundDescriptorEntry = nullptr;
+
+    // The Vulkan pipeline cache gives the driver a chance to reuse baked pipeline state
+    // across similar pipelines; it is also what gets serialized to disk when a cache
+    // directory has been provided. See setCacheDirectory().
+    VkPipelineCache mVkPipelineCache = VK_NULL_HANDLE;
+    utils::CString mCacheDirectory;
+
     // Current state for scissoring.
     VkRect2D mCurrentScissor = {};
 
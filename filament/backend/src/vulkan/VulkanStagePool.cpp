@@ -44,13 +44,19 @@ VulkanStage const* VulkanStagePool::acquireStage(uint32_t numBytes) {
         .lastAccessed = mCurrentFrame,
     });
 
-    // Create the VkBuffer.
+    // Create the VkBuffer. Staging buffers are recycled between the graphics queue and the
+    // dedicated transfer queue (when one exists), so they are shared between both families.
     mUsedStages.insert(stage);
     VkBufferCreateInfo bufferInfo {
         .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
         .size = numBytes,
         .usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
     };
+    if (mContext.sharedQueueFamilyCount > 1) {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = mContext.sharedQueueFamilyCount;
+        bufferInfo.pQueueFamilyIndices = mContext.sharedQueueFamilies;
+    }
     VmaAllocationCreateInfo allocInfo { .pool = mContext.vmaPoolCPU };
     vmaCreateBuffer(mContext.allocator, &bufferInfo, &allocInfo, &stage->buffer, &stage->memory,
             nullptr);
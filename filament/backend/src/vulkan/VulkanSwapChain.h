@@ -59,6 +59,11 @@ struct VulkanSwapChain : public HwSwapChain {
 
     bool suboptimal = false;
     bool firstRenderPass = false;
+
+    // Damage hint consumed by the next present, in surface coordinates (top-left origin).
+    // See VulkanDriver::setPresentFrameDamage.
+    VkRectLayerKHR pendingDamage = {};
+    bool hasPendingDamage = false;
 };
 
 } // namespace filament
@@ -31,7 +31,8 @@ namespace backend {
 
 VulkanTexture::VulkanTexture(VulkanContext& context, SamplerType target, uint8_t levels,
         TextureFormat tformat, uint8_t samples, uint32_t w, uint32_t h, uint32_t depth,
-        TextureUsage tusage, VulkanStagePool& stagePool, VkComponentMapping swizzle) :
+        TextureUsage tusage, VulkanStagePool& stagePool, VkComponentMapping swizzle,
+        bool transient) :
         HwTexture(target, levels, samples, w, h, depth, tformat, tusage),
 
         // Vulkan does not support 24-bit depth, use the official fallback format.
@@ -113,6 +114,29 @@ VulkanTexture::VulkanTexture(VulkanContext& context, SamplerType target, uint8_t
         }
     }
 
+    // Transient attachments exist only within the render passes that write them, so they are
+    // restricted to attachment usage. This allows them to be backed by lazily-allocated memory
+    // below, which on tiled GPUs keeps their contents entirely on-tile and may avoid the
+    // main-memory allocation altogether.
+    if (transient) {
+        imageInfo.usage &= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+        imageInfo.usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    }
+
+    // Route uploads for non-attachment textures through the dedicated transfer queue when one
+    // exists, which requires sharing the image between the two queue families. Attachments stay
+    // exclusive to the graphics queue: CONCURRENT sharing can disable framebuffer compression
+    // on some hardware, and attachments are never streamed anyway.
+    if (context.sharedQueueFamilyCount > 1 &&
+            !any(usage & (TextureUsage::COLOR_ATTACHMENT | TextureUsage::DEPTH_ATTACHMENT |
+                    TextureUsage::STENCIL_ATTACHMENT))) {
+        imageInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        imageInfo.queueFamilyIndexCount = context.sharedQueueFamilyCount;
+        imageInfo.pQueueFamilyIndices = context.sharedQueueFamilies;
+        mUploadsUseTransferQueue = true;
+    }
+
     // Constrain the sample count according to the sample count masks in VkPhysicalDeviceProperties.
     // Note that VulkanRenderTarget holds a single MSAA count, so we play it safe if this is used as
     // any kind of attachment (color or depth).
@@ -142,18 +166,37 @@ VulkanTexture::VulkanTexture(VulkanContext& context, SamplerType target, uint8_t
     }
     ASSERT_POSTCONDITION(!error, "Unable to create image.");
 
-    // Allocate memory for the VkImage and bind it.
-    VkMemoryRequirements memReqs = {};
-    vkGetImageMemoryRequirements(context.device, mTextureImage, &memReqs);
-    VkMemoryAllocateInfo allocInfo = {
-        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize = memReqs.size,
-        .memoryTypeIndex = context.selectMemoryType(memReqs.memoryTypeBits,
-                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
-    };
-    error = vkAllocateMemory(context.device, &allocInfo, nullptr, &mTextureImageMemory);
-    ASSERT_POSTCONDITION(!error, "Unable to allocate image memory.");
-    error = vkBindImageMemory(context.device, mTextureImage, mTextureImageMemory, 0);
+    // Transient attachments prefer a lazily-allocated memory type, which the driver commits
+    // only if the attachment ever needs to be spilled to main memory. Not every device exposes
+    // such a memory type, so fall through to the regular path when the allocation fails.
+    bool allocated = false;
+    if (transient) {
+        const VmaAllocationCreateInfo lazyInfo = { .usage = VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED };
+        allocated = vmaAllocateMemoryForImage(context.allocator, mTextureImage, &lazyInfo,
+                &mTextureImageMemory, nullptr) == VK_SUCCESS;
+    }
+
+    // Allocate memory for the VkImage from the pool matching its lifetime class and bind it.
+    // Attachments live in their own pool so that their frequent recreation (e.g. on resize)
+    // does not fragment the pool holding long-lived sampleable textures. See VulkanContext.
+    if (!allocated) {
+        const VmaAllocationCreateInfo allocInfo = {
+            .pool = any(usage & (TextureUsage::COLOR_ATTACHMENT | TextureUsage::DEPTH_ATTACHMENT)) ?
+                    context.vmaPoolAttachments : context.vmaPoolImages,
+        };
+        error = vmaAllocateMemoryForImage(context.allocator, mTextureImage, &allocInfo,
+                &mTextureImageMemory, nullptr);
+        if (error) {
+            // The image's memory type bits do not match the pool's memory type (this can happen
+            // with exotic formats, e.g. lazily allocated or depth-only memory types), so fall back
+            // to a dedicated allocation.
+            const VmaAllocationCreateInfo fallbackInfo = { .usage = VMA_MEMORY_USAGE_GPU_ONLY };
+            error = vmaAllocateMemoryForImage(context.allocator, mTextureImage, &fallbackInfo,
+                    &mTextureImageMemory, nullptr);
+        }
+        ASSERT_POSTCONDITION(!error, "Unable to allocate image memory.");
+    }
+    error = vmaBindImageMemory(context.allocator, mTextureImageMemory, mTextureImage);
     ASSERT_POSTCONDITION(!error, "Unable to bind image.");
 
     // Spec out the "primary" VkImageView that shaders use to sample from the image.
@@ -189,7 +232,7 @@ VulkanTexture::VulkanTexture(VulkanContext& context, SamplerType target, uint8_t
 VulkanTexture::~VulkanTexture() {
     delete mSidecarMSAA;
     vkDestroyImage(mContext.device, mTextureImage, VKALLOC);
-    vkFreeMemory(mContext.device, mTextureImageMemory, VKALLOC);
+    vmaFreeMemory(mContext.allocator, mTextureImageMemory);
     for (auto entry : mCachedImageViews) {
         vkDestroyImageView(mContext.device, entry.second, VKALLOC);
     }
@@ -226,7 +269,8 @@ void VulkanTexture::updateImage(const PixelBufferDescriptor& data, uint32_t widt
     vmaUnmapMemory(mContext.allocator, stage->memory);
     vmaFlushAllocation(mContext.allocator, stage->memory, 0, hostData->size);
 
-    const VkCommandBuffer cmdbuffer = mContext.commands->get().cmdbuffer;
+    const VkCommandBuffer cmdbuffer = mUploadsUseTransferQueue ?
+            mContext.transferCommands->get().cmdbuffer : mContext.commands->get().cmdbuffer;
 
     VkBufferImageCopy copyRegion = {
         .bufferOffset = {},
@@ -265,7 +309,11 @@ void VulkanTexture::updateImage(const PixelBufferDescriptor& data, uint32_t widt
     vkCmdCopyBufferToImage(cmdbuffer, stage->buffer, mTextureImage,
             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
 
-    transitionLayout(cmdbuffer, transitionRange, getDefaultImageLayout(usage));
+    if (mUploadsUseTransferQueue) {
+        transitionLayoutForUploadQueue(cmdbuffer, transitionRange, getDefaultImageLayout(usage));
+    } else {
+        transitionLayout(cmdbuffer, transitionRange, getDefaultImageLayout(usage));
+    }
 }
 
 void VulkanTexture::updateImageWithBlit(const PixelBufferDescriptor& hostData, uint32_t width,
@@ -278,6 +326,8 @@ void VulkanTexture::updateImageWithBlit(const PixelBufferDescriptor& hostData, u
     vmaUnmapMemory(mContext.allocator, stage->memory);
     vmaFlushAllocation(mContext.allocator, stage->memory, 0, hostData.size);
 
+    // vkCmdBlitImage is not supported on transfer-only queues, so format-converting uploads
+    // stay on the graphics queue even when a dedicated transfer queue exists.
     const VkCommandBuffer cmdbuffer = mContext.commands->get().cmdbuffer;
 
     // TODO: support blit-based format conversion for 3D images and cubemaps.
@@ -322,7 +372,8 @@ void VulkanTexture::updateCubeImage(const PixelBufferDescriptor& data,
     vmaUnmapMemory(mContext.allocator, stage->memory);
     vmaFlushAllocation(mContext.allocator, stage->memory, 0, numDstBytes);
 
-    const VkCommandBuffer cmdbuffer = mContext.commands->get().cmdbuffer;
+    const VkCommandBuffer cmdbuffer = mUploadsUseTransferQueue ?
+            mContext.transferCommands->get().cmdbuffer : mContext.commands->get().cmdbuffer;
     const uint32_t width = std::max(1u, this->width >> miplevel);
     const uint32_t height = std::max(1u, this->height >> miplevel);
 
@@ -345,7 +396,11 @@ void VulkanTexture::updateCubeImage(const PixelBufferDescriptor& data,
     vkCmdCopyBufferToImage(cmdbuffer, stage->buffer, mTextureImage,
             VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 6, regions);
 
-    transitionLayout(cmdbuffer, range, textureLayout);
+    if (mUploadsUseTransferQueue) {
+        transitionLayoutForUploadQueue(cmdbuffer, range, textureLayout);
+    } else {
+        transitionLayout(cmdbuffer, range, textureLayout);
+    }
 }
 
 void VulkanTexture::setPrimaryRange(uint32_t minMiplevel, uint32_t maxMiplevel) {
@@ -428,6 +483,32 @@ void VulkanTexture::transitionLayout(VkCommandBuffer commands, const VkImageSubr
             .subresources = range,
     }));
 
+    trackLayout(range, newLayout);
+}
+
+void VulkanTexture::transitionLayoutForUploadQueue(VkCommandBuffer commands,
+        const VkImageSubresourceRange& range, VkImageLayout newLayout) {
+    const VkImageLayout oldLayout = getVkLayout(range.baseArrayLayer, range.baseMipLevel);
+
+    // The stage masks that textureTransitionHelper produces target shader stages, which are
+    // not valid on a transfer-only queue. The release half of a barrier is sufficient here:
+    // availability and visibility on the graphics queue come from the timeline-semaphore
+    // handoff in VulkanCommands, which orders entire submissions across the two queues.
+    transitionImageLayout(commands, {
+            .image = mTextureImage,
+            .oldLayout = oldLayout,
+            .newLayout = newLayout,
+            .subresources = range,
+            .srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT,
+            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstStage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            .dstAccessMask = 0,
+    });
+
+    trackLayout(range, newLayout);
+}
+
+void VulkanTexture::trackLayout(const VkImageSubresourceRange& range, VkImageLayout newLayout) {
     const uint32_t first_layer = range.baseArrayLayer;
     const uint32_t last_layer = first_layer + range.layerCount;
     const uint32_t first_level = range.baseMipLevel;
@@ -27,9 +27,15 @@ namespace filament {
 namespace backend {
 
 struct VulkanTexture : public HwTexture {
+    // Setting "transient" restricts the image to attachment usage and backs it with
+    // lazily-allocated memory when the device has such a memory type; use it only for
+    // attachments whose contents never leave the render passes that write them (e.g. the
+    // MSAA sidecars created by VulkanRenderTarget). Transient textures cannot be sampled,
+    // uploaded to, or blitted.
     VulkanTexture(VulkanContext& context, SamplerType target, uint8_t levels,
             TextureFormat format, uint8_t samples, uint32_t w, uint32_t h, uint32_t depth,
-            TextureUsage usage, VulkanStagePool& stagePool, VkComponentMapping swizzle = {});
+            TextureUsage usage, VulkanStagePool& stagePool, VkComponentMapping swizzle = {},
+            bool transient = false);
     ~VulkanTexture();
 
     // Uploads data into a subregion of a 2D or 3D texture.
@@ -68,13 +74,23 @@ private:
     void updateImageWithBlit(const PixelBufferDescriptor& hostData, uint32_t width,
         uint32_t height, uint32_t depth, uint32_t miplevel);
 
+    // Same as transitionLayout, but uses only transfer-safe pipeline stages so that it can be
+    // recorded on the dedicated transfer queue, where shader stages are not valid barrier
+    // targets. Visibility to the graphics queue is provided by the timeline-semaphore handoff
+    // in VulkanCommands.
+    void transitionLayoutForUploadQueue(VkCommandBuffer commands,
+            const VkImageSubresourceRange& range, VkImageLayout newLayout);
+
+    // Records the layout of each subresource in the given range into mSubresourceLayouts.
+    void trackLayout(const VkImageSubresourceRange& range, VkImageLayout newLayout);
+
     VulkanTexture* mSidecarMSAA = nullptr;
     const VkFormat mVkFormat;
     const VkImageAspectFlags mAspect;
     const VkImageViewType mViewType;
     const VkComponentMapping mSwizzle;
     VkImage mTextureImage = VK_NULL_HANDLE;
-    VkDeviceMemory mTextureImageMemory = VK_NULL_HANDLE;
+    VmaAllocation mTextureImageMemory = VK_NULL_HANDLE;
 
     // Track the image layout of each subresource using a sparse range map.
     utils::RangeMap<uint32_t, VkImageLayout> mSubresourceLayouts;
@@ -84,6 +100,11 @@ private:
     VkImageSubresourceRange mPrimaryViewRange;
 
     std::map<VkImageSubresourceRange, VkImageView> mCachedImageViews;
+
+    // True when the image was created with CONCURRENT sharing across the graphics and transfer
+    // queue families, in which case uploads are recorded on the dedicated transfer queue.
+    bool mUploadsUseTransferQueue = false;
+
     VulkanContext& mContext;
     VulkanStagePool& mStagePool;
 };
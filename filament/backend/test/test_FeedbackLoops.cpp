@@ -208,7 +208,7 @@ TEST_F(BackendTest, FeedbackLoops) {
                     .sourceLevel = float(sourceLevel),
                 });
                 api.beginRenderPass(renderTargets[targetLevel], params);
-                api.draw(state, triangle.getRenderPrimitive());
+                api.draw(state, triangle.getRenderPrimitive(), 1);
                 api.endRenderPass();
             }
 
@@ -227,7 +227,7 @@ TEST_F(BackendTest, FeedbackLoops) {
                     .sourceLevel = float(sourceLevel),
                 });
                 api.beginRenderPass(renderTargets[targetLevel], params);
-                api.draw(state, triangle.getRenderPrimitive());
+                api.draw(state, triangle.getRenderPrimitive(), 1);
                 api.endRenderPass();
             }
 
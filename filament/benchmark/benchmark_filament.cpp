@@ -28,6 +28,8 @@
 #include <vector>
 #include <random>
 
+#include <stdlib.h>
+
 using namespace filament;
 using namespace filament::math;
 using namespace utils;
@@ -103,3 +105,53 @@ BENCHMARK_F(FilamentFixture, sphereCulling)(benchmark::State& state) {
         state.SetItemsProcessed(state.iterations() * BATCH_SIZE);
     }
 }
+
+/*
+ * Replays a culling capture recorded from a live application (run it with
+ * FILAMENT_CULLING_CAPTURE=<path> set, see Culler.h), so culling changes are
+ * validated against the spatial clustering of real scenes rather than the
+ * synthetic random boxes above. The same variable selects the capture to replay:
+ *
+ *   FILAMENT_CULLING_CAPTURE=scene.cull benchmark_filament
+ */
+class CaptureFixture : public benchmark::Fixture {
+protected:
+    Frustum frustum{};
+    std::vector<float3> boxesCenter;
+    std::vector<float3> boxesExtent;
+    Culler::result_type* UTILS_RESTRICT visibles = nullptr;
+    size_t count = 0;
+
+public:
+    CaptureFixture() {
+        const char* const path = getenv("FILAMENT_CULLING_CAPTURE");
+        if (path && Culler::loadCapture(path, &frustum, &boxesCenter, &boxesExtent)) {
+            // Culler processes multiple-of-MODULO batches, pad with empty boxes
+            count = Culler::round(boxesCenter.size());
+            boxesCenter.resize(count, float3{});
+            boxesExtent.resize(count, float3{});
+            visibles = (Culler::result_type*)utils::aligned_alloc(count * sizeof(*visibles), 32);
+        }
+    }
+
+    ~CaptureFixture() override {
+        utils::aligned_free(visibles);
+    }
+};
+
+BENCHMARK_F(CaptureFixture, captureBoxCulling)(benchmark::State& state) {
+    if (count == 0) {
+        state.SkipWithError("no capture, set FILAMENT_CULLING_CAPTURE to a capture file");
+        return;
+    }
+    {
+        PerformanceCounters pc(state);
+        for (auto _ : state) {
+            Culler::Test::intersects(visibles, frustum,
+                    boxesCenter.data(), boxesExtent.data(), count);
+        }
+        benchmark::ClobberMemory();
+        pc.stop();
+        state.SetItemsProcessed(state.iterations() * count);
+    }
+}
@@ -0,0 +1,239 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <filament/Box.h>
+#include <filament/Camera.h>
+#include <filament/Engine.h>
+#include <filament/IndexBuffer.h>
+#include <filament/LightManager.h>
+#include <filament/RenderableManager.h>
+#include <filament/Renderer.h>
+#include <filament/Scene.h>
+#include <filament/SwapChain.h>
+#include <filament/TransformManager.h>
+#include <filament/VertexBuffer.h>
+#include <filament/View.h>
+#include <filament/Viewport.h>
+
+#include <utils/EntityManager.h>
+
+#include <math/mat4.h>
+#include <math/norm.h>
+
+#include <random>
+#include <vector>
+
+using namespace filament;
+using namespace filament::math;
+using namespace utils;
+
+/*
+ * End-to-end frame benchmark running the whole CPU frame pipeline
+ * (prepare / cull / froxelize / generate commands / sort / execute) against the
+ * no-op backend, so only the engine's CPU cost is measured. Scenes are generated
+ * programmatically from the benchmark arguments:
+ *
+ *   Args({ renderables, lights, shadow casters })
+ *
+ * The individual stages aren't timed separately -- they run inside
+ * FRenderer::renderJob and overlap on the job system -- but each stage's cost
+ * can be isolated by differencing configurations: emptyScene is the fixed
+ * per-frame overhead, renderables-only adds prepare/cull/commands/sort,
+ * adding lights brings in froxelization, and shadow casters add the
+ * shadow map passes. For a finer breakdown, use systrace on a device build.
+ */
+class RendererFixture : public benchmark::Fixture {
+protected:
+    static constexpr uint32_t VIEWPORT_SIZE = 1024;
+
+    Engine* mEngine = nullptr;
+    SwapChain* mSwapChain = nullptr;
+    Renderer* mRenderer = nullptr;
+    Scene* mScene = nullptr;
+    View* mView = nullptr;
+    Camera* mCamera = nullptr;
+    Entity mCameraEntity;
+
+    VertexBuffer* mVertexBuffer = nullptr;
+    IndexBuffer* mIndexBuffer = nullptr;
+    std::vector<Entity> mEntities;
+
+public:
+    void SetUp(benchmark::State& state) override {
+        mEngine = Engine::create(Engine::Backend::NOOP);
+        mSwapChain = mEngine->createSwapChain(VIEWPORT_SIZE, VIEWPORT_SIZE);
+        mRenderer = mEngine->createRenderer();
+        mScene = mEngine->createScene();
+
+        mCameraEntity = EntityManager::get().create();
+        mCamera = mEngine->createCamera(mCameraEntity);
+        mCamera->setProjection(45.0, 1.0, 0.1, 1000.0, Camera::Fov::VERTICAL);
+        mCamera->lookAt({ 0, 0, 120 }, { 0, 0, 0 }, { 0, 1, 0 });
+
+        mView = mEngine->createView();
+        mView->setViewport({ 0, 0, VIEWPORT_SIZE, VIEWPORT_SIZE });
+        mView->setScene(mScene);
+        mView->setCamera(mCamera);
+        // we're measuring the frame pipeline, not the post-process chain
+        mView->setPostProcessingEnabled(false);
+
+        buildScene(size_t(state.range(0)), size_t(state.range(1)), size_t(state.range(2)));
+    }
+
+    void TearDown(benchmark::State&) override {
+        for (Entity e : mEntities) {
+            mEngine->destroy(e);
+            EntityManager::get().destroy(e);
+        }
+        mEntities.clear();
+        mEngine->destroy(mVertexBuffer);
+        mEngine->destroy(mIndexBuffer);
+        mEngine->destroy(mView);
+        mEngine->destroy(mScene);
+        mEngine->destroy(mRenderer);
+        mEngine->destroy(mSwapChain);
+        mEngine->destroyCameraComponent(mCameraEntity);
+        EntityManager::get().destroy(mCameraEntity);
+        Engine::destroy(&mEngine);
+    }
+
+protected:
+    void buildScene(size_t renderableCount, size_t lightCount, size_t shadowCasterCount) {
+        // all renderables share one unit cube, we're measuring engine overhead,
+        // not vertex data processing
+        static const float3 vertices[8] = {
+                { -1, -1, -1 }, { 1, -1, -1 }, { -1, 1, -1 }, { 1, 1, -1 },
+                { -1, -1,  1 }, { 1, -1,  1 }, { -1, 1,  1 }, { 1, 1,  1 },
+        };
+        static const short4 tangents[8] = {
+                packTbnFrame(), packTbnFrame(), packTbnFrame(), packTbnFrame(),
+                packTbnFrame(), packTbnFrame(), packTbnFrame(), packTbnFrame(),
+        };
+        static const uint16_t indices[36] = {
+                0, 1, 3,  0, 3, 2,      // -z
+                5, 4, 6,  5, 6, 7,      // +z
+                4, 0, 2,  4, 2, 6,      // -x
+                1, 5, 7,  1, 7, 3,      // +x
+                4, 5, 1,  4, 1, 0,      // -y
+                2, 3, 7,  2, 7, 6,      // +y
+        };
+
+        mVertexBuffer = VertexBuffer::Builder()
+                .bufferCount(2)
+                .vertexCount(8)
+                .attribute(VertexAttribute::POSITION, 0, VertexBuffer::AttributeType::FLOAT3)
+                .attribute(VertexAttribute::TANGENTS, 1, VertexBuffer::AttributeType::SHORT4)
+                .normalized(VertexAttribute::TANGENTS)
+                .build(*mEngine);
+        mVertexBuffer->setBufferAt(*mEngine, 0, { vertices, sizeof(vertices) });
+        mVertexBuffer->setBufferAt(*mEngine, 1, { tangents, sizeof(tangents) });
+
+        mIndexBuffer = IndexBuffer::Builder()
+                .indexCount(36)
+                .bufferType(IndexBuffer::IndexType::USHORT)
+                .build(*mEngine);
+        mIndexBuffer->setBuffer(*mEngine, { indices, sizeof(indices) });
+
+        std::default_random_engine gen; // NOLINT
+        std::uniform_real_distribution<float> rand(-100.0f, 100.0f);
+
+        auto& em = EntityManager::get();
+        auto& tcm = mEngine->getTransformManager();
+
+        // scatter the renderables in a slab in front of the camera, so a realistic
+        // fraction of them is culled. Renderables beyond shadowCasterCount don't
+        // cast shadows; they still go through the shadow casters' culling.
+        for (size_t i = 0; i < renderableCount; i++) {
+            Entity e = em.create();
+            // renderables without a material instance use the engine's default material
+            RenderableManager::Builder(1)
+                    .boundingBox({{ 0, 0, 0 }, { 1, 1, 1 }})
+                    .geometry(0, RenderableManager::PrimitiveType::TRIANGLES,
+                            mVertexBuffer, mIndexBuffer)
+                    .castShadows(i < shadowCasterCount)
+                    .receiveShadows(true)
+                    .build(*mEngine, e);
+            tcm.create(e, {}, mat4f::translation(float3{ rand(gen), rand(gen), rand(gen) }));
+            mScene->addEntity(e);
+            mEntities.push_back(e);
+        }
+
+        // point lights, plus one shadow-casting directional light when the scene
+        // has shadow casters (this is what enables the shadow map passes)
+        for (size_t i = 0; i < lightCount; i++) {
+            Entity e = em.create();
+            LightManager::Builder(LightManager::Type::POINT)
+                    .position({ rand(gen), rand(gen), rand(gen) })
+                    .intensity(10000.0f)
+                    .falloff(10.0f)
+                    .build(*mEngine, e);
+            mScene->addEntity(e);
+            mEntities.push_back(e);
+        }
+
+        if (shadowCasterCount > 0) {
+            Entity e = em.create();
+            LightManager::Builder(LightManager::Type::SUN)
+                    .direction(normalize(float3{ 0.5f, -1.0f, 0.25f }))
+                    .intensity(100000.0f)
+                    .castShadows(true)
+                    .build(*mEngine, e);
+            mScene->addEntity(e);
+            mEntities.push_back(e);
+        }
+    }
+
+    void renderFrame() {
+        if (mRenderer->beginFrame(mSwapChain)) {
+            mRenderer->render(mView);
+            mRenderer->endFrame();
+        }
+    }
+
+private:
+    // identity tbn frame, packed the way filament expects TANGENTS
+    static short4 packTbnFrame() noexcept {
+        return packSnorm16(quatf{ 1, 0, 0, 0 }.xyzw);
+    }
+};
+
+BENCHMARK_DEFINE_F(RendererFixture, renderFrame)(benchmark::State& state) {
+    for (auto _ : state) {
+        renderFrame();
+    }
+    // make sure the driver thread consumed everything we measured
+    mEngine->flushAndWait();
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// baseline: fixed per-frame overhead (beginFrame / framegraph / endFrame)
+BENCHMARK_REGISTER_F(RendererFixture, renderFrame)->Args({ 0, 0, 0 });
+
+// prepare / cull / generateCommands / sort scaling with the number of renderables
+BENCHMARK_REGISTER_F(RendererFixture, renderFrame)->Args({ 64, 0, 0 });
+BENCHMARK_REGISTER_F(RendererFixture, renderFrame)->Args({ 512, 0, 0 });
+BENCHMARK_REGISTER_F(RendererFixture, renderFrame)->Args({ 2048, 0, 0 });
+BENCHMARK_REGISTER_F(RendererFixture, renderFrame)->Args({ 8192, 0, 0 });
+
+// froxelization scaling with the number of lights
+BENCHMARK_REGISTER_F(RendererFixture, renderFrame)->Args({ 512, 64, 0 });
+BENCHMARK_REGISTER_F(RendererFixture, renderFrame)->Args({ 512, 255, 0 });
+
+// shadow map passes (cascades culling + per-cascade command generation)
+BENCHMARK_REGISTER_F(RendererFixture, renderFrame)->Args({ 512, 0, 128 });
+BENCHMARK_REGISTER_F(RendererFixture, renderFrame)->Args({ 2048, 64, 512 });
@@ -51,6 +51,7 @@ class UTILS_PUBLIC BufferObject : public FilamentAPI {
 public:
     using BufferDescriptor = backend::BufferDescriptor;
     using BindingType = backend::BufferObjectBinding;
+    using BufferUsage = backend::BufferUsage;
 
     class Builder : public BuilderBase<BuilderDetails> {
         friend struct BuilderDetails;
@@ -76,6 +77,18 @@ public:
          */
         Builder& bindingType(BindingType bindingType) noexcept;
 
+        /**
+         * How the content of this buffer will be updated. (defaults to STATIC)
+         *
+         * This is a hint that lets the backend pick its allocation and orphaning strategy:
+         * use STREAM for content rewritten every frame (see setBufferStreaming), DYNAMIC
+         * for occasional updates, STATIC for content set once.
+         *
+         * @param usage Expected update frequency of the buffer content.
+         * @return A reference to this Builder for chaining calls.
+         */
+        Builder& usage(BufferUsage usage) noexcept;
+
         /**
          * Creates the BufferObject and returns a pointer to it. After creation, the buffer
          * object is uninitialized. Use BufferObject::setBuffer() to initialize it.
@@ -105,6 +118,29 @@ public:
      */
     void setBuffer(Engine& engine, BufferDescriptor&& buffer, uint32_t byteOffset = 0);
 
+    /**
+     * Schedules an update of a region of this BufferObject and returns a pointer for the
+     * caller to write the new content into, avoiding the intermediate copy that setBuffer()
+     * requires.
+     *
+     * The returned memory belongs to the engine's command stream: the caller writes into it
+     * directly, the data is consumed when the frame's commands execute, and the memory is
+     * reclaimed automatically afterwards. The pointer is valid for writing only until the
+     * next call to Renderer::render() or Engine::flush().
+     *
+     * Exactly the [byteOffset, byteOffset + byteCount) range is updated, so per-frame
+     * writes never touch -- or stall on -- the rest of the buffer. Together with
+     * Builder::usage(BufferUsage::STREAM), which lets the backend rename the buffer
+     * storage instead of synchronizing with frames in flight, this is the preferred path
+     * for content rewritten every frame, such as particles or debug-line geometry.
+     *
+     * @param engine Reference to the filament::Engine associated with this BufferObject.
+     * @param byteCount Number of bytes that will be written.
+     * @param byteOffset Offset in bytes into the BufferObject.
+     * @return Pointer to byteCount bytes of write-only staging memory.
+     */
+    void* setBufferStreaming(Engine& engine, uint32_t byteCount, uint32_t byteOffset = 0);
+
     /**
      * Returns the size of this BufferObject in elements.
      * @return The maximum capacity of the BufferObject.
@@ -17,6 +17,7 @@
 #ifndef TNT_FILAMENT_ENGINE_H
 #define TNT_FILAMENT_ENGINE_H
 
+#include <backend/PixelBufferDescriptor.h>
 #include <backend/Platform.h>
 
 #include <utils/compiler.h>
@@ -72,6 +73,11 @@ class TransformManager;
  * Engine essentially represents (or is associated to) a hardware context
  * (e.g. an OpenGL ES context).
  *
+ * Several Engines can coexist in the same process, e.g. for server-side batch rendering.
+ * Each Engine owns its own backend context, driver thread and resources -- nothing is shared
+ * between them and the GPU is arbitrated by the OS driver -- and each must be used from a
+ * single thread, which can be a different thread per Engine (see samples/renderfarm.cpp).
+ *
  * Rendering typically happens in an operating system's window (which can be full screen), such
  * window is managed by a filament.Renderer.
  *
@@ -446,6 +452,22 @@ public:
     bool destroy(const View* p);                //!< Destroys a View object.
     void destroy(utils::Entity e);              //!< Destroys all filament-known components from this entity
 
+    /**
+     * Destroys all filament-known components from a batch of entities, amortized over
+     * several frames.
+     *
+     * The entities are queued immediately and their components are then removed in slices
+     * under the Engine's per-frame deferred work budget (see setDeferredWorkBudget()),
+     * instead of paying for every per-entity removal up front -- useful when unloading a
+     * large group of objects at once. Remove the entities from their Scene first; their
+     * components stay live until their slice is processed, typically within a few frames,
+     * and the entities must not receive new components until then.
+     *
+     * @param n        number of entities in the batch
+     * @param entities array of n entities whose components are to be destroyed
+     */
+    void destroyAsync(size_t n, const utils::Entity* entities);
+
     /**
      * Kicks the hardware thread (e.g. the OpenGL, Vulkan or Metal thread) and blocks until
      * all commands to this point are executed. Note that does guarantee that the
@@ -458,6 +480,47 @@ public:
      */
     void flushAndWait();
 
+    /**
+     * An opaque synchronization token returned by insertToken().
+     *
+     * Tokens are signaled in the order they were inserted; the value 0 is always signaled.
+     */
+    using SyncToken = uint64_t;
+
+    /**
+     * Inserts a synchronization token in the command stream.
+     *
+     * The token is signaled once the hardware thread (e.g. the OpenGL, Vulkan or Metal thread)
+     * has executed all commands issued before it. Unlike flushAndWait(), waiting on a token only
+     * waits for the work issued before the token was inserted -- typically the uploads of a
+     * set of assets -- without draining the whole pipeline, so rendering of subsequent frames
+     * isn't serialized with the wait.
+     *
+     * @return a SyncToken that can be passed to isTokenSignaled() or waitForToken()
+     * @see isTokenSignaled(), waitForToken()
+     */
+    SyncToken insertToken();
+
+    /**
+     * Queries whether a SyncToken has been signaled. Never blocks.
+     *
+     * @param token a SyncToken returned by insertToken()
+     * @return true if the hardware thread has executed all commands issued before \p token
+     * @see insertToken()
+     */
+    bool isTokenSignaled(SyncToken token) const noexcept;
+
+    /**
+     * Blocks the current thread until the given SyncToken is signaled.
+     *
+     * The command stream is flushed first, so it is safe to call this from the thread that
+     * inserted the token.
+     *
+     * @param token a SyncToken returned by insertToken()
+     * @see insertToken()
+     */
+    void waitForToken(SyncToken token);
+
     /**
      * Kicks the hardware thread (e.g. the OpenGL, Vulkan or Metal thread) but does not wait
      * for commands to be either executed or the hardware finished.
@@ -477,6 +540,275 @@ public:
      */
     void pumpMessageQueues();
 
+    /**
+     * Sets the directory where the backend may persist compiled shader programs between
+     * runs of the application, so that subsequent cold starts can skip most of the
+     * driver's shader compilation work. The OpenGL backend persists program binaries
+     * (<code>glProgramBinary</code>) and the Vulkan backend persists its
+     * <code>VkPipelineCache</code>; other backends silently ignore it.
+     *
+     * <p>The directory must exist and be writable by the application. Entries are
+     * automatically invalidated when the GPU driver changes. Call this once, right after
+     * creating the engine and before loading any Material. Passing <code>nullptr</code>
+     * or an empty path disables the cache.</p>
+     *
+     * @param path Absolute path to the application's cache directory, or nullptr.
+     */
+    void setProgramBinaryCacheDirectory(const char* path) noexcept;
+
+    /**
+     * Returns the usage statistics of the driver's handle arena: the current and
+     * high-water handle counts of each size-class pool, plus those of the heap overflow
+     * map that is used -- slowly, with a lock -- once a pool is exhausted. Useful to
+     * size the handle arena so the overflow path is never hit. The counters are not
+     * synchronized with the threads allocating handles, so the values are approximate.
+     */
+    backend::HandleAllocatorStats getHandleAllocatorStats() noexcept;
+
+    /**
+     * Estimated memory held by the Engine, in bytes, broken down by category.
+     *
+     * The values are CPU-side estimates of the GPU allocations, computed from the objects'
+     * descriptors (dimensions, formats, counts); actual driver allocations can differ due
+     * to alignment, padding or internal copies. External and streamed textures are not
+     * counted because their storage is not owned by filament.
+     *
+     * @see getMemoryStats(), setMemoryBudget()
+     */
+    struct MemoryStats {
+        size_t textures;        //!< Texture objects created by the application
+        size_t buffers;         //!< vertex, index and generic buffer objects
+        size_t renderTargets;   //!< transient render-target storage (frame graph textures)
+        size_t commandArenas;   //!< command stream and per-render-pass arena capacity
+        size_t total;           //!< sum of the categories above
+
+        /**
+         * Device memory reserved by the backend's internal allocation pools, as reported by
+         * the backend itself (currently only the Vulkan backend reports this; other backends
+         * report 0). Unlike the estimates above this is an exact figure, and it is larger
+         * than the sum of the live resources because pools retain whole blocks. It is not
+         * included in total, which remains the sum of the estimates.
+         */
+        size_t backendPools;
+    };
+
+    /**
+     * Returns an estimate of the memory currently held by this Engine.
+     *
+     * This walks all live resources, so it is not free; call it at most once per frame.
+     * Must be called from the Engine's main thread.
+     *
+     * @return the current MemoryStats.
+     */
+    MemoryStats getMemoryStats() const noexcept;
+
+    /**
+     * Callback invoked when the memory budget set with setMemoryBudget() is exceeded.
+     * Called from the Engine's main thread during Renderer::endFrame().
+     *
+     * @param user  the user pointer given to setMemoryBudget()
+     * @param stats the MemoryStats that exceeded the budget
+     */
+    using MemoryBudgetCallback = void (*)(void* user, MemoryStats const& stats);
+
+    /**
+     * Sets a soft memory budget for this Engine.
+     *
+     * Once per frame the Engine compares getMemoryStats().total against the budget and
+     * invokes the callback when it is exceeded, so the application can reduce quality
+     * (texture resolution, dynamic resolution, shadow sizes...) before the OS takes
+     * action. The callback fires once when the budget is crossed and is re-armed when
+     * usage drops below 90% of the budget.
+     *
+     * @param budget   budget in bytes, or 0 to disable monitoring.
+     * @param callback callback to invoke when the budget is exceeded, or nullptr.
+     * @param user     arbitrary pointer passed back to the callback.
+     */
+    void setMemoryBudget(size_t budget, MemoryBudgetCallback callback, void* user) noexcept;
+
+    /**
+     * Sets the per-frame watermark for deferred resource destruction.
+     *
+     * By default destroy() releases an object's GPU resources immediately, and the driver
+     * thread executes the corresponding deallocations interleaved with rendering -- a bulk
+     * unload (e.g. thousands of destroys when a streamed world chunk is evicted) can then
+     * cause a visible hitch. When a watermark is set, destroyed Texture, VertexBuffer,
+     * IndexBuffer, BufferObject, SkinningBuffer and MorphTargetBuffer objects accumulate
+     * into a garbage list instead, reclaimed in bulk after each frame is presented, at
+     * most `watermark` objects per frame, spreading the cost over several frames.
+     *
+     * Deferred objects keep their CPU and GPU memory until they are reclaimed; all other
+     * object types are still destroyed immediately. Pending garbage is fully reclaimed
+     * when the Engine is shut down.
+     *
+     * @param watermark maximum number of objects reclaimed per frame, or 0 to destroy
+     *                  immediately (the default).
+     */
+    void setDestroyReclaimWatermark(size_t watermark) noexcept;
+
+    /**
+     * @return the watermark set with setDestroyReclaimWatermark(), 0 by default.
+     */
+    size_t getDestroyReclaimWatermark() const noexcept;
+
+    /**
+     * Sets the per-frame CPU budget of the Engine's deferred work queue, in microseconds.
+     *
+     * Bursty internal tasks -- for instance the per-variant shader program builds issued
+     * by Material::prewarm() -- are queued and drained on the main thread at the end of
+     * each frame, oldest first, until the budget is exhausted, so they amortize over
+     * several frames instead of spiking one. At least one task runs per frame so the
+     * queue always makes progress.
+     *
+     * @param budgetMicroseconds budget per frame in microseconds, 1000 (1ms) by default.
+     */
+    void setDeferredWorkBudget(uint32_t budgetMicroseconds) noexcept;
+
+    /**
+     * @return the budget set with setDeferredWorkBudget().
+     */
+    uint32_t getDeferredWorkBudget() const noexcept;
+
+    /**
+     * Callback invoked when the thermal quality governor changes its reduction step.
+     * Called from the Engine's main thread.
+     *
+     * @param user      the user pointer given to setThermalGovernorEnabled()
+     * @param reduction the new reduction step, 0 (full quality) to 3
+     */
+    using ThermalQualityCallback = void (*)(void* user, uint8_t reduction);
+
+    /**
+     * Enables or disables the thermal quality governor. Disabled by default.
+     *
+     * When enabled, the Engine polls the platform's thermal status (Android's thermal
+     * API; a no-op elsewhere) and derives a quality reduction step from it. Expensive
+     * internal knobs consult the step automatically: shadow maps are rendered at half
+     * resolution per step, and bloom reduces its resolution and blur levels. Quality is
+     * stepped down as soon as the device reports a worse thermal status, and stepped
+     * back up only after the improvement is sustained, to avoid oscillating around a
+     * thermal threshold.
+     *
+     * The callback is invoked on each step change so the application can scale down its
+     * own workload as well (resolution, effects, simulation rate...).
+     *
+     * @param enabled  true to enable the governor.
+     * @param callback callback to invoke on step changes, or nullptr.
+     * @param user     arbitrary pointer passed back to the callback.
+     */
+    void setThermalGovernorEnabled(bool enabled, ThermalQualityCallback callback = nullptr,
+            void* user = nullptr) noexcept;
+
+    //! Returns whether the thermal quality governor is enabled.
+    bool isThermalGovernorEnabled() const noexcept;
+
+    /**
+     * Returns the governor's current quality reduction step, 0 (full quality) to 3.
+     * Always 0 while the governor is disabled.
+     */
+    uint8_t getThermalQualityReduction() const noexcept;
+
+    /**
+     * An opaque id referencing a material parameter animation track, see
+     * addParameterTrack(). 0 is never a valid track.
+     */
+    using ParameterTrack = uint32_t;
+
+    /**
+     * Registers an engine-side animation track for a material parameter.
+     *
+     * A track binds a float parameter (1 to 4 components) of a MaterialInstance to a
+     * piecewise-linear keyframe curve. All registered tracks are evaluated in bulk
+     * once per frame, at the time set with setParameterTrackTime(), and the results
+     * are written directly into each instance's uniform storage before it is
+     * committed. Driving emissive ramps, UV scrolls and similar animations this way
+     * replaces one setParameter() call per parameter per frame with a single
+     * setParameterTrackTime() call.
+     *
+     * The keyframes are copied. Outside the keyframe range the curve clamps to its
+     * end values; with looping enabled the evaluation time wraps at the last
+     * keyframe's time instead. Tracks targeting an instance are removed automatically
+     * when the instance is destroyed.
+     *
+     * @param instance       instance whose parameter is animated. Cannot be nullptr.
+     * @param name           name of a float, float2, float3 or float4 parameter as
+     *                       defined by the instance's Material.
+     * @param times          keyframe times in seconds, sorted ascending.
+     * @param values         keyframe values, componentCount floats per keyframe,
+     *                       tightly packed.
+     * @param keyframeCount  number of keyframes, at least 1.
+     * @param componentCount number of components of the parameter, 1 to 4.
+     * @param loop           whether the evaluation time wraps at the last keyframe.
+     * @return a track id usable with removeParameterTrack(), or 0 if the parameter
+     *         doesn't exist or the track is malformed.
+     */
+    ParameterTrack addParameterTrack(MaterialInstance* instance, const char* name,
+            float const* times, float const* values, size_t keyframeCount,
+            size_t componentCount, bool loop = false) noexcept;
+
+    /**
+     * Removes a track registered with addParameterTrack(); the parameter keeps its
+     * last evaluated value. Invalid ids are ignored.
+     */
+    void removeParameterTrack(ParameterTrack track) noexcept;
+
+    /**
+     * Sets the time at which all parameter tracks are evaluated, typically once per
+     * frame with the application's animation clock.
+     *
+     * @param time animation time in seconds.
+     */
+    void setParameterTrackTime(double time) noexcept;
+
+    /**
+     * Sets a per-frame byte budget for texture uploads.
+     *
+     * When set, Texture::setImage() calls whose cumulative size exceeds the budget are
+     * deferred and issued in later frames, spreading transfer work over time. This
+     * avoids a frame spike when e.g. a streaming system finishes loading many textures
+     * at once. Deferred uploads are issued by priority class
+     * (see Texture::setUploadPriority()), oldest first within a class; at least one
+     * upload is issued per frame so the queue always drains.
+     *
+     * @param bytesPerFrame upload budget in bytes per frame, 0 (the default) disables
+     *                      the budget and issues all uploads immediately.
+     */
+    void setTextureUploadBudget(uint32_t bytesPerFrame) noexcept;
+
+    /**
+     * @return the budget set with setTextureUploadBudget().
+     */
+    uint32_t getTextureUploadBudget() const noexcept;
+
+    /**
+     * Creates a PixelBufferDescriptor whose memory comes from the engine's recycling
+     * staging pool.
+     *
+     * The returned descriptor behaves like any other PixelBufferDescriptor and can be
+     * passed to e.g. Texture::setImage(). Once the engine has consumed the data, the
+     * memory automatically returns to the pool instead of being freed, so paths that
+     * upload multi-megabyte buffers every frame -- video, texture streaming -- stop
+     * hitting the system allocator. The buffer content is uninitialized.
+     *
+     * @param size      Size in bytes of the pixel buffer
+     * @param format    Format of the image pixels
+     * @param type      Type of the image pixels
+     * @param alignment Alignment in bytes of pixel rows
+     * @return A PixelBufferDescriptor backed by the staging pool
+     */
+    backend::PixelBufferDescriptor createStagingPixelBuffer(size_t size,
+            backend::PixelDataFormat format, backend::PixelDataType type,
+            uint8_t alignment = 1) noexcept;
+
+    /**
+     * Sets the maximum amount of memory the staging pool retains for reuse. Memory
+     * released while the pool is at capacity is freed immediately. The default is
+     * 64 MiB; 0 disables recycling.
+     *
+     * @param bytes staging pool capacity in bytes.
+     */
+    void setStagingBufferPoolCapacity(size_t bytes) noexcept;
+
     /**
      * Returns the default Material.
      *
@@ -530,6 +862,43 @@ public:
      */
     void* streamAlloc(size_t size, size_t alignment = alignof(double)) noexcept;
 
+    /**
+     * Allocate a buffer from the engine's upload staging pool. This is intended for large,
+     * frequent uploads -- typically video frames passed to Texture::setImage() -- where the
+     * producer (e.g. a decoder) can write directly into the returned memory, which the backend
+     * then consumes in place without any additional copy on the Filament side.
+     *
+     * The returned memory is cache-line aligned and owned by the caller until it is released
+     * with releaseStagingMemory(), usually by passing releaseStagingMemory as the
+     * buffer descriptor's release callback with this Engine as the callback user:
+     *
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+     * void* buffer = engine->allocateStagingMemory(size);
+     * decodeFrameInto(buffer);
+     * texture->setImage(*engine, 0, Texture::PixelBufferDescriptor(
+     *         buffer, size, Texture::Format::RGBA, Texture::Type::UBYTE,
+     *         &Engine::releaseStagingMemory, engine));
+     * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+     *
+     * Released buffers are recycled by subsequent allocations of the same (or smaller) size,
+     * so a steady-state stream of uploads performs no allocation at all.
+     *
+     * @param size size to allocate in bytes
+     * @return a pointer to the allocated buffer, or nullptr if size is zero
+     */
+    void* allocateStagingMemory(size_t size) noexcept;
+
+    /**
+     * Releases a buffer obtained from allocateStagingMemory() back to the staging pool.
+     * This function matches backend::BufferDescriptor::Callback so it can be used directly
+     * as a buffer descriptor's release callback.
+     *
+     * @param buffer buffer returned by allocateStagingMemory()
+     * @param size   size of the buffer in bytes
+     * @param user   the Engine the buffer was allocated from
+     */
+    static void releaseStagingMemory(void* buffer, size_t size, void* user);
+
     /**
       * Invokes one iteration of the render loop, used only on single-threaded platforms.
       *
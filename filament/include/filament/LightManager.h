@@ -297,8 +297,8 @@ public:
         /**
          * Number of ray-marching steps for screen-space contact shadows (8 by default).
          *
-         * CAUTION: this parameter is ignored for all lights except the directional/sun light,
-         *          all other lights use the same value set for the directional/sun light.
+         * CAUTION: this parameter is shared by all lights; the largest value among the
+         *          lights that enable screen-space contact shadows is used.
          *
          */
         uint8_t stepCount = 8;
@@ -307,8 +307,8 @@ public:
          * Maximum shadow-occluder distance for screen-space contact shadows (world units).
          * (30 cm by default)
          *
-         * CAUTION: this parameter is ignored for all lights except the directional/sun light,
-         *          all other lights use the same value set for the directional/sun light.
+         * CAUTION: this parameter is shared by all lights; the largest value among the
+         *          lights that enable screen-space contact shadows is used.
          *
          */
         float maxShadowDistance = 0.3f;
@@ -133,6 +133,20 @@ public:
      */
     MaterialInstance* createInstance(const char* name = nullptr) const noexcept;
 
+    /**
+     * Compiles the programs for this material's shader variants ahead of time.
+     *
+     * By default a variant's program is compiled the first time it is needed for rendering,
+     * which can cause noticeable hitches when e.g. a shadow or fog variant first appears on
+     * screen. prewarm() issues the compilation of every variant this material supports through
+     * the engine's command stream, so the work happens asynchronously on the backend thread --
+     * typically during a loading screen.
+     *
+     * This call returns immediately; use Fence or Engine::flushAndWait() to wait for the
+     * compilations to complete.
+     */
+    void prewarm() noexcept;
+
     //! Returns the name of this material as a null-terminated string.
     const char* getName() const noexcept;
 
@@ -30,6 +30,8 @@
 
 namespace filament {
 
+class FMaterialInstance;
+
 class Material;
 class Texture;
 class TextureSampler;
@@ -106,6 +108,68 @@ public:
     template<typename T, typename = is_supported_parameter_t<T>>
     void setParameter(const char* name, const T* values, size_t count) noexcept;
 
+    /**
+     * An opaque token referencing a uniform parameter, resolved once with
+     * getParameterHandle().
+     *
+     * Using a handle skips the name lookup that setParameter(const char*, ...) performs
+     * on every call, which matters when animating many parameters on many instances
+     * per frame. A handle depends only on the parent Material's uniform layout, so it
+     * can be shared by all instances of that Material.
+     */
+    class ParameterHandle {
+    public:
+        ParameterHandle() noexcept = default;
+
+        //! Whether this handle refers to an existing uniform parameter.
+        bool isValid() const noexcept { return mOffset >= 0; }
+
+    private:
+        friend class FMaterialInstance;
+        friend class MaterialInstance;
+        int32_t mOffset = -1;
+    };
+
+    /**
+     * Resolves a uniform parameter name to a handle usable with
+     * setParameter(ParameterHandle, ...).
+     *
+     * @param name  Name of the parameter as defined by Material. Cannot be nullptr.
+     * @return      A handle for the named parameter, or an invalid handle if the name
+     *              does not refer to a uniform parameter (samplers are not supported).
+     */
+    ParameterHandle getParameterHandle(const char* name) const noexcept;
+
+    /**
+     * Set a uniform by handle; the hot-path equivalent of setParameter(const char*, ...).
+     *
+     * No type checking is performed: the value type must match the type the parameter
+     * was declared with. Invalid handles are ignored.
+     *
+     * @param handle    Handle returned by getParameterHandle().
+     * @param value     Value of the parameter to set.
+     */
+    template<typename T, typename = is_supported_parameter_t<T>>
+    void setParameter(ParameterHandle handle, T const& value) noexcept;
+
+    /**
+     * Copies a block of raw parameter values in a single operation.
+     *
+     * The data must be laid out exactly as the corresponding parameters are declared in
+     * the material, including the alignment and padding dictated by uniform block rules;
+     * this layout is fixed when the material is parsed. The destination range is checked
+     * against the declared block size, and out-of-range writes are ignored.
+     *
+     * This is intended for updating many parameters on many instances per frame: a
+     * struct mirroring the declared layout can be blitted with one call instead of one
+     * name lookup per parameter.
+     *
+     * @param first     Handle of the first parameter covered by the block.
+     * @param data      Parameter values, laid out as declared in the material.
+     * @param size      Size of the block in bytes.
+     */
+    void setParameters(ParameterHandle first, const void* data, size_t size) noexcept;
+
     /**
      * Set a texture as the named parameter
      *
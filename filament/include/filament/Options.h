@@ -266,6 +266,15 @@ struct AmbientOcclusionOptions {
     bool enabled = false;    //!< enables or disables screen-space ambient occlusion
     bool bentNormals = false; //!< enables bent normals computation from AO, and specular AO
     float minHorizonAngleRad = 0.0f;  //!< min angle in radian to consider
+
+    /**
+     * Temporal amortization: the AO buffer is recomputed only one frame in updateInterval
+     * and reused as-is in between, taking most of the AO cost off the steady-state frame
+     * (AO is perceptually tolerant to this). The reused buffer is not reprojected, so
+     * intervals above 3 or 4 can show stale occlusion during fast camera motion.
+     * 0 or 1 (the default) recomputes every frame.
+     */
+    uint8_t updateInterval = 1;
     /**
      * Screen Space Cone Tracing (SSCT) options
      * Ambient shadows from dominant light
@@ -314,6 +323,31 @@ struct TemporalAntiAliasingOptions {
     float filterWidth = 1.0f;   //!< reconstruction filter width typically between 0 (sharper, aliased) and 1 (smoother)
     float feedback = 0.04f;     //!< history feedback, between 0 (maximum temporal AA) and 1 (no temporal AA).
     bool enabled = false;       //!< enables or disables temporal anti-aliasing
+
+    /**
+     * Stores the TAA history in R11G11B10 instead of the hdr color buffer format, halving the
+     * history bandwidth. Slightly increases flickering on very bright highlights. Ignored when
+     * the pipeline needs an alpha channel.
+     */
+    bool reducedHistoryPrecision = false;
+};
+
+/**
+ * Options for automatic exposure metering.
+ *
+ * The average scene luminance of the color pass is metered on the GPU and adapted over time;
+ * the adapted value is read back asynchronously and exposed through
+ * View::getAdaptedLuminance(), so no pipeline stall is incurred.
+ *
+ * @see setAutoExposureOptions()
+ */
+struct AutoExposureOptions {
+    /**
+     * Per-frame blend weight toward the metered luminance, between 0 (frozen) and
+     * 1 (instant adaptation).
+     */
+    float adaptationRate = 0.05f;
+    bool enabled = false;       //!< enables or disables auto-exposure metering
 };
 
 /**
@@ -356,6 +390,24 @@ enum class ShadowType : uint8_t {
     PCSS        //!< PCF with soft shadows and contact hardening
 };
 
+/**
+ * View-level options for scheduling shadow map updates.
+ *
+ * The most distant shadow cascades can be refreshed at a reduced rate: the last
+ * deferredCascades cascades are re-rendered only every interval frames, staggered so
+ * that at most one of them is refreshed on any given frame. Between refreshes a
+ * deferred cascade keeps its previous light-space frustum and content, trading a
+ * small distant-shadow latency for GPU time. This works best together with
+ * LightManager::ShadowOptions::stable, which snaps the shadow frustum to texel
+ * boundaries and prevents shadow swimming when a cascade is eventually refreshed.
+ *
+ * @see setShadowUpdateOptions()
+ */
+struct ShadowUpdateOptions {
+    uint8_t deferredCascades = 0;   //!< number of distant cascades updated at a reduced rate
+    uint8_t interval = 4;           //!< refresh period of the deferred cascades, in frames
+};
+
 /**
  * View-level options for VSM Shadowing.
  * @see setVsmShadowOptions()
@@ -134,6 +134,25 @@ public:
          */
         Builder& layer(AttachmentPoint attachment, uint32_t layer) noexcept;
 
+        /**
+         * Sets the sample count for MSAA rendering into this RenderTarget.
+         *
+         * When a value greater than 1 is specified, the backend allocates internal multisample
+         * buffers for the attachments and resolves them into the attached textures when the
+         * render pass ends. On tile-based GPUs this resolve happens on-store, as part of writing
+         * the tile back to memory (EXT_multisampled_render_to_texture on OpenGL ES,
+         * pResolveAttachments on Vulkan, storeAndMultisampleResolve on Metal), and is
+         * effectively free -- no separate resolve blit is issued.
+         *
+         * The attached textures themselves stay single-sampled and can be used as regular
+         * sampleable textures afterwards.
+         *
+         * @param samples Sample count. 0 or 1 disables MSAA. Values are clamped by the backend
+         *                to its supported maximum.
+         * @return A reference to this Builder for chaining calls.
+         */
+        Builder& samples(uint8_t samples) noexcept;
+
         /**
          * Creates the RenderTarget object and returns a pointer to it.
          *
@@ -182,6 +201,12 @@ public:
      * @return Number of color attachments usable in a render target.
      */
     uint8_t getSupportedColorAttachmentsCount() const noexcept;
+
+    /**
+     * Returns the sample count of this render target.
+     * @return The sample count set with Builder::samples(), at least 1.
+     */
+    uint8_t getSamples() const noexcept;
 };
 
 } // namespace filament
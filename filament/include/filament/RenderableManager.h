@@ -158,6 +158,50 @@ public:
         Builder& geometry(size_t index, PrimitiveType type, VertexBuffer* vertices, IndexBuffer* indices, size_t offset, size_t count) noexcept; //!< \overload
         Builder& geometry(size_t index, PrimitiveType type, VertexBuffer* vertices, IndexBuffer* indices) noexcept; //!< \overload
 
+        /**
+         * Declares a level of detail (LOD) over a contiguous range of this renderable's
+         * primitives.
+         *
+         * Each level covers the primitives [offset, offset + count), and level 0 must be the
+         * most detailed one. Every frame, each View picks the level to render based on the
+         * screen coverage of the renderable's bounding sphere: a level is used as long as the
+         * coverage is at least \p minScreenCoverage, otherwise the next (coarser) level is
+         * tried; the last declared level is never dropped. Renderables that don't declare any
+         * level always render all their primitives.
+         *
+         * @param level zero-based level of detail, must be less than 4 and declared in order
+         * @param offset index of the first primitive of this level
+         * @param count number of primitives in this level
+         * @param minScreenCoverage smallest fraction of the viewport height the bounding
+         *                          sphere may cover before the next level is selected;
+         *                          ignored for the last level
+         */
+        Builder& lod(uint8_t level, size_t offset, size_t count,
+                float minScreenCoverage) noexcept;
+
+        /**
+         * Specifies an object-space bounding cone for a primitive, enabling cluster backface
+         * culling: when every triangle of the primitive faces away from the camera, the
+         * primitive is skipped entirely during command generation, saving its vertex shading.
+         *
+         * The cone is typically precomputed offline (e.g. by filamesh, which uses
+         * meshoptimizer's cluster bounds): \p axis is the average facing direction of the
+         * primitive's triangles and the primitive is culled when
+         * dot(center - camera, axis) >= cutoff * |center - camera| + radius.
+         * A \p cutoff of 1.0 or more disables the test (the default).
+         *
+         * Only primitives whose triangles all share a similar facing benefit from this; it is
+         * most useful when a mesh is split into many small clusters.
+         *
+         * @param index zero-based index of the primitive, must be less than the count passed to Builder constructor
+         * @param center object-space center of the primitive's bounding sphere
+         * @param radius radius of the primitive's bounding sphere
+         * @param axis unit-length average facing direction of the primitive's triangles
+         * @param cutoff cone cutoff as computed by meshoptimizer (sin of the cone half-angle)
+         */
+        Builder& boundingCone(size_t index, math::float3 center, float radius,
+                math::float3 axis, float cutoff) noexcept;
+
         /**
          * Binds a material instance to the specified primitive.
          *
@@ -251,6 +295,21 @@ public:
          */
         Builder& screenSpaceContactShadows(bool enable) noexcept;
 
+        /**
+         * Marks this renderable as an occluder for software occlusion culling
+         * (off by default).
+         *
+         * During View preparation the world-space bounding box of each occluder is
+         * rasterized into a small conservative depth buffer, and renderables entirely
+         * hidden behind the occluders are culled before draw commands are generated.
+         * Because only the bounding box is considered -- never the actual geometry --
+         * this should be enabled only on renderables whose bounding box is mostly solid
+         * and opaque (e.g.: walls, buildings or terrain chunks). Alternatively, a
+         * dedicated proxy renderable placed on an invisible layer can be used as a
+         * pure occlusion volume.
+         */
+        Builder& occluder(bool enable) noexcept;
+
         /**
          * Allows bones to be swapped out and shared using SkinningBuffer.
          *
@@ -362,6 +421,11 @@ public:
             MaterialInstance const* materialInstance = nullptr;
             PrimitiveType type = PrimitiveType::TRIANGLES;
             uint16_t blendOrder = 0;
+            // bounding cone for cluster backface culling, see Builder::boundingCone()
+            math::float3 coneCenter = {};
+            float coneRadius = 0.0f;
+            math::float3 coneAxis = {};
+            float coneCutoff = 1.0f;    // >= 1 disables the cone test
         };
     };
 
@@ -438,6 +502,14 @@ public:
      */
     void setScreenSpaceContactShadows(Instance instance, bool enable) noexcept;
 
+    /**
+     * Changes whether or not the renderable acts as an occluder for software
+     * occlusion culling.
+     *
+     * \see Builder::occluder()
+     */
+    void setOccluder(Instance instance, bool enable) noexcept;
+
     /**
      * Checks if the renderable can cast shadows.
      *
@@ -452,6 +524,13 @@ public:
      */
     bool isShadowReceiver(Instance instance) const noexcept;
 
+    /**
+     * Checks if the renderable is an occluder for software occlusion culling.
+     *
+     * \see Builder::occluder().
+     */
+    bool isOccluder(Instance instance) const noexcept;
+
     /**
      * Updates the bone transforms in the range [offset, offset + boneCount).
      * The bones must be pre-allocated using Builder::skinning().
@@ -465,6 +544,55 @@ public:
     void setSkinningBuffer(Instance instance, SkinningBuffer* skinningBuffer,
             size_t count, size_t offset);
 
+    /**
+     * Attaches this renderable to a joint of another renderable's skin.
+     *
+     * While attached, the world transform used for rendering is sampled from the target's
+     * bone palette at render time:
+     *
+     *     world = target world transform * bone transform * this renderable's transform
+     *
+     * where the bone transform is the same model-space matrix last passed to setBones() for
+     * the given joint (i.e. it includes the inverse bind pose), and this renderable's own
+     * TransformManager transform acts as a local offset from the joint. The transform
+     * hierarchy is bypassed entirely, so props attached to skeleton joints follow the
+     * animation without any transform nodes to update each tick -- there is no need to
+     * parent the prop to the skeleton.
+     *
+     * The target must have skinning enabled and own its bone data, that is it must not use
+     * skinning buffer mode (see Builder::enableSkinningBuffers()). If the target is
+     * destroyed, the attached renderable falls back to its TransformManager world transform.
+     *
+     * @param instance Instance of the component obtained from getInstance().
+     * @param target Entity owning the skinned renderable to follow, or the null entity
+     *               to detach.
+     * @param boneIndex Index of the joint in the target's bone palette.
+     */
+    void setBoneAttachment(Instance instance, utils::Entity target, size_t boneIndex);
+
+    /**
+     * Enables or disables posed bounds for a skinned renderable. Disabled by default.
+     *
+     * The bounding box of a skinned renderable normally has to be inflated by the
+     * application to conservatively cover every possible pose, which hurts culling
+     * efficiency. With posed bounds enabled, the box set with
+     * setAxisAlignedBoundingBox() (or Builder::boundingBox()) is treated as the
+     * rest-pose bounds, and each setBones() call re-derives the current bounds as the
+     * union of the rest-pose box transformed by every bone of the palette. The
+     * recomputation is deferred and runs in parallel on the JobSystem when the scene is
+     * prepared, so enabling this on hundreds of characters doesn't serialize on the
+     * animation thread.
+     *
+     * The renderable must have skinning enabled and own its bone data, that is it must
+     * not use skinning buffer mode (see Builder::enableSkinningBuffers()). Disabling
+     * posed bounds restores the rest-pose box.
+     *
+     * @param instance Instance of the component obtained from getInstance().
+     * @param enabled true to derive the bounds from the current pose, false to restore
+     *                the application-provided box.
+     */
+    void setPosedBoundsEnabled(Instance instance, bool enabled);
+
     /**
      * Updates the vertex morphing weights on a renderable, all zeroes by default.
      *
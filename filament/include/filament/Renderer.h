@@ -28,6 +28,7 @@
 
 #include <math/vec4.h>
 
+#include <stddef.h>
 #include <stdint.h>
 
 namespace filament {
@@ -135,6 +136,133 @@ public:
         bool discard = true;
     };
 
+    /**
+     * FramePacingOptions control when beginFrame() returns, to trade throughput for input
+     * latency. In LOW_LATENCY mode, beginFrame() blocks until the GPU has finished the
+     * previous frame, so the input sampled right after beginFrame() is consumed by the very
+     * next frame presented -- this minimizes motion-to-photon latency at the cost of CPU/GPU
+     * parallelism. The measured latency is available with getMeasuredFrameLatencyNanos().
+     *
+     * @see setFramePacingOptions()
+     */
+    struct FramePacingOptions {
+        enum class Mode : uint8_t {
+            DEFAULT,        //!< beginFrame() never blocks on the GPU
+            LOW_LATENCY     //!< beginFrame() waits for the previous frame's GPU work
+        };
+        Mode mode = Mode::DEFAULT;
+        /**
+         * Upper bound on how long beginFrame() may block in LOW_LATENCY mode, in
+         * milliseconds. 0 means wait until the GPU has caught up. If the GPU can't catch up
+         * within this budget, beginFrame() stops waiting -- the latency target can't be met
+         * for that frame anyway.
+         */
+        float targetLatencyMilliseconds = 0.0f;
+        /**
+         * When enabled, frames are skipped proactively based on a model of the GPU frame
+         * cost (an exponential moving average of the measured GPU frame time): if the model
+         * predicts that each frame needs N refresh periods, beginFrame() returns false on
+         * all but every Nth vsync, so presents settle on a steady divisor cadence instead
+         * of juddering whenever the GPU happens to fall behind. The default skipper only
+         * reacts after a frame has already missed.
+         */
+        bool predictiveSkipping = false;
+    };
+
+    /**
+     * Frame skipping statistics, see getFrameSkipStats().
+     */
+    struct SkipStats {
+        uint32_t totalFrames = 0;       //!< number of beginFrame() calls
+        uint32_t skippedFrames = 0;     //!< frames skipped, for any reason
+        uint32_t predictedSkips = 0;    //!< frames skipped proactively by the load model
+        //! current estimate of the GPU frame cost, in milliseconds
+        float predictedGpuFrameTimeMilliseconds = 0.0f;
+    };
+
+    /**
+     * GPU timing information for a single render pass, aggregated over the last frames.
+     * All times are in milliseconds.
+     *
+     * @see getPassTimings()
+     */
+    struct PassTiming {
+        static constexpr size_t MAX_NAME_LENGTH = 31;
+        char name[MAX_NAME_LENGTH + 1];  //!< pass name, null terminated, possibly truncated
+        uint32_t samples;                //!< number of frames aggregated in the values below
+        float last;                      //!< GPU time of the most recent frame
+        float median;                    //!< median GPU time
+        float p95;                       //!< 95th percentile GPU time
+        float max;                       //!< worst GPU time observed
+    };
+
+    /**
+     * Enables or disables per-pass GPU profiling. Disabled by default.
+     *
+     * When enabled, each FrameGraph pass (shadows, color, bloom, etc...) is bracketed with
+     * GPU timer queries and its timing history becomes available from getPassTimings().
+     *
+     * @note
+     * Timer queries cannot nest on some backends (OpenGL), so while pass profiling is
+     * enabled the whole-frame GPU timer is paused and dynamic resolution holds its
+     * current scale factor.
+     *
+     * @param enabled true to enable per-pass GPU profiling.
+     */
+    void setPassProfilingEnabled(bool enabled) noexcept;
+
+    //! Returns whether per-pass GPU profiling is enabled. See setPassProfilingEnabled().
+    bool isPassProfilingEnabled() const noexcept;
+
+    /**
+     * Retrieves the per-pass GPU timings recorded since pass profiling was enabled.
+     *
+     * Timer query results arrive a few frames after the commands are submitted, so the
+     * values trail the rendered frames by the backend's frame latency.
+     *
+     * @param timings Client-side array receiving one entry per instrumented pass.
+     * @param count   Capacity of the timings array.
+     * @return The number of entries written, at most count.
+     */
+    size_t getPassTimings(PassTiming* timings, size_t count) const noexcept;
+
+    /**
+     * CPU timestamps of the phases of one frame, in nanoseconds on the same
+     * std::chrono::steady_clock timebase as vsyncSteadyClockTimeNano in beginFrame().
+     * A timestamp of 0 means the corresponding phase didn't occur this frame.
+     *
+     * @see setFrameTimingsCallback()
+     */
+    struct FrameTimings {
+        uint32_t frameId;                //!< frame id, as counted by beginFrame()
+        uint64_t beginFrameNanos;        //!< beginFrame() was called
+        uint64_t prepareStartNanos;      //!< the first view started preparing scene data
+        uint64_t prepareEndNanos;        //!< the last view finished preparing scene data
+        uint64_t commandsGeneratedNanos; //!< all driver commands have been generated
+        uint64_t driverFlushedNanos;     //!< the command buffer was handed to the driver thread
+        uint64_t presentQueuedNanos;     //!< the swap-chain commit was queued
+        uint64_t endFrameNanos;          //!< endFrame() is about to return
+    };
+
+    /**
+     * Callback delivering the phase timestamps of the frame that just ended, along with the
+     * per-pass GPU timing table (empty unless pass profiling is enabled, see
+     * setPassProfilingEnabled()). The pointers are only valid for the duration of the call.
+     */
+    using FrameTimingsCallback = void(*)(void* user, FrameTimings const& timings,
+            PassTiming const* passes, size_t passCount);
+
+    /**
+     * Sets a callback invoked synchronously at the end of each endFrame(), on the thread
+     * that called it, giving profiling integrations structured frame timing without
+     * polling. Pass nullptr to remove the callback. Keep the callback cheap: it runs on
+     * the rendering critical path.
+     *
+     * @param callback the callback to invoke every frame, or nullptr
+     * @param user arbitrary pointer handed back to the callback
+     */
+    void setFrameTimingsCallback(FrameTimingsCallback callback, void* user) noexcept;
+
     /**
      * Information about the display this Renderer is associated to. This information is needed
      * to accurately compute dynamic-resolution scaling and for frame-pacing.
@@ -152,6 +280,48 @@ public:
      */
     void setClearOptions(const ClearOptions& options);
 
+    /**
+     * Set options controlling frame pacing and input latency.
+     *
+     * Takes effect on the next beginFrame().
+     */
+    void setFramePacingOptions(FramePacingOptions const& options) noexcept;
+
+    /**
+     * Returns the last measured latency between beginFrame() returning -- i.e. the point
+     * where the application typically samples its input -- and the GPU finishing the
+     * corresponding frame, in nanoseconds. This is the portion of motion-to-photon latency
+     * under the application's control; the display adds up to one refresh period on top.
+     *
+     * The measurement is exact in FramePacingOptions::Mode::LOW_LATENCY and an upper bound
+     * otherwise. Returns 0 until a first frame has completed.
+     */
+    uint64_t getMeasuredFrameLatencyNanos() const noexcept;
+
+    /**
+     * Returns frame skipping statistics: how many frames were skipped (and how many of
+     * those proactively, see FramePacingOptions::predictiveSkipping), along with the current
+     * GPU frame cost estimate. Counters accumulate for the lifetime of the Renderer.
+     */
+    SkipStats getFrameSkipStats() const noexcept;
+
+    /**
+     * Declares the region of the swap chain that actually changed this frame.
+     *
+     * On mostly-static content (dashboards, viewers at rest), presenting only the damaged
+     * region lets the presentation engine skip recomposing the rest of the screen, saving
+     * power. The hint is forwarded to the backend at the next endFrame() and consumed by it;
+     * frames without a hint present fully. Backends without partial-present support
+     * (or windowing systems without EGL_KHR_swap_buffers_with_damage /
+     * VK_KHR_incremental_present) ignore the hint.
+     *
+     * This is a presentation hint only: the caller must still render the damaged region, and
+     * the content outside it must be unchanged from the previous frame.
+     *
+     * @param damage The changed region, in pixels, with a bottom-left origin.
+     */
+    void setFrameDamage(Viewport const& damage) noexcept;
+
     /**
      * Get the Engine that created this Renderer.
      *
@@ -299,6 +469,31 @@ public:
      */
     void render(View const* view);
 
+    /**
+     * Render several Views into this renderer's window as part of the same frame.
+     *
+     * This is equivalent to calling render() on each View in order, except that the
+     * CPU-side preparation work that doesn't involve the backend (gathering the scenes'
+     * world-space data) is performed concurrently for all Views before any of them is
+     * rendered. With several Views -- e.g. one per viewport or camera -- this overlaps
+     * a significant part of the per-View cost that render() would otherwise serialize.
+     *
+     * Backend commands are generated and submitted in the order the Views appear in the
+     * array, exactly as with individual render() calls.
+     *
+     * Null entries and Views without a Scene are skipped.
+     *
+     * @param views     Pointer to an array of Views to render.
+     * @param viewCount Number of Views in the array.
+     *
+     * @attention
+     * Like render(), this must be called *after* beginFrame() and *before* endFrame(),
+     * and from the Engine's main thread.
+     *
+     * @see render()
+     */
+    void render(View const* const* views, size_t viewCount);
+
     /**
      * Copy the currently rendered view to the indicated swap chain, using the
      * indicated source and destination rectangle.
@@ -99,6 +99,19 @@ public:
      */
     void setIndirectLight(IndirectLight const* ibl) noexcept;
 
+    /**
+     * Set a secondary IndirectLight to blend with the one set by setIndirectLight().
+     *
+     * The spherical harmonics and intensity of the two environments are interpolated on the
+     * CPU each frame and the reflections use whichever environment dominates, so environment
+     * transitions (e.g. time-of-day changes) don't re-decode or re-upload any cubemap.
+     *
+     * @param ibl   The IndirectLight to blend towards, or nullptr to disable blending.
+     * @param blend Blend factor in [0, 1]; 0 selects the IndirectLight set with
+     *              setIndirectLight(), 1 selects \p ibl.
+     */
+    void setIndirectLightBlend(IndirectLight const* ibl, float blend) noexcept;
+
     /**
      * Adds an Entity to the Scene.
      *
@@ -181,9 +181,10 @@ public:
      * Updates an ACQUIRED stream with an image that is guaranteed to be used in the next frame.
      *
      * This method tells Filament to immediately "acquire" the image and trigger a callback
-     * when it is done with it. This should be called by the user outside of beginFrame / endFrame,
-     * and should be called only once per frame. If the user pushes images to the same stream
-     * multiple times in a single frame, only the final image is honored, but all callbacks are
+     * when it is done with it. This should be called by the user outside of beginFrame / endFrame.
+     * The engine keeps a small queue of acquired images (3 deep), so a producer such as a video
+     * decoder may run a few frames ahead of the renderer; each rendered frame consumes the oldest
+     * queued image. If the queue overflows, the oldest image is dropped, but all callbacks are
      * invoked.
      *
      * This method should be called on the same thread that calls Renderer::beginFrame, which is
@@ -79,6 +79,18 @@ public:
     using Usage = backend::TextureUsage;                             //!< Usage affects texel layout
     using Swizzle = backend::TextureSwizzle;                         //!< Texture swizzle
 
+    /**
+     * Priority class of this texture's uploads when a per-frame upload budget is set
+     * with Engine::setTextureUploadBudget().
+     *
+     * @see setUploadPriority()
+     */
+    enum class UploadPriority : uint8_t {
+        HIGH,       //!< uploaded first, e.g. textures of visible objects
+        NORMAL,     //!< default
+        LOW         //!< uploaded last, e.g. textures of distant or occluded objects
+    };
+
     /** @return whether a backend supports a particular format. */
     static bool isTextureFormatSupported(Engine& engine, InternalFormat format) noexcept;
 
@@ -334,7 +346,12 @@ public:
      *            this method will have no effect, otherwise it will behave as if the
      *            texture was specified with Sampler::SAMPLER_2D.
      *
-     * @see Builder::sampler()
+     * @note \p buffer is consumed in place by the backend, with no intermediate copy on the
+     *       Filament side. For large streaming uploads (e.g. video frames), consider writing
+     *       the image directly into memory obtained from Engine::allocateStagingMemory() to
+     *       avoid allocating a fresh buffer for every frame.
+     *
+     * @see Builder::sampler(), Engine::allocateStagingMemory()
      */
     void setImage(Engine& engine, size_t level,
             uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height,
@@ -473,6 +490,39 @@ public:
      */
     void generateMipmaps(Engine& engine) const noexcept;
 
+    /**
+     * Restricts sampling to a range of mip levels.
+     *
+     * This is intended for mip streaming: a texture can be created with its full mip pyramid
+     * but populated only from the coarsest levels up, with sampling clamped to the resident
+     * tail while the finer levels are uploaded. Levels outside the range are never sampled,
+     * so their contents may be undefined.
+     *
+     * Both bounds are clamped to the texture's level count.
+     *
+     * @param engine    Engine this texture is associated to.
+     * @param minLevel  Finest mip level allowed to be sampled.
+     * @param maxLevel  Coarsest mip level allowed to be sampled, must be >= \p minLevel.
+     *
+     * @attention \p engine must be the instance passed to Builder::build()
+     */
+    void setMinMaxLevels(Engine& engine, uint8_t minLevel, uint8_t maxLevel) const noexcept;
+
+    /**
+     * Sets the priority class of this texture's uploads.
+     *
+     * This only matters when a per-frame upload budget is set with
+     * Engine::setTextureUploadBudget(): uploads of over-budget frames are deferred,
+     * higher priority class first. Typically, textures of visible objects should be
+     * HIGH so they resolve before distant ones. Without a budget, uploads are always
+     * issued immediately and the priority has no effect.
+     *
+     * The priority applies to subsequent setImage() calls.
+     *
+     * @param priority  Upload priority class, NORMAL by default.
+     */
+    void setUploadPriority(UploadPriority priority) noexcept;
+
     /**
      * Creates a reflection map from an environment map.
      *
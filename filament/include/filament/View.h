@@ -80,9 +80,11 @@ public:
     using RenderQuality = RenderQuality;
     using AmbientOcclusionOptions = AmbientOcclusionOptions;
     using TemporalAntiAliasingOptions = TemporalAntiAliasingOptions;
+    using AutoExposureOptions = AutoExposureOptions;
     using MultiSampleAntiAliasingOptions = MultiSampleAntiAliasingOptions;
     using VsmShadowOptions = VsmShadowOptions;
     using SoftShadowOptions = SoftShadowOptions;
+    using ShadowUpdateOptions = ShadowUpdateOptions;
     using ScreenSpaceReflectionsOptions = ScreenSpaceReflectionsOptions;
 
     /**
@@ -152,6 +154,21 @@ public:
      */
     RenderTarget* getRenderTarget() const noexcept;
 
+    /**
+     * Forces the next Renderer::render() of this View to actually render.
+     *
+     * A View with an offscreen render target (see setRenderTarget()) is skipped entirely by
+     * Renderer::render() when nothing it renders has changed since the previous frame -- the
+     * render target's attachments still hold the previous, identical, result. The change
+     * detection covers the scene's content (entities, components, transforms), the camera and
+     * the View's settings, but not everything: in particular material parameter changes and
+     * texture or buffer updates are not tracked. Call this method after such a change to
+     * force a re-render.
+     *
+     * This is a no-op for Views rendering into the SwapChain, which are always rendered.
+     */
+    void invalidate() noexcept;
+
     /**
      * Sets the rectangular region to render to.
      *
@@ -199,6 +216,23 @@ public:
         return const_cast<View*>(this)->getCamera();
     }
 
+    /**
+     * Sets a Camera used for culling and shadow preparation in place of the viewing camera.
+     *
+     * This is intended for stereo rendering, where each eye is a separate View: associate the
+     * same camera -- positioned at the head and with a frustum covering the union of the two
+     * eye frusta -- to both Views. Culling then sees a single conservative frustum, and because
+     * the world-space scene preparation is keyed off the shared camera it is done once and
+     * reused by the second eye, whose CPU cost reduces to mostly its command generation.
+     *
+     * The shared camera's frustum must contain the viewing camera's frustum, otherwise
+     * objects may be incorrectly culled.
+     *
+     * @param camera the Camera to cull with, or nullptr to cull with the viewing camera
+     *               (the default). The View doesn't take ownership of the pointer.
+     */
+    void setSharedCullingCamera(Camera* camera) noexcept;
+
     /**
      * Sets the blending mode used to draw the view into the SwapChain.
      *
@@ -214,6 +248,50 @@ public:
      */
     BlendMode getBlendMode() const noexcept;
 
+    /**
+     * Enables distance bucketing when sorting blended (transparent) objects.
+     *
+     * By default blended objects are sorted back-to-front by exact distance to the camera,
+     * which prevents grouping objects by material. With bucketing enabled, the distance is
+     * quantized into the given number of buckets and objects within a bucket are sorted by
+     * material instead, greatly reducing pipeline and descriptor changes in scenes with
+     * many transparent objects (e.g. particles). Objects in the same bucket may blend in
+     * the wrong order, so this is a trade-off between correctness and performance; a
+     * larger bucket count reduces the ordering error. Blend order
+     * (RenderableManager::setBlendOrder) keeps only its 5 most significant bits when
+     * bucketing is enabled.
+     *
+     * @param bucketCount number of distance buckets, rounded down to a power-of-two,
+     *                    at most 1024. 0 (the default) sorts by exact distance.
+     */
+    void setBlendedDistanceBuckets(uint16_t bucketCount) noexcept;
+
+    /**
+     * @return the number of distance buckets set by setBlendedDistanceBuckets
+     */
+    uint16_t getBlendedDistanceBuckets() const noexcept;
+
+    /**
+     * Enables a depth-only pre-pass before the color pass.
+     *
+     * Opaque and alpha-masked objects are first drawn into the depth buffer only; the color
+     * pass then only passes the depth test on equality, so occluded fragments are rejected
+     * before any shading runs. This trades extra vertex work and draw calls for a large
+     * reduction of fragment work in scenes with heavy overdraw (e.g. foliage), and is
+     * mostly beneficial on GPUs without an efficient hidden-surface-removal pass.
+     *
+     * The pre-pass is disabled by default.
+     *
+     * @param enabled true to enable the depth pre-pass
+     */
+    void setDepthPrepassEnabled(bool enabled) noexcept;
+
+    /**
+     * @return whether the depth pre-pass is enabled
+     * @see setDepthPrepassEnabled
+     */
+    bool isDepthPrepassEnabled() const noexcept;
+
     /**
      * Sets which layers are visible.
      *
@@ -331,6 +409,35 @@ public:
      */
     TemporalAntiAliasingOptions const& getTemporalAntiAliasingOptions() const noexcept;
 
+    /**
+     * Enables or disables automatic exposure metering. Disabled by default.
+     *
+     * The average scene luminance of the color pass is metered and adapted over time on the
+     * GPU, and read back asynchronously; use getAdaptedLuminance() to retrieve the result.
+     * Unlike metering the rendered frame with Renderer::readPixels(), this doesn't stall
+     * the pipeline.
+     *
+     * @param options auto-exposure options
+     */
+    void setAutoExposureOptions(AutoExposureOptions options) noexcept;
+
+    /**
+     * Returns auto-exposure options.
+     *
+     * @return auto-exposure options
+     */
+    AutoExposureOptions const& getAutoExposureOptions() const noexcept;
+
+    /**
+     * Returns the latest adapted average scene luminance metered by auto-exposure, or 0 if
+     * no result has arrived yet. Because the readback is asynchronous the value is typically
+     * a few frames old; it is intended to drive application logic such as
+     * Camera::setExposure().
+     *
+     * @return adapted average scene luminance, in the units of the color pass
+     */
+    float getAdaptedLuminance() const noexcept;
+
     /**
      * Enables or disable screen-space reflections. Disabled by default.
      *
@@ -516,6 +623,23 @@ public:
      */
     void setDynamicLightingOptions(float zLightNear, float zLightFar) noexcept;
 
+    /**
+     * Sets the quality of the froxel grid used for clustered (dynamic) lighting.
+     *
+     * Lower quality levels use a coarser froxel grid, which reduces the CPU cost of
+     * light froxelization and the bandwidth needed to upload the per-froxel light
+     * lists, at the expense of coarser per-pixel light culling (more fragments shade
+     * lights that don't actually reach them).
+     *
+     *   QualityLevel::LOW     quarter of the froxel budget
+     *   QualityLevel::MEDIUM  half of the froxel budget
+     *   QualityLevel::HIGH    full froxel budget (default)
+     *   QualityLevel::ULTRA   full froxel budget
+     *
+     * @param quality Froxel grid quality for this View. (Default: HIGH)
+     */
+    void setFroxelQuality(QualityLevel quality) noexcept;
+
     /*
      * Set the shadow mapping technique this View uses.
      *
@@ -575,6 +699,25 @@ public:
      */
     SoftShadowOptions getSoftShadowOptions() const noexcept;
 
+    /**
+     * Sets the shadow map update scheduling options for this View.
+     *
+     * By default all shadow maps are updated every frame; these options allow distant
+     * shadow cascades to be refreshed at a reduced rate.
+     *
+     * @param options Options for scheduling shadow map updates.
+     *
+     * @see ShadowUpdateOptions
+     */
+    void setShadowUpdateOptions(ShadowUpdateOptions const& options) noexcept;
+
+    /**
+     * Returns the shadow map update scheduling options associated with this View.
+     *
+     * @return value set by setShadowUpdateOptions().
+     */
+    ShadowUpdateOptions getShadowUpdateOptions() const noexcept;
+
     /**
      * Enables or disables post processing. Enabled by default.
      *
@@ -24,6 +24,7 @@ namespace filament {
 
 struct BufferObject::BuilderDetails {
     BindingType mBindingType = BindingType::VERTEX;
+    BufferUsage mUsage = BufferUsage::STATIC;
     uint32_t mByteCount = 0;
 };
 
@@ -45,6 +46,11 @@ BufferObject::Builder& BufferObject::Builder::bindingType(BindingType bindingTyp
     return *this;
 }
 
+BufferObject::Builder& BufferObject::Builder::usage(BufferUsage usage) noexcept {
+    mImpl->mUsage = usage;
+    return *this;
+}
+
 BufferObject* BufferObject::Builder::build(Engine& engine) {
     return upcast(engine).createBufferObject(*this);
 }
@@ -55,7 +61,7 @@ FBufferObject::FBufferObject(FEngine& engine, const BufferObject::Builder& build
         : mByteCount(builder->mByteCount), mBindingType(builder->mBindingType) {
     FEngine::DriverApi& driver = engine.getDriverApi();
     mHandle = driver.createBufferObject(builder->mByteCount, builder->mBindingType,
-            backend::BufferUsage::STATIC);
+            builder->mUsage);
 }
 
 void FBufferObject::terminate(FEngine& engine) {
@@ -67,6 +73,19 @@ void FBufferObject::setBuffer(FEngine& engine, BufferDescriptor&& buffer, uint32
     engine.getDriverApi().updateBufferObject(mHandle, std::move(buffer), byteOffset);
 }
 
+void* FBufferObject::setBufferStreaming(FEngine& engine, uint32_t byteCount,
+        uint32_t byteOffset) {
+    ASSERT_PRECONDITION(byteOffset + byteCount <= mByteCount,
+            "streaming update overflows the BufferObject (offset=%u, count=%u, size=%u)",
+            byteOffset, byteCount, mByteCount);
+    FEngine::DriverApi& driver = engine.getDriverApi();
+    // Command-stream scratch memory: filled by the caller, consumed when the command
+    // executes, reclaimed with the rest of the stream. No callback and no second copy.
+    void* const buffer = driver.allocate(byteCount);
+    driver.updateBufferObject(mHandle, { buffer, byteCount }, byteOffset);
+    return buffer;
+}
+
 // ------------------------------------------------------------------------------------------------
 // Trampoline calling into private implementation
 // ------------------------------------------------------------------------------------------------
@@ -76,6 +95,10 @@ void BufferObject::setBuffer(Engine& engine,
     upcast(this)->setBuffer(upcast(engine), std::move(buffer), byteOffset);
 }
 
+void* BufferObject::setBufferStreaming(Engine& engine, uint32_t byteCount, uint32_t byteOffset) {
+    return upcast(this)->setBufferStreaming(upcast(engine), byteCount, byteOffset);
+}
+
 size_t BufferObject::getByteCount() const noexcept {
     return upcast(this)->getByteCount();
 }
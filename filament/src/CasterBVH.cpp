@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "CasterBVH.h"
+
+#include <utils/compiler.h>
+#include <utils/debug.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+using namespace filament::math;
+
+namespace filament {
+
+// Classifies an AABB against the frustum planes: -1 when no contained box can pass
+// Culler's visibility test, +1 when every contained box passes it, 0 otherwise.
+// This uses the same per-plane arithmetic as Culler::intersects(): a box is visible
+// when dot(plane, center) - dot(|plane|, extent) + w < 0 for all six planes.
+static inline int classify(float4 const* UTILS_RESTRICT planes,
+        float3 const& c, float3 const& e) noexcept {
+    int result = 1;
+    for (size_t j = 0; j < 6; j++) {
+        const float d = planes[j].x * c.x + planes[j].y * c.y + planes[j].z * c.z + planes[j].w;
+        const float r = std::abs(planes[j].x) * e.x
+                + std::abs(planes[j].y) * e.y
+                + std::abs(planes[j].z) * e.z;
+        if (d - r >= 0.0f) {
+            // the closest corner of any contained box is at least as far out as ours
+            return -1;
+        }
+        if (d + r >= 0.0f) {
+            // some contained boxes may still fail this plane
+            result = 0;
+        }
+    }
+    return result;
+}
+
+static inline float area(float3 const& extent) noexcept {
+    return extent.x * extent.y + extent.y * extent.z + extent.z * extent.x;
+}
+
+void CasterBVH::update(float3 const* center, float3 const* extent,
+        uint32_t count, uint32_t orderVersion) noexcept {
+    if (UTILS_UNLIKELY(count == 0)) {
+        mNodes.clear();
+        mPrims.clear();
+        mCount = 0;
+        return;
+    }
+
+    if (mCount == count && mOrderVersion == orderVersion && !mNodes.empty()) {
+        const float refitArea = refit(center, extent);
+        // Refitting keeps the bits exact but lets node volumes grow as renderables move;
+        // once the accumulated inflation doubles the tree's area, queries have degraded
+        // enough that a rebuild pays for itself.
+        if (refitArea <= 2.0f * mBuiltArea) {
+            return;
+        }
+    }
+
+    mNodes.clear();
+    mNodes.reserve(2 * (count / LEAF_SIZE + 1));
+    mPrims.resize(count);
+    std::iota(mPrims.begin(), mPrims.end(), 0u);
+    build(0, count, center, extent);
+
+    float builtArea = 0.0f;
+    for (Node const& node : mNodes) {
+        builtArea += area(node.extent);
+    }
+    mBuiltArea = builtArea;
+    mOrderVersion = orderVersion;
+    mCount = count;
+}
+
+uint32_t CasterBVH::build(uint32_t first, uint32_t count,
+        float3 const* center, float3 const* extent) noexcept {
+    const uint32_t index = uint32_t(mNodes.size());
+    mNodes.emplace_back();
+
+    float3 mn = std::numeric_limits<float>::max();
+    float3 mx = std::numeric_limits<float>::lowest();
+    uint32_t const* const prims = mPrims.data();
+    for (uint32_t i = first, e = first + count; i < e; i++) {
+        const uint32_t p = prims[i];
+        mn = min(mn, center[p] - extent[p]);
+        mx = max(mx, center[p] + extent[p]);
+    }
+
+    uint32_t left = 0;
+    uint32_t right = 0;
+    if (count > LEAF_SIZE) {
+        // median split on the longest axis, which keeps the tree perfectly balanced
+        // (and the traversal stack bounded) regardless of the spatial distribution
+        const float3 size = mx - mn;
+        const int axis = (size.x > size.y)
+                ? (size.x > size.z ? 0 : 2)
+                : (size.y > size.z ? 1 : 2);
+        uint32_t* const p = mPrims.data();
+        std::nth_element(p + first, p + first + count / 2, p + first + count,
+                [center, axis](uint32_t lhs, uint32_t rhs) {
+                    return center[lhs][axis] < center[rhs][axis];
+                });
+        left = build(first, count / 2, center, extent);
+        right = build(first + count / 2, count - count / 2, center, extent);
+    }
+
+    // the recursion above can reallocate mNodes, only now is it safe to write the node
+    Node& node = mNodes[index];
+    node.center = (mn + mx) * 0.5f;
+    node.extent = (mx - mn) * 0.5f;
+    node.first = first;
+    node.count = count;
+    node.left = left;
+    node.right = right;
+    return index;
+}
+
+float CasterBVH::refit(float3 const* center, float3 const* extent) noexcept {
+    Node* const UTILS_RESTRICT nodes = mNodes.data();
+    uint32_t const* const UTILS_RESTRICT prims = mPrims.data();
+    float totalArea = 0.0f;
+    // children are always stored after their parent, so a single reverse pass sees
+    // every node's children before the node itself
+    for (uint32_t i = uint32_t(mNodes.size()); i-- > 0;) {
+        Node& node = nodes[i];
+        float3 mn, mx;
+        if (!node.left) {
+            mn = std::numeric_limits<float>::max();
+            mx = std::numeric_limits<float>::lowest();
+            for (uint32_t j = node.first, e = node.first + node.count; j < e; j++) {
+                const uint32_t p = prims[j];
+                mn = min(mn, center[p] - extent[p]);
+                mx = max(mx, center[p] + extent[p]);
+            }
+        } else {
+            Node const& l = nodes[node.left];
+            Node const& r = nodes[node.right];
+            mn = min(l.center - l.extent, r.center - r.extent);
+            mx = max(l.center + l.extent, r.center + r.extent);
+        }
+        node.center = (mn + mx) * 0.5f;
+        node.extent = (mx - mn) * 0.5f;
+        totalArea += area(node.extent);
+    }
+    return totalArea;
+}
+
+void CasterBVH::cull(Culler::result_type* UTILS_RESTRICT visibles, Frustum const& frustum,
+        float3 const* UTILS_RESTRICT center, float3 const* UTILS_RESTRICT extent,
+        size_t bit) const noexcept {
+    assert_invariant(!mNodes.empty());
+
+    float4 const* const UTILS_RESTRICT planes = frustum.getNormalizedPlanes();
+    const auto mask = Culler::result_type(1u << bit);
+    Node const* const UTILS_RESTRICT nodes = mNodes.data();
+    uint32_t const* const UTILS_RESTRICT prims = mPrims.data();
+
+    // the tree is balanced, so the depth is bounded by log2(count / LEAF_SIZE) + 1
+    uint32_t stack[64];
+    uint32_t sp = 0;
+    stack[sp++] = 0;
+    while (sp) {
+        Node const& node = nodes[stack[--sp]];
+        const int c = classify(planes, node.center, node.extent);
+        if (c < 0) {
+            continue;
+        }
+        if (c > 0) {
+            // the whole subtree is inside the frustum
+            for (uint32_t i = node.first, e = node.first + node.count; i < e; i++) {
+                visibles[prims[i]] |= mask;
+            }
+            continue;
+        }
+        if (!node.left) {
+            for (uint32_t i = node.first, e = node.first + node.count; i < e; i++) {
+                const uint32_t p = prims[i];
+                if (classify(planes, center[p], extent[p]) >= 0) {
+                    visibles[p] |= mask;
+                }
+            }
+            continue;
+        }
+        assert_invariant(sp + 2 <= sizeof(stack) / sizeof(stack[0]));
+        stack[sp++] = node.left;
+        stack[sp++] = node.right;
+    }
+}
+
+} // namespace filament
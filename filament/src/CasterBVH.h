@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_DETAILS_CASTERBVH_H
+#define TNT_FILAMENT_DETAILS_CASTERBVH_H
+
+#include "Culler.h"
+
+#include <filament/Frustum.h>
+
+#include <math/vec3.h>
+
+#include <vector>
+
+#include <stdint.h>
+
+namespace filament {
+
+/*
+ * A bounding volume hierarchy over the world-space AABBs of a scene's renderables, used to
+ * answer per-light shadow-caster queries in O(log n + k) instead of scanning every
+ * renderable once per shadow-casting light.
+ *
+ * The tree is stored flat (a vector of nodes, children after their parent) and built by
+ * median split on the longest axis, so it is perfectly balanced. The primitives of each
+ * subtree are contiguous in mPrims, which lets a node that is entirely inside the frustum
+ * mark its whole range without testing individual boxes. Both the node rejection and the
+ * leaf tests use the same plane arithmetic as Culler::intersects(), so the visibility bits
+ * produced by cull() are identical to a linear scan.
+ *
+ * update() rebuilds the topology only when the primitive ordering changed; otherwise the
+ * node bounds are refit in place in O(n). Refitting never affects correctness, but
+ * renderables drifting apart inflate the nodes and degrade query efficiency, so a rebuild
+ * is also triggered when the total node area has grown too much since the last build.
+ */
+class CasterBVH {
+public:
+    /*
+     * Rebuilds or refits the hierarchy over count AABBs given as center/extent pairs.
+     * orderVersion must change whenever primitives are added, removed or reordered;
+     * bounds-only changes are handled by refitting.
+     */
+    void update(math::float3 const* center, math::float3 const* extent,
+            uint32_t count, uint32_t orderVersion) noexcept;
+
+    /*
+     * Sets `bit` in visibles[] for each primitive whose AABB intersects the frustum,
+     * producing the same bits as Culler::intersects() on the same arrays. The center and
+     * extent arrays must be the ones the hierarchy was last updated from.
+     */
+    void cull(Culler::result_type* visibles, Frustum const& frustum,
+            math::float3 const* center, math::float3 const* extent, size_t bit) const noexcept;
+
+    bool empty() const noexcept { return mNodes.empty(); }
+
+private:
+    // with fewer primitives per node the traversal overhead exceeds the test savings
+    static constexpr uint32_t LEAF_SIZE = 8;
+
+    struct Node {
+        math::float3 center;
+        math::float3 extent;
+        uint32_t first;     // subtree's first entry in mPrims
+        uint32_t count;     // number of primitives in the subtree
+        uint32_t left;      // children indices, 0 for leaves
+        uint32_t right;
+    };
+
+    uint32_t build(uint32_t first, uint32_t count,
+            math::float3 const* center, math::float3 const* extent) noexcept;
+
+    float refit(math::float3 const* center, math::float3 const* extent) noexcept;
+
+    std::vector<Node> mNodes;
+    std::vector<uint32_t> mPrims;   // primitive indices, contiguous per subtree
+    uint32_t mOrderVersion = 0;
+    uint32_t mCount = 0;
+    float mBuiltArea = 0.0f;        // total node area right after the last rebuild
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_DETAILS_CASTERBVH_H
@@ -31,8 +31,12 @@
 #include <utils/SpinLock.h>
 #include <utils/Systrace.h>
 
+#include <algorithm>
+#include <array>
+
 #include <math.h>
 #include <stdlib.h>
+#include <string.h>
 
 namespace filament {
 
@@ -617,15 +621,65 @@ struct Config {
     float3 colorGradingLuminance;
 };
 
+// The ToneMapper is an opaque user subclass, so the LUT cache cannot inspect it for identity --
+// and comparing pointers would wrongly match a different mapper later allocated at a recycled
+// address. Instead, its response is sampled at a few dozen log-spaced, off-gray probes; mappers
+// that agree on every probe are treated as identical.
+struct FColorGrading::ToneMapperFingerprint {
+    std::array<float3, 32> samples;
+
+    static ToneMapperFingerprint sample(ToneMapper const& toneMapper) noexcept {
+        ToneMapperFingerprint fp;
+        for (size_t i = 0, n = fp.samples.size(); i < n; i++) {
+            // luminances from ~2^-14 to 2^4, with unequal channels to probe color behavior
+            float const L = std::pow(2.0f, mix(-14.0f, 4.0f, float(i) / float(n - 1)));
+            fp.samples[i] = toneMapper(float3{ L, 0.5f * L, 0.25f * L });
+        }
+        return fp;
+    }
+
+    bool operator==(ToneMapperFingerprint const& rhs) const noexcept {
+        // bitwise comparison on purpose: these are raw response samples
+        return !memcmp(samples.data(), rhs.samples.data(), sizeof(samples));
+    }
+};
+
 // Inside the FColorGrading constructor, TSAN sporadically detects a data race on the config struct;
 // the Filament thread writes and the Job thread reads. In practice there should be no data race, so
 // we force TSAN off to silence the warning.
 UTILS_NO_SANITIZE_THREAD
-FColorGrading::FColorGrading(FEngine& engine, const Builder& builder) {
+FColorGrading::FColorGrading(FEngine& engine, const Builder& builder)
+        : mEngine(engine) {
     SYSTRACE_CALL();
 
     DriverApi& driver = engine.getDriverApi();
 
+    mDimension = builder->dimension;
+
+    TextureFormat textureFormat;
+    selectLutTextureParams(builder->format, textureFormat, mFormat, mType);
+    assert_invariant(FTexture::validatePixelFormatAndType(textureFormat, mFormat, mType));
+
+    // The texture is created up-front; the upload is deferred until the LUT data is ready.
+    mLutHandle = driver.createTexture(
+            SamplerType::SAMPLER_3D,
+            1,
+            textureFormat,
+            1,
+            mDimension,
+            mDimension,
+            mDimension,
+            TextureUsage::DEFAULT
+    );
+
+    // A LUT with these settings may have been generated recently; re-uploading it is much
+    // cheaper than generating it again, which makes toggling between a few standard grades free.
+    ToneMapperFingerprint const fingerprint = ToneMapperFingerprint::sample(*builder->toneMapper);
+    if (LutBuffer lut = lutCacheLookup(builder, fingerprint)) {
+        uploadLut(std::move(lut));
+        return;
+    }
+
     Config c;
     // This lock protects the data inside Config, which is written to by the Filament thread,
     // and read from multiple Job threads.
@@ -639,20 +693,11 @@ FColorGrading::FColorGrading(FEngine& engine, const Builder& builder) {
         c.colorGradingLuminance = selectColorGradingLuminance(builder->toneMapping);
     }
 
-    mDimension = c.lutDimension;
-
     size_t lutElementCount = c.lutDimension * c.lutDimension * c.lutDimension;
-    size_t elementSize = sizeof(half4);
-    void* data = malloc(lutElementCount * elementSize);
-
-    TextureFormat textureFormat;
-    PixelDataFormat format;
-    PixelDataType type;
-    selectLutTextureParams(builder->format, textureFormat, format, type);
-    assert_invariant(FTexture::validatePixelFormatAndType(textureFormat, format, type));
+    void* data = malloc(lutElementCount * sizeof(half4));
 
     void* converted = nullptr;
-    if (type == PixelDataType::UINT_2_10_10_10_REV) {
+    if (mType == PixelDataType::UINT_2_10_10_10_REV) {
         // convert input to UINT_2_10_10_10_REV if needed
         converted = malloc(lutElementCount * sizeof(uint32_t));
     }
@@ -672,7 +717,8 @@ FColorGrading::FColorGrading(FEngine& engine, const Builder& builder) {
                 std::lock_guard<utils::SpinLock> lock(configLock);
                 config = c;
             }
-            half4* UTILS_RESTRICT p = (half4*) data + b * config.lutDimension * config.lutDimension;
+            half4* UTILS_RESTRICT p =
+                    (half4*) data + b * config.lutDimension * config.lutDimension;
             for (size_t g = 0; g < config.lutDimension; g++) {
                 for (size_t r = 0; r < config.lutDimension; r++) {
                     float3 v = float3{r, g, b} * (1.0f / float(config.lutDimension - 1u));
@@ -692,7 +738,7 @@ FColorGrading::FColorGrading(FEngine& engine, const Builder& builder) {
                     }
 
                     // Move to color grading color space
-                    v = c.colorGradingIn * v;
+                    v = config.colorGradingIn * v;
 
                     if (builder->hasAdjustments) {
                         // White balance
@@ -705,7 +751,7 @@ FColorGrading::FColorGrading(FEngine& engine, const Builder& builder) {
                         v = channelMixer(v, builder->outRed, builder->outGreen, builder->outBlue);
 
                         // Shadows/mid-tones/highlights
-                        v = tonalRanges(v, c.colorGradingLuminance,
+                        v = tonalRanges(v, config.colorGradingLuminance,
                                 builder->shadows, builder->midtones, builder->highlights,
                                 builder->tonalRanges);
 
@@ -722,10 +768,10 @@ FColorGrading::FColorGrading(FEngine& engine, const Builder& builder) {
                         v = LogC_to_linear(v);
 
                         // Vibrance in linear space
-                        v = vibrance(v, c.colorGradingLuminance, builder->vibrance);
+                        v = vibrance(v, config.colorGradingLuminance, builder->vibrance);
 
                         // Saturation in linear space
-                        v = saturation(v, c.colorGradingLuminance, builder->saturation);
+                        v = saturation(v, config.colorGradingLuminance, builder->saturation);
 
                         // Kill negative values before curves
                         v = max(v, 0.0f);
@@ -737,13 +783,13 @@ FColorGrading::FColorGrading(FEngine& engine, const Builder& builder) {
 
                     // Tone mapping
                     if (builder->luminanceScaling) {
-                        v = luminanceScaling(v, *builder->toneMapper, c.colorGradingLuminance);
+                        v = luminanceScaling(v, *builder->toneMapper, config.colorGradingLuminance);
                     } else {
                         v = (*builder->toneMapper)(v);
                     }
 
                     // Go back to display color space
-                    v = c.colorGradingOut * v;
+                    v = config.colorGradingOut * v;
 
                     // Apply gamut mapping
                     if (builder->gamutMapping) {
@@ -787,45 +833,107 @@ FColorGrading::FColorGrading(FEngine& engine, const Builder& builder) {
         js.run(job);
     }
 
-    // TODO: Should we do a runAndRetain() and defer the wait() + texture creation until
-    //       getHwHandle() is invoked?
+    // build() is documented as synchronous -- callers may delete the tone mapper as soon as
+    // it returns -- so the generation jobs must be waited on here.
     js.runAndWait(slices);
 
     //std::chrono::duration<float, std::milli> duration = std::chrono::steady_clock::now() - now;
     //slog.d << "LUT generation time: " << duration.count() << " ms" << io::endl;
 
-    mLutHandle = driver.createTexture(
-            SamplerType::SAMPLER_3D,
-            1,
-            textureFormat,
-            1,
-            c.lutDimension,
-            c.lutDimension,
-            c.lutDimension,
-            TextureUsage::DEFAULT
-    );
-
     if (converted) {
         free(data);
         data = converted;
-        elementSize = sizeof(uint32_t);
     }
 
+    LutBuffer lut(data, ::free);
+    lutCacheInsert(builder, fingerprint, lut);
+    uploadLut(std::move(lut));
+}
+
+FColorGrading::~FColorGrading() noexcept = default;
+
+void FColorGrading::terminate(FEngine& engine) {
+    DriverApi& driver = engine.getDriverApi();
+    driver.destroyTexture(mLutHandle);
+}
+
+void FColorGrading::uploadLut(LutBuffer lut) const noexcept {
+    size_t const lutElementCount = size_t(mDimension) * mDimension * mDimension;
+    size_t const elementSize = mType == PixelDataType::UINT_2_10_10_10_REV ?
+            sizeof(uint32_t) : sizeof(half4);
+
+    // The descriptor shares ownership of the buffer with the cache, so a cached LUT can be
+    // re-uploaded while a previous upload is still in flight.
+    auto* const holder = new LutBuffer(std::move(lut));
+    DriverApi& driver = mEngine.getDriverApi();
     driver.update3DImage(mLutHandle, 0,
             0, 0, 0,
-            c.lutDimension, c.lutDimension, c.lutDimension,
+            mDimension, mDimension, mDimension,
             PixelBufferDescriptor{
-                    data, lutElementCount * elementSize,format, type,
-                    [](void* buffer, size_t, void*) { free(buffer); }
+                    holder->get(), lutElementCount * elementSize, mFormat, mType,
+                    [](void*, size_t, void* user) { delete static_cast<LutBuffer*>(user); },
+                    holder
             }
     );
 }
 
-FColorGrading::~FColorGrading() noexcept = default;
+// ------------------------------------------------------------------------------------------------
+// LUT cache
+// ------------------------------------------------------------------------------------------------
 
-void FColorGrading::terminate(FEngine& engine) {
-    DriverApi& driver = engine.getDriverApi();
-    driver.destroyTexture(mLutHandle);
+// A small MRU cache of recently generated LUTs, so toggling between a handful of grading
+// presets doesn't pay the generation cost each time. The LUT data only depends on the builder
+// settings -- not on the engine -- so the cache is shared by the whole process.
+struct FColorGrading::LutCacheEntry {
+    Builder settings;
+    ToneMapperFingerprint fingerprint;
+    LutBuffer lut;
+};
+
+// enough for a few standard grades; each entry is dimension^3 * 4 or 8 bytes (1 MiB at 64^3)
+static constexpr size_t LUT_CACHE_CAPACITY = 4;
+
+SpinLock FColorGrading::sLutCacheLock;
+std::vector<FColorGrading::LutCacheEntry> FColorGrading::sLutCache;
+
+bool FColorGrading::isLutCompatible(LutCacheEntry const& entry, Builder const& builder,
+        ToneMapperFingerprint const& fingerprint) noexcept {
+    // BuilderDetails::operator== intentionally skips the tone mapping fields, but they do
+    // change the LUT, so they're compared here. The ToneMapper is matched by its sampled
+    // response, never by address (a deleted mapper's address can be recycled).
+    auto const& l = *entry.settings.mImpl;
+    auto const& r = *builder.mImpl;
+    return l == r &&
+           l.toneMapping == r.toneMapping &&
+           l.hasAdjustments == r.hasAdjustments &&
+           entry.fingerprint == fingerprint;
+}
+
+FColorGrading::LutBuffer FColorGrading::lutCacheLookup(Builder const& builder,
+        ToneMapperFingerprint const& fingerprint) noexcept {
+    std::lock_guard<SpinLock> lock(sLutCacheLock);
+    auto& cache = sLutCache;
+    for (auto it = cache.begin(); it != cache.end(); ++it) {
+        if (isLutCompatible(*it, builder, fingerprint)) {
+            // move the entry to the front (MRU order)
+            std::rotate(cache.begin(), it, it + 1);
+            return cache.front().lut;
+        }
+    }
+    return nullptr;
+}
+
+void FColorGrading::lutCacheInsert(Builder const& builder,
+        ToneMapperFingerprint const& fingerprint, LutBuffer const& lut) noexcept {
+    std::lock_guard<SpinLock> lock(sLutCacheLock);
+    auto& cache = sLutCache;
+    if (cache.size() >= LUT_CACHE_CAPACITY) {
+        cache.pop_back();
+    }
+    LutCacheEntry entry{ builder, fingerprint, lut };
+    // the stored Builder is only compared field-wise; don't keep a dangling ToneMapper pointer
+    entry.settings.toneMapper(nullptr);
+    cache.insert(cache.begin(), std::move(entry));
 }
 
 } //namespace filament
@@ -18,8 +18,26 @@
 
 #include <filament/Box.h>
 
+#include <utils/algorithm.h>
+
 #include <math/fast.h>
 
+#include <algorithm>
+#include <limits>
+
+#include <stdio.h>
+
+#if defined(__ARM_NEON)
+#   include <arm_neon.h>
+#   define FILAMENT_CULLER_USE_NEON 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#   include <emmintrin.h>
+#   define FILAMENT_CULLER_USE_SSE 1
+#elif defined(__wasm_simd128__)
+#   include <wasm_simd128.h>
+#   define FILAMENT_CULLER_USE_WASM_SIMD 1
+#endif
+
 using namespace filament::math;
 
 // use 8 if Culler::result_type is 8-bits, on ARMv8 it allows the compiler to write eight
@@ -40,6 +58,86 @@ void Culler::intersects(
     float4 const * const UTILS_RESTRICT planes = frustum.mPlanes;
 
     count = round(count);
+
+#if defined(FILAMENT_CULLER_USE_NEON)
+    // explicit 4-wide packets: 4 spheres are tested against all 6 planes at once,
+    // vld4q deinterleaves the {x,y,z,r} AoS layout into SoA registers for free.
+    for (size_t i = 0; i < count; i += MODULO) {
+        float32x4x4_t const s = vld4q_f32(reinterpret_cast<float const*>(b + i));
+        uint32x4_t visible = vdupq_n_u32(~0u);
+        for (size_t j = 0; j < 6; j++) {
+            float32x4_t dot = vmlaq_n_f32(vdupq_n_f32(planes[j].w), s.val[0], planes[j].x);
+            dot = vmlaq_n_f32(dot, s.val[1], planes[j].y);
+            dot = vmlaq_n_f32(dot, s.val[2], planes[j].z);
+            dot = vsubq_f32(dot, s.val[3]);
+            visible = vandq_u32(visible, vcltq_f32(dot, vdupq_n_f32(0.0f)));
+        }
+        results[i + 0] = result_type(vgetq_lane_u32(visible, 0) & 1u);
+        results[i + 1] = result_type(vgetq_lane_u32(visible, 1) & 1u);
+        results[i + 2] = result_type(vgetq_lane_u32(visible, 2) & 1u);
+        results[i + 3] = result_type(vgetq_lane_u32(visible, 3) & 1u);
+    }
+#elif defined(FILAMENT_CULLER_USE_SSE)
+    // explicit 4-wide packets: 4 spheres are tested against all 6 planes at once
+    __m128 const zero = _mm_setzero_ps();
+    for (size_t i = 0; i < count; i += MODULO) {
+        float const* const p = reinterpret_cast<float const*>(b + i);
+        __m128 x = _mm_loadu_ps(p +  0);
+        __m128 y = _mm_loadu_ps(p +  4);
+        __m128 z = _mm_loadu_ps(p +  8);
+        __m128 w = _mm_loadu_ps(p + 12);
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        __m128 visible = _mm_cmpeq_ps(zero, zero); // all ones
+        for (size_t j = 0; j < 6; j++) {
+            __m128 dot = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[j].x), x),
+                               _mm_mul_ps(_mm_set1_ps(planes[j].y), y)),
+                    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes[j].z), z),
+                               _mm_set1_ps(planes[j].w)));
+            dot = _mm_sub_ps(dot, w);
+            visible = _mm_and_ps(visible, _mm_cmplt_ps(dot, zero));
+        }
+        int const mask = _mm_movemask_ps(visible);
+        results[i + 0] = result_type((mask >> 0) & 1);
+        results[i + 1] = result_type((mask >> 1) & 1);
+        results[i + 2] = result_type((mask >> 2) & 1);
+        results[i + 3] = result_type((mask >> 3) & 1);
+    }
+#elif defined(FILAMENT_CULLER_USE_WASM_SIMD)
+    // explicit 4-wide packets: 4 spheres are tested against all 6 planes at once
+    v128_t const zero = wasm_f32x4_const_splat(0.0f);
+    for (size_t i = 0; i < count; i += MODULO) {
+        float const* const p = reinterpret_cast<float const*>(b + i);
+        v128_t const r0 = wasm_v128_load(p +  0);
+        v128_t const r1 = wasm_v128_load(p +  4);
+        v128_t const r2 = wasm_v128_load(p +  8);
+        v128_t const r3 = wasm_v128_load(p + 12);
+        // transpose the {x,y,z,r} AoS layout into SoA registers
+        v128_t const t0 = wasm_i32x4_shuffle(r0, r1, 0, 4, 1, 5);
+        v128_t const t1 = wasm_i32x4_shuffle(r2, r3, 0, 4, 1, 5);
+        v128_t const t2 = wasm_i32x4_shuffle(r0, r1, 2, 6, 3, 7);
+        v128_t const t3 = wasm_i32x4_shuffle(r2, r3, 2, 6, 3, 7);
+        v128_t const x = wasm_i32x4_shuffle(t0, t1, 0, 1, 4, 5);
+        v128_t const y = wasm_i32x4_shuffle(t0, t1, 2, 3, 6, 7);
+        v128_t const z = wasm_i32x4_shuffle(t2, t3, 0, 1, 4, 5);
+        v128_t const w = wasm_i32x4_shuffle(t2, t3, 2, 3, 6, 7);
+        v128_t visible = wasm_i32x4_const_splat(~0);
+        for (size_t j = 0; j < 6; j++) {
+            v128_t dot = wasm_f32x4_add(
+                    wasm_f32x4_add(wasm_f32x4_mul(wasm_f32x4_splat(planes[j].x), x),
+                                   wasm_f32x4_mul(wasm_f32x4_splat(planes[j].y), y)),
+                    wasm_f32x4_add(wasm_f32x4_mul(wasm_f32x4_splat(planes[j].z), z),
+                                   wasm_f32x4_splat(planes[j].w)));
+            dot = wasm_f32x4_sub(dot, w);
+            visible = wasm_v128_and(visible, wasm_f32x4_lt(dot, zero));
+        }
+        uint32_t const mask = wasm_i32x4_bitmask(visible);
+        results[i + 0] = result_type((mask >> 0) & 1);
+        results[i + 1] = result_type((mask >> 1) & 1);
+        results[i + 2] = result_type((mask >> 2) & 1);
+        results[i + 3] = result_type((mask >> 3) & 1);
+    }
+#else
     #pragma clang loop vectorize_width(FILAMENT_CULLER_VECTORIZE_HINT)
     for (size_t i = 0; i < count; i++) {
         int visible = ~0;
@@ -57,6 +155,7 @@ void Culler::intersects(
         }
         results[i] = result_type(visible);
     }
+#endif
 }
 
 void Culler::intersects(
@@ -69,6 +168,93 @@ void Culler::intersects(
     float4 const * UTILS_RESTRICT const planes = frustum.mPlanes;
 
     count = round(count);
+
+#if defined(FILAMENT_CULLER_USE_NEON) || defined(FILAMENT_CULLER_USE_SSE) || \
+        defined(FILAMENT_CULLER_USE_WASM_SIMD)
+    // the planes (and their absolute values, needed for the AABB test) are loop invariants,
+    // hoist them into SoA form once
+    float4 absPlanes[6];
+    for (size_t j = 0; j < 6; j++) {
+        absPlanes[j] = abs(planes[j]);
+    }
+#endif
+
+#if defined(FILAMENT_CULLER_USE_NEON)
+    // explicit 4-wide packets: 4 boxes are tested against all 6 planes at once,
+    // vld3q deinterleaves the float3 AoS layout into SoA registers for free.
+    for (size_t i = 0; i < count; i += MODULO) {
+        float32x4x3_t const c = vld3q_f32(reinterpret_cast<float const*>(center + i));
+        float32x4x3_t const e = vld3q_f32(reinterpret_cast<float const*>(extent + i));
+        uint32x4_t visible = vdupq_n_u32(~0u);
+        for (size_t j = 0; j < 6; j++) {
+            float32x4_t dot = vmlaq_n_f32(vdupq_n_f32(planes[j].w), c.val[0], planes[j].x);
+            dot = vmlsq_n_f32(dot, e.val[0], absPlanes[j].x);
+            dot = vmlaq_n_f32(dot, c.val[1], planes[j].y);
+            dot = vmlsq_n_f32(dot, e.val[1], absPlanes[j].y);
+            dot = vmlaq_n_f32(dot, c.val[2], planes[j].z);
+            dot = vmlsq_n_f32(dot, e.val[2], absPlanes[j].z);
+            visible = vandq_u32(visible, vcltq_f32(dot, vdupq_n_f32(0.0f)));
+        }
+        results[i + 0] |= result_type((vgetq_lane_u32(visible, 0) & 1u) << bit);
+        results[i + 1] |= result_type((vgetq_lane_u32(visible, 1) & 1u) << bit);
+        results[i + 2] |= result_type((vgetq_lane_u32(visible, 2) & 1u) << bit);
+        results[i + 3] |= result_type((vgetq_lane_u32(visible, 3) & 1u) << bit);
+    }
+#elif defined(FILAMENT_CULLER_USE_SSE)
+    // explicit 4-wide packets: 4 boxes are tested against all 6 planes at once
+    __m128 const zero = _mm_setzero_ps();
+    for (size_t i = 0; i < count; i += MODULO) {
+        __m128 const cx = _mm_setr_ps(center[i].x, center[i + 1].x, center[i + 2].x, center[i + 3].x);
+        __m128 const cy = _mm_setr_ps(center[i].y, center[i + 1].y, center[i + 2].y, center[i + 3].y);
+        __m128 const cz = _mm_setr_ps(center[i].z, center[i + 1].z, center[i + 2].z, center[i + 3].z);
+        __m128 const ex = _mm_setr_ps(extent[i].x, extent[i + 1].x, extent[i + 2].x, extent[i + 3].x);
+        __m128 const ey = _mm_setr_ps(extent[i].y, extent[i + 1].y, extent[i + 2].y, extent[i + 3].y);
+        __m128 const ez = _mm_setr_ps(extent[i].z, extent[i + 1].z, extent[i + 2].z, extent[i + 3].z);
+        __m128 visible = _mm_cmpeq_ps(zero, zero); // all ones
+        for (size_t j = 0; j < 6; j++) {
+            __m128 dot = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(planes[j].x), cx),
+                                    _mm_mul_ps(_mm_set1_ps(absPlanes[j].x), ex));
+            dot = _mm_add_ps(dot, _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(planes[j].y), cy),
+                                             _mm_mul_ps(_mm_set1_ps(absPlanes[j].y), ey)));
+            dot = _mm_add_ps(dot, _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(planes[j].z), cz),
+                                             _mm_mul_ps(_mm_set1_ps(absPlanes[j].z), ez)));
+            dot = _mm_add_ps(dot, _mm_set1_ps(planes[j].w));
+            visible = _mm_and_ps(visible, _mm_cmplt_ps(dot, zero));
+        }
+        int const mask = _mm_movemask_ps(visible);
+        results[i + 0] |= result_type(((mask >> 0) & 1) << bit);
+        results[i + 1] |= result_type(((mask >> 1) & 1) << bit);
+        results[i + 2] |= result_type(((mask >> 2) & 1) << bit);
+        results[i + 3] |= result_type(((mask >> 3) & 1) << bit);
+    }
+#elif defined(FILAMENT_CULLER_USE_WASM_SIMD)
+    // explicit 4-wide packets: 4 boxes are tested against all 6 planes at once
+    v128_t const zero = wasm_f32x4_const_splat(0.0f);
+    for (size_t i = 0; i < count; i += MODULO) {
+        v128_t const cx = wasm_f32x4_make(center[i].x, center[i + 1].x, center[i + 2].x, center[i + 3].x);
+        v128_t const cy = wasm_f32x4_make(center[i].y, center[i + 1].y, center[i + 2].y, center[i + 3].y);
+        v128_t const cz = wasm_f32x4_make(center[i].z, center[i + 1].z, center[i + 2].z, center[i + 3].z);
+        v128_t const ex = wasm_f32x4_make(extent[i].x, extent[i + 1].x, extent[i + 2].x, extent[i + 3].x);
+        v128_t const ey = wasm_f32x4_make(extent[i].y, extent[i + 1].y, extent[i + 2].y, extent[i + 3].y);
+        v128_t const ez = wasm_f32x4_make(extent[i].z, extent[i + 1].z, extent[i + 2].z, extent[i + 3].z);
+        v128_t visible = wasm_i32x4_const_splat(~0);
+        for (size_t j = 0; j < 6; j++) {
+            v128_t dot = wasm_f32x4_sub(wasm_f32x4_mul(wasm_f32x4_splat(planes[j].x), cx),
+                                        wasm_f32x4_mul(wasm_f32x4_splat(absPlanes[j].x), ex));
+            dot = wasm_f32x4_add(dot, wasm_f32x4_sub(wasm_f32x4_mul(wasm_f32x4_splat(planes[j].y), cy),
+                                                     wasm_f32x4_mul(wasm_f32x4_splat(absPlanes[j].y), ey)));
+            dot = wasm_f32x4_add(dot, wasm_f32x4_sub(wasm_f32x4_mul(wasm_f32x4_splat(planes[j].z), cz),
+                                                     wasm_f32x4_mul(wasm_f32x4_splat(absPlanes[j].z), ez)));
+            dot = wasm_f32x4_add(dot, wasm_f32x4_splat(planes[j].w));
+            visible = wasm_v128_and(visible, wasm_f32x4_lt(dot, zero));
+        }
+        uint32_t const mask = wasm_i32x4_bitmask(visible);
+        results[i + 0] |= result_type(((mask >> 0) & 1) << bit);
+        results[i + 1] |= result_type(((mask >> 1) & 1) << bit);
+        results[i + 2] |= result_type(((mask >> 2) & 1) << bit);
+        results[i + 3] |= result_type(((mask >> 3) & 1) << bit);
+    }
+#else
     #pragma clang loop vectorize_width(FILAMENT_CULLER_VECTORIZE_HINT)
     for (size_t i = 0; i < count; i++) {
         int visible = ~0;
@@ -88,6 +274,99 @@ void Culler::intersects(
 
         results[i] |= result_type(visible);
     }
+#endif
+}
+
+void Culler::intersects(
+        result_type* UTILS_RESTRICT results,
+        float* UTILS_RESTRICT maxDots,
+        Frustum const& UTILS_RESTRICT frustum,
+        float3 const* UTILS_RESTRICT center,
+        float3 const* UTILS_RESTRICT extent,
+        size_t count, size_t bit) noexcept {
+
+    float4 const* UTILS_RESTRICT const planes = frustum.mPlanes;
+
+    count = round(count);
+
+    // scalar only: the margin output doesn't map to the movemask-style reductions of the
+    // explicit SIMD paths above, and this variant only runs on full-refresh frames of the
+    // temporally-coherent culling; we rely on the auto-vectorizer here.
+    #pragma clang loop vectorize_width(FILAMENT_CULLER_VECTORIZE_HINT)
+    for (size_t i = 0; i < count; i++) {
+        float maxDot = -std::numeric_limits<float>::max();
+
+        #pragma clang loop unroll(full)
+        for (size_t j = 0; j < 6; j++) {
+            const float dot =
+                    planes[j].x * center[i].x - std::abs(planes[j].x) * extent[i].x +
+                    planes[j].y * center[i].y - std::abs(planes[j].y) * extent[i].y +
+                    planes[j].z * center[i].z - std::abs(planes[j].z) * extent[i].z +
+                    planes[j].w;
+            maxDot = std::max(maxDot, dot);
+        }
+
+        maxDots[i] = maxDot;
+        results[i] |= result_type(int(maxDot < 0.0f) << bit);
+    }
+}
+
+Culler::Classification Culler::classify(Frustum const& frustum,
+        float3 center, float3 extent, plane_mask_type& mask) noexcept {
+    float4 const* UTILS_RESTRICT const planes = frustum.mPlanes;
+    plane_mask_type remaining = 0;
+    for (plane_mask_type m = mask; m; m &= m - 1u) {
+        size_t const j = size_t(utils::ctz(unsigned(m)));
+        // signed distances of the nearest and farthest box corner to the plane
+        const float dotCenter =
+                planes[j].x * center.x + planes[j].y * center.y +
+                planes[j].z * center.z + planes[j].w;
+        const float dotExtent =
+                std::abs(planes[j].x) * extent.x + std::abs(planes[j].y) * extent.y +
+                std::abs(planes[j].z) * extent.z;
+        if (dotCenter - dotExtent > 0) {
+            // nearest corner outside: the box is entirely outside this plane, and with it
+            // the whole subtree -- the mask doesn't matter anymore
+            return Classification::OUTSIDE;
+        }
+        if (dotCenter + dotExtent > 0) {
+            // farthest corner outside: the box crosses the plane, children must re-test it
+            remaining |= plane_mask_type(1u << j);
+        }
+        // else entirely inside this plane, children can skip it
+    }
+    mask = remaining;
+    return remaining ? Classification::INTERSECTS : Classification::INSIDE;
+}
+
+void Culler::classify(Classification* UTILS_RESTRICT results,
+        plane_mask_type* UTILS_RESTRICT childMasks,
+        Frustum const& UTILS_RESTRICT frustum,
+        float3 const* UTILS_RESTRICT center,
+        float3 const* UTILS_RESTRICT extent,
+        size_t count, plane_mask_type mask) noexcept {
+    // scalar only: the active plane set varies per node and is typically small, which
+    // defeats the fixed 6-plane packets of the explicit SIMD paths above
+    for (size_t i = 0; i < count; i++) {
+        plane_mask_type m = mask;
+        results[i] = classify(frustum, center[i], extent[i], m);
+        childMasks[i] = m;
+    }
+}
+
+float Culler::maxPlaneDistance(Frustum const& frustum,
+        float3 center, float3 extent) noexcept {
+    float4 const* UTILS_RESTRICT const planes = frustum.mPlanes;
+    float maxDot = -std::numeric_limits<float>::max();
+    for (size_t j = 0; j < 6; j++) {
+        const float dot =
+                planes[j].x * center.x - std::abs(planes[j].x) * extent.x +
+                planes[j].y * center.y - std::abs(planes[j].y) * extent.y +
+                planes[j].z * center.z - std::abs(planes[j].z) * extent.z +
+                planes[j].w;
+        maxDot = std::max(maxDot, dot);
+    }
+    return maxDot;
 }
 
 /*
@@ -119,6 +398,56 @@ bool Culler::intersects(Frustum const& frustum, float4 const& sphere) noexcept {
     return bool(results[0]);
 }
 
+// Culling captures, see Culler.h
+
+namespace {
+struct CaptureHeader {
+    static constexpr uint32_t MAGIC = 0x4c4c5543;   // 'CULL'
+    static constexpr uint32_t VERSION = 1;
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;
+    uint32_t reserved;
+};
+} // anonymous namespace
+
+bool Culler::dumpCapture(const char* path, Frustum const& frustum,
+        float3 const* center, float3 const* extent, size_t count) noexcept {
+    FILE* const file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    CaptureHeader const header{ CaptureHeader::MAGIC, CaptureHeader::VERSION,
+            uint32_t(count), 0 };
+    bool success = fwrite(&header, sizeof(header), 1, file) == 1
+            && fwrite(&frustum, sizeof(Frustum), 1, file) == 1
+            && fwrite(center, sizeof(float3), count, file) == count
+            && fwrite(extent, sizeof(float3), count, file) == count;
+    success = (fclose(file) == 0) && success;
+    return success;
+}
+
+bool Culler::loadCapture(const char* path, Frustum* frustum,
+        std::vector<float3>* center, std::vector<float3>* extent) noexcept {
+    FILE* const file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    CaptureHeader header{};
+    bool success = fread(&header, sizeof(header), 1, file) == 1
+            && header.magic == CaptureHeader::MAGIC
+            && header.version == CaptureHeader::VERSION;
+    if (success) {
+        center->resize(header.count);
+        extent->resize(header.count);
+        success = fread(frustum, sizeof(Frustum), 1, file) == 1
+                && fread(center->data(), sizeof(float3), header.count, file) == header.count
+                && fread(extent->data(), sizeof(float3), header.count, file) == header.count;
+    }
+    fclose(file);
+    return success;
+}
+
 // For testing...
 
 void Culler::Test::intersects(
@@ -25,6 +25,8 @@
 #include <math/vec4.h>
 #include <math/vec2.h>
 
+#include <vector>
+
 namespace filament {
 
 /*
@@ -53,6 +55,62 @@ public:
             math::float3 const* extent,
             size_t count, size_t bit) noexcept;
 
+    /*
+     * Same as the AABB variant above, but also writes for each box its largest signed
+     * plane distance: negative values mean the box is inside the frustum by that margin,
+     * positive values that it is outside. Temporally-coherent culling uses the margins
+     * to decide which boxes need re-testing on subsequent frames.
+     */
+    static void intersects(result_type* results, float* maxDots,
+            Frustum const& frustum,
+            math::float3 const* center,
+            math::float3 const* extent,
+            size_t count, size_t bit) noexcept;
+
+    /*
+     * largest signed plane distance of a single AABB, see above
+     */
+    static float maxPlaneDistance(
+            Frustum const& frustum,
+            math::float3 center,
+            math::float3 extent) noexcept;
+
+    /*
+     * Plane mask for hierarchy-aware culling; bit j set means plane j still needs testing.
+     */
+    using plane_mask_type = uint8_t;
+    static constexpr plane_mask_type ALL_PLANES = 0x3f;
+
+    enum class Classification : uint8_t {
+        OUTSIDE,        // entirely outside at least one active plane
+        INTERSECTS,     // crosses at least one active plane
+        INSIDE,         // entirely inside every active plane
+    };
+
+    /*
+     * Hierarchy-aware AABB test: classifies a box against the frustum, testing only the
+     * planes set in 'mask'. On return 'mask' holds the planes the box actually crosses,
+     * so the children of an INTERSECTS node are tested against that reduced set only,
+     * and the subtree of an INSIDE node isn't tested at all. Start with ALL_PLANES at
+     * the root.
+     */
+    static Classification classify(
+            Frustum const& frustum,
+            math::float3 center,
+            math::float3 extent,
+            plane_mask_type& mask) noexcept;
+
+    /*
+     * Batch variant for a node's children: classifies count boxes against the planes set
+     * in 'mask' and writes each box's reduced mask to childMasks. Unlike the intersects()
+     * batches above, count doesn't need to be a multiple of MODULO.
+     */
+    static void classify(Classification* results, plane_mask_type* childMasks,
+            Frustum const& frustum,
+            math::float3 const* center,
+            math::float3 const* extent,
+            size_t count, plane_mask_type mask) noexcept;
+
     /*
      * returns whether each sphere in an array intersects with the frustum
      */
@@ -77,6 +135,20 @@ public:
             math::float4 const& sphere) noexcept;
 
 
+    /*
+     * Culling captures record a live view's culling inputs -- the culling frustum and
+     * every renderable's world-space AABB -- so culling changes can be benchmarked
+     * against the spatial distribution of production scenes instead of synthetic
+     * random boxes. A capture is written by FView::prepare() when the
+     * FILAMENT_CULLING_CAPTURE environment variable is set, and replayed by
+     * benchmark_filament (see benchmark/README.md).
+     */
+    static bool dumpCapture(const char* path, Frustum const& frustum,
+            math::float3 const* center, math::float3 const* extent, size_t count) noexcept;
+
+    static bool loadCapture(const char* path, Frustum* frustum,
+            std::vector<math::float3>* center, std::vector<math::float3>* extent) noexcept;
+
     struct UTILS_PUBLIC Test {
         static void intersects(result_type* results,
                 Frustum const& frustum,
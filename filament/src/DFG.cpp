@@ -19,17 +19,51 @@
 #include "details/Engine.h"
 #include "details/Texture.h"
 
+#if FILAMENT_GENERATE_DFG_AT_RUNTIME
+#include <ibl/CubemapIBL.h>
+#include <ibl/Image.h>
+
+#include <math/half.h>
+#include <math/vec3.h>
+#endif
+
 namespace filament {
 
+#if !FILAMENT_GENERATE_DFG_AT_RUNTIME
 const uint16_t DFG::DFG_LUT[] = {
 #include "generated/data/dfg.inc"
 };
+#endif
 
 DFG::DFG(FEngine& engine) noexcept : mEngine(engine) {
     constexpr size_t fp16Count = DFG_LUT_SIZE * DFG_LUT_SIZE * 3;
     constexpr size_t byteCount = fp16Count * sizeof(uint16_t);
 
+#if FILAMENT_GENERATE_DFG_AT_RUNTIME
+    // Generate the LUT with the same integrator cmgen uses offline (ibl-lite is already part of
+    // this library), parallelized on the engine's JobSystem. The data -- not the texture, which
+    // is per-Engine -- is computed once and shared by every Engine in the process. Like the
+    // embedded table it replaces, it is never freed.
+    static const uint16_t* const sharedLut = [&engine]() -> const uint16_t* {
+        ibl::Image image(DFG_LUT_SIZE, DFG_LUT_SIZE);
+        ibl::CubemapIBL::DFG(engine.getJobSystem(), image, true, true);
+        uint16_t* const lut = new uint16_t[fp16Count];
+        uint16_t* p = lut;
+        for (size_t y = 0; y < DFG_LUT_SIZE; y++) {
+            auto const* src = static_cast<math::float3 const*>(image.getPixelRef(0, y));
+            for (size_t x = 0; x < DFG_LUT_SIZE; x++, src++) {
+                *p++ = getBits(math::half(src->r));
+                *p++ = getBits(math::half(src->g));
+                *p++ = getBits(math::half(src->b));
+            }
+        }
+        return lut;
+    }();
+    const uint16_t* const dfgLut = sharedLut;
+#else
     static_assert(sizeof(DFG_LUT) == byteCount, "DFG_LUT_SIZE doesn't match size of the DFG LUT");
+    const uint16_t* const dfgLut = DFG_LUT;
+#endif
 
     Texture* lut = Texture::Builder()
             .width(DFG_LUT_SIZE)
@@ -37,7 +71,7 @@ DFG::DFG(FEngine& engine) noexcept : mEngine(engine) {
             .format(backend::TextureFormat::RGB16F)
             .build(mEngine);
 
-    Texture::PixelBufferDescriptor buffer(DFG_LUT, byteCount,
+    Texture::PixelBufferDescriptor buffer(dfgLut, byteCount,
             Texture::Format::RGB, Texture::Type::HALF);
 
     lut->setImage(mEngine, 0, std::move(buffer));
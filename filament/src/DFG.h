@@ -31,6 +31,10 @@ class FEngine;
 #define FILAMENT_DFG_LUT_SIZE 128
 #endif
 
+#if !defined(FILAMENT_GENERATE_DFG_AT_RUNTIME)
+#define FILAMENT_GENERATE_DFG_AT_RUNTIME 0
+#endif
+
 class DFG {
 public:
     explicit DFG(FEngine& engine) noexcept;
@@ -61,8 +65,10 @@ private:
     // make sure to use the right size here
     static constexpr size_t DFG_LUT_SIZE = FILAMENT_DFG_LUT_SIZE;
 
+#if !FILAMENT_GENERATE_DFG_AT_RUNTIME
     // this lookup table is generated with cmgen
     static const uint16_t DFG_LUT[];
+#endif
 };
 
 #undef FILAMENT_DFG_LUT_SIZE
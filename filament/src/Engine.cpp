@@ -45,13 +45,20 @@
 #include <backend/DriverEnums.h>
 
 #include <utils/compiler.h>
+#include <utils/FixedCapacityVector.h>
 #include <utils/Log.h>
 #include <utils/Panic.h>
 #include <utils/Systrace.h>
+#include <utils/architecture.h>
 #include <utils/debug.h>
+#include <utils/memalign.h>
 
+#include <algorithm>
+#include <cinttypes>
 #include <memory>
 
+#include <stdlib.h>
+
 #include "generated/resources/materials.h"
 
 using namespace filament::math;
@@ -186,6 +193,9 @@ FEngine::FEngine(Backend backend, Platform* platform, void* sharedGLContext) :
     // (it may not be the case)
     mJobSystem.adopt();
 
+    // let the transform manager parallelize large hierarchy updates
+    mTransformManager.setJobSystem(&mJobSystem);
+
     slog.i << "FEngine (" << sizeof(void*) * 8 << " bits) created at " << this << " "
            << "(threading is " << (UTILS_HAS_THREADING ? "enabled)" : "disabled)") << io::endl;
 }
@@ -210,6 +220,24 @@ void FEngine::init() {
     mCommandStream = CommandStream(*mDriver, mCommandBufferQueue.getCircularBuffer());
     DriverApi& driverApi = getDriverApi();
 
+    // FILAMENT_CAPTURE=<path> serializes the command stream to <path>, so a workload can
+    // be replayed against any backend with tools/capreplay. FILAMENT_CAPTURE_FRAMES
+    // limits the capture to the first N frames; unset or 0 records until shutdown.
+    // The recorder is attached here, before any resource is created, so that the capture
+    // is self-contained.
+    const char* const capturePath = getenv("FILAMENT_CAPTURE");
+    if (UTILS_UNLIKELY(capturePath != nullptr)) {
+        const char* const captureFrames = getenv("FILAMENT_CAPTURE_FRAMES");
+        const uint32_t frameCount = captureFrames ? uint32_t(atoi(captureFrames)) : 0u;
+        mCaptureRecorder = new backend::CaptureRecorder(capturePath, frameCount);
+        if (mCaptureRecorder->isOpen()) {
+            driverApi.setCapturer(mCaptureRecorder);
+        } else {
+            delete mCaptureRecorder;
+            mCaptureRecorder = nullptr;
+        }
+    }
+
     mResourceAllocator = new ResourceAllocator(driverApi);
 
     mFullScreenTriangleVb = upcast(VertexBuffer::Builder()
@@ -235,25 +263,9 @@ void FEngine::init() {
     driverApi.setRenderPrimitiveRange(mFullScreenTriangleRph, PrimitiveType::TRIANGLES,
             0, 0, 2, (uint32_t)mFullScreenTriangleIb->getIndexCount());
 
-    mDefaultIblTexture = upcast(Texture::Builder()
-            .width(1).height(1).levels(1)
-            .format(Texture::InternalFormat::RGBA8)
-            .sampler(Texture::Sampler::SAMPLER_CUBEMAP)
-            .build(*this));
-    static uint32_t pixel = 0;
-    Texture::PixelBufferDescriptor buffer(
-            &pixel, 4, // 4 bytes in 1 RGBA pixel
-            Texture::Format::RGBA, Texture::Type::UBYTE);
-    Texture::FaceOffsets offsets = {};
-    mDefaultIblTexture->setImage(*this, 0, std::move(buffer), offsets);
-
-    // 3 bands = 9 float3
-    const float sh[9 * 3] = { 0.0f };
-    mDefaultIbl = upcast(IndirectLight::Builder()
-            .irradiance(3, reinterpret_cast<const float3*>(sh))
-            .build(*this));
-
-    mDefaultColorGrading = upcast(ColorGrading::Builder().build(*this));
+    // Note: the default IBL, default color grading, DFG LUT and skybox material are not created
+    // here; like the skybox material they materialize on first use (see the getters below), which
+    // keeps cold Engine creation -- and therefore time-to-first-frame -- as short as possible.
 
     // Always initialize the default material, most materials' depth shaders fallback on it.
     mDefaultMaterial = upcast(
@@ -280,7 +292,6 @@ void FEngine::init() {
 
     mPostProcessManager.init();
     mLightManager.init(*this);
-    mDFG = std::make_unique<DFG>(*this);
 }
 
 FEngine::~FEngine() noexcept {
@@ -310,16 +321,26 @@ void FEngine::shutdown() {
 
     DriverApi& driver = getDriverApi();
 
+    // reclaim all pending deferred destroys before cleaning up the resource lists
+    mGarbageWatermark = 0;
+    reclaimGarbage();
+
+    // pending deferred work is pointless now
+    mDeferredWork.clear();
+
     /*
      * Destroy our own state first
      */
 
     mPostProcessManager.terminate(driver);  // free-up post-process manager resources
     mResourceAllocator->terminate();
-    mDFG->terminate();                      // free-up the DFG
+    if (mDFG) {
+        mDFG->terminate();                  // free-up the DFG
+    }
     mRenderableManager.terminate();         // free-up all renderables
     mLightManager.terminate();              // free-up all lights
     mCameraManager.terminate();             // free-up all cameras
+    mStagingBufferPool.terminate();         // free-up pooled staging memory
 
     driver.destroyRenderPrimitive(mFullScreenTriangleRph);
     destroy(mFullScreenTriangleIb);
@@ -347,6 +368,7 @@ void FEngine::shutdown() {
 
     // this must be done after Skyboxes and before materials
     destroy(mSkyboxMaterial);
+    destroy(mDebugOverdrawMaterial);
 
     cleanupResourceList(mBufferObjects);
     cleanupResourceList(mIndexBuffers);
@@ -361,6 +383,16 @@ void FEngine::shutdown() {
     }
     cleanupResourceList(mFences);
 
+    // all material instances are gone at this point, their uniform slots are all released
+    mUniformBufferArena.terminate(driver);
+
+    // all pending uploads have been consumed at this point (their descriptors were released
+    // when the resources above were destroyed), so the staging pool holds every block
+    for (auto const& item : mStagingPool) {
+        utils::aligned_free(item.first);
+    }
+    mStagingPool.clear();
+
     driver.destroySamplerGroup(mDummyMorphingSamplerGroup);
     driver.destroyTexture(mDummyOneTexture);
     driver.destroyTexture(mDummyOneTextureArray);
@@ -371,6 +403,14 @@ void FEngine::shutdown() {
      * Shutdown the backend...
      */
 
+    // the capture, if any, ends here -- the resource destructions above are part of it,
+    // which lets the replay tool exit cleanly
+    if (UTILS_UNLIKELY(mCaptureRecorder != nullptr)) {
+        getDriverApi().setCapturer(nullptr);
+        delete mCaptureRecorder; // closes the capture file if it is still recording
+        mCaptureRecorder = nullptr;
+    }
+
     // There might be commands added by the terminate() calls, so we need to flush all commands
     // up to this point. After flushCommandBuffer() is called, all pending commands are guaranteed
     // to be executed before the driver thread exits.
@@ -402,10 +442,24 @@ void FEngine::shutdown() {
 
 void FEngine::prepare() {
     SYSTRACE_CALL();
+
+    // let the thermal governor adjust the quality reduction step for this frame
+    mQualityGovernor.update();
+
     // prepare() is called once per Renderer frame. Ideally we would upload the content of
     // UBOs that are visible only. It's not such a big issue because the actual upload() is
     // skipped is the UBO hasn't changed. Still we could have a lot of these.
+    // evaluate the parameter animation tracks first, so the values they write are
+    // picked up by the commits below
+    if (!mParameterTrackManager.isEmpty()) {
+        mParameterTrackManager.evaluate();
+    }
+
     FEngine::DriverApi& driver = getDriverApi();
+
+    // issue deferred texture uploads within this frame's budget
+    mTextureUploadScheduler.flush(driver);
+
     for (auto& materialInstanceList : mMaterialInstances) {
         for (const auto& item : materialInstanceList.second) {
             item->commit(driver);
@@ -418,6 +472,22 @@ void FEngine::prepare() {
     }
 }
 
+ParameterTrackManager::TrackId FEngine::addParameterTrack(FMaterialInstance* instance,
+        const char* name, float const* times, float const* values,
+        size_t keyframeCount, size_t componentCount, bool loop) noexcept {
+    if (UTILS_UNLIKELY(!instance || !name)) {
+        return 0;
+    }
+    // resolve the parameter name once, at registration
+    ssize_t const offset =
+            instance->getMaterial()->getUniformInterfaceBlock().getUniformOffset(name, 0);
+    if (UTILS_UNLIKELY(offset < 0)) {
+        return 0;
+    }
+    return mParameterTrackManager.addTrack(instance, size_t(offset), componentCount,
+            times, values, keyframeCount, loop);
+}
+
 void FEngine::gc() {
     // Note: this runs in a Job
     auto& em = mEntityManager;
@@ -432,6 +502,10 @@ void FEngine::flush() {
     flushCommandBuffer(mCommandBufferQueue);
 }
 
+void FEngine::setProgramBinaryCacheDirectory(const char* path) noexcept {
+    getDriverApi().setProgramBinaryCacheDirectory(utils::CString{ path ? path : "" });
+}
+
 void FEngine::flushAndWait() {
 
 #if defined(__ANDROID__)
@@ -477,6 +551,31 @@ void FEngine::flushAndWait() {
     getDriver().purge();
 }
 
+FEngine::SyncToken FEngine::insertToken() {
+    SyncToken const token = ++mLastInsertedToken;
+    getDriverApi().queueCommand([this, token]() {
+        // we're on the driver thread here; every command issued before the token has now
+        // been executed
+        std::lock_guard<utils::Mutex> const lock(mTokenLock);
+        mLastSignaledToken.store(token, std::memory_order_release);
+        mTokenCondition.notify_all();
+    });
+    return token;
+}
+
+void FEngine::waitForToken(SyncToken token) {
+    if (isTokenSignaled(token)) {
+        return;
+    }
+    // Make sure the command buffer holding the token is submitted to the driver thread,
+    // otherwise we could wait forever.
+    flush();
+    std::unique_lock<utils::Mutex> lock(mTokenLock);
+    mTokenCondition.wait(lock, [this, token]() {
+        return mLastSignaledToken.load(std::memory_order_acquire) >= token;
+    });
+}
+
 // -----------------------------------------------------------------------------------------------
 // Render thread / command queue
 // -----------------------------------------------------------------------------------------------
@@ -560,6 +659,70 @@ const FMaterial* FEngine::getSkyboxMaterial() const noexcept {
     return material;
 }
 
+FMaterialInstance* FEngine::getDebugOverdrawMaterialInstance() noexcept {
+    if (UTILS_UNLIKELY(mDebugOverdrawMaterial == nullptr)) {
+        mDebugOverdrawMaterial = upcast(Material::Builder()
+                .package(MATERIALS_DEBUGOVERDRAW_DATA, MATERIALS_DEBUGOVERDRAW_SIZE)
+                .build(*this));
+    }
+    return mDebugOverdrawMaterial->getDefaultInstance();
+}
+
+/*
+ * The resources below are not needed to bring up the swapchain and show the first frames, so
+ * they're not created in init(); instead they materialize on first use, on the thread that owns
+ * the Engine.
+ */
+
+DFG* FEngine::getDFG() const noexcept {
+    if (UTILS_UNLIKELY(!mDFG)) {
+        mDFG = std::make_unique<DFG>(*const_cast<FEngine*>(this));
+    }
+    return mDFG.get();
+}
+
+const FTexture* FEngine::getDummyCubemap() const noexcept {
+    FTexture* texture = mDefaultIblTexture;
+    if (UTILS_UNLIKELY(texture == nullptr)) {
+        FEngine& engine = *const_cast<FEngine*>(this);
+        texture = upcast(Texture::Builder()
+                .width(1).height(1).levels(1)
+                .format(Texture::InternalFormat::RGBA8)
+                .sampler(Texture::Sampler::SAMPLER_CUBEMAP)
+                .build(engine));
+        static uint32_t pixel = 0;
+        Texture::PixelBufferDescriptor buffer(
+                &pixel, 4, // 4 bytes in 1 RGBA pixel
+                Texture::Format::RGBA, Texture::Type::UBYTE);
+        Texture::FaceOffsets offsets = {};
+        texture->setImage(engine, 0, std::move(buffer), offsets);
+        mDefaultIblTexture = texture;
+    }
+    return texture;
+}
+
+const FIndirectLight* FEngine::getDefaultIndirectLight() const noexcept {
+    FIndirectLight* ibl = mDefaultIbl;
+    if (UTILS_UNLIKELY(ibl == nullptr)) {
+        // 3 bands = 9 float3
+        const float sh[9 * 3] = { 0.0f };
+        ibl = upcast(IndirectLight::Builder()
+                .irradiance(3, reinterpret_cast<const float3*>(sh))
+                .build(*const_cast<FEngine*>(this)));
+        mDefaultIbl = ibl;
+    }
+    return ibl;
+}
+
+const FColorGrading* FEngine::getDefaultColorGrading() const noexcept {
+    FColorGrading* colorGrading = mDefaultColorGrading;
+    if (UTILS_UNLIKELY(colorGrading == nullptr)) {
+        colorGrading = upcast(ColorGrading::Builder().build(*const_cast<FEngine*>(this)));
+        mDefaultColorGrading = colorGrading;
+    }
+    return colorGrading;
+}
+
 // -----------------------------------------------------------------------------------------------
 // Resource management
 // -----------------------------------------------------------------------------------------------
@@ -763,26 +926,91 @@ bool FEngine::terminateAndDestroy(const T* ptr, ResourceList<T, L>& list) {
     return success;
 }
 
+template<typename T, typename L>
+bool FEngine::terminateAndDestroyDeferred(const T* ptr, ResourceList<T, L>& list) {
+    if (UTILS_LIKELY(!mGarbageWatermark)) {
+        return terminateAndDestroy(ptr, list);
+    }
+    if (ptr == nullptr) return true;
+    bool success = list.remove(ptr);
+    if (ASSERT_PRECONDITION_NON_FATAL(success,
+            "Object %s at %p doesn't exist (double free?)",
+            CallStack::typeName<T>().c_str(), ptr)) {
+        mGarbage.push_back({ const_cast<T*>(ptr),
+                +[](FEngine& engine, void* object) {
+                    T* const p = static_cast<T*>(object);
+                    p->terminate(engine);
+                    engine.mHeapAllocator.destroy(p);
+                }});
+    }
+    return success;
+}
+
+void FEngine::reclaimGarbage() noexcept {
+    auto& garbage = mGarbage;
+    if (UTILS_LIKELY(garbage.empty())) {
+        return;
+    }
+    // reclaim oldest first, at most mGarbageWatermark objects per frame, so that a bulk
+    // unload (thousands of destroys in one frame) is spread over several frames instead
+    // of stalling the driver thread during rendering
+    const size_t watermark = mGarbageWatermark;
+    const size_t count = watermark ? std::min(garbage.size(), watermark) : garbage.size();
+    for (size_t i = 0; i < count; i++) {
+        garbage[i].terminate(*this, garbage[i].object);
+    }
+    garbage.erase(garbage.begin(), garbage.begin() + count);
+}
+
+void FEngine::scheduleDeferredWork(void const* owner, std::function<void()> work) noexcept {
+    mDeferredWork.push_back({ owner, std::move(work) });
+}
+
+void FEngine::cancelDeferredWork(void const* owner) noexcept {
+    auto& queue = mDeferredWork;
+    queue.erase(std::remove_if(queue.begin(), queue.end(),
+            [owner](DeferredWork const& item) { return item.owner == owner; }),
+            queue.end());
+}
+
+void FEngine::runDeferredWork() noexcept {
+    auto& queue = mDeferredWork;
+    if (UTILS_LIKELY(queue.empty())) {
+        return;
+    }
+    // oldest first; at least one task runs per frame so the queue always makes progress,
+    // then as many as fit in the budget. Individual tasks are expected to be small
+    // relative to the budget. Tasks may schedule more work; it lands after the erased
+    // prefix and runs on later frames.
+    using clock = std::chrono::steady_clock;
+    auto const deadline = clock::now() + std::chrono::nanoseconds(mDeferredWorkBudgetNs);
+    size_t count = 0;
+    do {
+        queue[count++].work();
+    } while (count < queue.size() && clock::now() < deadline);
+    queue.erase(queue.begin(), queue.begin() + count);
+}
+
 // -----------------------------------------------------------------------------------------------
 
 bool FEngine::destroy(const FBufferObject* p) {
-    return terminateAndDestroy(p, mBufferObjects);
+    return terminateAndDestroyDeferred(p, mBufferObjects);
 }
 
 bool FEngine::destroy(const FVertexBuffer* p) {
-    return terminateAndDestroy(p, mVertexBuffers);
+    return terminateAndDestroyDeferred(p, mVertexBuffers);
 }
 
 bool FEngine::destroy(const FIndexBuffer* p) {
-    return terminateAndDestroy(p, mIndexBuffers);
+    return terminateAndDestroyDeferred(p, mIndexBuffers);
 }
 
 bool FEngine::destroy(const FSkinningBuffer* p) {
-    return terminateAndDestroy(p, mSkinningBuffers);
+    return terminateAndDestroyDeferred(p, mSkinningBuffers);
 }
 
 bool FEngine::destroy(const FMorphTargetBuffer* p) {
-    return terminateAndDestroy(p, mMorphTargetBuffers);
+    return terminateAndDestroyDeferred(p, mMorphTargetBuffers);
 }
 
 inline bool FEngine::destroy(const FRenderer* p) {
@@ -803,7 +1031,11 @@ inline bool FEngine::destroy(const FColorGrading* p) {
 
 UTILS_NOINLINE
 bool FEngine::destroy(const FTexture* p) {
-    return terminateAndDestroy(p, mTextures);
+    if (UTILS_UNLIKELY(p && !mTextureUploadScheduler.isEmpty())) {
+        // drop uploads still queued for this texture
+        mTextureUploadScheduler.purge(p->getHwHandle());
+    }
+    return terminateAndDestroyDeferred(p, mTextures);
 }
 
 bool FEngine::destroy(const FRenderTarget* p) {
@@ -848,6 +1080,7 @@ bool FEngine::destroy(const FMaterial* ptr) {
 
 bool FEngine::destroy(const FMaterialInstance* ptr) {
     if (ptr == nullptr) return true;
+    mParameterTrackManager.removeTracks(ptr);
     auto pos = mMaterialInstances.find(ptr->getMaterial());
     assert_invariant(pos != mMaterialInstances.cend());
     if (pos != mMaterialInstances.cend()) {
@@ -865,6 +1098,24 @@ void FEngine::destroy(Entity e) {
     mCameraManager.destroy(e);
 }
 
+void FEngine::destroyAsync(size_t n, const Entity* entities) {
+    // slice the batch so each deferred task stays small relative to the frame budget;
+    // each slice sweeps all managers for its entities in one go
+    constexpr size_t SLICE_SIZE = 64;
+    for (size_t i = 0; i < n; i += SLICE_SIZE) {
+        size_t const count = std::min(SLICE_SIZE, n - i);
+        auto slice = utils::FixedCapacityVector<Entity>::with_capacity(count);
+        for (size_t j = 0; j < count; j++) {
+            slice.push_back(entities[i + j]);
+        }
+        scheduleDeferredWork(this, [this, slice = std::move(slice)]() {
+            for (Entity const e : slice) {
+                destroy(e);
+            }
+        });
+    }
+}
+
 void* FEngine::streamAlloc(size_t size, size_t alignment) noexcept {
     // we allow this only for small allocations
     if (size > 65536) {
@@ -873,6 +1124,120 @@ void* FEngine::streamAlloc(size_t size, size_t alignment) noexcept {
     return getDriverApi().allocate(size, alignment);
 }
 
+void* FEngine::allocateStagingMemory(size_t size) noexcept {
+    if (UTILS_UNLIKELY(size == 0)) {
+        return nullptr;
+    }
+    std::unique_lock<utils::Mutex> lock(mStagingPoolLock);
+    // reuse the smallest pooled block that is large enough
+    auto& pool = mStagingPool;
+    auto pos = pool.end();
+    for (auto it = pool.begin(); it != pool.end(); ++it) {
+        if (it->second >= size && (pos == pool.end() || it->second < pos->second)) {
+            pos = it;
+        }
+    }
+    if (pos != pool.end()) {
+        // if the caller releases this block with a smaller size than its true capacity, the
+        // capacity recorded at that point is under-estimated, which is always safe
+        void* const buffer = pos->first;
+        pool.erase(pos);
+        return buffer;
+    }
+    lock.unlock();
+    return utils::aligned_alloc(size, utils::CACHELINE_SIZE);
+}
+
+void FEngine::releaseStagingMemory(void* buffer, size_t size) noexcept {
+    if (UTILS_UNLIKELY(!buffer)) {
+        return;
+    }
+    std::unique_lock<utils::Mutex> lock(mStagingPoolLock);
+    auto& pool = mStagingPool;
+    if (pool.size() >= STAGING_POOL_SIZE) {
+        // pool is full, keep the largest blocks
+        auto const pos = std::min_element(pool.begin(), pool.end(),
+                [](auto const& lhs, auto const& rhs) { return lhs.second < rhs.second; });
+        if (pos->second >= size) {
+            // our block is the smallest, free it
+            lock.unlock();
+            utils::aligned_free(buffer);
+            return;
+        }
+        void* const evicted = pos->first;
+        *pos = { buffer, size };
+        lock.unlock();
+        utils::aligned_free(evicted);
+        return;
+    }
+    pool.emplace_back(buffer, size);
+}
+
+Engine::MemoryStats FEngine::getMemoryStats() const noexcept {
+    Engine::MemoryStats stats{};
+
+    for (FTexture const* texture : mTextures) {
+        stats.textures += texture->getEstimatedByteCount();
+    }
+
+    for (FBufferObject const* bo : mBufferObjects) {
+        stats.buffers += bo->getByteCount();
+    }
+    for (FVertexBuffer const* vb : mVertexBuffers) {
+        stats.buffers += vb->getByteCount();
+    }
+    for (FIndexBuffer const* ib : mIndexBuffers) {
+        stats.buffers += ib->getByteCount();
+    }
+
+    if (mResourceAllocator) {
+        stats.renderTargets = mResourceAllocator->getMemoryUsed();
+    }
+
+    // these capacities are reserved whether used or not; the command buffer ring can
+    // grow past its initial size under bursty loads
+    stats.commandArenas = mCommandBufferQueue.getOccupancy().bufferSize
+            + CONFIG_PER_RENDER_PASS_ARENA_SIZE;
+
+    stats.total = stats.textures + stats.buffers + stats.renderTargets + stats.commandArenas;
+
+    // synchronous driver API, but it executes on the calling thread
+    stats.backendPools = const_cast<FEngine*>(this)->getDriverApi().getMemoryPoolSize();
+
+    return stats;
+}
+
+void FEngine::checkMemoryBudget() noexcept {
+    const size_t budget = mMemoryBudget;
+    if (UTILS_LIKELY(budget == 0 || mMemoryBudgetCallback == nullptr)) {
+        return;
+    }
+    Engine::MemoryStats const stats = getMemoryStats();
+    if (!mMemoryBudgetExceeded) {
+        if (UTILS_UNLIKELY(stats.total > budget)) {
+            mMemoryBudgetExceeded = true;
+            mMemoryBudgetCallback(mMemoryBudgetUser, stats);
+        }
+    } else if (stats.total < budget - budget / 10) {
+        // re-arm once usage drops well below the budget, so the callback doesn't
+        // fire every frame while the application is adjusting quality
+        mMemoryBudgetExceeded = false;
+    }
+}
+
+void FEngine::dumpMaterialVariantUsage() const noexcept {
+    // one line per material, parseable by matc's --used-variants flag; the mask is
+    // VARIANT_COUNT bits in hex, most significant word first
+    for (FMaterial const* material : mMaterials) {
+        VariantList const used = material->getUsedVariants();
+        char mask[2 * VARIANT_COUNT / 8 + 1];
+        snprintf(mask, sizeof(mask), "%016" PRIx64 "%016" PRIx64,
+                used.getBitsAt(1), used.getBitsAt(0));
+        slog.i << "variant-usage \"" << material->getName().c_str() << "\" "
+               << mask << io::endl;
+    }
+}
+
 bool FEngine::execute() {
 
     // wait until we get command buffers to be executed (or thread exit requested)
@@ -1058,6 +1423,10 @@ void Engine::destroy(Entity e) {
     upcast(this)->destroy(e);
 }
 
+void Engine::destroyAsync(size_t n, const Entity* entities) {
+    upcast(this)->destroyAsync(n, entities);
+}
+
 void Engine::flushAndWait() {
     upcast(this)->flushAndWait();
 }
@@ -1066,6 +1435,18 @@ void Engine::flush() {
     upcast(this)->flush();
 }
 
+Engine::SyncToken Engine::insertToken() {
+    return upcast(this)->insertToken();
+}
+
+bool Engine::isTokenSignaled(SyncToken token) const noexcept {
+    return upcast(this)->isTokenSignaled(token);
+}
+
+void Engine::waitForToken(SyncToken token) {
+    upcast(this)->waitForToken(token);
+}
+
 utils::EntityManager& Engine::getEntityManager() noexcept {
     return upcast(this)->getEntityManager();
 }
@@ -1090,6 +1471,14 @@ void* Engine::streamAlloc(size_t size, size_t alignment) noexcept {
     return upcast(this)->streamAlloc(size, alignment);
 }
 
+void* Engine::allocateStagingMemory(size_t size) noexcept {
+    return upcast(this)->allocateStagingMemory(size);
+}
+
+void Engine::releaseStagingMemory(void* buffer, size_t size, void* user) {
+    upcast(static_cast<Engine*>(user))->releaseStagingMemory(buffer, size);
+}
+
 // The external-facing execute does a flush, and is meant only for single-threaded environments.
 // It also discards the boolean return value, which would otherwise indicate a thread exit.
 void Engine::execute() {
@@ -1110,4 +1499,82 @@ void Engine::pumpMessageQueues() {
     upcast(this)->pumpMessageQueues();
 }
 
+void Engine::setProgramBinaryCacheDirectory(const char* path) noexcept {
+    upcast(this)->setProgramBinaryCacheDirectory(path);
+}
+
+backend::HandleAllocatorStats Engine::getHandleAllocatorStats() noexcept {
+    return upcast(this)->getHandleAllocatorStats();
+}
+
+Engine::MemoryStats Engine::getMemoryStats() const noexcept {
+    return upcast(this)->getMemoryStats();
+}
+
+void Engine::setMemoryBudget(size_t budget, MemoryBudgetCallback callback, void* user) noexcept {
+    upcast(this)->setMemoryBudget(budget, callback, user);
+}
+
+void Engine::setDestroyReclaimWatermark(size_t watermark) noexcept {
+    upcast(this)->setDestroyReclaimWatermark(watermark);
+}
+
+size_t Engine::getDestroyReclaimWatermark() const noexcept {
+    return upcast(this)->getDestroyReclaimWatermark();
+}
+
+void Engine::setDeferredWorkBudget(uint32_t budgetMicroseconds) noexcept {
+    upcast(this)->setDeferredWorkBudget(budgetMicroseconds);
+}
+
+uint32_t Engine::getDeferredWorkBudget() const noexcept {
+    return upcast(this)->getDeferredWorkBudget();
+}
+
+void Engine::setThermalGovernorEnabled(bool enabled,
+        ThermalQualityCallback callback, void* user) noexcept {
+    upcast(this)->getQualityGovernor().setEnabled(enabled, callback, user);
+}
+
+bool Engine::isThermalGovernorEnabled() const noexcept {
+    return upcast(this)->getQualityGovernor().isEnabled();
+}
+
+uint8_t Engine::getThermalQualityReduction() const noexcept {
+    return upcast(this)->getQualityGovernor().getQualityReduction();
+}
+
+Engine::ParameterTrack Engine::addParameterTrack(MaterialInstance* instance, const char* name,
+        float const* times, float const* values, size_t keyframeCount,
+        size_t componentCount, bool loop) noexcept {
+    return upcast(this)->addParameterTrack(upcast(instance), name,
+            times, values, keyframeCount, componentCount, loop);
+}
+
+void Engine::removeParameterTrack(ParameterTrack track) noexcept {
+    upcast(this)->removeParameterTrack(track);
+}
+
+void Engine::setParameterTrackTime(double time) noexcept {
+    upcast(this)->setParameterTrackTime(time);
+}
+
+void Engine::setTextureUploadBudget(uint32_t bytesPerFrame) noexcept {
+    upcast(this)->getTextureUploadScheduler().setBudget(bytesPerFrame);
+}
+
+uint32_t Engine::getTextureUploadBudget() const noexcept {
+    return upcast(this)->getTextureUploadScheduler().getBudget();
+}
+
+backend::PixelBufferDescriptor Engine::createStagingPixelBuffer(size_t size,
+        backend::PixelDataFormat format, backend::PixelDataType type,
+        uint8_t alignment) noexcept {
+    return upcast(this)->getStagingBufferPool().acquire(size, format, type, alignment);
+}
+
+void Engine::setStagingBufferPoolCapacity(size_t bytes) noexcept {
+    upcast(this)->getStagingBufferPool().setCapacity(bytes);
+}
+
 } // namespace filament
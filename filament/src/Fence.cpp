@@ -23,6 +23,10 @@
 #include <utils/Panic.h>
 #include <utils/debug.h>
 
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
 namespace filament {
 
 using namespace backend;
@@ -35,8 +39,87 @@ static const constexpr uint64_t PUMP_INTERVAL_MILLISECONDS = 1;
 using ms = std::chrono::milliseconds;
 using ns = std::chrono::nanoseconds;
 
+// ------------------------------------------------------------------------------------------------
+
+// Small-block pool backing the FenceSignal allocations. Streaming systems create hundreds of
+// fences per second, and each one used to cost two heap allocations (the signal object and its
+// shared_ptr control block); with allocate_shared below both live in a single block, which is
+// recycled here. All blocks have the same size, fixed at compile time by the single
+// allocate_shared<> call site, so a simple free list suffices.
+class FenceSignalPool {
+public:
+    static FenceSignalPool& get() noexcept {
+        static FenceSignalPool sPool;
+        return sPool;
+    }
+
+    void* acquire(size_t size) noexcept {
+        std::unique_lock<utils::Mutex> lock(mLock);
+        if (UTILS_LIKELY(!mFreeList.empty())) {
+            assert_invariant(size == mBlockSize);
+            void* const p = mFreeList.back();
+            mFreeList.pop_back();
+            return p;
+        }
+        mBlockSize = size;
+        lock.unlock();
+        return ::malloc(size);
+    }
+
+    void release(void* p) noexcept {
+        std::unique_lock<utils::Mutex> lock(mLock);
+        if (UTILS_LIKELY(mFreeList.size() < CACHE_CAPACITY)) {
+            mFreeList.push_back(p);
+            return;
+        }
+        lock.unlock();
+        ::free(p);
+    }
+
+private:
+    // enough for a deep streaming pipeline; beyond this, blocks go back to the heap
+    static constexpr size_t CACHE_CAPACITY = 256;
+
+    FenceSignalPool() { mFreeList.reserve(CACHE_CAPACITY); }
+    ~FenceSignalPool() {
+        for (void* p : mFreeList) {
+            ::free(p);
+        }
+    }
+
+    utils::Mutex mLock;
+    std::vector<void*> mFreeList;
+    size_t mBlockSize = 0;
+};
+
+template<typename T>
+struct FenceSignalAllocator {
+    using value_type = T;
+    FenceSignalAllocator() noexcept = default;
+    template<typename U>
+    FenceSignalAllocator(FenceSignalAllocator<U> const&) noexcept {}
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(FenceSignalPool::get().acquire(n * sizeof(T)));
+    }
+    void deallocate(T* p, std::size_t) noexcept {
+        FenceSignalPool::get().release(p);
+    }
+};
+
+template<typename T, typename U>
+inline bool operator==(FenceSignalAllocator<T> const&, FenceSignalAllocator<U> const&) noexcept {
+    return true;
+}
+template<typename T, typename U>
+inline bool operator!=(FenceSignalAllocator<T> const&, FenceSignalAllocator<U> const&) noexcept {
+    return false;
+}
+
+// ------------------------------------------------------------------------------------------------
+
 FFence::FFence(FEngine& engine, Type type)
-    : mEngine(engine), mFenceSignal(std::make_shared<FenceSignal>(type)) {
+    : mEngine(engine), mFenceSignal(
+            std::allocate_shared<FenceSignal>(FenceSignalAllocator<FenceSignal>{}, type)) {
     DriverApi& driverApi = engine.getDriverApi();
     if (type == Type::HARD) {
         mFenceHandle = driverApi.createFence();
@@ -117,12 +200,18 @@ FenceStatus FFence::wait(Mode mode, uint64_t timeout) noexcept {
 UTILS_NOINLINE
 void FFence::FenceSignal::signal(State s) noexcept {
     std::lock_guard<utils::Mutex> lock(FFence::sLock);
-    mState = s;
+    mState.store(s, std::memory_order_release);
     FFence::sCondition.notify_all();
 }
 
 UTILS_NOINLINE
 Fence::FenceStatus FFence::FenceSignal::wait(uint64_t timeout) noexcept {
+    // Fast path: once the command stream has signaled, waiting is a single atomic check. This
+    // is the common case for frame-level waits (e.g. Fence::waitAndDestroy a frame after the
+    // fence was created), and it avoids the lock and condition variable entirely.
+    if (mState.load(std::memory_order_acquire) != UNSIGNALED) {
+        return FenceStatus::CONDITION_SATISFIED;
+    }
     std::unique_lock<utils::Mutex> lock(FFence::sLock);
     while (mState == UNSIGNALED) {
         if (mState == DESTROYED) {
@@ -28,6 +28,11 @@ namespace filament {
 struct FrameHistoryEntry {
     FrameGraphTexture color;
     FrameGraphTexture::Descriptor colorDesc;
+    FrameGraphTexture ssao;     // AO buffer kept across frames, see AmbientOcclusionOptions::updateInterval
+    FrameGraphTexture::Descriptor ssaoDesc;
+    FrameGraphTexture adaptedLuminance; // 1x1 log-luminance kept across frames for auto-exposure
+    FrameGraphTexture::Descriptor adaptedLuminanceDesc;
+    uint32_t ssaoAge = 0;       // frames since the AO buffer was last computed
     math::mat4f projection;     // world space to clip space
     math::float2 jitter{};
     uint32_t frameId = 0;
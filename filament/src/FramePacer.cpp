@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "FramePacer.h"
+
+#include "details/Engine.h"
+#include "details/Fence.h"
+
+namespace filament {
+
+using namespace backend;
+
+void FramePacer::terminate(FEngine& engine) noexcept {
+    if (mFrameFence) {
+        engine.destroy(mFrameFence);
+        mFrameFence = nullptr;
+    }
+}
+
+void FramePacer::beginFrame(FEngine& engine,
+        Renderer::FramePacingOptions const& options) noexcept {
+    FFence* const fence = mFrameFence;
+    if (fence) {
+        FenceStatus status;
+        if (options.mode == Renderer::FramePacingOptions::Mode::LOW_LATENCY) {
+            // Block until the GPU has caught up with the previous frame, so that at most one
+            // frame is in flight and the input sampled after we return is consumed by the very
+            // next frame. The target latency bounds how long we're willing to block -- if the
+            // GPU can't keep up within that budget there is no point delaying input sampling
+            // further, the latency target is already blown.
+            const float targetMs = options.targetLatencyMilliseconds;
+            const uint64_t timeout = targetMs > 0.0f ?
+                    uint64_t(targetMs * 1e6f) : Fence::FENCE_WAIT_FOR_EVER;
+            status = fence->wait(Fence::Mode::FLUSH, timeout);
+        } else {
+            // just poll, so the latency measurement below stays available
+            status = fence->wait(Fence::Mode::DONT_FLUSH, 0);
+        }
+        if (status == FenceStatus::CONDITION_SATISFIED) {
+            mMeasuredLatency = clock::now() - mInputSampleTime;
+        }
+        engine.destroy(fence);
+        mFrameFence = nullptr;
+    }
+    // the application samples its input right after beginFrame() returns
+    mInputSampleTime = clock::now();
+}
+
+void FramePacer::endFrame(FEngine& engine) noexcept {
+    // if beginFrame() was skipped (e.g. the frame was rendered despite FrameSkipper saying
+    // no), an unconsumed fence can still be here
+    if (UTILS_UNLIKELY(mFrameFence)) {
+        engine.destroy(mFrameFence);
+    }
+    // signals when the GPU (not just the driver thread) is done with this frame
+    mFrameFence = engine.createFence(FFence::Type::HARD);
+}
+
+} // namespace filament
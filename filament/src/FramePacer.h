@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_DETAILS_FRAMEPACER_H
+#define TNT_FILAMENT_DETAILS_FRAMEPACER_H
+
+#include <filament/Renderer.h>
+
+#include <chrono>
+
+namespace filament {
+
+class FEngine;
+class FFence;
+
+/*
+ * FramePacer implements Renderer::FramePacingOptions. While FrameSkipper only decides whether
+ * a frame should be dropped when the GPU is running behind, FramePacer controls *when*
+ * beginFrame() returns: in low-latency mode it blocks until the GPU has caught up with the
+ * previous frame, so the input sampled right after beginFrame() is at most one frame away
+ * from the pixels it produces. It also measures the time between that sampling point and
+ * the GPU finishing the frame, which is the controllable part of motion-to-photon latency.
+ */
+class FramePacer {
+public:
+    using clock = std::chrono::steady_clock;
+
+    void terminate(FEngine& engine) noexcept;
+
+    // Called at the end of Renderer::beginFrame(), i.e. just before the application samples
+    // its input. May block, depending on the mode.
+    void beginFrame(FEngine& engine, Renderer::FramePacingOptions const& options) noexcept;
+
+    // Called from Renderer::endFrame(); creates the fence that tracks this frame's completion.
+    void endFrame(FEngine& engine) noexcept;
+
+    // Latest measured duration between beginFrame() returning and the GPU finishing the
+    // corresponding frame. Exact in low-latency mode; an upper bound (quantized to the
+    // frame cadence) otherwise. Zero until a first frame has been measured.
+    clock::duration getMeasuredLatency() const noexcept { return mMeasuredLatency; }
+
+private:
+    FFence* mFrameFence = nullptr;          // tracks completion of the last submitted frame
+    clock::time_point mInputSampleTime{};   // when beginFrame() returned for that frame
+    clock::duration mMeasuredLatency{};
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_DETAILS_FRAMEPACER_H
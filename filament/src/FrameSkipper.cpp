@@ -21,6 +21,8 @@
 #include <utils/Log.h>
 #include <utils/debug.h>
 
+#include <algorithm>
+
 namespace filament {
 
 using namespace utils;
@@ -41,13 +43,52 @@ void FrameSkipper::terminate(DriverApi& driver) noexcept {
     }
 }
 
-bool FrameSkipper::beginFrame(DriverApi& driver) noexcept {
+void FrameSkipper::updateLoadModel(duration gpuFrameTime, duration refreshPeriod) noexcept {
+    if (gpuFrameTime.count() <= 0.0f || refreshPeriod.count() <= 0.0f) {
+        return;
+    }
+
+    // EWMA of the GPU frame cost; the relatively large weight favors reacting to load
+    // spikes over smoothing them away.
+    constexpr float alpha = 0.25f;
+    float ewma = mGpuFrameTimeEwma.count();
+    ewma = (ewma <= 0.0f) ? gpuFrameTime.count() : ewma + alpha * (gpuFrameTime.count() - ewma);
+    mGpuFrameTimeEwma = duration{ ewma };
+
+    // How many refresh periods each frame is predicted to need. The hysteresis band keeps
+    // the cadence from oscillating between two divisors -- that oscillation is precisely
+    // the judder the reactive fence check can't avoid.
+    float const load = ewma / refreshPeriod.count();
+    uint32_t interval = mPredictedInterval;
+    if (load > float(interval) * 1.05f) {
+        interval++;
+    } else if (interval > 1 && load < float(interval - 1) * 0.85f) {
+        interval--;
+    }
+    mPredictedInterval = std::min(interval, MAX_PREDICTED_INTERVAL);
+}
+
+bool FrameSkipper::beginFrame(DriverApi& driver, bool predictive) noexcept {
+    mStats.totalFrames++;
+
+    if (UTILS_UNLIKELY(predictive && mPredictedInterval > 1)) {
+        // With the GPU predicted to need N refresh periods per frame, accept only every Nth
+        // vsync so presents land on a steady divisor cadence, instead of whenever a fence
+        // happens to miss.
+        if ((mStats.totalFrames % mPredictedInterval) != 0) {
+            mStats.skippedFrames++;
+            mStats.predictedSkips++;
+            return false;
+        }
+    }
+
     auto& syncs = mDelayedSyncs;
     auto sync = syncs.front();
     if (sync) {
         auto status = driver.getSyncStatus(sync);
         if (status == SyncStatus::NOT_SIGNALED) {
             // Sync not ready, skip frame
+            mStats.skippedFrames++;
             return false;
         }
         driver.destroySync(sync);
@@ -17,32 +17,54 @@
 #ifndef TNT_FILAMENT_DETAILS_FRAMESKIPPER_H
 #define TNT_FILAMENT_DETAILS_FRAMESKIPPER_H
 
+#include <filament/Renderer.h>
+
 #include <backend/Handle.h>
 #include <private/backend/DriverApi.h>
 
 #include <array>
+#include <chrono>
 
 namespace filament {
 
 class FrameSkipper {
     static constexpr size_t MAX_FRAME_LATENCY = 4;
+    static constexpr uint32_t MAX_PREDICTED_INTERVAL = 4;
 public:
+    using duration = std::chrono::duration<float, std::milli>;
+    using SkipStats = Renderer::SkipStats;
+
     explicit FrameSkipper(size_t latency = 2) noexcept;
     ~FrameSkipper() noexcept;
 
     void terminate(backend::DriverApi& driver) noexcept;
 
-    // returns false if we need to skip this frame, because the gpu is running behind the cpu.
+    // Feeds the GPU load model with the measured GPU cost of the last completed frame.
+    // Call once per frame, before beginFrame().
+    void updateLoadModel(duration gpuFrameTime, duration refreshPeriod) noexcept;
+
+    // returns false if we need to skip this frame, either because the gpu is running behind
+    // the cpu, or -- when predictive is set -- because the load model decided to skip it
+    // proactively to keep presents on a steady cadence.
     // in that case, don't call endFrame().
     // returns true if rendering can proceed. Always call endFrame() when done.
-    bool beginFrame(backend::DriverApi& driver) noexcept;
+    bool beginFrame(backend::DriverApi& driver, bool predictive = false) noexcept;
 
     void endFrame(backend::DriverApi& driver) noexcept;
 
+    SkipStats getStats() const noexcept {
+        SkipStats stats = mStats;
+        stats.predictedGpuFrameTimeMilliseconds = mGpuFrameTimeEwma.count();
+        return stats;
+    }
+
 private:
     using Container = std::array<backend::Handle<backend::HwSync>, MAX_FRAME_LATENCY>;
     mutable Container mDelayedSyncs{};
     size_t mLast;
+    duration mGpuFrameTimeEwma{};
+    uint32_t mPredictedInterval = 1;    // refresh periods per frame the model asks for
+    SkipStats mStats{};
 };
 
 } // namespace filament
@@ -26,9 +26,12 @@
 #include <filament/Viewport.h>
 
 #include <utils/BinaryTreeArray.h>
+#include <utils/Hash.h>
 #include <utils/Systrace.h>
 #include <utils/debug.h>
 
+#include <tsl/robin_map.h>
+
 #include <math/mat4.h>
 #include <math/fast.h>
 #include <math/scalar.h>
@@ -122,6 +125,18 @@ void Froxelizer::setOptions(float zLightNear, float zLightFar) noexcept {
 }
 
 
+void Froxelizer::setFroxelBufferEntryCount(size_t count) noexcept {
+    count = clamp(count, size_t(512), FROXEL_BUFFER_ENTRY_COUNT_MAX);
+    // round down to a power-of-two by clearing the low bits one by one
+    while (count & (count - 1)) {
+        count &= count - 1;
+    }
+    if (UTILS_UNLIKELY(mFroxelBufferEntryCount != count)) {
+        mFroxelBufferEntryCount = uint16_t(count);
+        mDirtyFlags |= VIEWPORT_CHANGED;
+    }
+}
+
 void Froxelizer::setViewport(filament::Viewport const& viewport) noexcept {
     if (UTILS_UNLIKELY(mViewport != viewport)) {
         mViewport = viewport;
@@ -146,6 +161,8 @@ bool Froxelizer::prepare(
     bool uniformsNeedUpdating = false;
     if (UTILS_UNLIKELY(mDirtyFlags)) {
         uniformsNeedUpdating = update();
+        // the grid or projection changed, the retained froxel data is stale
+        mFroxelsInvalidated = true;
     }
 
     /*
@@ -191,17 +208,17 @@ bool Froxelizer::prepare(
 
 void Froxelizer::computeFroxelLayout(
         uint2* dim, uint16_t* countX, uint16_t* countY, uint16_t* countZ,
-        filament::Viewport const& viewport) noexcept {
+        size_t froxelBufferEntryCount, filament::Viewport const& viewport) noexcept {
 
     auto roundTo8 = [](uint32_t v) { return (v + 7u) & ~7u; };
 
     const uint32_t width  = std::max(16u, viewport.width);
     const uint32_t height = std::max(16u, viewport.height);
 
-    // calculate froxel dimension from FROXEL_BUFFER_ENTRY_COUNT_MAX and viewport
+    // calculate froxel dimension from the froxel budget and viewport
     // - Start from the maximum number of froxels we can use in the x-y plane
     size_t froxelSliceCount = FEngine::CONFIG_FROXEL_SLICE_COUNT;
-    size_t froxelPlaneCount = FROXEL_BUFFER_ENTRY_COUNT_MAX / froxelSliceCount;
+    size_t froxelPlaneCount = froxelBufferEntryCount / froxelSliceCount;
     // - compute the number of square froxels we need in width and height, rounded down
     //   solving: |  froxelCountX * froxelCountY == froxelPlaneCount
     //            |  froxelCountX / froxelCountY == width / height
@@ -238,7 +255,8 @@ bool Froxelizer::update() noexcept {
 
         uint2 froxelDimension;
         uint16_t froxelCountX, froxelCountY, froxelCountZ;
-        computeFroxelLayout(&froxelDimension, &froxelCountX, &froxelCountY, &froxelCountZ, viewport);
+        computeFroxelLayout(&froxelDimension, &froxelCountX, &froxelCountY, &froxelCountZ,
+                mFroxelBufferEntryCount, viewport);
 
         mFroxelDimension = froxelDimension;
         mClipToFroxelX = (0.5f * viewport.width)  / froxelDimension.x;
@@ -252,7 +270,7 @@ bool Froxelizer::update() noexcept {
                << froxelDimension.x << "x" << froxelDimension.y << io::endl
                << "Froxel: " << froxelCountX << "x" << froxelCountY << "x" << froxelCountZ
                << " = " << (froxelCountX * froxelCountY * froxelCountZ)
-               << " (" << FROXEL_BUFFER_ENTRY_COUNT_MAX - froxelCountX * froxelCountY * froxelCountZ << " lost)"
+               << " (" << mFroxelBufferEntryCount - froxelCountX * froxelCountY * froxelCountZ << " lost)"
                << io::endl;
 #endif
 
@@ -492,15 +510,29 @@ std::pair<size_t, size_t> Froxelizer::clipToIndices(float2 const& clip) const no
 
 
 void Froxelizer::commit(backend::DriverApi& driverApi) {
-    // send data to GPU
+    if (UTILS_LIKELY(!mUploadNeeded)) {
+        // neither the lights nor the froxel grid changed since the previous upload,
+        // the GPU-side buffers still hold valid data
+        return;
+    }
+    mUploadNeeded = false;
+
+    // send data to GPU -- only the rows covering froxels actually in use, the shader
+    // never addresses the texture past the froxel count
+    const size_t rowCount = (mFroxelCount + FROXEL_BUFFER_WIDTH_MASK) / FROXEL_BUFFER_WIDTH;
     driverApi.update2DImage(mFroxelTexture, 0, 0, 0,
-            FROXEL_BUFFER_WIDTH, FROXEL_BUFFER_HEIGHT,{
-                    mFroxelBufferUser.begin(), mFroxelBufferUser.sizeInBytes(),
+            FROXEL_BUFFER_WIDTH, uint32_t(rowCount), {
+                    mFroxelBufferUser.begin(),
+                    rowCount * FROXEL_BUFFER_WIDTH * sizeof(FroxelEntry),
                     PixelBufferDescriptor::PixelDataFormat::RG_INTEGER,
                     PixelBufferDescriptor::PixelDataType::USHORT });
 
-    driverApi.updateBufferObject(mRecordsBuffer,
-            { mRecordBufferUser.data(), RECORD_BUFFER_ENTRY_COUNT }, 0);
+    // only the prefix of the record buffer actually referenced by froxels needs to go up;
+    // with record sharing this is typically a small fraction of the full buffer
+    if (mRecordBufferUsed) {
+        driverApi.updateBufferObject(mRecordsBuffer,
+                { mRecordBufferUser.data(), mRecordBufferUsed * sizeof(RecordBufferType) }, 0);
+    }
 
 #ifndef NDEBUG
     mFroxelBufferUser.clear();
@@ -513,8 +545,59 @@ void Froxelizer::froxelizeLights(FEngine& engine,
         CameraInfo const& UTILS_RESTRICT camera,
         const FScene::LightSoa& UTILS_RESTRICT lightData) noexcept {
     // note: this is called asynchronously
-    froxelizeLoop(engine, camera, lightData);
-    froxelizeAssignRecordsCompress();
+
+    /*
+     * Precompute each light's view-space parameters. Besides hoisting this work out of
+     * the froxelization jobs, it lets us detect that neither the lights nor the camera
+     * changed since the last frame -- everything froxelization consumes is encoded in
+     * these parameters (plus the grid/projection state, tracked by mFroxelsInvalidated) --
+     * in which case the retained froxel data and the GPU buffers are still valid and
+     * both the rebuild and the upload can be skipped.
+     */
+
+    auto& lcm = engine.getLightManager();
+    auto const* UTILS_RESTRICT spheres      = lightData.data<FScene::POSITION_RADIUS>();
+    auto const* UTILS_RESTRICT directions   = lightData.data<FScene::DIRECTION>();
+    auto const* UTILS_RESTRICT instances    = lightData.data<FScene::LIGHT_INSTANCE>();
+
+    // We use minimum cone angle of 0.5 degrees because too small angles cause issues in the
+    // sphere/cone intersection test, due to floating-point precision.
+    constexpr float maxInvSin = 114.59301f;         // 1 / sin(0.5 degrees)
+    constexpr float maxCosSquared = 0.99992385f;    // cos(0.5 degrees)^2
+
+    const mat3f vn = camera.view.upperLeft();
+    const size_t count = lightData.size() - FScene::DIRECTIONAL_LIGHTS_COUNT;
+    auto lightParams = utils::FixedCapacityVector<LightParams>::with_capacity(count);
+    for (size_t i = 0; i < count; i++) {
+        const size_t j = i + FScene::DIRECTIONAL_LIGHTS_COUNT;
+        FLightManager::Instance li = instances[j];
+        LightParams light = {
+                .position = (camera.view * float4{ spheres[j].xyz, 1 }).xyz, // to view-space
+                .cosSqr = std::min(maxCosSquared, lcm.getCosOuterSquared(li)),  // spot only
+                .axis = vn * directions[j],                                     // spot only
+                .invSin = lcm.getSinInverse(li),                                // spot only
+                .radius = spheres[j].w,
+        };
+        // infinity means "pointlight"
+        if (light.invSin != std::numeric_limits<float>::infinity()) {
+            light.invSin = std::min(maxInvSin, light.invSin);
+        }
+        lightParams.push_back(light);
+    }
+
+    const bool lightsChanged = lightParams.size() != mLastLightParams.size()
+            || (count > 0 && memcmp(lightParams.data(), mLastLightParams.data(),
+                    count * sizeof(LightParams)) != 0);
+
+    if (UTILS_LIKELY(!mFroxelsInvalidated && !lightsChanged)) {
+        return;
+    }
+    mFroxelsInvalidated = false;
+    mLastLightParams = std::move(lightParams);
+
+    froxelizeLoop(engine, mLastLightParams);
+    froxelizeAssignRecordsCompress(engine);
+    mUploadNeeded = true;
 
 #ifndef NDEBUG
     if (lightData.size()) {
@@ -541,51 +624,24 @@ void Froxelizer::froxelizeLights(FEngine& engine,
 }
 
 void Froxelizer::froxelizeLoop(FEngine& engine,
-        const CameraInfo& UTILS_RESTRICT camera,
-        const FScene::LightSoa& UTILS_RESTRICT lightData) noexcept {
+        utils::FixedCapacityVector<LightParams> const& lightParams) noexcept {
     SYSTRACE_CALL();
 
     Slice<FroxelThreadData> froxelThreadData = mFroxelShardedData;
     memset(froxelThreadData.data(), 0, froxelThreadData.sizeInBytes());
 
-    auto& lcm = engine.getLightManager();
-    auto const* UTILS_RESTRICT spheres      = lightData.data<FScene::POSITION_RADIUS>();
-    auto const* UTILS_RESTRICT directions   = lightData.data<FScene::DIRECTION>();
-    auto const* UTILS_RESTRICT instances    = lightData.data<FScene::LIGHT_INSTANCE>();
-
-    auto process = [ this, &froxelThreadData,
-                     spheres, directions, instances, &camera, &lcm ]
+    auto process = [ this, &froxelThreadData, lights = lightParams.data() ]
             (size_t count, size_t offset, size_t stride) {
 
         const mat4f& projection = mProjection;
-        const mat3f& vn = camera.view.upperLeft();
-
-        // We use minimum cone angle of 0.5 degrees because too small angles cause issues in the
-        // sphere/cone intersection test, due to floating-point precision.
-        constexpr float maxInvSin = 114.59301f;         // 1 / sin(0.5 degrees)
-        constexpr float maxCosSquared = 0.99992385f;    // cos(0.5 degrees)^2
 
         for (size_t i = offset; i < count; i += stride) {
-            const size_t j = i + FScene::DIRECTIONAL_LIGHTS_COUNT;
-            FLightManager::Instance li = instances[j];
-            LightParams light = {
-                    .position = (camera.view * float4{ spheres[j].xyz, 1 }).xyz, // to view-space
-                    .cosSqr = std::min(maxCosSquared, lcm.getCosOuterSquared(li)),  // spot only
-                    .axis = vn * directions[j],                                     // spot only
-                    .invSin = lcm.getSinInverse(li),                                // spot only
-                    .radius = spheres[j].w,
-            };
-            // infinity means "pointlight"
-            if (light.invSin != std::numeric_limits<float>::infinity()) {
-                light.invSin = std::min(maxInvSin, light.invSin);
-            }
-
             const size_t group = i % GROUP_COUNT;
             const size_t bit   = i / GROUP_COUNT;
             assert_invariant(bit < LIGHT_PER_GROUP);
 
             FroxelThreadData& threadData = froxelThreadData[group];
-            froxelizePointAndSpotLight(threadData, bit, projection, light);
+            froxelizePointAndSpotLight(threadData, bit, projection, lights[i]);
         }
     };
 
@@ -597,17 +653,17 @@ void Froxelizer::froxelizeLoop(FEngine& engine,
         auto *parent = js.createJob();
         for (size_t i = 0; i < GROUP_COUNT; i++) {
             js.run(jobs::createJob(js, parent, std::cref(process),
-                    lightData.size() - FScene::DIRECTIONAL_LIGHTS_COUNT, i, GROUP_COUNT));
+                    lightParams.size(), i, GROUP_COUNT));
         }
         js.runAndWait(parent);
     } else {
         js.runAndWait(jobs::createJob(js, nullptr, std::cref(process),
-                lightData.size() - FScene::DIRECTIONAL_LIGHTS_COUNT, 0, 1)
+                lightParams.size(), 0, 1)
         );
     }
 }
 
-void Froxelizer::froxelizeAssignRecordsCompress() noexcept {
+void Froxelizer::froxelizeAssignRecordsCompress(FEngine& engine) noexcept {
 
     SYSTRACE_CALL();
 
@@ -617,24 +673,50 @@ void Froxelizer::froxelizeAssignRecordsCompress() noexcept {
     // easily compare adjacent froxels, for compaction. The conversion loops below get
     // inlined and vectorized in release builds.
 
-    // this gets very well vectorized...
+    // this gets very well vectorized, but with several hundred lights it's still a
+    // significant amount of serial work, so we spread it over tiles of froxels processed
+    // as independent jobs. Each job also computes a partial union of the light bits it
+    // has seen; those partials are merged below once all jobs have completed.
+
+    // tile size and count; CountSplitter below always splits in half down to TILE_SIZE,
+    // so each job processes exactly one tile and tiles never overlap.
+    constexpr uint32_t TILE_SIZE  = 512;
+    constexpr uint32_t TILE_COUNT = FROXEL_BUFFER_ENTRY_COUNT_MAX / TILE_SIZE;
+    static_assert(FROXEL_BUFFER_ENTRY_COUNT_MAX % TILE_SIZE == 0);
+
+    LightRecord::bitset partialLights[TILE_COUNT] = {};
 
     utils::Slice<LightRecord> records(mLightRecords);
-    for (size_t j = 0, jc = FROXEL_BUFFER_ENTRY_COUNT_MAX; j < jc; j++) {
-        for (size_t i = 0; i < LightRecord::bitset::WORLD_COUNT; i++) {
-            using container_type = LightRecord::bitset::container_type;
-            constexpr size_t r = sizeof(container_type) / sizeof(LightGroupType);
-            container_type b = froxelThreadData[i * r][j];
-            for (size_t k = 0; k < r; k++) {
-                b |= (container_type(froxelThreadData[i * r + k][j]) << (LIGHT_PER_GROUP * k));
+    auto convert = [froxelThreadData, records = records.data(), &partialLights]
+            (uint32_t start, uint32_t count) {
+        assert_invariant(start % TILE_SIZE == 0 && count == TILE_SIZE);
+        LightRecord::bitset tileLights{};
+        for (size_t j = start, jc = start + count; j < jc; j++) {
+            for (size_t i = 0; i < LightRecord::bitset::WORLD_COUNT; i++) {
+                using container_type = LightRecord::bitset::container_type;
+                constexpr size_t r = sizeof(container_type) / sizeof(LightGroupType);
+                container_type b = froxelThreadData[i * r][j];
+                for (size_t k = 0; k < r; k++) {
+                    b |= (container_type(froxelThreadData[i * r + k][j]) << (LIGHT_PER_GROUP * k));
+                }
+                records[j].lights.getBitsAt(i) = b;
+                tileLights.getBitsAt(i) |= b;
             }
-            records[j].lights.getBitsAt(i) = b;
         }
-    }
+        partialLights[start / TILE_SIZE] = tileLights;
+    };
+
+    // only convert up to the froxel budget; unused tiles keep their zero-initialized
+    // partials. The budget is a power-of-two >= TILE_SIZE, so CountSplitter's halving
+    // always produces whole, aligned tiles.
+    assert_invariant(mFroxelBufferEntryCount % TILE_SIZE == 0);
+    JobSystem& js = engine.getJobSystem();
+    js.runAndWait(jobs::parallel_for(js, nullptr, 0, uint32_t(mFroxelBufferEntryCount),
+            std::cref(convert), jobs::CountSplitter<TILE_SIZE, 4>()));
 
     LightRecord::bitset allLights{};
-    for (size_t j = 0, jc = FROXEL_BUFFER_ENTRY_COUNT_MAX; j < jc; j++) {
-        allLights |= records[j].lights;
+    for (auto const& partial : partialLights) {
+        allLights |= partial;
     }
 
     uint16_t offset = 0;
@@ -661,6 +743,15 @@ void Froxelizer::froxelizeAssignRecordsCompress() noexcept {
     // how many froxel record entries were reused (for debugging)
     UTILS_UNUSED size_t reused = 0;
 
+    // Froxels anywhere in the grid with an identical light set share a single span of the
+    // record buffer. The left/above neighbor checks in the loop below catch contiguous
+    // repeats for free; this map catches the distant ones (e.g. the symmetric halves of the
+    // grid around a centered light), which shrinks the used portion of the record buffer and
+    // largely avoids the out-of-space fallback.
+    tsl::robin_map<LightRecord::bitset, uint32_t,
+            utils::hash::MurmurHashFn<LightRecord::bitset>> sharedRecords;
+    sharedRecords.reserve(256);
+
     for (size_t i = 0, c = getFroxelCount(); i < c;) {
         LightRecord b = records[i];
         if (b.lights.none()) {
@@ -676,35 +767,40 @@ void Froxelizer::froxelizeAssignRecordsCompress() noexcept {
         };
         const size_t lightCount = entry.count;
 
-        if (UTILS_UNLIKELY(offset + lightCount >= RECORD_BUFFER_ENTRY_COUNT)) {
+        auto const it = sharedRecords.find(b.lights);
+        if (it != sharedRecords.end()) {
+            // this exact light set was already filed, point at the existing span
+            entry.u32 = it->second;
+        } else {
+            if (UTILS_UNLIKELY(offset + lightCount >= RECORD_BUFFER_ENTRY_COUNT)) {
 #ifndef NDEBUG
-            slog.d << "out of space: " << i << ", at " << offset << io::endl;
+                slog.d << "out of space: " << i << ", at " << offset << io::endl;
 #endif
-            // note: instead of dropping froxels we could look for similar records we've already
-            // filed up.
-            do {
-                froxels[i] = { .offset = 0, .count = allLightsCount };
-                if (records[i].lights.none()) {
-                    froxels[i].u32 = 0;
-                }
-            } while(++i < c);
-            goto out_of_memory;
-        }
+                do {
+                    froxels[i] = { .offset = 0, .count = allLightsCount };
+                    if (records[i].lights.none()) {
+                        froxels[i].u32 = 0;
+                    }
+                } while(++i < c);
+                goto out_of_memory;
+            }
 
-        // iterate the bitfield
-        auto * const beginPoint = froxelRecords + offset;
-        b.lights.forEachSetBit([point = beginPoint, beginPoint](size_t l) mutable {
-            // make sure to keep this code branch-less
-            const size_t word = l / LIGHT_PER_GROUP;
-            const size_t bit  = l % LIGHT_PER_GROUP;
-            l = (bit * GROUP_COUNT) | (word % GROUP_COUNT);
-            *point = (RecordBufferType)l;
-            // we need to "cancel" the write if we have more than 255 spot or point lights
-            // (this is a limitation of the data type used to store the light counts per froxel)
-            point += (point - beginPoint < 255) ? 1 : 0;
-        });
-
-        offset += lightCount;
+            // iterate the bitfield
+            auto * const beginPoint = froxelRecords + offset;
+            b.lights.forEachSetBit([point = beginPoint, beginPoint](size_t l) mutable {
+                // make sure to keep this code branch-less
+                const size_t word = l / LIGHT_PER_GROUP;
+                const size_t bit  = l % LIGHT_PER_GROUP;
+                l = (bit * GROUP_COUNT) | (word % GROUP_COUNT);
+                *point = (RecordBufferType)l;
+                // we need to "cancel" the write if we have more than 255 spot or point lights
+                // (this is a limitation of the data type used to store the light counts per froxel)
+                point += (point - beginPoint < 255) ? 1 : 0;
+            });
+
+            offset += lightCount;
+            sharedRecords[b.lights] = entry.u32;
+        }
 
 #ifndef NDEBUG
         if (lightCount) { reused--; }
@@ -726,6 +822,9 @@ void Froxelizer::froxelizeAssignRecordsCompress() noexcept {
         } while(records[i].lights == b.lights);
     }
 out_of_memory:
+    // everything froxels reference lives below the high-water mark, even in the
+    // out-of-space case (the fallback points at the all-lights span at offset 0)
+    mRecordBufferUsed = offset;
     // FIXME: on big-endian systems we need to change the endianness of the record buffer
     ;
 }
@@ -28,6 +28,7 @@
 
 #include <utils/compiler.h>
 #include <utils/bitset.h>
+#include <utils/FixedCapacityVector.h>
 #include <utils/Slice.h>
 
 #include <math/mat4.h>
@@ -96,6 +97,12 @@ public:
 
     void setOptions(float zLightNear, float zLightFar) noexcept;
 
+    // set the number of froxels this view is allowed to use, [512, FROXEL_BUFFER_ENTRY_COUNT_MAX].
+    // Rounded down to a power-of-two (froxelizeAssignRecordsCompress() relies on the budget
+    // being a power-of-two multiple of its tile size). A smaller budget yields a coarser grid
+    // and proportionally less froxelization work and GPU upload traffic.
+    void setFroxelBufferEntryCount(size_t count) noexcept;
+
     /*
      * Allocate per-frame data structures for froxelization.
      *
@@ -194,9 +201,9 @@ private:
     bool update() noexcept;
 
     void froxelizeLoop(FEngine& engine,
-            const CameraInfo& camera, const FScene::LightSoa& lightData) noexcept;
+            utils::FixedCapacityVector<LightParams> const& lightParams) noexcept;
 
-    void froxelizeAssignRecordsCompress() noexcept;
+    void froxelizeAssignRecordsCompress(FEngine& engine) noexcept;
 
     void froxelizePointAndSpotLight(FroxelThreadData& froxelThread, size_t bit,
             math::mat4f const& projection, const LightParams& light) const noexcept;
@@ -215,7 +222,7 @@ private:
 
     static void computeFroxelLayout(
             math::uint2* dim, uint16_t* countX, uint16_t* countY, uint16_t* countZ,
-            Viewport const& viewport) noexcept;
+            size_t froxelBufferEntryCount, Viewport const& viewport) noexcept;
 
     // internal state dependant on the viewport and needed for froxelizing
     LinearAllocatorArena mArena;                    // ~256 KiB
@@ -232,6 +239,19 @@ private:
     utils::Slice<RecordBufferType> mRecordBufferUser;   //  16 KiB
     utils::Slice<LightRecord> mLightRecords;            // 256 KiB w/ 256 lights
 
+    // the previous frame's per-light view-space parameters; when they're unchanged (and
+    // the grid isn't dirty) froxelization and the GPU upload are skipped entirely.
+    utils::FixedCapacityVector<LightParams> mLastLightParams;
+    bool mFroxelsInvalidated = true;    // the froxel grid or projection changed
+    bool mUploadNeeded = false;         // froxel data was rebuilt since the last commit()
+
+    // number of record-buffer entries referenced by the current froxel data;
+    // commit() only uploads this prefix
+    uint32_t mRecordBufferUsed = 0;
+
+    // number of froxels the grid is allowed to use (quality tier), always a power-of-two
+    uint16_t mFroxelBufferEntryCount = FROXEL_BUFFER_ENTRY_COUNT_MAX;
+
     uint16_t mFroxelCountX = 0;
     uint16_t mFroxelCountY = 0;
     uint16_t mFroxelCountZ = 0;
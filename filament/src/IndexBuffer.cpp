@@ -52,7 +52,8 @@ IndexBuffer* IndexBuffer::Builder::build(Engine& engine) {
 // ------------------------------------------------------------------------------------------------
 
 FIndexBuffer::FIndexBuffer(FEngine& engine, const IndexBuffer::Builder& builder)
-        : mIndexCount(builder->mIndexCount) {
+        : mIndexCount(builder->mIndexCount),
+          mIndexSize(builder->mIndexType == IndexType::USHORT ? 2 : 4) {
     FEngine::DriverApi& driver = engine.getDriverApi();
     mHandle = driver.createIndexBuffer(
             (backend::ElementType)builder->mIndexType,
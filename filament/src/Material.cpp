@@ -127,23 +127,30 @@ Material* Material::Builder::build(Engine& engine) {
     return upcast(engine).createMaterial(*this);
 }
 
-static void addSamplerGroup(Program& pb, uint8_t bindingPoint, SamplerInterfaceBlock const& sib,
-        SamplerBindingMap const& map) {
+void FMaterial::precomputeSamplerGroup(uint8_t bindingPoint,
+        SamplerInterfaceBlock const& sib) noexcept {
     const size_t samplerCount = sib.getSize();
-    if (samplerCount) {
-        std::vector<Program::Sampler> samplers(samplerCount);
-        auto const& list = sib.getSamplerInfoList();
-        for (size_t i = 0, c = samplerCount; i < c; ++i) {
-            CString uniformName(
-                    SamplerInterfaceBlock::getUniformName(sib.getName().c_str(),
-                            list[i].name.c_str()));
-            uint8_t binding = 0;
-            UTILS_UNUSED bool ok = map.getSamplerBinding(bindingPoint, (uint8_t)i, &binding);
-            assert_invariant(ok);
-            const bool strict = (bindingPoint == filament::BindingPoints::PER_MATERIAL_INSTANCE);
-            samplers[i] = { std::move(uniformName), binding, strict };
-        }
-        pb.setSamplerGroup(bindingPoint, sib.getStageFlags(), samplers.data(), samplers.size());
+    auto& table = mSamplerGroupTables[bindingPoint];
+    table.stageFlags = sib.getStageFlags();
+    table.samplers = FixedCapacityVector<Program::Sampler>::with_capacity(samplerCount);
+    auto const& list = sib.getSamplerInfoList();
+    for (size_t i = 0, c = samplerCount; i < c; ++i) {
+        CString uniformName(
+                SamplerInterfaceBlock::getUniformName(sib.getName().c_str(),
+                        list[i].name.c_str()));
+        uint8_t binding = 0;
+        UTILS_UNUSED bool ok = mSamplerBindings.getSamplerBinding(bindingPoint, (uint8_t)i, &binding);
+        assert_invariant(ok);
+        const bool strict = (bindingPoint == filament::BindingPoints::PER_MATERIAL_INSTANCE);
+        table.samplers.push_back({ std::move(uniformName), binding, strict });
+    }
+}
+
+void FMaterial::addSamplerGroup(Program& pb, uint8_t bindingPoint) const noexcept {
+    auto const& table = mSamplerGroupTables[bindingPoint];
+    if (!table.samplers.empty()) {
+        pb.setSamplerGroup(bindingPoint, table.stageFlags,
+                table.samplers.data(), table.samplers.size());
     }
 }
 
@@ -169,6 +176,7 @@ FMaterial::FMaterial(FEngine& engine, const Material::Builder& builder)
     if (UTILS_UNLIKELY(server)) {
         auto details = builder.mImpl;
         mDebuggerId = server->addMaterial(mName, details->mPayload, details->mSize, this);
+        mDebugServer = server;
     }
 #endif
 
@@ -177,8 +185,19 @@ FMaterial::FMaterial(FEngine& engine, const Material::Builder& builder)
         mSubpassInfo.isValid = false;
     }
 
-    // Populate sampler bindings for the backend that will consume this Material.
-    mSamplerBindings.populate(&mSamplerInterfaceBlock);
+    // Use the sampler binding table baked by matc when present; recomputing it here gives
+    // the same layout, but older packages don't carry the chunk.
+    if (!parser->getSamplerBindings(&mSamplerBindings)) {
+        mSamplerBindings.populate(&mSamplerInterfaceBlock);
+    }
+
+    // Sampler names and offsets don't depend on the variant (SibGenerator relies on this
+    // too), so the finalized sampler lists can be computed once for all program variants.
+    precomputeSamplerGroup(BindingPoints::PER_VIEW,
+            SibGenerator::getPerViewSib({}));
+    precomputeSamplerGroup(BindingPoints::PER_RENDERABLE_MORPHING,
+            SibGenerator::getPerRenderPrimitiveMorphingSib({}));
+    precomputeSamplerGroup(BindingPoints::PER_MATERIAL_INSTANCE, mSamplerInterfaceBlock);
 
     parser->getShading(&mShading);
     parser->getMaterialProperties(&mMaterialProperties);
@@ -318,6 +337,9 @@ FMaterial::~FMaterial() noexcept {
 
 void FMaterial::terminate(FEngine& engine) {
 
+    // drop any prewarm work still queued for this material
+    engine.cancelDeferredWork(this);
+
 #if FILAMENT_ENABLE_MATDBG
     // Unregister the material with matdbg.
     matdbg::DebugServer* server = upcast(mEngine).debug.server;
@@ -385,11 +407,10 @@ Handle<HwProgram> FMaterial::getSurfaceProgramSlow(Variant variant) const noexce
 
     // Always add the morphing sampler group because there is no way
     // that SamplerBindingMap knows the current variant.
-    addSamplerGroup(pb, BindingPoints::PER_RENDERABLE_MORPHING,
-            SibGenerator::getPerRenderPrimitiveMorphingSib(variant), mSamplerBindings);
+    addSamplerGroup(pb, BindingPoints::PER_RENDERABLE_MORPHING);
 
-    addSamplerGroup(pb, BindingPoints::PER_VIEW, SibGenerator::getPerViewSib(variant), mSamplerBindings);
-    addSamplerGroup(pb, BindingPoints::PER_MATERIAL_INSTANCE, mSamplerInterfaceBlock, mSamplerBindings);
+    addSamplerGroup(pb, BindingPoints::PER_VIEW);
+    addSamplerGroup(pb, BindingPoints::PER_MATERIAL_INSTANCE);
 
     // getSurfaceBindingIndexMap in GLSLPostProcessor.cpp also needs to update if sampler groups are added.
 
@@ -403,7 +424,7 @@ Handle<HwProgram> FMaterial::getPostProcessProgramSlow(Variant variant)
     pb.setUniformBlock(BindingPoints::PER_VIEW, PerViewUib::_name)
       .setUniformBlock(BindingPoints::PER_MATERIAL_INSTANCE, mUniformInterfaceBlock.getName());
 
-    addSamplerGroup(pb, BindingPoints::PER_MATERIAL_INSTANCE, mSamplerInterfaceBlock, mSamplerBindings);
+    addSamplerGroup(pb, BindingPoints::PER_MATERIAL_INSTANCE);
 
     // getPostProcessBindingIndexMap in GLSLPostProcessor.cpp also needs to update if sampler groups are added.
 
@@ -452,11 +473,62 @@ Program FMaterial::getProgramBuilderWithVariants(
     return pb;
 }
 
+void FMaterial::prewarm(VariantList const& variants) const noexcept {
+    const bool isSurface = getMaterialDomain() == MaterialDomain::SURFACE;
+    const bool lit = isVariantLit();
+    for (size_t k = 0; k < VARIANT_COUNT; k++) {
+        if (!variants[k]) {
+            continue;
+        }
+        const Variant variant(Variant::type_t(k));
+        if (isSurface) {
+            // only compile variants that can actually be requested at draw time
+            if (Variant::isReserved(variant)) {
+                continue;
+            }
+            if (variant != Variant::filterVariant(variant, lit)) {
+                continue;
+            }
+        }
+        // getProgram() is a no-op for variants that are already compiled. createProgram()
+        // is an asynchronous driver command, so the compilation itself happens on the
+        // backend thread. The CPU-side program construction goes through the engine's
+        // budgeted work queue, so prewarming a material with many variants amortizes
+        // over several frames instead of spiking one.
+        mEngine.scheduleDeferredWork(this, [this, v = variant]() {
+            getProgram(v);
+        });
+    }
+}
+
+void FMaterial::prewarm() const noexcept {
+    VariantList variants;
+    switch (getMaterialDomain()) {
+        case MaterialDomain::SURFACE:
+            // all non-reserved variants; prewarm(VariantList) filters further
+            for (size_t k = 0; k < VARIANT_COUNT; k++) {
+                variants.set(k);
+            }
+            break;
+        case MaterialDomain::POST_PROCESS:
+            // post-process materials define their own variant space, we can only assume
+            // the default variant here
+            variants.set(0);
+            break;
+    }
+    prewarm(variants);
+}
+
 Handle<HwProgram> FMaterial::createAndCacheProgram(Program&& p, Variant variant) const noexcept {
     auto program = mEngine.getDriverApi().createProgram(std::move(p));
     assert_invariant(program);
 
     mCachedPrograms[variant.key] = program;
+
+    // The shader source has been handed off to the driver, so the decompressed dictionary
+    // entries are no longer needed; the program handle is cached for the lifetime of the
+    // material, making a re-decompression for this variant rare.
+    mMaterialParser->releaseShaderData();
     return program;
 }
 
@@ -573,6 +645,10 @@ MaterialInstance* Material::createInstance(const char* name) const noexcept {
     return upcast(this)->createInstance(name);
 }
 
+void Material::prewarm() noexcept {
+    upcast(this)->prewarm();
+}
+
 const char* Material::getName() const noexcept {
     return upcast(this)->getName().c_str();
 }
@@ -116,6 +116,60 @@ template UTILS_PUBLIC void MaterialInstance::setParameter<mat4f>   (const char*
 
 // ------------------------------------------------------------------------------------------------
 
+MaterialInstance::ParameterHandle MaterialInstance::getParameterHandle(
+        const char* name) const noexcept {
+    ParameterHandle handle;
+    handle.mOffset = int32_t(
+            upcast(this)->getMaterial()->getUniformInterfaceBlock().getUniformOffset(name, 0));
+    return handle;
+}
+
+template <typename T, typename>
+void MaterialInstance::setParameter(ParameterHandle handle, T const& value) noexcept {
+    upcast(this)->setParameterImpl(handle, value);
+}
+
+template<>
+UTILS_PUBLIC void MaterialInstance::setParameter(ParameterHandle handle, bool const& v) noexcept {
+    MaterialInstance::setParameter(handle, (uint32_t)v);
+}
+
+template<>
+UTILS_PUBLIC void MaterialInstance::setParameter(ParameterHandle handle, bool2 const& v) noexcept {
+    MaterialInstance::setParameter(handle, uint2(v));
+}
+
+template<>
+UTILS_PUBLIC void MaterialInstance::setParameter(ParameterHandle handle, bool3 const& v) noexcept {
+    MaterialInstance::setParameter(handle, uint3(v));
+}
+
+template<>
+UTILS_PUBLIC void MaterialInstance::setParameter(ParameterHandle handle, bool4 const& v) noexcept {
+    MaterialInstance::setParameter(handle, uint4(v));
+}
+
+template UTILS_PUBLIC void MaterialInstance::setParameter<float>   (ParameterHandle handle, float const&    v) noexcept;
+template UTILS_PUBLIC void MaterialInstance::setParameter<int32_t> (ParameterHandle handle, int32_t const&  v) noexcept;
+template UTILS_PUBLIC void MaterialInstance::setParameter<uint32_t>(ParameterHandle handle, uint32_t const& v) noexcept;
+template UTILS_PUBLIC void MaterialInstance::setParameter<int2>    (ParameterHandle handle, int2 const&     v) noexcept;
+template UTILS_PUBLIC void MaterialInstance::setParameter<int3>    (ParameterHandle handle, int3 const&     v) noexcept;
+template UTILS_PUBLIC void MaterialInstance::setParameter<int4>    (ParameterHandle handle, int4 const&     v) noexcept;
+template UTILS_PUBLIC void MaterialInstance::setParameter<uint2>   (ParameterHandle handle, uint2 const&    v) noexcept;
+template UTILS_PUBLIC void MaterialInstance::setParameter<uint3>   (ParameterHandle handle, uint3 const&    v) noexcept;
+template UTILS_PUBLIC void MaterialInstance::setParameter<uint4>   (ParameterHandle handle, uint4 const&    v) noexcept;
+template UTILS_PUBLIC void MaterialInstance::setParameter<float2>  (ParameterHandle handle, float2 const&   v) noexcept;
+template UTILS_PUBLIC void MaterialInstance::setParameter<float3>  (ParameterHandle handle, float3 const&   v) noexcept;
+template UTILS_PUBLIC void MaterialInstance::setParameter<float4>  (ParameterHandle handle, float4 const&   v) noexcept;
+template UTILS_PUBLIC void MaterialInstance::setParameter<mat3f>   (ParameterHandle handle, mat3f const&    v) noexcept;
+template UTILS_PUBLIC void MaterialInstance::setParameter<mat4f>   (ParameterHandle handle, mat4f const&    v) noexcept;
+
+void MaterialInstance::setParameters(ParameterHandle first, const void* data, size_t size) noexcept {
+    upcast(this)->setParametersImpl(first, data, size);
+}
+
+// ------------------------------------------------------------------------------------------------
+
 template <typename T, typename>
 void MaterialInstance::setParameter(const char* name, const T* value, size_t count) noexcept {
     upcast(this)->setParameterImpl(name, value, count);
@@ -193,8 +247,7 @@ FMaterialInstance::FMaterialInstance(FEngine& engine,
 
     if (!material->getUniformInterfaceBlock().isEmpty()) {
         mUniforms.setUniforms(other->getUniformBuffer());
-        mUbHandle = driver.createBufferObject(mUniforms.getSize(),
-                BufferObjectBinding::UNIFORM, backend::BufferUsage::DYNAMIC);
+        mUbAllocation = engine.getUniformBufferArena().allocate(driver, mUniforms.getSize());
     }
 
     if (!material->getSamplerInterfaceBlock().isEmpty()) {
@@ -222,8 +275,7 @@ void FMaterialInstance::initDefaultInstance(FEngine& engine, FMaterial const* ma
 
     if (!material->getUniformInterfaceBlock().isEmpty()) {
         mUniforms = UniformBuffer(material->getUniformInterfaceBlock().getSize());
-        mUbHandle = driver.createBufferObject(mUniforms.getSize(),
-                BufferObjectBinding::UNIFORM, backend::BufferUsage::STATIC);
+        mUbAllocation = engine.getUniformBufferArena().allocate(driver, mUniforms.getSize());
     }
 
     if (!material->getSamplerInterfaceBlock().isEmpty()) {
@@ -263,14 +315,18 @@ FMaterialInstance::~FMaterialInstance() noexcept = default;
 
 void FMaterialInstance::terminate(FEngine& engine) {
     FEngine::DriverApi& driver = engine.getDriverApi();
-    driver.destroyBufferObject(mUbHandle);
+    engine.getUniformBufferArena().release(mUbAllocation);
     driver.destroySamplerGroup(mSbHandle);
 }
 
 void FMaterialInstance::commitSlow(DriverApi& driver) const {
-    // update uniforms if needed
+    // update uniforms if needed, only pushing the range that was actually modified
     if (mUniforms.isDirty()) {
-        driver.updateBufferObject(mUbHandle, mUniforms.toBufferDescriptor(driver), 0);
+        const size_t dirtyOffset = mUniforms.getDirtyOffset();
+        const size_t dirtySize = mUniforms.getDirtySize();
+        driver.updateBufferObject(mUbAllocation.handle,
+                mUniforms.toBufferDescriptor(driver, dirtyOffset, dirtySize),
+                mUbAllocation.offset + uint32_t(dirtyOffset));
     }
     if (mSamplers.isDirty()) {
         driver.updateSamplerGroup(mSbHandle, std::move(mSamplers.toCommandStream()));
@@ -354,10 +410,12 @@ void FMaterialInstance::setDoubleSided(bool doubleSided) noexcept {
 
 void FMaterialInstance::setTransparencyMode(TransparencyMode mode) noexcept {
     mTransparencyMode = mode;
+    ++mStateVersion;
 }
 
 void FMaterialInstance::setDepthCulling(bool enable) noexcept {
     mDepthFunc = enable ? RasterState::DepthFunc::GE : RasterState::DepthFunc::A;
+    ++mStateVersion;
 }
 
 const char* FMaterialInstance::getName() const noexcept {
@@ -26,6 +26,7 @@
 
 #include <filament/MaterialChunkType.h>
 
+#include <private/filament/SamplerBindingMap.h>
 #include <private/filament/SamplerInterfaceBlock.h>
 #include <private/filament/UniformInterfaceBlock.h>
 #include <private/filament/SubpassInfo.h>
@@ -149,6 +150,17 @@ bool MaterialParser::getSubpasses(SubpassInfo* subpass) const noexcept {
     return ChunkSubpassInterfaceBlock::unflatten(unflattener, subpass);
 }
 
+bool MaterialParser::getSamplerBindings(SamplerBindingMap* bindings) const noexcept {
+    auto type = MaterialSamplerBindings;
+    // this chunk is optional, older packages don't carry the baked binding table
+    ChunkContainer::ChunkDesc const* pChunkDesc;
+    if (!mImpl.mChunkContainer.hasChunk(type, &pChunkDesc)) {
+        return false;
+    }
+    Unflattener unflattener(pChunkDesc->start, pChunkDesc->start + pChunkDesc->size);
+    return ChunkSamplerBindings::unflatten(unflattener, bindings);
+}
+
 bool MaterialParser::getShaderModels(uint32_t* value) const noexcept {
     return mImpl.getFromSimpleChunk(ChunkType::MaterialShaderModels, value);
 }
@@ -282,6 +294,10 @@ bool MaterialParser::getShader(ShaderBuilder& shader,
             mImpl.mBlobDictionary, (uint8_t)shaderModel, variant, stage);
 }
 
+void MaterialParser::releaseShaderData() noexcept {
+    mImpl.mBlobDictionary.releaseDecompressedBlobs();
+}
+
 // ------------------------------------------------------------------------------------------------
 
 
@@ -442,4 +458,40 @@ bool ChunkSubpassInterfaceBlock::unflatten(Unflattener& unflattener,
     return true;
 }
 
+bool ChunkSamplerBindings::unflatten(Unflattener& unflattener,
+        filament::SamplerBindingMap* bindings) {
+
+    // Read number of bindings.
+    uint64_t numBindings = 0;
+    if (!unflattener.read(&numBindings)) {
+        return false;
+    }
+
+    for (uint64_t i = 0; i < numBindings; i++) {
+        uint8_t blockIndex = 0;
+        uint8_t localOffset = 0;
+        uint8_t globalOffset = 0;
+
+        if (!unflattener.read(&blockIndex)) {
+            return false;
+        }
+
+        if (!unflattener.read(&localOffset)) {
+            return false;
+        }
+
+        if (!unflattener.read(&globalOffset)) {
+            return false;
+        }
+
+        bindings->addSampler({
+            .blockIndex = blockIndex,
+            .localOffset = localOffset,
+            .globalOffset = globalOffset,
+        });
+    }
+
+    return true;
+}
+
 } // namespace filament
@@ -41,6 +41,7 @@ namespace filament {
 
 class UniformInterfaceBlock;
 class SamplerInterfaceBlock;
+class SamplerBindingMap;
 struct SubpassInfo;
 
 class MaterialParser {
@@ -64,6 +65,7 @@ public:
     bool getUIB(UniformInterfaceBlock* uib) const noexcept;
     bool getSIB(SamplerInterfaceBlock* sib) const noexcept;
     bool getSubpasses(SubpassInfo* subpass) const noexcept;
+    bool getSamplerBindings(SamplerBindingMap* bindings) const noexcept;
     bool getShaderModels(uint32_t* value) const noexcept;
     bool getMaterialProperties(uint64_t* value) const noexcept;
 
@@ -95,6 +97,10 @@ public:
     bool getShader(filaflat::ShaderBuilder& shader, backend::ShaderModel shaderModel,
             Variant variant, backend::ShaderType stage) noexcept;
 
+    // Releases the decompressed shader dictionary entries. Call this once a program has been
+    // handed to the driver; a later getShader() for another variant simply decompresses again.
+    void releaseShaderData() noexcept;
+
 private:
     struct MaterialParserDetails {
         MaterialParserDetails(backend::Backend backend, const void* data, size_t size);
@@ -149,6 +155,10 @@ struct ChunkSubpassInterfaceBlock {
     static bool unflatten(filaflat::Unflattener& unflattener, SubpassInfo* sib);
 };
 
+struct ChunkSamplerBindings {
+    static bool unflatten(filaflat::Unflattener& unflattener, SamplerBindingMap* bindings);
+};
+
 } // namespace filament
 
 #endif // TNT_FILAMENT_MATERIALPARSER_H
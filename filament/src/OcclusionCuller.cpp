@@ -0,0 +1,257 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "OcclusionCuller.h"
+
+#include <utils/Systrace.h>
+
+#include <math/vec2.h>
+#include <math/vec4.h>
+
+#include <algorithm>
+
+#include <cmath>
+
+using namespace filament::math;
+
+namespace filament {
+
+// a box is ignored when one of its corners comes this close to (or behind) the camera
+// plane; such a box can't be projected reliably, so it neither occludes nor is occluded
+static constexpr float MIN_W = 1.0f / 1024.0f;
+
+// offset of a given mip level into the depth buffer storage
+static constexpr size_t mipOffset(size_t level) noexcept {
+    size_t offset = 0;
+    for (size_t i = 0; i < level; i++) {
+        offset += (OcclusionCuller::WIDTH >> i) * (OcclusionCuller::HEIGHT >> i);
+    }
+    return offset;
+}
+
+namespace {
+struct ProjectedBox {
+    float2 p[8];    // window coordinates of each corner
+    float z[8];     // NDC depth of each corner
+};
+} // anonymous namespace
+
+// projects the corners of a box to window coordinates, returns false if the box crosses
+// the w = MIN_W plane
+static bool project(ProjectedBox& out,
+        float3 const& center, float3 const& extent, mat4f const& viewProjection) noexcept {
+    for (size_t i = 0; i < 8; i++) {
+        const float3 corner{
+                center.x + ((i & 1u) ? extent.x : -extent.x),
+                center.y + ((i & 2u) ? extent.y : -extent.y),
+                center.z + ((i & 4u) ? extent.z : -extent.z) };
+        const float4 c = viewProjection * float4{ corner, 1.0f };
+        if (UTILS_UNLIKELY(c.w < MIN_W)) {
+            return false;
+        }
+        const float iw = 1.0f / c.w;
+        out.p[i] = { (c.x * iw * 0.5f + 0.5f) * float(OcclusionCuller::WIDTH),
+                     (c.y * iw * 0.5f + 0.5f) * float(OcclusionCuller::HEIGHT) };
+        out.z[i] = c.z * iw;
+    }
+    return true;
+}
+
+void OcclusionCuller::rasterizeBox(float3 const& center, float3 const& extent,
+        mat4f const& viewProjection) noexcept {
+    ProjectedBox box;
+    if (UTILS_UNLIKELY(!project(box, center, extent, viewProjection))) {
+        return;
+    }
+
+    // corner indices of each face of the box
+    static constexpr uint8_t faces[6][4] = {
+            { 0, 4, 6, 2 }, { 1, 3, 7, 5 },     // -x, +x
+            { 0, 1, 5, 4 }, { 2, 6, 7, 3 },     // -y, +y
+            { 0, 2, 3, 1 }, { 4, 5, 7, 6 },     // -z, +z
+    };
+
+    float* const UTILS_RESTRICT depth = mDepth.get();
+    for (auto const& face : faces) {
+        float2 q[4];
+        float maxz = -1.0f;
+        for (size_t i = 0; i < 4; i++) {
+            q[i] = box.p[face[i]];
+            maxz = std::max(maxz, box.z[face[i]]);
+        }
+
+        // a face beyond the far plane can't conservatively occlude anything
+        if (maxz > 1.0f) {
+            continue;
+        }
+
+        // make the winding counter-clockwise, so that the interior of the face is to
+        // the left of each directed edge
+        const float area = cross(q[1] - q[0], q[2] - q[0]) + cross(q[2] - q[0], q[3] - q[0]);
+        if (area < 0.0f) {
+            std::swap(q[0], q[3]);
+            std::swap(q[1], q[2]);
+        }
+
+        float2 n[4];
+        float c[4];
+        float2 bbMin = q[0];
+        float2 bbMax = q[0];
+        for (size_t i = 0; i < 4; i++) {
+            const float2 v0 = q[i];
+            const float2 e = q[(i + 1) & 3u] - v0;
+            // interior (left) normal of the edge, with a half-pixel inward shift so
+            // that only pixels whose footprint is entirely covered pass the test
+            n[i] = { -e.y, e.x };
+            c[i] = dot(n[i], v0) + 0.5f * (std::abs(n[i].x) + std::abs(n[i].y));
+            bbMin = min(bbMin, v0);
+            bbMax = max(bbMax, v0);
+        }
+
+        const int32_t x0 = std::max(0, int32_t(bbMin.x));
+        const int32_t y0 = std::max(0, int32_t(bbMin.y));
+        const int32_t x1 = std::min(int32_t(WIDTH) - 1, int32_t(std::ceil(bbMax.x)));
+        const int32_t y1 = std::min(int32_t(HEIGHT) - 1, int32_t(std::ceil(bbMax.y)));
+        for (int32_t y = y0; y <= y1; y++) {
+            const float py = float(y) + 0.5f;
+            float* const UTILS_RESTRICT row = depth + size_t(y) * WIDTH;
+            for (int32_t x = x0; x <= x1; x++) {
+                const float px = float(x) + 0.5f;
+                if (n[0].x * px + n[0].y * py >= c[0] &&
+                    n[1].x * px + n[1].y * py >= c[1] &&
+                    n[2].x * px + n[2].y * py >= c[2] &&
+                    n[3].x * px + n[3].y * py >= c[3]) {
+                    row[x] = std::min(row[x], maxz);
+                }
+            }
+        }
+    }
+}
+
+bool OcclusionCuller::isOccluded(float3 const& center, float3 const& extent,
+        mat4f const& viewProjection) const noexcept {
+    ProjectedBox box;
+    if (UTILS_UNLIKELY(!project(box, center, extent, viewProjection))) {
+        return false;
+    }
+
+    float2 bbMin = box.p[0];
+    float2 bbMax = box.p[0];
+    float minz = box.z[0];
+    for (size_t i = 1; i < 8; i++) {
+        bbMin = min(bbMin, box.p[i]);
+        bbMax = max(bbMax, box.p[i]);
+        minz = std::min(minz, box.z[i]);
+    }
+
+    // only the on-screen part of the box matters, the rest can't be seen anyway
+    const int32_t x0 = std::max(0, int32_t(bbMin.x));
+    const int32_t y0 = std::max(0, int32_t(bbMin.y));
+    const int32_t x1 = std::min(int32_t(WIDTH) - 1, int32_t(std::ceil(bbMax.x)));
+    const int32_t y1 = std::min(int32_t(HEIGHT) - 1, int32_t(std::ceil(bbMax.y)));
+    if (x1 < x0 || y1 < y0) {
+        return false;
+    }
+
+    // pick the coarsest level where the rectangle spans no more than 2x2 texels
+    size_t level = 0;
+    while (level < MIP_COUNT - 1 &&
+            ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1)) {
+        level++;
+    }
+
+    float const* const UTILS_RESTRICT mip = mDepth.get() + mipOffset(level);
+    const size_t w = WIDTH >> level;
+    float farthest = -1.0f;
+    for (int32_t y = y0 >> level, yl = y1 >> level; y <= yl; y++) {
+        for (int32_t x = x0 >> level, xl = x1 >> level; x <= xl; x++) {
+            farthest = std::max(farthest, mip[size_t(y) * w + size_t(x)]);
+        }
+    }
+    return minz > farthest;
+}
+
+void OcclusionCuller::prepare(FRenderableManager::Visibility const* UTILS_RESTRICT visibility,
+        float3 const* UTILS_RESTRICT center,
+        float3 const* UTILS_RESTRICT extent,
+        size_t count, mat4f const& viewProjection) noexcept {
+    SYSTRACE_CALL();
+
+    mViewProjection = viewProjection;
+
+    // rasterize the occluders -- whether or not they're in a visible layer, so that a
+    // renderable on a hidden layer can serve as an invisible occlusion proxy
+    mHasOccluders = false;
+    for (size_t i = 0; i < count; i++) {
+        if (UTILS_UNLIKELY(visibility[i].occluder)) {
+            if (!mHasOccluders) {
+                mHasOccluders = true;
+                if (UTILS_UNLIKELY(!mDepth)) {
+                    mDepth = std::make_unique<float[]>(mipOffset(MIP_COUNT));
+                }
+                std::fill_n(mDepth.get(), WIDTH * HEIGHT, 1.0f);
+            }
+            rasterizeBox(center[i], extent[i], viewProjection);
+        }
+    }
+    if (!mHasOccluders) {
+        return;
+    }
+
+    // reduce the depth buffer into a max-depth pyramid
+    for (size_t level = 1; level < MIP_COUNT; level++) {
+        float const* const UTILS_RESTRICT src = mDepth.get() + mipOffset(level - 1);
+        float* const UTILS_RESTRICT dst = mDepth.get() + mipOffset(level);
+        const size_t w = WIDTH >> level;
+        const size_t h = HEIGHT >> level;
+        for (size_t y = 0; y < h; y++) {
+            for (size_t x = 0; x < w; x++) {
+                const float d00 = src[(y * 2    ) * (w * 2) + x * 2    ];
+                const float d01 = src[(y * 2    ) * (w * 2) + x * 2 + 1];
+                const float d10 = src[(y * 2 + 1) * (w * 2) + x * 2    ];
+                const float d11 = src[(y * 2 + 1) * (w * 2) + x * 2 + 1];
+                dst[y * w + x] = std::max(std::max(d00, d01), std::max(d10, d11));
+            }
+        }
+    }
+}
+
+void OcclusionCuller::cull(Culler::result_type* UTILS_RESTRICT results,
+        FRenderableManager::Visibility const* UTILS_RESTRICT visibility,
+        float3 const* UTILS_RESTRICT center,
+        float3 const* UTILS_RESTRICT extent,
+        size_t count, size_t bit) const noexcept {
+    SYSTRACE_CALL();
+
+    if (!mHasOccluders) {
+        return;
+    }
+
+    const auto mask = Culler::result_type(1u << bit);
+    for (size_t i = 0; i < count; i++) {
+        if ((results[i] & mask) && UTILS_LIKELY(visibility[i].culling)) {
+            if (UTILS_UNLIKELY(isOccluded(center[i], extent[i], mViewProjection))) {
+                results[i] &= ~mask;
+            }
+        }
+    }
+}
+
+bool OcclusionCuller::isOccluded(float3 const& center, float3 const& extent) const noexcept {
+    return mHasOccluders && isOccluded(center, extent, mViewProjection);
+}
+
+} // namespace filament
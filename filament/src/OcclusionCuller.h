@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_DETAILS_OCCLUSIONCULLER_H
+#define TNT_FILAMENT_DETAILS_OCCLUSIONCULLER_H
+
+#include "Culler.h"
+
+#include "components/RenderableManager.h"
+
+#include <utils/compiler.h>
+
+#include <math/mat4.h>
+#include <math/vec3.h>
+
+#include <memory>
+
+namespace filament {
+
+/*
+ * This is where software occlusion culling is implemented.
+ *
+ * Renderables flagged as occluders (RenderableManager::Builder::occluder()) have their
+ * world-space bounding box rasterized into a small depth buffer; the bounding boxes of
+ * all renderables are then tested against it and those that are entirely hidden get
+ * their visibility bit cleared. Only bounding boxes are ever considered -- the actual
+ * geometry is not available on the CPU -- so occluders should be authored such that
+ * their bounding box is a solid, opaque volume (e.g.: walls, buildings).
+ *
+ * Both sides are conservative: an occluder only writes the pixels entirely covered by
+ * the projection of each of its faces, at the farthest depth of that face, while an
+ * occludee is tested with the nearest depth of its whole box against a max-depth mip
+ * pyramid. A visible renderable can therefore never be culled incorrectly.
+ */
+
+class OcclusionCuller {
+public:
+    // depth buffer resolution, kept small on purpose; must be a power-of-two
+    static constexpr size_t WIDTH = 256;
+    static constexpr size_t HEIGHT = 128;
+
+    /*
+     * rasterizes the bounding box of each occluder found in visibility[] and reduces the
+     * result into the max-depth pyramid. Must be called once per frame, before any of the
+     * queries below. This is cheap if there are no occluders.
+     */
+    void prepare(FRenderableManager::Visibility const* visibility,
+            math::float3 const* center,
+            math::float3 const* extent,
+            size_t count, math::mat4f const& viewProjection) noexcept;
+
+    // whether prepare() rasterized at least one occluder; when false all queries below
+    // trivially return "not occluded"
+    bool hasOccluders() const noexcept { return mHasOccluders; }
+
+    /*
+     * clears 'bit' in results[] for each renderable whose bounding box is entirely
+     * occluded. This is a no-op if there are no occluders.
+     */
+    void cull(Culler::result_type* results,
+            FRenderableManager::Visibility const* visibility,
+            math::float3 const* center,
+            math::float3 const* extent,
+            size_t count, size_t bit) const noexcept;
+
+    // whether the given world-space box is entirely hidden behind the occluders
+    // rasterized by the last call to prepare()
+    bool isOccluded(math::float3 const& center, math::float3 const& extent) const noexcept;
+
+private:
+    // number of levels of the max-depth pyramid, the coarsest is HEIGHT >> (MIP_COUNT-1)
+    static constexpr size_t MIP_COUNT = 6;
+
+    void rasterizeBox(math::float3 const& center, math::float3 const& extent,
+            math::mat4f const& viewProjection) noexcept;
+
+    bool isOccluded(math::float3 const& center, math::float3 const& extent,
+            math::mat4f const& viewProjection) const noexcept;
+
+    // storage for all mip levels, tightly packed; allocated on first use
+    std::unique_ptr<float[]> mDepth;
+    // view-projection the pyramid was built with, set by prepare()
+    math::mat4f mViewProjection;
+    bool mHasOccluders = false;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_DETAILS_OCCLUSIONCULLER_H
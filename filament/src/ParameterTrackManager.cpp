@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ParameterTrackManager.h"
+
+#include "details/MaterialInstance.h"
+
+#include <utils/Log.h>
+#include <utils/Systrace.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace filament::math;
+
+namespace filament {
+
+ParameterTrackManager::TrackId ParameterTrackManager::addTrack(FMaterialInstance* instance,
+        size_t offset, size_t componentCount,
+        float const* times, float const* values, size_t keyframeCount, bool loop) noexcept {
+    if (UTILS_UNLIKELY(!instance || !times || !values ||
+            keyframeCount == 0 || componentCount == 0 || componentCount > 4)) {
+        utils::slog.w << "ignoring malformed parameter track" << utils::io::endl;
+        return 0;
+    }
+    for (size_t i = 1; i < keyframeCount; i++) {
+        if (UTILS_UNLIKELY(times[i] < times[i - 1])) {
+            utils::slog.w << "ignoring parameter track with unsorted keyframe times"
+                          << utils::io::endl;
+            return 0;
+        }
+    }
+
+    Track track;
+    track.instance = instance;
+    track.offset = uint32_t(offset);
+    track.firstKey = uint32_t(mKeyTimes.size());
+    track.keyCount = uint32_t(keyframeCount);
+    track.id = mNextId++;
+    track.components = uint8_t(componentCount);
+    track.loop = loop;
+
+    mKeyTimes.insert(mKeyTimes.end(), times, times + keyframeCount);
+    mKeyValues.reserve(mKeyValues.size() + keyframeCount);
+    for (size_t i = 0; i < keyframeCount; i++) {
+        // values are tightly packed, pad each keyframe to a float4
+        float4 v{};
+        memcpy(&v, values + i * componentCount, componentCount * sizeof(float));
+        mKeyValues.push_back(v);
+    }
+    mTracks.push_back(track);
+    return track.id;
+}
+
+void ParameterTrackManager::removeTrack(TrackId id) noexcept {
+    auto pos = std::find_if(mTracks.begin(), mTracks.end(),
+            [id](Track const& t) { return t.id == id; });
+    if (pos != mTracks.end()) {
+        mGarbageKeys += pos->keyCount;
+        mTracks.erase(pos);
+        compactKeyPools();
+    }
+}
+
+void ParameterTrackManager::removeTracks(FMaterialInstance const* instance) noexcept {
+    auto pos = std::remove_if(mTracks.begin(), mTracks.end(),
+            [instance, this](Track const& t) {
+                if (t.instance == instance) {
+                    mGarbageKeys += t.keyCount;
+                    return true;
+                }
+                return false;
+            });
+    if (pos != mTracks.end()) {
+        mTracks.erase(pos, mTracks.end());
+        compactKeyPools();
+    }
+}
+
+void ParameterTrackManager::compactKeyPools() noexcept {
+    // reclaim the keyframe slices of removed tracks once they outweigh the live ones
+    if (mGarbageKeys <= mKeyTimes.size() / 2) {
+        return;
+    }
+    std::vector<float> times;
+    std::vector<float4> values;
+    times.reserve(mKeyTimes.size() - mGarbageKeys);
+    values.reserve(mKeyTimes.size() - mGarbageKeys);
+    for (Track& t : mTracks) {
+        const uint32_t firstKey = uint32_t(times.size());
+        times.insert(times.end(),
+                mKeyTimes.begin() + t.firstKey, mKeyTimes.begin() + t.firstKey + t.keyCount);
+        values.insert(values.end(),
+                mKeyValues.begin() + t.firstKey, mKeyValues.begin() + t.firstKey + t.keyCount);
+        t.firstKey = firstKey;
+    }
+    mKeyTimes = std::move(times);
+    mKeyValues = std::move(values);
+    mGarbageKeys = 0;
+}
+
+void ParameterTrackManager::evaluate() noexcept {
+    SYSTRACE_CALL();
+    const float time = float(mTime);
+    float const* const UTILS_RESTRICT keyTimes = mKeyTimes.data();
+    float4 const* const UTILS_RESTRICT keyValues = mKeyValues.data();
+    for (Track& t : mTracks) {
+        float const* const kt = keyTimes + t.firstKey;
+        float4 const* const kv = keyValues + t.firstKey;
+        const uint32_t last = t.keyCount - 1;
+
+        float u = time;
+        if (t.loop) {
+            const float duration = kt[last];
+            if (duration > 0.0f) {
+                u = std::fmod(u, duration);
+                if (u < 0.0f) {
+                    u += duration;
+                }
+            }
+        }
+
+        float4 v;
+        if (u <= kt[0]) {
+            v = kv[0];
+            t.cursor = 0;
+        } else if (u >= kt[last]) {
+            v = kv[last];
+            t.cursor = last > 0 ? last - 1 : 0;
+        } else {
+            // time is coherent from frame to frame, resume the search at the cached
+            // segment; the typical cost is zero or one iteration
+            uint32_t i = std::min(t.cursor, last - 1);
+            while (u < kt[i]) { i--; }
+            while (u >= kt[i + 1]) { i++; }
+            t.cursor = i;
+            const float s = (u - kt[i]) / (kt[i + 1] - kt[i]);
+            v = kv[i] + (kv[i + 1] - kv[i]) * s;   // float4 lerp, vectorized
+        }
+
+        // write into the instance's shadow copy; the regular commit() uploads it
+        const size_t size = t.components * sizeof(float);
+        memcpy(t.instance->mUniforms.invalidateUniforms(t.offset, size), &v, size);
+    }
+}
+
+} // namespace filament
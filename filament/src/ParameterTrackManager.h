@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_PARAMETERTRACKMANAGER_H
+#define TNT_FILAMENT_PARAMETERTRACKMANAGER_H
+
+#include <math/vec4.h>
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <vector>
+
+namespace filament {
+
+class FMaterialInstance;
+
+/*
+ * ParameterTrackManager animates material parameters engine-side. A track binds a
+ * (MaterialInstance, uniform parameter) pair to a piecewise-linear keyframe curve;
+ * all tracks are evaluated in one pass from FEngine::prepare() and write straight
+ * into each instance's UniformBuffer shadow copy, so the regular per-frame commit
+ * picks the new values up. This replaces one setParameter() call per animated
+ * parameter per frame with a single setTime() call.
+ *
+ * Keyframes of all tracks are pooled in two parallel arrays (times, float4 values)
+ * so evaluation is a linear walk; values are padded to float4 regardless of the
+ * parameter's component count so the lerp vectorizes. Each track caches the index
+ * of its current segment, which makes the keyframe search O(1) for the common case
+ * of time advancing a little each frame.
+ */
+class ParameterTrackManager {
+public:
+    using TrackId = uint32_t;
+
+    // registers a track; offset is the byte offset of the parameter in the instance's
+    // uniform block, componentCount is 1 to 4 floats. The keyframes are copied.
+    // Returns 0 if the track is malformed.
+    TrackId addTrack(FMaterialInstance* instance, size_t offset, size_t componentCount,
+            float const* times, float const* values, size_t keyframeCount,
+            bool loop) noexcept;
+
+    void removeTrack(TrackId id) noexcept;
+
+    // removes all tracks targeting this instance, called when the instance is destroyed
+    void removeTracks(FMaterialInstance const* instance) noexcept;
+
+    void setTime(double time) noexcept { mTime = time; }
+
+    // evaluates all tracks at the current time, called once per frame from
+    // FEngine::prepare() before the material instances are committed
+    void evaluate() noexcept;
+
+    bool isEmpty() const noexcept { return mTracks.empty(); }
+
+private:
+    struct Track {
+        FMaterialInstance* instance;
+        uint32_t offset;        // byte offset in the instance's uniform block
+        uint32_t firstKey;      // index of the first keyframe in the pools
+        uint32_t keyCount;
+        uint32_t cursor = 0;    // cached segment index of the last evaluation
+        TrackId id;
+        uint8_t components;     // 1 to 4 floats
+        bool loop;
+    };
+
+    void compactKeyPools() noexcept;
+
+    std::vector<Track> mTracks;
+    // keyframe pools shared by all tracks, each track owns a contiguous slice
+    std::vector<float> mKeyTimes;
+    std::vector<math::float4> mKeyValues;
+    size_t mGarbageKeys = 0;    // keyframes owned by removed tracks, see compactKeyPools()
+    double mTime = 0.0;
+    TrackId mNextId = 1;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_PARAMETERTRACKMANAGER_H
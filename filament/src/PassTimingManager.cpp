@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "PassTimingManager.h"
+
+#include <utils/debug.h>
+
+#include <algorithm>
+
+#include <string.h>
+
+namespace filament {
+
+using namespace utils;
+using namespace backend;
+
+void PassTimingManager::terminate(DriverApi& driver) noexcept {
+    for (auto& slot : mSlots) {
+        for (auto& query : slot.queries) {
+            driver.destroyTimerQuery(query);
+        }
+    }
+    mSlots.clear();
+    mSlotIndices.clear();
+    mCurrentPass = nullptr;
+}
+
+void PassTimingManager::beginFrame(DriverApi& driver) noexcept {
+    // harvest the queries that have a result available; queries complete in submission
+    // order, so we stop at the first one still pending
+    for (auto& slot : mSlots) {
+        uint64_t elapsed = 0;
+        while (slot.inFlight && driver.getTimerQueryValue(slot.queries[slot.tail], &elapsed)) {
+            slot.tail = (slot.tail + 1) % POOL_COUNT;
+            slot.inFlight--;
+            slot.samples[slot.cursor] = float(elapsed) * 1e-6f; // ns to ms
+            slot.cursor = (slot.cursor + 1) % MAX_SAMPLE_HISTORY;
+            slot.sampleCount = std::min(slot.sampleCount + 1, uint32_t(MAX_SAMPLE_HISTORY));
+        }
+    }
+}
+
+PassTimingManager::Slot& PassTimingManager::getSlot(DriverApi& driver, const char* name) noexcept {
+    auto pos = mSlotIndices.find(name);
+    if (UTILS_LIKELY(pos != mSlotIndices.end())) {
+        return mSlots[pos->second];
+    }
+    Slot& slot = mSlots.emplace_back();
+    slot.name = CString{ name };
+    for (auto& query : slot.queries) {
+        query = driver.createTimerQuery();
+    }
+    // the key must outlive transient pass names (e.g. the present pass), so it points
+    // into the slot's own storage -- growing mSlots moves the CString but not its buffer
+    mSlotIndices[slot.name.c_str()] = uint32_t(mSlots.size() - 1);
+    return slot;
+}
+
+void PassTimingManager::beginPass(DriverApi& driver, const char* name) noexcept {
+    assert_invariant(mCurrentPass == nullptr);
+    Slot& slot = getSlot(driver, name);
+    if (UTILS_UNLIKELY(slot.inFlight == POOL_COUNT)) {
+        // the GPU is several frames behind, skip this pass rather than reuse a live query
+        return;
+    }
+    driver.beginTimerQuery(slot.queries[slot.head]);
+    mCurrentPass = &slot;
+}
+
+void PassTimingManager::endPass(DriverApi& driver) noexcept {
+    Slot* const slot = mCurrentPass;
+    if (UTILS_UNLIKELY(slot == nullptr)) {
+        return;
+    }
+    driver.endTimerQuery(slot->queries[slot->head]);
+    slot->head = (slot->head + 1) % POOL_COUNT;
+    slot->inFlight++;
+    mCurrentPass = nullptr;
+}
+
+float PassTimingManager::getLastFrameGpuTimeMs() const noexcept {
+    float total = 0.0f;
+    for (auto const& slot : mSlots) {
+        if (slot.sampleCount > 0) {
+            total += slot.samples[(slot.cursor + MAX_SAMPLE_HISTORY - 1) % MAX_SAMPLE_HISTORY];
+        }
+    }
+    return total;
+}
+
+size_t PassTimingManager::getPassTimings(PassTiming* timings, size_t count) const noexcept {
+    size_t written = 0;
+    for (auto const& slot : mSlots) {
+        if (written >= count) {
+            break;
+        }
+        const size_t n = slot.sampleCount;
+        if (n == 0) {
+            continue;
+        }
+
+        std::array<float, MAX_SAMPLE_HISTORY> sorted; // NOLINT -- initialized below
+        std::copy_n(slot.samples.begin(), n, sorted.begin());
+        std::sort(sorted.begin(), sorted.begin() + n);
+
+        PassTiming& out = timings[written++];
+        strncpy(out.name, slot.name.c_str(), PassTiming::MAX_NAME_LENGTH);
+        out.name[PassTiming::MAX_NAME_LENGTH] = '\0';
+        out.samples = uint32_t(n);
+        out.last = slot.samples[(slot.cursor + MAX_SAMPLE_HISTORY - 1) % MAX_SAMPLE_HISTORY];
+        out.median = sorted[n / 2];
+        out.p95 = sorted[std::min(n - 1, (n * 95) / 100)];
+        out.max = sorted[n - 1];
+    }
+    return written;
+}
+
+} // namespace filament
@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_PASSTIMINGMANAGER_H
+#define TNT_FILAMENT_PASSTIMINGMANAGER_H
+
+#include "backend/Handle.h"
+#include <private/backend/DriverApi.h>
+
+#include <filament/Renderer.h>
+
+#include <utils/CString.h>
+
+#include <tsl/robin_map.h>
+
+#include <array>
+#include <vector>
+
+#include <stdint.h>
+
+namespace filament {
+
+/*
+ * PassTimingManager measures the GPU time spent in each FrameGraph pass using backend timer
+ * queries (abstracted by DriverApi::beginTimerQuery / endTimerQuery) and aggregates the
+ * results into a per-pass ring buffer of samples, queryable with Renderer::getPassTimings().
+ *
+ * Profiling is off by default because timer queries aren't free on all drivers. Timer
+ * queries also can't nest on OpenGL, so while pass profiling is enabled the whole-frame
+ * timer in FrameInfoManager is paused (see FRenderer::beginFrame).
+ */
+class PassTimingManager {
+    // enough in-flight queries per pass to cover the backend's frame latency
+    static constexpr size_t POOL_COUNT = 4;
+    static constexpr size_t MAX_SAMPLE_HISTORY = 64;
+
+public:
+    using PassTiming = Renderer::PassTiming;
+
+    PassTimingManager() noexcept = default;
+
+    // frees driver resources, must be called before destruction
+    void terminate(backend::DriverApi& driver) noexcept;
+
+    void setEnabled(bool enabled) noexcept { mEnabled = enabled; }
+    bool isEnabled() const noexcept { return mEnabled; }
+
+    // call once at the beginning of the frame, harvests the queries that completed
+    void beginFrame(backend::DriverApi& driver) noexcept;
+
+    // brackets the GPU work of a single pass, passes must not nest
+    void beginPass(backend::DriverApi& driver, const char* name) noexcept;
+    void endPass(backend::DriverApi& driver) noexcept;
+
+    // fills timings with up to count per-pass entries, returns the number written
+    size_t getPassTimings(PassTiming* timings, size_t count) const noexcept;
+
+    // sum of the most recent sample of every pass, i.e. the GPU cost of a whole frame,
+    // in milliseconds; 0 if no samples are available yet
+    float getLastFrameGpuTimeMs() const noexcept;
+
+private:
+    struct Slot {
+        utils::CString name;
+        backend::Handle<backend::HwTimerQuery> queries[POOL_COUNT];
+        uint32_t head = 0;          // next query to begin
+        uint32_t tail = 0;          // oldest query not yet harvested
+        uint32_t inFlight = 0;
+        // sample ring buffer, in milliseconds
+        std::array<float, MAX_SAMPLE_HISTORY> samples;
+        uint32_t cursor = 0;        // next sample to overwrite
+        uint32_t sampleCount = 0;   // valid samples, saturates at MAX_SAMPLE_HISTORY
+    };
+
+    Slot& getSlot(backend::DriverApi& driver, const char* name) noexcept;
+
+    std::vector<Slot> mSlots;
+    // keys point into the slots' own name storage, which outlives the map
+    tsl::robin_map<const char*, uint32_t,
+            utils::hashCStrings, utils::equalCStrings> mSlotIndices;
+    Slot* mCurrentPass = nullptr;
+    bool mEnabled = false;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_PASSTIMINGMANAGER_H
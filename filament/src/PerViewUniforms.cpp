@@ -235,20 +235,43 @@ void PerViewUniforms::prepareDirectionalLight(
 }
 
 void PerViewUniforms::prepareAmbientLight(FIndirectLight const& ibl,
-        float intensity, float exposure) noexcept {
+        float intensity, float exposure,
+        FIndirectLight const* blendTarget, float blend) noexcept {
     auto& engine = mEngine;
     auto& s = mPerViewUb.edit();
 
+    // When a blend target is set, the two environments are combined here: spherical harmonics
+    // and intensity are interpolated on the CPU (9 lerps per frame), which keeps the ambient
+    // term perfectly smooth without touching any texture. The prefiltered reflections come
+    // from whichever environment dominates -- cross-fading those would need a second cubemap
+    // sampler in the lighting shader.
+    FIndirectLight const* dominant = &ibl;
+    if (UTILS_UNLIKELY(blendTarget)) {
+        blend = math::clamp(blend, 0.0f, 1.0f);
+        intensity = mix(intensity, blendTarget->getIntensity(), blend);
+        if (blend >= 0.5f) {
+            dominant = blendTarget;
+        }
+    }
+
     // Set up uniforms and sampler for the IBL, guaranteed to be non-null at this point.
-    float iblRoughnessOneLevel = ibl.getLevelCount() - 1.0f;
+    float iblRoughnessOneLevel = dominant->getLevelCount() - 1.0f;
     s.iblRoughnessOneLevel = iblRoughnessOneLevel;
     s.iblLuminance = intensity * exposure;
-    std::transform(ibl.getSH(), ibl.getSH() + 9, s.iblSH, [](float3 v) {
-        return float4(v, 0.0f);
-    });
+    if (UTILS_UNLIKELY(blendTarget)) {
+        float3 const* const sh0 = ibl.getSH();
+        float3 const* const sh1 = blendTarget->getSH();
+        for (size_t i = 0; i < 9; i++) {
+            s.iblSH[i] = float4(mix(sh0[i], sh1[i], blend), 0.0f);
+        }
+    } else {
+        std::transform(ibl.getSH(), ibl.getSH() + 9, s.iblSH, [](float3 v) {
+            return float4(v, 0.0f);
+        });
+    }
 
     // We always sample from the reflection texture, so provide a dummy texture if necessary.
-    Handle<HwTexture> reflection = ibl.getReflectionHwHandle();
+    Handle<HwTexture> reflection = dominant->getReflectionHwHandle();
     if (!reflection) {
         reflection = engine.getDummyCubemap()->getHwHandle();
     }
@@ -328,13 +351,59 @@ void PerViewUniforms::prepareShadowPCSS(Handle <HwTexture> texture,
 
 void PerViewUniforms::commit(backend::DriverApi& driver) noexcept {
     if (mPerViewUb.isDirty()) {
-        driver.updateBufferObject(mPerViewUbh, mPerViewUb.toBufferDescriptor(driver), 0);
+        commitDirtyRanges(driver);
     }
     if (mPerViewSb.isDirty()) {
         driver.updateSamplerGroup(mPerViewSbh, std::move(mPerViewSb.toCommandStream()));
     }
 }
 
+void PerViewUniforms::commitDirtyRanges(backend::DriverApi& driver) noexcept {
+    // Upload only the byte ranges that changed since the last commit. Most of the block
+    // (IBL SH, fog, exposure, shadow parameters...) is stable from frame to frame, so
+    // with several views sharing an engine this shrinks the per-view upload from the
+    // whole ~2 KiB block to a few cache lines, and small sub-range updates let the
+    // backend avoid renaming the whole buffer.
+    const size_t size = mPerViewUb.getSize();
+    char const* const cur = reinterpret_cast<char const*>(&mPerViewUb.edit());
+    char* const gpu = reinterpret_cast<char*>(&mCommitted);
+
+    if (UTILS_UNLIKELY(!mCommittedValid)) {
+        mCommittedValid = true;
+        memcpy(gpu, cur, size);
+        driver.updateBufferObject(mPerViewUbh, mPerViewUb.toBufferDescriptor(driver), 0);
+        return;
+    }
+
+    // compare in cache-line-sized blocks and upload each contiguous run of dirty blocks
+    constexpr size_t BLOCK_SIZE = 64;
+    size_t runBegin = 0;
+    bool inRun = false;
+    for (size_t i = 0; i < size; i += BLOCK_SIZE) {
+        const size_t n = std::min(BLOCK_SIZE, size - i);
+        const bool dirty = memcmp(cur + i, gpu + i, n) != 0;
+        if (dirty != inRun) {
+            if (dirty) {
+                runBegin = i;
+            } else {
+                memcpy(gpu + runBegin, cur + runBegin, i - runBegin);
+                driver.updateBufferObject(mPerViewUbh,
+                        mPerViewUb.toBufferDescriptor(driver, runBegin, i - runBegin),
+                        uint32_t(runBegin));
+            }
+            inRun = dirty;
+        }
+    }
+    if (inRun) {
+        memcpy(gpu + runBegin, cur + runBegin, size - runBegin);
+        driver.updateBufferObject(mPerViewUbh,
+                mPerViewUb.toBufferDescriptor(driver, runBegin, size - runBegin),
+                uint32_t(runBegin));
+    }
+    // handles the case where dirty uniforms were rewritten with identical values
+    mPerViewUb.clean();
+}
+
 void PerViewUniforms::bind(backend::DriverApi& driver) noexcept {
     driver.bindUniformBuffer(BindingPoints::PER_VIEW, mPerViewUbh);
     driver.bindSamplers(BindingPoints::PER_VIEW, mPerViewSbh);
@@ -86,7 +86,8 @@ public:
     void prepareDirectionalLight(float exposure,
             math::float3 const& sceneSpaceDirection, LightManagerInstance instance) noexcept;
 
-    void prepareAmbientLight(FIndirectLight const& ibl, float intensity, float exposure) noexcept;
+    void prepareAmbientLight(FIndirectLight const& ibl, float intensity, float exposure,
+            FIndirectLight const* blendTarget, float blend) noexcept;
 
     void prepareDynamicLights(Froxelizer& froxelizer) noexcept;
 
@@ -96,7 +97,8 @@ public:
     void prepareShadowDPCF(TextureHandle texture, SoftShadowOptions const& options) noexcept;
     void prepareShadowPCSS(TextureHandle texture, SoftShadowOptions const& options) noexcept;
 
-    // update local data into GPU UBO
+    // update local data into GPU UBO. Only the byte ranges that changed since the last
+    // commit are uploaded, so stable fields (IBL, fog, exposure...) cost nothing per frame.
     void commit(backend::DriverApi& driver) noexcept;
 
     // bind this UBO
@@ -105,9 +107,15 @@ public:
     void unbindSamplers() noexcept;
 
 private:
+    void commitDirtyRanges(backend::DriverApi& driver) noexcept;
+
     FEngine& mEngine;
     math::float2 mClipControl{};
     TypedUniformBuffer<PerViewUib> mPerViewUb;
+    // copy of the UBO content currently on the GPU, used by commit() to upload only the
+    // byte ranges that actually changed
+    PerViewUib mCommitted;
+    bool mCommittedValid = false;
     backend::SamplerGroup mPerViewSb;
     backend::Handle<backend::HwSamplerGroup> mPerViewSbh;
     backend::Handle<backend::HwBufferObject> mPerViewUbh;
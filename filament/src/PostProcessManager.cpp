@@ -46,6 +46,7 @@
 #include <math/mat2.h>
 
 #include <algorithm>
+#include <cstdlib>
 #include <limits>
 
 namespace filament {
@@ -202,6 +203,8 @@ struct MaterialInfo {
 };
 
 static const MaterialInfo sMaterialList[] = {
+        { "autoExposureAdaptation",     MATERIAL(AUTOEXPOSUREADAPTATION) },
+        { "autoExposureLuminance",      MATERIAL(AUTOEXPOSURELUMINANCE) },
         { "bilateralBlur",              MATERIAL(BILATERALBLUR) },
         { "bilateralBlurBentNormals",   MATERIAL(BILATERALBLURBENTNORMALS) },
         { "blitLow",                    MATERIAL(BLITLOW) },
@@ -246,6 +249,10 @@ void PostProcessManager::init() noexcept {
     //debugRegistry.registerProperty("d.ssao.kernelSize", &engine.debug.ssao.kernelSize);
     //debugRegistry.registerProperty("d.ssao.stddev", &engine.debug.ssao.stddev);
 
+    FDebugRegistry& debugRegistry = engine.getDebugRegistry();
+    debugRegistry.registerProperty("d.taa.frames", &engine.debug.taa.frames);
+    debugRegistry.registerProperty("d.taa.history_rejections", &engine.debug.taa.history_rejections);
+
     mWorkaroundSplitEasu = driver.isWorkaroundNeeded(Workaround::SPLIT_EASU);
 
     #pragma nounroll
@@ -316,7 +323,7 @@ void PostProcessManager::commitAndRender(FrameGraphResources::RenderPassInfo con
     mi->commit(driver);
     mi->use(driver);
     driver.beginRenderPass(out.target, out.params);
-    driver.draw(material.getPipelineState(variant), mEngine.getFullScreenRenderPrimitive());
+    driver.draw(material.getPipelineState(variant), mEngine.getFullScreenRenderPrimitive(), 1);
     driver.endRenderPass();
 }
 
@@ -339,6 +346,11 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::structure(FrameGraph& fg,
     //    - ssao
     //    - contact shadows
     // It consists of a mipmapped depth pass, tuned for SSAO
+    //
+    // This is the single geometry pre-pass of the frame; anything else that needs per-pixel
+    // scene data ahead of the color pass (e.g. a future motion-vector attachment for
+    // TAA/DoF/motion blur) should be produced here as an additional attachment rather than
+    // with its own geometry pass.
     struct StructurePassData {
         FrameGraphId<FrameGraphTexture> depth;
         FrameGraphId<FrameGraphTexture> picking;
@@ -439,6 +451,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::structure(FrameGraph& fg,
 
 FrameGraphId<FrameGraphTexture> PostProcessManager::screenSpaceAmbientOcclusion(FrameGraph& fg,
         filament::Viewport const& svp, const CameraInfo& cameraInfo,
+        FrameHistory& frameHistory,
         AmbientOcclusionOptions const& options) noexcept {
 
     FEngine& engine = mEngine;
@@ -447,6 +460,30 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::screenSpaceAmbientOcclusion(
     FrameGraphId<FrameGraphTexture> depth = fg.getBlackboard().get<FrameGraphTexture>("structure");
     assert_invariant(depth);
 
+    // Temporal amortization: if the previous frame's AO buffer is still fresh enough and
+    // matches the current resolution, reuse it as-is instead of recomputing it. Ownership
+    // of the buffer is carried forward to the current history entry, so it survives the
+    // history commit at the end of the frame.
+    const uint8_t updateInterval = options.updateInterval;
+    if (updateInterval > 1) {
+        auto& previous = frameHistory[0];
+        auto const& depthDesc = fg.getDescriptor(depth);
+        if (previous.ssao.handle &&
+                previous.ssaoAge + 1u < uint32_t(updateInterval) &&
+                previous.ssaoDesc.width == depthDesc.width &&
+                previous.ssaoDesc.height == depthDesc.height) {
+            auto& current = frameHistory.getCurrent();
+            current.ssao = previous.ssao;
+            current.ssaoDesc = previous.ssaoDesc;
+            current.ssaoAge = previous.ssaoAge + 1u;
+            previous.ssao = {};
+            FrameGraphId<FrameGraphTexture> const reused = fg.import("Reused SSAO buffer",
+                    current.ssaoDesc, FrameGraphTexture::Usage::SAMPLEABLE, current.ssao);
+            fg.getBlackboard().put("ssao", reused);
+            return reused;
+        }
+    }
+
     const size_t levelCount = fg.getDescriptor(depth).levels;
 
     // With q the standard deviation,
@@ -650,7 +687,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::screenSpaceAmbientOcclusion(
                 pipeline.rasterState.depthFunc = RasterState::DepthFunc::L;
 
                 driver.beginRenderPass(ssao.target, ssao.params);
-                driver.draw(pipeline, fullScreenRenderPrimitive);
+                driver.draw(pipeline, fullScreenRenderPrimitive, 1);
                 driver.endRenderPass();
             });
 
@@ -670,6 +707,25 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::screenSpaceAmbientOcclusion(
                 config);
     }
 
+    if (updateInterval > 1) {
+        // detach the final AO buffer into the frame history, so the next frames can
+        // reuse it; same idiom as the color history export in FRenderer
+        struct ExportSSAOData {
+            FrameGraphId<FrameGraphTexture> ssao;
+        };
+        fg.addPass<ExportSSAOData>("Export SSAO history",
+                [&](FrameGraph::Builder& builder, auto& data) {
+                    builder.sideEffect();
+                    data.ssao = builder.sample(ssao);
+                },
+                [&frameHistory](FrameGraphResources const& resources, auto const& data,
+                        DriverApi&) {
+                    FrameHistoryEntry& current = frameHistory.getCurrent();
+                    resources.detach(data.ssao, &current.ssao, &current.ssaoDesc);
+                    current.ssaoAge = 0;
+                });
+    }
+
     fg.getBlackboard().put("ssao", ssao);
     return ssao;
 }
@@ -766,7 +822,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::bilateralBlurPass(
                 pipeline.rasterState.depthFunc = RasterState::DepthFunc::L;
 
                 driver.beginRenderPass(blurred.target, blurred.params);
-                driver.draw(pipeline, fullScreenRenderPrimitive);
+                driver.draw(pipeline, fullScreenRenderPrimitive, 1);
                 driver.endRenderPass();
             });
 
@@ -930,7 +986,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::gaussianBlurPass(FrameGraph&
                 // we don't need to call use() here, since it's the same material
 
                 driver.beginRenderPass(hwOutRT.target, hwOutRT.params);
-                driver.draw(separableGaussianBlur.getPipelineState(), fullScreenRenderPrimitive);
+                driver.draw(separableGaussianBlur.getPipelineState(), fullScreenRenderPrimitive, 1);
                 driver.endRenderPass();
             });
 
@@ -1278,7 +1334,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::dof(FrameGraph& fg,
                     mi->setParameter("pixelSize", 1.0f / float2{w, h});
                     mi->commit(driver);
                     driver.beginRenderPass(out.target, out.params);
-                    driver.draw(pipeline, fullScreenRenderPrimitive);
+                    driver.draw(pipeline, fullScreenRenderPrimitive, 1);
                     driver.endRenderPass();
                 }
                 driver.setMinMaxLevels(inOutColor, 0, mipmapCount - 1u);
@@ -1627,12 +1683,19 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::bloomPass(FrameGraph& fg,
     inoutBloomOptions.levels = std::min(inoutBloomOptions.levels, maxLevels);
     inoutBloomOptions.levels = std::min(inoutBloomOptions.levels, kMaxBloomLevels);
 
-    if (2 * width < desc.width || 2 * height < desc.height) {
-        // if we're scaling down by more than 2x, prescale the image with a blit to improve
-        // performance. This is important on mobile/tilers.
+    // If we're scaling down by more than 2x, prescale the image with a chain of half-size
+    // blits until the source is within 2x of the bloom buffer. This is important on
+    // mobile/tilers: a single large reduction makes the first downsample's scattered taps
+    // defeat the texture cache (and alias), while each extra half-size blit only costs a
+    // quarter of the previous one's bandwidth.
+    uint32_t prescaleWidth  = desc.width;
+    uint32_t prescaleHeight = desc.height;
+    while (2 * width < prescaleWidth || 2 * height < prescaleHeight) {
+        prescaleWidth  = std::max(width,  prescaleWidth  / 2);
+        prescaleHeight = std::max(height, prescaleHeight / 2);
         input = opaqueBlit(fg, input, {
-                .width = desc.width / 2,
-                .height = desc.height / 2,
+                .width = prescaleWidth,
+                .height = prescaleHeight,
                 .format = outFormat
         });
     }
@@ -1696,7 +1759,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::bloomPass(FrameGraph& fg,
                         hwOutRT.params.flags.discardStart = TargetBufferFlags::COLOR;
                         hwOutRT.params.flags.discardEnd = TargetBufferFlags::NONE;
                         driver.beginRenderPass(hwOutRT.target, hwOutRT.params);
-                        driver.draw(pipeline, fullScreenRenderPrimitive);
+                        driver.draw(pipeline, fullScreenRenderPrimitive, 1);
                         driver.endRenderPass();
 
                         // prepare the next level
@@ -1804,7 +1867,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::bloomPass(FrameGraph& fg,
                         mi->commit(driver);
 
                         driver.beginRenderPass(hwDstRT.target, hwDstRT.params);
-                        driver.draw(pipeline, fullScreenRenderPrimitive);
+                        driver.draw(pipeline, fullScreenRenderPrimitive, 1);
                         driver.endRenderPass();
                     }
 
@@ -1889,7 +1952,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::bloomPass(FrameGraph& fg,
                         hwDstRT.params.flags.discardStart = TargetBufferFlags::COLOR;
                         hwDstRT.params.flags.discardEnd = TargetBufferFlags::NONE;
                         driver.beginRenderPass(hwDstRT.target, hwDstRT.params);
-                        driver.draw(pipeline, fullScreenRenderPrimitive);
+                        driver.draw(pipeline, fullScreenRenderPrimitive, 1);
                         driver.endRenderPass();
 
                         // prepare the next level
@@ -1953,7 +2016,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::bloomPass(FrameGraph& fg,
                         mi->commit(driver);
 
                         driver.beginRenderPass(hwDstRT.target, hwDstRT.params);
-                        driver.draw(pipeline, fullScreenRenderPrimitive);
+                        driver.draw(pipeline, fullScreenRenderPrimitive, 1);
                         driver.endRenderPass();
                     }
 
@@ -2046,7 +2109,7 @@ void PostProcessManager::colorGradingSubpass(DriverApi& driver,
             PostProcessVariant::TRANSLUCENT : PostProcessVariant::OPAQUE);
 
     driver.nextSubpass();
-    driver.draw(material.getPipelineState(variant), fullScreenRenderPrimitive);
+    driver.draw(material.getPipelineState(variant), fullScreenRenderPrimitive, 1);
 }
 
 
@@ -2065,7 +2128,7 @@ void PostProcessManager::customResolveSubpass(DriverApi& driver) noexcept {
     FMaterialInstance* mi = material.getMaterialInstance();
     mi->use(driver);
     driver.nextSubpass();
-    driver.draw(material.getPipelineState(), fullScreenRenderPrimitive);
+    driver.draw(material.getPipelineState(), fullScreenRenderPrimitive, 1);
 }
 
 FrameGraphId<FrameGraphTexture> PostProcessManager::customResolveUncompressPass(FrameGraph& fg,
@@ -2323,6 +2386,11 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::taa(FrameGraph& fg,
     auto& taa = fg.addPass<TAAData>("TAA",
             [&](FrameGraph::Builder& builder, auto& data) {
                 auto desc = fg.getDescriptor(input);
+                if (taaOptions.reducedHistoryPrecision && !colorGradingConfig.translucent) {
+                    // the TAA output doubles as next frame's history; R11G11B10 halves the
+                    // bandwidth of its read-modify-write cycle
+                    desc.format = TextureFormat::R11F_G11F_B10F;
+                }
                 data.color = builder.sample(input);
                 data.depth = builder.sample(depth);
                 data.history = builder.sample(colorHistory);
@@ -2382,20 +2450,35 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::taa(FrameGraph& fg,
                 auto depth = resources.getTexture(data.depth);
                 auto history = resources.getTexture(data.history);
 
+                mat4f const reprojection =
+                        *historyProjection * inverse(current.projection) * normalizedToClip;
+
+                // Catastrophic history failure (camera cut, teleport): if the mid-depth
+                // reprojection of the screen center lands more than a quarter of NDC away, or
+                // behind the camera, the history is stale everywhere and feeding it back only
+                // produces a long-lived ghost. Raise the current-frame weight instead so we
+                // re-converge within a few frames.
+                float alpha = taaOptions.feedback;
+                float4 const q = reprojection * float4{ 0.5f, 0.5f, 0.5f, 1.0f };
+                float2 const d = q.xy * (1.0f / q.w);
+                mEngine.debug.taa.frames++;
+                if (UTILS_UNLIKELY(q.w <= 0.0f ||
+                        !(std::abs(d.x) < 0.25f && std::abs(d.y) < 0.25f))) {
+                    alpha = std::max(alpha, 0.5f);
+                    mEngine.debug.taa.history_rejections++;
+                }
+
                 auto const& material = getPostProcessMaterial("taa");
                 FMaterialInstance* mi = material.getMaterialInstance();
                 mi->setParameter("color",  color, {});  // nearest
                 mi->setParameter("depth",  depth, {});  // nearest
-                mi->setParameter("alpha", taaOptions.feedback);
+                mi->setParameter("alpha", alpha);
                 mi->setParameter("history", history, {
                         .filterMag = SamplerMagFilter::LINEAR,
                         .filterMin = SamplerMinFilter::LINEAR
                 });
                 mi->setParameter("filterWeights",  weights, 9);
-                mi->setParameter("reprojection",
-                        *historyProjection *
-                        inverse(current.projection) *
-                        normalizedToClip);
+                mi->setParameter("reprojection", reprojection);
 
                 mi->commit(driver);
                 mi->use(driver);
@@ -2407,7 +2490,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::taa(FrameGraph& fg,
                     out.params.subpassMask = 1;
                 }
                 driver.beginRenderPass(out.target, out.params);
-                driver.draw(material.getPipelineState(variant), mEngine.getFullScreenRenderPrimitive());
+                driver.draw(material.getPipelineState(variant), mEngine.getFullScreenRenderPrimitive(), 1);
                 if (colorGradingConfig.asSubpass) {
                     colorGradingSubpass(driver, colorGradingConfig);
                 }
@@ -2416,6 +2499,129 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::taa(FrameGraph& fg,
     return colorGradingConfig.asSubpass ? taa->tonemappedOutput : taa->output;
 }
 
+void PostProcessManager::autoExposure(FrameGraph& fg,
+        FrameGraphId<FrameGraphTexture> input, FrameHistory& frameHistory,
+        AutoExposureOptions const& options, float* adaptedLuminance) noexcept {
+
+    FrameHistoryEntry const& entry = frameHistory[0];
+
+    float adaptationRate = math::clamp(options.adaptationRate, 0.0f, 1.0f);
+    FrameGraphId<FrameGraphTexture> history;
+    if (UTILS_LIKELY(entry.adaptedLuminance.handle)) {
+        history = fg.import("Adapted luminance history", entry.adaptedLuminanceDesc,
+                FrameGraphTexture::Usage::SAMPLEABLE, entry.adaptedLuminance);
+    } else {
+        // no history yet, converge to the metered value immediately
+        adaptationRate = 1.0f;
+    }
+
+    // The log-luminance of the color buffer is rendered into a small mipmapped target and
+    // reduced to its 1x1 top mip, i.e. we meter the geometric mean of the frame's luminance.
+    // The backend has no compute, so a histogram-based metering isn't possible, but the
+    // log-average is just as good at driving exposure and the reduction is a plain mip chain.
+    constexpr uint32_t kLuminanceSize = 128u;
+    constexpr uint8_t kLuminanceLevels = 8u;    // 128x128 down to 1x1
+
+    struct LuminanceData {
+        FrameGraphId<FrameGraphTexture> input;
+        FrameGraphId<FrameGraphTexture> luminance;
+    };
+    auto& luminancePass = fg.addPass<LuminanceData>("Auto-exposure luminance",
+            [&](FrameGraph::Builder& builder, auto& data) {
+                data.input = builder.sample(input);
+                data.luminance = builder.createTexture("Log-luminance buffer", {
+                        .width = kLuminanceSize, .height = kLuminanceSize,
+                        .levels = kLuminanceLevels,
+                        .format = TextureFormat::R16F });
+                data.luminance = builder.write(data.luminance,
+                        FrameGraphTexture::Usage::COLOR_ATTACHMENT);
+                builder.declareRenderPass("Log-luminance target", {
+                        .attachments = { .color = { data.luminance }}
+                });
+            },
+            [=](FrameGraphResources const& resources, auto const& data, DriverApi& driver) {
+                auto const& material = getPostProcessMaterial("autoExposureLuminance");
+                FMaterialInstance* mi = material.getMaterialInstance();
+                mi->setParameter("color", resources.getTexture(data.input), {
+                        .filterMag = SamplerMagFilter::LINEAR,
+                        .filterMin = SamplerMinFilter::LINEAR
+                });
+                commitAndRender(resources.getRenderPassInfo(), material, driver);
+            });
+
+    struct AdaptationData {
+        FrameGraphId<FrameGraphTexture> luminance;
+        FrameGraphId<FrameGraphTexture> history;
+        FrameGraphId<FrameGraphTexture> output;
+    };
+    auto& adaptationPass = fg.addPass<AdaptationData>("Auto-exposure adaptation",
+            [&](FrameGraph::Builder& builder, auto& data) {
+                data.luminance = builder.sample(luminancePass->luminance);
+                // with no history we blend the metered value with itself (rate is 1 anyway)
+                data.history = history ? builder.sample(history) : data.luminance;
+                data.output = builder.createTexture("Adapted luminance", {
+                        .width = 1u, .height = 1u,
+                        .format = TextureFormat::R16F });
+                data.output = builder.write(data.output,
+                        FrameGraphTexture::Usage::COLOR_ATTACHMENT);
+                builder.declareRenderPass("Adapted luminance target", {
+                        .attachments = { .color = { data.output }}
+                });
+                // the readback below must not be culled
+                builder.sideEffect();
+            },
+            [=](FrameGraphResources const& resources, auto const& data, DriverApi& driver) {
+                auto luminance = resources.getTexture(data.luminance);
+
+                // all backends implement this as a blit chain, much cheaper than a chain of
+                // explicit downsampling passes
+                driver.generateMipmaps(luminance);
+
+                auto const& material = getPostProcessMaterial("autoExposureAdaptation");
+                FMaterialInstance* mi = material.getMaterialInstance();
+                mi->setParameter("luminance", luminance, {
+                        .filterMin = SamplerMinFilter::LINEAR_MIPMAP_NEAREST
+                });
+                mi->setParameter("history", resources.getTexture(data.history), {});
+                mi->setParameter("level", float(kLuminanceLevels - 1u));
+                mi->setParameter("adaptationRate", adaptationRate);
+
+                auto const out = resources.getRenderPassInfo();
+                commitAndRender(out, material, driver);
+
+                // Asynchronous readback of the adapted value for application logic: the
+                // callback runs on the main thread a few frames later, without ever
+                // stalling the pipeline. The history stays in log2 space, the application
+                // gets linear luminance.
+                float* const result = static_cast<float*>(malloc(sizeof(float)));
+                driver.readPixels(out.target, 0, 0, 1, 1, {
+                        result, sizeof(float),
+                        PixelDataFormat::R, PixelDataType::FLOAT,
+                        +[](void* buffer, size_t, void* user) {
+                            *static_cast<float*>(user) =
+                                    std::exp2(*static_cast<float*>(buffer));
+                            free(buffer);
+                        }, adaptedLuminance });
+            });
+
+    // detach the adapted luminance into the frame history, so the next frame can
+    // continue the adaptation from it; same idiom as the color history export in FRenderer
+    struct ExportAdaptedLuminanceData {
+        FrameGraphId<FrameGraphTexture> adapted;
+    };
+    fg.addPass<ExportAdaptedLuminanceData>("Export adapted luminance",
+            [&](FrameGraph::Builder& builder, auto& data) {
+                builder.sideEffect();
+                data.adapted = builder.sample(adaptationPass->output);
+            },
+            [&frameHistory](FrameGraphResources const& resources, auto const& data,
+                    DriverApi&) {
+                FrameHistoryEntry& current = frameHistory.getCurrent();
+                resources.detach(data.adapted, &current.adaptedLuminance,
+                        &current.adaptedLuminanceDesc);
+            });
+}
+
 FrameGraphId<FrameGraphTexture> PostProcessManager::opaqueBlit(FrameGraph& fg,
         FrameGraphId<FrameGraphTexture> input, FrameGraphTexture::Descriptor const& outDesc,
         SamplerMagFilter filter) noexcept {
@@ -2590,7 +2796,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::blendBlit(
                     if (translucent) {
                         enableTranslucentBlending(pipeline);
                     }
-                    driver.draw(pipeline, fullScreenRenderPrimitive);
+                    driver.draw(pipeline, fullScreenRenderPrimitive, 1);
                 }
 
                 { // scope to not leak local variables
@@ -2604,7 +2810,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::blendBlit(
                     if (twoPassesEASU) {
                         pipeline.rasterState.depthFunc = backend::SamplerCompareFunc::NE;
                     }
-                    driver.draw(pipeline, fullScreenRenderPrimitive);
+                    driver.draw(pipeline, fullScreenRenderPrimitive, 1);
                 }
 
                 driver.endRenderPass();
@@ -2645,7 +2851,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::blendBlit(
 
                     PipelineState pipeline(material.getPipelineState(variant));
                     driver.beginRenderPass(out.target, out.params);
-                    driver.draw(pipeline, fullScreenRenderPrimitive);
+                    driver.draw(pipeline, fullScreenRenderPrimitive, 1);
                     driver.endRenderPass();
                 });
 
@@ -2786,7 +2992,7 @@ FrameGraphId<FrameGraphTexture> PostProcessManager::vsmMipmapPass(FrameGraph& fg
                 mi->use(driver);
 
                 driver.beginRenderPass(out.target, out.params);
-                driver.draw(pipeline, mEngine.getFullScreenRenderPrimitive());
+                driver.draw(pipeline, mEngine.getFullScreenRenderPrimitive(), 1);
                 driver.endRenderPass();
 
                 if (finalize) {
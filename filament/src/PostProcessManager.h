@@ -79,6 +79,7 @@ public:
     // SSAO
     FrameGraphId<FrameGraphTexture> screenSpaceAmbientOcclusion(FrameGraph& fg,
             filament::Viewport const& svp, const CameraInfo& cameraInfo,
+            FrameHistory& frameHistory,
             AmbientOcclusionOptions const& options) noexcept;
 
     // Gaussian mipmap
@@ -139,6 +140,14 @@ public:
             TemporalAntiAliasingOptions const& taaOptions,
             ColorGradingConfig colorGradingConfig) noexcept;
 
+    // Auto-exposure metering. Doesn't modify the image; the adapted average log-luminance is
+    // kept across frames in the FrameHistory and read back asynchronously into
+    // 'adaptedLuminance', which must outlive the readback (it lives in FView, which also
+    // owns the frame history).
+    void autoExposure(FrameGraph& fg,
+            FrameGraphId<FrameGraphTexture> input, FrameHistory& frameHistory,
+            AutoExposureOptions const& options, float* adaptedLuminance) noexcept;
+
     // Blit/rescaling/resolves
     FrameGraphId<FrameGraphTexture> opaqueBlit(FrameGraph& fg,
             FrameGraphId<FrameGraphTexture> input, FrameGraphTexture::Descriptor const& outDesc,
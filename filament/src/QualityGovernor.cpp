@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "QualityGovernor.h"
+
+#include <utils/compiler.h>
+
+#include <algorithm>
+
+namespace filament {
+
+void QualityGovernor::setEnabled(bool enabled, Callback callback, void* user) noexcept {
+    mEnabled = enabled;
+    mCallback = callback;
+    mUser = user;
+    mFrameCounter = 0;
+    mImprovedPolls = 0;
+    if (!enabled && mReduction != 0) {
+        // restore full quality and let the application know
+        mReduction = 0;
+        if (callback) {
+            callback(user, 0);
+        }
+    }
+}
+
+uint8_t QualityGovernor::targetForStatus(ThermalStatus status) noexcept {
+    switch (status) {
+        case ThermalStatus::ERROR:
+        case ThermalStatus::NONE:
+        case ThermalStatus::LIGHT:
+            return 0;
+        case ThermalStatus::MODERATE:
+            return 1;
+        case ThermalStatus::SEVERE:
+            return 2;
+        case ThermalStatus::CRITICAL:
+        case ThermalStatus::EMERGENCY:
+        case ThermalStatus::SHUTDOWN:
+            return MAX_REDUCTION;
+    }
+    return 0;
+}
+
+void QualityGovernor::update() noexcept {
+    if (UTILS_LIKELY(!mEnabled)) {
+        return;
+    }
+    if (mFrameCounter++ % POLL_INTERVAL != 0) {
+        return;
+    }
+
+    const ThermalStatus status = mThermalManager.getCurrentThermalStatus();
+    if (UTILS_UNLIKELY(status == ThermalStatus::ERROR)) {
+        return;
+    }
+
+    const uint8_t target = targetForStatus(status);
+    uint8_t reduction = mReduction;
+    if (target > reduction) {
+        // heating up: step down one level right away
+        reduction++;
+        mImprovedPolls = 0;
+    } else if (target < reduction) {
+        // cooling down: require the improvement to be sustained before stepping back
+        // up, so we don't oscillate around a thermal threshold
+        if (++mImprovedPolls >= STEP_UP_POLLS) {
+            reduction--;
+            mImprovedPolls = 0;
+        }
+    } else {
+        mImprovedPolls = 0;
+    }
+
+    if (reduction != mReduction) {
+        mReduction = reduction;
+        if (mCallback) {
+            mCallback(mUser, reduction);
+        }
+    }
+}
+
+} // namespace filament
@@ -0,0 +1,75 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_QUALITYGOVERNOR_H
+#define TNT_FILAMENT_QUALITYGOVERNOR_H
+
+#include <utils/ThermalManager.h>
+
+#include <stdint.h>
+
+namespace filament {
+
+/*
+ * QualityGovernor polls the platform's thermal status (utils::ThermalManager, a no-op
+ * outside of Android) and derives a quality reduction step that the engine's expensive
+ * knobs consult: ShadowMapManager halves its shadow-map resolution per step and the
+ * bloom pass reduces its resolution and level count.
+ *
+ * Stepping down is immediate once a worse thermal status is reported, stepping back up
+ * requires the improved status to be sustained, so quality doesn't oscillate around a
+ * thermal threshold. The application is notified of each step change via a callback and
+ * can adjust its own knobs as well.
+ */
+class QualityGovernor {
+public:
+    using ThermalStatus = utils::ThermalManager::ThermalStatus;
+    using Callback = void (*)(void* user, uint8_t reduction);
+
+    static constexpr uint8_t MAX_REDUCTION = 3;
+
+    void setEnabled(bool enabled, Callback callback, void* user) noexcept;
+    bool isEnabled() const noexcept { return mEnabled; }
+
+    // current reduction step, 0 (full quality) to MAX_REDUCTION
+    uint8_t getQualityReduction() const noexcept { return mReduction; }
+
+    // shadow-map dimension shift derived from the reduction step (one mip per step)
+    uint8_t getTextureSizeShift() const noexcept { return mReduction; }
+
+    // call once per frame on the main thread
+    void update() noexcept;
+
+private:
+    static uint8_t targetForStatus(ThermalStatus status) noexcept;
+
+    // poll the thermal API about once per second at 60Hz
+    static constexpr uint32_t POLL_INTERVAL = 60;
+    // consecutive improved polls required before stepping quality back up
+    static constexpr uint32_t STEP_UP_POLLS = 10;
+
+    utils::ThermalManager mThermalManager;
+    Callback mCallback = nullptr;
+    void* mUser = nullptr;
+    uint32_t mFrameCounter = 0;
+    uint32_t mImprovedPolls = 0;
+    uint8_t mReduction = 0;
+    bool mEnabled = false;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_QUALITYGOVERNOR_H
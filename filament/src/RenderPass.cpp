@@ -30,7 +30,12 @@
 #include <utils/JobSystem.h>
 #include <utils/Systrace.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
 #include <utility>
+#include <vector>
 
 using namespace utils;
 using namespace filament::math;
@@ -114,12 +119,13 @@ void RenderPass::appendCommands(CommandTypeFlags const commandTypeFlags) noexcep
     // we extract camera position/forward outside of the loop, because these are not cheap.
     const float3 cameraPosition(camera.getPosition());
     const float3 cameraForwardVector(camera.getForwardVector());
+    const uint8_t blendedBucketBits = mBlendedBucketBits;
     auto work = [commandTypeFlags, curr, &soa, variant, renderFlags, visibilityMask, cameraPosition,
-                 cameraForwardVector]
+                 cameraForwardVector, blendedBucketBits]
             (uint32_t startIndex, uint32_t indexCount) {
         RenderPass::generateCommands(commandTypeFlags, curr,
                 soa, { startIndex, startIndex + indexCount }, variant, renderFlags, visibilityMask,
-                cameraPosition, cameraForwardVector);
+                cameraPosition, cameraForwardVector, blendedBucketBits);
     };
 
     if (vr.size() <= JOBS_PARALLEL_FOR_COMMANDS_COUNT) {
@@ -136,6 +142,51 @@ void RenderPass::appendCommands(CommandTypeFlags const commandTypeFlags) noexcep
     curr[commandCount - 1].key = uint64_t(Pass::SENTINEL);
 }
 
+utils::JobSystem::Job* RenderPass::appendCommandsAsync(utils::JobSystem::Job* const parent,
+        CommandTypeFlags const commandTypeFlags) noexcept {
+    assert_invariant(mRenderableSoa);
+
+    JobSystem& js = mEngine.getJobSystem();
+
+    utils::Range<uint32_t> const vr = mVisibleRenderables;
+    if (UTILS_UNLIKELY(vr.empty())) {
+        return js.createJob(parent);
+    }
+
+    // the command storage is allocated here, serially: the command arena is not
+    // synchronized. note: the caller is responsible for keeping the summed primitive
+    // counts -- which live in the scene SoA and depend only on the geometry range --
+    // up-to-date (see updateSummedPrimitiveCounts()).
+    uint32_t commandCount = FScene::getPrimitiveCount(*mRenderableSoa, vr.last);
+    const bool colorPass  = bool(commandTypeFlags & CommandTypeFlags::COLOR);
+    const bool depthPass  = bool(commandTypeFlags & CommandTypeFlags::DEPTH);
+    commandCount *= uint32_t(colorPass * 2 + depthPass);
+    commandCount += 1; // for the sentinel
+    Command* const curr = append(commandCount);
+
+    return jobs::createJob(js, parent,
+            [this, commandTypeFlags, curr, commandCount]() {
+                utils::Range<uint32_t> const vr = mVisibleRenderables;
+                const float3 cameraPosition(mCamera.getPosition());
+                const float3 cameraForwardVector(mCamera.getForwardVector());
+                generateCommands(commandTypeFlags, curr, *mRenderableSoa, vr,
+                        mVariant, mFlags, mVisibilityMask,
+                        cameraPosition, cameraForwardVector, mBlendedBucketBits);
+                curr[commandCount - 1].key = uint64_t(Pass::SENTINEL);
+
+                // sort and trim the sentinels; unlike sortCommands() we don't return the
+                // trimmed tail to the arena: other concurrently recorded passes may have
+                // allocated right behind it. Waiting on the nested sort jobs from inside
+                // this job is fine, the worker executes other jobs in the meantime.
+                radixSortCommands(mEngine.getJobSystem(), mCommandBegin, mCommandEnd);
+                Command* const last = std::partition_point(mCommandBegin, mCommandEnd,
+                        [](Command const& c) {
+                            return c.key != uint64_t(Pass::SENTINEL);
+                        });
+                mCommandEnd = last;
+            });
+}
+
 void RenderPass::appendCustomCommand(Pass pass, CustomCommand custom, uint32_t order,
         std::function<void()> command) {
 
@@ -153,10 +204,134 @@ void RenderPass::appendCustomCommand(Pass pass, CustomCommand custom, uint32_t o
     curr->key = cmd;
 }
 
+/* static */
+void RenderPass::radixSortCommands(JobSystem& js, Command* const begin, Command* const end) noexcept {
+    size_t const count = size_t(end - begin);
+
+    // below this, introsort beats the histogram passes and the scratch allocation
+    constexpr size_t RADIX_SORT_MIN_COUNT = 4096;
+    // bins below this are sorted with introsort instead of the LSD radix passes
+    constexpr size_t RADIX_BIN_MIN_COUNT = 2048;
+    constexpr size_t BIN_COUNT = 256;               // one bin per value of the top key byte
+    constexpr unsigned BIN_SHIFT = 56;
+    constexpr size_t CHUNK_SIZE = 32768;            // granularity of the histogram/scatter jobs
+
+    if (count < RADIX_SORT_MIN_COUNT) {
+        std::sort(begin, end);
+        return;
+    }
+
+    Command* const scratch = static_cast<Command*>(malloc(count * sizeof(Command)));
+    if (UTILS_UNLIKELY(!scratch)) {
+        std::sort(begin, end);
+        return;
+    }
+
+    // level 1: bin the commands by their top key byte, stably, into the scratch buffer.
+    // Each chunk histograms its slice in parallel; the per-chunk histograms are then turned
+    // into per-chunk scatter bases so the chunks can also scatter in parallel without ever
+    // writing the same slot.
+    size_t const chunkCount = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    std::vector<std::array<uint32_t, BIN_COUNT>> histograms(chunkCount);
+
+    auto histogramWork = [begin, count, &histograms](uint32_t start, uint32_t n) {
+        for (uint32_t chunk = start; chunk < start + n; chunk++) {
+            auto& h = histograms[chunk];
+            h.fill(0);
+            size_t const s = size_t(chunk) * CHUNK_SIZE;
+            size_t const e = std::min(s + CHUNK_SIZE, count);
+            for (size_t i = s; i < e; i++) {
+                h[begin[i].key >> BIN_SHIFT]++;
+            }
+        }
+    };
+    js.runAndWait(jobs::parallel_for(js, nullptr, 0, uint32_t(chunkCount),
+            std::cref(histogramWork), jobs::CountSplitter<1, 8>()));
+
+    // prefix-sum the histograms into scatter bases, in bin-major order for stability
+    uint32_t binStart[BIN_COUNT + 1];
+    uint32_t offset = 0;
+    for (size_t bin = 0; bin < BIN_COUNT; bin++) {
+        binStart[bin] = offset;
+        for (auto& h : histograms) {
+            uint32_t const n = h[bin];
+            h[bin] = offset;
+            offset += n;
+        }
+    }
+    binStart[BIN_COUNT] = offset;
+    assert_invariant(offset == count);
+
+    auto scatterWork = [begin, count, scratch, &histograms](uint32_t start, uint32_t n) {
+        for (uint32_t chunk = start; chunk < start + n; chunk++) {
+            auto& h = histograms[chunk];    // per-chunk running scatter offsets
+            size_t const s = size_t(chunk) * CHUNK_SIZE;
+            size_t const e = std::min(s + CHUNK_SIZE, count);
+            for (size_t i = s; i < e; i++) {
+                scratch[h[begin[i].key >> BIN_SHIFT]++] = begin[i];
+            }
+        }
+    };
+    js.runAndWait(jobs::parallel_for(js, nullptr, 0, uint32_t(chunkCount),
+            std::cref(scatterWork), jobs::CountSplitter<1, 8>()));
+
+    // level 2: sort each bin independently by the remaining key bytes and move it back
+    // into [begin, end). Bins are independent, so they sort in parallel; work stealing
+    // evens out their very uneven sizes.
+    auto binWork = [begin, scratch, &binStart](uint32_t start, uint32_t n) {
+        for (uint32_t bin = start; bin < start + n; bin++) {
+            size_t const size = binStart[bin + 1] - binStart[bin];
+            if (size == 0) {
+                continue;
+            }
+            Command* const src = scratch + binStart[bin];
+            Command* const dst = begin + binStart[bin];
+
+            if (size < RADIX_BIN_MIN_COUNT) {
+                std::sort(src, src + size);
+                std::copy_n(src, size, dst);
+                continue;
+            }
+
+            // LSD radix over the low 7 key bytes, ping-ponging between the scratch bin
+            // and its final storage; passes where all keys share the same byte are free
+            Command* from = src;
+            Command* to = dst;
+            for (unsigned pass = 0; pass < 7; pass++) {
+                unsigned const shift = pass * 8;
+                uint32_t h[BIN_COUNT] = {};
+                for (size_t i = 0; i < size; i++) {
+                    h[(from[i].key >> shift) & 0xffu]++;
+                }
+                if (h[(from[0].key >> shift) & 0xffu] == size) {
+                    continue;   // single bucket, nothing to move
+                }
+                uint32_t o = 0;
+                for (size_t i = 0; i < BIN_COUNT; i++) {
+                    uint32_t const c = h[i];
+                    h[i] = o;
+                    o += c;
+                }
+                for (size_t i = 0; i < size; i++) {
+                    to[h[(from[i].key >> shift) & 0xffu]++] = from[i];
+                }
+                std::swap(from, to);
+            }
+            if (from != dst) {
+                std::copy_n(from, size, dst);
+            }
+        }
+    };
+    js.runAndWait(jobs::parallel_for(js, nullptr, 0, uint32_t(BIN_COUNT),
+            std::cref(binWork), jobs::CountSplitter<1, 8>()));
+
+    free(scratch);
+}
+
 void RenderPass::sortCommands() noexcept {
     SYSTRACE_NAME("sort and trim commands");
 
-    std::sort(mCommandBegin, mCommandEnd);
+    radixSortCommands(mEngine.getJobSystem(), mCommandBegin, mCommandEnd);
 
     // find the last command
     Command const* const last = std::partition_point(mCommandBegin, mCommandEnd,
@@ -167,16 +342,50 @@ void RenderPass::sortCommands() noexcept {
     resize(uint32_t(last - mCommandBegin));
 }
 
+/* static */
+UTILS_NOINLINE      // cold path, only taken when the cached material state went stale
+void RenderPass::refreshSortKeyCache(FRenderPrimitive const& primitive,
+        FMaterialInstance const* const UTILS_RESTRICT mi) noexcept {
+
+    FMaterial const * const UTILS_RESTRICT ma = mi->getMaterial();
+
+    BlendingMode blendingMode = ma->getBlendingMode();
+    bool hasScreenSpaceRefraction = ma->getRefractionMode() == RefractionMode::SCREEN_SPACE;
+    bool isBlendingCommand = !hasScreenSpaceRefraction &&
+            (blendingMode != BlendingMode::OPAQUE && blendingMode != BlendingMode::MASKED);
+
+    uint64_t key = uint64_t(hasScreenSpaceRefraction ? Pass::REFRACT : Pass::COLOR);
+    key |= uint64_t(CustomCommand::PASS);
+    key |= mi->getSortingKey(); // already all set-up for direct or'ing
+    key |= makeField(ma->getRasterState().alphaToCoverage, BLENDING_MASK, BLENDING_SHIFT);
+
+    RasterState rasterState = ma->getRasterState();
+    rasterState.culling = mi->getCullingMode();
+    rasterState.colorWrite = mi->getColorWrite();
+    rasterState.depthWrite = mi->getDepthWrite();
+    rasterState.depthFunc = mi->getDepthFunc();
+    // we keep "RasterState::colorWrite" to the value set by material (could be disabled)
+
+    primitive.updateSortKeyCache(key, rasterState, isBlendingCommand, mi->getStateVersion());
+}
+
 /* static */
 UTILS_ALWAYS_INLINE // this function exists only to make the code more readable. we want it inlined.
 inline              // and we don't need it in the compilation unit
 void RenderPass::setupColorCommand(Command& cmdDraw,
-        FMaterialInstance const* const UTILS_RESTRICT mi, bool inverseFrontFaces) noexcept {
+        FRenderPrimitive const& primitive, bool inverseFrontFaces) noexcept {
 
+    FMaterialInstance const* const UTILS_RESTRICT mi = primitive.getMaterialInstance();
     FMaterial const * const UTILS_RESTRICT ma = mi->getMaterial();
     Variant variant = Variant::filterVariant(
             cmdDraw.primitive.materialVariant, ma->isVariantLit());
 
+    // the material bits of the key and the derived raster state are cached on the primitive,
+    // they only change when the material instance's rendering state is modified.
+    if (UTILS_UNLIKELY(primitive.getCachedMaterialVersion() != mi->getStateVersion())) {
+        refreshSortKeyCache(primitive, mi);
+    }
+
     // Below, we evaluate both commands to avoid a branch
 
     uint64_t keyBlending = cmdDraw.key;
@@ -184,29 +393,32 @@ void RenderPass::setupColorCommand(Command& cmdDraw,
     keyBlending |= uint64_t(Pass::BLENDED);
     keyBlending |= uint64_t(CustomCommand::PASS);
 
-    BlendingMode blendingMode = ma->getBlendingMode();
-    bool hasScreenSpaceRefraction = ma->getRefractionMode() == RefractionMode::SCREEN_SPACE;
-    bool isBlendingCommand = !hasScreenSpaceRefraction &&
-            (blendingMode != BlendingMode::OPAQUE && blendingMode != BlendingMode::MASKED);
-
     uint64_t keyDraw = cmdDraw.key;
     keyDraw &= ~(PASS_MASK | BLENDING_MASK | MATERIAL_MASK);
-    keyDraw |= uint64_t(hasScreenSpaceRefraction ? Pass::REFRACT : Pass::COLOR);
-    keyDraw |= uint64_t(CustomCommand::PASS);
-    keyDraw |= mi->getSortingKey(); // already all set-up for direct or'ing
+    keyDraw |= primitive.getCachedColorKey();
     keyDraw |= makeField(variant.key, MATERIAL_VARIANT_KEY_MASK, MATERIAL_VARIANT_KEY_SHIFT);
-    keyDraw |= makeField(ma->getRasterState().alphaToCoverage, BLENDING_MASK, BLENDING_SHIFT);
 
-    cmdDraw.key = isBlendingCommand ? keyBlending : keyDraw;
-    cmdDraw.primitive.rasterState = ma->getRasterState();
+    cmdDraw.key = primitive.isCachedCommandBlended() ? keyBlending : keyDraw;
+    cmdDraw.primitive.rasterState = primitive.getCachedRasterState();
     cmdDraw.primitive.rasterState.inverseFrontFaces = inverseFrontFaces;
-    cmdDraw.primitive.rasterState.culling = mi->getCullingMode();
-    cmdDraw.primitive.rasterState.colorWrite = mi->getColorWrite();
-    cmdDraw.primitive.rasterState.depthWrite = mi->getDepthWrite();
-    cmdDraw.primitive.rasterState.depthFunc = mi->getDepthFunc();
     cmdDraw.primitive.mi = mi;
     cmdDraw.primitive.materialVariant = variant;
-    // we keep "RasterState::colorWrite" to the value set by material (could be disabled)
+}
+
+// Returns true when the primitive's bounding cone (see FRenderPrimitive::setBoundingCone)
+// faces entirely away from the camera, i.e. all its triangles are backfacing.
+static inline bool isConeBackfacing(FRenderPrimitive const& primitive,
+        math::mat4f const& model, float3 cameraPosition) noexcept {
+    float4 const centerRadius = primitive.getConeCenterRadius();
+    float4 const axisCutoff = primitive.getConeAxisCutoff();
+    // transform the cone to world space; the radius scales with the largest axis scale,
+    // which keeps the test conservative for non-uniform transforms
+    float3 const center = (model * float4{ centerRadius.xyz, 1.0f }).xyz;
+    float3 const axis = normalize(model.upperLeft() * axisCutoff.xyz);
+    float const scale = std::sqrt(std::max(std::max(
+            length2(model[0].xyz), length2(model[1].xyz)), length2(model[2].xyz)));
+    float3 const v = center - cameraPosition;
+    return dot(v, axis) >= axisCutoff.w * length(v) + centerRadius.w * scale;
 }
 
 /* static */
@@ -215,7 +427,8 @@ void RenderPass::generateCommands(uint32_t commandTypeFlags, Command* const comm
         FScene::RenderableSoa const& soa, Range<uint32_t> range,
         Variant variant, RenderFlags renderFlags,
         FScene::VisibleMaskType visibilityMask,
-        float3 cameraPosition, float3 cameraForward) noexcept {
+        float3 cameraPosition, float3 cameraForward,
+        uint8_t blendedBucketBits) noexcept {
 
     // generateCommands() writes both the draw and depth commands simultaneously such that
     // we go throw the list of renderables just once.
@@ -242,11 +455,13 @@ void RenderPass::generateCommands(uint32_t commandTypeFlags, Command* const comm
     switch (commandTypeFlags & (CommandTypeFlags::COLOR | CommandTypeFlags::DEPTH)) {
         case CommandTypeFlags::COLOR:
             generateCommandsImpl<CommandTypeFlags::COLOR>(commandTypeFlags, curr,
-                    soa, range, variant, renderFlags, visibilityMask, cameraPosition, cameraForward);
+                    soa, range, variant, renderFlags, visibilityMask, cameraPosition, cameraForward,
+                    blendedBucketBits);
             break;
         case CommandTypeFlags::DEPTH:
             generateCommandsImpl<CommandTypeFlags::DEPTH>(commandTypeFlags, curr,
-                    soa, range, variant, renderFlags, visibilityMask, cameraPosition, cameraForward);
+                    soa, range, variant, renderFlags, visibilityMask, cameraPosition, cameraForward,
+                    blendedBucketBits);
             break;
         default:
             // we should never end-up here
@@ -261,7 +476,8 @@ void RenderPass::generateCommandsImpl(uint32_t extraFlags,
         Command* UTILS_RESTRICT curr,
         FScene::RenderableSoa const& UTILS_RESTRICT soa, Range<uint32_t> range,
         Variant variant, RenderFlags renderFlags, FScene::VisibleMaskType visibilityMask,
-        float3 cameraPosition, float3 cameraForward) noexcept {
+        float3 cameraPosition, float3 cameraForward,
+        uint8_t blendedBucketBits) noexcept {
 
     // generateCommands() writes both the draw and depth commands simultaneously such that
     // we go throw the list of renderables just once.
@@ -278,6 +494,7 @@ void RenderPass::generateCommandsImpl(uint32_t extraFlags,
     const bool depthFilterAlphaMaskedObjects = bool(extraFlags & CommandTypeFlags::DEPTH_FILTER_ALPHA_MASKED_OBJECTS);
 
     auto const* const UTILS_RESTRICT soaWorldAABBCenter = soa.data<FScene::WORLD_AABB_CENTER>();
+    auto const* const UTILS_RESTRICT soaWorldTransform  = soa.data<FScene::WORLD_TRANSFORM>();
     auto const* const UTILS_RESTRICT soaVisibility      = soa.data<FScene::VISIBILITY_STATE>();
     auto const* const UTILS_RESTRICT soaPrimitives      = soa.data<FScene::PRIMITIVES>();
     auto const* const UTILS_RESTRICT soaMorphing        = soa.data<FScene::MORPHING_BUFFER>();
@@ -373,12 +590,24 @@ void RenderPass::generateCommandsImpl(uint32_t extraFlags,
          * When modifying this code, always ensure it stays efficient.
          */
         for (auto const& primitive : primitives) {
+            if constexpr (isColorPass) {
+                // cluster backface culling: skip primitives whose bounding cone faces
+                // entirely away from the camera (see RenderableManager::Builder::boundingCone)
+                if (UTILS_UNLIKELY(primitive.hasBoundingCone())) {
+                    if (isConeBackfacing(primitive, soaWorldTransform[i], cameraPosition)) {
+                        curr[0].key = uint64_t(Pass::SENTINEL);
+                        curr[1].key = uint64_t(Pass::SENTINEL);
+                        curr += 2;
+                        continue;
+                    }
+                }
+            }
             FMaterialInstance const* const mi = primitive.getMaterialInstance();
             FMorphTargetBuffer const* const morphTargetBuffer = primitive.getMorphTargetBuffer();
             if constexpr (isColorPass) {
                 cmdColor.primitive.primitiveHandle = primitive.getHwHandle();
                 cmdColor.primitive.materialVariant = variant;
-                RenderPass::setupColorCommand(cmdColor, mi, inverseFrontFaces);
+                RenderPass::setupColorCommand(cmdColor, primitive, inverseFrontFaces);
 
                 cmdColor.primitive.morphWeightBuffer = morphing.handle;
                 if (UTILS_UNLIKELY(morphTargetBuffer)) {
@@ -393,10 +622,30 @@ void RenderPass::generateCommandsImpl(uint32_t extraFlags,
                     // for a given Z value
                     cmdColor.key &= ~BLEND_ORDER_MASK;
                     cmdColor.key &= ~BLEND_DISTANCE_MASK;
-                    cmdColor.key |= makeField(~distanceBits,
-                            BLEND_DISTANCE_MASK, BLEND_DISTANCE_SHIFT);
-                    cmdColor.key |= makeField(primitive.getBlendOrder(),
-                            BLEND_ORDER_MASK, BLEND_ORDER_SHIFT);
+                    if (UTILS_UNLIKELY(blendedBucketBits)) {
+                        // bucketed blend pass:
+                        // quantize the distance into 2^bits buckets (still back-to-front)
+                        // and sort material-major within each bucket, trading a bounded
+                        // ordering error for fewer pipeline changes; blendOrder keeps only
+                        // its 5 most significant bits.
+                        const uint32_t bucket = (~distanceBits >> 22u)
+                                & (0x3FFu & ~((1u << (10u - blendedBucketBits)) - 1u));
+                        const uint64_t materialKey = (mi->getSortingKey()
+                                | makeField(cmdColor.primitive.materialVariant.key,
+                                        MATERIAL_VARIANT_KEY_MASK, MATERIAL_VARIANT_KEY_SHIFT))
+                                & MATERIAL_MASK;
+                        cmdColor.key |= makeField(bucket,
+                                BLEND_BUCKET_MASK, BLEND_BUCKET_SHIFT);
+                        cmdColor.key |= makeField(materialKey,
+                                BLEND_BUCKET_MATERIAL_MASK, BLEND_BUCKET_MATERIAL_SHIFT);
+                        cmdColor.key |= makeField(primitive.getBlendOrder() >> 10u,
+                                BLEND_BUCKET_ORDER_MASK, BLEND_BUCKET_ORDER_SHIFT);
+                    } else {
+                        cmdColor.key |= makeField(~distanceBits,
+                                BLEND_DISTANCE_MASK, BLEND_DISTANCE_SHIFT);
+                        cmdColor.key |= makeField(primitive.getBlendOrder(),
+                                BLEND_ORDER_MASK, BLEND_ORDER_SHIFT);
+                    }
 
                     const TransparencyMode mode = mi->getTransparencyMode();
 
@@ -545,6 +794,7 @@ void RenderPass::Executor::recordDriverCommands(FEngine& engine,
         Handle<HwBufferObject> uboHandle = mUboHandle;
         FMaterialInstance const* UTILS_RESTRICT mi = nullptr;
         FMaterial const* UTILS_RESTRICT ma = nullptr;
+        FMaterialInstance const* const miOverride = mMaterialInstanceOverride;
         auto const& customCommands = mCustomCommands;
 
         first--;
@@ -562,16 +812,30 @@ void RenderPass::Executor::recordDriverCommands(FEngine& engine,
             // per-renderable uniform
             const PrimitiveInfo info = first->primitive;
             pipeline.rasterState = info.rasterState;
-            if (UTILS_UNLIKELY(mi != info.mi)) {
+            FMaterialInstance const* const cmdMi = miOverride ? miOverride : info.mi;
+            if (UTILS_UNLIKELY(mi != cmdMi)) {
                 // this is always taken the first time
-                mi = info.mi;
+                mi = cmdMi;
                 ma = mi->getMaterial();
                 pipeline.scissor = mi->getScissor();
                 *pPipelinePolygonOffset = mi->getPolygonOffset();
                 mi->use(driver);
             }
 
-            pipeline.program = ma->getProgram(info.materialVariant);
+            Variant variant = info.materialVariant;
+            if (UTILS_UNLIKELY(miOverride)) {
+                // the override material is unlit, strip the lit-only variant bits but keep
+                // the vertex-affecting ones (e.g. skinning)
+                variant = Variant::filterVariant(info.materialVariant, false);
+                // only the per-primitive winding and culling are kept, everything else
+                // comes from the override material
+                auto rs = ma->getRasterState();
+                rs.culling = info.rasterState.culling;
+                rs.inverseFrontFaces = info.rasterState.inverseFrontFaces;
+                pipeline.rasterState = rs;
+            }
+
+            pipeline.program = ma->getProgram(variant);
             size_t offset = info.index * sizeof(PerRenderableUib);
             driver.bindUniformBufferRange(BindingPoints::PER_RENDERABLE,
                     uboHandle, offset, sizeof(PerRenderableUib));
@@ -603,7 +867,7 @@ void RenderPass::Executor::recordDriverCommands(FEngine& engine,
                 }
             }
 
-            driver.draw(pipeline, info.primitiveHandle);
+            driver.draw(pipeline, info.primitiveHandle, 1);
         }
     }
 }
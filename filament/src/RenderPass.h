@@ -30,6 +30,7 @@
 #include <backend/Handle.h>
 
 #include <utils/Allocator.h>
+#include <utils/JobSystem.h>
 #include <utils/Range.h>
 #include <utils/architecture.h>
 #include <utils/compiler.h>
@@ -42,6 +43,7 @@
 namespace filament {
 
 class FMaterialInstance;
+class FRenderPrimitive;
 
 class RenderPass {
 public:
@@ -79,6 +81,14 @@ public:
      *   | correctness                                                            |
      *
      *
+     *   BLENDED command, distance-bucketed variant (see setBlendedDistanceBucketing())
+     *   |   6  | 2| 2|1| 3 | 2|   10     |               32               |  5  |1|
+     *   +------+--+--+-+---+--+----------+--------------------------------+-----+-+
+     *   |000011|01|00|0|ppp|00| Z-bucket |          material-id           |order|t|
+     *   +------+--+--+-+---+--+----------+--------------------------------+-----+-+
+     *   | correctness      |      optimizations (truncation allowed)            | |
+     *
+     *
      *   pre-CUSTOM command
      *   |   6  | 2| 2|         22           |               32               |
      *   +------+--+--+----------------------+--------------------------------+
@@ -124,6 +134,15 @@ public:
     static constexpr uint64_t BLEND_DISTANCE_MASK           = 0xFFFFFFFF0000llu;
     static constexpr unsigned BLEND_DISTANCE_SHIFT          = 16;
 
+    static constexpr uint64_t BLEND_BUCKET_MASK             = 0xFFC000000000llu;
+    static constexpr unsigned BLEND_BUCKET_SHIFT            = 38;
+
+    static constexpr uint64_t BLEND_BUCKET_MATERIAL_MASK    = 0x003FFFFFFFC0llu;
+    static constexpr unsigned BLEND_BUCKET_MATERIAL_SHIFT   = 6;
+
+    static constexpr uint64_t BLEND_BUCKET_ORDER_MASK       = 0x3Ellu;
+    static constexpr unsigned BLEND_BUCKET_ORDER_SHIFT      = 1;
+
     static constexpr uint64_t MATERIAL_MASK                 = 0xFFFFFFFFllu;
     static constexpr unsigned MATERIAL_SHIFT                = 0;
 
@@ -180,6 +199,8 @@ public:
         SHADOW = DEPTH | DEPTH_CONTAINS_SHADOW_CASTERS,
         // generate commands for SSAO
         SSAO = DEPTH | DEPTH_FILTER_TRANSLUCENT_OBJECTS,
+        // generate commands for a depth pre-pass (alpha-masked objects included)
+        DEPTH_PREPASS = DEPTH | DEPTH_FILTER_TRANSLUCENT_OBJECTS,
     };
 
 
@@ -263,6 +284,10 @@ public:
     // if non-null, overrides the material's polygon offset
     void overridePolygonOffset(backend::PolygonOffset* polygonOffset) noexcept;
 
+    // if non-null, overrides the material of every surface command in this pass; used by the
+    // overdraw debug visualization (d.renderer.visualize_overdraw)
+    void overrideMaterial(FMaterialInstance const* mi) noexcept { mMaterialInstanceOverride = mi; }
+
     // specifies the geometry to generate commands for
     void setGeometry(FScene::RenderableSoa const& soa, utils::Range<uint32_t> vr,
             backend::Handle<backend::HwBufferObject> uboHandle) noexcept;
@@ -281,6 +306,14 @@ public:
     // Defaults to all 1's, which means all renderables in this render pass will be rendered.
     void setVisibilityMask(FScene::VisibleMaskType mask) noexcept { mVisibilityMask = mask; }
 
+    // Quantizes the distance sort of blended commands into 2^bits buckets and sorts
+    // material-major within each bucket (see the bucketed BLENDED key layout above).
+    // 0 (the default) sorts by exact distance. blendOrder keeps only its 5 most
+    // significant bits when bucketing is enabled.
+    void setBlendedDistanceBucketing(uint8_t bits) noexcept {
+        mBlendedBucketBits = bits < 10 ? bits : uint8_t(10);
+    }
+
     Command const* begin() const noexcept { return mCommandBegin; }
     Command const* end() const noexcept { return mCommandEnd; }
     bool empty() const noexcept { return begin() == end(); }
@@ -289,6 +322,21 @@ public:
     // the current camera, geometry and flags set. This can be called multiple times if needed.
     void appendCommands(CommandTypeFlags commandTypeFlags) noexcept;
 
+    // Like appendCommands() followed by sortCommands(), but performs the command
+    // generation and sorting in the returned job (not submitted), so several passes can
+    // be recorded concurrently. The command storage is allocated from the arena
+    // immediately -- the arena is not synchronized -- and the summed primitive counts for
+    // the geometry range must be up-to-date before the job runs (see
+    // updateSummedPrimitiveCounts()). Unlike sortCommands(), the trimmed tail is not
+    // returned to the arena, since other passes may have allocated right behind it.
+    utils::JobSystem::Job* appendCommandsAsync(utils::JobSystem::Job* parent,
+            CommandTypeFlags commandTypeFlags) noexcept;
+
+    // updates the summed primitive count for the given visible range; must be up-to-date
+    // before commands are generated for that range. appendCommands() does this implicitly.
+    static void updateSummedPrimitiveCounts(
+            FScene::RenderableSoa& renderableData, utils::Range<uint32_t> vr) noexcept;
+
     // Appends a custom command.
     void appendCustomCommand(Pass pass, CustomCommand custom, uint32_t order,
             std::function<void()> command);
@@ -296,6 +344,12 @@ public:
     // sorts commands, then trims sentinels
     void sortCommands() noexcept;
 
+    // Sorts commands by key with a two-level parallel radix sort: a bucketed histogram
+    // pass bins the commands by their top key byte on the JobSystem, then each bin is
+    // sorted independently (LSD radix over the remaining bytes, stable within bins).
+    // Falls back to std::sort below a size threshold, where introsort wins.
+    static void radixSortCommands(utils::JobSystem& js, Command* begin, Command* end) noexcept;
+
     // Helper to execute all the commands generated by this RenderPass
     void execute(const char* name,
             backend::Handle<backend::HwRenderTarget> renderTarget,
@@ -320,12 +374,14 @@ public:
         const backend::Handle<backend::HwBufferObject> mUboHandle;
         const backend::PolygonOffset mPolygonOffset;
         const bool mPolygonOffsetOverride;
+        FMaterialInstance const* const mMaterialInstanceOverride;
 
         Executor(RenderPass const* pass, Command const* b, Command const* e) noexcept
                 : mEngine(pass->mEngine), mBegin(b), mEnd(e), mRenderableSoa(*pass->mRenderableSoa),
                   mCustomCommands(pass->mCustomCommands), mUboHandle(pass->mUboHandle),
                   mPolygonOffset(pass->mPolygonOffset),
-                  mPolygonOffsetOverride(pass->mPolygonOffsetOverride) {
+                  mPolygonOffsetOverride(pass->mPolygonOffsetOverride),
+                  mMaterialInstanceOverride(pass->mMaterialInstanceOverride) {
             assert_invariant(b >= pass->begin());
             assert_invariant(e <= pass->end());
         }
@@ -369,19 +425,21 @@ private:
             FScene::RenderableSoa const& soa, utils::Range<uint32_t> range,
             Variant variant, RenderFlags renderFlags,
             FScene::VisibleMaskType visibilityMask,
-            math::float3 cameraPosition, math::float3 cameraForward) noexcept;
+            math::float3 cameraPosition, math::float3 cameraForward,
+            uint8_t blendedBucketBits) noexcept;
 
     template<uint32_t commandTypeFlags>
     static inline void generateCommandsImpl(uint32_t, Command* commands,
             FScene::RenderableSoa const& soa, utils::Range<uint32_t> range,
             Variant variant, RenderFlags renderFlags, FScene::VisibleMaskType visibilityMask,
-            math::float3 cameraPosition, math::float3 cameraForward) noexcept;
+            math::float3 cameraPosition, math::float3 cameraForward,
+            uint8_t blendedBucketBits) noexcept;
 
     static void setupColorCommand(Command& cmdDraw,
-            FMaterialInstance const* mi, bool inverseFrontFaces) noexcept;
+            FRenderPrimitive const& primitive, bool inverseFrontFaces) noexcept;
 
-    static void updateSummedPrimitiveCounts(
-            FScene::RenderableSoa& renderableData, utils::Range<uint32_t> vr) noexcept;
+    static void refreshSortKeyCache(FRenderPrimitive const& primitive,
+            FMaterialInstance const* mi) noexcept;
 
     using CustomCommandFn = std::function<void()>;
     using CustomCommandVector = std::vector<CustomCommandFn,
@@ -420,12 +478,18 @@ private:
     // Additional visibility mask
     FScene::VisibleMaskType mVisibilityMask = std::numeric_limits<FScene::VisibleMaskType>::max();
 
+    // number of bits of distance bucketing for blended commands, 0 = exact sort
+    uint8_t mBlendedBucketBits = 0;
+
     // whether to override the polygon offset setting
     bool mPolygonOffsetOverride = false;
 
     // value of the override
     backend::PolygonOffset mPolygonOffset{};
 
+    // if non-null, all surface commands are drawn with this material instead of their own
+    FMaterialInstance const* mMaterialInstanceOverride = nullptr;
+
     // a vector for our custom commands
     mutable CustomCommandVector mCustomCommands;
 };
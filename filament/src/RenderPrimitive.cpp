@@ -33,6 +33,7 @@ void FRenderPrimitive::init(backend::DriverApi& driver,
     mHandle = driver.createRenderPrimitive();
     mMaterialInstance = upcast(entry.materialInstance);
     mBlendOrder = entry.blendOrder;
+    setBoundingCone(entry.coneCenter, entry.coneRadius, entry.coneAxis, entry.coneCutoff);
 
     if (entry.indices && entry.vertices) {
         FVertexBuffer* vertexBuffer = upcast(entry.vertices);
@@ -21,8 +21,11 @@
 
 #include "details/MaterialInstance.h"
 
+#include <backend/DriverEnums.h>
 #include <backend/Handle.h>
 
+#include <math/vec4.h>
+
 #include <utils/compiler.h>
 
 namespace filament {
@@ -58,11 +61,45 @@ public:
     uint16_t getBlendOrder() const noexcept { return mBlendOrder; }
     FMorphTargetBuffer* getMorphTargetBuffer() const noexcept { return mMorphTargetBuffer; }
 
-    void setMaterialInstance(FMaterialInstance const* mi) noexcept { mMaterialInstance = mi; }
+    void setMaterialInstance(FMaterialInstance const* mi) noexcept {
+        mMaterialInstance = mi;
+        mCachedMaterialVersion = 0; // invalidate the sort-key cache
+    }
     void setBlendOrder(uint16_t order) noexcept {
         mBlendOrder = static_cast<uint16_t>(order & 0x7FFF);
     }
 
+    /*
+     * Object-space bounding cone used for cluster backface culling
+     * (see RenderableManager::Builder::boundingCone). A cutoff >= 1 disables the test.
+     */
+    bool hasBoundingCone() const noexcept { return mConeAxisCutoff.w < 1.0f; }
+    math::float4 getConeCenterRadius() const noexcept { return mConeCenterRadius; }
+    math::float4 getConeAxisCutoff() const noexcept { return mConeAxisCutoff; }
+    void setBoundingCone(math::float3 center, float radius,
+            math::float3 axis, float cutoff) noexcept {
+        mConeCenterRadius = { center, radius };
+        mConeAxisCutoff = { axis, cutoff };
+    }
+
+    /*
+     * Cached material bits of the color-pass sort key and the derived raster state
+     * (see RenderPass::setupColorCommand). The cache is rebuilt whenever the version below
+     * doesn't match the material instance's state version, so mostly-static scenes skip the
+     * material dereference chain for every command of every frame.
+     */
+    uint64_t getCachedColorKey() const noexcept { return mCachedColorKey; }
+    backend::RasterState getCachedRasterState() const noexcept { return mCachedRasterState; }
+    bool isCachedCommandBlended() const noexcept { return mCachedIsBlended; }
+    uint32_t getCachedMaterialVersion() const noexcept { return mCachedMaterialVersion; }
+    void updateSortKeyCache(uint64_t key, backend::RasterState rasterState,
+            bool isBlended, uint32_t version) const noexcept {
+        mCachedColorKey = key;
+        mCachedRasterState = rasterState;
+        mCachedIsBlended = isBlended;
+        mCachedMaterialVersion = version;
+    }
+
 private:
     FMaterialInstance const* mMaterialInstance = nullptr;
     backend::Handle<backend::HwRenderPrimitive> mHandle;
@@ -70,6 +107,16 @@ private:
     AttributeBitset mEnabledAttributes;
     uint16_t mBlendOrder = 0;
     FMorphTargetBuffer* mMorphTargetBuffer = nullptr;
+
+    // bounding cone for cluster backface culling: {center, radius} and {axis, cutoff}
+    math::float4 mConeCenterRadius{};
+    math::float4 mConeAxisCutoff{ 0.0f, 0.0f, 0.0f, 1.0f };
+
+    // sort-key cache, updated during command generation (hence mutable)
+    mutable uint64_t mCachedColorKey = 0;
+    mutable backend::RasterState mCachedRasterState{};
+    mutable uint32_t mCachedMaterialVersion = 0;    // 0 == invalid
+    mutable bool mCachedIsBlended = false;
 };
 
 } // namespace filament
@@ -33,7 +33,7 @@ struct RenderTarget::BuilderDetails {
     FRenderTarget::Attachment mAttachments[FRenderTarget::ATTACHMENT_COUNT] = {};
     uint32_t mWidth{};
     uint32_t mHeight{};
-    uint8_t mSamples = 1;   // currently not settable in the public facing API
+    uint8_t mSamples = 1;
 };
 
 using BuilderType = RenderTarget;
@@ -64,6 +64,11 @@ RenderTarget::Builder& RenderTarget::Builder::layer(AttachmentPoint pt, uint32_t
     return *this;
 }
 
+RenderTarget::Builder& RenderTarget::Builder::samples(uint8_t samples) noexcept {
+    mImpl->mSamples = std::max(uint8_t(1), samples);
+    return *this;
+}
+
 RenderTarget* RenderTarget::Builder::build(Engine& engine) {
     using backend::TextureUsage;
     const FRenderTarget::Attachment& color = mImpl->mAttachments[(size_t)AttachmentPoint::COLOR0];
@@ -119,7 +124,8 @@ RenderTarget* RenderTarget::Builder::build(Engine& engine) {
 // ------------------------------------------------------------------------------------------------
 
 FRenderTarget::FRenderTarget(FEngine& engine, const RenderTarget::Builder& builder)
-    : mSupportedColorAttachmentsCount(engine.getDriverApi().getMaxDrawBuffers()) {
+    : mSamples(builder.mImpl->mSamples),
+      mSupportedColorAttachmentsCount(engine.getDriverApi().getMaxDrawBuffers()) {
 
     std::copy(std::begin(builder.mImpl->mAttachments), std::end(builder.mImpl->mAttachments),
             std::begin(mAttachments));
@@ -183,4 +189,8 @@ uint8_t RenderTarget::getSupportedColorAttachmentsCount() const noexcept {
     return upcast(this)->getSupportedColorAttachmentsCount();
 }
 
+uint8_t RenderTarget::getSamples() const noexcept {
+    return upcast(this)->getSamples();
+}
+
 } // namespace filament
@@ -18,10 +18,13 @@
 
 #include "PostProcessManager.h"
 #include "RenderPass.h"
+#include "RenderPrimitive.h"
 #include "ResourceAllocator.h"
 
 #include "details/Engine.h"
 #include "details/Fence.h"
+#include "details/Material.h"
+#include "details/MaterialInstance.h"
 #include "details/Scene.h"
 #include "details/SwapChain.h"
 #include "details/Texture.h"
@@ -36,12 +39,16 @@
 #include "fg2/FrameGraphId.h"
 #include "fg2/FrameGraphResources.h"
 
+#include <tsl/robin_map.h>
+
 #include <utils/compiler.h>
 #include <utils/Panic.h>
 #include <utils/Systrace.h>
 #include <utils/vector.h>
 #include <utils/debug.h>
 
+#include <algorithm>
+
 // this helps visualize what dynamic-scaling is doing
 #define DEBUG_DYNAMIC_SCALING false
 
@@ -64,6 +71,15 @@ FRenderer::FRenderer(FEngine& engine) :
 
     debugRegistry.registerProperty("d.renderer.doFrameCapture",
             &engine.debug.renderer.doFrameCapture);
+
+    debugRegistry.registerProperty("d.renderer.visualize_overdraw",
+            &engine.debug.renderer.visualize_overdraw);
+
+    debugRegistry.registerProperty("d.renderer.dump_pixel_cost",
+            &engine.debug.renderer.dump_pixel_cost);
+
+    debugRegistry.registerProperty("d.materials.dump_variant_usage",
+            &engine.debug.materials.dump_variant_usage);
 }
 
 void FRenderer::init() noexcept {
@@ -131,7 +147,9 @@ void FRenderer::terminate(FEngine& engine) {
         engine.execute();
     }
     mFrameInfoManager.terminate(driver);
+    mPassTimingManager.terminate(driver);
     mFrameSkipper.terminate(driver);
+    mFramePacer.terminate(engine);
 }
 
 void FRenderer::resetUserTime() {
@@ -176,6 +194,9 @@ void FRenderer::renderStandaloneView(FView const* view) {
         FEngine::DriverApi& driver = engine.getDriverApi();
         driver.beginFrame(steady_clock::now().time_since_epoch().count(), mFrameId);
 
+        // there is no whole-frame timer on this path, so per-pass profiling can always run
+        mPassTimingManager.beginFrame(driver);
+
         renderInternal(view);
 
         driver.endFrame(mFrameId);
@@ -197,6 +218,54 @@ void FRenderer::render(FView const* view) {
     }
 }
 
+void FRenderer::render(FView const* const* views, size_t viewCount) {
+    SYSTRACE_CALL();
+
+    assert_invariant(mSwapChain);
+
+    if (mBeginFrameInternal) {
+        mBeginFrameInternal();
+        mBeginFrameInternal = {};
+    }
+
+    FEngine& engine = mEngine;
+    JobSystem& js = engine.getJobSystem();
+
+    // Gather the scene data (world transforms, AABBs, light list) of all distinct scenes
+    // concurrently; this is the largest driver-free chunk of the per-View CPU work, and it
+    // only writes to the scene's own arrays. When the views are rendered below, their
+    // FView::prepare() finds the scene already prepared and takes the incremental path.
+    // The per-View culling and partitioning mutate the (possibly shared) scene arrays, and
+    // the backend command stream must be recorded from this thread, so the views themselves
+    // are rendered in call order -- this is also what keeps the submission order guarantee.
+    JobSystem::Job* parent = js.createJob();
+    for (size_t i = 0; i < viewCount; i++) {
+        FView const* const view = views[i];
+        if (UTILS_UNLIKELY(!view || !view->getScene())) {
+            continue;
+        }
+        // each distinct scene is prepared once, by the first view that references it
+        bool const firstReference = std::none_of(views, views + i,
+                [scene = view->getScene()](FView const* v) {
+                    return v && v->getScene() == scene;
+                });
+        if (firstReference) {
+            js.run(js.createJob(parent, [&engine, view](JobSystem&, JobSystem::Job*) {
+                FScene* const scene = const_cast<FView*>(view)->getScene();
+                scene->prepare(view->getWorldOriginScene(engine), view->hasVSM());
+            }));
+        }
+    }
+    js.runAndWait(parent);
+
+    for (size_t i = 0; i < viewCount; i++) {
+        FView const* const view = views[i];
+        if (UTILS_LIKELY(view && view->getScene())) {
+            renderInternal(view);
+        }
+    }
+}
+
 void FRenderer::renderInternal(FView const* view) {
     // per-renderpass data
     ArenaScope rootArena(mPerRenderPassArena);
@@ -204,17 +273,69 @@ void FRenderer::renderInternal(FView const* view) {
     FEngine& engine = mEngine;
     JobSystem& js = engine.getJobSystem();
 
+    // keep the workers from parking for the duration of the frame; the parallel_for
+    // bursts below (culling, froxelization, command generation) are much shorter than
+    // the workers' wake-up latency
+    js.beginBurst(uint16_t(js.getThreadCount()));
+
     // create a root job so no other job can escape
     auto *rootJob = js.setRootJob(js.createJob());
 
     // execute the render pass
     renderJob(rootArena, const_cast<FView&>(*view));
 
+    if (UTILS_UNLIKELY(mFrameTimingsCallback)) {
+        // overwritten by each view; the final value covers the whole frame
+        mFrameTimings.commandsGeneratedNanos = steadyClockNowNanos();
+    }
+
     // make sure to flush the command buffer
     engine.flush();
 
     // and wait for all jobs to finish as a safety (this should be a no-op)
     js.runAndWait(rootJob);
+
+    js.endBurst();
+}
+
+UTILS_NOINLINE
+static void dumpEstimatedPixelCost(filament::Viewport const& svp, CameraInfo const& cameraInfo,
+        FScene::RenderableSoa const& soa, utils::Range<uint32_t> visible) noexcept {
+    // Estimated number of pixels shaded by each material this frame: the screen-projected area
+    // of each visible renderable's bounding sphere, attributed to the materials of its
+    // primitives. This is a coarse upper bound -- no occlusion and no exact silhouettes -- but
+    // it ranks materials by render cost well enough to spot the expensive one quickly.
+    auto const* const UTILS_RESTRICT centers = soa.data<FScene::WORLD_AABB_CENTER>();
+    auto const* const UTILS_RESTRICT extents = soa.data<FScene::WORLD_AABB_EXTENT>();
+    auto const* const UTILS_RESTRICT primitives = soa.data<FScene::PRIMITIVES>();
+    float3 const cameraPosition = cameraInfo.getPosition();
+    float3 const cameraForward = cameraInfo.getForwardVector();
+    // projection[1][1] is 1/tan(fovy/2), i.e. the clip-space size of a unit-length object at
+    // unit distance; half the viewport height turns that into pixels
+    float const pixelsAtUnitDistance = cameraInfo.projection[1][1] * float(svp.height) * 0.5f;
+    float const viewportArea = float(svp.width) * float(svp.height);
+
+    tsl::robin_map<FMaterial const*, float> costs;
+    for (uint32_t i = visible.first; i < visible.last; i++) {
+        float const d = std::max(cameraInfo.zn,
+                dot(centers[i] - cameraPosition, cameraForward));
+        float const radiusPixels = length(extents[i]) * pixelsAtUnitDistance / d;
+        float const area = std::min(float(F_PI) * radiusPixels * radiusPixels, viewportArea);
+        for (auto const& primitive : primitives[i]) {
+            FMaterialInstance const* const mi = primitive.getMaterialInstance();
+            if (mi) {
+                costs[mi->getMaterial()] += area;
+            }
+        }
+    }
+
+    std::vector<std::pair<FMaterial const*, float>> sorted(costs.begin(), costs.end());
+    std::sort(sorted.begin(), sorted.end(),
+            [](auto const& lhs, auto const& rhs) { return lhs.second > rhs.second; });
+    for (auto const& [material, cost] : sorted) {
+        slog.i << "pixel-cost \"" << material->getName().c_str() << "\" "
+               << uint64_t(cost) << io::endl;
+    }
 }
 
 void FRenderer::renderJob(ArenaScope& arena, FView& view) {
@@ -226,6 +347,18 @@ void FRenderer::renderJob(ArenaScope& arena, FView& view) {
     // DEBUG: driver commands must all happen from the same thread. Enforce that on debug builds.
     engine.getDriverApi().debugThreading();
 
+    // Views rendering into their own RenderTarget are skipped entirely when nothing they
+    // render has changed since the previous frame: the target's attachments still hold the
+    // previous, identical, result. This cuts the whole-View cost to zero for static HUDs
+    // and overlays; View::invalidate() forces a re-render after changes we don't track
+    // (e.g. material parameters or texture contents).
+    if (UTILS_UNLIKELY(view.getRenderTarget() != nullptr)) {
+        // pending picking queries are answered during rendering, they can't be skipped
+        if (!view.hasPicking() && view.isRenderStateUnchanged()) {
+            return;
+        }
+    }
+
     filament::Viewport const& vp = view.getViewport();
     const bool hasPostProcess = view.hasPostProcessPass();
     bool hasColorGrading = hasPostProcess;
@@ -238,6 +371,7 @@ void FRenderer::renderJob(ArenaScope& arena, FView& view) {
     auto dofOptions = view.getDepthOfFieldOptions();
     auto aoOptions = view.getAmbientOcclusionOptions();
     auto taaOptions = view.getTemporalAntiAliasingOptions();
+    auto autoExposureOptions = view.getAutoExposureOptions();
     auto vignetteOptions = view.getVignetteOptions();
     auto colorGrading = view.getColorGrading();
     auto ssReflectionsOptions = view.getScreenSpaceReflectionsOptions();
@@ -247,12 +381,21 @@ void FRenderer::renderJob(ArenaScope& arena, FView& view) {
         bloomOptions.enabled = false;
         vignetteOptions.enabled = false;
         taaOptions.enabled = false;
+        autoExposureOptions.enabled = false;
         hasColorGrading = false;
         hasDithering = false;
         hasFXAA = false;
         scale = 1.0f;
     }
 
+    // the thermal quality governor cheapens the bloom chain by one octave per reduction step
+    const uint8_t qualityReduction = engine.getQualityGovernor().getQualityReduction();
+    if (UTILS_UNLIKELY(qualityReduction && bloomOptions.enabled)) {
+        bloomOptions.levels = uint8_t(std::max(3, int(bloomOptions.levels) - int(qualityReduction)));
+        bloomOptions.resolution = std::max(1u << bloomOptions.levels,
+                bloomOptions.resolution >> qualityReduction);
+    }
+
     const uint8_t msaaSampleCount = msaaOptions.enabled ? msaaOptions.sampleCount : 1u;
 
     const bool scaled = any(notEqual(scale, float2(1.0f)));
@@ -261,8 +404,17 @@ void FRenderer::renderJob(ArenaScope& arena, FView& view) {
         return;
     }
 
+    if (UTILS_UNLIKELY(mFrameTimingsCallback && !mFrameTimings.prepareStartNanos)) {
+        mFrameTimings.prepareStartNanos = steadyClockNowNanos();
+    }
+
     view.prepare(engine, driver, arena, svp, getShaderUserTime());
 
+    if (UTILS_UNLIKELY(mFrameTimingsCallback)) {
+        // overwritten by each view; the final value is the end of the last prepare
+        mFrameTimings.prepareEndNanos = steadyClockNowNanos();
+    }
+
     view.prepareUpscaler(scale);
 
     // start froxelization immediately, it has no dependencies
@@ -301,6 +453,9 @@ void FRenderer::renderJob(ArenaScope& arena, FView& view) {
      */
 
     FrameGraph fg(engine.getResourceAllocator());
+    if (UTILS_UNLIKELY(mPassTimingManager.isEnabled())) {
+        fg.setPassProfiler(&mPassTimingManager);
+    }
 
     /*
      * Shadow pass
@@ -361,7 +516,9 @@ void FRenderer::renderJob(ArenaScope& arena, FView& view) {
                     .attachments = attachmentMask,
                     .viewport = DEBUG_DYNAMIC_SCALING ? svp : vp,
                     .clearColor = clearColor,
-                    .samples = 0,
+                    // a custom MSAA RenderTarget resolves on store in the backend, so the frame
+                    // graph must know its sample count to not schedule a redundant resolve
+                    .samples = currentRenderTarget ? currentRenderTarget->getSamples() : uint8_t(0),
                     .clearFlags = clearFlags,
                     .keepOverrideStart = keepOverrideStartFlags,
                     .keepOverrideEnd = keepOverrideEndFlags
@@ -419,6 +576,19 @@ void FRenderer::renderJob(ArenaScope& arena, FView& view) {
     pass.setCamera(cameraInfo);
     pass.setGeometry(scene.getRenderableData(), view.getVisibleRenderables(), scene.getRenderableUBO());
 
+    // render-cost debugging: draw every surface with an additive debug material, turning the
+    // framebuffer into an overdraw heatmap
+    if (UTILS_UNLIKELY(engine.debug.renderer.visualize_overdraw)) {
+        pass.overrideMaterial(engine.getDebugOverdrawMaterialInstance());
+    }
+
+    // render-cost debugging: log an estimate of how many pixels each material shades this frame
+    if (UTILS_UNLIKELY(engine.debug.renderer.dump_pixel_cost)) {
+        engine.debug.renderer.dump_pixel_cost = false;
+        dumpEstimatedPixelCost(svp, cameraInfo,
+                scene.getRenderableData(), view.getVisibleRenderables());
+    }
+
     // view set-ups that need to happen before rendering
     fg.addTrivialSideEffectPass("Prepare View Uniforms", [svp, &view] (DriverApi& driver) {
         CameraInfo cameraInfo = view.getCameraInfo();
@@ -492,7 +662,7 @@ void FRenderer::renderJob(ArenaScope& arena, FView& view) {
 
     if (aoOptions.enabled) {
         // we could rely on FrameGraph culling, but this creates unnecessary CPU work
-        ppm.screenSpaceAmbientOcclusion(fg, svp, cameraInfo, aoOptions);
+        ppm.screenSpaceAmbientOcclusion(fg, svp, cameraInfo, view.getFrameHistory(), aoOptions);
     }
 
     // --------------------------------------------------------------------------------------------
@@ -502,7 +672,16 @@ void FRenderer::renderJob(ArenaScope& arena, FView& view) {
     // (i.e. it won't be culled, unless everything is culled), so no need to complexify things.
     pass.setRenderFlags(renderFlags);
     pass.setVariant(variant);
+    pass.setBlendedDistanceBucketing(view.getBlendedBucketBits());
     pass.appendCommands(RenderPass::COLOR);
+    if (view.isDepthPrepassEnabled()) {
+        // depth pre-pass: append depth-only commands for opaque and alpha-masked objects.
+        // Pass::DEPTH keys sort before all color commands, so these execute first within
+        // the same render pass; the color commands then only pass the depth test on
+        // equality (the default depth function is GE) and skip occluded fragment work.
+        pass.setVariant(Variant(Variant::DEPTH_VARIANT));
+        pass.appendCommands(RenderPass::DEPTH_PREPASS);
+    }
     pass.sortCommands();
 
     FrameGraphTexture::Descriptor desc = {
@@ -593,6 +772,13 @@ void FRenderer::renderJob(ArenaScope& arena, FView& view) {
     //       dedicated TAA pass for the DoF, as explained in
     //       "Life of a Bokeh" by Guillaume Abadie, SIGGRAPH 2018
 
+    // auto-exposure metering of the HDR color buffer; doesn't modify the image, the adapted
+    // value is read back asynchronously, see View::getAdaptedLuminance()
+    if (autoExposureOptions.enabled) {
+        ppm.autoExposure(fg, input, view.getFrameHistory(), autoExposureOptions,
+                view.getAdaptedLuminanceSlot());
+    }
+
     // TAA for color pass
     if (taaOptions.enabled) {
         input = ppm.taa(fg, input, view.getFrameHistory(),
@@ -694,7 +880,7 @@ void FRenderer::renderJob(ArenaScope& arena, FView& view) {
 
     fg.present(fgViewRenderTarget);
 
-    fg.compile();
+    fg.compile(&mCompileCache);
 
     //fg.export_graphviz(slog.d, view.getName());
 
@@ -1048,6 +1234,12 @@ bool FRenderer::beginFrame(FSwapChain* swapChain, uint64_t vsyncSteadyClockTimeN
 
     mFrameId++;
 
+    if (UTILS_UNLIKELY(mFrameTimingsCallback)) {
+        mFrameTimings = {};
+        mFrameTimings.frameId = mFrameId;
+        mFrameTimings.beginFrameNanos = uint64_t(now.time_since_epoch().count());
+    }
+
     { // scope for frame id trace
         char buf[64];
         snprintf(buf, 64, "frame %u", mFrameId);
@@ -1095,9 +1287,16 @@ bool FRenderer::beginFrame(FSwapChain* swapChain, uint64_t vsyncSteadyClockTimeN
         // This need to occur after the backend beginFrame() because some backends need to start
         // a command buffer before creating a fence.
 
-        mFrameInfoManager.beginFrame(driver, {
-                .historySize = mFrameRateOptions.history
-        }, mFrameId);
+        // timer queries can't nest on some backends (OpenGL), so the whole-frame timer
+        // is paused while per-pass profiling is active; latch the choice for this frame
+        // because it must match in endFrame().
+        mPassProfilingActive = mPassTimingManager.isEnabled();
+        mPassTimingManager.beginFrame(driver);
+        if (!mPassProfilingActive) {
+            mFrameInfoManager.beginFrame(driver, {
+                    .historySize = mFrameRateOptions.history
+            }, mFrameId);
+        }
 
         if (false && vsyncSteadyClockTimeNano) { // work in progress
             const size_t interval = mFrameRateOptions.interval; // user requested swap-interval;
@@ -1135,10 +1334,24 @@ bool FRenderer::beginFrame(FSwapChain* swapChain, uint64_t vsyncSteadyClockTimeN
         engine.prepare();
     };
 
-    if (mFrameSkipper.beginFrame(driver)) {
+    // feed the predictive pacing model with the GPU cost of the last completed frame;
+    // when per-pass profiling is active the whole-frame timer is paused, so the sum of the
+    // per-pass timers stands in for it
+    mFrameSkipper.updateLoadModel(
+            mPassProfilingActive
+                    ? FrameInfo::duration{ mPassTimingManager.getLastFrameGpuTimeMs() }
+                    : mFrameInfoManager.getLastFrameTime(),
+            FrameInfo::duration{ 1000.0f / mDisplayInfo.refreshRate });
+
+    if (mFrameSkipper.beginFrame(driver, mFramePacingOptions.predictiveSkipping)) {
         // if beginFrame() returns true, we are expecting a call to endFrame(),
         // so do the beginFrame work right now, instead of requiring a call to render()
         beginFrameInternal();
+
+        // this must be the very last thing we do, as it can block until the GPU caught up
+        // with the previous frame (in low-latency mode); the application samples its input
+        // right after we return
+        mFramePacer.beginFrame(engine, mFramePacingOptions);
         return true;
     }
 
@@ -1169,12 +1382,25 @@ void FRenderer::endFrame() {
         driver.debugThreading();
     }
 
-    mFrameInfoManager.endFrame(driver);
+    if (!mPassProfilingActive) {
+        mFrameInfoManager.endFrame(driver);
+    }
     mFrameSkipper.endFrame(driver);
+    mFramePacer.endFrame(engine);
 
     if (mSwapChain) {
+        if (UTILS_UNLIKELY(mHasFrameDamage)) {
+            driver.setPresentFrameDamage(mSwapChain->getHwHandle(),
+                    uint32_t(std::max(mFrameDamage.left, int32_t(0))),
+                    uint32_t(std::max(mFrameDamage.bottom, int32_t(0))),
+                    mFrameDamage.width, mFrameDamage.height);
+            mHasFrameDamage = false;
+        }
         mSwapChain->commit(driver);
         mSwapChain = nullptr;
+        if (UTILS_UNLIKELY(mFrameTimingsCallback)) {
+            mFrameTimings.presentQueuedNanos = steadyClockNowNanos();
+        }
     }
 
     driver.endFrame(mFrameId);
@@ -1188,6 +1414,22 @@ void FRenderer::endFrame() {
         engine.debug.renderer.doFrameCapture = false;
     }
 
+    // dump the per-material variant-usage masks, if requested
+    if (UTILS_UNLIKELY(engine.debug.materials.dump_variant_usage)) {
+        engine.debug.materials.dump_variant_usage = false;
+        engine.dumpMaterialVariantUsage();
+    }
+
+    // check the memory budget while nothing is running concurrently
+    engine.checkMemoryBudget();
+
+    // reclaim a batch of deferred destroys now that the frame has been presented; the
+    // driver thread executes them after this frame's commands, at low priority
+    engine.reclaimGarbage();
+
+    // run low-priority deferred engine work under its per-frame CPU budget
+    engine.runDeferredWork();
+
     // do this before engine.flush()
     engine.getResourceAllocator().gc();
 
@@ -1199,8 +1441,23 @@ void FRenderer::endFrame() {
 
     engine.flush();     // flush command stream
 
+    if (UTILS_UNLIKELY(mFrameTimingsCallback)) {
+        mFrameTimings.driverFlushedNanos = steadyClockNowNanos();
+    }
+
     // make sure we're done with the gcs
     js.waitAndRelease(job);
+
+    if (UTILS_UNLIKELY(mFrameTimingsCallback)) {
+        // deliver the frame timings with the current GPU pass table (empty unless pass
+        // profiling is enabled); this runs on the rendering critical path, so the
+        // callback is expected to be cheap
+        PassTiming passes[64];
+        const size_t passCount = mPassProfilingActive ?
+                getPassTimings(passes, sizeof(passes) / sizeof(passes[0])) : 0;
+        mFrameTimings.endFrameNanos = steadyClockNowNanos();
+        mFrameTimingsCallback(mFrameTimingsUser, mFrameTimings, passes, passCount);
+    }
 }
 
 void FRenderer::readPixels(uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height,
@@ -1333,6 +1590,11 @@ void Renderer::render(View const* view) {
     upcast(this)->render(upcast(view));
 }
 
+void Renderer::render(View const* const* views, size_t viewCount) {
+    // FView is the only implementation of View, so this cast is safe
+    upcast(this)->render(reinterpret_cast<FView const* const*>(views), viewCount);
+}
+
 bool Renderer::beginFrame(SwapChain* swapChain, uint64_t vsyncSteadyClockTimeNano) {
     return upcast(this)->beginFrame(upcast(swapChain), vsyncSteadyClockTimeNano);
 }
@@ -1374,6 +1636,38 @@ void Renderer::setFrameRateOptions(FrameRateOptions const& options) noexcept {
     upcast(this)->setFrameRateOptions(options);
 }
 
+void Renderer::setPassProfilingEnabled(bool enabled) noexcept {
+    upcast(this)->setPassProfilingEnabled(enabled);
+}
+
+bool Renderer::isPassProfilingEnabled() const noexcept {
+    return upcast(this)->isPassProfilingEnabled();
+}
+
+size_t Renderer::getPassTimings(PassTiming* timings, size_t count) const noexcept {
+    return upcast(this)->getPassTimings(timings, count);
+}
+
+void Renderer::setFrameTimingsCallback(FrameTimingsCallback callback, void* user) noexcept {
+    upcast(this)->setFrameTimingsCallback(callback, user);
+}
+
+void Renderer::setFramePacingOptions(FramePacingOptions const& options) noexcept {
+    upcast(this)->setFramePacingOptions(options);
+}
+
+uint64_t Renderer::getMeasuredFrameLatencyNanos() const noexcept {
+    return upcast(this)->getMeasuredFrameLatencyNanos();
+}
+
+Renderer::SkipStats Renderer::getFrameSkipStats() const noexcept {
+    return upcast(this)->getFrameSkipStats();
+}
+
+void Renderer::setFrameDamage(filament::Viewport const& damage) noexcept {
+    upcast(this)->setFrameDamage(damage);
+}
+
 void Renderer::setClearOptions(const ClearOptions& options) {
     upcast(this)->setClearOptions(options);
 }
@@ -22,9 +22,11 @@
 
 #include <utils/FixedCapacityVector.h>
 #include <utils/Log.h>
+#include <utils/algorithm.h>
 #include <utils/debug.h>
 
 #include <iterator>
+#include <limits>
 
 using namespace utils;
 
@@ -145,10 +147,32 @@ backend::TextureHandle ResourceAllocator::createTexture(const char* name,
         auto& textureCache = mTextureCache;
         const TextureKey key{ name, target, levels, format, samples, width, height, depth, usage, swizzle };
         auto it = textureCache.find(key);
+        if (it == textureCache.end()) {
+            // no exact match; transient FrameGraph textures whose lifetimes don't overlap can
+            // still alias each other if their keys only differ by usage flags, as long as the
+            // cached texture's usage is a superset of the requested one. Among the candidates
+            // we pick the one wasting the fewest extra usage bits.
+            auto best = textureCache.end();
+            unsigned int bestExtraBits = std::numeric_limits<unsigned int>::max();
+            for (auto curr = textureCache.begin(); curr != textureCache.end(); ++curr) {
+                if (curr->first.isAliasOf(key)) {
+                    const unsigned int extraBits = utils::popcount(
+                            uint32_t(curr->first.usage & ~key.usage));
+                    if (extraBits < bestExtraBits) {
+                        best = curr;
+                        bestExtraBits = extraBits;
+                    }
+                }
+            }
+            it = best;
+        }
         if (UTILS_LIKELY(it != textureCache.end())) {
-            // we do, move the entry to the in-use list, and remove from the cache
+            // we do, move the entry to the in-use list, and remove from the cache.
+            // we record the cache entry's key -- not the requested one -- so the texture
+            // keeps its original identity when it's returned to the cache.
             handle = it->second.handle;
             mCacheSize -= it->second.size;
+            mInUseTextures.emplace(handle, it->first);
             textureCache.erase(it);
         } else {
             // we don't, allocate a new texture and populate the in-use list
@@ -160,8 +184,8 @@ backend::TextureHandle ResourceAllocator::createTexture(const char* name,
                         target, levels, format, samples, width, height, depth, usage,
                         swizzle[0], swizzle[1], swizzle[2], swizzle[3]);
             }
+            mInUseTextures.emplace(handle, key);
         }
-        mInUseTextures.emplace(handle, key);
     } else {
         if (swizzle == defaultSwizzle) {
             handle = mBackend.createTexture(
@@ -195,6 +219,14 @@ void ResourceAllocator::destroyTexture(TextureHandle h) noexcept {
     }
 }
 
+size_t ResourceAllocator::getMemoryUsed() const noexcept {
+    size_t size = mCacheSize;
+    for (auto const& it : mInUseTextures) {
+        size += it.second.getSize();
+    }
+    return size;
+}
+
 void ResourceAllocator::gc() noexcept {
     // this is called regularly -- usually once per frame of each Renderer
 
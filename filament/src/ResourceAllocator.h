@@ -88,6 +88,9 @@ public:
 
     void gc() noexcept;
 
+    // estimated bytes held, both cached and currently in use by the frame graph
+    size_t getMemoryUsed() const noexcept;
+
 private:
     // TODO: these should be settings of the engine
     static constexpr size_t CACHE_CAPACITY = 64u << 20u;   // 64 MiB
@@ -107,6 +110,21 @@ private:
 
         size_t getSize() const noexcept;
 
+        // Returns true if a cached texture with this key can be aliased to a request for
+        // `requested`: everything must match exactly, except usage which only needs to be
+        // a superset of the requested usage.
+        bool isAliasOf(const TextureKey& requested) const noexcept {
+            return target == requested.target &&
+                   levels == requested.levels &&
+                   format == requested.format &&
+                   samples == requested.samples &&
+                   width == requested.width &&
+                   height == requested.height &&
+                   depth == requested.depth &&
+                   (usage & requested.usage) == requested.usage &&
+                   swizzle == requested.swizzle;
+        }
+
         bool operator==(const TextureKey& other) const noexcept {
             return target == other.target &&
                    levels == other.levels &&
@@ -42,15 +42,26 @@ namespace filament {
 
 FScene::FScene(FEngine& engine) :
         mEngine(engine) {
+    // we need to know when entities are destroyed, so we can rebuild the prepared data
+    engine.getEntityManager().registerListener(this);
 }
 
 FScene::~FScene() noexcept = default;
 
+uint64_t FScene::getContentVersion() const noexcept {
+    FEngine& engine = mEngine;
+    FRenderableManager const& rcm = engine.getRenderableManager();
+    FTransformManager const& tcm = engine.getTransformManager();
+    FLightManager const& lcm = engine.getLightManager();
+    // all of these are monotonically increasing, so their sum is too
+    return tcm.getWorldTransformVersion()
+            + mStructureVersion.load(std::memory_order_relaxed)
+            + rcm.getVersion()
+            + lcm.getStructureVersion()
+            + tcm.getStructureVersion();
+}
 
 void FScene::prepare(const mat4& worldOriginTransform, bool shadowReceiversAreCasters) noexcept {
-    // TODO: can we skip this in most cases? Since we rely on indices staying the same,
-    //       we could only skip, if nothing changed in the RCM.
-
     SYSTRACE_CALL();
 
     FEngine& engine = mEngine;
@@ -60,9 +71,39 @@ void FScene::prepare(const mat4& worldOriginTransform, bool shadowReceiversAreCa
     FLightManager& lcm = engine.getLightManager();
     // go through the list of entities, and gather the data of those that are renderables
     auto& sceneData = mRenderableData;
-    auto& lightData = mLightData;
     auto const& entities = mEntities;
 
+    // re-derive the bounds of skinned renderables whose pose changed since the last frame,
+    // before any box is consumed below (see RenderableManager::setPosedBoundsEnabled())
+    if (UTILS_UNLIKELY(rcm.hasPosedBounds())) {
+        rcm.updatePosedBounds(engine.getJobSystem());
+    }
+
+    // The renderable data can be rebuilt from scratch only when needed, that is when entities
+    // were added or removed, components were created or destroyed, or a renderable attribute
+    // changed. In the common case where only some world transforms changed, we just refresh
+    // the affected rows in place, which turns an O(N) pass into O(changes).
+    // The light data however is always rebuilt (from the light entities gathered by the last
+    // full pass) because it's small, it gets truncated and reordered by the views, and the
+    // dominant directional light must be re-elected when intensities change.
+    const uint32_t structureVersion = mStructureVersion.load(std::memory_order_relaxed);
+    const uint64_t transformVersion = tcm.getWorldTransformVersion();
+    const bool incremental =
+            mPreparedStructureVersion == structureVersion &&
+            mPreparedRenderableVersion == rcm.getVersion() &&
+            mPreparedLightStructureVersion == lcm.getStructureVersion() &&
+            mPreparedTransformStructureVersion == tcm.getStructureVersion() &&
+            mPreparedShadowReceiversAreCasters == shadowReceiversAreCasters &&
+            !mat4::fuzzyEqual(mPreparedWorldOriginTransform, worldOriginTransform);
+
+    if (UTILS_LIKELY(incremental)) {
+        updateChangedRenderables(worldOriginTransform, shadowReceiversAreCasters);
+        mPreparedTransformVersion = transformVersion;
+        mPreparedBoneAttachmentVersion = rcm.getBoneAttachmentVersion();
+        mPreparedPosedBoundsVersion = rcm.getPosedBoundsVersion();
+        prepareLightData(worldOriginTransform);
+        return;
+    }
 
     // NOTE: we can't know in advance how many entities are renderable or lights because the corresponding
     // component can be added after the entity is added to the scene.
@@ -78,22 +119,7 @@ void FScene::prepare(const mat4& worldOriginTransform, bool shadowReceiversAreCa
         sceneData.setCapacity(renderableDataCapacity);
     }
 
-    // The light data list will always contain at least one entry for the
-    // dominating directional light, even if there are no entities.
-    size_t lightDataCapacity = std::max<size_t>(1, entities.size());
-    // we need the capacity to be multiple of 16 for SIMD loops
-    lightDataCapacity = (lightDataCapacity + 0xFu) & ~0xFu;
-
-    lightData.clear();
-    if (lightData.capacity() < lightDataCapacity) {
-        lightData.setCapacity(lightDataCapacity);
-    }
-    // the first entries are reserved for the directional lights (currently only one)
-    lightData.resize(DIRECTIONAL_LIGHTS_COUNT);
-
-
-    // find the max intensity directional light index in our local array
-    float maxIntensity = 0.0f;
+    mLightEntities.clear();
 
     for (Entity e : entities) {
         if (!em.isAlive(e)) {
@@ -108,15 +134,26 @@ void FScene::prepare(const mat4& worldOriginTransform, bool shadowReceiversAreCa
             continue;
         }
 
+        if (li) {
+            // the light rows themselves are built by prepareLightData() below
+            mLightEntities.push_back(e);
+        }
+
         // get the world transform
         auto ti = tcm.getInstance(e);
-        // this is where we go from double to float for our transforms
-        const mat4f worldTransform{ worldOriginTransform * tcm.getWorldTransformAccurate(ti) };
-        const bool reversedWindingOrder = det(worldTransform.upperLeft()) < 0;
 
         // don't even draw this object if it doesn't have a transform (which shouldn't happen
         // because one is always created when creating a Renderable component).
         if (ri && ti) {
+            // this is where we go from double to float for our transforms
+            mat4f worldTransform{ worldOriginTransform * tcm.getWorldTransformAccurate(ti) };
+            if (UTILS_UNLIKELY(rcm.hasBoneAttachments())) {
+                // renderables attached to a skeleton joint sample the target's bone palette
+                // instead of the transform hierarchy
+                rcm.getBoneAttachmentWorldTransform(ri, worldOriginTransform, worldTransform);
+            }
+            const bool reversedWindingOrder = det(worldTransform.upperLeft()) < 0;
+
             // compute the world AABB so we can perform culling
             const Box worldAABB = rigidTransform(rcm.getAABB(ri), worldTransform);
 
@@ -146,35 +183,153 @@ void FScene::prepare(const mat4& worldOriginTransform, bool shadowReceiversAreCa
                     worldAABB.halfExtent,           // WORLD_AABB_EXTENT
                     {},                             // PRIMITIVES
                     0,                              // SUMMED_PRIMITIVE_COUNT
-                    scale                           // USER_DATA
+                    scale,                          // USER_DATA
+                    ti                              // TRANSFORM_INSTANCE
             );
         }
+    }
 
-        if (li) {
-            // find the dominant directional light
-            if (UTILS_UNLIKELY(lcm.isDirectionalLight(li))) {
-                // we don't store the directional lights, because we only have a single one
-                if (lcm.getIntensity(li) >= maxIntensity) {
-                    maxIntensity = lcm.getIntensity(li);
-                    float3 d = lcm.getLocalDirection(li);
-                    // using mat3f::getTransformForNormals handles non-uniform scaling
-                    d = normalize(mat3f::getTransformForNormals(worldTransform.upperLeft()) * d);
-                    lightData.elementAt<FScene::POSITION_RADIUS>(0) =
-                            float4{ 0, 0, 0, std::numeric_limits<float>::infinity() };
-                    lightData.elementAt<FScene::DIRECTION>(0)       = d;
-                    lightData.elementAt<FScene::LIGHT_INSTANCE>(0)  = li;
-                }
-            } else {
-                const float4 p = worldTransform * float4{ lcm.getLocalPosition(li), 1 };
-                float3 d = 0;
-                if (!lcm.isPointLight(li) || lcm.isIESLight(li)) {
-                    d = lcm.getLocalDirection(li);
-                    // using mat3f::getTransformForNormals handles non-uniform scaling
-                    d = normalize(mat3f::getTransformForNormals(worldTransform.upperLeft()) * d);
-                }
-                lightData.push_back_unsafe(
-                        float4{ p.xyz, lcm.getRadius(li) }, d, li, {}, {}, {});
+    // Purely for the benefit of MSAN, we can avoid uninitialized reads by zeroing out the
+    // unused scene elements between the end of the array and the rounded-up count.
+    if (UTILS_HAS_SANITIZE_MEMORY) {
+        for (size_t i = sceneData.size(), e = renderableDataCapacity; i < e; i++) {
+            sceneData.data<LAYERS>()[i] = 0;
+            sceneData.data<VISIBLE_MASK>()[i] = 0;
+            sceneData.data<VISIBILITY_STATE>()[i] = {};
+        }
+    }
+
+    mRenderableOrderVersion++;
+    mPreparedStructureVersion = structureVersion;
+    mPreparedRenderableVersion = rcm.getVersion();
+    mPreparedLightStructureVersion = lcm.getStructureVersion();
+    mPreparedTransformStructureVersion = tcm.getStructureVersion();
+    mPreparedTransformVersion = transformVersion;
+    mPreparedBoneAttachmentVersion = rcm.getBoneAttachmentVersion();
+    mPreparedPosedBoundsVersion = rcm.getPosedBoundsVersion();
+    mPreparedShadowReceiversAreCasters = shadowReceiversAreCasters;
+    mPreparedWorldOriginTransform = worldOriginTransform;
+
+    prepareLightData(worldOriginTransform);
+}
+
+UTILS_NOINLINE
+void FScene::updateChangedRenderables(const mat4& worldOriginTransform,
+        bool shadowReceiversAreCasters) noexcept {
+    FRenderableManager& rcm = mEngine.getRenderableManager();
+    FTransformManager& tcm = mEngine.getTransformManager();
+    auto& sceneData = mRenderableData;
+
+    const uint64_t preparedTransformVersion = mPreparedTransformVersion;
+    // attached renderables must also be refreshed when the joint they follow moved, even
+    // if their own transform didn't change
+    const bool refreshBoneAttachments = rcm.hasBoneAttachments() &&
+            rcm.getBoneAttachmentVersion() != mPreparedBoneAttachmentVersion;
+    // similarly, renderables with posed bounds must be refreshed when their box was
+    // re-derived from a new pose, even if their transform didn't change
+    const bool refreshPosedBounds = rcm.hasPosedBounds() &&
+            rcm.getPosedBoundsVersion() != mPreparedPosedBoundsVersion;
+    auto const* const UTILS_RESTRICT instances = sceneData.data<TRANSFORM_INSTANCE>();
+    for (size_t i = 0, c = sceneData.size(); i < c; i++) {
+        const auto ti = instances[i];
+        if (tcm.getWorldTransformVersion(ti) <= preparedTransformVersion &&
+                !(refreshBoneAttachments &&
+                        rcm.hasBoneAttachment(sceneData.elementAt<RENDERABLE_INSTANCE>(i))) &&
+                !(refreshPosedBounds &&
+                        rcm.hasPosedBounds(sceneData.elementAt<RENDERABLE_INSTANCE>(i)))) {
+            continue;
+        }
+
+        // recompute the data that depends on the world transform, exactly as the full
+        // pass above does; everything else in the row is unchanged by construction
+        auto ri = sceneData.elementAt<RENDERABLE_INSTANCE>(i);
+        mat4f worldTransform{ worldOriginTransform * tcm.getWorldTransformAccurate(ti) };
+        if (UTILS_UNLIKELY(rcm.hasBoneAttachments())) {
+            rcm.getBoneAttachmentWorldTransform(ri, worldOriginTransform, worldTransform);
+        }
+        const bool reversedWindingOrder = det(worldTransform.upperLeft()) < 0;
+
+        const Box worldAABB = rigidTransform(rcm.getAABB(ri), worldTransform);
+
+        auto visibility = rcm.getVisibility(ri);
+        visibility.reversedWindingOrder = reversedWindingOrder;
+        if (shadowReceiversAreCasters && visibility.receiveShadows) {
+            visibility.castShadows = true;
+        }
+
+        const mat4f& transform = tcm.getTransform(ti);
+        float scale = (length(transform[0].xyz) + length(transform[1].xyz) +
+                length(transform[2].xyz)) / 3.0f;
+
+        sceneData.elementAt<WORLD_TRANSFORM>(i)     = worldTransform;
+        sceneData.elementAt<VISIBILITY_STATE>(i)    = visibility;
+        sceneData.elementAt<WORLD_AABB_CENTER>(i)   = worldAABB.center;
+        sceneData.elementAt<WORLD_AABB_EXTENT>(i)   = worldAABB.halfExtent;
+        sceneData.elementAt<USER_DATA>(i)           = scale;
+    }
+}
+
+UTILS_NOINLINE
+void FScene::prepareLightData(const mat4& worldOriginTransform) noexcept {
+    FTransformManager& tcm = mEngine.getTransformManager();
+    FLightManager& lcm = mEngine.getLightManager();
+    auto& lightData = mLightData;
+
+    // The light data list will always contain at least one entry for the
+    // dominating directional light, even if there are no lights.
+    size_t lightDataCapacity =
+            std::max<size_t>(1, mLightEntities.size() + DIRECTIONAL_LIGHTS_COUNT);
+    // we need the capacity to be multiple of 16 for SIMD loops
+    lightDataCapacity = (lightDataCapacity + 0xFu) & ~0xFu;
+
+    lightData.clear();
+    if (lightData.capacity() < lightDataCapacity) {
+        lightData.setCapacity(lightDataCapacity);
+    }
+    // the first entries are reserved for the directional lights (currently only one)
+    lightData.resize(DIRECTIONAL_LIGHTS_COUNT);
+
+    // find the max intensity directional light index in our local array
+    float maxIntensity = 0.0f;
+
+    for (Entity e : mLightEntities) {
+        auto li = lcm.getInstance(e);
+
+        // active-set compaction: lights that can't contribute (zero intensity, no channel
+        // enabled, or not light casters) are skipped entirely, so froxelization and the
+        // light UBO build below only ever traverse the active set
+        if (UTILS_UNLIKELY(!lcm.isLightActive(li))) {
+            continue;
+        }
+
+        // get the world transform
+        auto ti = tcm.getInstance(e);
+        // this is where we go from double to float for our transforms
+        const mat4f worldTransform{ worldOriginTransform * tcm.getWorldTransformAccurate(ti) };
+
+        // find the dominant directional light
+        if (UTILS_UNLIKELY(lcm.isDirectionalLight(li))) {
+            // we don't store the directional lights, because we only have a single one
+            if (lcm.getIntensity(li) >= maxIntensity) {
+                maxIntensity = lcm.getIntensity(li);
+                float3 d = lcm.getLocalDirection(li);
+                // using mat3f::getTransformForNormals handles non-uniform scaling
+                d = normalize(mat3f::getTransformForNormals(worldTransform.upperLeft()) * d);
+                lightData.elementAt<FScene::POSITION_RADIUS>(0) =
+                        float4{ 0, 0, 0, std::numeric_limits<float>::infinity() };
+                lightData.elementAt<FScene::DIRECTION>(0)       = d;
+                lightData.elementAt<FScene::LIGHT_INSTANCE>(0)  = li;
+            }
+        } else {
+            const float4 p = worldTransform * float4{ lcm.getLocalPosition(li), 1 };
+            float3 d = 0;
+            if (!lcm.isPointLight(li) || lcm.isIESLight(li)) {
+                d = lcm.getLocalDirection(li);
+                // using mat3f::getTransformForNormals handles non-uniform scaling
+                d = normalize(mat3f::getTransformForNormals(worldTransform.upperLeft()) * d);
             }
+            lightData.push_back_unsafe(
+                    float4{ p.xyz, lcm.getRadius(li) }, d, li, {}, {}, {});
         }
     }
 
@@ -184,16 +339,13 @@ void FScene::prepare(const mat4& worldOriginTransform, bool shadowReceiversAreCa
     for (size_t i = lightData.size(), e = lightDataCapacity; i < e; i++) {
         new(lightData.data<POSITION_RADIUS>() + i) float4{ 0, 0, 0, 1 };
     }
+}
 
-    // Purely for the benefit of MSAN, we can avoid uninitialized reads by zeroing out the
-    // unused scene elements between the end of the array and the rounded-up count.
-    if (UTILS_HAS_SANITIZE_MEMORY) {
-        for (size_t i = sceneData.size(), e = renderableDataCapacity; i < e; i++) {
-            sceneData.data<LAYERS>()[i] = 0;
-            sceneData.data<VISIBLE_MASK>()[i] = 0;
-            sceneData.data<VISIBILITY_STATE>()[i] = {};
-        }
-    }
+void FScene::onEntitiesDestroyed(size_t, Entity const*) noexcept {
+    // this can be called from any thread, and we don't check whether these entities belong
+    // to this scene because it's not worth the bookkeeping -- a spurious bump only costs
+    // one full prepare()
+    mStructureVersion.fetch_add(1, std::memory_order_relaxed);
 }
 
 void FScene::updateUBOs(utils::Range<uint32_t> visibleRenderables, backend::Handle<backend::HwBufferObject> renderableUbh) noexcept {
@@ -282,6 +434,7 @@ void FScene::updateUBOs(utils::Range<uint32_t> visibleRenderables, backend::Hand
 }
 
 void FScene::terminate(FEngine& engine) {
+    engine.getEntityManager().unregisterListener(this);
     // DO NOT destroy this UBO, it's owned by the View
     mRenderableViewUbh.clear();
 }
@@ -366,15 +519,20 @@ inline void FScene::computeLightRanges(
 }
 
 void FScene::addEntity(Entity entity) {
-    mEntities.insert(entity);
+    if (mEntities.insert(entity).second) {
+        mStructureVersion.fetch_add(1, std::memory_order_relaxed);
+    }
 }
 
 void FScene::addEntities(const Entity* entities, size_t count) {
     mEntities.insert(entities, entities + count);
+    mStructureVersion.fetch_add(1, std::memory_order_relaxed);
 }
 
 void FScene::remove(Entity entity) {
-    mEntities.erase(entity);
+    if (mEntities.erase(entity)) {
+        mStructureVersion.fetch_add(1, std::memory_order_relaxed);
+    }
 }
 
 void FScene::removeEntities(const Entity* entities, size_t count) {
@@ -441,6 +599,15 @@ bool FScene::hasContactShadows() const noexcept {
     return hasContactShadows && mHasContactShadows;
 }
 
+void FScene::updateCasterBVH() noexcept {
+    SYSTRACE_CALL();
+    auto const& sceneData = mRenderableData;
+    mCasterBVH.update(
+            sceneData.data<WORLD_AABB_CENTER>(),
+            sceneData.data<WORLD_AABB_EXTENT>(),
+            uint32_t(sceneData.size()), mRenderableOrderVersion);
+}
+
 void FScene::forEach(Invocable<void(utils::Entity)>&& functor) const noexcept {
     std::for_each(mEntities.begin(), mEntities.end(), std::move(functor));
 }
@@ -465,6 +632,10 @@ void Scene::setIndirectLight(IndirectLight const* ibl) noexcept {
     upcast(this)->setIndirectLight(upcast(ibl));
 }
 
+void Scene::setIndirectLightBlend(IndirectLight const* ibl, float blend) noexcept {
+    upcast(this)->setIndirectLightBlend(upcast(ibl), blend);
+}
+
 void Scene::addEntity(Entity entity) {
     upcast(this)->addEntity(entity);
 }
@@ -25,6 +25,8 @@
 #include "private/backend/DriverApiForward.h"
 #include "private/backend/SamplerGroup.h"
 
+#include <utils/JobSystem.h>
+
 #include <math/mat4.h>
 #include <math/vec4.h>
 
@@ -104,7 +106,10 @@ public:
             const ShadowMapInfo& shadowMapInfo, FScene const& scene,
             SceneInfo& sceneInfo) noexcept;
 
-    void render(FScene const& scene, utils::Range<uint32_t> range,
+    // Sets the pass up and returns the command generation/sorting job (not submitted),
+    // so that several shadow passes can be recorded concurrently.
+    utils::JobSystem::Job* render(utils::JobSystem::Job* parent,
+            FScene const& scene, utils::Range<uint32_t> range,
             FScene::VisibleMaskType visibilityMask, filament::CameraInfo const& cameraInfo,
             RenderPass* pass) noexcept;
 
@@ -17,8 +17,11 @@
 #include "ShadowMapManager.h"
 
 #include "RenderPass.h"
+#include "RenderPrimitive.h"
 #include "ShadowMap.h"
 
+#include "details/Material.h"
+#include "details/MaterialInstance.h"
 #include "details/Texture.h"
 #include "details/View.h"
 
@@ -28,6 +31,8 @@
 
 #include <utils/debug.h>
 #include <utils/FixedCapacityVector.h>
+#include <utils/Hash.h>
+#include <utils/JobSystem.h>
 
 namespace filament {
 
@@ -44,6 +49,8 @@ ShadowMapManager::ShadowMapManager(FEngine& engine) { // NOLINT(cppcoreguideline
             &engine.debug.shadowmap.visualize_cascades);
     debugRegistry.registerProperty("d.shadowmap.tightly_bound_scene",
             &engine.debug.shadowmap.tightly_bound_scene);
+    debugRegistry.registerProperty("d.shadowmap.caching",
+            &engine.debug.shadowmap.caching);
 }
 
 ShadowMapManager::~ShadowMapManager() {
@@ -59,6 +66,12 @@ ShadowMapManager::ShadowTechnique ShadowMapManager::update(
         FScene::LightSoa& lightData) noexcept {
     ShadowTechnique shadowTechnique = {};
 
+    mFrameCounter++;
+
+    // under thermal pressure the governor steps the shadow resolution down; a change
+    // also invalidates the layer content hashes through the dimension baked into them
+    mTextureSizeShift = engine.getQualityGovernor().getTextureSizeShift();
+
     calculateTextureRequirements(engine, view, lightData);
 
     ShadowMap::SceneInfo sceneInfo(view.getVisibleLayers());
@@ -77,6 +90,13 @@ ShadowMapManager::ShadowTechnique ShadowMapManager::update(
     return shadowTechnique;
 }
 
+void ShadowMapManager::terminate(DriverApi& driver) noexcept {
+    if (mShadowAtlas) {
+        driver.destroyTexture(mShadowAtlas);
+        mShadowAtlas.clear();
+    }
+}
+
 void ShadowMapManager::reset() noexcept {
     mCascadeShadowMaps.clear();
     mSpotShadowMaps.clear();
@@ -99,6 +119,69 @@ void ShadowMapManager::addSpotShadowMap(size_t lightIndex,
     mSpotShadowMaps.emplace_back(shadowMap, lightIndex, options);
 }
 
+// Computes a digest of the set of shadow casters selected by visibilityMask: which
+// renderables they are and their world transforms. Casters whose rendered appearance can
+// change without our knowledge -- skinned or morphed geometry, and materials that are
+// sampled by the depth variant (i.e. anything not opaque) -- make the result meaningless,
+// which is signaled by clearing 'cacheable'.
+static uint32_t computeShadowCasterDigest(FRenderableManager const& rcm,
+        FScene::RenderableSoa const& soa, utils::Range<uint32_t> range,
+        FScene::VisibleMaskType visibilityMask, bool& cacheable) noexcept {
+    auto const* const UTILS_RESTRICT visibleMask = soa.data<FScene::VISIBLE_MASK>();
+    auto const* const UTILS_RESTRICT worldTransform = soa.data<FScene::WORLD_TRANSFORM>();
+    auto const* const UTILS_RESTRICT visibility = soa.data<FScene::VISIBILITY_STATE>();
+    auto const* const UTILS_RESTRICT instances = soa.data<FScene::RENDERABLE_INSTANCE>();
+    uint32_t digest = 0;
+    for (uint32_t i = range.first; i < range.last; i++) {
+        if (visibleMask[i] & visibilityMask) {
+            if (UTILS_UNLIKELY(visibility[i].skinning || visibility[i].morphing)) {
+                cacheable = false;
+            }
+            for (auto const& primitive : rcm.getRenderPrimitives(instances[i], 0)) {
+                FMaterial const* const ma = primitive.getMaterialInstance()->getMaterial();
+                if (UTILS_UNLIKELY(ma->getBlendingMode() != BlendingMode::OPAQUE)) {
+                    cacheable = false;
+                }
+            }
+            const uint32_t id = instances[i].asValue();
+            digest = utils::hash::murmur3(&id, 1, digest);
+            digest = utils::hash::murmur3(
+                    reinterpret_cast<uint32_t const*>(&worldTransform[i]),
+                    sizeof(mat4f) / sizeof(uint32_t), digest);
+        }
+    }
+    return digest;
+}
+
+// Hash of everything that affects the content of one shadow map: the light-space matrix
+// (which accounts for the light, and for cascades the viewing camera as well), the caster
+// digest above and the options that affect how the casters are rendered into the map.
+static uint32_t computeShadowMapContentHash(ShadowMap const& shadowMap,
+        LightManager::ShadowOptions const& options, uint32_t casterDigest,
+        uint32_t dimension) noexcept {
+    const struct {
+        mat4f lightSpace;
+        uint32_t casterDigest;
+        uint32_t mapSize;
+        float polygonOffsetConstant;
+        float polygonOffsetSlope;
+        float vsmBlurWidth;
+        uint32_t vsmMsaaSamples;
+    } key = {
+            shadowMap.getLightSpaceMatrix(),
+            casterDigest,
+            dimension,
+            options.polygonOffsetConstant,
+            options.polygonOffsetSlope,
+            options.vsm.blurWidth,
+            options.vsm.msaaSamples,
+    };
+    const uint32_t h = utils::hash::murmur3(
+            reinterpret_cast<uint32_t const*>(&key), sizeof(key) / sizeof(uint32_t), 0);
+    // 0 is reserved to mean "must be redrawn"
+    return h ? h : 1u;
+}
+
 void ShadowMapManager::render(FrameGraph& fg, FEngine& engine, backend::DriverApi& driver,
         RenderPass const& pass, FView& view) noexcept {
 
@@ -111,25 +194,73 @@ void ShadowMapManager::render(FrameGraph& fg, FEngine& engine, backend::DriverAp
     const TextureAtlasRequirements textureRequirements = mTextureAtlasRequirements;
     assert_invariant(textureRequirements.layers <= MAX_SHADOW_LAYERS);
 
+    // The shadow atlas is owned by us rather than by the frame graph, so its layers
+    // survive across frames; it only needs to be re-created when its layout changes,
+    // in which case all cached layers become invalid.
+    const bool vsm = view.hasVSM();
+    if (UTILS_UNLIKELY(!mShadowAtlas
+            || textureRequirements.size != mShadowAtlasDesc.size
+            || textureRequirements.layers != mShadowAtlasDesc.layers
+            || textureRequirements.levels != mShadowAtlasDesc.levels
+            || vsm != mShadowAtlasIsVsm)) {
+        if (mShadowAtlas) {
+            driver.destroyTexture(mShadowAtlas);
+        }
+        mShadowAtlas = driver.createTexture(SamplerType::SAMPLER_2D_ARRAY,
+                textureRequirements.levels,
+                vsm ? vsmTextureFormat : mTextureFormat, 1,
+                textureRequirements.size, textureRequirements.size,
+                textureRequirements.layers,
+                vsm ? (TextureUsage::COLOR_ATTACHMENT | TextureUsage::SAMPLEABLE)
+                    : (TextureUsage::DEPTH_ATTACHMENT | TextureUsage::SAMPLEABLE));
+        mShadowAtlasDesc = textureRequirements;
+        mShadowAtlasIsVsm = vsm;
+        mLayerContentHash.fill(0);
+    }
+
     struct ShadowPass {
         ShadowMapEntry const* shadowMapEntry;
         utils::Range<uint32_t> range;
         FScene::VisibleMaskType visibilityMask;
     };
 
-    auto passList = utils::FixedCapacityVector<ShadowPass>::with_capacity(MAX_SHADOW_LAYERS);
+    // inline storage, so steady-state frames don't heap-allocate here
+    utils::SmallVector<ShadowPass, MAX_SHADOW_LAYERS> passList;
 
     FScene* scene = view.getScene();
     assert_invariant(scene);
 
     // these loops create a list of the shadow maps that need to be rendered (i.e. that have
-    // visible shadows).
+    // visible shadows). Maps whose content hash matches the content already present in
+    // their layer of the atlas are skipped; their layer is preserved from a previous frame.
+
+    FRenderableManager const& rcm = engine.getRenderableManager();
+    const bool cachingEnabled = engine.debug.shadowmap.caching;
 
     // Directional, cascaded shadowmaps
     auto const directionalShadowCastersRange = view.getVisibleDirectionalShadowCasters();
     if (!directionalShadowCastersRange.empty()) {
-        for (const auto& map : mCascadeShadowMaps) {
+        bool cacheable = cachingEnabled;
+        uint32_t casterDigest = 0;
+        if (cacheable) {
+            // all cascades share the same caster set, they differ only by their matrix
+            casterDigest = computeShadowCasterDigest(rcm, scene->getRenderableData(),
+                    directionalShadowCastersRange, VISIBLE_DIR_SHADOW_RENDERABLE, cacheable);
+        }
+        for (size_t i = 0, c = mCascadeShadowMaps.size(); i < c; i++) {
+            const auto& map = mCascadeShadowMaps[i];
             if (map.hasVisibleShadows()) {
+                if (mDeferredCascadesMask & (1u << i)) {
+                    // this cascade is not scheduled for a refresh this frame
+                    continue;
+                }
+                const uint32_t contentHash = cacheable ? computeShadowMapContentHash(
+                        map.getShadowMap(), *map.getShadowOptions(), casterDigest,
+                        map.getDimension()) : 0;
+                if (contentHash && contentHash == mLayerContentHash[map.getLayer()]) {
+                    continue;
+                }
+                mLayerContentHash[map.getLayer()] = contentHash;
                 passList.push_back({
                     &map, directionalShadowCastersRange, VISIBLE_DIR_SHADOW_RENDERABLE });
             }
@@ -142,6 +273,20 @@ void ShadowMapManager::render(FrameGraph& fg, FEngine& engine, backend::DriverAp
         for (size_t i = 0, c = mSpotShadowMaps.size(); i < c; i++) {
             const auto& map = mSpotShadowMaps[i];
             if (map.hasVisibleShadows()) {
+                bool cacheable = cachingEnabled;
+                uint32_t casterDigest = 0;
+                if (cacheable) {
+                    casterDigest = computeShadowCasterDigest(rcm, scene->getRenderableData(),
+                            spotShadowCastersRange, VISIBLE_SPOT_SHADOW_RENDERABLE_N(i),
+                            cacheable);
+                }
+                const uint32_t contentHash = cacheable ? computeShadowMapContentHash(
+                        map.getShadowMap(), *map.getShadowOptions(), casterDigest,
+                        map.getDimension()) : 0;
+                if (contentHash && contentHash == mLayerContentHash[map.getLayer()]) {
+                    continue;
+                }
+                mLayerContentHash[map.getLayer()] = contentHash;
                 passList.push_back({
                     &map, spotShadowCastersRange, VISIBLE_SPOT_SHADOW_RENDERABLE_N(i) });
             }
@@ -150,24 +295,49 @@ void ShadowMapManager::render(FrameGraph& fg, FEngine& engine, backend::DriverAp
 
     assert_invariant(passList.size() <= textureRequirements.layers);
 
-    // -------------------------------------------------------------------------------------------
+    // Record the commands of all shadow passes now, as concurrent jobs, rather than one
+    // pass at a time when the frame graph executes. Passes of a group (all cascades, then
+    // all spot lights) share the same geometry range, so the primitive LODs and summed
+    // primitive counts they depend on -- which live in the scene SoA -- are set up once
+    // per group; groups are recorded back-to-back because those counts depend on the range.
+    utils::JobSystem& js = engine.getJobSystem();
+    utils::SmallVector<RenderPass, MAX_SHADOW_LAYERS> passes;
+    for (size_t i = 0, c = passList.size(); i < c;) {
+        utils::Range<uint32_t> const groupRange = passList[i].range;
+
+        // updatePrimitivesLod must be run before RenderPass::appendCommands.
+        view.updatePrimitivesLod(engine,
+                CameraInfo(passList[i].shadowMapEntry->getShadowMap().getCamera()),
+                scene->getRenderableData(), groupRange);
+        RenderPass::updateSummedPrimitiveCounts(scene->getRenderableData(), groupRange);
+
+        auto* const parent = js.createJob();
+        for (; i < c && passList[i].range.first == groupRange.first
+                     && passList[i].range.last == groupRange.last; i++) {
+            auto const& entry = passList[i];
+            ShadowMap& shadowMap = entry.shadowMapEntry->getShadowMap();
+            const CameraInfo cameraInfo(shadowMap.getCamera());
+            passes.push_back(pass); // copy the pass "template"
+            js.run(shadowMap.render(parent, *scene, entry.range, entry.visibilityMask,
+                    cameraInfo, &passes.back()));
+        }
+        js.runAndWait(parent);
+    }
 
-    struct PrepareShadowPassData {
-        FrameGraphId<FrameGraphTexture> shadows;        // the actual shadowmap
-    };
+    // -------------------------------------------------------------------------------------------
 
-    auto& prepareShadowPass = fg.addPass<PrepareShadowPassData>("Prepare Shadow Pass",
-            [&](FrameGraph::Builder& builder, auto& data) {
-                data.shadows = builder.createTexture("Shadowmap", {
-                        .width = textureRequirements.size, .height = textureRequirements.size,
-                        .depth = textureRequirements.layers,
-                        .levels = textureRequirements.levels,
-                        .type = SamplerType::SAMPLER_2D_ARRAY,
-                        .format = view.hasVSM() ? vsmTextureFormat : mTextureFormat
-                });
+    // Import the persistent atlas into the frame graph; the graph neither creates nor
+    // discards it, so the layers not written to this frame keep their content.
+    FrameGraphId<FrameGraphTexture> const importedShadows = fg.import("Shadowmap", {
+                    .width = textureRequirements.size, .height = textureRequirements.size,
+                    .depth = textureRequirements.layers,
+                    .levels = textureRequirements.levels,
+                    .type = SamplerType::SAMPLER_2D_ARRAY,
+                    .format = vsm ? vsmTextureFormat : mTextureFormat
             },
-            [=](FrameGraphResources const& resources, auto const& data, DriverApi& driver) { });
-
+            vsm ? (TextureUsage::COLOR_ATTACHMENT | TextureUsage::SAMPLEABLE)
+                : (TextureUsage::DEPTH_ATTACHMENT | TextureUsage::SAMPLEABLE),
+            FrameGraphTexture{ .handle = mShadowAtlas });
 
     // -------------------------------------------------------------------------------------------
 
@@ -181,21 +351,25 @@ void ShadowMapManager::render(FrameGraph& fg, FEngine& engine, backend::DriverAp
         uint32_t shadowRt{};
     };
 
-    auto shadows = prepareShadowPass.getData().shadows;
+    auto shadows = importedShadows;
 
     auto& ppm = engine.getPostProcessManager();
 
-    for (auto const& entry : passList) {
+    for (size_t index = 0, passCount = passList.size(); index < passCount; index++) {
+        auto const& entry = passList[index];
         const auto layer = entry.shadowMapEntry->getLayer();
         const auto* options = entry.shadowMapEntry->getShadowOptions();
 
+        // commands for this pass were already generated and sorted above
+        const auto executor = passes[index].getExecutor();
+
         auto& shadowPass = fg.addPass<ShadowPassData>("Shadow Pass",
                 [&](FrameGraph::Builder& builder, auto& data) {
                     const bool blur = view.hasVSM() && options->vsm.blurWidth > 0.0f;
 
                     FrameGraphRenderPass::Descriptor renderTargetDesc{};
 
-                    auto attachment = builder.createSubresource(prepareShadowPass->shadows,
+                    auto attachment = builder.createSubresource(importedShadows,
                             "Shadowmap Layer", { .layer = layer });
 
                     if (view.hasVSM()) {
@@ -262,14 +436,6 @@ void ShadowMapManager::render(FrameGraph& fg, FEngine& engine, backend::DriverAp
                     ShadowMap& shadowMap = entry.shadowMapEntry->getShadowMap();
                     const CameraInfo cameraInfo(shadowMap.getCamera());
 
-                    // updatePrimitivesLod must be run before RenderPass::appendCommands.
-                    view.updatePrimitivesLod(engine, cameraInfo, scene->getRenderableData(), entry.range);
-
-                    // generate and sort the commands for rendering the shadow map
-                    RenderPass entryPass(pass);
-                    shadowMap.render(*scene, entry.range, entry.visibilityMask, cameraInfo, &entryPass);
-
-                    const auto& executor = entryPass.getExecutor();
                     const bool blur = view.hasVSM() && options->vsm.blurWidth > 0.0f;
 
                     view.prepareCamera(cameraInfo);
@@ -284,7 +450,7 @@ void ShadowMapManager::render(FrameGraph& fg, FEngine& engine, backend::DriverAp
                     // shadowing.fs). Unfortunately, the APIs don't seem let us clear depth
                     // attachments to anything greater than 1.0, so we'd need a way to do this other
                     // than clearing.
-                    const uint32_t dim = options->mapSize;
+                    const uint32_t dim = entry.shadowMapEntry->getDimension();
                     filament::Viewport viewport{ 1, 1, dim - 2, dim - 2 };
                     view.prepareViewport(viewport);
 
@@ -345,10 +511,11 @@ ShadowMapManager::ShadowTechnique ShadowMapManager::updateCascadeShadowMaps(FEng
     FLightManager::ShadowOptions const& options = lcm.getShadowOptions(directionalLight);
     FLightManager::ShadowParams const& params = lcm.getShadowParams(directionalLight);
 
+    const uint32_t textureDimension = effectiveDimension(options.mapSize);
     const ShadowMap::ShadowMapInfo shadowMapInfo{
             .atlasDimension   = mTextureAtlasRequirements.size,
-            .textureDimension = uint16_t(options.mapSize),
-            .shadowDimension  = uint16_t(options.mapSize - 2u),
+            .textureDimension = uint16_t(textureDimension),
+            .shadowDimension  = uint16_t(textureDimension - 2u),
             .vsm = view.hasVSM(),
             .polygonOffset = { // handle reversed Z
                     .slope    = view.hasVSM() ? 0.0f : -params.options.polygonOffsetSlope,
@@ -424,6 +591,20 @@ ShadowMapManager::ShadowTechnique ShadowMapManager::updateCascadeShadowMaps(FEng
 
     mShadowMappingUniforms.cascadeSplits = wsSplitPositionUniform;
 
+    // Distant cascades can be refreshed at a reduced rate (see ShadowUpdateOptions). A
+    // cascade can only be deferred once its layer of the atlas holds valid content, i.e.
+    // the atlas layout is stable and the layer has been rendered at least once.
+    auto const& updateOptions = view.getShadowUpdateOptions();
+    const size_t firstDeferredCascade = cascadeCount
+            - std::min(size_t(updateOptions.deferredCascades), cascadeCount);
+    const uint32_t updateInterval = std::max(uint8_t(1), updateOptions.interval);
+    const bool atlasValid = mShadowAtlasIsVsm == view.hasVSM()
+            && mTextureAtlasRequirements.size == mShadowAtlasDesc.size
+            && mTextureAtlasRequirements.layers == mShadowAtlasDesc.layers
+            && mTextureAtlasRequirements.levels == mShadowAtlasDesc.levels;
+
+    mDeferredCascadesMask = 0;
+
     ShadowTechnique shadowTechnique{};
     uint32_t directionalShadowsMask = 0;
     uint32_t cascadeHasVisibleShadows = 0;
@@ -434,11 +615,22 @@ ShadowMapManager::ShadowTechnique ShadowMapManager::updateCascadeShadowMaps(FEng
         ShadowMap& shadowMap = entry.getShadowMap();
         assert_invariant(entry.getLightIndex() == 0);
 
-        sceneInfo.csNearFar = { csSplitPosition[i], csSplitPosition[i + 1] };
-
-        shadowMap.updateDirectional(lightData, 0,
-                viewingCameraInfo, shadowMapInfo,
-                *scene, sceneInfo);
+        const bool deferred = i >= firstDeferredCascade
+                && atlasValid
+                && mLayerContentHash[entry.getLayer()] != 0
+                && ((mFrameCounter + i) % updateInterval) != 0;   // staggered refresh
+
+        if (!deferred) {
+            sceneInfo.csNearFar = { csSplitPosition[i], csSplitPosition[i + 1] };
+
+            shadowMap.updateDirectional(lightData, 0,
+                    viewingCameraInfo, shadowMapInfo,
+                    *scene, sceneInfo);
+        } else {
+            // keep the previous frustum and content; the matrix below, and the shadow map
+            // itself, are still the ones from the last refresh, so they stay consistent
+            mDeferredCascadesMask |= 1u << i;
+        }
 
         if (shadowMap.hasVisibleShadows()) {
             mShadowMappingUniforms.lightFromWorldMatrix[i] = shadowMap.getLightSpaceMatrix();
@@ -447,12 +639,28 @@ ShadowMapManager::ShadowTechnique ShadowMapManager::updateCascadeShadowMaps(FEng
         }
     }
 
-    // screen-space contact shadows for the directional light
-    float screenSpaceShadowDistance = options.maxShadowDistance;
-    if (options.screenSpaceContactShadows) {
+    // Screen-space contact shadows. The ray-march distance and step count live in a single
+    // uniform shared by all lights, but any light can enable the feature; aggregate the
+    // requirements of every participating light so contact shadows work -- and are properly
+    // tuned -- when only punctual lights use them, e.g. small lights that don't warrant a
+    // shadow map at all.
+    float screenSpaceShadowDistance = 0.0f;
+    uint32_t stepCount = 0;
+    for (size_t l = 0, c = lightData.size(); l < c; l++) {
+        FLightManager::Instance const li = lightData.elementAt<FScene::LIGHT_INSTANCE>(l);
+        if (li) {
+            auto const& shadowOptions = lcm.getShadowOptions(li);
+            if (shadowOptions.screenSpaceContactShadows) {
+                screenSpaceShadowDistance =
+                        std::max(screenSpaceShadowDistance, shadowOptions.maxShadowDistance);
+                stepCount = std::max(stepCount, uint32_t(shadowOptions.stepCount));
+            }
+        }
+    }
+    if (directionalLight && options.screenSpaceContactShadows) {
         shadowTechnique |= ShadowTechnique::SCREEN_SPACE;
     }
-    directionalShadowsMask |= std::min(uint8_t(255u), options.stepCount) << 8u;
+    directionalShadowsMask |= std::min(255u, stepCount) << 8u;
 
     if (any(shadowTechnique & ShadowTechnique::SHADOW_MAP)) {
         directionalShadowsMask |= 0x1u;
@@ -482,6 +690,17 @@ ShadowMapManager::ShadowTechnique ShadowMapManager::updateSpotShadowMaps(FEngine
     auto& lcm = engine.getLightManager();
     const CameraInfo& viewingCameraInfo = view.getCameraInfo();
 
+    // With several shadowed spot/point lights, scanning every renderable once per light is
+    // the dominant cost of this function, so above these thresholds each light's caster
+    // query is answered with the scene's caster BVH instead. The BVH produces the same
+    // visibility bits as the linear scan; updating it costs one O(n) pass (a refit, or a
+    // rebuild when the scene structure changed) amortized over all shadowed lights.
+    FScene& scene = *view.getScene();
+    const bool useCasterBVH = mSpotShadowMaps.size() >= 2 && renderableData.size() >= 1024;
+    if (useCasterBVH) {
+        scene.updateCasterBVH();
+    }
+
     // shadow-map shadows for point/spotlights
     ShadowTechnique shadowTechnique{};
     FScene::ShadowInfo* const shadowInfo = lightData.data<FScene::SHADOW_INFO>();
@@ -495,10 +714,12 @@ ShadowMapManager::ShadowTechnique ShadowMapManager::updateSpotShadowMaps(FEngine
         FLightManager::ShadowParams params = lcm.getShadowParams(li);
 
         FLightManager::ShadowOptions const* const options = entry.getShadowOptions();
+        // coverage-adaptive dimension, computed in calculateTextureRequirements()
+        const uint32_t textureDimension = entry.getDimension();
         const ShadowMap::ShadowMapInfo shadowMapInfo{
                 .atlasDimension = mTextureAtlasRequirements.size,
-                .textureDimension = uint16_t(options->mapSize),
-                .shadowDimension = uint16_t(options->mapSize - 2u),
+                .textureDimension = uint16_t(textureDimension),
+                .shadowDimension = uint16_t(textureDimension - 2u),
                 .spotIndex = uint16_t(i),
                 .vsm = view.hasVSM(),
                 .polygonOffset = { // handle reversed Z
@@ -522,8 +743,15 @@ ShadowMapManager::ShadowTechnique ShadowMapManager::updateSpotShadowMaps(FEngine
         const Frustum frustum(MpMv);
 
         // Cull shadow casters
-        FView::cullRenderables(engine.getJobSystem(), renderableData, frustum,
-                VISIBLE_SPOT_SHADOW_RENDERABLE_N_BIT(i));
+        if (useCasterBVH) {
+            scene.getCasterBVH().cull(renderableData.data<FScene::VISIBLE_MASK>(), frustum,
+                    renderableData.data<FScene::WORLD_AABB_CENTER>(),
+                    renderableData.data<FScene::WORLD_AABB_EXTENT>(),
+                    VISIBLE_SPOT_SHADOW_RENDERABLE_N_BIT(i));
+        } else {
+            FView::cullRenderables(engine.getJobSystem(), renderableData, frustum,
+                    VISIBLE_SPOT_SHADOW_RENDERABLE_N_BIT(i));
+        }
 
         shadowMap.updateSpot(lightData, lightIndex,
                 viewingCameraInfo, shadowMapInfo,
@@ -580,12 +808,48 @@ void ShadowMapManager::calculateTextureRequirements(FEngine& engine, FView& view
     for (auto& entry : mCascadeShadowMaps) {
         // Shadow map size should be the same for all cascades.
         auto const& options = entry.getShadowOptions();
-        maxDimension = std::max(maxDimension, options->mapSize);
+        const uint32_t dimension = effectiveDimension(options->mapSize);
+        entry.setDimension(uint16_t(dimension));
+        maxDimension = std::max(maxDimension, dimension);
         entry.setLayer(layer++);
     }
-    for (auto& entry : mSpotShadowMaps) {
-        auto const& options = entry.getShadowOptions();
-        maxDimension = std::max(maxDimension, options->mapSize);
+
+    // Spot shadow maps adapt their resolution to the light's on-screen coverage: a light
+    // whose influence sphere covers a small part of the viewport doesn't need its full
+    // requested map size. The dimension is sticky -- it grows immediately when more
+    // resolution is needed, but only shrinks once the coverage has clearly dropped -- so
+    // small camera moves don't thrash the cached atlas layers.
+    CameraInfo const& camera = view.getCameraInfo();
+    const float cotHalfFov = camera.projection[1][1];
+    const float viewportHeight = float(view.getViewport().height);
+    for (size_t i = 0, c = mSpotShadowMaps.size(); i < c; i++) {
+        auto& entry = mSpotShadowMaps[i];
+        const uint32_t maxDim = effectiveDimension(entry.getShadowOptions()->mapSize);
+        const uint32_t minDim = std::min(256u, maxDim);
+
+        const float4 positionRadius =
+                lightData.elementAt<FScene::POSITION_RADIUS>(entry.getLightIndex());
+        const float distance = length(positionRadius.xyz - camera.getPosition());
+        // conservative estimate of the influence sphere's diameter on screen, in pixels
+        float desired = float(maxDim);
+        if (distance > positionRadius.w) {
+            desired = positionRadius.w * cotHalfFov / distance * viewportHeight;
+        }
+
+        uint32_t target = minDim;
+        while (target < maxDim && float(target) < desired) {
+            target *= 2;
+        }
+
+        uint16_t dimension = mAdaptiveSpotDimension[i];
+        if (dimension < minDim || dimension > maxDim
+                || target > dimension                       // more resolution needed: grow now
+                || desired < float(dimension) * 0.45f) {    // clearly below: shrink
+            dimension = uint16_t(target);
+        }
+        mAdaptiveSpotDimension[i] = dimension;
+        entry.setDimension(dimension);
+        maxDimension = std::max(maxDimension, uint32_t(dimension));
         entry.setLayer(layer++);
     }
 
@@ -38,6 +38,7 @@
 
 #include <math/vec3.h>
 
+#include <algorithm>
 #include <array>
 #include <memory>
 #include <vector>
@@ -74,6 +75,9 @@ public:
     explicit ShadowMapManager(FEngine& engine);
     ~ShadowMapManager();
 
+    // frees driver resources, must be called before destruction
+    void terminate(backend::DriverApi& driver) noexcept;
+
     // Reset shadow map layout.
     void reset() noexcept;
 
@@ -124,6 +128,12 @@ private:
 
     void calculateTextureRequirements(FEngine& engine, FView& view, FScene::LightSoa& lightData) noexcept;
 
+    // shadow-map dimension after the thermal quality governor's reduction is applied,
+    // floored so heavily throttled devices still get usable shadows
+    uint32_t effectiveDimension(uint32_t mapSize) const noexcept {
+        return std::max(mapSize >> mTextureSizeShift, std::min(mapSize, 256u));
+    }
+
     class ShadowMapEntry {
     public:
         ShadowMapEntry() = default;
@@ -137,6 +147,11 @@ private:
         void setLayer(uint8_t layer) noexcept { mLayer = layer; }
         uint8_t getLayer() const noexcept { return mLayer; }
 
+        // dimension actually used this frame, set by calculateTextureRequirements();
+        // for spot shadow maps this adapts to the light's on-screen coverage
+        void setDimension(uint16_t dimension) noexcept { mDimension = dimension; }
+        uint16_t getDimension() const noexcept { return mDimension; }
+
         LightManager::ShadowOptions const* getShadowOptions() const noexcept { return mOptions; }
         ShadowMap& getShadowMap() const { return *mShadowMap; }
         size_t getLightIndex() const { return mLightIndex; }
@@ -147,6 +162,7 @@ private:
         ShadowMap* mShadowMap = nullptr;
         LightManager::ShadowOptions const* mOptions = nullptr;
         uint32_t mLightIndex = 0;
+        uint16_t mDimension = 0;
         uint8_t mLayer = 0;
     };
 
@@ -195,6 +211,27 @@ private:
         uint8_t levels = 0;
     } mTextureAtlasRequirements;
 
+    // The shadow atlas is persistent across frames, so that the content of the layers
+    // whose light and casters didn't change can be reused instead of re-rendered.
+    // Each layer's content is identified by a hash of everything that went into
+    // rendering it; 0 means the layer must be (re)drawn.
+    backend::Handle<backend::HwTexture> mShadowAtlas;
+    TextureAtlasRequirements mShadowAtlasDesc;
+    bool mShadowAtlasIsVsm = false;
+    std::array<uint32_t,
+            CONFIG_MAX_SHADOW_CASCADES + CONFIG_MAX_SHADOW_CASTING_SPOTS> mLayerContentHash{};
+
+    // Round-robin refresh of the distant cascades (see ShadowUpdateOptions). A cascade
+    // deferred this frame keeps both its previous frustum and its previous content.
+    // Coverage-adaptive spot shadow resolutions, kept across frames so the dimension is
+    // sticky (see calculateTextureRequirements()); indexed by spot shadow slot.
+    std::array<uint16_t, CONFIG_MAX_SHADOW_CASTING_SPOTS> mAdaptiveSpotDimension{};
+
+    uint32_t mFrameCounter = 0;
+    uint8_t mDeferredCascadesMask = 0;
+    uint8_t mTextureSizeShift = 0;      // set each frame from the engine's QualityGovernor
+    static_assert(CONFIG_MAX_SHADOW_CASCADES <= 8, "mDeferredCascadesMask is 8 bits");
+
     SoftShadowOptions mSoftShadowOptions;
 
     CascadeSplits::Params mCascadeSplitParams;
@@ -207,13 +244,9 @@ private:
 
     ShadowMappingUniforms mShadowMappingUniforms;
 
-    utils::FixedCapacityVector<ShadowMapEntry> mCascadeShadowMaps{
-            utils::FixedCapacityVector<ShadowMapEntry>::with_capacity(
-                    CONFIG_MAX_SHADOW_CASCADES) };
+    utils::SmallVector<ShadowMapEntry, CONFIG_MAX_SHADOW_CASCADES> mCascadeShadowMaps;
 
-    utils::FixedCapacityVector<ShadowMapEntry> mSpotShadowMaps{
-            utils::FixedCapacityVector<ShadowMapEntry>::with_capacity(
-                    CONFIG_MAX_SHADOW_CASTING_SPOTS) };
+    utils::SmallVector<ShadowMapEntry, CONFIG_MAX_SHADOW_CASTING_SPOTS> mSpotShadowMaps;
 
     // inline storage for all our ShadowMap objects, we can't easily use a std::array<> directly.
     // because ShadowMap doesn't have a default ctor, and we avoid out-of-line allocations.
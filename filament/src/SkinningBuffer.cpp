@@ -116,16 +116,29 @@ static uint32_t packHalf2x16(half2 v) noexcept {
     return (hi << 16) | lo;
 }
 
-void FSkinningBuffer::setBones(FEngine& engine, Handle<backend::HwBufferObject> handle,
-        RenderableManager::Bone const* transforms, size_t boneCount, size_t offset) noexcept {
-    auto& driverApi = engine.getDriverApi();
-    PerRenderableUibBone* UTILS_RESTRICT out = driverApi.allocatePod<PerRenderableUibBone>(boneCount);
+void FSkinningBuffer::convertBones(PerRenderableUibBone* UTILS_RESTRICT out,
+        RenderableManager::Bone const* transforms, size_t boneCount) noexcept {
     for (size_t i = 0, c = boneCount; i < c; ++i) {
         // the transform is stored in row-major, last row is not stored.
         mat4f transform(transforms[i].unitQuaternion);
         transform[3] = float4{ transforms[i].translation, 1.0f };
         out[i] = makeBone(transform);
     }
+}
+
+void FSkinningBuffer::convertBones(PerRenderableUibBone* UTILS_RESTRICT out,
+        mat4f const* transforms, size_t boneCount) noexcept {
+    for (size_t i = 0, c = boneCount; i < c; ++i) {
+        // the transform is stored in row-major, last row is not stored.
+        out[i] = makeBone(transforms[i]);
+    }
+}
+
+void FSkinningBuffer::setBones(FEngine& engine, Handle<backend::HwBufferObject> handle,
+        RenderableManager::Bone const* transforms, size_t boneCount, size_t offset) noexcept {
+    auto& driverApi = engine.getDriverApi();
+    PerRenderableUibBone* UTILS_RESTRICT out = driverApi.allocatePod<PerRenderableUibBone>(boneCount);
+    convertBones(out, transforms, boneCount);
     driverApi.updateBufferObject(handle, {
                     out, boneCount * sizeof(PerRenderableUibBone) },
             offset * sizeof(PerRenderableUibBone));
@@ -156,10 +169,7 @@ void FSkinningBuffer::setBones(FEngine& engine, Handle<backend::HwBufferObject>
         mat4f const* transforms, size_t boneCount, size_t offset) noexcept {
     auto& driverApi = engine.getDriverApi();
     PerRenderableUibBone* UTILS_RESTRICT out = driverApi.allocatePod<PerRenderableUibBone>(boneCount);
-    for (size_t i = 0, c = boneCount; i < c; ++i) {
-        // the transform is stored in row-major, last row is not stored.
-        out[i] = makeBone(transforms[i]);
-    }
+    convertBones(out, transforms, boneCount);
     driverApi.updateBufferObject(handle, {
                     out, boneCount * sizeof(PerRenderableUibBone) },
             offset * sizeof(PerRenderableUibBone));
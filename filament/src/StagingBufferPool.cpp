@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "StagingBufferPool.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include <stdlib.h>
+
+using namespace filament::backend;
+
+namespace filament {
+
+// Rounds a requested size up to its size class. The class is recomputed from the
+// descriptor's size when the buffer is released, so it's never stored with the
+// in-flight buffer.
+static size_t sizeClass(size_t size) noexcept {
+    // anything smaller isn't worth recycling
+    size_t c = 4096;
+    while (c < size) {
+        c *= 2;
+    }
+    return c;
+}
+
+StagingBufferPool::~StagingBufferPool() noexcept {
+    terminate();
+}
+
+void StagingBufferPool::terminate() noexcept {
+    std::lock_guard<utils::Mutex> const lock(mLock);
+    for (auto const& entry : mFreeList) {
+        ::free(entry.buffer);
+    }
+    mFreeList.clear();
+    mPooledBytes = 0;
+}
+
+void* StagingBufferPool::acquireBuffer(size_t size) noexcept {
+    std::lock_guard<utils::Mutex> const lock(mLock);
+    auto pos = std::find_if(mFreeList.begin(), mFreeList.end(),
+            [size](Entry const& entry) { return entry.size == size; });
+    if (pos == mFreeList.end()) {
+        return nullptr;
+    }
+    void* const buffer = pos->buffer;
+    mPooledBytes -= pos->size;
+    // swap-with-last removal, the free list is unordered
+    *pos = mFreeList.back();
+    mFreeList.pop_back();
+    return buffer;
+}
+
+PixelBufferDescriptor StagingBufferPool::acquire(size_t size,
+        PixelDataFormat format, PixelDataType type, uint8_t alignment) noexcept {
+    size_t const allocSize = sizeClass(size);
+    void* buffer = acquireBuffer(allocSize);
+    if (buffer == nullptr) {
+        buffer = ::malloc(allocSize);
+    }
+    return { buffer, size, format, type, alignment, 0, 0, 0,
+             nullptr, &StagingBufferPool::release, this };
+}
+
+void StagingBufferPool::release(void* buffer, size_t size, void* user) noexcept {
+    StagingBufferPool* const pool = static_cast<StagingBufferPool*>(user);
+    size_t const allocSize = sizeClass(size);
+    std::lock_guard<utils::Mutex> const lock(pool->mLock);
+    if (pool->mPooledBytes + allocSize <= pool->mCapacity) {
+        pool->mFreeList.push_back({ buffer, allocSize });
+        pool->mPooledBytes += allocSize;
+    } else {
+        ::free(buffer);
+    }
+}
+
+void StagingBufferPool::setCapacity(size_t bytes) noexcept {
+    std::lock_guard<utils::Mutex> const lock(mLock);
+    mCapacity = bytes;
+    while (mPooledBytes > mCapacity) {
+        Entry const entry = mFreeList.back();
+        mFreeList.pop_back();
+        ::free(entry.buffer);
+        mPooledBytes -= entry.size;
+    }
+}
+
+size_t StagingBufferPool::getCapacity() const noexcept {
+    std::lock_guard<utils::Mutex> const lock(mLock);
+    return mCapacity;
+}
+
+} // namespace filament
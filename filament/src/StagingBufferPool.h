@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_STAGINGBUFFERPOOL_H
+#define TNT_FILAMENT_STAGINGBUFFERPOOL_H
+
+#include <backend/PixelBufferDescriptor.h>
+
+#include <utils/Mutex.h>
+
+#include <vector>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+
+/*
+ * A recycling pool for the CPU staging memory behind PixelBufferDescriptor.
+ *
+ * Streaming paths (video, texture streaming) create multi-megabyte pixel buffers every
+ * frame that the engine frees through the descriptor's callback once the backend has
+ * consumed them. acquire() hands out a buffer from the pool instead, wrapped in a
+ * descriptor whose callback automatically returns the memory to the pool when the copy
+ * is done, so steady-state streaming performs no system allocations at all.
+ *
+ * Buffers are bucketed by power-of-two size classes, which gives recycling hits across
+ * the slightly different sizes a streaming source can produce. Memory released while the
+ * pool is at capacity is freed immediately.
+ *
+ * The descriptor callback can fire on the backend thread, so the free list is
+ * lock-protected.
+ */
+class StagingBufferPool {
+public:
+    // default for the total bytes retained in the free list
+    static constexpr size_t DEFAULT_CAPACITY = 64u << 20u;
+
+    StagingBufferPool() noexcept = default;
+    ~StagingBufferPool() noexcept;
+
+    StagingBufferPool(StagingBufferPool const&) = delete;
+    StagingBufferPool& operator=(StagingBufferPool const&) = delete;
+
+    // frees all pooled memory; buffers still in flight return normally afterwards
+    void terminate() noexcept;
+
+    // Returns a descriptor of the given size backed by pooled memory; the content is
+    // uninitialized. The memory returns to the pool when the engine releases the buffer.
+    backend::PixelBufferDescriptor acquire(size_t size,
+            backend::PixelDataFormat format, backend::PixelDataType type,
+            uint8_t alignment) noexcept;
+
+    // Sets the maximum amount of memory retained for reuse; 0 disables recycling.
+    // Pooled memory in excess of the new capacity is freed immediately.
+    void setCapacity(size_t bytes) noexcept;
+
+    size_t getCapacity() const noexcept;
+
+private:
+    struct Entry {
+        void* buffer;
+        size_t size;    // size class, not the requested size
+    };
+
+    // PixelBufferDescriptor release callback, returns the buffer to the pool
+    static void release(void* buffer, size_t size, void* user) noexcept;
+
+    // returns a pooled buffer of exactly the given size class, or nullptr
+    void* acquireBuffer(size_t size) noexcept;
+
+    mutable utils::Mutex mLock;
+    std::vector<Entry> mFreeList;
+    size_t mPooledBytes = 0;    // total bytes currently in mFreeList
+    size_t mCapacity = DEFAULT_CAPACITY;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_STAGINGBUFFERPOOL_H
@@ -238,8 +238,9 @@ void FTexture::setImage(FEngine& engine,
         return;
     }
 
-    engine.getDriverApi().update2DImage(mHandle,
-            uint8_t(level), xoffset, yoffset, width, height, std::move(buffer));
+    engine.getTextureUploadScheduler().update2DImage(engine.getDriverApi(), mHandle,
+            mUploadPriority, uint8_t(level), xoffset, yoffset, width, height,
+            std::move(buffer));
 }
 
 void FTexture::setImage(FEngine& engine,
@@ -309,8 +310,9 @@ void FTexture::setImage(FEngine& engine,
         return;
     }
 
-    engine.getDriverApi().update3DImage(mHandle,
-            uint8_t(level), xoffset, yoffset, zoffset, width, height, depth, std::move(buffer));
+    engine.getTextureUploadScheduler().update3DImage(engine.getDriverApi(), mHandle,
+            mUploadPriority, uint8_t(level), xoffset, yoffset, zoffset, width, height, depth,
+            std::move(buffer));
 }
 
 void FTexture::setImage(FEngine& engine, size_t level,
@@ -353,8 +355,8 @@ void FTexture::setImage(FEngine& engine, size_t level,
         return;
     }
 
-    engine.getDriverApi().updateCubeImage(mHandle, uint8_t(level),
-            std::move(buffer), faceOffsets);
+    engine.getTextureUploadScheduler().updateCubeImage(engine.getDriverApi(), mHandle,
+            mUploadPriority, uint8_t(level), std::move(buffer), faceOffsets);
 }
 
 void FTexture::setExternalImage(FEngine& engine, void* image) noexcept {
@@ -467,6 +469,16 @@ void FTexture::generateMipmaps(FEngine& engine) const noexcept {
     }
 }
 
+void FTexture::setMinMaxLevels(FEngine& engine, uint8_t minLevel, uint8_t maxLevel) const noexcept {
+    if (!ASSERT_POSTCONDITION_NON_FATAL(mTarget != SamplerType::SAMPLER_EXTERNAL,
+            "External Textures don't support mip levels.")) {
+        return;
+    }
+    maxLevel = std::min(maxLevel, uint8_t(mLevelCount - 1u));
+    minLevel = std::min(minLevel, maxLevel);
+    engine.getDriverApi().setMinMaxLevels(mHandle, minLevel, maxLevel);
+}
+
 bool FTexture::isTextureFormatSupported(FEngine& engine, InternalFormat format) noexcept {
     return engine.getDriverApi().isTextureFormatSupported(format);
 }
@@ -484,6 +496,25 @@ size_t FTexture::getFormatSize(InternalFormat format) noexcept {
     return backend::getFormatSize(format);
 }
 
+size_t FTexture::getEstimatedByteCount() const noexcept {
+    if (mTarget == Sampler::SAMPLER_EXTERNAL || mStream) {
+        // external storage, not owned by us
+        return 0;
+    }
+    size_t pixelCount = 0;
+    for (size_t level = 0; level < mLevelCount; level++) {
+        pixelCount += valueForLevel(level, mWidth)
+                * valueForLevel(level, mHeight)
+                * valueForLevel(level, mDepth);
+    }
+    size_t size = pixelCount * getFormatSize(mFormat);
+    if (isCubemap()) {
+        size *= 6;
+    }
+    // if we have MSAA, we assume N times the storage
+    return size * std::max(uint8_t(1), mSampleCount);
+}
+
 
 // this is a hack to be able to create a std::function<> with a non-copyable closure
 template<class F>
@@ -1117,6 +1148,14 @@ void Texture::generateMipmaps(Engine& engine) const noexcept {
     upcast(this)->generateMipmaps(upcast(engine));
 }
 
+void Texture::setMinMaxLevels(Engine& engine, uint8_t minLevel, uint8_t maxLevel) const noexcept {
+    upcast(this)->setMinMaxLevels(upcast(engine), minLevel, maxLevel);
+}
+
+void Texture::setUploadPriority(UploadPriority priority) noexcept {
+    upcast(this)->setUploadPriority(priority);
+}
+
 bool Texture::isTextureFormatSupported(Engine& engine, InternalFormat format) noexcept {
     return FTexture::isTextureFormatSupported(upcast(engine), format);
 }
@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TextureUploadScheduler.h"
+
+#include <utils/Systrace.h>
+#include <utils/compiler.h>
+
+#include <algorithm>
+
+namespace filament {
+
+using namespace backend;
+
+bool TextureUploadScheduler::fits(UploadPriority priority, size_t size) noexcept {
+    if (mBudget == 0) {
+        return true;
+    }
+    // an upload can't jump ahead of queued uploads of its own class: successive
+    // updates to the same texture must apply in order, and since the priority is a
+    // texture attribute they all share one class
+    if (!mPending[size_t(priority)].empty()) {
+        return false;
+    }
+    return mBytesThisFrame + size <= mBudget;
+}
+
+void TextureUploadScheduler::update2DImage(DriverApi& driver,
+        Handle<HwTexture> handle, UploadPriority priority,
+        uint8_t level, uint32_t xoffset, uint32_t yoffset,
+        uint32_t width, uint32_t height, PixelBufferDescriptor&& buffer) noexcept {
+    if (UTILS_LIKELY(fits(priority, buffer.size))) {
+        mBytesThisFrame += buffer.size;
+        driver.update2DImage(handle, level, xoffset, yoffset, width, height,
+                std::move(buffer));
+        return;
+    }
+    mPending[size_t(priority)].push_back(PendingUpload{ handle, std::move(buffer), {},
+            xoffset, yoffset, 0, width, height, 0, level,
+            PendingUpload::Type::IMAGE_2D });
+}
+
+void TextureUploadScheduler::update3DImage(DriverApi& driver,
+        Handle<HwTexture> handle, UploadPriority priority,
+        uint8_t level, uint32_t xoffset, uint32_t yoffset, uint32_t zoffset,
+        uint32_t width, uint32_t height, uint32_t depth,
+        PixelBufferDescriptor&& buffer) noexcept {
+    if (UTILS_LIKELY(fits(priority, buffer.size))) {
+        mBytesThisFrame += buffer.size;
+        driver.update3DImage(handle, level, xoffset, yoffset, zoffset,
+                width, height, depth, std::move(buffer));
+        return;
+    }
+    mPending[size_t(priority)].push_back(PendingUpload{ handle, std::move(buffer), {},
+            xoffset, yoffset, zoffset, width, height, depth, level,
+            PendingUpload::Type::IMAGE_3D });
+}
+
+void TextureUploadScheduler::updateCubeImage(DriverApi& driver,
+        Handle<HwTexture> handle, UploadPriority priority,
+        uint8_t level, PixelBufferDescriptor&& buffer,
+        FaceOffsets faceOffsets) noexcept {
+    if (UTILS_LIKELY(fits(priority, buffer.size))) {
+        mBytesThisFrame += buffer.size;
+        driver.updateCubeImage(handle, level, std::move(buffer), faceOffsets);
+        return;
+    }
+    mPending[size_t(priority)].push_back(PendingUpload{ handle, std::move(buffer),
+            faceOffsets, 0, 0, 0, 0, 0, 0, level,
+            PendingUpload::Type::IMAGE_CUBE });
+}
+
+void TextureUploadScheduler::issue(DriverApi& driver, PendingUpload& upload) noexcept {
+    switch (upload.type) {
+        case PendingUpload::Type::IMAGE_2D:
+            driver.update2DImage(upload.handle, upload.level,
+                    upload.xoffset, upload.yoffset, upload.width, upload.height,
+                    std::move(upload.buffer));
+            break;
+        case PendingUpload::Type::IMAGE_3D:
+            driver.update3DImage(upload.handle, upload.level,
+                    upload.xoffset, upload.yoffset, upload.zoffset,
+                    upload.width, upload.height, upload.depth,
+                    std::move(upload.buffer));
+            break;
+        case PendingUpload::Type::IMAGE_CUBE:
+            driver.updateCubeImage(upload.handle, upload.level,
+                    std::move(upload.buffer), upload.faceOffsets);
+            break;
+    }
+}
+
+void TextureUploadScheduler::flush(DriverApi& driver) noexcept {
+    mBytesThisFrame = 0;
+    if (UTILS_LIKELY(isEmpty())) {
+        return;
+    }
+    SYSTRACE_CALL();
+    bool issuedOne = false;
+    for (auto& queue : mPending) {
+        while (!queue.empty()) {
+            PendingUpload& upload = queue.front();
+            size_t const size = upload.buffer.size;
+            // always issue at least one upload per frame, so the queue drains even
+            // with a budget smaller than the smallest upload
+            if (mBudget && issuedOne && mBytesThisFrame + size > mBudget) {
+                return; // lower classes wait for the higher ones to drain
+            }
+            mBytesThisFrame += size;
+            issue(driver, upload);
+            queue.pop_front();
+            issuedOne = true;
+        }
+    }
+}
+
+void TextureUploadScheduler::purge(Handle<HwTexture> handle) noexcept {
+    for (auto& queue : mPending) {
+        auto pos = std::remove_if(queue.begin(), queue.end(),
+                [handle](PendingUpload const& upload) { return upload.handle == handle; });
+        // ~PixelBufferDescriptor releases the dropped buffers
+        queue.erase(pos, queue.end());
+    }
+}
+
+} // namespace filament
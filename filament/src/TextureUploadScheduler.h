@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_TEXTUREUPLOADSCHEDULER_H
+#define TNT_FILAMENT_TEXTUREUPLOADSCHEDULER_H
+
+#include <filament/Texture.h>
+
+#include "private/backend/DriverApi.h"
+
+#include <backend/DriverEnums.h>
+#include <backend/Handle.h>
+#include <backend/PixelBufferDescriptor.h>
+
+#include <stdint.h>
+
+#include <deque>
+
+namespace filament {
+
+/*
+ * TextureUploadScheduler spreads texture uploads over frames. When streaming completes,
+ * dozens of queued setImage() calls would otherwise all execute in one frame and blow
+ * the GPU's transfer budget for ~30ms. With a per-frame byte budget set
+ * (Engine::setTextureUploadBudget()), uploads that don't fit are queued and issued in
+ * later frames, higher priority class first (Texture::setUploadPriority(), so visible
+ * textures resolve before distant ones), oldest first within a class. At least one
+ * upload is issued per frame so the queue always drains. Without a budget every upload
+ * is issued immediately, as before.
+ */
+class TextureUploadScheduler {
+public:
+    using UploadPriority = Texture::UploadPriority;
+
+    // per-frame budget in bytes, 0 issues all uploads immediately
+    void setBudget(uint32_t bytesPerFrame) noexcept { mBudget = bytesPerFrame; }
+    uint32_t getBudget() const noexcept { return mBudget; }
+
+    void update2DImage(backend::DriverApi& driver,
+            backend::Handle<backend::HwTexture> handle, UploadPriority priority,
+            uint8_t level, uint32_t xoffset, uint32_t yoffset,
+            uint32_t width, uint32_t height,
+            backend::PixelBufferDescriptor&& buffer) noexcept;
+
+    void update3DImage(backend::DriverApi& driver,
+            backend::Handle<backend::HwTexture> handle, UploadPriority priority,
+            uint8_t level, uint32_t xoffset, uint32_t yoffset, uint32_t zoffset,
+            uint32_t width, uint32_t height, uint32_t depth,
+            backend::PixelBufferDescriptor&& buffer) noexcept;
+
+    void updateCubeImage(backend::DriverApi& driver,
+            backend::Handle<backend::HwTexture> handle, UploadPriority priority,
+            uint8_t level, backend::PixelBufferDescriptor&& buffer,
+            backend::FaceOffsets faceOffsets) noexcept;
+
+    // issues pending uploads within the byte budget, called once per frame from
+    // FEngine::prepare()
+    void flush(backend::DriverApi& driver) noexcept;
+
+    // drops pending uploads targeting a destroyed texture; their buffers are released
+    void purge(backend::Handle<backend::HwTexture> handle) noexcept;
+
+    bool isEmpty() const noexcept {
+        for (auto const& queue : mPending) {
+            if (!queue.empty()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    static constexpr size_t PRIORITY_COUNT = 3;
+
+    struct PendingUpload {
+        backend::Handle<backend::HwTexture> handle;
+        backend::PixelBufferDescriptor buffer;
+        backend::FaceOffsets faceOffsets;   // cube uploads only
+        uint32_t xoffset, yoffset, zoffset;
+        uint32_t width, height, depth;
+        uint8_t level;
+        enum class Type : uint8_t { IMAGE_2D, IMAGE_3D, IMAGE_CUBE } type;
+    };
+
+    // whether an upload of the given size can bypass the queue this frame
+    bool fits(UploadPriority priority, size_t size) noexcept;
+    static void issue(backend::DriverApi& driver, PendingUpload& upload) noexcept;
+
+    std::deque<PendingUpload> mPending[PRIORITY_COUNT];
+    uint32_t mBudget = 0;               // bytes per frame, 0 = unlimited
+    size_t mBytesThisFrame = 0;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_TEXTUREUPLOADSCHEDULER_H
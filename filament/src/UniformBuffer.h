@@ -32,6 +32,7 @@
 #include <math/mat4.h>
 
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 
 namespace filament {
@@ -69,7 +70,8 @@ public:
     // invalidate a range of uniforms and return a pointer to it. offset and size given in bytes
     void* invalidateUniforms(size_t offset, size_t size) {
         assert_invariant(offset + size <= mSize);
-        mSomethingDirty = true;
+        mDirtyStart = std::min(mDirtyStart, uint32_t(offset));
+        mDirtyEnd = std::max(mDirtyEnd, uint32_t(offset + size));
         return static_cast<char*>(mBuffer) + offset;
     }
 
@@ -84,10 +86,16 @@ public:
     size_t getSize() const noexcept { return mSize; }
 
     // return if any uniform has been changed
-    bool isDirty() const noexcept { return mSomethingDirty; }
+    bool isDirty() const noexcept { return mDirtyStart < mDirtyEnd; }
+
+    // offset in bytes of the first uniform modified since the last call to clean()
+    size_t getDirtyOffset() const noexcept { return isDirty() ? mDirtyStart : 0; }
+
+    // size in bytes of the range of uniforms modified since the last call to clean()
+    size_t getDirtySize() const noexcept { return isDirty() ? mDirtyEnd - mDirtyStart : 0; }
 
     // mark the whole buffer as clean (no modified uniforms)
-    void clean() const noexcept { mSomethingDirty = false; }
+    void clean() const noexcept { mDirtyStart = UINT32_MAX; mDirtyEnd = 0; }
 
     /*
      * -----------------------------------------------
@@ -203,7 +211,9 @@ private:
     char mStorage[96];
     void *mBuffer = nullptr;
     uint32_t mSize = 0;
-    mutable bool mSomethingDirty = false;
+    // modified range in bytes; the buffer is clean when the range is empty
+    mutable uint32_t mDirtyStart = UINT32_MAX;
+    mutable uint32_t mDirtyEnd = 0;
 };
 
 // specialization for mat3f (which has a different alignment, see std140 layout rules)
@@ -0,0 +1,74 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "UniformBufferArena.h"
+
+#include <utils/debug.h>
+
+#include <algorithm>
+
+namespace filament {
+
+using namespace backend;
+
+UniformBufferArena::UniformBufferArena() noexcept = default;
+
+UniformBufferArena::~UniformBufferArena() noexcept {
+    assert_invariant(mSlabs.empty());
+}
+
+void UniformBufferArena::terminate(DriverApi& driver) {
+    for (auto const& slab : mSlabs) {
+        driver.destroyBufferObject(slab.handle);
+    }
+    mSlabs.clear();
+    mFreeSlots.clear();
+}
+
+UniformBufferArena::Allocation UniformBufferArena::allocate(DriverApi& driver, uint32_t size) {
+    const uint32_t slotSize = (size + OFFSET_ALIGNMENT - 1) & ~(OFFSET_ALIGNMENT - 1);
+
+    // first see if we have a free slot of that size
+    auto pos = mFreeSlots.find(slotSize);
+    if (pos != mFreeSlots.end() && !pos->second.empty()) {
+        Allocation allocation = pos.value().back();
+        pos.value().pop_back();
+        return allocation;
+    }
+
+    // then try to bump-allocate from the most recent slab
+    if (mSlabs.empty() || mSlabs.back().used + slotSize > mSlabs.back().capacity) {
+        // exceptionally large allocations get a dedicated slab
+        const uint32_t capacity = std::max(slotSize, SLAB_SIZE);
+        mSlabs.push_back({
+                driver.createBufferObject(capacity,
+                        BufferObjectBinding::UNIFORM, BufferUsage::DYNAMIC),
+                0, capacity });
+    }
+
+    Slab& slab = mSlabs.back();
+    Allocation allocation = { slab.handle, slab.used, slotSize };
+    slab.used += slotSize;
+    return allocation;
+}
+
+void UniformBufferArena::release(Allocation const& allocation) noexcept {
+    if (allocation) {
+        mFreeSlots[allocation.size].push_back(allocation);
+    }
+}
+
+} // namespace filament
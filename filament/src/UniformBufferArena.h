@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_FILAMENT_UNIFORMBUFFERARENA_H
+#define TNT_FILAMENT_UNIFORMBUFFERARENA_H
+
+#include <backend/Handle.h>
+#include <private/backend/DriverApi.h>
+
+#include <tsl/robin_map.h>
+
+#include <vector>
+
+#include <stdint.h>
+
+namespace filament {
+
+/*
+ * UniformBufferArena sub-allocates uniform-buffer space out of a small number of large
+ * BufferObject slabs, instead of creating one BufferObject per client. Allocations are
+ * long-lived: each client keeps its slot for its whole lifetime, updates it with
+ * updateBufferObject() at (offset + local offset), and binds it with bindUniformBufferRange().
+ * This keeps the number of driver-side buffer objects constant regardless of the number of
+ * material instances, and lets consecutive draws switch instances with an offset change
+ * rather than a buffer change.
+ */
+class UniformBufferArena {
+public:
+    struct Allocation {
+        backend::Handle<backend::HwBufferObject> handle;
+        uint32_t offset = 0;
+        uint32_t size = 0;      // allocated (rounded-up) size in bytes
+
+        explicit operator bool() const noexcept { return bool(handle); }
+    };
+
+    UniformBufferArena() noexcept;
+    ~UniformBufferArena() noexcept;
+
+    UniformBufferArena(UniformBufferArena const& rhs) = delete;
+    UniformBufferArena& operator=(UniformBufferArena const& rhs) = delete;
+
+    // destroys all slabs. All allocations must have been released.
+    void terminate(backend::DriverApi& driver);
+
+    // allocates a uniform-buffer range of at least size bytes
+    Allocation allocate(backend::DriverApi& driver, uint32_t size);
+
+    // returns an allocation to the arena for reuse
+    void release(Allocation const& allocation) noexcept;
+
+private:
+    // Offsets handed out to clients must honor the uniform-buffer offset alignment of the
+    // underlying API; 256 is the worst case across all versions of GLES (see PerRenderableUib).
+    static constexpr uint32_t OFFSET_ALIGNMENT = 256;
+    static constexpr uint32_t SLAB_SIZE = 256 * 1024;
+
+    struct Slab {
+        backend::Handle<backend::HwBufferObject> handle;
+        uint32_t used = 0;
+        uint32_t capacity = 0;
+    };
+
+    std::vector<Slab> mSlabs;
+    // free slots, keyed by their rounded-up size -- slots are never split nor coalesced, which
+    // works well because instances of a given material all request the same size.
+    tsl::robin_map<uint32_t, std::vector<Allocation>> mFreeSlots;
+};
+
+} // namespace filament
+
+#endif // TNT_FILAMENT_UNIFORMBUFFERARENA_H
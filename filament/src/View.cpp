@@ -36,6 +36,8 @@
 #include <private/filament/SibGenerator.h>
 #include <private/filament/UibStructs.h>
 
+#include <utils/Hash.h>
+#include <utils/Log.h>
 #include <utils/Profiler.h>
 #include <utils/Slice.h>
 #include <utils/Systrace.h>
@@ -47,6 +49,8 @@
 
 #include <memory>
 
+#include <stdlib.h>
+
 using namespace utils;
 
 namespace filament {
@@ -119,6 +123,7 @@ void FView::terminate(FEngine& engine) {
     drainFrameHistory(engine);
     mPerViewUniforms.terminate(driver);
     mFroxelizer.terminate(driver);
+    mShadowMapManager.terminate(driver);
 }
 
 void FView::setViewport(filament::Viewport const& viewport) noexcept {
@@ -155,6 +160,22 @@ void FView::setDynamicLightingOptions(float zLightNear, float zLightFar) noexcep
     mFroxelizer.setOptions(zLightNear, zLightFar);
 }
 
+void FView::setFroxelQuality(QualityLevel quality) noexcept {
+    size_t froxelBufferEntryCount = FROXEL_BUFFER_ENTRY_COUNT_MAX;
+    switch (quality) {
+        case QualityLevel::LOW:
+            froxelBufferEntryCount = FROXEL_BUFFER_ENTRY_COUNT_MAX / 4;
+            break;
+        case QualityLevel::MEDIUM:
+            froxelBufferEntryCount = FROXEL_BUFFER_ENTRY_COUNT_MAX / 2;
+            break;
+        case QualityLevel::HIGH:
+        case QualityLevel::ULTRA:
+            break;
+    }
+    mFroxelizer.setFroxelBufferEntryCount(froxelBufferEntryCount);
+}
+
 float2 FView::updateScale(FEngine& engine,
         FrameInfo const& info,
         Renderer::FrameRateOptions const& frameRateOptions,
@@ -167,8 +188,10 @@ float2 FView::updateScale(FEngine& engine,
     DynamicResolutionOptions const& options = mDynamicResolution;
     if (options.enabled) {
         if (!UTILS_UNLIKELY(info.valid)) {
-            // always clamp to the min/max scale range
-            mScale = clamp(1.0f, options.minScale, options.maxScale);
+            // no GPU measurement available (first frames, or the frame timer is paused
+            // while per-pass profiling is active); hold the current scale rather than
+            // snapping back toward 1.0, the loop resumes where it left off
+            mScale = clamp(mScale, options.minScale, options.maxScale);
             return mScale;
         }
 
@@ -282,6 +305,78 @@ bool FView::isSkyboxVisible() const noexcept {
     return skybox != nullptr && (skybox->getLayerMask() & mVisibleLayers);
 }
 
+// murmur3 of any trivially-copyable value, chained through `seed`. Padding bytes may
+// differ between otherwise equal values; this can only cause a spurious re-render, which
+// is safe (the skip must be conservative).
+template<typename T>
+static uint32_t hashRenderState(T const& value, uint32_t seed) noexcept {
+    constexpr size_t wordCount = (sizeof(T) + 3) / 4;
+    uint32_t words[wordCount] = {};
+    memcpy(words, &value, sizeof(T));
+    return utils::hash::murmur3(words, wordCount, seed);
+}
+
+uint32_t FView::computeRenderStateHash() const noexcept {
+    uint32_t h = 0;
+    FCamera const* const camera = mViewingCamera ? mViewingCamera : mCullingCamera;
+    if (camera) {
+        h = hashRenderState(camera->getModelMatrix(), h);
+        h = hashRenderState(camera->getProjectionMatrix(), h);
+        h = hashRenderState(camera->getScaling(), h);
+        h = hashRenderState(math::float4{ camera->getAperture(), camera->getShutterSpeed(),
+                camera->getSensitivity(), camera->getFocusDistance() }, h);
+    }
+    // the scene's environment is plain pointers, not versioned; a swap must trigger a render
+    if (mScene) {
+        h = hashRenderState(mScene->getSkybox(), h);
+        h = hashRenderState(mScene->getIndirectLight(), h);
+    }
+    h = hashRenderState(mViewport, h);
+    h = hashRenderState(mRenderTarget, h);
+    h = hashRenderState(mColorGrading, h);
+    struct {
+        uint8_t visibleLayers;
+        bool culling, frontFaceWindingInverted, shadowingEnabled;
+        bool screenSpaceRefractionEnabled, hasPostProcessPass;
+        AntiAliasing antiAliasing;
+        Dithering dithering;
+        ShadowType shadowType;
+        BlendMode blendMode;
+        uint8_t blendedBucketBits;
+        bool depthPrepass;
+    } const flags{ mVisibleLayers, mCulling, mFrontFaceWindingInverted, mShadowingEnabled,
+            mScreenSpaceRefractionEnabled, mHasPostProcessPass, mAntiAliasing, mDithering,
+            mShadowType, mBlendMode, mBlendedBucketBits, mDepthPrepass };
+    h = hashRenderState(flags, h);
+    h = hashRenderState(mAmbientOcclusionOptions, h);
+    h = hashRenderState(mVsmShadowOptions, h);
+    h = hashRenderState(mSoftShadowOptions, h);
+    h = hashRenderState(mBloomOptions, h);
+    h = hashRenderState(mFogOptions, h);
+    h = hashRenderState(mDepthOfFieldOptions, h);
+    h = hashRenderState(mVignetteOptions, h);
+    h = hashRenderState(mTemporalAntiAliasingOptions, h);
+    h = hashRenderState(mMultiSampleAntiAliasingOptions, h);
+    h = hashRenderState(mScreenSpaceReflectionsOptions, h);
+    h = hashRenderState(mRenderQuality, h);
+    return h;
+}
+
+bool FView::isRenderStateUnchanged() noexcept {
+    uint64_t const contentVersion = mScene->getContentVersion();
+    uint32_t const stateHash = computeRenderStateHash();
+    if (UTILS_LIKELY(!mInvalidated
+            && contentVersion == mRenderedContentVersion
+            && stateHash == mRenderedStateHash)) {
+        return true;
+    }
+    // something changed: record the state the caller is about to render
+    mInvalidated = false;
+    mRenderedContentVersion = contentVersion;
+    mRenderedStateHash = stateHash;
+    return false;
+}
+
 void FView::prepareShadowing(FEngine& engine, DriverApi& driver,
         FScene::RenderableSoa& renderableData, FScene::LightSoa& lightData) noexcept {
     SYSTRACE_CALL();
@@ -309,6 +404,16 @@ void FView::prepareShadowing(FEngine& engine, DriverApi& driver,
     // Find all shadow-casting spotlights.
     size_t shadowCastingSpotCount = 0;
 
+    // Number of consecutive frames a light's influence volume must be occluded before its
+    // shadow map stops being rendered. Occlusion queries can flicker at occluder
+    // silhouettes, and a shadow popping back in is far more noticeable than a few wasted
+    // shadow passes, so deactivation is fenced; reactivation is always immediate.
+    constexpr uint8_t OCCLUDED_SHADOW_FENCE_FRAMES = 4;
+    const bool hasOccluders = mOcclusionCuller.hasOccluders();
+    if (UTILS_LIKELY(!hasOccluders) && UTILS_UNLIKELY(!mOccludedSpotShadowFence.empty())) {
+        mOccludedSpotShadowFence.clear();
+    }
+
     // We allow a max of CONFIG_MAX_SHADOW_CASTING_SPOTS spot light shadows. Any additional
     // shadow-casting spotlights are ignored.
     for (size_t l = FScene::DIRECTIONAL_LIGHTS_COUNT; l < lightData.size(); l++) {
@@ -330,6 +435,25 @@ void FView::prepareShadowing(FEngine& engine, DriverApi& driver,
             continue; // is not a spot-li (we're not supporting point-lights yet)
         }
 
+        if (UTILS_UNLIKELY(hasOccluders)) {
+            // A light whose entire influence volume is hidden behind occluders can't
+            // produce a visible shadow (frustum culling already happened in
+            // prepareVisibleLights()), so we don't render its shadow map. The light is
+            // still shaded normally -- only the shadow pass is elided.
+            const auto sphere = lightData.elementAt<FScene::POSITION_RADIUS>(l);
+            uint8_t& fence = mOccludedSpotShadowFence[uint32_t(li.asValue())];
+            if (mOcclusionCuller.isOccluded(sphere.xyz, math::float3{ sphere.w })) {
+                if (fence < OCCLUDED_SHADOW_FENCE_FRAMES) {
+                    fence++;
+                }
+            } else {
+                fence = 0;
+            }
+            if (fence >= OCCLUDED_SHADOW_FENCE_FRAMES) {
+                continue;
+            }
+        }
+
         const auto& shadowOptions = lcm.getShadowOptions(li);
         mShadowMapManager.addSpotShadowMap(l, &shadowOptions);
         ++shadowCastingSpotCount;
@@ -394,7 +518,8 @@ void FView::prepareLighting(FEngine& engine, FEngine::DriverApi& driver, ArenaSc
         intensity = skybox ? skybox->getIntensity() : FIndirectLight::DEFAULT_INTENSITY;
     }
 
-    mPerViewUniforms.prepareAmbientLight(*ibl, intensity, exposure);
+    mPerViewUniforms.prepareAmbientLight(*ibl, intensity, exposure,
+            scene->getIndirectLightBlendTarget(), scene->getIndirectLightBlend());
 
     /*
      * Directional light (always at index 0)
@@ -406,52 +531,66 @@ void FView::prepareLighting(FEngine& engine, FEngine::DriverApi& driver, ArenaSc
     mHasDirectionalLight = directionalLight.isValid();
 }
 
-void FView::prepare(FEngine& engine, DriverApi& driver, ArenaScope& arena,
-        filament::Viewport const& viewport, float4 const& userTime) noexcept {
-    JobSystem& js = engine.getJobSystem();
-
-    /*
-     * Prepare the scene -- this is where we gather all the objects added to the scene,
-     * and in particular their world-space AABB.
-     */
-
-    FScene* const scene = getScene();
-
+mat4 FView::getWorldOriginScene(FEngine& engine) const noexcept {
     /*
      * We apply a "world origin" to "everything" in order to implement the IBL rotation.
      * The "world origin" could also be useful for other things, like keeping the origin
      * close to the camera position to improve fp precision in the shader for large scenes.
      */
     mat4 worldOriginScene;
-    FIndirectLight const* const ibl = scene->getIndirectLight();
+    FIndirectLight const* const ibl = mScene->getIndirectLight();
     if (ibl) {
         // the IBL transformation must be a rigid transform
-        mat3f rotation{ scene->getIndirectLight()->getRotation() };
+        mat3f rotation{ ibl->getRotation() };
         // for a rigid-body transform, the inverse is the transpose
         worldOriginScene = mat4{ transpose(rotation) };
     }
 
-    /*
-     * Calculate all camera parameters needed to render this View for this frame.
-     */
-    FCamera const* const camera = mViewingCamera ? mViewingCamera : mCullingCamera;
-
     if (engine.debug.view.camera_at_origin) {
         // this moves the camera to the origin, effectively doing all shader computations in
         // view-space, which improves floating point precision in the shader by staying around
         // zero, where fp precision is highest. This also ensures that when the camera is placed
         // very far from the origin, objects are still rendered and lit properly.
-        worldOriginScene[3].xyz -= camera->getPosition();
+        // When a shared culling camera is set, key the origin off it instead of the eye camera,
+        // so that the world-space data prepared below is identical for all views sharing it and
+        // the scene's incremental prepare path short-circuits for the second eye.
+        FCamera const* const camera = mViewingCamera ? mViewingCamera : mCullingCamera;
+        worldOriginScene[3].xyz -=
+                (mSharedCullingCamera ? mSharedCullingCamera : camera)->getPosition();
     }
+    return worldOriginScene;
+}
+
+void FView::prepare(FEngine& engine, DriverApi& driver, ArenaScope& arena,
+        filament::Viewport const& viewport, float4 const& userTime) noexcept {
+    JobSystem& js = engine.getJobSystem();
+
+    /*
+     * Prepare the scene -- this is where we gather all the objects added to the scene,
+     * and in particular their world-space AABB.
+     */
+
+    FScene* const scene = getScene();
+
+    const mat4 worldOriginScene = getWorldOriginScene(engine);
+
+    /*
+     * Calculate all camera parameters needed to render this View for this frame.
+     */
+    FCamera const* const camera = mViewingCamera ? mViewingCamera : mCullingCamera;
+
+    // the shared culling camera (stereo rendering) takes precedence over the view's own camera
+    FCamera const* const cullingCamera = mSharedCullingCamera ? mSharedCullingCamera : mCullingCamera;
 
     // Note: for debugging (i.e. visualize what the camera / objects are doing, using
     // the viewing camera), we can set worldOriginScene to identity when mViewingCamera
     // is set
     mViewingCameraInfo = CameraInfo(*camera, worldOriginScene);
 
-    mCullingFrustum = Frustum(mat4f{
-                    mCullingCamera->getCullingProjectionMatrix() *
-                    inverse(worldOriginScene * mCullingCamera->getModelMatrix()) });
+    const mat4f cullingViewProjection{
+            cullingCamera->getCullingProjectionMatrix() *
+            inverse(worldOriginScene * cullingCamera->getModelMatrix()) };
+    mCullingFrustum = Frustum(cullingViewProjection);
 
     /*
      * Gather all information needed to render this scene. Apply the world origin to all
@@ -485,8 +624,39 @@ void FView::prepare(FEngine& engine, DriverApi& driver, ArenaScope& arena,
          * (this will set the VISIBLE_RENDERABLE bit)
          */
 
+        /*
+         * FILAMENT_CULLING_CAPTURE=<path> dumps this view's culling inputs (frustum and
+         * renderable bounds) to <path> for replay by benchmark_filament, once, at the
+         * frame selected with FILAMENT_CULLING_CAPTURE_FRAME (first frame by default,
+         * pick a later one if the scene streams in progressively).
+         */
+        static const char* const capturePath = getenv("FILAMENT_CULLING_CAPTURE");
+        if (UTILS_UNLIKELY(capturePath)) {
+            static const char* const captureFrame = getenv("FILAMENT_CULLING_CAPTURE_FRAME");
+            static uint32_t remainingFrames = captureFrame ? strtoul(captureFrame, nullptr, 10) : 0;
+            static bool done = false;
+            if (!done && renderableData.size() > 0 && remainingFrames-- == 0) {
+                done = Culler::dumpCapture(capturePath, mCullingFrustum,
+                        renderableData.data<FScene::WORLD_AABB_CENTER>(),
+                        renderableData.data<FScene::WORLD_AABB_EXTENT>(),
+                        renderableData.size());
+                slog.i << "culling capture " << (done ? "written to " : "failed: ")
+                       << capturePath << io::endl;
+            }
+        }
+
         prepareVisibleRenderables(js, mCullingFrustum, renderableData);
 
+        /*
+         * Occlusion: rasterize the occluders and build the depth pyramid now, so that
+         * prepareShadowing() below can already query it (shadowed lights entirely hidden
+         * behind occluders don't get a shadow map). The per-renderable occlusion test
+         * runs later, after computeVisibilityMasks().
+         */
+        mOcclusionCuller.prepare(renderableData.data<FScene::VISIBILITY_STATE>(),
+                renderableData.data<FScene::WORLD_AABB_CENTER>(),
+                renderableData.data<FScene::WORLD_AABB_EXTENT>(),
+                renderableData.size(), cullingViewProjection);
 
         /*
          * Shadowing: compute the shadow camera and cull shadow casters
@@ -524,6 +694,17 @@ void FView::prepare(FEngine& engine, DriverApi& driver, ArenaScope& arena,
         computeVisibilityMasks(getVisibleLayers(), layers, visibility, cullingMask.begin(),
                 renderableData.size());
 
+        /*
+         * Occlusion: renderables whose bounding box is entirely hidden behind the designated
+         * occluders don't need to be drawn. Only the VISIBLE_RENDERABLE bit is cleared, so
+         * occluded renderables still cast shadows. This is a no-op when the scene contains
+         * no occluders.
+         */
+        mOcclusionCuller.cull(cullingMask.begin(), visibility,
+                renderableData.data<FScene::WORLD_AABB_CENTER>(),
+                renderableData.data<FScene::WORLD_AABB_EXTENT>(),
+                renderableData.size(), VISIBLE_RENDERABLE_BIT);
+
         auto const beginRenderables = renderableData.begin();
         auto beginCasters = partition(beginRenderables, renderableData.end(), VISIBLE_RENDERABLE);
         auto beginCastersOnly = partition(beginCasters, renderableData.end(),
@@ -719,13 +900,100 @@ void FView::prepareVisibleRenderables(JobSystem& js,
         Frustum const& frustum, FScene::RenderableSoa& renderableData) const noexcept {
     SYSTRACE_CALL();
     if (UTILS_LIKELY(isFrustumCullingEnabled())) {
-        FView::cullRenderables(js, renderableData, frustum, VISIBLE_RENDERABLE_BIT);
+        cullRenderablesCoherent(js, renderableData, frustum);
     } else {
         std::uninitialized_fill(renderableData.begin<FScene::VISIBLE_MASK>(),
                   renderableData.end<FScene::VISIBLE_MASK>(), VISIBLE_RENDERABLE);
     }
 }
 
+void FView::cullRenderablesCoherent(JobSystem& js,
+        FScene::RenderableSoa& renderableData, Frustum const& frustum) const noexcept {
+    SYSTRACE_CALL();
+
+    VisibilityCache& cache = mVisibilityCache;
+    uint32_t const count = uint32_t(renderableData.size());
+    uint64_t const sceneVersion = mScene->getContentVersion();
+
+    float3 const* UTILS_RESTRICT const center = renderableData.data<FScene::WORLD_AABB_CENTER>();
+    float3 const* UTILS_RESTRICT const extent = renderableData.data<FScene::WORLD_AABB_EXTENT>();
+    FScene::VisibleMaskType* UTILS_RESTRICT const visibleArray =
+            renderableData.data<FScene::VISIBLE_MASK>();
+
+    // conservative bound on how much any plane test can have drifted since the full cull:
+    // a rotation of the plane normal contributes at most its angle times the distance of
+    // the farthest renderable, a translation contributes the change of the plane offset
+    bool incremental = cache.valid && cache.count == count && cache.sceneVersion == sceneVersion;
+    float delta = 0.0f;
+    if (incremental) {
+        float4 const* UTILS_RESTRICT const p0 = cache.frustum.getNormalizedPlanes();
+        float4 const* UTILS_RESTRICT const p1 = frustum.getNormalizedPlanes();
+        for (size_t j = 0; j < 6; j++) {
+            delta = std::max(delta, length(p1[j].xyz - p0[j].xyz) * cache.sceneBound
+                    + std::abs(p1[j].w - p0[j].w));
+        }
+        // once the frustum has drifted too far, most margins are smaller than the drift
+        // and the incremental path degenerates to a full cull with extra bookkeeping
+        incremental = delta < 0.05f * cache.sceneBound;
+    }
+
+    if (!incremental) {
+        // full cull, recording each renderable's plane-distance margin for later frames
+        cache.maxDot.resize(Culler::round(count));
+        float* UTILS_RESTRICT const maxDots = cache.maxDot.data();
+        auto functor = [&frustum, center, extent, visibleArray, maxDots]
+                (uint32_t index, uint32_t c) {
+            Culler::intersects(visibleArray + index, maxDots + index, frustum,
+                    center + index, extent + index, c, VISIBLE_RENDERABLE_BIT);
+        };
+
+        // same fan-out strategy as cullRenderables() below
+        constexpr uint32_t PARALLEL_THRESHOLD = 16384;
+        constexpr uint32_t CHUNK = 8192;
+        if (UTILS_LIKELY(count < PARALLEL_THRESHOLD)) {
+            functor(0, count);
+        } else {
+            JobSystem::Job* parent = js.createJob();
+            for (uint32_t index = 0; index < count; index += CHUNK) {
+                js.run(jobs::createJob(js, parent, std::cref(functor),
+                        index, std::min(CHUNK, count - index)));
+            }
+            js.runAndWait(parent);
+        }
+
+        float sceneBound = 0.0f;
+        for (uint32_t i = 0; i < count; i++) {
+            sceneBound = std::max(sceneBound, length(center[i]) + length(extent[i]));
+        }
+        cache.center.assign(center, center + count);
+        cache.extent.assign(extent, extent + count);
+        cache.sceneBound = sceneBound;
+        cache.frustum = frustum;
+        cache.sceneVersion = sceneVersion;
+        cache.count = count;
+        cache.valid = true;
+        return;
+    }
+
+    // incremental cull: renderables farther from every frustum plane than the drift keep
+    // last frame's result; only those inside the band -- or that moved since the full
+    // cull -- are re-tested. All margins stay relative to the last full cull, so the
+    // reuse criterion remains conservative as the drift accumulates.
+    float const* UTILS_RESTRICT const maxDots = cache.maxDot.data();
+    float3 const* UTILS_RESTRICT const prevCenter = cache.center.data();
+    float3 const* UTILS_RESTRICT const prevExtent = cache.extent.data();
+    for (uint32_t i = 0; i < count; i++) {
+        float maxDot = maxDots[i];
+        bool const moved = center[i] != prevCenter[i] || extent[i] != prevExtent[i];
+        if (UTILS_UNLIKELY(moved || std::abs(maxDot) <= delta)) {
+            maxDot = Culler::maxPlaneDistance(frustum, center[i], extent[i]);
+        }
+        if (maxDot < 0.0f) {
+            visibleArray[i] |= VISIBLE_RENDERABLE;
+        }
+    }
+}
+
 void FView::cullRenderables(JobSystem& js,
         FScene::RenderableSoa& renderableData, Frustum const& frustum, size_t bit) noexcept {
     SYSTRACE_CALL();
@@ -745,11 +1013,28 @@ void FView::cullRenderables(JobSystem& js,
     };
 
     // Note: we can't use jobs::parallel_for() here because Culler::intersects() must process
-    //       multiples of eight primitives.
-    // Moreover, even with a large number of primitives, the overhead of the JobSystem is too
+    //       multiples of Culler::MODULO primitives, and the halving splitter doesn't
+    //       guarantee aligned ranges.
+    // Moreover, with a moderate number of primitives, the overhead of the JobSystem is too
     // large compared to the run time of Culler::intersects, e.g.: ~100us for 4000 primitives
-    // on Pixel4.
-    functor(0, renderableData.size());
+    // on Pixel4. For very large scenes however, culling dominates prepare(), so above a
+    // threshold we fan out fixed-size aligned chunks to the workers.
+    uint32_t const count = uint32_t(renderableData.size());
+    constexpr uint32_t PARALLEL_THRESHOLD = 16384;
+    if (UTILS_LIKELY(count < PARALLEL_THRESHOLD)) {
+        functor(0, count);
+        return;
+    }
+
+    constexpr uint32_t CHUNK = 8192;
+    static_assert(CHUNK % Culler::MODULO == 0,
+            "chunks must be aligned to Culler::MODULO, intersects() rounds the count up");
+    JobSystem::Job* parent = js.createJob();
+    for (uint32_t index = 0; index < count; index += CHUNK) {
+        js.run(jobs::createJob(js, parent, std::cref(functor),
+                index, std::min(CHUNK, count - index)));
+    }
+    js.runAndWait(parent);
 }
 
 void FView::prepareVisibleLights(FLightManager const& lcm, ArenaScope& rootArena,
@@ -862,12 +1147,27 @@ inline void FView::computeLightCameraDistances(
     }
 }
 
-void FView::updatePrimitivesLod(FEngine& engine, const CameraInfo&,
+void FView::updatePrimitivesLod(FEngine& engine, const CameraInfo& camera,
         FScene::RenderableSoa& renderableData, Range visible) noexcept {
     FRenderableManager const& rcm = engine.getRenderableManager();
+    float3 const* const UTILS_RESTRICT worldAABBCenter =
+            renderableData.data<FScene::WORLD_AABB_CENTER>();
+    float3 const* const UTILS_RESTRICT worldAABBExtent =
+            renderableData.data<FScene::WORLD_AABB_EXTENT>();
+    float3 const cameraPosition = camera.getPosition();
+    // cot(fovy / 2): a bounding sphere of radius r at distance d covers r * cot(fovy/2) / d
+    // of the viewport height (in NDC, the viewport height maps to [-1, 1])
+    float const cotHalfFov = camera.projection[1][1];
     for (uint32_t index : visible) {
-        uint8_t level = 0; // TODO: pick the proper level of detail
         auto ri = renderableData.elementAt<FScene::RENDERABLE_INSTANCE>(index);
+        uint8_t level = 0;
+        if (UTILS_UNLIKELY(rcm.getLevelCount(ri) > 1)) {
+            float const radius = length(worldAABBExtent[index]);
+            float const distance = length(worldAABBCenter[index] - cameraPosition);
+            float const coverage = distance > radius ?
+                    radius * cotHalfFov / distance : 1.0f;
+            level = rcm.getLodLevel(ri, coverage);
+        }
         renderableData.elementAt<FScene::PRIMITIVES>(index) = rcm.getRenderPrimitives(ri, level);
     }
 }
@@ -882,6 +1182,8 @@ void FView::commitFrameHistory(FEngine& engine) noexcept {
     auto& frameHistory = mFrameHistory;
     FrameHistoryEntry& last = frameHistory.back();
     last.color.destroy(engine.getResourceAllocator());
+    last.ssao.destroy(engine.getResourceAllocator());
+    last.adaptedLuminance.destroy(engine.getResourceAllocator());
 
     // and then push the new history entry to the history stack
     frameHistory.commit();
@@ -960,6 +1262,10 @@ void View::setDebugCamera(Camera* camera) noexcept {
     upcast(this)->setViewingCamera(upcast(camera));
 }
 
+void View::setSharedCullingCamera(Camera* camera) noexcept {
+    upcast(this)->setSharedCullingCamera(upcast(camera));
+}
+
 void View::setVisibleLayers(uint8_t select, uint8_t values) noexcept {
     upcast(this)->setVisibleLayers(select, values);
 }
@@ -988,6 +1294,10 @@ RenderTarget* View::getRenderTarget() const noexcept {
     return upcast(this)->getRenderTarget();
 }
 
+void View::invalidate() noexcept {
+    upcast(this)->invalidate();
+}
+
 void View::setSampleCount(uint8_t count) noexcept {
     upcast(this)->setSampleCount(count);
 }
@@ -1012,6 +1322,18 @@ const View::TemporalAntiAliasingOptions& View::getTemporalAntiAliasingOptions()
     return upcast(this)->getTemporalAntiAliasingOptions();
 }
 
+void View::setAutoExposureOptions(AutoExposureOptions options) noexcept {
+    upcast(this)->setAutoExposureOptions(options);
+}
+
+const View::AutoExposureOptions& View::getAutoExposureOptions() const noexcept {
+    return upcast(this)->getAutoExposureOptions();
+}
+
+float View::getAdaptedLuminance() const noexcept {
+    return upcast(this)->getAdaptedLuminance();
+}
+
 void View::setMultiSampleAntiAliasingOptions(MultiSampleAntiAliasingOptions options) noexcept {
     upcast(this)->setMultiSampleAntiAliasingOptions(options);
 }
@@ -1080,6 +1402,10 @@ void View::setDynamicLightingOptions(float zLightNear, float zLightFar) noexcept
     upcast(this)->setDynamicLightingOptions(zLightNear, zLightFar);
 }
 
+void View::setFroxelQuality(View::QualityLevel quality) noexcept {
+    upcast(this)->setFroxelQuality(quality);
+}
+
 void View::setShadowType(View::ShadowType shadow) noexcept {
     upcast(this)->setShadowType(shadow);
 }
@@ -1100,6 +1426,14 @@ SoftShadowOptions View::getSoftShadowOptions() const noexcept {
     return upcast(this)->getSoftShadowOptions();
 }
 
+void View::setShadowUpdateOptions(ShadowUpdateOptions const& options) noexcept {
+    upcast(this)->setShadowUpdateOptions(options);
+}
+
+ShadowUpdateOptions View::getShadowUpdateOptions() const noexcept {
+    return upcast(this)->getShadowUpdateOptions();
+}
+
 void View::setAmbientOcclusion(View::AmbientOcclusion ambientOcclusion) noexcept {
     upcast(this)->setAmbientOcclusion(ambientOcclusion);
 }
@@ -1152,6 +1486,22 @@ void View::setBlendMode(BlendMode blendMode) noexcept {
     upcast(this)->setBlendMode(blendMode);
 }
 
+void View::setDepthPrepassEnabled(bool enabled) noexcept {
+    upcast(this)->setDepthPrepassEnabled(enabled);
+}
+
+bool View::isDepthPrepassEnabled() const noexcept {
+    return upcast(this)->isDepthPrepassEnabled();
+}
+
+void View::setBlendedDistanceBuckets(uint16_t bucketCount) noexcept {
+    upcast(this)->setBlendedDistanceBuckets(bucketCount);
+}
+
+uint16_t View::getBlendedDistanceBuckets() const noexcept {
+    return upcast(this)->getBlendedDistanceBuckets();
+}
+
 View::BlendMode View::getBlendMode() const noexcept {
     return upcast(this)->getBlendMode();
 }
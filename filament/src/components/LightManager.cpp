@@ -176,6 +176,8 @@ void FLightManager::create(const FLightManager::Builder& builder, utils::Entity
     assert_invariant(i);
 
     if (i) {
+        ++mStructureVersion;
+
         // This needs to happen before we call the set() methods below
         // Type must be set first (some calls depend on it below)
         LightType& lightType = manager[i].lightType;
@@ -208,6 +210,7 @@ void FLightManager::prepare(backend::DriverApi& driver) const noexcept {
 void FLightManager::destroy(utils::Entity e) noexcept {
     Instance i = getInstance(e);
     if (i) {
+        ++mStructureVersion;
         auto& manager = mManager;
         manager.removeComponent(e);
     }
@@ -248,6 +251,7 @@ void FLightManager::setLightChannel(Instance i, unsigned int channel, bool enabl
             const uint8_t mask = 1u << channel;
             manager[i].channels &= ~mask;
             manager[i].channels |= enable ? mask : 0u;
+            updateActiveState(i);
         }
     }
 }
@@ -336,6 +340,7 @@ void FLightManager::setIntensity(Instance i, float intensity, IntensityUnit unit
                 break;
         }
         manager[i].intensity = luminousIntensity;
+        updateActiveState(i);
     }
 }
 
@@ -378,6 +383,7 @@ void FLightManager::setSpotLightCone(Instance i, float inner, float outer) noexc
             float luminousPower = spotParams.luminousPower;
             float luminousIntensity = luminousPower / (f::TAU * (1.0f - cosOuter));
             manager[i].intensity = luminousIntensity;
+            updateActiveState(i);
         }
     }
 }
@@ -60,6 +60,12 @@ public:
         return mManager.getInstance(e);
     }
 
+    // incremented every time a component is added or removed; used by FScene to know
+    // when the list of light entities it gathered during prepare() went stale
+    uint32_t getStructureVersion() const noexcept {
+        return mStructureVersion;
+    }
+
     void create(const FLightManager::Builder& builder, utils::Entity entity);
 
     void destroy(utils::Entity e) noexcept;
@@ -67,13 +73,17 @@ public:
     void prepare(backend::DriverApi& driver) const noexcept;
 
     void gc(utils::EntityManager& em) noexcept {
-        mManager.gc(em);
+        mManager.gc(em, 4, [this](utils::Entity e) {
+            mManager.removeComponent(e);
+            ++mStructureVersion;
+        });
     }
 
     struct LightType {
         Type type : 3;
         bool shadowCaster : 1;
         bool lightCaster : 1;
+        bool active : 1;    // derived: lightCaster && intensity > 0 && channels != 0
     };
 
     struct SpotParams {
@@ -124,6 +134,13 @@ public:
         return getLightType(i).lightCaster;
     }
 
+    // Whether the light can contribute at all: it casts light, has a non-zero intensity and
+    // at least one channel enabled. Maintained incrementally by the setters so that FScene
+    // can compact the per-frame light list down to the active set with a single bit test.
+    bool isLightActive(Instance i) const noexcept {
+        return getLightType(i).active;
+    }
+
     bool isPointLight(Instance i) const noexcept {
         return getType(i) == Type::POINT; 
     }
@@ -298,8 +315,17 @@ private:
         }
     };
 
+    // recomputes the cached LightType::active bit, called by the setters it depends on
+    void updateActiveState(Instance i) noexcept {
+        LightType& lightType = mManager[i].lightType;
+        lightType.active = lightType.lightCaster
+                && mManager[i].intensity > 0.0f
+                && mManager[i].channels != 0;
+    }
+
     Sim mManager;
     FEngine& mEngine;
+    uint32_t mStructureVersion = 0;
 };
 
 FILAMENT_UPCAST(LightManager)
@@ -30,10 +30,16 @@
 
 #include <backend/DriverEnums.h>
 
+#include <utils/Hash.h>
+#include <utils/JobSystem.h>
 #include <utils/Log.h>
 #include <utils/Panic.h>
 #include <utils/debug.h>
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
 
 using namespace filament::math;
 using namespace utils;
@@ -53,6 +59,7 @@ struct RenderableManager::BuilderDetails {
     bool mCastShadows : 1;
     bool mReceiveShadows : 1;
     bool mScreenSpaceContactShadows : 1;
+    bool mOccluder : 1;
     bool mSkinningBufferMode : 1;
     size_t mSkinningBoneCount = 0;
     size_t mMorphTargetCount = 0;
@@ -60,10 +67,11 @@ struct RenderableManager::BuilderDetails {
     mat4f const* mUserBoneMatrices = nullptr;
     FSkinningBuffer* mSkinningBuffer = nullptr;
     uint32_t mSkinningBufferOffset = 0;
+    FRenderableManager::LodTable mLodTable{};
 
     explicit BuilderDetails(size_t count)
             : mEntries(count), mCulling(true), mCastShadows(false), mReceiveShadows(true),
-              mScreenSpaceContactShadows(false), mSkinningBufferMode(false) {
+              mScreenSpaceContactShadows(false), mOccluder(false), mSkinningBufferMode(false) {
     }
     // this is only needed for the explicit instantiation below
     BuilderDetails() = default;
@@ -108,6 +116,28 @@ RenderableManager::Builder& RenderableManager::Builder::geometry(size_t index,
     return *this;
 }
 
+RenderableManager::Builder& RenderableManager::Builder::boundingCone(size_t index,
+        float3 center, float radius, float3 axis, float cutoff) noexcept {
+    std::vector<Entry>& entries = mImpl->mEntries;
+    if (index < entries.size()) {
+        entries[index].coneCenter = center;
+        entries[index].coneRadius = radius;
+        entries[index].coneAxis = axis;
+        entries[index].coneCutoff = cutoff;
+    }
+    return *this;
+}
+
+RenderableManager::Builder& RenderableManager::Builder::lod(uint8_t level, size_t offset,
+        size_t count, float minScreenCoverage) noexcept {
+    FRenderableManager::LodTable& table = mImpl->mLodTable;
+    if (level < CONFIG_MAX_LOD_COUNT) {
+        table.levels[level] = { uint16_t(offset), uint16_t(count), minScreenCoverage };
+        table.levelCount = std::max(table.levelCount, uint8_t(level + 1u));
+    }
+    return *this;
+}
+
 RenderableManager::Builder& RenderableManager::Builder::material(size_t index,
         MaterialInstance const* materialInstance) noexcept {
     if (index < mImpl->mEntries.size()) {
@@ -160,6 +190,11 @@ RenderableManager::Builder& RenderableManager::Builder::screenSpaceContactShadow
     return *this;
 }
 
+RenderableManager::Builder& RenderableManager::Builder::occluder(bool enable) noexcept {
+    mImpl->mOccluder = enable;
+    return *this;
+}
+
 RenderableManager::Builder& RenderableManager::Builder::skinning(size_t boneCount) noexcept {
     mImpl->mSkinningBoneCount = boneCount;
     return *this;
@@ -212,6 +247,18 @@ RenderableManager::Builder::Result RenderableManager::Builder::build(Engine& eng
         return Error;
     }
 
+    FRenderableManager::LodTable const& lodTable = mImpl->mLodTable;
+    for (size_t i = 0; i < lodTable.levelCount; i++) {
+        auto const& level = lodTable.levels[i];
+        if (!ASSERT_PRECONDITION_NON_FATAL(
+                level.offset + level.count <= mImpl->mEntries.size(),
+                "[entity=%u, lod %u] offset (%u) + count (%u) > primitive count (%u)",
+                entity.getId(), unsigned(i),
+                level.offset, level.count, unsigned(mImpl->mEntries.size()))) {
+            return Error;
+        }
+    }
+
     for (size_t i = 0, c = mImpl->mEntries.size(); i < c; i++) {
         auto& entry = mImpl->mEntries[i];
 
@@ -309,6 +356,10 @@ void FRenderableManager::create(
         }
         setPrimitives(ci, { rp, size_type(builder->mEntries.size()) });
 
+        if (builder->mLodTable.levelCount > 0) {
+            manager[ci].lod = new LodTable(builder->mLodTable);
+        }
+
         setAxisAlignedBoundingBox(ci, builder->mAABB);
         setLayerMask(ci, builder->mLayerMask);
         setPriority(ci, builder->mPriority);
@@ -316,6 +367,7 @@ void FRenderableManager::create(
         setReceiveShadows(ci, builder->mReceiveShadows);
         setScreenSpaceContactShadows(ci, builder->mScreenSpaceContactShadows);
         setCulling(ci, builder->mCulling);
+        setOccluder(ci, builder->mOccluder);
         setSkinning(ci, false);
         setMorphing(ci, builder->mMorphTargetCount);
         mManager[ci].channels = builder->mChannels;
@@ -397,6 +449,7 @@ void FRenderableManager::create(
 void FRenderableManager::destroy(utils::Entity e) noexcept {
     Instance ci = getInstance(e);
     if (ci) {
+        ++mVersion;
         destroyComponent(ci);
         mManager.removeComponent(e);
     }
@@ -416,6 +469,14 @@ void FRenderableManager::terminate() noexcept {
             manager.removeComponent(manager.getEntity(ci));
         }
     }
+
+    // with all components gone, every shared bone palette has been released
+    assert_invariant(mBonePaletteCache.empty());
+    FEngine::DriverApi& driver = mEngine.getDriverApi();
+    for (auto const& handle : mBonePaletteFreeList) {
+        driver.destroyBufferObject(handle);
+    }
+    mBonePaletteFreeList.clear();
 }
 
 // This is basically a Renderable's destructor.
@@ -425,11 +486,19 @@ void FRenderableManager::destroyComponent(Instance ci) noexcept {
 
     FEngine::DriverApi& driver = engine.getDriverApi();
 
+    if (UTILS_UNLIKELY(!mBoneAttachments.empty())) {
+        detachBone(manager.getEntity(ci));
+    }
+    if (UTILS_UNLIKELY(!mPosedBounds.empty())) {
+        releasePosedBounds(manager.getEntity(ci));
+    }
+
     // See create(RenderableManager::Builder&, Entity)
     destroyComponentPrimitives(engine, manager[ci].primitives);
 
     // destroy the bones structures if any
     Bones const& bones = manager[ci].bones;
+    releaseBonePalette(bones.palette);
     if (bones.handle && !bones.skinningBufferMode) {
         driver.destroyBufferObject(bones.handle);
     }
@@ -439,6 +508,11 @@ void FRenderableManager::destroyComponent(Instance ci) noexcept {
     if (morphWeights.handle) {
         driver.destroyBufferObject(morphWeights.handle);
     }
+    delete[] morphWeights.shadow;
+
+    // destroy the LOD table if any
+    LodTable* const lod = manager[ci].lod;
+    delete lod;
 }
 
 void FRenderableManager::destroyComponentPrimitives(
@@ -449,6 +523,18 @@ void FRenderableManager::destroyComponentPrimitives(
     delete[] primitives.data();
 }
 
+Slice<FRenderPrimitive> FRenderableManager::getRenderPrimitives(
+        Instance instance, uint8_t level) const noexcept {
+    Slice<FRenderPrimitive> primitives = mManager[instance].primitives;
+    LodTable const* const lod = mManager[instance].lod;
+    if (UTILS_UNLIKELY(lod)) {
+        auto const& range = lod->levels[level < lod->levelCount ? level : lod->levelCount - 1u];
+        primitives = { primitives.data() + range.offset,
+                Slice<FRenderPrimitive>::size_type(range.count) };
+    }
+    return primitives;
+}
+
 void FRenderableManager::setMaterialInstanceAt(Instance instance, uint8_t level,
         size_t primitiveIndex, FMaterialInstance const* mi) noexcept {
     if (instance) {
@@ -522,6 +608,100 @@ void FRenderableManager::setGeometryAt(Instance instance, uint8_t level, size_t
     }
 }
 
+FRenderableManager::BonePalette* FRenderableManager::acquireBonePalette(
+        PerRenderableUibBone const* palette, size_t count) noexcept {
+    uint32_t const hash = hash::murmur3(reinterpret_cast<uint32_t const*>(palette),
+            count * sizeof(PerRenderableUibBone) / sizeof(uint32_t), 0);
+
+    auto& cache = mBonePaletteCache;
+    auto pos = cache.find(hash);
+    if (pos != cache.end()) {
+        BonePalette* const entry = pos->second;
+        if (UTILS_LIKELY(entry->count == count &&
+                !memcmp(entry->cpu.data(), palette, count * sizeof(PerRenderableUibBone)))) {
+            entry->refs++;
+            return entry;
+        }
+        // hash collision with different content; the caller falls back to its private UBO
+        return nullptr;
+    }
+
+    // first time we see this content: upload it once, into a recycled buffer if we have one
+    FEngine::DriverApi& driver = mEngine.getDriverApi();
+    Handle<HwBufferObject> handle;
+    if (!mBonePaletteFreeList.empty()) {
+        handle = mBonePaletteFreeList.back();
+        mBonePaletteFreeList.pop_back();
+    } else {
+        // sized like the private bone UBOs, see create()
+        handle = driver.createBufferObject(
+                CONFIG_MAX_BONE_COUNT * sizeof(PerRenderableUibBone),
+                BufferObjectBinding::UNIFORM,
+                backend::BufferUsage::DYNAMIC);
+    }
+
+    auto* out = driver.allocatePod<PerRenderableUibBone>(count);
+    memcpy(out, palette, count * sizeof(PerRenderableUibBone));
+    driver.updateBufferObject(handle, { out, count * sizeof(PerRenderableUibBone) }, 0);
+
+    BonePalette* const entry = new BonePalette{
+            .handle = handle,
+            .hash = hash,
+            .refs = 1,
+            .count = uint16_t(count),
+            .cpu = { palette, palette + count }};
+    cache[hash] = entry;
+    return entry;
+}
+
+void FRenderableManager::releaseBonePalette(BonePalette* palette) noexcept {
+    if (palette && --palette->refs == 0) {
+        mBonePaletteCache.erase(palette->hash);
+        if (mBonePaletteFreeList.size() < BONE_PALETTE_FREE_LIST_SIZE) {
+            mBonePaletteFreeList.push_back(palette->handle);
+        } else {
+            mEngine.getDriverApi().destroyBufferObject(palette->handle);
+        }
+        delete palette;
+    }
+}
+
+// Repoints the renderable at the shared palette matching mBonePaletteScratch, returning
+// true if the upload has been (or will be) done through the shared palette. Returns false
+// on a hash collision, after making the private UBO authoritative again.
+bool FRenderableManager::shareBonePalette(Bones& bones, size_t boneCount) noexcept {
+    BonePalette* const palette = acquireBonePalette(mBonePaletteScratch.data(), boneCount);
+    if (UTILS_LIKELY(palette)) {
+        if (palette == bones.palette) {
+            // already pointing at it, drop the reference we just acquired
+            releaseBonePalette(palette);
+        } else {
+            releaseBonePalette(bones.palette);
+            bones.palette = palette;
+        }
+        return true;
+    }
+    // couldn't be shared: the caller's full upload makes the private UBO authoritative again
+    releaseBonePalette(bones.palette);
+    bones.palette = nullptr;
+    return false;
+}
+
+// If recent full updates went to a shared palette, the private UBO content is stale; bring
+// it back up-to-date before a partial update lands on top of it.
+void FRenderableManager::restorePrivateBones(Bones& bones) noexcept {
+    BonePalette* const palette = bones.palette;
+    if (UTILS_UNLIKELY(palette)) {
+        FEngine::DriverApi& driver = mEngine.getDriverApi();
+        auto* out = driver.allocatePod<PerRenderableUibBone>(palette->count);
+        memcpy(out, palette->cpu.data(), palette->count * sizeof(PerRenderableUibBone));
+        driver.updateBufferObject(bones.handle,
+                { out, palette->count * sizeof(PerRenderableUibBone) }, 0);
+        releaseBonePalette(palette);
+        bones.palette = nullptr;
+    }
+}
+
 void FRenderableManager::setBones(Instance ci,
         Bone const* UTILS_RESTRICT transforms, size_t boneCount, size_t offset) {
     if (ci) {
@@ -533,6 +713,21 @@ void FRenderableManager::setBones(Instance ci,
         assert_invariant(bones.handle && offset + boneCount <= bones.count);
         if (bones.handle) {
             boneCount = std::min(boneCount, bones.count - offset);
+            if (UTILS_UNLIKELY(!mBoneShadows.empty())) {
+                captureBoneShadow(mManager.getEntity(ci), transforms, boneCount, offset);
+            }
+            if (offset == 0 && boneCount == bones.count) {
+                // full palette: convert once and share the upload with every renderable
+                // that set identical bones
+                auto& scratch = mBonePaletteScratch;
+                scratch.resize(boneCount);
+                FSkinningBuffer::convertBones(scratch.data(), transforms, boneCount);
+                if (shareBonePalette(bones, boneCount)) {
+                    return;
+                }
+            } else {
+                restorePrivateBones(bones);
+            }
             FSkinningBuffer::setBones(mEngine, bones.handle, transforms, boneCount, offset);
         }
     }
@@ -549,6 +744,21 @@ void FRenderableManager::setBones(Instance ci,
         assert_invariant(bones.handle && offset + boneCount <= bones.count);
         if (bones.handle) {
             boneCount = std::min(boneCount, bones.count - offset);
+            if (UTILS_UNLIKELY(!mBoneShadows.empty())) {
+                captureBoneShadow(mManager.getEntity(ci), transforms, boneCount, offset);
+            }
+            if (offset == 0 && boneCount == bones.count) {
+                // full palette: convert once and share the upload with every renderable
+                // that set identical bones
+                auto& scratch = mBonePaletteScratch;
+                scratch.resize(boneCount);
+                FSkinningBuffer::convertBones(scratch.data(), transforms, boneCount);
+                if (shareBonePalette(bones, boneCount)) {
+                    return;
+                }
+            } else {
+                restorePrivateBones(bones);
+            }
             FSkinningBuffer::setBones(mEngine, bones.handle, transforms, boneCount, offset);
         }
     }
@@ -583,16 +793,259 @@ void FRenderableManager::setSkinningBuffer(FRenderableManager::Instance ci,
     bones.handle = skinningBuffer->getHwHandle();
     bones.count = uint16_t(count);
     bones.offset = uint16_t(offset);
+    ++mVersion;
+}
+
+void FRenderableManager::setBoneAttachment(Instance ci, Entity target, size_t boneIndex) {
+    if (ci) {
+        Entity const e = mManager.getEntity(ci);
+
+        // detach first, so re-attaching to another joint or target just works
+        detachBone(e);
+
+        if (!target) {
+            ++mVersion;
+            return;
+        }
+
+        Instance const ti = mManager.getInstance(target);
+        ASSERT_PRECONDITION(ti, "Bone attachment target has no renderable component");
+
+        Bones const& bones = mManager[ti].bones;
+        ASSERT_PRECONDITION(!bones.skinningBufferMode,
+                "Bone attachments require the target to own its bone data "
+                "(skinning buffer mode is not supported)");
+        ASSERT_PRECONDITION(boneIndex < bones.count,
+                "Bone index %u out of range (target has %u bones)",
+                unsigned(boneIndex), unsigned(bones.count));
+
+        BoneShadow& shadow = mBoneShadows[target];
+        if (shadow.refs++ == 0) {
+            // joints sample as identity until the next setBones() on the target
+            shadow.transforms.resize(bones.count, mat4f{});
+        }
+        mBoneAttachments[e] = { target, uint16_t(boneIndex) };
+        ++mVersion;
+    }
+}
+
+void FRenderableManager::detachBone(Entity e) noexcept {
+    auto pos = mBoneAttachments.find(e);
+    if (pos != mBoneAttachments.end()) {
+        auto shadow = mBoneShadows.find(pos->second.target);
+        if (shadow != mBoneShadows.end() && --shadow.value().refs == 0) {
+            mBoneShadows.erase(shadow);
+        }
+        mBoneAttachments.erase(pos);
+    }
+}
+
+void FRenderableManager::captureBoneShadow(Entity e, Bone const* transforms,
+        size_t boneCount, size_t offset) noexcept {
+    auto pos = mBoneShadows.find(e);
+    if (UTILS_LIKELY(pos == mBoneShadows.end())) {
+        return;
+    }
+    auto& shadow = pos.value().transforms;
+    boneCount = std::min(boneCount, shadow.size() - std::min(offset, shadow.size()));
+    for (size_t i = 0; i < boneCount; i++) {
+        mat4f transform(transforms[i].unitQuaternion);
+        transform[3] = float4{ transforms[i].translation, 1.0f };
+        shadow[offset + i] = transform;
+    }
+    ++mBoneAttachmentVersion;
+    markPosedBoundsDirty(e);
+}
+
+void FRenderableManager::captureBoneShadow(Entity e, mat4f const* transforms,
+        size_t boneCount, size_t offset) noexcept {
+    auto pos = mBoneShadows.find(e);
+    if (UTILS_LIKELY(pos == mBoneShadows.end())) {
+        return;
+    }
+    auto& shadow = pos.value().transforms;
+    boneCount = std::min(boneCount, shadow.size() - std::min(offset, shadow.size()));
+    std::copy_n(transforms, boneCount, shadow.begin() + offset);
+    ++mBoneAttachmentVersion;
+    markPosedBoundsDirty(e);
+}
+
+bool FRenderableManager::getBoneAttachmentWorldTransform(Instance ci,
+        mat4 const& worldOriginTransform, mat4f& outWorldTransform) const noexcept {
+    Entity const e = mManager.getEntity(ci);
+    auto pos = mBoneAttachments.find(e);
+    if (pos == mBoneAttachments.end()) {
+        return false;
+    }
+    BoneAttachment const& attachment = pos->second;
+    FTransformManager& tcm = mEngine.getTransformManager();
+    auto const targetTi = tcm.getInstance(attachment.target);
+    auto shadow = mBoneShadows.find(attachment.target);
+    if (UTILS_UNLIKELY(!targetTi || shadow == mBoneShadows.end() ||
+            attachment.boneIndex >= shadow->second.transforms.size())) {
+        // the target is gone, fall back to the TransformManager world transform
+        return false;
+    }
+    // the bone transform is the same model-space matrix used for skinning, and our own local
+    // transform acts as an offset from the joint
+    mat4f const& localTransform = tcm.getTransform(tcm.getInstance(e));
+    outWorldTransform = mat4f{ worldOriginTransform * tcm.getWorldTransformAccurate(targetTi) }
+            * shadow->second.transforms[attachment.boneIndex] * localTransform;
+    return true;
+}
+
+void FRenderableManager::setPosedBoundsEnabled(Instance ci, bool enabled) {
+    if (ci) {
+        Entity const e = mManager.getEntity(ci);
+        auto pos = mPosedBounds.find(e);
+        if (enabled) {
+            if (pos != mPosedBounds.end()) {
+                return;
+            }
+            Bones const& bones = mManager[ci].bones;
+            ASSERT_PRECONDITION(bones.count > 0,
+                    "Posed bounds require a skinned renderable (see Builder::skinning())");
+            ASSERT_PRECONDITION(!bones.skinningBufferMode,
+                    "Posed bounds require the renderable to own its bone data "
+                    "(skinning buffer mode is not supported)");
+            BoneShadow& shadow = mBoneShadows[e];
+            if (shadow.refs++ == 0) {
+                // bones sample as identity until the next setBones()
+                shadow.transforms.resize(bones.count, mat4f{});
+            }
+            // the SoA box currently holds the application-provided rest-pose bounds
+            mPosedBounds[e] = { getAABB(ci), false };
+        } else if (pos != mPosedBounds.end()) {
+            // restore the rest-pose bounds; bumps the structure version
+            Box const restBox = pos->second.restBox;
+            releasePosedBounds(e);
+            setAxisAlignedBoundingBox(ci, restBox);
+        }
+    }
+}
+
+void FRenderableManager::releasePosedBounds(Entity e) noexcept {
+    auto pos = mPosedBounds.find(e);
+    if (pos != mPosedBounds.end()) {
+        auto shadow = mBoneShadows.find(e);
+        if (shadow != mBoneShadows.end() && --shadow.value().refs == 0) {
+            mBoneShadows.erase(shadow);
+        }
+        mPosedBounds.erase(pos);
+    }
 }
 
-static void updateMorphWeights(FEngine& engine, backend::Handle<backend::HwBufferObject> handle,
+void FRenderableManager::updatePosedBounds(JobSystem& js) noexcept {
+    struct Update {
+        Instance ci;
+        Box const* restBox;
+        std::vector<mat4f> const* palette;
+    };
+
+    // gather the dirty entries so the parallel loop below indexes a flat array
+    std::vector<Update> updates;
+    for (auto it = mPosedBounds.begin(); it != mPosedBounds.end(); ++it) {
+        if (!it.value().dirty) {
+            continue;
+        }
+        it.value().dirty = false;
+        Instance const ci = mManager.getInstance(it->first);
+        auto shadow = mBoneShadows.find(it->first);
+        if (UTILS_UNLIKELY(!ci || shadow == mBoneShadows.end())) {
+            continue;
+        }
+        updates.push_back({ ci, &it->second.restBox, &shadow->second.transforms });
+    }
+    if (updates.empty()) {
+        return;
+    }
+
+    auto& manager = mManager;
+    auto work = [&manager, &updates](uint32_t start, uint32_t count) {
+        for (uint32_t i = start; i < start + count; i++) {
+            Update const& update = updates[i];
+            Box const& restBox = *update.restBox;
+
+            // the posed bounds are the union of the rest-pose box transformed by every
+            // bone of the palette; conservative (each bone only moves its own vertices)
+            // but much tighter than a box inflated to cover every possible pose
+            Box posed{};
+            bool first = true;
+            for (mat4f const& m : *update.palette) {
+                // affine AABB transform, bones can contain non-uniform scale
+                float3 const center = (m * float4{ restBox.center, 1.0f }).xyz;
+                float3 const halfExtent =
+                        abs(m[0].xyz) * restBox.halfExtent.x +
+                        abs(m[1].xyz) * restBox.halfExtent.y +
+                        abs(m[2].xyz) * restBox.halfExtent.z;
+                Box const b{ center, halfExtent };
+                if (first) {
+                    posed = b;
+                    first = false;
+                } else {
+                    posed.unionSelf(b);
+                }
+            }
+            // distinct rows, safe to write concurrently
+            manager[update.ci].aabb = posed;
+        }
+    };
+
+    // don't bother splitting jobs for a handful of characters, the unions are cheap
+    constexpr uint32_t MIN_COUNT_FOR_JOBS = 16;
+    if (updates.size() < MIN_COUNT_FOR_JOBS) {
+        work(0, uint32_t(updates.size()));
+    } else {
+        js.runAndWait(jobs::parallel_for(js, nullptr, 0, uint32_t(updates.size()),
+                std::cref(work), jobs::CountSplitter<MIN_COUNT_FOR_JOBS, 4>()));
+    }
+    ++mPosedBoundsVersion;
+}
+
+// Uploads only the spans of weights that actually changed since the previous call. Facial rigs
+// routinely have ~100 targets with only a handful active on any given frame, so diffing against
+// the CPU shadow cuts the per-frame upload down to the few animated entries -- and to nothing at
+// all when the weights are static.
+static void updateMorphWeights(FEngine& engine,
+        backend::Handle<backend::HwBufferObject> handle, float* const shadowBase,
         float const* weights, size_t count, size_t offset) noexcept {
     auto& driver = engine.getDriverApi();
-    auto size = sizeof(float4) * count;
-    auto* UTILS_RESTRICT out = (float4*)driver.allocate(size);
-    std::transform(weights, weights + count, out,
-            [](float value) { return float4(value, 0, 0, 0); });
-    driver.updateBufferObject(handle, { out, size }, sizeof(float4) * offset);
+    float const* const UTILS_RESTRICT shadow = shadowBase + offset;
+
+    // unchanged gaps up to this size are folded into the surrounding span, trading a few
+    // redundant entries for fewer update commands
+    constexpr size_t MERGE_GAP = 4;
+
+    size_t i = 0;
+    while (i < count) {
+        // find the next changed weight (NaN in the shadow compares unequal, so entries that
+        // were never uploaded are always considered changed)
+        while (i < count && shadow[i] == weights[i]) {
+            i++;
+        }
+        if (i >= count) {
+            break;
+        }
+        size_t const first = i;
+        size_t last = i++;
+        // extend the span while changes are no further than MERGE_GAP apart
+        for (size_t gap = 0; i < count && gap < MERGE_GAP; i++) {
+            if (shadow[i] != weights[i]) {
+                last = i;
+                gap = 0;
+            } else {
+                gap++;
+            }
+        }
+        auto size = sizeof(float4) * (last - first + 1);
+        auto* UTILS_RESTRICT out = (float4*)driver.allocate(size);
+        std::transform(weights + first, weights + last + 1, out,
+                [](float value) { return float4(value, 0, 0, 0); });
+        driver.updateBufferObject(handle, { out, size },
+                sizeof(float4) * (offset + first));
+    }
+
+    memcpy(shadowBase + offset, weights, count * sizeof(float));
 }
 
 void FRenderableManager::setMorphWeights(Instance instance, float const* weights,
@@ -604,7 +1057,15 @@ void FRenderableManager::setMorphWeights(Instance instance, float const* weights
 
         MorphWeights& morphWeights = mManager[instance].morphWeights;
         if (morphWeights.handle) {
-            updateMorphWeights(mEngine, morphWeights.handle, weights, count, offset);
+            if (UTILS_UNLIKELY(!morphWeights.shadow)) {
+                // The UBO contents are undefined until the first upload; seeding the shadow
+                // with NaN makes every entry of this window compare as changed.
+                morphWeights.shadow = new float[morphWeights.count];
+                std::fill_n(morphWeights.shadow, morphWeights.count,
+                        std::numeric_limits<float>::quiet_NaN());
+            }
+            updateMorphWeights(mEngine, morphWeights.handle, morphWeights.shadow,
+                    weights, count, offset);
         }
     }
 }
@@ -701,6 +1162,10 @@ void RenderableManager::setScreenSpaceContactShadows(Instance instance, bool ena
     upcast(this)->setScreenSpaceContactShadows(instance, enable);
 }
 
+void RenderableManager::setOccluder(Instance instance, bool enable) noexcept {
+    upcast(this)->setOccluder(instance, enable);
+}
+
 bool RenderableManager::isShadowCaster(Instance instance) const noexcept {
     return upcast(this)->isShadowCaster(instance);
 }
@@ -709,6 +1174,10 @@ bool RenderableManager::isShadowReceiver(Instance instance) const noexcept {
     return upcast(this)->isShadowReceiver(instance);
 }
 
+bool RenderableManager::isOccluder(Instance instance) const noexcept {
+    return upcast(this)->isOccluder(instance);
+}
+
 const Box& RenderableManager::getAxisAlignedBoundingBox(Instance instance) const noexcept {
     return upcast(this)->getAxisAlignedBoundingBox(instance);
 }
@@ -766,6 +1235,15 @@ void RenderableManager::setSkinningBuffer(Instance instance,
     upcast(this)->setSkinningBuffer(instance, upcast(skinningBuffer), count, offset);
 }
 
+void RenderableManager::setBoneAttachment(Instance instance,
+        utils::Entity target, size_t boneIndex) {
+    upcast(this)->setBoneAttachment(instance, target, boneIndex);
+}
+
+void RenderableManager::setPosedBoundsEnabled(Instance instance, bool enabled) {
+    upcast(this)->setPosedBoundsEnabled(instance, enabled);
+}
+
 void RenderableManager::setMorphWeights(Instance instance, float const* weights,
         size_t count, size_t offset) {
     upcast(this)->setMorphWeights(instance, weights, count, offset);
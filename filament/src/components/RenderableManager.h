@@ -28,6 +28,7 @@
 #include <filament/Box.h>
 #include <filament/RenderableManager.h>
 
+#include <private/filament/EngineEnums.h>
 #include <private/filament/UibStructs.h>
 
 #include <utils/Entity.h>
@@ -35,6 +36,14 @@
 #include <utils/Slice.h>
 #include <utils/Range.h>
 
+#include <tsl/robin_map.h>
+
+#include <vector>
+
+namespace utils {
+class JobSystem;
+} // namespace utils
+
 namespace filament {
 
 class FBufferObject;
@@ -60,10 +69,24 @@ public:
         bool morphing                   : 1;
         bool screenSpaceContactShadows  : 1;
         bool reversedWindingOrder       : 1;
+        bool occluder                   : 1;
     };
 
     static_assert(sizeof(Visibility) == sizeof(uint16_t), "Visibility should be 16 bits");
 
+    // Per-renderable level-of-detail table. Each level covers a contiguous range of the
+    // renderable's primitives; level 0 is the most detailed. Only allocated for renderables
+    // that declared LODs with Builder::lod().
+    struct LodTable {
+        struct Level {
+            uint16_t offset = 0;            // first primitive of this level
+            uint16_t count = 0;             // number of primitives in this level
+            float minScreenCoverage = 0;    // below this coverage, the next level is used
+        };
+        Level levels[CONFIG_MAX_LOD_COUNT];
+        uint8_t levelCount = 0;
+    };
+
     explicit FRenderableManager(FEngine& engine) noexcept;
     ~FRenderableManager();
 
@@ -82,14 +105,68 @@ public:
         return mManager.getInstance(e);
     }
 
+    // incremented every time a component is added or removed, or when an attribute
+    // gathered by FScene::prepare() changes; used to detect when the prepared
+    // renderable data needs to be rebuilt
+    uint32_t getVersion() const noexcept {
+        return mVersion;
+    }
+
     void create(const RenderableManager::Builder& builder, utils::Entity entity);
 
     void destroy(utils::Entity e) noexcept;
 
     void gc(utils::EntityManager& em) noexcept {
-        mManager.gc(em);
+        mManager.gc(em, 4, [this](utils::Entity e) {
+            if (UTILS_UNLIKELY(!mBoneAttachments.empty())) {
+                detachBone(e);
+            }
+            if (UTILS_UNLIKELY(!mPosedBounds.empty())) {
+                releasePosedBounds(e);
+            }
+            mManager.removeComponent(e);
+            ++mVersion;
+        });
     }
 
+    // Bulk mutation of per-renderable user state. openTransaction() exposes the component
+    // columns of the SoA directly, so a sync step touching many renderables writes through
+    // spans instead of going through one instance lookup per entity; the change version is
+    // bumped once when the transaction is committed (or goes out of scope) rather than once
+    // per write. Spans are indexed by Instance - 1 and are invalidated by create(),
+    // destroy() or gc(); a transaction must be committed before the next render.
+    class Transaction {
+    public:
+        Transaction(Transaction const&) = delete;
+        Transaction& operator=(Transaction const&) = delete;
+        Transaction(Transaction&& rhs) noexcept : mOwner(rhs.mOwner) { rhs.mOwner = nullptr; }
+
+        ~Transaction() noexcept { commit(); }
+
+        void commit() noexcept {
+            if (mOwner) {
+                ++mOwner->mVersion;
+                mOwner = nullptr;
+            }
+        }
+
+        size_t size() const noexcept { return mOwner->mManager.getComponentCount(); }
+
+        utils::Slice<Box> aabbs() noexcept { return mOwner->mManager.slice<AABB>(); }
+        utils::Slice<uint8_t> layers() noexcept { return mOwner->mManager.slice<LAYERS>(); }
+        utils::Slice<uint8_t> channels() noexcept { return mOwner->mManager.slice<CHANNELS>(); }
+        utils::Slice<Visibility> visibility() noexcept {
+            return mOwner->mManager.slice<VISIBILITY>();
+        }
+
+    private:
+        friend class FRenderableManager;
+        explicit Transaction(FRenderableManager* owner) noexcept : mOwner(owner) {}
+        FRenderableManager* mOwner;
+    };
+
+    Transaction openTransaction() noexcept { return Transaction(this); }
+
     inline void setAxisAlignedBoundingBox(Instance instance, const Box& aabb) noexcept;
 
     inline void setLayerMask(Instance instance, uint8_t select, uint8_t values) noexcept;
@@ -103,6 +180,7 @@ public:
     inline void setReceiveShadows(Instance instance, bool enable) noexcept;
     inline void setScreenSpaceContactShadows(Instance instance, bool enable) noexcept;
     inline void setCulling(Instance instance, bool enable) noexcept;
+    inline void setOccluder(Instance instance, bool enable) noexcept;
     inline void setSkinning(Instance instance, bool enable) noexcept;
     inline void setMorphing(Instance instance, bool enable) noexcept;
     inline void setPrimitives(Instance instance, utils::Slice<FRenderPrimitive> const& primitives) noexcept;
@@ -110,6 +188,8 @@ public:
     inline void setBones(Instance instance, math::mat4f const* transforms, size_t boneCount, size_t offset = 0);
     inline void setSkinningBuffer(Instance instance, FSkinningBuffer* skinningBuffer,
             size_t count, size_t offset);
+    void setBoneAttachment(Instance instance, utils::Entity target, size_t boneIndex);
+    void setPosedBoundsEnabled(Instance instance, bool enabled);
     void setMorphWeights(Instance instance, float const* weights, size_t count, size_t offset);
     void setMorphTargetBufferAt(Instance instance, uint8_t level, size_t primitiveIndex,
             FMorphTargetBuffer* morphTargetBuffer, size_t offset, size_t count);
@@ -121,6 +201,7 @@ public:
     inline bool isShadowCaster(Instance instance) const noexcept;
     inline bool isShadowReceiver(Instance instance) const noexcept;
     inline bool isCullingEnabled(Instance instance) const noexcept;
+    inline bool isOccluder(Instance instance) const noexcept;
 
 
     inline Box const& getAABB(Instance instance) const noexcept;
@@ -138,6 +219,36 @@ public:
     inline SkinningBindingInfo getSkinningBufferInfo(Instance instance) const noexcept;
     inline uint32_t getBoneCount(Instance instance) const noexcept;
 
+    // true if any renderable is attached to a skeleton joint (see setBoneAttachment())
+    bool hasBoneAttachments() const noexcept { return !mBoneAttachments.empty(); }
+
+    // true if any renderable derives its bounds from its pose (see setPosedBoundsEnabled())
+    bool hasPosedBounds() const noexcept { return !mPosedBounds.empty(); }
+
+    inline bool hasPosedBounds(Instance instance) const noexcept;
+
+    // bumped every time updatePosedBounds() wrote new boxes into the SoA
+    uint32_t getPosedBoundsVersion() const noexcept { return mPosedBoundsVersion; }
+
+    // Recomputes the bounds of every renderable whose bone palette changed since the last
+    // call, in parallel on the JobSystem. Called by FScene::prepare() before the boxes are
+    // consumed; doesn't bump the structure version, the scenes refresh the affected rows
+    // through getPosedBoundsVersion() instead.
+    void updatePosedBounds(utils::JobSystem& js) noexcept;
+
+    // bumped every time the sampled joint transforms of an attachment target change
+    uint32_t getBoneAttachmentVersion() const noexcept { return mBoneAttachmentVersion; }
+
+    inline bool hasBoneAttachment(Instance instance) const noexcept;
+
+    // Computes the world transform of a renderable attached to a skeleton joint by sampling
+    // the CPU copy of the target's bone palette. Returns false -- and leaves outWorldTransform
+    // untouched -- if the instance has no attachment or the target is gone, in which case the
+    // caller falls back to the regular TransformManager world transform.
+    bool getBoneAttachmentWorldTransform(Instance instance,
+            math::mat4 const& worldOriginTransform,
+            math::mat4f& outWorldTransform) const noexcept;
+
     struct MorphingBindingInfo {
         backend::Handle<backend::HwBufferObject> handle;
         uint32_t count;
@@ -148,7 +259,26 @@ public:
         return mManager.getEntity(instance);
     }
 
-    inline size_t getLevelCount(Instance instance) const noexcept { return 1; }
+    inline size_t getLevelCount(Instance instance) const noexcept {
+        LodTable const* const lod = mManager[instance].lod;
+        return lod ? lod->levelCount : 1;
+    }
+
+    // returns the level of detail to use for the given screen coverage (fraction of the
+    // viewport height covered by the renderable's bounding sphere)
+    inline uint8_t getLodLevel(Instance instance, float screenCoverage) const noexcept {
+        LodTable const* const lod = mManager[instance].lod;
+        if (UTILS_LIKELY(!lod)) {
+            return 0;
+        }
+        uint8_t level = 0;
+        while (level < lod->levelCount - 1u &&
+                screenCoverage < lod->levels[level].minScreenCoverage) {
+            level++;
+        }
+        return level;
+    }
+
     inline size_t getPrimitiveCount(Instance instance, uint8_t level) const noexcept;
     void setMaterialInstanceAt(Instance instance, uint8_t level,
             size_t primitiveIndex, FMaterialInstance const* materialInstance) noexcept;
@@ -160,7 +290,10 @@ public:
             PrimitiveType type, size_t offset, size_t count) noexcept;
     void setBlendOrderAt(Instance instance, uint8_t level, size_t primitiveIndex, uint16_t blendOrder) noexcept;
     AttributeBitset getEnabledAttributesAt(Instance instance, uint8_t level, size_t primitiveIndex) const noexcept;
-    inline utils::Slice<FRenderPrimitive> const& getRenderPrimitives(Instance instance, uint8_t level) const noexcept;
+    // the primitives of the given level of detail (the whole array if no LODs were declared)
+    utils::Slice<FRenderPrimitive> getRenderPrimitives(Instance instance, uint8_t level) const noexcept;
+    // all the primitives, regardless of levels of detail; primitive indices passed to the
+    // mutators above are indices into this array
     inline utils::Slice<FRenderPrimitive>& getRenderPrimitives(Instance instance, uint8_t level) noexcept;
 
 private:
@@ -168,19 +301,36 @@ private:
     static void destroyComponentPrimitives(FEngine& engine,
             utils::Slice<FRenderPrimitive>& primitives) noexcept;
 
+    // A bone palette shared by every renderable that set identical bone transforms, so a
+    // crowd of identical skeletons uploads a single UBO bound by all passes and instances.
+    // Content-addressed by a hash of the converted bone data, refcounted by the instances
+    // currently pointing at it. The CPU copy is needed to restore a renderable's private
+    // UBO when a partial setBones() lands after full updates went to a shared palette.
+    struct BonePalette {
+        backend::Handle<backend::HwBufferObject> handle;
+        uint32_t hash = 0;
+        uint32_t refs = 0;
+        uint16_t count = 0;
+        std::vector<PerRenderableUibBone> cpu;
+    };
+
     struct Bones {
         backend::Handle<backend::HwBufferObject> handle;
+        BonePalette* palette = nullptr; // shared palette, takes precedence over handle
         uint16_t count = 0;
         uint16_t offset = 0;
         bool skinningBufferMode = false;
     };
-    static_assert(sizeof(Bones) == 12);
+    static_assert(sizeof(Bones) <= 24);
 
     struct MorphWeights {
         backend::Handle<backend::HwBufferObject> handle;
         uint32_t count = 0;
+        // CPU copy of the uploaded weights, lazily allocated by setMorphWeights(); it lets us
+        // upload only the weights that actually changed since the previous frame.
+        float* shadow = nullptr;
     };
-    static_assert(sizeof(MorphWeights) == 8);
+    static_assert(sizeof(MorphWeights) <= 16);
 
     enum {
         AABB,               // user data
@@ -190,6 +340,7 @@ private:
         VISIBILITY,         // user data
         PRIMITIVES,         // user data
         BONES,              // filament data, UBO storing a pointer to the bones information
+        LOD,                // user data, only allocated for renderables with LODs
     };
 
     using Base = utils::SingleInstanceComponentManager<
@@ -199,7 +350,8 @@ private:
             uint8_t,                         // CHANNELS
             Visibility,                      // VISIBILITY
             utils::Slice<FRenderPrimitive>,  // PRIMITIVES
-            Bones                            // BONES
+            Bones,                           // BONES
+            LodTable*                        // LOD
     >;
 
     struct Sim : public Base {
@@ -221,6 +373,7 @@ private:
                 Field<VISIBILITY>   visibility;
                 Field<PRIMITIVES>   primitives;
                 Field<BONES>        bones;
+                Field<LOD>          lod;
             };
         };
 
@@ -232,14 +385,76 @@ private:
         }
     };
 
+    // Returns the shared palette matching the given converted bone data, with its refcount
+    // incremented, creating and uploading it on first sight. Returns nullptr on a hash
+    // collision with different content (the caller falls back to its private UBO).
+    BonePalette* acquireBonePalette(PerRenderableUibBone const* palette, size_t count) noexcept;
+    void releaseBonePalette(BonePalette* palette) noexcept;
+    bool shareBonePalette(Bones& bones, size_t boneCount) noexcept;
+    void restorePrivateBones(Bones& bones) noexcept;
+
+    // Unreferenced palettes keep their GPU buffer here for reuse; animated palettes change
+    // content every frame and would otherwise destroy/create a buffer each time.
+    static constexpr size_t BONE_PALETTE_FREE_LIST_SIZE = 8;
+
+    // Direct bone attachments (see RenderableManager::setBoneAttachment()). Attachments are
+    // rare, so they live in side maps rather than in the component SoA, and they're keyed by
+    // entity because instances are unstable across destroy() and gc().
+    struct BoneAttachment {
+        utils::Entity target;
+        uint16_t boneIndex = 0;
+    };
+
+    // CPU copy of the model-space joint transforms of an attachment target, refreshed by
+    // setBones() and sampled by attached renderables in FScene::prepare(). Refcounted by the
+    // attachments pointing at the target.
+    struct BoneShadow {
+        std::vector<math::mat4f> transforms;
+        uint32_t refs = 0;
+    };
+
+    void detachBone(utils::Entity e) noexcept;
+    void captureBoneShadow(utils::Entity e, Bone const* transforms,
+            size_t boneCount, size_t offset) noexcept;
+    void captureBoneShadow(utils::Entity e, math::mat4f const* transforms,
+            size_t boneCount, size_t offset) noexcept;
+
+    // Pose-derived bounds (see setPosedBoundsEnabled()). The SoA box of an enabled
+    // renderable holds the posed bounds; the application-provided rest-pose box is kept
+    // here, along with a dirty bit set by setBones() through captureBoneShadow(). The bone
+    // palette itself is sampled from the same CPU shadow the attachments use.
+    struct PosedBounds {
+        Box restBox;
+        bool dirty = false;
+    };
+
+    void markPosedBoundsDirty(utils::Entity e) noexcept {
+        auto pos = mPosedBounds.find(e);
+        if (pos != mPosedBounds.end()) {
+            pos.value().dirty = true;
+        }
+    }
+
+    void releasePosedBounds(utils::Entity e) noexcept;
+
     Sim mManager;
     FEngine& mEngine;
+    uint32_t mVersion = 0;
+    tsl::robin_map<uint32_t, BonePalette*> mBonePaletteCache;
+    std::vector<backend::Handle<backend::HwBufferObject>> mBonePaletteFreeList;
+    std::vector<PerRenderableUibBone> mBonePaletteScratch;
+    tsl::robin_map<utils::Entity, BoneAttachment> mBoneAttachments;
+    tsl::robin_map<utils::Entity, BoneShadow> mBoneShadows;
+    uint32_t mBoneAttachmentVersion = 0;
+    tsl::robin_map<utils::Entity, PosedBounds> mPosedBounds;
+    uint32_t mPosedBoundsVersion = 0;
 };
 
 FILAMENT_UPCAST(RenderableManager)
 
 void FRenderableManager::setAxisAlignedBoundingBox(Instance instance, const Box& aabb) noexcept {
     if (instance) {
+        ++mVersion;
         mManager[instance].aabb = aabb;
     }
 }
@@ -247,6 +462,7 @@ void FRenderableManager::setAxisAlignedBoundingBox(Instance instance, const Box&
 void FRenderableManager::setLayerMask(Instance instance,
         uint8_t select, uint8_t values) noexcept {
     if (instance) {
+        ++mVersion;
         uint8_t& layers = mManager[instance].layers;
         layers = (layers & ~select) | (values & select);
     }
@@ -254,12 +470,14 @@ void FRenderableManager::setLayerMask(Instance instance,
 
 void FRenderableManager::setLayerMask(Instance instance, uint8_t layerMask) noexcept {
     if (instance) {
+        ++mVersion;
         mManager[instance].layers = layerMask;
     }
 }
 
 void FRenderableManager::setPriority(Instance instance, uint8_t priority) noexcept {
     if (instance) {
+        ++mVersion;
         Visibility& visibility = mManager[instance].visibility;
         visibility.priority = priority;
     }
@@ -267,6 +485,7 @@ void FRenderableManager::setPriority(Instance instance, uint8_t priority) noexce
 
 void FRenderableManager::setCastShadows(Instance instance, bool enable) noexcept {
     if (instance) {
+        ++mVersion;
         Visibility& visibility = mManager[instance].visibility;
         visibility.castShadows = enable;
     }
@@ -274,6 +493,7 @@ void FRenderableManager::setCastShadows(Instance instance, bool enable) noexcept
 
 void FRenderableManager::setReceiveShadows(Instance instance, bool enable) noexcept {
     if (instance) {
+        ++mVersion;
         Visibility& visibility = mManager[instance].visibility;
         visibility.receiveShadows = enable;
     }
@@ -281,6 +501,7 @@ void FRenderableManager::setReceiveShadows(Instance instance, bool enable) noexc
 
 void FRenderableManager::setScreenSpaceContactShadows(Instance instance, bool enable) noexcept {
     if (instance) {
+        ++mVersion;
         Visibility& visibility = mManager[instance].visibility;
         visibility.screenSpaceContactShadows = enable;
     }
@@ -288,13 +509,23 @@ void FRenderableManager::setScreenSpaceContactShadows(Instance instance, bool en
 
 void FRenderableManager::setCulling(Instance instance, bool enable) noexcept {
     if (instance) {
+        ++mVersion;
         Visibility& visibility = mManager[instance].visibility;
         visibility.culling = enable;
     }
 }
 
+void FRenderableManager::setOccluder(Instance instance, bool enable) noexcept {
+    if (instance) {
+        ++mVersion;
+        Visibility& visibility = mManager[instance].visibility;
+        visibility.occluder = enable;
+    }
+}
+
 void FRenderableManager::setSkinning(Instance instance, bool enable) noexcept {
     if (instance) {
+        ++mVersion;
         Visibility& visibility = mManager[instance].visibility;
         visibility.skinning = enable;
     }
@@ -302,6 +533,7 @@ void FRenderableManager::setSkinning(Instance instance, bool enable) noexcept {
 
 void FRenderableManager::setMorphing(Instance instance, bool enable) noexcept {
     if (instance) {
+        ++mVersion;
         Visibility& visibility = mManager[instance].visibility;
         visibility.morphing = enable;
     }
@@ -310,6 +542,7 @@ void FRenderableManager::setMorphing(Instance instance, bool enable) noexcept {
 void FRenderableManager::setPrimitives(Instance instance,
         utils::Slice<FRenderPrimitive> const& primitives) noexcept {
     if (instance) {
+        ++mVersion;
         mManager[instance].primitives = primitives;
     }
 }
@@ -331,6 +564,10 @@ bool FRenderableManager::isCullingEnabled(Instance instance) const noexcept {
     return getVisibility(instance).culling;
 }
 
+bool FRenderableManager::isOccluder(Instance instance) const noexcept {
+    return getVisibility(instance).occluder;
+}
+
 uint8_t FRenderableManager::getLayerMask(Instance instance) const noexcept {
     return mManager[instance].layers;
 }
@@ -350,6 +587,10 @@ Box const& FRenderableManager::getAABB(Instance instance) const noexcept {
 FRenderableManager::SkinningBindingInfo
 FRenderableManager::getSkinningBufferInfo(Instance instance) const noexcept {
     Bones const& bones = mManager[instance].bones;
+    if (bones.palette) {
+        // the renderable's bones live in a shared, deduplicated palette
+        return { bones.palette->handle, 0 };
+    }
     return { bones.handle, bones.offset };
 }
 
@@ -358,17 +599,20 @@ inline uint32_t FRenderableManager::getBoneCount(Instance instance) const noexce
     return bones.count;
 }
 
+bool FRenderableManager::hasBoneAttachment(Instance instance) const noexcept {
+    return mBoneAttachments.find(mManager.getEntity(instance)) != mBoneAttachments.end();
+}
+
+bool FRenderableManager::hasPosedBounds(Instance instance) const noexcept {
+    return mPosedBounds.find(mManager.getEntity(instance)) != mPosedBounds.end();
+}
+
 FRenderableManager::MorphingBindingInfo
 FRenderableManager::getMorphingBufferInfo(Instance instance) const noexcept {
     MorphWeights const& morphWeights = mManager[instance].morphWeights;
     return { morphWeights.handle, morphWeights.count };
 }
 
-utils::Slice<FRenderPrimitive> const& FRenderableManager::getRenderPrimitives(
-        Instance instance, uint8_t level) const noexcept {
-    return mManager[instance].primitives;
-}
-
 utils::Slice<FRenderPrimitive>& FRenderableManager::getRenderPrimitives(
         Instance instance, uint8_t level) noexcept {
     return mManager[instance].primitives;
@@ -19,8 +19,11 @@
 #include <math/mat4.h>
 
 #include <utils/debug.h>
+#include <utils/JobSystem.h>
 #include <filament/TransformManager.h>
 
+#include <vector>
+
 
 using namespace utils;
 using namespace filament::math;
@@ -61,6 +64,7 @@ void FTransformManager::create(Entity entity, Instance parent, const mat4f& loca
     assert_invariant(i != parent);
 
     if (i && i != parent) {
+        ++mStructureVersion;
         manager[i].parent = 0;
         manager[i].next = 0;
         manager[i].prev = 0;
@@ -83,6 +87,7 @@ void FTransformManager::create(Entity entity, Instance parent, const mat4& local
     assert_invariant(i != parent);
 
     if (i && i != parent) {
+        ++mStructureVersion;
         manager[i].parent = 0;
         manager[i].next = 0;
         manager[i].prev = 0;
@@ -147,6 +152,9 @@ void FTransformManager::destroy(Entity e) noexcept {
     Instance i = manager.getInstance(e);
     validateNode(i);
     if (i) {
+        // removing the component moves another instance into its place
+        ++mStructureVersion;
+
         // 1) remove the entry from the linked lists
         removeNode(i);
 
@@ -205,6 +213,7 @@ void FTransformManager::updateNodeTransform(Instance i) noexcept {
             manager[parent].world, manager[i].local,
             manager[parent].worldTranslationLo, manager[i].localTranslationLo,
             mAccurateTranslations);
+    manager[i].version = ++mCurrentVersion;
 
     // update our children's world transforms
     Instance child = manager[i].firstChild;
@@ -227,11 +236,20 @@ void FTransformManager::commitLocalTransformTransaction() noexcept {
 void FTransformManager::computeAllWorldTransforms() noexcept {
     auto& manager = mManager;
 
+    // large hierarchies are worth the bookkeeping overhead of the parallel path below
+    constexpr size_t PARALLEL_THRESHOLD = 4096;
+    utils::JobSystem* const js = mJobSystem;
+    if (UTILS_UNLIKELY(js && manager.getComponentCount() >= PARALLEL_THRESHOLD)) {
+        computeAllWorldTransformsParallel(*js);
+        return;
+    }
+
     // swapNode() below needs some temporary storage which we provide here
     const bool accurate = mAccurateTranslations;
     auto& soa = manager.getSoA();
     soa.ensureCapacity(soa.size() + 1);
 
+    const uint64_t version = ++mCurrentVersion;
     for (Instance i = manager.begin(), e = manager.end(); i != e; ++i) {
         // Ensure that children are always sorted after their parent.
         while (UTILS_UNLIKELY(Instance(manager[i].parent) > i)) {
@@ -244,6 +262,78 @@ void FTransformManager::computeAllWorldTransforms() noexcept {
                 manager[parent].world, manager[i].local,
                 manager[parent].worldTranslationLo, manager[i].localTranslationLo,
                 accurate);
+        manager[i].version = version;
+    }
+}
+
+void FTransformManager::computeAllWorldTransformsParallel(JobSystem& js) noexcept {
+    auto& manager = mManager;
+    const bool accurate = mAccurateTranslations;
+
+    // swapNode() below needs some temporary storage which we provide here
+    auto& soa = manager.getSoA();
+    soa.ensureCapacity(soa.size() + 1);
+
+    // Ensure that children are always sorted after their parent.
+    for (Instance i = manager.begin(), e = manager.end(); i != e; ++i) {
+        while (UTILS_UNLIKELY(Instance(manager[i].parent) > i)) {
+            swapNode(i, manager[i].parent);
+        }
+        assert_invariant(Instance(manager[i].parent) < i);
+    }
+
+    // Nodes of a given depth only depend on nodes of the previous depth, so each depth level
+    // can be processed in parallel, with a barrier between levels. Because parents are sorted
+    // before their children, a single forward pass computes all depths.
+    const uint32_t first = manager.begin();
+    const uint32_t last = manager.end();
+    std::vector<uint32_t> depths(last, 0);
+    uint32_t maxDepth = 0;
+    for (uint32_t i = first; i < last; ++i) {
+        const uint32_t parent = Instance(manager[Instance(i)].parent);
+        const uint32_t depth = parent ? depths[parent] + 1 : 0;
+        depths[i] = depth;
+        maxDepth = std::max(maxDepth, depth);
+    }
+
+    // bucket the instances by depth (counting sort)
+    std::vector<uint32_t> levelStart(maxDepth + 2, 0);
+    for (uint32_t i = first; i < last; ++i) {
+        levelStart[depths[i] + 1]++;
+    }
+    for (uint32_t d = 1; d < maxDepth + 2; ++d) {
+        levelStart[d] += levelStart[d - 1];
+    }
+    std::vector<uint32_t> order(last - first);
+    std::vector<uint32_t> levelNext(levelStart.begin(), levelStart.end() - 1);
+    for (uint32_t i = first; i < last; ++i) {
+        order[levelNext[depths[i]]++] = i;
+    }
+
+    const uint64_t version = ++mCurrentVersion;
+    auto work = [this, &manager, &order, accurate, version](uint32_t start, uint32_t count) {
+        for (uint32_t j = start; j < start + count; ++j) {
+            const Instance i(order[j]);
+            const Instance parent(manager[i].parent);
+            computeWorldTransform(manager[i].world, manager[i].worldTranslationLo,
+                    manager[parent].world, manager[i].local,
+                    manager[parent].worldTranslationLo, manager[i].localTranslationLo,
+                    accurate);
+            manager[i].version = version;
+        }
+    };
+
+    // don't bother splitting jobs for small levels, the matrix products are cheap
+    constexpr uint32_t MIN_LEVEL_SIZE_FOR_JOBS = 256;
+    for (uint32_t d = 0; d <= maxDepth; ++d) {
+        const uint32_t start = levelStart[d];
+        const uint32_t count = levelStart[d + 1] - start;
+        if (count < MIN_LEVEL_SIZE_FOR_JOBS) {
+            work(start, count);
+        } else {
+            js.runAndWait(jobs::parallel_for(js, nullptr, start, count,
+                    std::cref(work), jobs::CountSplitter<MIN_LEVEL_SIZE_FOR_JOBS, 4>()));
+        }
     }
 }
 
@@ -278,9 +368,13 @@ void FTransformManager::swapNode(Instance i, Instance j) noexcept {
 
     auto& manager = mManager;
 
+    // moving instances around invalidates previously obtained Instances
+    ++mStructureVersion;
+
     // swap the content of the nodes directly
     std::swap(manager.elementAt<LOCAL>(i), manager.elementAt<LOCAL>(j));
     std::swap(manager.elementAt<WORLD>(i), manager.elementAt<WORLD>(j));
+    std::swap(manager.elementAt<VERSION>(i), manager.elementAt<VERSION>(j));
     manager.swap(i, j); // this swaps the data relative to SingleInstanceComponentManager
 
     // now swap the linked-list references, to do that correctly we must use a temporary
@@ -376,6 +470,7 @@ void FTransformManager::transformChildren(Sim& manager, Instance i) noexcept {
                 manager[parent].world, manager[i].local,
                 manager[parent].worldTranslationLo, manager[i].localTranslationLo,
                 accurate);
+        manager[i].version = mCurrentVersion;
 
         // assume we don't have a deep hierarchy
         Instance child = manager[i].firstChild;
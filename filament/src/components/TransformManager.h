@@ -28,6 +28,10 @@
 
 #include <math/mat4.h>
 
+namespace utils {
+class JobSystem;
+} // namespace utils
+
 namespace filament {
 
 class UTILS_PRIVATE FTransformManager : public TransformManager {
@@ -40,6 +44,9 @@ public:
     // free-up all resources
     void terminate() noexcept;
 
+    // when set, world transforms of large hierarchies are recomputed in parallel
+    void setJobSystem(utils::JobSystem* js) noexcept { mJobSystem = js; }
+
 
     /*
     * Component Manager APIs
@@ -117,6 +124,23 @@ public:
         return r;
     }
 
+    // incremented every time world transforms are recomputed, used by FScene to detect
+    // which world transforms changed between two calls to prepare()
+    uint64_t getWorldTransformVersion() const noexcept {
+        return mCurrentVersion;
+    }
+
+    // version of the last update of this instance's world transform
+    uint64_t getWorldTransformVersion(Instance ci) const noexcept {
+        return mManager[ci].version;
+    }
+
+    // incremented every time instances are added, removed or moved in the array, i.e.
+    // whenever previously obtained Instances may have been invalidated
+    uint32_t getStructureVersion() const noexcept {
+        return mStructureVersion;
+    }
+
 private:
     struct Sim;
 
@@ -130,6 +154,8 @@ private:
 
     void computeAllWorldTransforms() noexcept;
 
+    void computeAllWorldTransformsParallel(utils::JobSystem& js) noexcept;
+
     void computeWorldTransform(math::mat4f& outWorld, math::float3& inoutWorldTranslationLo,
             math::mat4f const& pt, math::mat4f const& local,
             math::float3 const& ptTranslationLo, math::float3 const& localTranslationLo,
@@ -146,6 +172,7 @@ private:
         FIRST_CHILD,    // instance to our first child
         NEXT,           // instance to our next sibling
         PREV,           // instance to our previous sibling
+        VERSION,        // version of the last world transform update
     };
 
     using Base = utils::SingleInstanceComponentManager<
@@ -156,7 +183,8 @@ private:
             Instance,       // parent
             Instance,       // firstChild
             Instance,       // next
-            Instance        // prev
+            Instance,       // prev
+            uint64_t        // version
     >;
 
     struct Sim : public Base {
@@ -181,6 +209,7 @@ private:
                 Field<FIRST_CHILD>  firstChild;
                 Field<NEXT>         next;
                 Field<PREV>         prev;
+                Field<VERSION>      version;
             };
         };
 
@@ -193,6 +222,9 @@ private:
     };
 
     Sim mManager;
+    utils::JobSystem* mJobSystem = nullptr;
+    uint64_t mCurrentVersion = 0;
+    uint32_t mStructureVersion = 0;
     bool mLocalTransformTransactionOpen = false;
     bool mAccurateTranslations = false;
 };
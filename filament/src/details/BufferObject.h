@@ -42,6 +42,8 @@ public:
 
     void setBuffer(FEngine& engine, BufferDescriptor&& buffer, uint32_t byteOffset = 0);
 
+    void* setBufferStreaming(FEngine& engine, uint32_t byteCount, uint32_t byteOffset);
+
     BindingType getBindingType() const noexcept { return mBindingType; }
 
 private:
@@ -26,6 +26,12 @@
 
 #include <math/mathfwd.h>
 
+#include <utils/compiler.h>
+#include <utils/SpinLock.h>
+
+#include <memory>
+#include <vector>
+
 namespace filament {
 
 class FEngine;
@@ -46,8 +52,26 @@ public:
     uint32_t getDimension() const noexcept { return mDimension; }
 
 private:
+    struct LutCacheEntry;
+    struct ToneMapperFingerprint;
+    using LutBuffer = std::shared_ptr<void>;
+
+    void uploadLut(LutBuffer lut) const noexcept;
+
+    static LutBuffer lutCacheLookup(Builder const& builder,
+            ToneMapperFingerprint const& fingerprint) noexcept;
+    static void lutCacheInsert(Builder const& builder,
+            ToneMapperFingerprint const& fingerprint, LutBuffer const& lut) noexcept;
+    static bool isLutCompatible(LutCacheEntry const& entry, Builder const& builder,
+            ToneMapperFingerprint const& fingerprint) noexcept;
+    static utils::SpinLock sLutCacheLock;
+    static std::vector<LutCacheEntry> sLutCache;
+
+    FEngine& mEngine;
     backend::TextureHandle mLutHandle;
     uint32_t mDimension;
+    backend::PixelDataFormat mFormat{};
+    backend::PixelDataType mType{};
 };
 
 FILAMENT_UPCAST(ColorGrading)
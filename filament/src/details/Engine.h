@@ -20,8 +20,13 @@
 #include "upcast.h"
 
 #include "Allocators.h"
+#include "ParameterTrackManager.h"
+#include "StagingBufferPool.h"
+#include "TextureUploadScheduler.h"
 #include "PostProcessManager.h"
+#include "QualityGovernor.h"
 #include "ResourceList.h"
+#include "UniformBufferArena.h"
 
 #include "components/CameraManager.h"
 #include "components/LightManager.h"
@@ -72,12 +77,17 @@ using MaterialKey = uint32_t;
 #include <utils/compiler.h>
 #include <utils/Allocator.h>
 #include <utils/JobSystem.h>
+#include <utils/Condition.h>
 #include <utils/CountDownLatch.h>
+#include <utils/Mutex.h>
 
+#include <atomic>
 #include <chrono>
+#include <functional>
 #include <memory>
 #include <random>
 #include <unordered_map>
+#include <vector>
 
 namespace filament {
 
@@ -148,7 +158,7 @@ public:
 
     backend::Driver& getDriver() const noexcept { return *mDriver; }
     DriverApi& getDriverApi() noexcept { return mCommandStream; }
-    DFG* getDFG() const noexcept { return mDFG.get(); }
+    DFG* getDFG() const noexcept;
 
     // the per-frame Area is used by all Renderer, so they must run in sequence and
     // have freed all allocated memory when done. If this needs to change in the future,
@@ -160,9 +170,13 @@ public:
 
     const FMaterial* getDefaultMaterial() const noexcept { return mDefaultMaterial; }
     const FMaterial* getSkyboxMaterial() const noexcept;
-    const FIndirectLight* getDefaultIndirectLight() const noexcept { return mDefaultIbl; }
-    const FTexture* getDummyCubemap() const noexcept { return mDefaultIblTexture; }
-    const FColorGrading* getDefaultColorGrading() const noexcept { return mDefaultColorGrading; }
+
+    // material instance used by the overdraw debug visualization
+    // (d.renderer.visualize_overdraw), created on first use
+    FMaterialInstance* getDebugOverdrawMaterialInstance() noexcept;
+    const FIndirectLight* getDefaultIndirectLight() const noexcept;
+    const FTexture* getDummyCubemap() const noexcept;
+    const FColorGrading* getDefaultColorGrading() const noexcept;
 
     backend::Handle<backend::HwRenderPrimitive> getFullScreenRenderPrimitive() const noexcept {
         return mFullScreenTriangleRph;
@@ -208,6 +222,10 @@ public:
         return mHeapAllocator;
     }
 
+    UniformBufferArena& getUniformBufferArena() noexcept {
+        return mUniformBufferArena;
+    }
+
     Backend getBackend() const noexcept {
         return mBackend;
     }
@@ -223,6 +241,9 @@ public:
 
     void* streamAlloc(size_t size, size_t alignment) noexcept;
 
+    void* allocateStagingMemory(size_t size) noexcept;
+    void releaseStagingMemory(void* buffer, size_t size) noexcept;
+
     Epoch getEngineEpoch() const { return mEngineEpoch; }
     duration getEngineTime() const noexcept {
         return clock::now() - getEngineEpoch();
@@ -282,9 +303,20 @@ public:
     bool destroy(const FView* p);
 
     void destroy(utils::Entity e);
+    void destroyAsync(size_t n, const utils::Entity* entities);
 
     void flushAndWait();
 
+    SyncToken insertToken();
+
+    bool isTokenSignaled(SyncToken token) const noexcept {
+        return mLastSignaledToken.load(std::memory_order_acquire) >= token;
+    }
+
+    void waitForToken(SyncToken token);
+
+    void setProgramBinaryCacheDirectory(const char* path) noexcept;
+
     // flush the current buffer
     void flush();
 
@@ -336,6 +368,82 @@ public:
         getDriver().purge();
     }
 
+    backend::HandleAllocatorStats getHandleAllocatorStats() noexcept {
+        return getDriverApi().getHandleAllocatorStats();
+    }
+
+    Engine::MemoryStats getMemoryStats() const noexcept;
+
+    void setMemoryBudget(size_t budget, Engine::MemoryBudgetCallback callback,
+            void* user) noexcept {
+        mMemoryBudget = budget;
+        mMemoryBudgetCallback = callback;
+        mMemoryBudgetUser = user;
+        mMemoryBudgetExceeded = false;
+    }
+
+    // called once per frame from FRenderer::endFrame(), on the main thread
+    void checkMemoryBudget() noexcept;
+
+    // logs the cumulative variant-usage mask of every live material, in a format
+    // consumable by matc's --used-variants flag; triggered by the
+    // d.materials.dump_variant_usage debug property
+    void dumpMaterialVariantUsage() const noexcept;
+
+    // deferred bulk destruction, see Engine::setDestroyReclaimWatermark()
+    void setDestroyReclaimWatermark(size_t watermark) noexcept {
+        mGarbageWatermark = watermark;
+    }
+    size_t getDestroyReclaimWatermark() const noexcept { return mGarbageWatermark; }
+
+    // called once per frame from FRenderer::endFrame() after the SwapChain is committed,
+    // on the main thread; reclaims at most mGarbageWatermark objects
+    void reclaimGarbage() noexcept;
+
+    // enqueues low-priority work drained by runDeferredWork() under a per-frame CPU
+    // budget; owner is an opaque tag used by cancelDeferredWork() when the requesting
+    // object is destroyed before its work has run
+    void scheduleDeferredWork(void const* owner, std::function<void()> work) noexcept;
+    void cancelDeferredWork(void const* owner) noexcept;
+
+    // per-frame CPU budget of the deferred work queue, see Engine::setDeferredWorkBudget()
+    void setDeferredWorkBudget(uint32_t budgetMicroseconds) noexcept {
+        mDeferredWorkBudgetNs = uint64_t(budgetMicroseconds) * 1000u;
+    }
+    uint32_t getDeferredWorkBudget() const noexcept {
+        return uint32_t(mDeferredWorkBudgetNs / 1000u);
+    }
+
+    // called once per frame from FRenderer::endFrame(), on the main thread
+    void runDeferredWork() noexcept;
+
+    QualityGovernor& getQualityGovernor() noexcept { return mQualityGovernor; }
+    QualityGovernor const& getQualityGovernor() const noexcept { return mQualityGovernor; }
+
+    // engine-side material parameter animation, see Engine::addParameterTrack()
+    ParameterTrackManager::TrackId addParameterTrack(FMaterialInstance* instance,
+            const char* name, float const* times, float const* values,
+            size_t keyframeCount, size_t componentCount, bool loop) noexcept;
+    void removeParameterTrack(ParameterTrackManager::TrackId track) noexcept {
+        mParameterTrackManager.removeTrack(track);
+    }
+    void setParameterTrackTime(double time) noexcept {
+        mParameterTrackManager.setTime(time);
+    }
+
+    // budgeted texture uploads, see Engine::setTextureUploadBudget()
+    TextureUploadScheduler& getTextureUploadScheduler() noexcept {
+        return mTextureUploadScheduler;
+    }
+    TextureUploadScheduler const& getTextureUploadScheduler() const noexcept {
+        return mTextureUploadScheduler;
+    }
+
+    // recycling CPU staging memory, see Engine::createStagingPixelBuffer()
+    StagingBufferPool& getStagingBufferPool() noexcept {
+        return mStagingBufferPool;
+    }
+
     backend::Handle<backend::HwTexture> getOneTexture() const { return mDummyOneTexture; }
     backend::Handle<backend::HwTexture> getZeroTexture() const { return mDummyZeroTexture; }
     backend::Handle<backend::HwTexture> getOneTextureArray() const { return mDummyOneTextureArray; }
@@ -353,6 +461,11 @@ private:
     template<typename T, typename L>
     bool terminateAndDestroy(const T* p, ResourceList<T, L>& list);
 
+    // like terminateAndDestroy(), but when a reclaim watermark is set the object's
+    // terminate() is deferred to the per-frame garbage list (see reclaimGarbage())
+    template<typename T, typename L>
+    bool terminateAndDestroyDeferred(const T* p, ResourceList<T, L>& list);
+
     template<typename T, typename L>
     void cleanupResourceList(ResourceList<T, L>& list);
 
@@ -399,16 +512,68 @@ private:
     // FMaterialInstance are handled directly by FMaterial
     std::unordered_map<const FMaterial*, ResourceList<FMaterialInstance>> mMaterialInstances;
 
-    std::unique_ptr<DFG> mDFG;
+    mutable std::unique_ptr<DFG> mDFG;
 
     std::thread mDriverThread;
     backend::CommandBufferQueue mCommandBufferQueue;
     DriverApi mCommandStream;
     uint32_t mFlushCounter = 0;
 
+    // command stream capture, enabled with the FILAMENT_CAPTURE environment variable
+    backend::CaptureRecorder* mCaptureRecorder = nullptr;
+
     LinearAllocatorArena mPerRenderPassAllocator;
     HeapAllocatorArena mHeapAllocator;
 
+    // thermal quality governor, see Engine::setThermalGovernorEnabled()
+    QualityGovernor mQualityGovernor;
+
+    // material parameter animation tracks, see Engine::addParameterTrack()
+    ParameterTrackManager mParameterTrackManager;
+
+    // budgeted texture uploads, see Engine::setTextureUploadBudget()
+    TextureUploadScheduler mTextureUploadScheduler;
+
+    // recycling CPU staging memory, see Engine::createStagingPixelBuffer()
+    StagingBufferPool mStagingBufferPool;
+
+    // destroyed streamed resources awaiting deferred reclaim, oldest first
+    struct Garbage {
+        void* object;
+        void (*terminate)(FEngine& engine, void* object);
+    };
+    std::vector<Garbage> mGarbage;
+    size_t mGarbageWatermark = 0;   // 0 = destroy immediately (the default)
+
+    // low-priority deferrable work, run on the main thread oldest first, see runDeferredWork()
+    struct DeferredWork {
+        void const* owner;
+        std::function<void()> work;
+    };
+    std::vector<DeferredWork> mDeferredWork;
+    uint64_t mDeferredWorkBudgetNs = 1000000;   // 1 ms
+
+    // soft memory budget, see setMemoryBudget()
+    size_t mMemoryBudget = 0;
+    Engine::MemoryBudgetCallback mMemoryBudgetCallback = nullptr;
+    void* mMemoryBudgetUser = nullptr;
+    bool mMemoryBudgetExceeded = false;
+
+    // shared slabs for material-instance uniform buffers
+    UniformBufferArena mUniformBufferArena;
+
+    // recycled CPU-side blocks for large uploads (see allocateStagingMemory()). The lock is
+    // needed because release callbacks can fire from the backend's callback thread.
+    static constexpr size_t STAGING_POOL_SIZE = 4;
+    utils::Mutex mStagingPoolLock;
+    std::vector<std::pair<void*, size_t>> mStagingPool;     // (block, capacity)
+
+    // sync tokens (see insertToken()). Signaled from the driver thread.
+    utils::Mutex mTokenLock;
+    utils::Condition mTokenCondition;
+    uint64_t mLastInsertedToken = 0;
+    std::atomic<uint64_t> mLastSignaledToken = { 0 };
+
     utils::JobSystem mJobSystem;
     static uint32_t getJobSystemThreadPoolSize() noexcept;
 
@@ -418,6 +583,7 @@ private:
 
     mutable FMaterial const* mDefaultMaterial = nullptr;
     mutable FMaterial const* mSkyboxMaterial = nullptr;
+    FMaterial* mDebugOverdrawMaterial = nullptr;
 
     mutable FTexture* mDefaultIblTexture = nullptr;
     mutable FIndirectLight* mDefaultIbl = nullptr;
@@ -447,6 +613,7 @@ public:
             bool lispsm = true;
             bool visualize_cascades = false;
             bool tightly_bound_scene = true;
+            bool caching = true;
             float dzn = -1.0f;
             float dzf =  1.0f;
         } shadowmap;
@@ -457,6 +624,12 @@ public:
             int kernelSize = 23;
             float stddev = 8.0f;
         } ssao;
+        struct {
+            // TAA history health counters, updated in PostProcessManager::taa(). The
+            // rejection rate is history_rejections / frames.
+            int frames = 0;
+            int history_rejections = 0;
+        } taa;
         struct {
             bool camera_at_origin = true;
             struct {
@@ -469,7 +642,21 @@ public:
             // When set to true, the backend will attempt to capture the next frame and write the
             // capture to file. At the moment, only supported by the Metal backend.
             bool doFrameCapture = false;
+            // When set to true, the color pass draws every surface with an additive debug
+            // material instead of its own, turning the framebuffer into an overdraw heatmap
+            // (brightness = number of shaded layers / 16).
+            bool visualize_overdraw = false;
+            // When set to true, an estimated per-material shaded-pixel count for the next
+            // frame is written to the log, most expensive first (and the flag is cleared).
+            bool dump_pixel_cost = false;
         } renderer;
+        struct {
+            // When set to true, the variant-usage mask accumulated by each live material
+            // since its creation is written to the log at the end of the frame (and the
+            // flag is cleared). The output is consumed by matc's --used-variants flag to
+            // strip never-used variants from material packages.
+            bool dump_variant_usage = false;
+        } materials;
         matdbg::DebugServer* server = nullptr;
     } debug;
 };
@@ -27,6 +27,8 @@
 #include <utils/Condition.h>
 #include <utils/Mutex.h>
 
+#include <atomic>
+
 namespace filament {
 
 class FEngine;
@@ -59,14 +61,15 @@ private:
         // we store mType here instead of in FFence, because it allows sizeof(FFence) to be
         // much smaller (since it needs to be multiple of 8 on 64 bits architectures)
         const Type mType;
-        State mState = UNSIGNALED;
+        // atomic so that wait() can check it without taking sLock once it has been signaled
+        std::atomic<State> mState = { UNSIGNALED };
         void signal(State s = SIGNALED) noexcept;
         FenceStatus wait(uint64_t timeout) noexcept;
     };
 
     FEngine& mEngine;
     backend::Handle<backend::HwFence> mFenceHandle;
-    // TODO: use custom allocator for these small objects
+    // allocated from a recycling pool, see Fence.cpp
     std::shared_ptr<FenceSignal> mFenceSignal;
 };
 
@@ -28,10 +28,14 @@
 #include <private/filament/SubpassInfo.h>
 #include <private/filament/Variant.h>
 
+#include <private/backend/Program.h>
+
 #include <filaflat/ShaderBuilder.h>
 
 #include <utils/compiler.h>
+#include <utils/FixedCapacityVector.h>
 
+#include <array>
 #include <atomic>
 
 namespace filament {
@@ -78,8 +82,13 @@ public:
     FEngine& getEngine() const noexcept  { return mEngine; }
 
     backend::Handle<backend::HwProgram> getProgram(Variant variant) const noexcept {
+        mUsedVariants.set(variant.key);
 #if FILAMENT_ENABLE_MATDBG
         mActivePrograms.set(variant.key);
+        if (UTILS_LIKELY(mDebugServer)) {
+            // feeds the server's production capture ring (see GET /api/capture)
+            mDebugServer->captureSwitch(mDebuggerId, variant.key);
+        }
         if (UTILS_UNLIKELY(mPendingEdits.load())) {
             const_cast<FMaterial*>(this)->applyPendingEdits();
         }
@@ -92,8 +101,18 @@ public:
     backend::Handle<backend::HwProgram> createAndCacheProgram(backend::Program&& p,
             Variant variant) const noexcept;
 
+    // compiles the programs for the given variants ahead of time, asynchronously on the
+    // backend thread. Reserved or filtered-out variants in the list are ignored.
+    void prewarm(VariantList const& variants) const noexcept;
+    // compiles the programs of all variants usable by this material ahead of time
+    void prewarm() const noexcept;
+
     bool isVariantLit() const noexcept { return mIsVariantLit; }
 
+    // all the variants requested via getProgram() since this material was created; used by
+    // FEngine::dumpMaterialVariantUsage() to feed matc's dead-variant stripping
+    VariantList getUsedVariants() const noexcept { return mUsedVariants; }
+
     const utils::CString& getName() const noexcept { return mName; }
     backend::RasterState getRasterState() const noexcept  { return mRasterState; }
     uint32_t getId() const noexcept { return mMaterialId; }
@@ -168,9 +187,25 @@ private:
     backend::Handle<backend::HwProgram> getSurfaceProgramSlow(Variant variant) const noexcept;
     backend::Handle<backend::HwProgram> getPostProcessProgramSlow(Variant variant) const noexcept;
 
+    void precomputeSamplerGroup(uint8_t bindingPoint, SamplerInterfaceBlock const& sib) noexcept;
+    void addSamplerGroup(backend::Program& pb, uint8_t bindingPoint) const noexcept;
+
+    // Finalized sampler lists (GLSL uniform names and global binding points) for each sampler
+    // block, computed once at creation; sampler names and offsets don't depend on the variant,
+    // so building a program variant only has to copy these instead of redoing the name
+    // formatting and binding-map lookups.
+    struct SamplerGroupTable {
+        backend::ShaderStageFlags stageFlags{};
+        utils::FixedCapacityVector<backend::Program::Sampler> samplers;
+    };
+    std::array<SamplerGroupTable, BindingPoints::COUNT> mSamplerGroupTables;
+
     // try to order by frequency of use
     mutable std::array<backend::Handle<backend::HwProgram>, VARIANT_COUNT> mCachedPrograms;
 
+    // cumulative variant usage, see getUsedVariants()
+    mutable VariantList mUsedVariants;
+
 #if FILAMENT_ENABLE_MATDBG
     mutable VariantList mActivePrograms;
 #endif
@@ -211,6 +246,7 @@ private:
 
 #if FILAMENT_ENABLE_MATDBG
     matdbg::MaterialKey mDebuggerId;
+    matdbg::DebugServer* mDebugServer = nullptr;    // cached from the engine at creation
 #endif
 
     utils::CString mName;
@@ -19,6 +19,7 @@
 
 #include "upcast.h"
 #include "UniformBuffer.h"
+#include "UniformBufferArena.h"
 #include "details/Engine.h"
 
 #include "private/backend/DriverApi.h"
@@ -54,8 +55,11 @@ public:
     }
 
     void use(FEngine::DriverApi& driver) const {
-        if (mUbHandle) {
-            driver.bindUniformBuffer(BindingPoints::PER_MATERIAL_INSTANCE, mUbHandle);
+        if (mUbAllocation) {
+            // all instances share a few arena slabs, so consecutive draws with different
+            // instances of the same material only change the binding offset
+            driver.bindUniformBufferRange(BindingPoints::PER_MATERIAL_INSTANCE,
+                    mUbAllocation.handle, mUbAllocation.offset, mUniforms.getSize());
         }
         if (mSbHandle) {
             driver.bindSamplers(BindingPoints::PER_MATERIAL_INSTANCE, mSbHandle);
@@ -66,6 +70,10 @@ public:
 
     uint64_t getSortingKey() const noexcept { return mMaterialSortingKey; }
 
+    // monotonically increasing version of the rendering state above (culling, color/depth
+    // write, depth func, transparency); used to invalidate cached sort keys in RenderPass.
+    uint32_t getStateVersion() const noexcept { return mStateVersion; }
+
     UniformBuffer const& getUniformBuffer() const noexcept { return mUniforms; }
     backend::SamplerGroup const& getSamplerGroup() const noexcept { return mSamplers; }
 
@@ -112,11 +120,11 @@ public:
 
     void setTransparencyMode(TransparencyMode mode) noexcept;
 
-    void setCullingMode(CullingMode culling) noexcept { mCulling = culling; }
+    void setCullingMode(CullingMode culling) noexcept { mCulling = culling; ++mStateVersion; }
 
-    void setColorWrite(bool enable) noexcept { mColorWrite = enable; }
+    void setColorWrite(bool enable) noexcept { mColorWrite = enable; ++mStateVersion; }
 
-    void setDepthWrite(bool enable) noexcept { mDepthWrite = enable; }
+    void setDepthWrite(bool enable) noexcept { mDepthWrite = enable; ++mStateVersion; }
 
     void setDepthCulling(bool enable) noexcept;
 
@@ -130,6 +138,8 @@ public:
 private:
     friend class FMaterial;
     friend class MaterialInstance;
+    // writes evaluated parameter tracks directly into mUniforms
+    friend class ParameterTrackManager;
 
     template<size_t Size>
     void setParameterUntypedImpl(const char* name, const void* value) noexcept;
@@ -140,6 +150,24 @@ private:
     template<typename T>
     void setParameterImpl(const char* name, T const& value) noexcept;
 
+    // hot path for pre-resolved parameters: no hashing, no lookup, just a store
+    template<typename T>
+    UTILS_ALWAYS_INLINE
+    inline void setParameterImpl(ParameterHandle handle, T const& value) noexcept {
+        if (UTILS_LIKELY(handle.isValid())) {
+            mUniforms.setUniform(size_t(handle.mOffset), value);
+        }
+    }
+
+    // bulk update: one range check and one memcpy, regardless of how many parameters
+    // the block covers. The layout was validated against the material when it was parsed.
+    void setParametersImpl(ParameterHandle first, const void* data, size_t size) noexcept {
+        if (UTILS_LIKELY(first.isValid() &&
+                size_t(first.mOffset) + size <= mUniforms.getSize())) {
+            memcpy(mUniforms.invalidateUniforms(size_t(first.mOffset), size), data, size);
+        }
+    }
+
     template<typename T>
     void setParameterImpl(const char* name, const T* value, size_t count) noexcept;
 
@@ -153,7 +181,7 @@ private:
 
     // keep these grouped, they're accessed together in the render-loop
     FMaterial const* mMaterial = nullptr;
-    backend::Handle<backend::HwBufferObject> mUbHandle;
+    UniformBufferArena::Allocation mUbAllocation;
     backend::Handle<backend::HwSamplerGroup> mSbHandle;
 
     UniformBuffer mUniforms;
@@ -167,6 +195,9 @@ private:
 
     uint64_t mMaterialSortingKey = 0;
 
+    // starts at 1 so that a zero-initialized cached version is always stale
+    uint32_t mStateVersion = 1;
+
     // Scissor rectangle is specified as: Left Bottom Width Height.
     backend::Viewport mScissorRect = { 0, 0,
             (uint32_t)std::numeric_limits<int32_t>::max(),
@@ -59,12 +59,17 @@ public:
         return mSupportedColorAttachmentsCount;
     }
 
+    uint8_t getSamples() const noexcept {
+        return mSamples;
+    }
+
 private:
     friend class RenderTarget;
     static constexpr size_t ATTACHMENT_COUNT = MAX_SUPPORTED_COLOR_ATTACHMENTS_COUNT + 1u;
     Attachment mAttachments[ATTACHMENT_COUNT];
     HwHandle mHandle{};
     backend::TargetBufferFlags mAttachmentMask = {};
+    const uint8_t mSamples;
     const uint8_t mSupportedColorAttachmentsCount;
 };
 
@@ -21,7 +21,9 @@
 
 #include "Allocators.h"
 #include "FrameInfo.h"
+#include "FramePacer.h"
 #include "FrameSkipper.h"
+#include "PassTimingManager.h"
 #include "PostProcessManager.h"
 #include "RenderPass.h"
 
@@ -29,6 +31,7 @@
 
 #include "private/backend/DriverApiForward.h"
 
+#include <fg2/FrameGraph.h>
 #include <fg2/FrameGraphId.h>
 #include <fg2/FrameGraphTexture.h>
 
@@ -82,6 +85,7 @@ public:
     bool beginFrame(FSwapChain* swapChain, uint64_t vsyncSteadyClockTimeNano);
 
     void render(FView const* view);
+    void render(FView const* const* views, size_t viewCount);
 
     void readPixels(uint32_t xoffset, uint32_t yoffset, uint32_t width, uint32_t height,
             backend::PixelBufferDescriptor&& buffer);
@@ -124,10 +128,45 @@ public:
         frameRateOptions.headRoomRatio = std::max(frameRateOptions.headRoomRatio, 0.0f);
     }
 
+    void setFramePacingOptions(FramePacingOptions const& options) noexcept {
+        mFramePacingOptions = options;
+    }
+
+    uint64_t getMeasuredFrameLatencyNanos() const noexcept {
+        return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                mFramePacer.getMeasuredLatency()).count());
+    }
+
+    SkipStats getFrameSkipStats() const noexcept {
+        return mFrameSkipper.getStats();
+    }
+
     void setClearOptions(const ClearOptions& options) {
         mClearOptions = options;
     }
 
+    void setPassProfilingEnabled(bool enabled) noexcept {
+        mPassTimingManager.setEnabled(enabled);
+    }
+
+    bool isPassProfilingEnabled() const noexcept {
+        return mPassTimingManager.isEnabled();
+    }
+
+    size_t getPassTimings(PassTiming* timings, size_t count) const noexcept {
+        return mPassTimingManager.getPassTimings(timings, count);
+    }
+
+    void setFrameTimingsCallback(FrameTimingsCallback callback, void* user) noexcept {
+        mFrameTimingsCallback = callback;
+        mFrameTimingsUser = user;
+    }
+
+    void setFrameDamage(Viewport const& damage) noexcept {
+        mFrameDamage = damage;
+        mHasFrameDamage = true;
+    }
+
 private:
     friend class Renderer;
     using Command = RenderPass::Command;
@@ -208,11 +247,17 @@ private:
     // keep a reference to our engine
     FEngine& mEngine;
     FrameSkipper mFrameSkipper;
+    FramePacer mFramePacer;
     backend::Handle<backend::HwRenderTarget> mRenderTarget;
     FSwapChain* mSwapChain = nullptr;
     size_t mCommandsHighWatermark = 0;
     uint32_t mFrameId = 0;
     FrameInfoManager mFrameInfoManager;
+    PassTimingManager mPassTimingManager;
+    // whether per-pass profiling was active when the current frame began; the whole-frame
+    // timer and the per-pass timers are mutually exclusive (queries can't nest on GL), so
+    // this must not change between beginFrame() and endFrame()
+    bool mPassProfilingActive = false;
     backend::TextureFormat mHdrTranslucent{};
     backend::TextureFormat mHdrQualityMedium{};
     backend::TextureFormat mHdrQualityHigh{};
@@ -221,12 +266,26 @@ private:
     math::float4 mShaderUserTime{};
     DisplayInfo mDisplayInfo;
     FrameRateOptions mFrameRateOptions;
+    FramePacingOptions mFramePacingOptions;
     ClearOptions mClearOptions;
     backend::TargetBufferFlags mDiscardStartFlags{};
     backend::TargetBufferFlags mClearFlags{};
+    FrameGraph::CompileCache mCompileCache;
     tsl::robin_set<FRenderTarget*> mPreviousRenderTargets;
     std::function<void()> mBeginFrameInternal;
 
+    // frame-lifecycle observation (see Renderer::setFrameTimingsCallback())
+    static uint64_t steadyClockNowNanos() noexcept {
+        return uint64_t(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+    FrameTimingsCallback mFrameTimingsCallback = nullptr;
+    void* mFrameTimingsUser = nullptr;
+    FrameTimings mFrameTimings{};
+
+    // partial-present hint, forwarded to the backend at endFrame() (see setFrameDamage())
+    Viewport mFrameDamage{};
+    bool mHasFrameDamage = false;
+
     // per-frame arena for this Renderer
     LinearAllocatorArena& mPerRenderPassArena;
 };
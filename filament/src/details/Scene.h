@@ -20,6 +20,7 @@
 #include "upcast.h"
 
 #include "Allocators.h"
+#include "CasterBVH.h"
 #include "Culler.h"
 
 #include "components/LightManager.h"
@@ -31,11 +32,15 @@
 
 #include <utils/compiler.h>
 #include <utils/Entity.h>
+#include <utils/EntityManager.h>
 #include <utils/Slice.h>
 #include <utils/StructureOfArrays.h>
 #include <utils/Range.h>
 #include <utils/debug.h>
 
+#include <atomic>
+#include <vector>
+
 #include <stddef.h>
 
 #include <tsl/robin_set.h>
@@ -49,7 +54,7 @@ class FRenderer;
 class FSkybox;
 
 
-class FScene : public Scene {
+class FScene : public Scene, private utils::EntityManager::Listener {
 public:
 
     /*
@@ -63,6 +68,15 @@ public:
     void setIndirectLight(FIndirectLight const* ibl) noexcept { mIndirectLight = ibl; }
     FIndirectLight const* getIndirectLight() const noexcept { return mIndirectLight; }
 
+    void setIndirectLightBlend(FIndirectLight const* ibl, float blend) noexcept {
+        mIndirectLightBlendTarget = ibl;
+        mIndirectLightBlend = blend;
+    }
+    FIndirectLight const* getIndirectLightBlendTarget() const noexcept {
+        return mIndirectLightBlendTarget;
+    }
+    float getIndirectLightBlend() const noexcept { return mIndirectLightBlend; }
+
     void addEntity(utils::Entity entity);
     void addEntities(const utils::Entity* entities, size_t count);
     void remove(utils::Entity entity);
@@ -88,6 +102,11 @@ public:
     void terminate(FEngine& engine);
 
     void prepare(const math::mat4& worldOriginTransform, bool shadowReceiversAreCasters) noexcept;
+
+    // Combined version of everything prepare() tracks (entities, components, transforms).
+    // Two equal values guarantee the scene content didn't change in between; used by FView
+    // to skip rendering of static views entirely (see FView::isRenderStateUnchanged()).
+    uint64_t getContentVersion() const noexcept;
     void prepareDynamicLights(const CameraInfo& camera, ArenaScope& arena,
             backend::Handle<backend::HwBufferObject> lightUbh) noexcept;
 
@@ -122,6 +141,8 @@ public:
 
         // FIXME: We need a better way to handle this
         USER_DATA,              //  4 | user data currently used to store the scale
+
+        TRANSFORM_INSTANCE,     //  4 | instance of the Transform component
     };
 
     using RenderableSoa = utils::StructureOfArrays<
@@ -130,15 +151,16 @@ public:
             FRenderableManager::Visibility,             // VISIBILITY_STATE
             FRenderableManager::SkinningBindingInfo,    // SKINNING_BUFFER
             FRenderableManager::MorphingBindingInfo,    // MORPHING_BUFFER
-            math::float3,                               // WORLD_AABB_CENTER
+            utils::Aligned<math::float3, 32>,           // WORLD_AABB_CENTER
             VisibleMaskType,                            // VISIBLE_MASK
             uint8_t,                                    // CHANNELS
             uint8_t,                                    // LAYERS
-            math::float3,                               // WORLD_AABB_EXTENT
+            utils::Aligned<math::float3, 32>,           // WORLD_AABB_EXTENT
             utils::Slice<FRenderPrimitive>,             // PRIMITIVES
             uint32_t,                                   // SUMMED_PRIMITIVE_COUNT
             // FIXME: We need a better way to handle this
-            float                                       // USER_DATA
+            float,                                      // USER_DATA
+            utils::EntityInstance<TransformManager>     // TRANSFORM_INSTANCE
     >;
 
     RenderableSoa const& getRenderableData() const noexcept { return mRenderableData; }
@@ -180,7 +202,7 @@ public:
     };
 
     using LightSoa = utils::StructureOfArrays<
-            math::float4,
+            utils::Aligned<math::float4, 32>,           // POSITION_RADIUS, Culler reads 4 at a time
             math::float3,
             FLightManager::Instance,
             Culler::result_type,
@@ -195,13 +217,33 @@ public:
 
     bool hasContactShadows() const noexcept;
 
+    // Rebuilds or refits the BVH over the renderables' world-space AABBs. Cheap (an O(n)
+    // refit) when only transforms changed since the last call; must be called after
+    // prepare(). Used by ShadowMapManager to answer per-light caster queries without
+    // scanning every renderable once per shadow-casting light.
+    void updateCasterBVH() noexcept;
+    CasterBVH const& getCasterBVH() const noexcept { return mCasterBVH; }
+
 private:
     static inline void computeLightRanges(math::float2* zrange,
             CameraInfo const& camera, const math::float4* spheres, size_t count) noexcept;
 
+    // update only the rows of mRenderableData whose world transform changed since the
+    // last call to prepare()
+    void updateChangedRenderables(const math::mat4& worldOriginTransform,
+            bool shadowReceiversAreCasters) noexcept;
+
+    // rebuild mLightData from the light entities gathered by the last full prepare()
+    void prepareLightData(const math::mat4& worldOriginTransform) noexcept;
+
+    // utils::EntityManager::Listener, can be called from any thread
+    void onEntitiesDestroyed(size_t n, utils::Entity const* entities) noexcept override;
+
     FEngine& mEngine;
     FSkybox* mSkybox = nullptr;
     FIndirectLight const* mIndirectLight = nullptr;
+    FIndirectLight const* mIndirectLightBlendTarget = nullptr;
+    float mIndirectLightBlend = 0.0f;
 
     /*
      * list of Entities in the scene. We use a robin_set<> so we can do efficient removes
@@ -210,6 +252,23 @@ private:
      */
     tsl::robin_set<utils::Entity> mEntities;
 
+    /*
+     * State used by prepare() to detect that nothing -- or only some world transforms --
+     * changed since the last call, in which case mRenderableData is refreshed in place
+     * instead of being rebuilt from scratch.
+     */
+    std::atomic<uint32_t> mStructureVersion = { 1 };    // add/remove and entity destruction
+    uint32_t mRenderableOrderVersion = 0;               // bumped whenever mRenderableData is rebuilt
+    std::vector<utils::Entity> mLightEntities;          // lights seen by the last full prepare()
+    math::mat4 mPreparedWorldOriginTransform;
+    uint64_t mPreparedTransformVersion = 0;
+    uint32_t mPreparedStructureVersion = 0;
+    uint32_t mPreparedBoneAttachmentVersion = 0;
+    uint32_t mPreparedPosedBoundsVersion = 0;
+    uint32_t mPreparedRenderableVersion = 0;
+    uint32_t mPreparedLightStructureVersion = 0;
+    uint32_t mPreparedTransformStructureVersion = 0;
+    bool mPreparedShadowReceiversAreCasters = false;
 
     /*
      * The data below is valid only during a view pass. i.e. if a scene is used in multiple
@@ -219,6 +278,7 @@ private:
      */
     RenderableSoa mRenderableData;
     LightSoa mLightData;
+    CasterBVH mCasterBVH;
     backend::Handle<backend::HwBufferObject> mRenderableViewUbh; // This is actually owned by the view.
     bool mHasContactShadows = false;
 };
@@ -63,6 +63,13 @@ private:
     static void setBones(FEngine& engine, backend::Handle<backend::HwBufferObject> handle,
             math::mat4f const* transforms, size_t boneCount, size_t offset) noexcept;
 
+    // convert user-supplied bone transforms to the packed UBO representation
+    static void convertBones(PerRenderableUibBone* out,
+            RenderableManager::Bone const* transforms, size_t boneCount) noexcept;
+
+    static void convertBones(PerRenderableUibBone* out,
+            math::mat4f const* transforms, size_t boneCount) noexcept;
+
     static PerRenderableUibBone makeBone(math::mat4f transform) noexcept;
 
     backend::Handle<backend::HwBufferObject> getHwHandle() const noexcept {
@@ -70,6 +70,11 @@ public:
 
     void generateMipmaps(FEngine& engine) const noexcept;
 
+    void setMinMaxLevels(FEngine& engine, uint8_t minLevel, uint8_t maxLevel) const noexcept;
+
+    void setUploadPriority(UploadPriority priority) noexcept { mUploadPriority = priority; }
+    UploadPriority getUploadPriority() const noexcept { return mUploadPriority; }
+
     void setSampleCount(size_t sampleCount) noexcept { mSampleCount = uint8_t(sampleCount); }
     size_t getSampleCount() const noexcept { return mSampleCount; }
     bool isMultisample() const noexcept { return mSampleCount > 1; }
@@ -79,6 +84,9 @@ public:
 
     FStream const* getStream() const noexcept { return mStream; }
 
+    // estimated GPU storage in bytes, zero for external or streamed textures
+    size_t getEstimatedByteCount() const noexcept;
+
     /*
      * Utilities
      */
@@ -125,6 +133,7 @@ private:
     Sampler mTarget = Sampler::SAMPLER_2D;
     uint8_t mLevelCount = 1;
     uint8_t mSampleCount = 1;
+    UploadPriority mUploadPriority = UploadPriority::NORMAL;
     Usage mUsage = Usage::DEFAULT;
 };
 
@@ -49,6 +49,10 @@ public:
 
     size_t getVertexCount() const noexcept;
 
+    // bytes held by the internally-created buffer objects; zero when the application
+    // supplies its own BufferObjects, which are accounted separately
+    size_t getByteCount() const noexcept { return mByteCount; }
+
     AttributeBitset getDeclaredAttributes() const noexcept {
         return mDeclaredAttributes;
     }
@@ -72,6 +76,7 @@ private:
     std::array<BufferObjectHandle, backend::MAX_VERTEX_BUFFER_COUNT> mBufferObjects;
     AttributeBitset mDeclaredAttributes;
     uint32_t mVertexCount = 0;
+    uint32_t mByteCount = 0;
     uint8_t mBufferCount = 0;
     bool mBufferObjectsEnabled = false;
 };
@@ -27,6 +27,7 @@
 #include "FrameHistory.h"
 #include "FrameInfo.h"
 #include "Froxelizer.h"
+#include "OcclusionCuller.h"
 #include "PerViewUniforms.h"
 #include "PIDController.h"
 #include "ShadowMap.h"
@@ -52,6 +53,10 @@
 
 #include <math/scalar.h>
 
+#include <tsl/robin_map.h>
+
+#include <vector>
+
 namespace utils {
 class JobSystem;
 } // namespace utils;
@@ -121,12 +126,17 @@ public:
     void prepare(FEngine& engine, backend::DriverApi& driver, ArenaScope& arena,
             Viewport const& viewport, math::float4 const& userTime) noexcept;
 
+    // the world-space transform applied to the whole scene for this view (IBL rotation,
+    // camera-at-origin); this is what prepare() passes to FScene::prepare()
+    math::mat4 getWorldOriginScene(FEngine& engine) const noexcept;
+
     void setScene(FScene* scene) { mScene = scene; }
     FScene const* getScene() const noexcept { return mScene; }
     FScene* getScene() noexcept { return mScene; }
 
     void setCullingCamera(FCamera* camera) noexcept { mCullingCamera = camera; }
     void setViewingCamera(FCamera* camera) noexcept { mViewingCamera = camera; }
+    void setSharedCullingCamera(FCamera* camera) noexcept { mSharedCullingCamera = camera; }
 
     CameraInfo const& getCameraInfo() const noexcept { return mViewingCameraInfo; }
 
@@ -218,6 +228,15 @@ public:
         mRenderTarget = renderTarget;
     }
 
+    // see View::invalidate()
+    void invalidate() noexcept { mInvalidated = true; }
+
+    // Returns true when nothing tracked by this View changed since the last call that
+    // returned false (scene content version, camera and settings). The renderer uses this
+    // to skip rendering of static Views entirely -- only for Views with an associated
+    // RenderTarget, whose attachments still hold the previous, identical, result.
+    bool isRenderStateUnchanged() noexcept;
+
     FRenderTarget* getRenderTarget() const noexcept {
         return mRenderTarget;
     }
@@ -250,6 +269,25 @@ public:
         return mTemporalAntiAliasingOptions;
     }
 
+    void setAutoExposureOptions(AutoExposureOptions options) noexcept {
+        options.adaptationRate = math::clamp(options.adaptationRate, 0.0f, 1.0f);
+        mAutoExposureOptions = options;
+    }
+
+    const AutoExposureOptions& getAutoExposureOptions() const noexcept {
+        return mAutoExposureOptions;
+    }
+
+    float getAdaptedLuminance() const noexcept {
+        return mAdaptedLuminance;
+    }
+
+    // where the asynchronous auto-exposure readback stores its result,
+    // see PostProcessManager::autoExposure()
+    float* getAdaptedLuminanceSlot() noexcept {
+        return &mAdaptedLuminance;
+    }
+
     void setMultiSampleAntiAliasingOptions(MultiSampleAntiAliasingOptions options) noexcept {
         options.sampleCount = uint8_t(options.sampleCount < 1u ? 1u : options.sampleCount);
         mMultiSampleAntiAliasingOptions = options;
@@ -312,6 +350,8 @@ public:
 
     void setDynamicLightingOptions(float zLightNear, float zLightFar) noexcept;
 
+    void setFroxelQuality(QualityLevel quality) noexcept;
+
     void setPostProcessingEnabled(bool enabled) noexcept {
         mHasPostProcessPass = enabled;
     }
@@ -334,6 +374,7 @@ public:
         options.intensity = std::max(0.0f, options.intensity);
         options.bilateralThreshold = std::max(0.0f, options.bilateralThreshold);
         options.minHorizonAngleRad = math::clamp(options.minHorizonAngleRad, 0.0f, math::f::PI_2);
+        options.updateInterval = std::max(uint8_t(1), options.updateInterval);
         options.ssct.lightConeRad = math::clamp(options.ssct.lightConeRad, 0.0f, math::f::PI_2);
         options.ssct.shadowDistance = std::max(0.0f, options.ssct.shadowDistance);
         options.ssct.contactDistanceMax = std::max(0.0f, options.ssct.contactDistanceMax);
@@ -372,6 +413,15 @@ public:
         return mSoftShadowOptions;
     }
 
+    void setShadowUpdateOptions(ShadowUpdateOptions options) noexcept {
+        options.interval = std::max(uint8_t(1), options.interval);
+        mShadowUpdateOptions = options;
+    }
+
+    ShadowUpdateOptions getShadowUpdateOptions() const noexcept {
+        return mShadowUpdateOptions;
+    }
+
     AmbientOcclusionOptions const& getAmbientOcclusionOptions() const noexcept {
         return mAmbientOcclusionOptions;
     }
@@ -432,6 +482,31 @@ public:
         return mBlendMode;
     }
 
+    void setBlendedDistanceBuckets(uint16_t bucketCount) noexcept {
+        uint8_t bits = 0;
+        while ((2u << bits) <= bucketCount && bits < 10) {
+            bits++;
+        }
+        mBlendedBucketBits = bits;
+    }
+
+    uint16_t getBlendedDistanceBuckets() const noexcept {
+        return mBlendedBucketBits ? uint16_t(1u << mBlendedBucketBits) : uint16_t(0);
+    }
+
+    // number of bits of distance bucketing for blended commands, 0 = exact sort
+    uint8_t getBlendedBucketBits() const noexcept {
+        return mBlendedBucketBits;
+    }
+
+    void setDepthPrepassEnabled(bool enabled) noexcept {
+        mDepthPrepass = enabled;
+    }
+
+    bool isDepthPrepassEnabled() const noexcept {
+        return mDepthPrepass;
+    }
+
     Range const& getVisibleRenderables() const noexcept {
         return mVisibleRenderables;
     }
@@ -464,6 +539,13 @@ public:
     static void cullRenderables(utils::JobSystem& js, FScene::RenderableSoa& renderableData,
             Frustum const& frustum, size_t bit) noexcept;
 
+    // Main-camera culling with temporal coherence: when the frustum has barely moved since
+    // the last full cull, last frame's visibility is reused and only the renderables whose
+    // recorded plane-distance margin is smaller than the frustum drift (or that moved) are
+    // re-tested. Falls back to a full cull whenever the drift grows or the scene changes.
+    void cullRenderablesCoherent(utils::JobSystem& js, FScene::RenderableSoa& renderableData,
+            Frustum const& frustum) const noexcept;
+
     auto& getShadowUniforms() const { return mShadowUb; }
 
     // Returns the frame history FIFO. This is typically used by the FrameGraph to access
@@ -532,6 +614,10 @@ private:
             Culler::result_type* visibleMask,
             size_t count);
 
+    // hash of the camera and settings state that affects this View's rendered result,
+    // see isRenderStateUnchanged()
+    uint32_t computeRenderStateHash() const noexcept;
+
     void bindPerViewUniformsAndSamplers(FEngine::DriverApi& driver) const noexcept {
         mPerViewUniforms.bind(driver);
         driver.bindUniformBuffer(BindingPoints::LIGHTS, mLightUbh);
@@ -558,9 +644,16 @@ private:
     FScene* mScene = nullptr;
     FCamera* mCullingCamera = nullptr;
     FCamera* mViewingCamera = nullptr;
+    // optional camera shared by several views (e.g. stereo eyes), culled against instead of
+    // mCullingCamera, see View::setSharedCullingCamera()
+    FCamera* mSharedCullingCamera = nullptr;
 
     CameraInfo mViewingCameraInfo;
     Frustum mCullingFrustum{};
+    OcclusionCuller mOcclusionCuller;
+    // per-light count of consecutive frames its influence volume was occluded, keyed by
+    // LightManager instance; used by prepareShadowing() to fence spot shadow deactivation
+    tsl::robin_map<uint32_t, uint8_t> mOccludedSpotShadowFence;
 
     mutable Froxelizer mFroxelizer;
 
@@ -580,14 +673,19 @@ private:
     ShadowType mShadowType = ShadowType::PCF;
     VsmShadowOptions mVsmShadowOptions; // FIXME: this should probably be per-light
     SoftShadowOptions mSoftShadowOptions;
+    ShadowUpdateOptions mShadowUpdateOptions;
     BloomOptions mBloomOptions;
     FogOptions mFogOptions;
     DepthOfFieldOptions mDepthOfFieldOptions;
     VignetteOptions mVignetteOptions;
     TemporalAntiAliasingOptions mTemporalAntiAliasingOptions;
+    AutoExposureOptions mAutoExposureOptions;
+    float mAdaptedLuminance = 0.0f; // written by the auto-exposure readback callback
     MultiSampleAntiAliasingOptions mMultiSampleAntiAliasingOptions;
     ScreenSpaceReflectionsOptions mScreenSpaceReflectionsOptions;
     BlendMode mBlendMode = BlendMode::OPAQUE;
+    uint8_t mBlendedBucketBits = 0;
+    bool mDepthPrepass = false;
     const FColorGrading* mColorGrading = nullptr;
     const FColorGrading* mDefaultColorGrading = nullptr;
 
@@ -603,10 +701,28 @@ private:
 
     mutable FrameHistory mFrameHistory{};
 
+    // state of the last full main-camera cull, see cullRenderablesCoherent()
+    struct VisibilityCache {
+        Frustum frustum;                    // frustum of the last full cull
+        std::vector<float> maxDot;          // per-renderable largest signed plane distance
+        std::vector<math::float3> center;   // world AABBs at the last full cull, used to
+        std::vector<math::float3> extent;   //   re-test renderables that moved since
+        float sceneBound = 0.0f;            // bound on renderable distance to the origin
+        uint64_t sceneVersion = 0;
+        uint32_t count = 0;
+        bool valid = false;
+    };
+    mutable VisibilityCache mVisibilityCache;
+
     FPickingQuery* mActivePickingQueriesList = nullptr;
 
     utils::CString mName;
 
+    // change detection for the static-view skip, see isRenderStateUnchanged()
+    uint64_t mRenderedContentVersion = 0;
+    uint32_t mRenderedStateHash = 0;
+    bool mInvalidated = true;
+
     // the following values are set by prepare()
     Range mVisibleRenderables;
     Range mVisibleDirectionalShadowCasters;
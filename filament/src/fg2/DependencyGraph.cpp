@@ -22,7 +22,8 @@
 
 namespace filament {
 
-DependencyGraph::DependencyGraph() noexcept {
+DependencyGraph::DependencyGraph(LinearAllocatorArena& arena) noexcept
+        : mArena(arena), mNodes(arena), mEdges(arena) {
     // Some reasonable defaults size for our vectors
     mNodes.reserve(8);
     mEdges.reserve(16);
@@ -74,7 +75,7 @@ DependencyGraph::NodeContainer const& DependencyGraph::getNodes() const noexcept
 DependencyGraph::EdgeContainer DependencyGraph::getIncomingEdges(
         DependencyGraph::Node const* node) const noexcept {
     // TODO: we might need something more efficient
-    auto result = EdgeContainer::with_capacity(mEdges.size());
+    auto result = EdgeContainer::with_capacity(mEdges.size(), mEdges.get_allocator());
     NodeID const nodeId = node->getId();
     std::copy_if(mEdges.begin(), mEdges.end(),
             std::back_insert_iterator<EdgeContainer>(result),
@@ -85,7 +86,7 @@ DependencyGraph::EdgeContainer DependencyGraph::getIncomingEdges(
 DependencyGraph::EdgeContainer DependencyGraph::getOutgoingEdges(
         DependencyGraph::Node const* node) const noexcept {
     // TODO: we might need something more efficient
-    auto result = EdgeContainer::with_capacity(mEdges.size());
+    auto result = EdgeContainer::with_capacity(mEdges.size(), mEdges.get_allocator());
     NodeID const nodeId = node->getId();
     std::copy_if(mEdges.begin(), mEdges.end(),
             std::back_insert_iterator<EdgeContainer>(result),
@@ -115,7 +116,7 @@ void DependencyGraph::cull() noexcept {
     }
 
     // cull nodes with a 0 reference count
-    auto stack = NodeContainer::with_capacity(nodes.size());
+    auto stack = NodeContainer::with_capacity(nodes.size(), nodes.get_allocator());
     for (Node* const pNode : nodes) {
         if (pNode->getRefCount() == 0) {
             stack.push_back(pNode);
@@ -134,6 +135,18 @@ void DependencyGraph::cull() noexcept {
     }
 }
 
+void DependencyGraph::copyRefCounts(uint32_t* refCounts) const noexcept {
+    for (Node const* pNode : mNodes) {
+        refCounts[pNode->getId()] = pNode->mRefCount;
+    }
+}
+
+void DependencyGraph::applyRefCounts(uint32_t const* refCounts) noexcept {
+    for (Node* pNode : mNodes) {
+        pNode->mRefCount = refCounts[pNode->getId()];
+    }
+}
+
 void DependencyGraph::clear() noexcept {
     mEdges.clear();
     mNodes.clear();
@@ -194,7 +207,7 @@ void DependencyGraph::export_graphviz(utils::io::ostream& out, char const* name)
 bool DependencyGraph::isAcyclic() const noexcept {
 #ifndef NDEBUG
     // We work on a copy of the graph
-    DependencyGraph graph;
+    DependencyGraph graph(mNodes.get_allocator().getArena());
     graph.mEdges = mEdges;
     graph.mNodes = mNodes;
     return DependencyGraph::isAcyclicInternal(graph);
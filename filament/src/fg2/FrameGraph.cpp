@@ -19,11 +19,14 @@
 #include "fg2/details/ResourceNode.h"
 #include "fg2/details/DependencyGraph.h"
 
+#include "PassTimingManager.h"
+
 #include "details/Engine.h"
 
 #include <backend/DriverEnums.h>
 #include <backend/Handle.h>
 
+#include <utils/Hash.h>
 #include <utils/Panic.h>
 #include <utils/Systrace.h>
 
@@ -37,6 +40,10 @@ void FrameGraph::Builder::sideEffect() noexcept {
     mPassNode->makeTarget();
 }
 
+void FrameGraph::Builder::asyncCompute() noexcept {
+    mPassNode->makeAsync();
+}
+
 const char* FrameGraph::Builder::getName(FrameGraphHandle handle) const noexcept {
     return mFrameGraph.getResource(handle)->name;
 }
@@ -62,6 +69,7 @@ FrameGraphId<FrameGraphTexture> FrameGraph::Builder::declareRenderPass(
 FrameGraph::FrameGraph(ResourceAllocatorInterface& resourceAllocator)
         : mResourceAllocator(resourceAllocator),
           mArena("FrameGraph Arena", 131072),
+          mGraph(mArena),
           mResourceSlots(mArena),
           mResources(mArena),
           mResourceNodes(mArena),
@@ -100,14 +108,90 @@ void FrameGraph::reset() noexcept {
     mResourceSlots.clear();
 }
 
-FrameGraph& FrameGraph::compile() noexcept {
+uint64_t FrameGraph::computeStructuralHash() const noexcept {
+    // The hash covers everything the culling result and lifetime intervals depend on: the
+    // number of passes, the edge topology and which nodes are targets. Descriptors and usage
+    // flags are deliberately left out -- they are re-resolved on every compile().
+    size_t seed = 0;
+    utils::hash::combine(seed, mPassNodes.size());
+    utils::hash::combine(seed, mGraph.getNodeCount());
+    for (auto const* pPassNode : mPassNodes) {
+        // the async flag affects the pass execution order, see compile()
+        utils::hash::combine(seed, pPassNode->isAsync());
+    }
+    for (auto const* pNode : mGraph.getNodes()) {
+        utils::hash::combine(seed, pNode->isTarget());
+    }
+    for (auto const* pEdge : mGraph.getEdges()) {
+        utils::hash::combine(seed, pEdge->from);
+        utils::hash::combine(seed, pEdge->to);
+    }
+    return seed;
+}
+
+void FrameGraph::CompileCache::clear() noexcept {
+    for (auto& entry : mEntries) {
+        entry.valid = false;
+    }
+}
+
+FrameGraph::CompileCache::Entry* FrameGraph::CompileCache::find(uint64_t structuralHash) noexcept {
+    mAge++;
+    for (auto& entry : mEntries) {
+        if (entry.valid && entry.structuralHash == structuralHash) {
+            entry.age = mAge;
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+FrameGraph::CompileCache::Entry& FrameGraph::CompileCache::replace(uint64_t structuralHash) noexcept {
+    // replace the least recently used entry
+    Entry* lru = &mEntries[0];
+    for (auto& entry : mEntries) {
+        if (!entry.valid) {
+            lru = &entry;
+            break;
+        }
+        if (entry.age < lru->age) {
+            lru = &entry;
+        }
+    }
+    lru->structuralHash = structuralHash;
+    lru->age = mAge;
+    lru->valid = false; // becomes valid only once fully recorded
+    lru->refCounts.clear();
+    lru->passResourceCounts.clear();
+    lru->passResources.clear();
+    return *lru;
+}
+
+FrameGraph& FrameGraph::compile(CompileCache* cache) noexcept {
 
     SYSTRACE_CALL();
 
     DependencyGraph& dependencyGraph = mGraph;
 
-    // first we cull unreachable nodes
-    dependencyGraph.cull();
+    CompileCache::Entry* hit = nullptr;
+    uint64_t structuralHash = 0;
+    if (cache) {
+        structuralHash = computeStructuralHash();
+        hit = cache->find(structuralHash);
+        if (UTILS_UNLIKELY(hit && hit->refCounts.size() != dependencyGraph.getNodeCount())) {
+            // hash collision between graphs of different sizes -- extremely unlikely
+            hit = nullptr;
+        }
+    }
+
+    if (UTILS_LIKELY(hit)) {
+        // the graph is structurally identical to one we've compiled before; reuse its
+        // culling result instead of walking the dependency graph again
+        dependencyGraph.applyRefCounts(hit->refCounts.data());
+    } else {
+        // first we cull unreachable nodes
+        dependencyGraph.cull();
+    }
 
     /*
      * update the reference counter of the resource themselves and
@@ -119,32 +203,127 @@ FrameGraph& FrameGraph::compile() noexcept {
         return !pPassNode->isCulled();
     });
 
+    /*
+     * Scheduling: passes marked asyncCompute() have no ordering requirement other than
+     * their data dependencies, so each one is hoisted to the earliest position where it
+     * still runs after every active pass it shares a resource with. This maximizes the
+     * independent work in flight around heavy passes. Two passes are considered dependent
+     * when they touch the same concrete resource (any version, subresources collapsed to
+     * their root), which over-approximates the true read/write hazards and is therefore
+     * always safe. The hoist is deterministic for a given graph, so the compile cache
+     * stays consistent (the async flags are part of the structural hash), and resource
+     * lifetimes are computed below, after reordering.
+     */
+    {
+        auto const sharesResources = [this, &dependencyGraph](PassNode* pPassNode,
+                std::unordered_set<VirtualResource*> const& touched) {
+            for (auto const& edge : dependencyGraph.getIncomingEdges(pPassNode)) {
+                auto pNode = static_cast<ResourceNode*>(dependencyGraph.getNode(edge->from));
+                if (touched.count(getResource(pNode->resourceHandle)->getResource())) {
+                    return true;
+                }
+            }
+            for (auto const& edge : dependencyGraph.getOutgoingEdges(pPassNode)) {
+                auto pNode = static_cast<ResourceNode*>(dependencyGraph.getNode(edge->to));
+                if (touched.count(getResource(pNode->resourceHandle)->getResource())) {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        auto const begin = mPassNodes.begin();
+        for (auto it = begin; it != mActivePassNodesEnd; ++it) {
+            if (UTILS_LIKELY(!(*it)->isAsync())) {
+                continue;
+            }
+            std::unordered_set<VirtualResource*> touched;
+            for (auto const& edge : dependencyGraph.getIncomingEdges(*it)) {
+                auto pNode = static_cast<ResourceNode*>(dependencyGraph.getNode(edge->from));
+                touched.insert(getResource(pNode->resourceHandle)->getResource());
+            }
+            for (auto const& edge : dependencyGraph.getOutgoingEdges(*it)) {
+                auto pNode = static_cast<ResourceNode*>(dependencyGraph.getNode(edge->to));
+                touched.insert(getResource(pNode->resourceHandle)->getResource());
+            }
+            auto insertPos = it;
+            while (insertPos != begin && !sharesResources(*(insertPos - 1), touched)) {
+                --insertPos;
+            }
+            if (insertPos != it) {
+                std::rotate(insertPos, it, it + 1);
+            }
+        }
+    }
+
     auto first = mPassNodes.begin();
     const auto activePassNodesEnd = mActivePassNodesEnd;
-    while (first != activePassNodesEnd) {
-        PassNode* const passNode = *first;
-        first++;
-        assert_invariant(!passNode->isCulled());
-
 
-        auto const& reads = dependencyGraph.getIncomingEdges(passNode);
-        for (auto const& edge : reads) {
-            // all incoming edges should be valid by construction
-            assert_invariant(dependencyGraph.isEdgeValid(edge));
-            auto pNode = static_cast<ResourceNode*>(dependencyGraph.getNode(edge->from));
-            passNode->registerResource(pNode->resourceHandle);
+    if (UTILS_LIKELY(hit)) {
+        // replay the cached resource registrations; this reconstructs each resource's
+        // refcount and first/last users without scanning the edge list for every pass
+        FrameGraphHandle::Index const* pIndices = hit->passResources.data();
+        uint32_t const* pCounts = hit->passResourceCounts.data();
+        while (first != activePassNodesEnd) {
+            PassNode* const passNode = *first;
+            first++;
+            assert_invariant(!passNode->isCulled());
+            uint32_t const count = *pCounts++;
+            for (uint32_t i = 0; i < count; i++) {
+                passNode->registerResource(FrameGraphHandle{ *pIndices++ });
+            }
+            passNode->resolve();
         }
+    } else {
+        CompileCache::Entry* record = nullptr;
+        if (cache) {
+            record = &cache->replace(structuralHash);
+            record->refCounts.resize(dependencyGraph.getNodeCount());
+            dependencyGraph.copyRefCounts(record->refCounts.data());
+        }
+
+        while (first != activePassNodesEnd) {
+            PassNode* const passNode = *first;
+            first++;
+            assert_invariant(!passNode->isCulled());
+
+            size_t registered = 0;
+
+            auto const& reads = dependencyGraph.getIncomingEdges(passNode);
+            for (auto const& edge : reads) {
+                // all incoming edges should be valid by construction
+                assert_invariant(dependencyGraph.isEdgeValid(edge));
+                auto pNode = static_cast<ResourceNode*>(dependencyGraph.getNode(edge->from));
+                passNode->registerResource(pNode->resourceHandle);
+                if (record) {
+                    record->passResources.push_back(pNode->resourceHandle.index);
+                    registered++;
+                }
+            }
 
-        auto const& writes = dependencyGraph.getOutgoingEdges(passNode);
-        for (auto const& edge : writes) {
-            // an outgoing edge might be invalid if the node it points to has been culled
-            // but, because we are not culled and we're a pass, we add a reference to
-            // the resource we are writing to.
-            auto pNode = static_cast<ResourceNode*>(dependencyGraph.getNode(edge->to));
-            passNode->registerResource(pNode->resourceHandle);
+            auto const& writes = dependencyGraph.getOutgoingEdges(passNode);
+            for (auto const& edge : writes) {
+                // an outgoing edge might be invalid if the node it points to has been culled
+                // but, because we are not culled and we're a pass, we add a reference to
+                // the resource we are writing to.
+                auto pNode = static_cast<ResourceNode*>(dependencyGraph.getNode(edge->to));
+                passNode->registerResource(pNode->resourceHandle);
+                if (record) {
+                    record->passResources.push_back(pNode->resourceHandle.index);
+                    registered++;
+                }
+            }
+
+            if (record) {
+                record->passResourceCounts.push_back(uint32_t(registered));
+            }
+
+            passNode->resolve();
         }
 
-        passNode->resolve();
+        if (record) {
+            record->valid = true;
+        }
     }
 
     // add resource to de-virtualize or destroy to the corresponding list for each active pass
@@ -197,6 +376,11 @@ void FrameGraph::execute(backend::DriverApi& driver) noexcept {
 
         driver.pushGroupMarker(node->getName());
 
+        PassTimingManager* const profiler = mPassProfiler;
+        if (UTILS_UNLIKELY(profiler)) {
+            profiler->beginPass(driver, node->getName());
+        }
+
         // devirtualize resourcesList
         for (VirtualResource* resource : node->devirtualize) {
             assert_invariant(resource->first == node);
@@ -213,6 +397,10 @@ void FrameGraph::execute(backend::DriverApi& driver) noexcept {
             resource->destroy(resourceAllocator);
         }
 
+        if (UTILS_UNLIKELY(profiler)) {
+            profiler->endPass(driver);
+        }
+
         driver.popGroupMarker();
     }
     // this is a good place to kick the GPU, since we've just done a bunch of work
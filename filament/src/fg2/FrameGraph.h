@@ -39,6 +39,7 @@
 
 namespace filament {
 
+class PassTimingManager;
 class ResourceAllocatorInterface;
 
 class FrameGraphPassExecutor;
@@ -155,6 +156,18 @@ public:
          */
         void sideEffect() noexcept;
 
+        /**
+         * Declares that the current pass has no ordering requirement with the passes
+         * declared around it beyond its data dependencies. At compile time such a pass is
+         * hoisted to the earliest position that still runs after every pass it shares a
+         * resource with, maximizing the independent work in flight around it -- e.g. a
+         * bandwidth-light post pass scheduled alongside shadow map rasterization. On our
+         * single-queue backends the overlap comes from GPU pipelining rather than a
+         * separate compute queue, so this is a scheduling hint, never a correctness
+         * contract.
+         */
+        void asyncCompute() noexcept;
+
         /**
          * Retrieves the descriptor associated to a resource
          * @tparam RESOURCE Type of the resource
@@ -265,11 +278,52 @@ public:
     template<typename Execute>
     void addTrivialSideEffectPass(const char* name, Execute&& execute);
 
+    /**
+     * Caches the result of the dependency graph analysis performed by compile() across
+     * FrameGraph instances. When the declared passes and resources form a graph that is
+     * structurally identical to one compiled previously, compile() reuses the cached culling
+     * result and resource lifetime intervals instead of traversing the DependencyGraph again.
+     * The cache is keyed on a hash of the graph's topology only; descriptors and usage flags
+     * are re-resolved each frame, so e.g. resizing an attachment doesn't invalidate it.
+     */
+    class CompileCache {
+    public:
+        //! Invalidates all cached entries.
+        void clear() noexcept;
+
+    private:
+        friend class FrameGraph;
+        struct Entry {
+            uint64_t structuralHash = 0;
+            uint32_t age = 0;
+            bool valid = false;
+            std::vector<uint32_t> refCounts;                // per DependencyGraph node
+            std::vector<uint32_t> passResourceCounts;       // per active pass node
+            std::vector<FrameGraphHandle::Index> passResources; // flattened, registration order
+        };
+        // a few entries, so that several Views -- each with their own graph -- rendered with
+        // the same Renderer don't evict each other every frame
+        static constexpr size_t ENTRY_COUNT = 4;
+        Entry* find(uint64_t structuralHash) noexcept;
+        Entry& replace(uint64_t structuralHash) noexcept;
+        Entry mEntries[ENTRY_COUNT];
+        uint32_t mAge = 0;
+    };
+
     /**
      * Allocates concrete resources and culls unreferenced passes.
+     * @param cache optional cache allowing an unchanged graph to reuse the previous
+     *              dependency analysis (see CompileCache).
      * @return a reference to the FrameGraph, for chaining calls.
      */
-    FrameGraph& compile() noexcept;
+    FrameGraph& compile(CompileCache* cache = nullptr) noexcept;
+
+    /**
+     * Sets an optional profiler which will see a beginPass() / endPass() bracket around
+     * each pass executed, to record its GPU time (see PassTimingManager).
+     * @param profiler the profiler to notify during execute(), or nullptr to disable.
+     */
+    void setPassProfiler(PassTimingManager* profiler) noexcept { mPassProfiler = profiler; }
 
     /**
      * Execute all referenced passes
@@ -401,6 +455,8 @@ private:
 
     bool assertValid(FrameGraphHandle handle) const;
 
+    uint64_t computeStructuralHash() const noexcept;
+
     template<typename RESOURCE>
     FrameGraphId<RESOURCE> create(char const* name,
             typename RESOURCE::Descriptor const& desc) noexcept;
@@ -452,6 +508,7 @@ private:
     void destroyInternal() noexcept;
 
     Blackboard mBlackboard;
+    PassTimingManager* mPassProfiler = nullptr;
     ResourceAllocatorInterface& mResourceAllocator;
     LinearAllocatorArena mArena;
     DependencyGraph mGraph;
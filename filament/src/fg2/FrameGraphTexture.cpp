@@ -29,10 +29,12 @@ void FrameGraphTexture::create(ResourceAllocatorInterface& resourceAllocator, co
             descriptor.swizzle.g,
             descriptor.swizzle.b,
             descriptor.swizzle.a };
+    // Devirtualized textures only live for (part of) the frame; backends can use this to alias
+    // their memory with that of other transients whose lifetimes don't overlap.
     handle = resourceAllocator.createTexture(name,
             descriptor.type, descriptor.levels, descriptor.format, descriptor.samples,
             descriptor.width, descriptor.height, descriptor.depth,
-            swizzle, usage);
+            swizzle, usage | backend::TextureUsage::TRANSIENT);
 }
 
 void FrameGraphTexture::destroy(ResourceAllocatorInterface& resourceAllocator) noexcept {
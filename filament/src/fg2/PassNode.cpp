@@ -32,6 +32,7 @@ namespace filament {
 PassNode::PassNode(FrameGraph& fg) noexcept
         : DependencyGraph::Node(fg.getGraph()),
           mFrameGraph(fg),
+          mDeclaredHandles(8, fg.getArena()),
           devirtualize(fg.getArena()),
           destroy(fg.getArena()) {
 }
@@ -53,7 +54,8 @@ void PassNode::registerResource(FrameGraphHandle resourceHandle) noexcept {
 // ------------------------------------------------------------------------------------------------
 
 RenderPassNode::RenderPassNode(FrameGraph& fg, const char* name, FrameGraphPassBase* base) noexcept
-        : PassNode(fg), mName(name), mPassBase(base, fg.getArena()) {
+        : PassNode(fg), mName(name), mPassBase(base, fg.getArena()),
+          mRenderTargetData(fg.getArena()) {
 }
 RenderPassNode::RenderPassNode(RenderPassNode&& rhs) noexcept = default;
 RenderPassNode::~RenderPassNode() noexcept = default;
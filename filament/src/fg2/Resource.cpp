@@ -22,6 +22,8 @@
 #include <utils/Panic.h>
 #include <utils/CString.h>
 
+#include <type_traits>
+
 using namespace filament::backend;
 
 namespace filament {
@@ -144,6 +146,11 @@ FrameGraphTexture::Usage ImportedRenderTarget::usageFromAttachmentsFlags(
 
 // ------------------------------------------------------------------------------------------------
 
+// edges are allocated from the frame arena and reclaimed in bulk when it rewinds,
+// their destructors never run
+static_assert(std::is_trivially_destructible_v<Resource<FrameGraphTexture>::ResourceEdge>,
+        "ResourceEdge must be trivially destructible");
+
 template class Resource<FrameGraphTexture>;
 template class ImportedResource<FrameGraphTexture>;
 
@@ -25,17 +25,8 @@ ResourceNode::ResourceNode(FrameGraph& fg, FrameGraphHandle h, FrameGraphHandle
           resourceHandle(h), mFrameGraph(fg), mReaderPasses(fg.getArena()), mParentHandle(parent) {
 }
 
-ResourceNode::~ResourceNode() noexcept {
-    VirtualResource* resource = mFrameGraph.getResource(resourceHandle);
-    assert_invariant(resource);
-    resource->destroyEdge(mWriterPass);
-    for (auto* pEdge : mReaderPasses) {
-        resource->destroyEdge(pEdge);
-    }
-    delete mParentReadEdge;
-    delete mParentWriteEdge;
-    delete mForwardedEdge;
-}
+// edges are trivially destructible and live in the frame arena, nothing to do here
+ResourceNode::~ResourceNode() noexcept = default;
 
 ResourceNode* ResourceNode::getParentNode() noexcept {
     return mParentHandle.isInitialized() ?
@@ -94,20 +85,23 @@ bool ResourceNode::hasWriteFrom(PassNode const* node) const noexcept {
 
 void ResourceNode::setParentReadDependency(ResourceNode* parent) noexcept {
     if (!mParentReadEdge) {
-        mParentReadEdge = new DependencyGraph::Edge(mFrameGraph.getGraph(), parent, this);
+        mParentReadEdge = mFrameGraph.getArena().make<DependencyGraph::Edge>(
+                mFrameGraph.getGraph(), parent, this);
     }
 }
 
 
 void ResourceNode::setParentWriteDependency(ResourceNode* parent) noexcept {
     if (!mParentWriteEdge) {
-        mParentWriteEdge = new DependencyGraph::Edge(mFrameGraph.getGraph(), this, parent);
+        mParentWriteEdge = mFrameGraph.getArena().make<DependencyGraph::Edge>(
+                mFrameGraph.getGraph(), this, parent);
     }
 }
 
 void ResourceNode::setForwardResourceDependency(ResourceNode* source) noexcept {
     assert_invariant(!mForwardedEdge);
-    mForwardedEdge = new DependencyGraph::Edge(mFrameGraph.getGraph(), this, source);
+    mForwardedEdge = mFrameGraph.getArena().make<DependencyGraph::Edge>(
+            mFrameGraph.getGraph(), this, source);
 }
 
 
@@ -17,6 +17,8 @@
 #ifndef TNT_FILAMENT_FG2_DETAILS_DEPENDENCYGRAPH_H
 #define TNT_FILAMENT_FG2_DETAILS_DEPENDENCYGRAPH_H
 
+#include "fg2/details/Utilities.h"
+
 #include <utils/ostream.h>
 #include <utils/CString.h>
 #include <utils/FixedCapacityVector.h>
@@ -31,7 +33,9 @@ namespace filament {
  */
 class DependencyGraph {
 public:
-    DependencyGraph() noexcept;
+    // Node and Edge lists are allocated from the given arena (typically the frame graph's),
+    // so building the graph performs no heap allocation.
+    explicit DependencyGraph(LinearAllocatorArena& arena) noexcept;
     ~DependencyGraph() noexcept;
     DependencyGraph(const DependencyGraph&) noexcept = delete;
     DependencyGraph& operator=(const DependencyGraph&) noexcept = delete;
@@ -49,10 +53,10 @@ public:
         const NodeID to;
 
         /**
-         * Creates an Edge between two nodes. The caller keeps ownership of the Edge object,
-         * which is only safe to destroy after calling DependencyGraph::clear(). Use
-         * DependencyGraph::isEdgeValid() after culling to check that the edge is still
-         * connected on both ends.
+         * Creates an Edge between two nodes. Edges (and their subclasses) must be trivially
+         * destructible and allocated from the graph's arena (see getArena()), their memory is
+         * reclaimed in bulk when the arena rewinds. Use DependencyGraph::isEdgeValid() after
+         * culling to check that the edge is still connected on both ends.
          * @param graph reference to the DependencyGraph to add the edge to
          * @param from  Node* existing in graph (no runtime check made)
          * @param to    Node* existing in graph (no runtime check made)
@@ -127,8 +131,8 @@ public:
         const NodeID mId;           // unique id
     };
 
-    using EdgeContainer = utils::FixedCapacityVector<Edge*, std::allocator<Edge*>, false>;
-    using NodeContainer = utils::FixedCapacityVector<Node*, std::allocator<Node*>, false>;
+    using EdgeContainer = utils::FixedCapacityVector<Edge*, Allocator<Edge*>, false>;
+    using NodeContainer = utils::FixedCapacityVector<Node*, Allocator<Node*>, false>;
 
     /**
      * Removes all edges and nodes from the graph.
@@ -163,6 +167,24 @@ public:
     //! cull unreferenced nodes. Links ARE NOT removed, only reference counts are updated.
     void cull() noexcept;
 
+    //! return the number of nodes in the graph
+    size_t getNodeCount() const noexcept { return mNodes.size(); }
+
+    //! return the number of edges in the graph
+    size_t getEdgeCount() const noexcept { return mEdges.size(); }
+
+    /**
+     * Saves the reference count of each node into refCounts, which must have room for
+     * getNodeCount() entries. Only valid after cull() has been called.
+     */
+    void copyRefCounts(uint32_t* refCounts) const noexcept;
+
+    /**
+     * Restores reference counts previously saved with copyRefCounts(), as a substitute for
+     * calling cull() on a graph with identical topology.
+     */
+    void applyRefCounts(uint32_t const* refCounts) noexcept;
+
     /**
      * Return whether an edge is valid, that is if both ends are connected to nodes
      * that are not culled. Valid only after cull() is called.
@@ -175,12 +197,16 @@ public:
 
     bool isAcyclic() const noexcept;
 
+    //! return the arena nodes and edges are allocated from
+    LinearAllocatorArena& getArena() noexcept { return mArena; }
+
 private:
     // id must be the node key in the NodeContainer
     uint32_t generateNodeId() noexcept;
     void registerNode(Node* node, NodeID id) noexcept;
     void link(Edge* edge) noexcept;
     static bool isAcyclicInternal(DependencyGraph& graph) noexcept;
+    LinearAllocatorArena& mArena;
     NodeContainer mNodes;
     EdgeContainer mEdges;
 };
@@ -43,7 +43,10 @@ class PassNode : public DependencyGraph::Node {
 protected:
     friend class FrameGraphResources;
     FrameGraph& mFrameGraph;
-    std::unordered_set<FrameGraphHandle::Index> mDeclaredHandles;
+    // arena-backed so that declaring resources doesn't hit the heap
+    std::unordered_set<FrameGraphHandle::Index,
+            std::hash<FrameGraphHandle::Index>, std::equal_to<FrameGraphHandle::Index>,
+            Allocator<FrameGraphHandle::Index>> mDeclaredHandles;
 public:
     PassNode(FrameGraph& fg) noexcept;
     PassNode(PassNode&& rhs) noexcept;
@@ -54,12 +57,19 @@ public:
 
     void registerResource(FrameGraphHandle resourceHandle) noexcept;
 
+    // see FrameGraph::Builder::asyncCompute()
+    void makeAsync() noexcept { mAsync = true; }
+    bool isAsync() const noexcept { return mAsync; }
+
     virtual void execute(FrameGraphResources const& resources, backend::DriverApi& driver) noexcept = 0;
     virtual void resolve() noexcept = 0;
     utils::CString graphvizifyEdgeColor() const noexcept override;
 
     Vector<VirtualResource*> devirtualize;         // resources we need to create before executing
     Vector<VirtualResource*> destroy;              // resources we need to destroy after executing
+
+private:
+    bool mAsync = false;
 };
 
 class RenderPassNode : public PassNode {
@@ -104,7 +114,7 @@ private:
     UniquePtr<FrameGraphPassBase, LinearAllocatorArena> mPassBase;
 
     // set during setup
-    std::vector<RenderPassData> mRenderTargetData;
+    Vector<RenderPassData> mRenderTargetData;
 };
 
 class PresentPassNode : public PassNode {
@@ -89,9 +89,6 @@ public:
     /* Destroy the concrete resource */
     virtual void destroy(ResourceAllocatorInterface& resourceAllocator) noexcept = 0;
 
-    /* Destroy an Edge instantiated by this resource */
-    virtual void destroyEdge(DependencyGraph::Edge* edge) noexcept = 0;
-
     virtual utils::CString usageString() const noexcept = 0;
 
     virtual bool isImported() const noexcept { return false; }
@@ -135,7 +132,8 @@ public:
     // weather the resource was detached
     bool detached = false;
 
-    // An Edge with added data from this resource
+    // An Edge with added data from this resource. Edges are allocated from the frame
+    // arena and never individually destroyed, so they must stay trivially destructible.
     class UTILS_PUBLIC ResourceEdge : public ResourceEdgeBase {
     public:
         Usage usage;
@@ -168,7 +166,7 @@ public:
         if (edge) {
             edge->usage |= u;
         } else {
-            edge = new ResourceEdge(graph,
+            edge = graph.getArena().make<ResourceEdge>(graph,
                     toDependencyGraphNode(passNode), toDependencyGraphNode(resourceNode), u);
             setIncomingEdge(resourceNode, edge);
         }
@@ -185,7 +183,7 @@ public:
         if (edge) {
             edge->usage |= u;
         } else {
-            edge = new ResourceEdge(graph,
+            edge = graph.getArena().make<ResourceEdge>(graph,
                     toDependencyGraphNode(resourceNode), toDependencyGraphNode(passNode), u);
             addOutgoingEdge(resourceNode, edge);
         }
@@ -224,11 +222,6 @@ protected:
         }
     }
 
-    void destroyEdge(DependencyGraph::Edge* edge) noexcept override {
-        // this Edge is guaranteed to be a ResourceEdge<RESOURCE> by construction
-        delete static_cast<ResourceEdge *>(edge);
-    }
-
     void devirtualize(ResourceAllocatorInterface& resourceAllocator) noexcept override {
         if (!isSubResource()) {
             resource.create(resourceAllocator, name, descriptor, usage);
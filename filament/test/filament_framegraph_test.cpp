@@ -28,6 +28,8 @@
 
 #include "details/Texture.h"
 
+#include <vector>
+
 using namespace filament;
 using namespace backend;
 
@@ -86,7 +88,8 @@ public:
 };
 
 TEST(DependencyGraphTest, Simple) {
-    DependencyGraph graph;
+    LinearAllocatorArena arena("DependencyGraph Test Arena", 131072);
+    DependencyGraph graph(arena);
     Node* n0 = new Node(graph, "node 0");
     Node* n1 = new Node(graph, "node 1");
     Node* n2 = new Node(graph, "node 2");
@@ -118,7 +121,8 @@ TEST(DependencyGraphTest, Simple) {
 }
 
 TEST(DependencyGraphTest, Culling1) {
-    DependencyGraph graph;
+    LinearAllocatorArena arena("DependencyGraph Test Arena", 131072);
+    DependencyGraph graph(arena);
     Node* n0 = new Node(graph, "node 0");
     Node* n1 = new Node(graph, "node 1");
     Node* n2 = new Node(graph, "node 2");
@@ -155,7 +159,8 @@ TEST(DependencyGraphTest, Culling1) {
 }
 
 TEST(DependencyGraphTest, Culling2) {
-    DependencyGraph graph;
+    LinearAllocatorArena arena("DependencyGraph Test Arena", 131072);
+    DependencyGraph graph(arena);
     Node* n0 = new Node(graph, "node 0");
     Node* n1 = new Node(graph, "node 1");
     Node* n2 = new Node(graph, "node 2");
@@ -303,6 +308,177 @@ TEST_F(FrameGraphTest, ReadWrite) {
     fg.execute(driverApi);
 }
 
+TEST_F(FrameGraphTest, CompileCache) {
+    FrameGraph::CompileCache cache;
+
+    // build the same graph several times; from the second iteration on, compile() reuses the
+    // cached dependency analysis and the result must be indistinguishable
+    for (size_t i = 0; i < 3; i++) {
+        FrameGraph fg(resourceAllocator);
+
+        struct PassData {
+            FrameGraphId<FrameGraphTexture> output;
+        };
+        auto& renderPass = fg.addPass<PassData>("Render",
+                [&](FrameGraph::Builder& builder, auto& data) {
+                    data.output = builder.createTexture("Color buffer", {.width=16, .height=32});
+                    data.output = builder.write(data.output, FrameGraphTexture::Usage::COLOR_ATTACHMENT);
+                },
+                [=](FrameGraphResources const& resources, auto const& data, backend::DriverApi&) {
+                    EXPECT_EQ(resources.getUsage(data.output),
+                            FrameGraphTexture::Usage::COLOR_ATTACHMENT);
+                });
+
+        auto& culledPass = fg.addPass<PassData>("Culled",
+                [&](FrameGraph::Builder& builder, auto& data) {
+                    data.output = builder.createTexture("Unused buffer", {.width=16, .height=32});
+                    data.output = builder.write(data.output, FrameGraphTexture::Usage::COLOR_ATTACHMENT);
+                },
+                [=](FrameGraphResources const&, auto const&, backend::DriverApi&) {
+                    ADD_FAILURE() << "culled pass must not execute";
+                });
+
+        fg.present(renderPass->output);
+
+        fg.compile(&cache);
+
+        EXPECT_FALSE(fg.isCulled(renderPass));
+        EXPECT_TRUE(fg.isCulled(culledPass));
+
+        fg.execute(driverApi);
+    }
+
+    // a structurally different graph must not reuse the cached analysis
+    {
+        FrameGraph fg(resourceAllocator);
+
+        struct PassData {
+            FrameGraphId<FrameGraphTexture> output;
+        };
+        auto& pass = fg.addPass<PassData>("Render",
+                [&](FrameGraph::Builder& builder, auto& data) {
+                    data.output = builder.createTexture("Color buffer", {.width=16, .height=32});
+                    data.output = builder.write(data.output, FrameGraphTexture::Usage::COLOR_ATTACHMENT);
+                },
+                [=](FrameGraphResources const&, auto const&, backend::DriverApi&) {
+                });
+
+        fg.present(pass->output);
+
+        fg.compile(&cache);
+
+        EXPECT_FALSE(fg.isCulled(pass));
+
+        fg.execute(driverApi);
+    }
+}
+
+TEST_F(FrameGraphTest, AsyncPassHoisting) {
+    std::vector<const char*> executionOrder;
+
+    struct PassData {
+        FrameGraphId<FrameGraphTexture> output;
+    };
+
+    auto& p1 = fg.addPass<PassData>("P1",
+            [&](FrameGraph::Builder& builder, auto& data) {
+                data.output = builder.createTexture("T1", {.width=16, .height=16});
+                data.output = builder.write(data.output, FrameGraphTexture::Usage::COLOR_ATTACHMENT);
+            },
+            [&executionOrder](FrameGraphResources const&, auto const&, backend::DriverApi&) {
+                executionOrder.push_back("P1");
+            });
+
+    struct Pass2Data {
+        FrameGraphId<FrameGraphTexture> input;
+        FrameGraphId<FrameGraphTexture> output;
+    };
+    auto& p2 = fg.addPass<Pass2Data>("P2",
+            [&](FrameGraph::Builder& builder, auto& data) {
+                data.input = builder.read(p1->output, FrameGraphTexture::Usage::SAMPLEABLE);
+                data.output = builder.createTexture("T2", {.width=16, .height=16});
+                data.output = builder.write(data.output, FrameGraphTexture::Usage::COLOR_ATTACHMENT);
+            },
+            [&executionOrder](FrameGraphResources const&, auto const&, backend::DriverApi&) {
+                executionOrder.push_back("P2");
+            });
+
+    // declared last and independent of everything: must be hoisted to the front
+    auto& independent = fg.addPass<PassData>("Independent",
+            [&](FrameGraph::Builder& builder, auto& data) {
+                data.output = builder.createTexture("T3", {.width=16, .height=16});
+                data.output = builder.write(data.output, FrameGraphTexture::Usage::COLOR_ATTACHMENT);
+                builder.asyncCompute();
+            },
+            [&executionOrder](FrameGraphResources const&, auto const&, backend::DriverApi&) {
+                executionOrder.push_back("Independent");
+            });
+
+    fg.present(p2->output);
+    fg.present(independent->output);
+
+    fg.compile();
+    fg.execute(driverApi);
+
+    ASSERT_EQ(executionOrder.size(), 3u);
+    EXPECT_STREQ(executionOrder[0], "Independent");
+    EXPECT_STREQ(executionOrder[1], "P1");
+    EXPECT_STREQ(executionOrder[2], "P2");
+}
+
+TEST_F(FrameGraphTest, AsyncPassKeepsDependencies) {
+    std::vector<const char*> executionOrder;
+
+    struct PassData {
+        FrameGraphId<FrameGraphTexture> output;
+    };
+
+    auto& producer = fg.addPass<PassData>("Producer",
+            [&](FrameGraph::Builder& builder, auto& data) {
+                data.output = builder.createTexture("T1", {.width=16, .height=16});
+                data.output = builder.write(data.output, FrameGraphTexture::Usage::COLOR_ATTACHMENT);
+            },
+            [&executionOrder](FrameGraphResources const&, auto const&, backend::DriverApi&) {
+                executionOrder.push_back("Producer");
+            });
+
+    auto& unrelated = fg.addPass<PassData>("Unrelated",
+            [&](FrameGraph::Builder& builder, auto& data) {
+                data.output = builder.createTexture("T2", {.width=16, .height=16});
+                data.output = builder.write(data.output, FrameGraphTexture::Usage::COLOR_ATTACHMENT);
+            },
+            [&executionOrder](FrameGraphResources const&, auto const&, backend::DriverApi&) {
+                executionOrder.push_back("Unrelated");
+            });
+
+    // async, but reads the producer's output: may hoist past "Unrelated" only
+    struct ConsumerData {
+        FrameGraphId<FrameGraphTexture> input;
+        FrameGraphId<FrameGraphTexture> output;
+    };
+    auto& consumer = fg.addPass<ConsumerData>("Consumer",
+            [&](FrameGraph::Builder& builder, auto& data) {
+                data.input = builder.read(producer->output, FrameGraphTexture::Usage::SAMPLEABLE);
+                data.output = builder.createTexture("T3", {.width=16, .height=16});
+                data.output = builder.write(data.output, FrameGraphTexture::Usage::COLOR_ATTACHMENT);
+                builder.asyncCompute();
+            },
+            [&executionOrder](FrameGraphResources const&, auto const&, backend::DriverApi&) {
+                executionOrder.push_back("Consumer");
+            });
+
+    fg.present(unrelated->output);
+    fg.present(consumer->output);
+
+    fg.compile();
+    fg.execute(driverApi);
+
+    ASSERT_EQ(executionOrder.size(), 3u);
+    EXPECT_STREQ(executionOrder[0], "Producer");
+    EXPECT_STREQ(executionOrder[1], "Consumer");
+    EXPECT_STREQ(executionOrder[2], "Unrelated");
+}
+
 TEST_F(FrameGraphTest, Culling1) {
     struct PassData {
         FrameGraphId<FrameGraphTexture> out0;
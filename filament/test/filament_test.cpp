@@ -37,6 +37,7 @@
 #include <private/backend/BackendUtils.h>
 
 #include "Allocators.h"
+#include "Culler.h"
 #include "details/Material.h"
 #include "details/Camera.h"
 #include "Froxelizer.h"
@@ -544,6 +545,77 @@ TEST(FilamentTest, BoxCulling) {
     EXPECT_TRUE( frustum.intersects( { 0, 200 }) );
 }
 
+TEST(FilamentTest, BoxClassify) {
+    using Classification = Culler::Classification;
+    Frustum frustum(mat4f::frustum(-1, 1, -1, 1, 1, 100));
+
+    // a cube centered in 0 of size 1
+    Box box = { 0, 0.5f };
+
+    // box fully inside: no plane left to test, children skip culling entirely
+    {
+        Culler::plane_mask_type mask = Culler::ALL_PLANES;
+        box = box.translateTo({ 0, 0, -10 });
+        EXPECT_EQ(Classification::INSIDE,
+                Culler::classify(frustum, box.center, box.halfExtent, mask));
+        EXPECT_EQ(0u, mask);
+    }
+
+    // box behind the near plane
+    {
+        Culler::plane_mask_type mask = Culler::ALL_PLANES;
+        box = box.translateTo({ 0, 0, 0 });
+        EXPECT_EQ(Classification::OUTSIDE,
+                Culler::classify(frustum, box.center, box.halfExtent, mask));
+    }
+
+    // box crossing the near plane: exactly one plane remains for the children
+    {
+        Culler::plane_mask_type mask = Culler::ALL_PLANES;
+        box = box.translateTo({ 0, 0, -1 });
+        EXPECT_EQ(Classification::INTERSECTS,
+                Culler::classify(frustum, box.center, box.halfExtent, mask));
+        EXPECT_EQ(1, __builtin_popcount(mask));
+
+        // a child fully on the inner side of that plane classifies as INSIDE without
+        // ever testing the other five
+        Culler::plane_mask_type childMask = mask;
+        Box child = {{ 0, 0, -1.9f }, 0.05f };
+        EXPECT_EQ(Classification::INSIDE,
+                Culler::classify(frustum, child.center, child.halfExtent, childMask));
+        EXPECT_EQ(0u, childMask);
+
+        // a child on the outer side of it is culled
+        childMask = mask;
+        child = { { 0, 0, -0.1f }, 0.05f };
+        EXPECT_EQ(Classification::OUTSIDE,
+                Culler::classify(frustum, child.center, child.halfExtent, childMask));
+    }
+
+    // a box that entirely contains the frustum crosses all 6 planes
+    {
+        Culler::plane_mask_type mask = Culler::ALL_PLANES;
+        EXPECT_EQ(Classification::INTERSECTS,
+                Culler::classify(frustum, { 0, 0, 0 }, { 200, 200, 200 }, mask));
+        EXPECT_EQ(Culler::ALL_PLANES, mask);
+    }
+
+    // the batch variant agrees with the single-box one
+    {
+        math::float3 centers[3] = {{ 0, 0, -10 }, { 0, 0, 0 }, { 0, 0, -1 }};
+        math::float3 extents[3] = { 0.5f, 0.5f, 0.5f };
+        Culler::Classification results[3];
+        Culler::plane_mask_type childMasks[3];
+        Culler::classify(results, childMasks, frustum, centers, extents, 3,
+                Culler::ALL_PLANES);
+        EXPECT_EQ(Classification::INSIDE,     results[0]);
+        EXPECT_EQ(Classification::OUTSIDE,    results[1]);
+        EXPECT_EQ(Classification::INTERSECTS, results[2]);
+        EXPECT_EQ(0u, childMasks[0]);
+        EXPECT_EQ(1, __builtin_popcount(childMasks[2]));
+    }
+}
+
 TEST(FilamentTest, SphereCulling) {
     Frustum frustum(mat4f::frustum(-1, 1, -1, 1, 1, 100));
 
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_BATCHUTILS_STATICBATCHER_H
+#define TNT_BATCHUTILS_STATICBATCHER_H
+
+#include <utils/compiler.h>
+#include <utils/Entity.h>
+
+#include <math/vec2.h>
+#include <math/vec3.h>
+#include <math/vec4.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+namespace filament {
+
+class Engine;
+class IndexBuffer;
+class Scene;
+class VertexBuffer;
+
+namespace batchutils {
+
+/**
+ * StaticBatcher merges static renderables that share a MaterialInstance into consolidated
+ * renderables, trading draw calls and per-object transform updates for a single large
+ * primitive per material. Scenes with thousands of small static props (furniture, debris,
+ * modular architecture) typically see their draw count drop by an order of magnitude.
+ *
+ * Positions are pre-transformed into world space when the batch is built, so the merged
+ * renderable sits at the identity transform and the source entities' transforms are baked
+ * in. This only makes sense for renderables that never move; call unbatch() before moving
+ * or destroying a source entity.
+ *
+ * The source renderables are not destroyed: commit() hides them by clearing their layer
+ * mask so that unbatch() can restore the original state. Filament cannot read vertex data
+ * back from the GPU, so the caller provides the CPU-side geometry of each renderable.
+ *
+ * Usage Example:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * StaticBatcher batcher(*engine);
+ * for (auto& prop : props) {
+ *     StaticBatcher::Geometry geometry;
+ *     geometry.positions = prop.positions;
+ *     geometry.tangents = prop.tangents;
+ *     geometry.uv0 = prop.uv0;
+ *     geometry.vertexCount = prop.vertexCount;
+ *     geometry.indices = prop.indices;
+ *     geometry.indexCount = prop.indexCount;
+ *     batcher.add(prop.entity, geometry);
+ * }
+ * batcher.commit(*scene);
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class UTILS_PUBLIC StaticBatcher {
+public:
+
+    /**
+     * CPU-side source geometry of one renderable. The arrays are copied during commit(),
+     * so they only need to stay valid until then. Tangents are quaternion tangent frames
+     * as accepted by VertexAttribute::TANGENTS with AttributeType::FLOAT4.
+     */
+    struct Geometry {
+        math::float3 const* positions = nullptr;    //!< required, vertexCount entries
+        math::float4 const* tangents = nullptr;     //!< optional quaternion tangent frames
+        math::float2 const* uv0 = nullptr;          //!< optional texture coordinates
+        size_t vertexCount = 0;
+        uint32_t const* indices = nullptr;          //!< required, triangle list
+        size_t indexCount = 0;
+    };
+
+    /**
+     * Creates a StaticBatcher.
+     * @param engine filament engine used to create the merged renderables
+     */
+    explicit StaticBatcher(Engine& engine);
+
+    /**
+     * Destroys all GPU resources created by commit(). Source renderables hidden by a batch
+     * that was never unbatched stay hidden; call unbatch() first to restore them.
+     */
+    ~StaticBatcher() noexcept;
+
+    StaticBatcher(StaticBatcher const&) = delete;
+    StaticBatcher& operator=(StaticBatcher const&) = delete;
+
+    /**
+     * Registers a renderable for batching. The entity must have a renderable component;
+     * the material instance of its first primitive selects which batch it joins, and its
+     * world transform at commit() time is baked into the merged positions.
+     *
+     * Renderables with no positions or indices are ignored.
+     */
+    void add(utils::Entity renderable, Geometry const& geometry);
+
+    /**
+     * Groups the renderables registered since the last commit() by material instance and
+     * builds one merged renderable per group. Merged renderables are added to the given
+     * scene; source renderables are hidden by clearing their layer mask. Tangents and UVs
+     * are only carried over when every member of a group provides them.
+     *
+     * @return the number of merged renderables created
+     */
+    size_t commit(Scene& scene);
+
+    /**
+     * Destroys all merged renderables and their buffers, removes them from the given
+     * scene, and restores the layer mask of every source renderable hidden by commit().
+     */
+    void unbatch(Scene& scene);
+
+private:
+    struct Source {
+        utils::Entity entity;
+        Geometry geometry;
+        uint8_t layerMask;
+    };
+
+    struct Batch {
+        utils::Entity entity;
+        VertexBuffer* vertexBuffer;
+        IndexBuffer* indexBuffer;
+    };
+
+    Engine& mEngine;
+    std::vector<Source> mPending;
+    std::vector<Source> mBatched;
+    std::vector<Batch> mBatches;
+};
+
+} // namespace batchutils
+} // namespace filament
+
+#endif // TNT_BATCHUTILS_STATICBATCHER_H
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <batchutils/StaticBatcher.h>
+
+#include <filament/Box.h>
+#include <filament/Engine.h>
+#include <filament/IndexBuffer.h>
+#include <filament/MaterialInstance.h>
+#include <filament/RenderableManager.h>
+#include <filament/Scene.h>
+#include <filament/TransformManager.h>
+#include <filament/VertexBuffer.h>
+
+#include <utils/EntityManager.h>
+#include <utils/Log.h>
+
+#include <math/mat3.h>
+#include <math/mat4.h>
+#include <math/norm.h>
+#include <math/quat.h>
+
+#include <tsl/robin_map.h>
+
+#include <limits>
+
+#include <stdlib.h>
+#include <string.h>
+
+using namespace filament::math;
+using namespace utils;
+
+namespace filament {
+namespace batchutils {
+
+static void freeCallback(void* buffer, size_t, void*) {
+    free(buffer);
+}
+
+// Rotation applied to tangent frames: the normalized rotational part of the world transform.
+// Mirror handedness (negative determinant) is not supported, such props should not be batched.
+static quatf extractRotation(const mat4f& world) noexcept {
+    mat3f upper = world.upperLeft();
+    upper[0] = normalize(upper[0]);
+    upper[1] = normalize(upper[1]);
+    upper[2] = normalize(upper[2]);
+    return upper.toQuaternion();
+}
+
+StaticBatcher::StaticBatcher(Engine& engine)
+        : mEngine(engine) {
+}
+
+StaticBatcher::~StaticBatcher() noexcept {
+    for (Batch const& batch : mBatches) {
+        mEngine.destroy(batch.entity);
+        mEngine.destroy(batch.vertexBuffer);
+        mEngine.destroy(batch.indexBuffer);
+        EntityManager::get().destroy(batch.entity);
+    }
+}
+
+void StaticBatcher::add(Entity renderable, Geometry const& geometry) {
+    if (!geometry.positions || !geometry.indices ||
+            geometry.vertexCount == 0 || geometry.indexCount == 0) {
+        slog.w << "StaticBatcher: renderable with no geometry ignored" << io::endl;
+        return;
+    }
+    auto& rm = mEngine.getRenderableManager();
+    if (!rm.hasComponent(renderable)) {
+        slog.w << "StaticBatcher: entity has no renderable component, ignored" << io::endl;
+        return;
+    }
+    mPending.push_back({ renderable, geometry, 0 });
+}
+
+size_t StaticBatcher::commit(Scene& scene) {
+    auto& rm = mEngine.getRenderableManager();
+    auto& tcm = mEngine.getTransformManager();
+
+    // group the pending renderables by the material instance of their first primitive
+    tsl::robin_map<MaterialInstance*, std::vector<size_t>> groups;
+    for (size_t i = 0, n = mPending.size(); i < n; i++) {
+        auto instance = rm.getInstance(mPending[i].entity);
+        groups[rm.getMaterialInstanceAt(instance, 0)].push_back(i);
+    }
+
+    size_t batchCount = 0;
+    for (auto& [materialInstance, members] : groups) {
+        size_t vertexCount = 0;
+        size_t indexCount = 0;
+        bool hasTangents = true;
+        bool hasUv0 = true;
+        for (size_t i : members) {
+            Geometry const& geometry = mPending[i].geometry;
+            vertexCount += geometry.vertexCount;
+            indexCount += geometry.indexCount;
+            hasTangents = hasTangents && geometry.tangents;
+            hasUv0 = hasUv0 && geometry.uv0;
+        }
+
+        float3* const positions = (float3*) malloc(vertexCount * sizeof(float3));
+        float4* const tangents = hasTangents ?
+                (float4*) malloc(vertexCount * sizeof(float4)) : nullptr;
+        float2* const uv0 = hasUv0 ?
+                (float2*) malloc(vertexCount * sizeof(float2)) : nullptr;
+        uint32_t* const indices = (uint32_t*) malloc(indexCount * sizeof(uint32_t));
+
+        // merge the source geometries, transforming them into world space
+        float3 aabbMin{ std::numeric_limits<float>::max() };
+        float3 aabbMax{ std::numeric_limits<float>::lowest() };
+        size_t baseVertex = 0;
+        size_t baseIndex = 0;
+        for (size_t i : members) {
+            Source& source = mPending[i];
+            Geometry const& geometry = source.geometry;
+            auto ti = tcm.getInstance(source.entity);
+            const mat4f world = ti ? tcm.getWorldTransform(ti) : mat4f{};
+            const quatf rotation = extractRotation(world);
+
+            for (size_t v = 0; v < geometry.vertexCount; v++) {
+                positions[baseVertex + v] = (world * float4{ geometry.positions[v], 1.0f }).xyz;
+            }
+            if (hasTangents) {
+                for (size_t v = 0; v < geometry.vertexCount; v++) {
+                    float4 const& t = geometry.tangents[v];
+                    const quatf q = normalize(rotation * quatf{ t.w, t.x, t.y, t.z });
+                    tangents[baseVertex + v] = { q.x, q.y, q.z, q.w };
+                }
+            }
+            if (hasUv0) {
+                memcpy(uv0 + baseVertex, geometry.uv0, geometry.vertexCount * sizeof(float2));
+            }
+            for (size_t j = 0; j < geometry.indexCount; j++) {
+                indices[baseIndex + j] = uint32_t(baseVertex + geometry.indices[j]);
+            }
+            baseVertex += geometry.vertexCount;
+            baseIndex += geometry.indexCount;
+
+            auto ri = rm.getInstance(source.entity);
+            const Box worldAabb = rigidTransform(rm.getAxisAlignedBoundingBox(ri), world);
+            aabbMin = min(aabbMin, worldAabb.getMin());
+            aabbMax = max(aabbMax, worldAabb.getMax());
+        }
+
+        VertexBuffer::Builder vbb;
+        vbb.vertexCount(uint32_t(vertexCount))
+                .bufferCount(1 + (hasTangents ? 1 : 0) + (hasUv0 ? 1 : 0))
+                .attribute(VertexAttribute::POSITION, 0, VertexBuffer::AttributeType::FLOAT3);
+        uint8_t bufferIndex = 1;
+        const uint8_t tangentsIndex = bufferIndex;
+        if (hasTangents) {
+            vbb.attribute(VertexAttribute::TANGENTS, bufferIndex++,
+                    VertexBuffer::AttributeType::FLOAT4);
+        }
+        const uint8_t uv0Index = bufferIndex;
+        if (hasUv0) {
+            vbb.attribute(VertexAttribute::UV0, bufferIndex++,
+                    VertexBuffer::AttributeType::FLOAT2);
+        }
+        VertexBuffer* const vertexBuffer = vbb.build(mEngine);
+        vertexBuffer->setBufferAt(mEngine, 0,
+                { positions, vertexCount * sizeof(float3), freeCallback });
+        if (hasTangents) {
+            vertexBuffer->setBufferAt(mEngine, tangentsIndex,
+                    { tangents, vertexCount * sizeof(float4), freeCallback });
+        }
+        if (hasUv0) {
+            vertexBuffer->setBufferAt(mEngine, uv0Index,
+                    { uv0, vertexCount * sizeof(float2), freeCallback });
+        }
+
+        IndexBuffer* const indexBuffer = IndexBuffer::Builder()
+                .indexCount(uint32_t(indexCount))
+                .bufferType(IndexBuffer::IndexType::UINT)
+                .build(mEngine);
+        indexBuffer->setBuffer(mEngine,
+                { indices, indexCount * sizeof(uint32_t), freeCallback });
+
+        // shadow flags are inherited from the first member of the group
+        auto const firstInstance = rm.getInstance(mPending[members[0]].entity);
+        const Entity merged = EntityManager::get().create();
+        RenderableManager::Builder(1)
+                .boundingBox(Box{}.set(aabbMin, aabbMax))
+                .material(0, materialInstance)
+                .geometry(0, RenderableManager::PrimitiveType::TRIANGLES,
+                        vertexBuffer, indexBuffer, 0, indexCount)
+                .castShadows(rm.isShadowCaster(firstInstance))
+                .receiveShadows(rm.isShadowReceiver(firstInstance))
+                .build(mEngine, merged);
+        scene.addEntity(merged);
+        mBatches.push_back({ merged, vertexBuffer, indexBuffer });
+        batchCount++;
+
+        // hide the sources, remembering their layer mask so unbatch() can restore it
+        for (size_t i : members) {
+            auto ri = rm.getInstance(mPending[i].entity);
+            mPending[i].layerMask = rm.getLayerMask(ri);
+            rm.setLayerMask(ri, 0xff, 0x00);
+        }
+    }
+
+    mBatched.insert(mBatched.end(), mPending.begin(), mPending.end());
+    mPending.clear();
+    return batchCount;
+}
+
+void StaticBatcher::unbatch(Scene& scene) {
+    auto& rm = mEngine.getRenderableManager();
+    for (Batch const& batch : mBatches) {
+        scene.remove(batch.entity);
+        mEngine.destroy(batch.entity);
+        mEngine.destroy(batch.vertexBuffer);
+        mEngine.destroy(batch.indexBuffer);
+        EntityManager::get().destroy(batch.entity);
+    }
+    mBatches.clear();
+    for (Source const& source : mBatched) {
+        auto ri = rm.getInstance(source.entity);
+        if (ri) {
+            rm.setLayerMask(ri, 0xff, source.layerMask);
+        }
+    }
+    mBatched.clear();
+}
+
+} // namespace batchutils
+} // namespace filament
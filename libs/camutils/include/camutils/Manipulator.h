@@ -254,9 +254,13 @@ public:
      *
      * This must be called once every frame before getLookAt is valid.
      *
+     * Motion is integrated internally at a fixed timestep and the pose returned by getLookAt()
+     * is interpolated between the two most recent steps, so camera smoothness doesn't depend
+     * on the frame rate and survives frame-time spikes.
+     *
      * @param deltaTime The amount of time, in seconds, passed since the previous call to update.
      */
-    virtual void update(FLOAT deltaTime);
+    void update(FLOAT deltaTime);
 
     /**
      * Gets a handle that can be used to reset the manipulator back to its current position.
@@ -284,12 +288,41 @@ protected:
 
     virtual void setProperties(const Config& props);
 
+    /**
+     * Advances the simulation by one fixed timestep; called by update() as many times as
+     * needed to consume the frame time.
+     */
+    virtual void updateSimulation(FLOAT deltaTime);
+
     vec3 raycastFarPlane(int x, int y) const;
 
     const Mode mMode;
     Config mProps;
     vec3 mEye;
     vec3 mTarget;
+
+private:
+    // fixed-timestep integrator (see update())
+    static constexpr FLOAT SIMULATION_TIMESTEP = FLOAT(1.0 / 120.0);
+    static constexpr FLOAT MAX_FRAME_TIME = FLOAT(0.25);
+    FLOAT mTimeAccumulator = 0;
+    vec3 mPreviousEye;
+    vec3 mPreviousTarget;
+    bool mHasPreviousStep = false;
+
+    // Small direct-mapped cache of scene raycasts, quantized to a coarse screen grid and
+    // invalidated when the camera moves (see raycast()).
+    static constexpr int RAYCAST_GRID_SIZE = 4;
+    static constexpr size_t RAYCAST_CACHE_SIZE = 64;
+    struct RaycastCacheEntry {
+        int cx, cy;
+        vec3 result;
+        bool hit;
+        bool valid;
+    };
+    mutable RaycastCacheEntry mRaycastCache[RAYCAST_CACHE_SIZE] = {};
+    mutable vec3 mRaycastCacheEye;
+    mutable vec3 mRaycastCacheTarget;
 };
 
 } // namespace camutils
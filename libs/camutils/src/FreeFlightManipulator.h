@@ -120,7 +120,7 @@ public:
         mMoveSpeed = pow(Base::mProps.flightMaxSpeed, mScrollPositionNormalized);
     }
 
-    void update(FLOAT deltaTime) override {
+    void updateSimulation(FLOAT deltaTime) override {
         vec3 forceLocal { 0.0, 0.0, 0.0 };
 
         if (mKeyDown[(int) Base::Key::FORWARD]) {
@@ -197,7 +197,7 @@ private:
     FLOAT mScrollWheel = 0.0f;
     FLOAT mScrollPositionNormalized = 0.0f;
     FLOAT mMoveSpeed = 1.0f;
-    vec3 mEyeVelocity;
+    vec3 mEyeVelocity{};
 };
 
 } // namespace camutils
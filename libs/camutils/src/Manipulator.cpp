@@ -196,9 +196,18 @@ void Manipulator<FLOAT>::setViewport(int width, int height) {
 
 template <typename FLOAT>
 void Manipulator<FLOAT>::getLookAt(vec3* eyePosition, vec3* targetPosition, vec3* upward) const {
-    *targetPosition = mTarget;
-    *eyePosition = mEye;
-    const vec3 gaze = normalize(mTarget - mEye);
+    vec3 eye = mEye;
+    vec3 target = mTarget;
+    if (mHasPreviousStep) {
+        // interpolate between the two most recent simulation steps, so the pose advances
+        // smoothly even when frame times don't line up with the fixed timestep
+        const FLOAT alpha = mTimeAccumulator / SIMULATION_TIMESTEP;
+        eye = mix(mPreviousEye, eye, alpha);
+        target = mix(mPreviousTarget, target, alpha);
+    }
+    *targetPosition = target;
+    *eyePosition = eye;
+    const vec3 gaze = normalize(target - eye);
     const vec3 right = cross(gaze, mProps.upVector);
     *upward = cross(right, gaze);
 }
@@ -255,6 +264,24 @@ void Manipulator<FLOAT>::getRay(int x, int y, vec3* porigin, vec3* pdir) const {
 
 template <typename FLOAT>
 bool Manipulator<FLOAT>::raycast(int x, int y, vec3* result) const {
+    // Scene raycasts are expensive against dense meshes and grab gestures query the same
+    // region many times per frame, so results are quantized to a coarse screen grid and
+    // cached until the camera moves.
+    if (mEye != mRaycastCacheEye || mTarget != mRaycastCacheTarget) {
+        for (auto& entry : mRaycastCache) {
+            entry.valid = false;
+        }
+        mRaycastCacheEye = mEye;
+        mRaycastCacheTarget = mTarget;
+    }
+    const int cx = x / RAYCAST_GRID_SIZE;
+    const int cy = y / RAYCAST_GRID_SIZE;
+    auto& entry = mRaycastCache[(uint32_t(cx) * 7919u + uint32_t(cy)) % RAYCAST_CACHE_SIZE];
+    if (entry.valid && entry.cx == cx && entry.cy == cy) {
+        *result = entry.result;
+        return entry.hit;
+    }
+
     vec3 origin, dir;
     getRay(x, y, &origin, &dir);
 
@@ -269,14 +296,18 @@ bool Manipulator<FLOAT>::raycast(int x, int y, vec3* result) const {
 
     // If the ray misses, then try the fallback function.
     FLOAT t;
+    bool hit = true;
     if (!callback(mEye, dir, &t, userdata)) {
         if (callback == fallback || !fallback(mEye, dir, &t, (void*) &mProps)) {
-            return false;
+            hit = false;
         }
     }
 
-    *result = mEye + dir * t;
-    return true;
+    entry = { cx, cy, hit ? mEye + dir * t : vec3{}, hit, true };
+    if (hit) {
+        *result = entry.result;
+    }
+    return hit;
 }
 
 template <typename FLOAT>
@@ -315,7 +346,22 @@ template <typename FLOAT>
 void Manipulator<FLOAT>::keyUp(Manipulator<FLOAT>::Key key) { }
 
 template <typename FLOAT>
-void Manipulator<FLOAT>::update(FLOAT deltaTime) { }
+void Manipulator<FLOAT>::update(FLOAT deltaTime) {
+    // Integrate at a fixed timestep so the motion (e.g. velocity damping) behaves identically
+    // regardless of frame rate; a long frame runs several steps, a short one maybe none. The
+    // frame time is clamped so a hitch doesn't trigger a catch-up burst of steps.
+    mTimeAccumulator += min(deltaTime, MAX_FRAME_TIME);
+    while (mTimeAccumulator >= SIMULATION_TIMESTEP) {
+        mPreviousEye = mEye;
+        mPreviousTarget = mTarget;
+        mHasPreviousStep = true;
+        updateSimulation(SIMULATION_TIMESTEP);
+        mTimeAccumulator -= SIMULATION_TIMESTEP;
+    }
+}
+
+template <typename FLOAT>
+void Manipulator<FLOAT>::updateSimulation(FLOAT deltaTime) { }
 
 template class Manipulator<float>;
 
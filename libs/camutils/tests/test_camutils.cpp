@@ -79,6 +79,83 @@ TEST_F(CamUtilsTest, Map) {
     delete map;
 }
 
+TEST_F(CamUtilsTest, FixedTimestep) {
+
+    float3 eye1, eye2, targetPosition, up;
+
+    auto builder = CamManipulator::Builder()
+        .viewport(256, 256)
+        .flightStartPosition(0, 0, 4)
+        .flightMoveDamping(15.0);
+
+    CamManipulator* flight1 = builder.build(camutils::Mode::FREE_FLIGHT);
+    CamManipulator* flight2 = builder.build(camutils::Mode::FREE_FLIGHT);
+
+    flight1->keyDown(CamManipulator::Key::FORWARD);
+    flight2->keyDown(CamManipulator::Key::FORWARD);
+
+    // The same total simulation time must yield the same pose, regardless of how it is
+    // sliced into frames.
+    for (int i = 0; i < 100; i++) {
+        flight1->update(0.01f);
+    }
+    for (int i = 0; i < 4; i++) {
+        flight2->update(0.25f);
+    }
+
+    flight1->getLookAt(&eye1, &targetPosition, &up);
+    flight2->getLookAt(&eye2, &targetPosition, &up);
+    EXPECT_NEAR(eye1.x, eye2.x, 1e-4);
+    EXPECT_NEAR(eye1.y, eye2.y, 1e-4);
+    EXPECT_NEAR(eye1.z, eye2.z, 1e-4);
+
+    // The camera should actually have moved forward.
+    EXPECT_LT(eye1.z, 4.0f);
+
+    delete flight1;
+    delete flight2;
+}
+
+TEST_F(CamUtilsTest, RaycastCache) {
+
+    static int raycastCount;
+    raycastCount = 0;
+
+    auto raycaster = [](const float3& origin, const float3& dir, float* t, void* userdata) {
+        raycastCount++;
+        *t = 4.0f;
+        return true;
+    };
+
+    CamManipulator* orbit = CamManipulator::Builder()
+        .viewport(256, 256)
+        .targetPosition(0, 0, 0)
+        .orbitHomePosition(0, 0, 4)
+        .raycastCallback(raycaster, nullptr)
+        .build(camutils::Mode::ORBIT);
+
+    float3 hit1, hit2;
+
+    // Queries within the same grid cell hit the cache.
+    EXPECT_TRUE(orbit->raycast(100, 100, &hit1));
+    EXPECT_TRUE(orbit->raycast(101, 101, &hit2));
+    EXPECT_EQ(raycastCount, 1);
+    EXPECT_VEC_EQ(hit2, hit1.x, hit1.y, hit1.z);
+
+    // A distant pixel falls in a different cell.
+    EXPECT_TRUE(orbit->raycast(200, 50, &hit2));
+    EXPECT_EQ(raycastCount, 2);
+
+    // Moving the camera invalidates the cache.
+    orbit->grabBegin(100, 100, false);
+    orbit->grabUpdate(120, 100);
+    orbit->grabEnd();
+    EXPECT_TRUE(orbit->raycast(100, 100, &hit1));
+    EXPECT_EQ(raycastCount, 3);
+
+    delete orbit;
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
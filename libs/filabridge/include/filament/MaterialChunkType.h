@@ -38,6 +38,10 @@ constexpr inline uint64_t charTo64bitNum(const char str[9]) noexcept {
 
 enum UTILS_PUBLIC ChunkType : uint64_t {
     Unknown  = charTo64bitNum("UNKNOWN "),
+
+    // Optional first chunk: maps every following chunk to its absolute offset in the package,
+    // which lets the engine locate chunks directly instead of walking the whole package.
+    MaterialChunkIndex = charTo64bitNum("MAT_CIDX"),
     MaterialUib = charTo64bitNum("MAT_UIB "),
     MaterialSib = charTo64bitNum("MAT_SIB "),
     MaterialSubpass = charTo64bitNum("MAT_SUB "),
@@ -45,7 +49,7 @@ enum UTILS_PUBLIC ChunkType : uint64_t {
     MaterialSpirv = charTo64bitNum("MAT_SPIR"),
     MaterialMetal = charTo64bitNum("MAT_METL"),
     MaterialShaderModels = charTo64bitNum("MAT_SMDL"),
-    MaterialSamplerBindings = charTo64bitNum("MAT_SAMP"),   // no longer used
+    MaterialSamplerBindings = charTo64bitNum("MAT_SAMP"),
     MaterialProperties = charTo64bitNum("MAT_PROP"),
 
     MaterialName = charTo64bitNum("MAT_NAME"),
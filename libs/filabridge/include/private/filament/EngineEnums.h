@@ -71,6 +71,9 @@ constexpr size_t CONFIG_MAX_BONE_COUNT = 256;
 // This value is limited by ES3.0, ES3.0 only guarantees 256 layers in an array texture.
 constexpr size_t CONFIG_MAX_MORPH_TARGET_COUNT = 256;
 
+// The maximum number of levels of detail a renderable can declare.
+constexpr size_t CONFIG_MAX_LOD_COUNT = 4;
+
 } // namespace filament
 
 #endif // TNT_FILAMENT_driver/EngineEnums.h
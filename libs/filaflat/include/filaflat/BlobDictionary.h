@@ -18,13 +18,17 @@
 #define TNT_FILAFLAT_BLOBDICTIONARY_H
 
 #include <cstdint>
+#include <utility>
 #include <vector>
 
 #include <stddef.h>
 
 namespace filaflat {
 
-// Flat list of blobs that can be referenced by index.
+// Flat list of blobs that can be referenced by index. An entry either owns its bytes, or is a
+// zero-copy span pointing into the material package (which must outlive the dictionary), or
+// holds compressed bytes that get decompressed lazily the first time they are accessed, so
+// that only shader variants actually used pay the decompression cost.
 class BlobDictionary {
 public:
     BlobDictionary() = default;
@@ -32,37 +36,111 @@ public:
 
     using Blob = std::vector<uint8_t>;
 
+    // Decompresses a compressed entry into "output", returning false if the data is corrupt.
+    using Decompressor = bool (*)(const char* compressed, size_t compressedSize, Blob* output);
+
+    // Copies the given bytes into owned storage.
     inline void addBlob(const char* blob, size_t len) noexcept {
-        mBlobs.emplace_back(blob, blob + len);
+        mEntries.push_back({nullptr, 0, nullptr, 0, Blob(blob, blob + len), false});
+        finishOwnedEntry();
     }
 
     inline void addBlob(Blob&& blob) noexcept {
-        mBlobs.push_back(std::move(blob));
+        mEntries.push_back({nullptr, 0, nullptr, 0, std::move(blob), false});
+        finishOwnedEntry();
+    }
+
+    // References the given bytes without copying them; the memory they live in (typically the
+    // material package) must remain valid for the lifetime of the dictionary.
+    inline void addSpan(const char* blob, size_t len) noexcept {
+        mEntries.push_back({blob, len, nullptr, 0, {}, false});
+    }
+
+    // References compressed bytes without copying them; they are run through the decompressor
+    // set with setDecompressor() on first access.
+    inline void addCompressedBlob(const char* compressed, size_t compressedSize) noexcept {
+        mEntries.push_back({compressed, compressedSize, compressed, compressedSize, {}, true});
+    }
+
+    inline void setDecompressor(Decompressor decompressor) noexcept {
+        mDecompressor = decompressor;
     }
 
     inline bool isEmpty() const noexcept {
-        return mBlobs.empty();
+        return mEntries.empty();
     }
 
     inline void reserve(size_t size) {
-        mBlobs.reserve(size);
+        mEntries.reserve(size);
     }
 
+    // Returns null if a compressed entry fails to decompress.
     inline const char* getBlob(size_t index, size_t* size) const noexcept {
-        *size = mBlobs[index].size();
-        return (const char*) mBlobs[index].data();
+        Entry& entry = mEntries[index];
+        if (entry.compressed) {
+            decompressEntry(entry);
+        }
+        *size = entry.size;
+        return entry.data;
     }
 
     inline const char* getString(size_t index) const noexcept {
-        return (const char*) mBlobs[index].data();
+        size_t size;
+        return getBlob(index, &size);
     }
 
     inline size_t size() const noexcept {
-        return mBlobs.size();
+        return mEntries.size();
+    }
+
+    // Frees the storage of entries that were decompressed, pointing them back at their
+    // compressed source bytes; a later access simply decompresses again. Zero-copy spans and
+    // entries created with addBlob() are left alone.
+    inline void releaseDecompressedBlobs() noexcept {
+        for (Entry& entry : mEntries) {
+            if (entry.source && !entry.storage.empty()) {
+                entry.storage = Blob{};
+                entry.data = entry.source;
+                entry.size = entry.sourceSize;
+                entry.compressed = true;
+            }
+        }
     }
 
 private:
-    std::vector<Blob> mBlobs;
+    struct Entry {
+        const char* data;
+        size_t size;
+        const char* source;     // original compressed bytes, null for uncompressed entries
+        size_t sourceSize;
+        Blob storage;           // owns the bytes when non-empty
+        bool compressed;
+    };
+
+    // Points the entry at its own storage. Moving a Blob transfers its heap buffer, so the
+    // pointer stays valid when mEntries grows.
+    inline void finishOwnedEntry() noexcept {
+        Entry& entry = mEntries.back();
+        entry.data = (const char*) entry.storage.data();
+        entry.size = entry.storage.size();
+    }
+
+    inline void decompressEntry(Entry& entry) const noexcept {
+        // Whether it succeeds or not, decompression is attempted only once.
+        entry.compressed = false;
+        Blob output;
+        if (mDecompressor && mDecompressor(entry.data, entry.size, &output)) {
+            entry.storage = std::move(output);
+            entry.data = (const char*) entry.storage.data();
+            entry.size = entry.storage.size();
+        } else {
+            entry.data = nullptr;
+            entry.size = 0;
+        }
+    }
+
+    mutable std::vector<Entry> mEntries;
+    Decompressor mDecompressor = nullptr;
 };
 
 } // namespace filaflat
@@ -88,6 +88,7 @@ public:
 
 private:
     bool parseChunk(Unflattener& unflattener);
+    bool parseIndex(Unflattener& unflattener);
 
     void const* mData;
     size_t mSize;
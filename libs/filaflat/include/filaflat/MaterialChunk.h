@@ -50,8 +50,14 @@ private:
     filamat::ChunkType mMaterialTag = filamat::ChunkType::Unknown;
     Unflattener mUnflattener{nullptr, nullptr};
     const uint8_t* mBase = nullptr;
+    const uint8_t* mIndexCursor = nullptr;
+    uint64_t mShaderCount = 0;
+    bool mIndexBuilt = false;
     tsl::robin_map<uint32_t, uint32_t> mOffsets;
 
+    // builds mOffsets from the index entries on first use
+    bool ensureIndex();
+
     bool getTextShader(Unflattener unflattener,
             BlobDictionary const& dictionary, ShaderBuilder& shaderBuilder,
             uint8_t shaderModel, filament::Variant variant, uint8_t ps);
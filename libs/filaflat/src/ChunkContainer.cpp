@@ -18,6 +18,8 @@
 
 #include <filaflat/Unflattener.h>
 
+#include <assert.h>
+
 namespace filaflat {
 
 ChunkContainer::~ChunkContainer() noexcept = default;
@@ -46,7 +48,46 @@ bool ChunkContainer::parseChunk(Unflattener& unflattener) {
     return true;
 }
 
+// Fast path for packages that start with an index chunk (written by matc): the index maps each
+// chunk to its absolute offset, so the chunk table can be built directly from it. The offsets in
+// the index are trusted -- the package is assumed to come from the application's own assets --
+// so individual chunks are not re-validated.
+bool ChunkContainer::parseIndex(Unflattener& unflattener) {
+    uint64_t type;
+    uint32_t size;
+    if (!unflattener.read(&type) || type != filamat::ChunkType::MaterialChunkIndex ||
+            !unflattener.read(&size)) {
+        return false;
+    }
+
+    uint32_t count;
+    if (!unflattener.read(&count)) {
+        return false;
+    }
+
+    mChunks.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        uint64_t chunkType;
+        uint32_t offset;
+        uint32_t chunkSize;
+        if (!unflattener.read(&chunkType) ||
+                !unflattener.read(&offset) ||
+                !unflattener.read(&chunkSize)) {
+            return false;
+        }
+        assert(offset + chunkSize <= mSize);
+        mChunks[Type(chunkType)] = { (uint8_t const*)mData + offset, chunkSize };
+    }
+    return true;
+}
+
 bool ChunkContainer::parse() noexcept {
+    Unflattener indexUnflattener((uint8_t *)mData, (uint8_t *)mData + mSize);
+    if (parseIndex(indexUnflattener)) {
+        return true;
+    }
+    mChunks.clear();
+
     Unflattener unflattener((uint8_t *)mData, (uint8_t *)mData + mSize);
     do {
         if (!parseChunk(unflattener)) {
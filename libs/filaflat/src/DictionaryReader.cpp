@@ -30,6 +30,18 @@ using namespace filamat;
 
 namespace filaflat {
 
+#if defined (FILAMENT_DRIVER_SUPPORTS_VULKAN)
+static bool decodeSpirv(const char* compressed, size_t compressedSize,
+        BlobDictionary::Blob* output) {
+    size_t spirvSize = smolv::GetDecodedBufferSize(compressed, compressedSize);
+    if (spirvSize == 0) {
+        return false;
+    }
+    output->resize(spirvSize);
+    return smolv::Decode(compressed, compressedSize, output->data(), spirvSize);
+}
+#endif
+
 bool DictionaryReader::unflatten(ChunkContainer const& container,
         ChunkContainer::Type dictionaryTag,
         BlobDictionary& dictionary) {
@@ -52,6 +64,10 @@ bool DictionaryReader::unflatten(ChunkContainer const& container,
             return false;
         }
 
+#if defined (FILAMENT_DRIVER_SUPPORTS_VULKAN)
+        // Record a span for each compressed blob; decoding happens lazily in BlobDictionary,
+        // so only the variants that actually get used pay the smolv cost.
+        dictionary.setDecompressor(decodeSpirv);
         dictionary.reserve(blobCount);
         for (uint32_t i = 0; i < blobCount; i++) {
             const char* compressed;
@@ -59,23 +75,12 @@ bool DictionaryReader::unflatten(ChunkContainer const& container,
             if (!unflattener.read(&compressed, &compressedSize)) {
                 return false;
             }
-
-#if defined (FILAMENT_DRIVER_SUPPORTS_VULKAN)
-            size_t spirvSize = smolv::GetDecodedBufferSize(compressed, compressedSize);
-            if (spirvSize == 0) {
-                return false;
-            }
-            BlobDictionary::Blob spirv(spirvSize);
-            if (!smolv::Decode(compressed, compressedSize, spirv.data(), spirvSize)) {
-                return false;
-            }
-            dictionary.addBlob(std::move(spirv));
-#else
-            return false;
-#endif
-
+            dictionary.addCompressedBlob(compressed, compressedSize);
         }
         return true;
+#else
+        return false;
+#endif
     } else if (dictionaryTag == ChunkType::DictionaryText) {
         uint32_t stringCount = 0;
         if (!unflattener.read(&stringCount)) {
@@ -88,9 +93,9 @@ bool DictionaryReader::unflatten(ChunkContainer const& container,
             if (!unflattener.read(&str)) {
                 return false;
             }
-            // BlobDictionary hold binary chunks and does not care if the data holds text, it is
-            // therefore crucial to include the trailing null.
-            dictionary.addBlob(str, strlen(str) + 1);
+            // The strings are stored uncompressed and null-terminated in the package, so a
+            // zero-copy span suffices; it is crucial to include the trailing null.
+            dictionary.addSpan(str, strlen(str) + 1);
         }
         return true;
     }
@@ -55,26 +55,35 @@ bool MaterialChunk::readIndex(filamat::ChunkType materialTag) {
         return false;
     }
 
+    // The index entries themselves are read lazily (see ensureIndex), so that materials whose
+    // shaders are never requested don't pay for building the offset map.
+    mShaderCount = numShaders;
+    mIndexCursor = unflattener.getCursor();
+    return true;
+}
+
+bool MaterialChunk::ensureIndex() {
+    if (mIndexBuilt) {
+        return !mOffsets.empty();
+    }
+    mIndexBuilt = true;
+
+    Unflattener unflattener = mUnflattener;
+    unflattener.setCursor(mIndexCursor);
+
     // Read all index entries.
-    for (uint64_t i = 0 ; i < numShaders; i++) {
+    mOffsets.reserve(mShaderCount);
+    for (uint64_t i = 0 ; i < mShaderCount; i++) {
         uint8_t shaderModelValue;
         filament::Variant variant;
         uint8_t pipelineStageValue;
         uint32_t offsetValue;
 
-        if (!unflattener.read(&shaderModelValue)) {
-            return false;
-        }
-
-        if (!unflattener.read(&variant)) {
-            return false;
-        }
-
-        if (!unflattener.read(&pipelineStageValue)) {
-            return false;
-        }
-
-        if (!unflattener.read(&offsetValue)) {
+        if (!unflattener.read(&shaderModelValue) ||
+                !unflattener.read(&variant) ||
+                !unflattener.read(&pipelineStageValue) ||
+                !unflattener.read(&offsetValue)) {
+            mOffsets.clear();
             return false;
         }
 
@@ -86,7 +95,7 @@ bool MaterialChunk::readIndex(filamat::ChunkType materialTag) {
 
 bool MaterialChunk::getTextShader(Unflattener unflattener, BlobDictionary const& dictionary,
         ShaderBuilder& shaderBuilder, uint8_t shaderModel, filament::Variant variant, uint8_t ps) {
-    if (mBase == nullptr) {
+    if (mBase == nullptr || !ensureIndex()) {
         return false;
     }
 
@@ -142,7 +151,7 @@ bool MaterialChunk::getTextShader(Unflattener unflattener, BlobDictionary const&
 bool MaterialChunk::getSpirvShader(BlobDictionary const& dictionary,
         ShaderBuilder& shaderBuilder, uint8_t shaderModel, filament::Variant variant, uint8_t stage) {
 
-    if (mBase == nullptr) {
+    if (mBase == nullptr || !ensureIndex()) {
         return false;
     }
 
@@ -155,6 +164,9 @@ bool MaterialChunk::getSpirvShader(BlobDictionary const& dictionary,
     size_t index = pos->second;
     size_t shaderSize;
     const char* shaderContent = dictionary.getBlob(index, &shaderSize);
+    if (shaderContent == nullptr) {
+        return false;
+    }
 
     shaderBuilder.reset();
     shaderBuilder.announce(shaderSize);
@@ -520,6 +520,22 @@ public:
     //! Specifies a list of variants that should be filtered out during code generation.
     MaterialBuilder& variantFilter(uint8_t variantFilter) noexcept;
 
+    /**
+     * Restricts code generation to the variants actually used at runtime, one bit per
+     * variant key, as recorded by the engine and dumped with its
+     * "d.materials.dump_variant_usage" debug property. An empty mask (the default) keeps
+     * every variant. Only meaningful for materials in the SURFACE domain.
+     */
+    MaterialBuilder& usedVariants(utils::bitset<uint64_t, 2> mask) noexcept;
+
+    /**
+     * Forces generation of the depth-only variants even when this material has no custom
+     * depth code. By default such variants are pruned from the package because the engine
+     * substitutes the default material's depth programs at runtime; the default material
+     * itself must therefore be built with this set to true.
+     */
+    MaterialBuilder& keepDepthVariants(bool keep) noexcept;
+
     //! Adds a new preprocessor macro definition to the shader code. Can be called repeatedly.
     MaterialBuilder& shaderDefine(const char* name, const char* value) noexcept;
 
@@ -637,6 +653,9 @@ public:
 
     uint8_t getVariantFilter() const { return mVariantFilter; }
 
+    // returns the material's name, as set by name()
+    const char* getName() const noexcept { return mMaterialName.c_str_safe(); }
+
     /// @endcond
 
 private:
@@ -726,6 +745,12 @@ private:
     bool mShadowMultiplier = false;
     bool mTransparentShadow = false;
 
+    // empty = generate all variants, see usedVariants()
+    utils::bitset<uint64_t, 2> mUsedVariants;
+
+    // see keepDepthVariants()
+    bool mKeepDepthVariants = false;
+
     uint8_t mParameterCount = 0;
 
     bool mDoubleSided = false;
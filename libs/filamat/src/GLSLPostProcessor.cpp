@@ -230,6 +230,48 @@ bool GLSLPostProcessor::process(const std::string& inputShader, Config const& co
         return true;
     }
 
+    // pack the Config fields that affect the output. The variant only matters for MSL,
+    // where it selects the sampler binding indices.
+    uint64_t const configBits = uint64_t(config.shaderType)
+            | uint64_t(config.shaderModel) << 8
+            | uint64_t(config.domain) << 16
+            | uint64_t(config.hasFramebufferFetch) << 24
+            | uint64_t(outputGlsl  != nullptr) << 25
+            | uint64_t(outputSpirv != nullptr) << 26
+            | uint64_t(outputMsl   != nullptr) << 27
+            | uint64_t(outputMsl ? config.variant.key : 0u) << 32;
+
+    CacheKey key{ inputShader, configBits };
+    {
+        std::lock_guard<utils::Mutex> guard(mCacheLock);
+        auto pos = mCache.find(key);
+        if (pos != mCache.end()) {
+            CacheEntry const& entry = pos->second;
+            if (outputGlsl)  { *outputGlsl  = entry.glsl;  }
+            if (outputSpirv) { *outputSpirv = entry.spirv; }
+            if (outputMsl)   { *outputMsl   = entry.msl;   }
+            return true;
+        }
+    }
+
+    bool const ok = processImpl(inputShader, config, outputGlsl, outputSpirv, outputMsl);
+    if (ok) {
+        std::lock_guard<utils::Mutex> guard(mCacheLock);
+        mCache.emplace(std::move(key), CacheEntry{
+                outputGlsl  ? *outputGlsl  : std::string(),
+                outputSpirv ? *outputSpirv : SpirvBlob(),
+                outputMsl   ? *outputMsl   : std::string() });
+    }
+    return ok;
+}
+
+bool GLSLPostProcessor::processImpl(const std::string& inputShader, Config const& config,
+        std::string* outputGlsl, SpirvBlob* outputSpirv, std::string* outputMsl) {
+
+    using TargetApi = MaterialBuilder::TargetApi;
+    const TargetApi targetApi = (outputSpirv || config.hasFramebufferFetch) ? TargetApi::VULKAN :
+        TargetApi::OPENGL;
+
     InternalConfig internalConfig;
 
     internalConfig.glslOutput = outputGlsl;
@@ -32,7 +32,10 @@
 
 #include <spirv-tools/optimizer.hpp>
 
+#include <utils/Mutex.h>
+
 #include <memory>
+#include <unordered_map>
 
 namespace filamat {
 
@@ -61,12 +64,19 @@ public:
         } glsl;
     };
 
+    // thread-safe, this is called concurrently from MaterialBuilder's variant jobs.
+    // Results are memoized on the shader content, see mCache below.
     bool process(const std::string& inputShader, Config const& config,
             std::string* outputGlsl,
             SpirvBlob* outputSpirv,
             std::string* outputMsl);
 
 private:
+    bool processImpl(const std::string& inputShader, Config const& config,
+            std::string* outputGlsl,
+            SpirvBlob* outputSpirv,
+            std::string* outputMsl);
+
     struct InternalConfig {
         std::string* glslOutput = nullptr;
         SpirvBlob* spirvOutput = nullptr;
@@ -99,6 +109,29 @@ private:
     const MaterialBuilder::Optimization mOptimization;
     const bool mPrintShaders;
     const bool mGenerateDebugInfo;
+
+    // Content-hash cache of postprocessing results. Different variants frequently
+    // generate byte-identical shader code (e.g. all the depth-only variants), there's
+    // no point running glslang / spirv-opt / spirv-cross on those again.
+    struct CacheKey {
+        std::string shader;
+        uint64_t config;    // the Config fields that affect the output, packed
+        bool operator==(CacheKey const& rhs) const noexcept {
+            return config == rhs.config && shader == rhs.shader;
+        }
+    };
+    struct CacheKeyHasher {
+        size_t operator()(CacheKey const& key) const noexcept {
+            return std::hash<std::string>()(key.shader) ^ std::hash<uint64_t>()(key.config);
+        }
+    };
+    struct CacheEntry {
+        std::string glsl;
+        SpirvBlob spirv;
+        std::string msl;
+    };
+    utils::Mutex mCacheLock;
+    std::unordered_map<CacheKey, CacheEntry, CacheKeyHasher> mCache;
 };
 
 } // namespace filamat
@@ -409,6 +409,18 @@ MaterialBuilder& MaterialBuilder::variantFilter(uint8_t variantFilter) noexcept
     return *this;
 }
 
+MaterialBuilder& MaterialBuilder::usedVariants(utils::bitset<uint64_t, 2> mask) noexcept {
+    static_assert(std::is_same_v<decltype(mUsedVariants), filament::VariantList>,
+            "usedVariants() mask must have the same layout as filament::VariantList");
+    mUsedVariants = mask;
+    return *this;
+}
+
+MaterialBuilder& MaterialBuilder::keepDepthVariants(bool keep) noexcept {
+    mKeepDepthVariants = keep;
+    return *this;
+}
+
 MaterialBuilder& MaterialBuilder::shaderDefine(const char* name, const char* value) noexcept {
     mDefines.emplace_back(name, value);
     return *this;
@@ -961,9 +973,13 @@ Package MaterialBuilder::build(JobSystem& jobSystem) noexcept {
 
     info.useLegacyMorphing = mUseLegacyMorphing;
 
-    // Generate all shaders and write the shader chunks.
+    // Generate all shaders and write the shader chunks. Depth variants are only reachable at
+    // runtime when the material provides custom depth code (see needsStandardDepthProgram());
+    // otherwise the engine substitutes the default material's depth programs, so generating
+    // them here would only waste package size and compile time.
     const auto variants = mMaterialDomain == MaterialDomain::SURFACE ?
-        determineSurfaceVariants(mVariantFilter, isLit(), mShadowMultiplier) :
+        determineSurfaceVariants(mVariantFilter, isLit(), mShadowMultiplier, mUsedVariants,
+                needsStandardDepthProgram() || mKeepDepthVariants) :
         determinePostProcessVariants();
     bool success = generateShaders(jobSystem, variants, container, info);
 
@@ -1036,6 +1052,9 @@ void MaterialBuilder::writeCommonChunks(ChunkContainer& container, MaterialInfo&
     // SIB
     container.addChild<MaterialSamplerInterfaceBlockChunk>(info.sib);
 
+    // Sampler binding table, so the engine doesn't have to recompute it at load time
+    container.addChild<MaterialSamplerBindingsChunk>(info.samplerBindings);
+
     // Subpass
     container.addChild<MaterialSubpassInterfaceBlockChunk>(info.subpass);
 
@@ -21,25 +21,53 @@
 namespace filamat {
 
 std::vector<Variant> determineSurfaceVariants(
-        filament::Variant::type_t variantFilter, bool isLit, bool shadowMultiplier) {
+        filament::Variant::type_t variantFilter, bool isLit, bool shadowMultiplier,
+        filament::VariantList const& usedVariants, bool includeDepthVariants) {
     std::vector<Variant> variants;
     filament::Variant::type_t variantMask = ~variantFilter;
+
+    // When a runtime usage mask is provided, only generate the vertex and fragment
+    // programs that at least one recorded variant resolves to; an empty mask keeps
+    // everything. The recorded keys go through the same filtering the engine applies
+    // before looking up a program, so reserved or filtered-out bits are harmless.
+    const bool hasUsage = usedVariants.any();
+    filament::VariantList usedVertex, usedFragment;
+    if (hasUsage) {
+        usedVariants.forEachSetBit([&](size_t key) {
+            filament::Variant v = filament::Variant::filterVariant(
+                    filament::Variant(filament::Variant::type_t(key)) & variantMask,
+                    isLit || shadowMultiplier);
+            usedVertex.set(filament::Variant::filterVariantVertex(v).key);
+            usedFragment.set(filament::Variant::filterVariantFragment(v).key);
+        });
+    }
+
     for (filament::Variant::type_t k = 0; k < filament::VARIANT_COUNT; k++) {
         filament::Variant variant(k);
         if (filament::Variant::isReserved(variant)) {
             continue;
         }
 
+        // Materials without custom depth code share the default material's depth programs at
+        // runtime, which makes their own depth variants unreachable; skip generating them.
+        if (!includeDepthVariants && filament::Variant::isValidDepthVariant(variant)) {
+            continue;
+        }
+
         // Remove variants for unlit materials
         filament::Variant v = filament::Variant::filterVariant(
                 variant & variantMask, isLit || shadowMultiplier);
 
         if (filament::Variant::filterVariantVertex(v) == variant) {
-            variants.emplace_back(variant, filament::backend::ShaderType::VERTEX);
+            if (!hasUsage || usedVertex[variant.key]) {
+                variants.emplace_back(variant, filament::backend::ShaderType::VERTEX);
+            }
         }
 
         if (filament::Variant::filterVariantFragment(v) == variant) {
-            variants.emplace_back(variant, filament::backend::ShaderType::FRAGMENT);
+            if (!hasUsage || usedFragment[variant.key]) {
+                variants.emplace_back(variant, filament::backend::ShaderType::FRAGMENT);
+            }
         }
     }
     return variants;
@@ -33,7 +33,8 @@ struct Variant {
 };
 
 std::vector<Variant> determineSurfaceVariants(
-        filament::Variant::type_t variantFilter, bool isLit, bool shadowMultiplier);
+        filament::Variant::type_t variantFilter, bool isLit, bool shadowMultiplier,
+        filament::VariantList const& usedVariants, bool includeDepthVariants);
 
 std::vector<Variant> determinePostProcessVariants();
 
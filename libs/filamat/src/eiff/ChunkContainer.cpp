@@ -26,6 +26,25 @@ size_t ChunkContainer::getSize() const {
 }
 
 size_t ChunkContainer::flatten(Flattener& f) const {
+    // The index chunk comes first and maps every chunk that follows to its absolute offset in
+    // the package, so the engine can build its chunk table without walking the whole package.
+    // Index entries are fixed-size, which is what makes this work: the dry run (getSize())
+    // produces the correct total before the children's flattened sizes are known, and by the
+    // time the real pass runs, the dry run has recorded each child's size.
+    f.writeUint64(static_cast<uint64_t>(ChunkType::MaterialChunkIndex));
+    f.writeSizePlaceholder();
+    f.writeUint32(static_cast<uint32_t>(mChildren.size()));
+    const size_t indexSize = 8 + 4 + 4 + mChildren.size() * 16;
+    size_t offset = indexSize;
+    for (const auto& chunk: mChildren) {
+        f.writeUint64(static_cast<uint64_t>(chunk->getType()));
+        // offset of the chunk's payload, i.e. just past its own type + size header
+        f.writeUint32(static_cast<uint32_t>(offset + 12));
+        f.writeUint32(static_cast<uint32_t>(chunk->getFlattenedSize()));
+        offset += 12 + chunk->getFlattenedSize();
+    }
+    f.writeSize();
+
     for (const auto& chunk: mChildren) {
         f.writeUint64(static_cast<uint64_t>(chunk->getType()));
         f.writeSizePlaceholder();
@@ -17,6 +17,8 @@
 
 #include "filament/MaterialChunkType.h"
 
+#include <private/filament/SamplerBindingMap.h>
+
 using namespace filament;
 
 namespace filamat {
@@ -56,6 +58,32 @@ void MaterialSamplerInterfaceBlockChunk::flatten(Flattener &f) {
     }
 }
 
+MaterialSamplerBindingsChunk::MaterialSamplerBindingsChunk(SamplerBindingMap const& bindings) :
+        Chunk(ChunkType::MaterialSamplerBindings),
+        mBindings(bindings) {
+}
+
+void MaterialSamplerBindingsChunk::flatten(Flattener &f) {
+    // (blockIndex, localOffset) -> globalOffset tuples; local offsets within a block are
+    // contiguous and start at zero, so the map can be enumerated by probing it directly
+    uint64_t count = 0;
+    for (uint8_t block = 0; block < filament::BindingPoints::COUNT; block++) {
+        uint8_t global = 0;
+        for (uint8_t local = 0; mBindings.getSamplerBinding(block, local, &global); local++) {
+            count++;
+        }
+    }
+    f.writeUint64(count);
+    for (uint8_t block = 0; block < filament::BindingPoints::COUNT; block++) {
+        uint8_t global = 0;
+        for (uint8_t local = 0; mBindings.getSamplerBinding(block, local, &global); local++) {
+            f.writeUint8(block);
+            f.writeUint8(local);
+            f.writeUint8(global);
+        }
+    }
+}
+
 MaterialSubpassInterfaceBlockChunk::MaterialSubpassInterfaceBlockChunk(SubpassInfo& subpass) :
         Chunk(ChunkType::MaterialSubpass),
         mSubpass(subpass) {
@@ -23,6 +23,10 @@
 #include <private/filament/UniformInterfaceBlock.h>
 #include <private/filament/SubpassInfo.h>
 
+namespace filament {
+class SamplerBindingMap;
+} // namespace filament
+
 namespace filamat {
 
 class MaterialUniformInterfaceBlockChunk final : public Chunk {
@@ -47,6 +51,17 @@ private:
     filament::SamplerInterfaceBlock& mSib;
 };
 
+class MaterialSamplerBindingsChunk final : public Chunk {
+public:
+    explicit MaterialSamplerBindingsChunk(filament::SamplerBindingMap const& bindings);
+    ~MaterialSamplerBindingsChunk() = default;
+
+private:
+    void flatten(Flattener &) override;
+
+    filament::SamplerBindingMap const& mBindings;
+};
+
 class MaterialSubpassInterfaceBlockChunk final : public Chunk {
 public:
     explicit MaterialSubpassInterfaceBlockChunk(filament::SubpassInfo& subpass);
@@ -50,9 +50,11 @@ IBL::IBL(Engine& engine) : mEngine(engine) {
 
 IBL::~IBL() {
     mEngine.destroy(mIndirectLight);
-    mEngine.destroy(mTexture);
     mEngine.destroy(mSkybox);
-    mEngine.destroy(mSkyboxTexture);
+    // these textures may be shared (see createSharedTexture()), releaseTexture() falls
+    // back to Engine::destroy() for the ones that aren't
+    ktx::releaseTexture(&mEngine, mTexture);
+    ktx::releaseTexture(&mEngine, mSkyboxTexture);
 }
 
 bool IBL::loadFromEquirect(Path const& path) {
@@ -134,8 +136,13 @@ bool IBL::loadFromKtx(const std::string& prefix) {
     KtxBundle* iblKtx = createKtx(iblPath);
     KtxBundle* skyKtx = createKtx(skyPath);
 
-    mSkyboxTexture = ktx::createTexture(&mEngine, skyKtx, false);
-    mTexture = ktx::createTexture(&mEngine, iblKtx, false);
+    // pack uncompressed HDR environments to R11F_G11F_B10F, pre-compressed bundles
+    // (e.g. ASTC HDR baked offline) are left untouched and uploaded as-is
+    packHdrTo101111(*iblKtx);
+    packHdrTo101111(*skyKtx);
+
+    mSkyboxTexture = ktx::createSharedTexture(&mEngine, skyKtx, false);
+    mTexture = ktx::createSharedTexture(&mEngine, iblKtx, false);
 
     if (!iblKtx->getSphericalHarmonics(mBands)) {
         return false;
@@ -39,6 +39,11 @@ namespace filamesh {
  * This API can be used to read meshes stored in the "filamesh" format produced
  * by the command line tool of the same name. This file format is documented in
  * "docs/filamesh.md" in the Filament distribution.
+ *
+ * Meshes written with quantized positions (see the POSITION_SNORM16 flag in
+ * filamesh.h) are given a transform component holding the dequantization
+ * transform; to place such a mesh, parent its renderable rather than
+ * overwriting its transform.
  */
 class UTILS_PUBLIC MeshReader {
 public:
@@ -89,6 +94,10 @@ public:
      * file cannot be matched to a material in the registry, a default material is
      * used instead. The default material can be overridden by adding a material
      * named "DefaultMaterial" to the registry.
+     *
+     * On platforms that support it, the file is memory-mapped rather than copied
+     * into a heap buffer, so vertex and index data is uploaded directly from the
+     * page cache.
      */
     static Mesh loadMeshFromFile(filament::Engine* engine,
             const utils::Path& path,
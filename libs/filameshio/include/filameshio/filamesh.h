@@ -19,6 +19,9 @@
 
 #include <filament/Box.h>
 
+#include <math/vec3.h>
+#include <math/vec4.h>
+
 namespace filamesh {
 
 using Box = filament::Box;
@@ -36,6 +39,18 @@ enum Flags : uint32_t {
     INTERLEAVED         = 1 << 0,
     TEXCOORD_SNORM16    = 1 << 1,
     COMPRESSION         = 1 << 2,
+    POSITION_SNORM16    = 1 << 3,
+    PART_CONES          = 1 << 4,
+};
+
+// Dequantization applied to snorm16 positions at load time: object-space position is
+// position * scale + offset. This header immediately follows the main Header and is only
+// present when the POSITION_SNORM16 flag is enabled. Note that in this case the AABBs
+// stored in the file are in quantized space; the loader is expected to place the mesh
+// under a transform built from this header.
+struct QuantizationHeader {
+    filament::math::float3 scale;
+    filament::math::float3 offset;
 };
 
 // Each of these fields specifies a number of bytes within the compressed data. This is ignored
@@ -79,6 +94,14 @@ struct Part {
     Box aabb;
 };
 
+// Object-space bounding cone of a part, used for cluster backface culling (see
+// RenderableManager::Builder::boundingCone). An array of these immediately follows the
+// Part array and is only present when the PART_CONES flag is enabled.
+struct PartCone {
+    filament::math::float4 centerRadius;    // cone apex center (xyz) and radius (w)
+    filament::math::float4 axisCutoff;      // cone axis (xyz) and cutoff (w), cutoff >= 1 disables
+};
+
 } // namespace filamesh
 
 #endif // TNT_FILAMENT_FILAMESHIO_FILAMESH_H
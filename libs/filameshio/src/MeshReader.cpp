@@ -24,8 +24,11 @@
 #include <filament/Material.h>
 #include <filament/MaterialInstance.h>
 #include <filament/RenderableManager.h>
+#include <filament/TransformManager.h>
 #include <filament/VertexBuffer.h>
 
+#include <math/mat4.h>
+
 #include <meshoptimizer.h>
 
 #include <utils/EntityManager.h>
@@ -39,6 +42,7 @@
 
 #include <fcntl.h>
 #if !defined(WIN32)
+#    include <sys/mman.h>
 #    include <unistd.h>
 #else
 #    include <io.h>
@@ -167,6 +171,21 @@ MeshReader::Mesh MeshReader::loadMeshFromFile(filament::Engine* engine, const ut
     int fd = open(path.c_str(), O_RDONLY);
 
     size_t size = fileSize(fd);
+
+#if !defined(WIN32)
+    // Map the file instead of copying it into a heap buffer; vertex and index data is then
+    // uploaded straight from the page cache. The mapping must stay alive until the backend
+    // has consumed the buffers, which the fence below guarantees.
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data != MAP_FAILED) {
+        if (!strncmp(MAGICID, (const char*) data, 8)) {
+            mesh = loadMeshFromBuffer(engine, data, nullptr, nullptr, materials);
+        }
+
+        Fence::waitAndDestroy(engine->createFence());
+        munmap(data, size);
+    }
+#else
     char* data = (char*) malloc(size);
     read(fd, data, size);
 
@@ -182,6 +201,7 @@ MeshReader::Mesh MeshReader::loadMeshFromFile(filament::Engine* engine, const ut
         Fence::waitAndDestroy(engine->createFence());
         free(data);
     }
+#endif
     close(fd);
 
     return mesh;
@@ -208,6 +228,12 @@ MeshReader::Mesh MeshReader::loadMeshFromBuffer(filament::Engine* engine,
     Header* header = (Header*) p;
     p += sizeof(Header);
 
+    QuantizationHeader* qheader = nullptr;
+    if (header->flags & POSITION_SNORM16) {
+        qheader = (QuantizationHeader*) p;
+        p += sizeof(QuantizationHeader);
+    }
+
     uint8_t const* vertexData = p;
     p += header->vertexSize;
 
@@ -217,6 +243,12 @@ MeshReader::Mesh MeshReader::loadMeshFromBuffer(filament::Engine* engine,
     Part* parts = (Part*) p;
     p += header->parts * sizeof(Part);
 
+    PartCone* partCones = nullptr;
+    if (header->flags & PART_CONES) {
+        partCones = (PartCone*) p;
+        p += header->parts * sizeof(PartCone);
+    }
+
     uint32_t materialCount = (uint32_t) *p;
     p += sizeof(uint32_t);
 
@@ -271,9 +303,13 @@ MeshReader::Mesh MeshReader::loadMeshFromBuffer(filament::Engine* engine,
     VertexBuffer::AttributeType uvtype = (header->flags & TEXCOORD_SNORM16) ?
             VertexBuffer::AttributeType::SHORT2 : VertexBuffer::AttributeType::HALF2;
 
+    VertexBuffer::AttributeType postype = (header->flags & POSITION_SNORM16) ?
+            VertexBuffer::AttributeType::SHORT4 : VertexBuffer::AttributeType::HALF4;
+
     vbb
-            .attribute(VertexAttribute::POSITION, 0, VertexBuffer::AttributeType::HALF4,
+            .attribute(VertexAttribute::POSITION, 0, postype,
                         header->offsetPosition, uint8_t(header->stridePosition))
+            .normalized(VertexAttribute::POSITION, header->flags & POSITION_SNORM16)
             .attribute(VertexAttribute::TANGENTS, 0, VertexBuffer::AttributeType::SHORT4,
                         header->offsetTangents, uint8_t(header->strideTangents))
             .attribute(VertexAttribute::COLOR, 0, VertexBuffer::AttributeType::UBYTE4,
@@ -360,6 +396,12 @@ MeshReader::Mesh MeshReader::loadMeshFromBuffer(filament::Engine* engine,
                 mesh.vertexBuffer, mesh.indexBuffer, parts[i].offset,
                 parts[i].minIndex, parts[i].maxIndex, parts[i].indexCount);
 
+        if (partCones) {
+            builder.boundingCone(i,
+                    partCones[i].centerRadius.xyz, partCones[i].centerRadius.w,
+                    partCones[i].axisCutoff.xyz, partCones[i].axisCutoff.w);
+        }
+
         // It may happen that there are more parts than materials
         // therefore we have to use Part::material instead of i.
         uint32_t materialIndex = parts[i].material;
@@ -381,6 +423,15 @@ MeshReader::Mesh MeshReader::loadMeshFromBuffer(filament::Engine* engine,
     }
     builder.build(*engine, mesh.renderable);
 
+    // Quantized positions (and the AABBs stored in the file) live in a normalized space;
+    // attach the dequantization transform so the renderable appears in object space. Callers
+    // that want to place the mesh should parent it rather than overwrite this transform.
+    if (qheader) {
+        auto& tcm = engine->getTransformManager();
+        tcm.create(mesh.renderable, {},
+                mat4f::translation(qheader->offset) * mat4f::scaling(qheader->scale));
+    }
+
     return mesh;
 }
 
@@ -94,6 +94,30 @@ public:
     size_t operator()(float* UTILS_RESTRICT target, void const* UTILS_RESTRICT source,
             size_t count) const noexcept;
 
+    /**
+     * Describes one attribute within an interleaved vertex buffer.
+     */
+    struct InterleavedAttribute {
+        Config config;              //!< inputStrideBytes is the stride of the interleaved buffer
+        uint32_t sourceOffsetBytes; //!< offset of this attribute within a vertex
+        float* target;              //!< client owned area receiving the tightly packed floats
+    };
+
+    /**
+     * Converts several attributes of an interleaved vertex buffer in one pass.
+     *
+     * Equivalent to invoking one Transcoder per attribute, but walks the source buffer in
+     * cache-sized blocks so that each block of vertices is pulled from memory only once,
+     * regardless of the number of attributes being extracted.
+     *
+     * @param attributes Description of each attribute and its destination
+     * @param attributeCount Number of entries in "attributes"
+     * @param source Pointer to the first vertex of the interleaved buffer
+     * @param count Number of vertices to convert
+     */
+    static void transcodeInterleaved(InterleavedAttribute const* attributes,
+            size_t attributeCount, void const* source, size_t count) noexcept;
+
 private:
     const Config mConfig;
 };
@@ -16,6 +16,7 @@
 
 #include <geometry/SurfaceOrientation.h>
 
+#include <utils/compiler.h>
 #include <utils/Panic.h>
 #include <utils/debug.h>
 
@@ -152,18 +153,87 @@ static float3 randomPerp(const float3& n) {
     return perp / sqrlen;
 }
 
+// Number of tangent frames converted to quaternions per iteration in the loops below. Each
+// float4 in TangentFrameBatch holds the same vector component for QUAT_BATCH_SIZE vertices,
+// so every arithmetic statement in packTangentFrames() is a 4-wide operation that the
+// compiler can map to a single SIMD instruction.
+constexpr size_t QUAT_BATCH_SIZE = 4;
+
+struct TangentFrameBatch {
+    float4 tx, ty, tz;      // tangent
+    float4 bx, by, bz;      // bitangent
+    float4 nx, ny, nz;      // normal
+    void set(size_t lane, float3 t, float3 b, float3 n) noexcept {
+        tx[lane] = t.x; ty[lane] = t.y; tz[lane] = t.z;
+        bx[lane] = b.x; by[lane] = b.y; bz[lane] = b.z;
+        nx[lane] = n.x; ny[lane] = n.y; nz[lane] = n.z;
+    }
+};
+
+// Batched equivalent of mat3f::packTangentFrame(). The quaternion extraction for the common
+// positive-trace case is computed four vertices at a time; lanes that hit the negative-trace
+// case (a rotation of more than ~120 degrees, whose greatest-diagonal search is inherently
+// branchy) fall back to the exact scalar routine. Results are identical either way.
+static void packTangentFrames(const TangentFrameBatch& f, quatf* out, size_t count) {
+    // Like the scalar routine, extract the quaternion from {t, cross(n, t), n}; the supplied
+    // bitangent only participates in the reflection test at the end.
+    const float4 cx = f.ny * f.tz - f.nz * f.ty;
+    const float4 cy = f.nz * f.tx - f.nx * f.tz;
+    const float4 cz = f.nx * f.ty - f.ny * f.tx;
+    const float4 trace = f.tx + cy + f.nz;
+    const float4 s = sqrt(max(float4{0.0f}, trace + 1.0f));
+    const float4 r = 0.5f / s;
+    const float4 qx = (cz - f.ny) * r;
+    const float4 qy = (f.nx - f.tz) * r;
+    const float4 qz = (f.ty - cx) * r;
+    const float4 qw = 0.5f * s;
+    const float4 len = sqrt(qx * qx + qy * qy + qz * qz + qw * qw);
+
+    // If there's a reflection, dot(cross(t, n), b) is negative, i.e. this dot is positive.
+    const float4 reflect = cx * f.bx + cy * f.by + cz * f.bz;
+
+    // Bias is 2^(nb_bits - 1) - 1, see mat3f::packTangentFrame().
+    constexpr float bias = 1.0f / float((1 << (sizeof(int16_t) * CHAR_BIT - 1)) - 1);
+    for (size_t lane = 0; lane < count; ++lane) {
+        if (UTILS_UNLIKELY(trace[lane] <= 0.0f)) {
+            out[lane] = mat3f::packTangentFrame({
+                    float3{ f.tx[lane], f.ty[lane], f.tz[lane] },
+                    float3{ f.bx[lane], f.by[lane], f.bz[lane] },
+                    float3{ f.nx[lane], f.ny[lane], f.nz[lane] }});
+            continue;
+        }
+        quatf q(qw[lane] / len[lane], qx[lane] / len[lane],
+                qy[lane] / len[lane], qz[lane] / len[lane]);
+        q = positive(q);
+        if (q.w < bias) {
+            q.w = bias;
+            const float factor = (float) (std::sqrt(1.0 - (double) bias * (double) bias));
+            q.xyz *= factor;
+        }
+        if (reflect[lane] > 0.0f) {
+            q = -q;
+        }
+        out[lane] = q;
+    }
+}
+
 SurfaceOrientation* OrientationBuilderImpl::buildWithNormalsOnly() {
     vector<quatf> quats(vertexCount);
 
     const float3* normal = this->normals;
     size_t nstride = this->normalStride ? this->normalStride : sizeof(float3);
 
-    for (size_t qindex = 0; qindex < vertexCount; ++qindex) {
-        float3 n = *normal;
-        float3 b = randomPerp(n);
-        float3 t = cross(n, b);
-        quats[qindex] = mat3f::packTangentFrame({t, b, n});
-        normal = (const float3*) (((const uint8_t*) normal) + nstride);
+    for (size_t qindex = 0; qindex < vertexCount; qindex += QUAT_BATCH_SIZE) {
+        const size_t count = std::min(vertexCount - qindex, QUAT_BATCH_SIZE);
+        TangentFrameBatch batch{};
+        for (size_t lane = 0; lane < count; ++lane) {
+            float3 n = *normal;
+            float3 b = randomPerp(n);
+            float3 t = cross(n, b);
+            batch.set(lane, t, b, n);
+            normal = (const float3*) (((const uint8_t*) normal) + nstride);
+        }
+        packTangentFrames(batch, &quats[qindex], count);
     }
 
     return new SurfaceOrientation(new OrientationImpl( { std::move(quats) } ));
@@ -179,21 +249,26 @@ SurfaceOrientation* OrientationBuilderImpl::buildWithSuppliedTangents() {
     const float* tandir = &this->tangents->w;
     size_t tstride = this->tangentStride ? this->tangentStride : sizeof(float4);
 
-    for (size_t qindex = 0; qindex < vertexCount; ++qindex) {
-        float3 n = *normal;
-        float3 t = *tanvec;
-        float3 b = *tandir > 0 ? cross(t, n) : cross(n, t);
-
-        // Some assets do not provide perfectly orthogonal tangents and normals, so we adjust the
-        // tangent to enforce orthonormality. We would rather honor the exact normal vector than
-        // the exact tangent vector since the latter is only used for bump mapping and anisotropic
-        // lighting.
-        t = *tandir > 0 ? cross(n, b) : cross(b, n);
-
-        quats[qindex] = mat3f::packTangentFrame({t, b, n});
-        normal = (const float3*) (((const uint8_t*) normal) + nstride);
-        tanvec = (const float3*) (((const uint8_t*) tanvec) + tstride);
-        tandir = (const float*) (((const uint8_t*) tandir) + tstride);
+    for (size_t qindex = 0; qindex < vertexCount; qindex += QUAT_BATCH_SIZE) {
+        const size_t count = std::min(vertexCount - qindex, QUAT_BATCH_SIZE);
+        TangentFrameBatch batch{};
+        for (size_t lane = 0; lane < count; ++lane) {
+            float3 n = *normal;
+            float3 t = *tanvec;
+            float3 b = *tandir > 0 ? cross(t, n) : cross(n, t);
+
+            // Some assets do not provide perfectly orthogonal tangents and normals, so we adjust
+            // the tangent to enforce orthonormality. We would rather honor the exact normal vector
+            // than the exact tangent vector since the latter is only used for bump mapping and
+            // anisotropic lighting.
+            t = *tandir > 0 ? cross(n, b) : cross(b, n);
+
+            batch.set(lane, t, b, n);
+            normal = (const float3*) (((const uint8_t*) normal) + nstride);
+            tanvec = (const float3*) (((const uint8_t*) tanvec) + tstride);
+            tandir = (const float*) (((const uint8_t*) tandir) + tstride);
+        }
+        packTangentFrames(batch, &quats[qindex], count);
     }
 
     return new SurfaceOrientation(new OrientationImpl( { std::move(quats) } ));
@@ -268,19 +343,24 @@ SurfaceOrientation* OrientationBuilderImpl::buildWithUvs() {
     }
 
     vector<quatf> quats(vertexCount);
-    for (size_t a = 0; a < vertexCount; a++) {
-        const float3& n = normals[a];
-        const float3& t1 = tan1[a];
-        const float3& t2 = tan2[a];
-
-        // Gram-Schmidt orthogonalize
-        float3 t = normalize(t1 - n * dot(n, t1));
-
-        // Calculate handedness
-        float w = (dot(cross(n, t1), t2) < 0.0f) ? -1.0f : 1.0f;
-
-        float3 b = w < 0 ? cross(t, n) : cross(n, t);
-        quats[a] = mat3f::packTangentFrame({t, b, n});
+    for (size_t a = 0; a < vertexCount; a += QUAT_BATCH_SIZE) {
+        const size_t count = std::min(vertexCount - a, QUAT_BATCH_SIZE);
+        TangentFrameBatch batch{};
+        for (size_t lane = 0; lane < count; ++lane) {
+            const float3& n = normals[a + lane];
+            const float3& t1 = tan1[a + lane];
+            const float3& t2 = tan2[a + lane];
+
+            // Gram-Schmidt orthogonalize
+            float3 t = normalize(t1 - n * dot(n, t1));
+
+            // Calculate handedness
+            float w = (dot(cross(n, t1), t2) < 0.0f) ? -1.0f : 1.0f;
+
+            float3 b = w < 0 ? cross(t, n) : cross(n, t);
+            batch.set(lane, t, b, n);
+        }
+        packTangentFrames(batch, &quats[a], count);
     }
     return new SurfaceOrientation(new OrientationImpl( { std::move(quats) } ));
 }
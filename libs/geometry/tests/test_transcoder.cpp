@@ -124,6 +124,58 @@ TEST_F(TranscoderTest, NonNormalized) {
     ASSERT_EQ(result[1], 1.0f);
 }
 
+TEST_F(TranscoderTest, Interleaved) {
+    float bytesBatch[count * 4];
+    float shortsBatch[count * 3];
+    float halfBatch[count * 1];
+
+    const Transcoder::InterleavedAttribute attributes[] = {
+        {
+            .config = {
+                .componentType = ComponentType::UBYTE,
+                .normalized = true,
+                .componentCount = 4u,
+                .inputStrideBytes = sizeof(Vertex)
+            },
+            .sourceOffsetBytes = 0u,
+            .target = bytesBatch
+        },
+        {
+            .config = {
+                .componentType = ComponentType::USHORT,
+                .normalized = true,
+                .componentCount = 3u,
+                .inputStrideBytes = sizeof(Vertex)
+            },
+            .sourceOffsetBytes = 4u,
+            .target = shortsBatch
+        },
+        {
+            .config = {
+                .componentType = ComponentType::HALF,
+                .normalized = false,
+                .componentCount = 1u,
+                .inputStrideBytes = sizeof(Vertex)
+            },
+            .sourceOffsetBytes = 10u,
+            .target = halfBatch
+        },
+    };
+
+    Transcoder::transcodeInterleaved(attributes, 3, vbuffer, count);
+
+    // The batch API must produce the exact same results as one Transcoder per attribute.
+    char const* srcBytes = (char const*) vbuffer;
+    float expected[count * 4];
+    for (const auto& attribute : attributes) {
+        Transcoder transcode(attribute.config);
+        transcode(expected, srcBytes + attribute.sourceOffsetBytes, count);
+        for (size_t i = 0; i < count * attribute.config.componentCount; ++i) {
+            ASSERT_EQ(attribute.target[i], expected[i]);
+        }
+    }
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -60,6 +60,12 @@ struct AssetConfiguration {
 
     //! Optional default node name for anonymous nodes
     char* defaultNodeName = nullptr;
+
+    //! Narrows float32 texture coordinates to half precision when the accessor's min/max bounds
+    //! show that the data is representable in 16 bits, halving UV memory and vertex fetch
+    //! bandwidth. Accessors without bounds are left at full precision. Note that normals and
+    //! tangents are always packed into snorm16 quaternions, regardless of this setting.
+    bool quantizeAttributes = false;
 };
 
 /**
@@ -154,13 +160,45 @@ public:
      */
     FilamentAsset* createAssetFromBinary(const uint8_t* bytes, uint32_t nbytes);
 
+    /**
+     * Takes the path to a GLB or JSON-based glTF 2.0 file and returns a bundle of Filament
+     * objects. Returns null on failure.
+     *
+     * Unlike createAssetFromBinary(), this does not make a heap copy of the file: where the
+     * platform supports it, the file is memory-mapped and buffer views are sourced directly
+     * from the mapping for vertex / index / texture upload. The mapping is released together
+     * with the rest of the source data (see FilamentAsset::releaseSourceData) once all
+     * uploads have completed. On platforms without memory mapping the file is read into a
+     * single heap block instead.
+     */
+    FilamentAsset* createAssetFromFile(const char* path);
+
+    /**
+     * Creates assets from several GLB or JSON-based glTF 2.0 files at once.
+     *
+     * The files are read and parsed concurrently on the engine's JobSystem -- the calling
+     * thread participates, so it must be adopted by the JobSystem (the main thread always
+     * is). Engine object creation is serialized on the calling thread, but starts as soon
+     * as the first parse completes, overlapping with the remaining parses. With many files
+     * this is substantially faster than calling createAssetFromFile() in a loop, where
+     * each parse is serialized behind the previous file's instantiation.
+     *
+     * Each created asset behaves exactly as if it came from createAssetFromFile().
+     * assets[i] receives the asset created from paths[i], or null if that file could not
+     * be loaded; returns the number of assets successfully created.
+     */
+    size_t createAssetsFromFiles(const char* const* paths, size_t count,
+            FilamentAsset** assets);
+
     /**
      * Consumes the contents of a glTF 2.0 file and produces a primary asset with one or more
      * instances. The primary asset has ownership over the instances.
      *
      * The returned instances share their textures, material instances, and vertex buffers with the
-     * primary asset. However each instance has its own unique set of entities, transform
-     * components, and renderable components. Instances are freed when the primary asset is freed.
+     * primary asset. Skinned instances also share a single pooled SkinningBuffer, with each
+     * instance's bones occupying a distinct region of it. However each instance has its own unique
+     * set of entities, transform components, and renderable components. Instances are freed when
+     * the primary asset is freed.
      *
      * Light components are not instanced, they belong only to the primary asset.
      *
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GLTFIO_MATERIALARCHIVE_H
+#define GLTFIO_MATERIALARCHIVE_H
+
+#include <gltfio/MaterialProvider.h>
+
+#include <utils/compiler.h>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gltfio {
+
+/**
+ * \file MaterialArchive.h
+ * \brief Indexed container of precompiled glTF materials.
+ *
+ * A material archive is a flat binary blob that packages a set of precompiled material
+ * packages (the same format that matc produces), indexed by MaterialKey. It is designed to
+ * be consumed in place: clients typically memory-map an archive file and hand the mapping
+ * directly to createArchiveLoader(), which resolves a requested feature set to a package
+ * with a single hash lookup and no parsing. This combines the fast startup of the
+ * ubershader path with the streamlined shaders of the generator path, at the cost of
+ * building the archive ahead of time (see buildMaterialArchive).
+ *
+ * Layout, with all multi-byte fields in host byte order:
+ *
+ *     MaterialArchiveHeader
+ *     MaterialArchiveEntry x header.entryCount, sorted by nothing in particular
+ *     payload: concatenated material packages, each 8-byte aligned
+ */
+
+/**
+ * \struct MaterialArchiveHeader MaterialArchive.h gltfio/MaterialArchive.h
+ * \brief Fixed-size header at the front of a material archive.
+ */
+struct MaterialArchiveHeader {
+    static constexpr uint32_t MAGIC = 'G' | ('M' << 8) | ('A' << 16) | ('T' << 24);
+    static constexpr uint32_t VERSION = 1;
+
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(MaterialArchiveHeader) == 16, "MaterialArchiveHeader has unexpected padding.");
+
+/**
+ * \struct MaterialArchiveEntry MaterialArchive.h gltfio/MaterialArchive.h
+ * \brief Index record that maps one material requirement set to its precompiled package.
+ */
+struct MaterialArchiveEntry {
+    //! Requirements that the package satisfies, after constrainMaterial() has been applied.
+    MaterialKey key;
+
+    //! Byte offset of the material package, relative to the start of the archive.
+    uint32_t offset;
+
+    //! Size of the material package in bytes.
+    uint32_t size;
+};
+
+static_assert(sizeof(MaterialArchiveEntry) == 24, "MaterialArchiveEntry has unexpected padding.");
+
+/**
+ * Creates a material provider that serves precompiled materials from the given archive.
+ *
+ * The archive memory is borrowed, not copied; it must remain valid (e.g. keep the file
+ * mapped) for the lifetime of the provider. Materials are created lazily, the first time a
+ * given configuration is requested. Requesting a configuration that the archive does not
+ * cover logs a warning and returns a null material instance.
+ *
+ * @param engine Lazily creates the filament::Material objects from the archived packages.
+ * @param archiveData Pointer to the first byte of the archive (typically a file mapping).
+ * @param archiveSize Total size of the archive in bytes.
+ * @return New material provider, or null if the archive fails validation.
+ *
+ * Does not require \c libfilamat; available in \c libgltfio_core.
+ *
+ * @see buildMaterialArchive
+ * @see createUbershaderLoader
+ */
+UTILS_PUBLIC
+MaterialProvider* createArchiveLoader(filament::Engine* engine, const void* archiveData,
+        size_t archiveSize);
+
+/**
+ * Compiles materials for the given requirement sets and serializes them into an archive.
+ *
+ * Each requirement set is constrained the same way createMaterialGenerator() would constrain
+ * it (see constrainMaterial), then duplicates are folded away, so it is fine to pass the raw
+ * keys harvested from one or more assets. Compilation is synchronous and can take a long
+ * time for large feature matrices; this is meant to run offline or during a packaging step,
+ * with the resulting blob written to disk for later consumption via createArchiveLoader().
+ *
+ * @param engine Supplies the target backend and the job system used for compilation.
+ * @param requirements Array of requirement sets to compile, one material per unique set.
+ * @param count Number of elements in the requirements array.
+ * @param archiveData Receives a malloc'd archive blob; the caller must release it with free().
+ * @param optimizeShaders Optimizes shaders, but at significant cost to construction time.
+ * @return Size of the archive in bytes, or 0 on failure.
+ *
+ * Requires \c libfilamat to be linked in. Not available in \c libgltfio_core.
+ *
+ * @see createArchiveLoader
+ */
+UTILS_PUBLIC
+size_t buildMaterialArchive(filament::Engine* engine, const MaterialKey* requirements,
+        size_t count, void** archiveData, bool optimizeShaders = true);
+
+} // namespace gltfio
+
+#endif // GLTFIO_MATERIALARCHIVE_H
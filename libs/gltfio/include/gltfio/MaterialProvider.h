@@ -165,6 +165,33 @@ public:
     virtual bool needsDummyData(filament::VertexAttribute attrib) const noexcept = 0;
 };
 
+/**
+ * \class HybridMaterialProvider MaterialProvider.h gltfio/MaterialProvider.h
+ * \brief Material provider that combines ubershaders with on-demand specialization.
+ *
+ * Material instances are initially created from the precompiled ubershaders, so assets can be
+ * displayed immediately. Clients then call specializeMaterials() (e.g. once per frame, or from a
+ * loading screen) to compile streamlined materials for the requested configurations a few at a
+ * time. Once a configuration has been specialized, material instances that are subsequently
+ * created for it (new assets or new instances) use the specialized material rather than the
+ * ubershader.
+ *
+ * Note that material instances that were handed out before specialization keep their ubershader;
+ * this version of Filament has no way to migrate parameter values between unrelated materials.
+ */
+class UTILS_PUBLIC HybridMaterialProvider : public MaterialProvider {
+public:
+    /**
+     * Compiles specialized materials for up to maxCount pending material configurations.
+     *
+     * Compilation happens synchronously on the calling thread, so use maxCount to bound the
+     * time spent per call.
+     *
+     * @return The number of configurations that are still waiting to be specialized.
+     */
+    virtual size_t specializeMaterials(size_t maxCount = 1) = 0;
+};
+
 void constrainMaterial(MaterialKey* key, UvMap* uvmap);
 
 void processShaderString(std::string* shader, const UvMap& uvmap,
@@ -195,6 +222,23 @@ MaterialProvider* createMaterialGenerator(filament::Engine* engine, bool optimiz
 UTILS_PUBLIC
 MaterialProvider* createUbershaderLoader(filament::Engine* engine);
 
+/**
+ * Creates a material provider that starts out serving ubershaders and gradually specializes.
+ *
+ * @param optimizeShaders Optimizes the specialized shaders, at significant cost to compile time.
+ * @return New hybrid material provider.
+ *
+ * Requires \c libfilamat and \c libgltfio_resources to be linked in. Not available in
+ * \c libgltfio_core.
+ *
+ * @see HybridMaterialProvider
+ * @see createMaterialGenerator
+ * @see createUbershaderLoader
+ */
+UTILS_PUBLIC
+HybridMaterialProvider* createHybridProvider(filament::Engine* engine,
+        bool optimizeShaders = false);
+
 } // namespace gltfio
 
 #endif // GLTFIO_MATERIALPROVIDER_H
@@ -53,9 +53,23 @@ struct ResourceConfiguration {
     //! do not need this, but it is useful for robustness.
     bool recomputeBoundingBoxes;
 
-    //! If true, ignore skinned primitives bind transform when compute bounding box. Implicitly true 
+    //! If true, ignore skinned primitives bind transform when compute bounding box. Implicitly true
     //! for instanced asset. Only applicable when recomputeBoundingBoxes is set to true
     bool ignoreBindTransform;
+
+    //! If true, triangle index buffers are reordered at load time for post-transform vertex
+    //! cache locality (see geometry::optimizeVertexCache). The set of triangles is unchanged
+    //! so this is transparent to the rest of the pipeline, but meshes that were not optimized
+    //! offline shade fewer vertices. Adds a small CPU cost per index buffer during loadResources.
+    bool optimizeIndexBuffers;
+
+    //! Optional path to a folder used as an on-disk texture transcode cache. When set, decoded
+    //! and mip-mapped texel blobs are stored in this folder, keyed by a hash of the source
+    //! image, and are checked before decoding; subsequent loads of the same images then skip
+    //! PNG / JPEG decoding and mipmap generation entirely. The folder must already exist and is
+    //! never pruned by the loader. The string pointer is not retained. Ignored on platforms
+    //! without a filesystem.
+    const char* textureCacheFolder;
 };
 
 /**
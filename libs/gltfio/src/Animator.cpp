@@ -23,6 +23,7 @@
 
 #include <filament/MaterialEnums.h>
 #include <filament/RenderableManager.h>
+#include <filament/SkinningBuffer.h>
 #include <filament/TransformManager.h>
 
 #include <utils/Log.h>
@@ -33,8 +34,9 @@
 #include <math/vec3.h>
 #include <math/vec4.h>
 
-#include <map>
+#include <algorithm>
 #include <string>
+#include <utility>
 #include <vector>
 
 using namespace filament;
@@ -44,12 +46,14 @@ using namespace utils;
 
 namespace gltfio {
 
-using TimeValues = map<float, size_t>;
 using SourceValues = vector<float>;
 using BoneVector = vector<filament::math::mat4f>;
 
 struct Sampler {
-    TimeValues times;
+    // Keyframe times (sorted, ascending) and the original keyframe index for each of them,
+    // kept as two parallel arrays so that cursor searches walk contiguous memory.
+    vector<float> times;
+    vector<size_t> indices;
     SourceValues values;
     enum { LINEAR, STEP, CUBIC } interpolation;
 };
@@ -58,6 +62,10 @@ struct Channel {
     const Sampler* sourceData;
     Entity targetEntity;
     enum { TRANSLATION, ROTATION, SCALE, WEIGHTS } transformType;
+
+    // Keyframe position left by the previous applyAnimation() call; playback time usually
+    // moves forward by a small amount, so the next search starts here.
+    size_t cursor = 0;
 };
 
 struct Animation {
@@ -80,13 +88,32 @@ struct AnimatorImpl {
 };
 
 static void createSampler(const cgltf_animation_sampler& src, Sampler& dst) {
-    // Copy the time values into a red-black tree.
+    // Copy the time values into sorted parallel arrays. Source timelines are almost always
+    // already sorted and unique, but the spec does not guarantee it, so sort and de-duplicate
+    // here (keeping the last keyframe when several share the same time).
     const cgltf_accessor* timelineAccessor = src.input;
     const uint8_t* timelineBlob = (const uint8_t*) timelineAccessor->buffer_view->buffer->data;
     const float* timelineFloats = (const float*) (timelineBlob + timelineAccessor->offset +
             timelineAccessor->buffer_view->offset);
-    for (size_t i = 0, len = timelineAccessor->count; i < len; ++i) {
-        dst.times[timelineFloats[i]] = i;
+    const size_t len = timelineAccessor->count;
+    vector<pair<float, size_t>> sortedTimes;
+    sortedTimes.reserve(len);
+    for (size_t i = 0; i < len; ++i) {
+        sortedTimes.emplace_back(timelineFloats[i], i);
+    }
+    std::stable_sort(sortedTimes.begin(), sortedTimes.end(),
+            [](const pair<float, size_t>& a, const pair<float, size_t>& b) {
+                return a.first < b.first;
+            });
+    dst.times.reserve(len);
+    dst.indices.reserve(len);
+    for (const auto& pair : sortedTimes) {
+        if (!dst.times.empty() && dst.times.back() == pair.first) {
+            dst.indices.back() = pair.second;
+        } else {
+            dst.times.push_back(pair.first);
+            dst.indices.push_back(pair.second);
+        }
     }
 
     // Convert source data to float.
@@ -203,8 +230,7 @@ Animator::Animator(FFilamentAsset* asset, FFilamentInstance* instance) {
             Sampler& dstSampler = dstAnim.samplers[j];
             createSampler(srcSampler, dstSampler);
             if (dstSampler.times.size() > 1) {
-                float maxtime = (--dstSampler.times.end())->first;
-                dstAnim.duration = std::max(dstAnim.duration, maxtime);
+                dstAnim.duration = std::max(dstAnim.duration, dstSampler.times.back());
             }
         }
 
@@ -239,38 +265,56 @@ size_t Animator::getAnimationCount() const {
     return mImpl->animations.size();
 }
 
+// Returns the position of the first keyframe whose time is greater than or equal to the given
+// time, like std::lower_bound, but starts the search at the given cursor position. Playback
+// time normally advances by a fraction of a keyframe interval per call, so this is O(1) in
+// practice; a backward seek (e.g. when the animation loops) degrades to a linear walk.
+static size_t findKeyframe(const vector<float>& times, float time, size_t cursor) {
+    const size_t n = times.size();
+    cursor = std::min(cursor, n);
+    while (cursor > 0 && times[cursor - 1] >= time) {
+        --cursor;
+    }
+    while (cursor < n && times[cursor] < time) {
+        ++cursor;
+    }
+    return cursor;
+}
+
 void Animator::applyAnimation(size_t animationIndex, float time) const {
-    const Animation& anim = mImpl->animations[animationIndex];
+    Animation& anim = mImpl->animations[animationIndex];
     TransformManager* transformManager = mImpl->transformManager;
-    RenderableManager* renderableManager = mImpl->renderableManager;
     time = fmod(time, anim.duration);
-    for (const auto& channel : anim.channels) {
+
+    // Batch all the transform writes into a single transaction so that world transforms are
+    // recomputed once, after every channel has been applied.
+    transformManager->openLocalTransformTransaction();
+    for (auto& channel : anim.channels) {
         const Sampler* sampler = channel.sourceData;
-        if (sampler->times.size() < 2) {
+        const vector<float>& times = sampler->times;
+        if (times.size() < 2) {
             continue;
         }
 
-        const TimeValues& times = sampler->times;
-
         // Find the first keyframe after the given time, or the keyframe that matches it exactly.
-        TimeValues::const_iterator iter = times.lower_bound(time);
+        const size_t pos = findKeyframe(times, time, channel.cursor);
+        channel.cursor = pos;
 
         // Compute the interpolant (between 0 and 1) and determine the keyframe pair.
         float t = 0.0f;
         size_t nextIndex;
         size_t prevIndex;
-        if (iter == times.end()) {
+        if (pos == times.size()) {
             nextIndex = times.size() - 1;
             prevIndex = nextIndex;
-        } else if (iter == times.begin()) {
+        } else if (pos == 0) {
             nextIndex = 0;
             prevIndex = 0;
         } else {
-            TimeValues::const_iterator prev = iter; --prev;
-            nextIndex = iter->second;
-            prevIndex = prev->second;
-            const float nextTime = iter->first;
-            const float prevTime = prev->first;
+            nextIndex = sampler->indices[pos];
+            prevIndex = sampler->indices[pos - 1];
+            const float nextTime = times[pos];
+            const float prevTime = times[pos - 1];
             float deltaTime = nextTime - prevTime;
             assert(deltaTime >= 0);
             if (deltaTime > 0) {
@@ -284,17 +328,24 @@ void Animator::applyAnimation(size_t animationIndex, float time) const {
 
         mImpl->applyAnimation(channel, t, prevIndex, nextIndex);
     }
+    transformManager->commitLocalTransformTransaction();
 }
 
 void Animator::updateBoneMatrices() {
     auto renderableManager = mImpl->renderableManager;
     auto transformManager = mImpl->transformManager;
+    FFilamentAsset* asset = mImpl->asset;
+    SkinningBuffer* const skinningBuffer = asset->mSkinningBuffer;
 
-    auto update = [=](const SkinVector& skins, BoneVector& boneVector) {
+    // The poolBase argument is the offset of the instance's bone pool in the asset's shared
+    // SkinningBuffer, or SIZE_MAX for instances using classic per-renderable bones.
+    auto update = [=](const SkinVector& skins, BoneVector& boneVector, size_t poolBase) {
         for (const auto& skin : skins) {
             size_t njoints = skin.joints.size();
             boneVector.resize(njoints);
-            for (const auto& entity : skin.targets) {
+            for (size_t targetIndex = 0, targetCount = skin.targets.size();
+                    targetIndex < targetCount; ++targetIndex) {
+                const Entity entity = skin.targets[targetIndex];
                 auto renderable = renderableManager->getInstance(entity);
                 if (!renderable) {
                     continue;
@@ -313,18 +364,23 @@ void Animator::updateBoneMatrices() {
                             globalJointTransform *
                             skin.inverseBindMatrices[boneIndex];
                 }
-                renderableManager->setBones(renderable, boneVector.data(), boneVector.size());
+                if (poolBase != SIZE_MAX) {
+                    skinningBuffer->setBones(*asset->mEngine, boneVector.data(), njoints,
+                            poolBase + skin.boneOffsets[targetIndex]);
+                } else {
+                    renderableManager->setBones(renderable, boneVector.data(), boneVector.size());
+                }
             }
         }
     };
 
     if (mImpl->instance) {
-        update(mImpl->instance->skins, mImpl->boneMatrices);
-    } else if (!mImpl->asset->isInstanced()) {
-        update(mImpl->asset->mSkins, mImpl->boneMatrices);
+        update(mImpl->instance->skins, mImpl->boneMatrices, mImpl->instance->skinningBufferBase);
+    } else if (!asset->isInstanced()) {
+        update(asset->mSkins, mImpl->boneMatrices, SIZE_MAX);
     } else {
-        for (FFilamentInstance* instance : mImpl->asset->mInstances) {
-            update(instance->skins, mImpl->boneMatrices);
+        for (FFilamentInstance* instance : asset->mInstances) {
+            update(instance->skins, mImpl->boneMatrices, instance->skinningBufferBase);
         }
     }
 }
@@ -372,7 +428,7 @@ void AnimatorImpl::addChannels(const NodeMap& nodeMap, const cgltf_animation& sr
 void AnimatorImpl::applyAnimation(const Channel& channel, float t, size_t prevIndex,
         size_t nextIndex) {
     const Sampler* sampler = channel.sourceData;
-    const TimeValues& times = sampler->times;
+    const vector<float>& times = sampler->times;
     TransformManager::Instance node = transformManager->getInstance(channel.targetEntity);
 
     // Perform the interpolation. This is a simple but inefficient implementation; Filament
@@ -31,6 +31,7 @@
 #include <filament/MorphTargetBuffer.h>
 #include <filament/RenderableManager.h>
 #include <filament/Scene.h>
+#include <filament/SkinningBuffer.h>
 #include <filament/TextureSampler.h>
 #include <filament/TransformManager.h>
 #include <filament/VertexBuffer.h>
@@ -41,6 +42,7 @@
 
 #include <utils/EntityManager.h>
 #include <utils/FixedCapacityVector.h>
+#include <utils/JobSystem.h>
 #include <utils/Log.h>
 #include <utils/Panic.h>
 #include <utils/NameComponentManager.h>
@@ -51,6 +53,15 @@
 #define CGLTF_IMPLEMENTATION
 #include <cgltf.h>
 
+#if GLTFIO_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <cstdio>
+#endif
+
 #include "math.h"
 #include "upcast.h"
 
@@ -64,6 +75,17 @@ void importSkins(const cgltf_data* gltf, const NodeMap& nodeMap, SkinVector& dst
 
 static const auto FREE_CALLBACK = [](void* mem, size_t, void*) { free(mem); };
 
+// Routes all cgltf allocations for a parse through a fresh per-asset arena. Ownership of the
+// arena is transferred to the asset's source data once the parse succeeds, so that the whole
+// hierarchy is released in one shot instead of free() by free().
+static std::unique_ptr<LoadArena> attachArena(cgltf_options& options) {
+    auto arena = std::make_unique<LoadArena>();
+    options.memory.alloc = LoadArena::cgltfAlloc;
+    options.memory.free = LoadArena::cgltfFree;
+    options.memory.user_data = arena.get();
+    return arena;
+}
+
 // Sometimes a glTF bufferview includes unused data at the end (e.g. in skinning.gltf) so we need to
 // compute the correct size of the vertex buffer. Filament automatically infers the size of
 // driver-level vertex buffers from the attribute data (stride, count, offset) and clients are
@@ -87,6 +109,32 @@ static const char* getNodeName(const cgltf_node* node, const char* defaultNodeNa
     return defaultNodeName;
 }
 
+// Everything produced by reading and parsing one file, before any Engine object exists.
+// Produced on any thread (cgltf_parse is thread-safe per document and each parse gets its
+// own arena); consumed on the loader's thread by createAsset().
+struct ParsedFile {
+    cgltf_data* sourceAsset = nullptr;
+    std::unique_ptr<LoadArena> arena;
+#if GLTFIO_USE_MMAP
+    void* mappedData = nullptr;
+    size_t mappedSize = 0;
+    ~ParsedFile() {
+        if (mappedData) {
+            munmap(mappedData, mappedSize);
+        }
+    }
+#else
+    utils::FixedCapacityVector<uint8_t> glbdata;
+#endif
+    ParsedFile() = default;
+    ParsedFile(ParsedFile const&) = delete;
+    ParsedFile& operator=(ParsedFile const&) = delete;
+};
+
+// reads and parses one GLB or JSON-based glTF file; returns false (with sourceAsset left
+// null) if the file could not be read or parsed
+static bool parseFile(const char* path, ParsedFile& out);
+
 struct FAssetLoader : public AssetLoader {
     FAssetLoader(const AssetConfiguration& config) :
             mEntityManager(config.entities ? *config.entities : EntityManager::get()),
@@ -95,10 +143,14 @@ struct FAssetLoader : public AssetLoader {
             mTransformManager(config.engine->getTransformManager()),
             mMaterials(config.materials),
             mEngine(config.engine),
+            mQuantizeAttributes(config.quantizeAttributes),
             mDefaultNodeName(config.defaultNodeName) {}
 
     FFilamentAsset* createAssetFromJson(const uint8_t* bytes, uint32_t nbytes);
     FFilamentAsset* createAssetFromBinary(const uint8_t* bytes, uint32_t nbytes);
+    FFilamentAsset* createAssetFromFile(const char* path);
+    size_t createAssetsFromFiles(const char* const* paths, size_t count,
+            FilamentAsset** assets);
     FFilamentAsset* createInstancedAsset(const uint8_t* bytes, uint32_t numBytes,
         FilamentInstance** instances, size_t numInstances);
     FilamentInstance* createInstance(FFilamentAsset* primary);
@@ -125,12 +177,14 @@ struct FAssetLoader : public AssetLoader {
     }
 
     void createAsset(const cgltf_data* srcAsset, size_t numInstances);
+    // transfers a parsed file's buffers into mResult's source data; mResult must be valid
+    void adoptSourceData(ParsedFile& parsed) noexcept;
     FFilamentInstance* createInstance(FFilamentAsset* primary, const cgltf_data* srcAsset,
             const cgltf_scene* scene);
     void createEntity(const cgltf_data* srcAsset, const cgltf_node* node, Entity parent,
             bool enableLight, FFilamentInstance* instance);
     void createRenderable(const cgltf_data* srcAsset, const cgltf_node* node, Entity entity,
-            const char* name);
+            const char* name, FFilamentInstance* instance);
     bool createPrimitive(const cgltf_primitive* inPrim, Primitive* outPrim, const UvMap& uvmap,
             const char* name, MaterialInstance* mi);
     void createLight(const cgltf_light* light, Entity entity);
@@ -149,6 +203,7 @@ struct FAssetLoader : public AssetLoader {
     TransformManager& mTransformManager;
     MaterialProvider* mMaterials;
     Engine* mEngine;
+    const bool mQuantizeAttributes;
 
     // Transient state used only for the asset currently being loaded:
     FFilamentAsset* mResult;
@@ -164,6 +219,7 @@ FILAMENT_UPCAST(AssetLoader)
 
 FFilamentAsset* FAssetLoader::createAssetFromJson(const uint8_t* bytes, uint32_t nbytes) {
     cgltf_options options { cgltf_file_type_invalid };
+    auto arena = attachArena(options);
     cgltf_data* sourceAsset;
     cgltf_result result = cgltf_parse(&options, bytes, nbytes, &sourceAsset);
     if (result != cgltf_result_success) {
@@ -171,6 +227,9 @@ FFilamentAsset* FAssetLoader::createAssetFromJson(const uint8_t* bytes, uint32_t
         return nullptr;
     }
     createAsset(sourceAsset, 0);
+    if (mResult) {
+        mResult->mSourceAsset->arena = std::move(arena);
+    }
     return mResult;
 }
 
@@ -187,6 +246,7 @@ FFilamentAsset* FAssetLoader::createAssetFromBinary(const uint8_t* bytes, uint32
     std::copy_n(bytes, byteCount, glbdata.data());
 
     cgltf_options options { cgltf_file_type_glb };
+    auto arena = attachArena(options);
     cgltf_data* sourceAsset;
     cgltf_result result = cgltf_parse(&options, glbdata.data(), byteCount, &sourceAsset);
     if (result != cgltf_result_success) {
@@ -196,10 +256,137 @@ FFilamentAsset* FAssetLoader::createAssetFromBinary(const uint8_t* bytes, uint32
     createAsset(sourceAsset, 0);
     if (mResult) {
         glbdata.swap(mResult->mSourceAsset->glbData);
+        mResult->mSourceAsset->arena = std::move(arena);
     }
     return mResult;
 }
 
+static bool parseFile(const char* path, ParsedFile& out) {
+#if GLTFIO_USE_MMAP
+    // Memory-map the file instead of copying it to the heap: cgltf points its buffer views
+    // straight into the mapping, so vertex / index / texture uploads read from it with no
+    // duplicate copy of the file in memory, and clean pages can be evicted under pressure.
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        slog.e << "Unable to open " << path << io::endl;
+        return false;
+    }
+    struct stat status;
+    if (fstat(fd, &status) < 0 || status.st_size == 0) {
+        slog.e << "Unable to read " << path << io::endl;
+        close(fd);
+        return false;
+    }
+    const size_t byteCount = size_t(status.st_size);
+    void* mapping = mmap(nullptr, byteCount, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);      // the mapping persists after the descriptor is closed
+    if (mapping == MAP_FAILED) {
+        slog.e << "Unable to map " << path << io::endl;
+        return false;
+    }
+    out.mappedData = mapping;   // unmapped by ~ParsedFile() unless adopted by an asset
+    out.mappedSize = byteCount;
+
+    // A default options struct asks cgltf to examine the magic identifier, so this entry point
+    // accepts both GLB and JSON-based glTF files.
+    cgltf_options options {};
+    out.arena = attachArena(options);
+    cgltf_result result = cgltf_parse(&options, mapping, byteCount, &out.sourceAsset);
+    if (result != cgltf_result_success) {
+        slog.e << "Unable to parse " << path << io::endl;
+        out.sourceAsset = nullptr;
+        return false;
+    }
+    return true;
+#else
+    // No memory mapping on this platform; read the file into a single heap block that the
+    // asset owns, which still avoids the second copy that createAssetFromBinary() makes.
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        slog.e << "Unable to open " << path << io::endl;
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    const long byteCount = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    utils::FixedCapacityVector<uint8_t> glbdata(byteCount);
+    const bool ok = byteCount > 0 && fread(glbdata.data(), byteCount, 1, file) == 1;
+    fclose(file);
+    if (!ok) {
+        slog.e << "Unable to read " << path << io::endl;
+        return false;
+    }
+
+    cgltf_options options {};
+    out.arena = attachArena(options);
+    cgltf_result result = cgltf_parse(&options, glbdata.data(), byteCount, &out.sourceAsset);
+    if (result != cgltf_result_success) {
+        slog.e << "Unable to parse " << path << io::endl;
+        out.sourceAsset = nullptr;
+        return false;
+    }
+    out.glbdata = std::move(glbdata);
+    return true;
+#endif
+}
+
+void FAssetLoader::adoptSourceData(ParsedFile& parsed) noexcept {
+    // the parsed buffers are released when the source data is, i.e. after all uploads completed
+    mResult->mSourceAsset->arena = std::move(parsed.arena);
+#if GLTFIO_USE_MMAP
+    mResult->mSourceAsset->mappedData = parsed.mappedData;
+    mResult->mSourceAsset->mappedSize = parsed.mappedSize;
+    parsed.mappedData = nullptr;
+#else
+    parsed.glbdata.swap(mResult->mSourceAsset->glbData);
+#endif
+}
+
+FFilamentAsset* FAssetLoader::createAssetFromFile(const char* path) {
+    ParsedFile parsed;
+    if (!parseFile(path, parsed)) {
+        return nullptr;
+    }
+    createAsset(parsed.sourceAsset, 0);
+    if (mResult) {
+        adoptSourceData(parsed);
+    }
+    return mResult;
+}
+
+size_t FAssetLoader::createAssetsFromFiles(const char* const* paths, size_t count,
+        FilamentAsset** assets) {
+    SYSTRACE_CALL();
+
+    // Parse every file concurrently; parsing dominates multi-file loads and each document
+    // is independent. Engine object creation is not thread-safe (and createAsset() uses
+    // transient loader state), so instantiation stays on this thread -- but it starts as
+    // soon as the first parse is done and overlaps with the remaining parses.
+    JobSystem& js = mEngine->getJobSystem();
+    std::vector<ParsedFile> parsed(count);
+    std::vector<JobSystem::Job*> parseJobs(count);
+    for (size_t i = 0; i < count; i++) {
+        parseJobs[i] = js.runAndRetain(jobs::createJob(js, nullptr,
+                [&parsed, paths, i]() { parseFile(paths[i], parsed[i]); }));
+    }
+
+    size_t created = 0;
+    for (size_t i = 0; i < count; i++) {
+        js.waitAndRelease(parseJobs[i]);
+        assets[i] = nullptr;
+        if (!parsed[i].sourceAsset) {
+            continue;
+        }
+        createAsset(parsed[i].sourceAsset, 0);
+        if (mResult) {
+            adoptSourceData(parsed[i]);
+            assets[i] = mResult;
+            created++;
+        }
+    }
+    return created;
+}
+
 FFilamentAsset* FAssetLoader::createInstancedAsset(const uint8_t* bytes, uint32_t byteCount,
         FilamentInstance** instances, size_t numInstances) {
     ASSERT_PRECONDITION(numInstances > 0, "Instance count must be 1 or more.");
@@ -207,6 +394,7 @@ FFilamentAsset* FAssetLoader::createInstancedAsset(const uint8_t* bytes, uint32_
     // This method can be used to load JSON or GLB. By using a default options struct, we are asking
     // cgltf to examine the magic identifier to determine which type of file is being loaded.
     cgltf_options options {};
+    auto arena = attachArena(options);
 
     // Clients can free up their source blob immediately, but cgltf has pointers into the data that
     // need to stay valid. Therefore we create a copy of the source blob and stash it inside the
@@ -223,6 +411,7 @@ FFilamentAsset* FAssetLoader::createInstancedAsset(const uint8_t* bytes, uint32_
     createAsset(sourceAsset, numInstances);
     if (mResult) {
         glbdata.swap(mResult->mSourceAsset->glbData);
+        mResult->mSourceAsset->arena = std::move(arena);
         std::copy_n(mResult->mInstances.data(), numInstances, instances);
     }
     return mResult;
@@ -296,6 +485,28 @@ void FAssetLoader::createAsset(const cgltf_data* srcAsset, size_t numInstances)
             createEntity(srcAsset, nodes[i], mResult->mRoot, true, nullptr);
         }
     } else {
+        // Pool the bone transforms of all instances into a single shared SkinningBuffer with
+        // per-instance offsets, rather than letting every skinned renderable allocate its own
+        // bone UBO. This cuts per-instance GPU memory down to the actual bone count. The
+        // enumeration below must match the one in importSkins(), which computes the same
+        // offsets for the animator.
+        if (srcAsset->skins_count > 0) {
+            for (cgltf_size i = 0; i < srcAsset->nodes_count; i++) {
+                const cgltf_node& node = srcAsset->nodes[i];
+                if (node.skin) {
+                    mResult->mBoneOffsets[&node] = mResult->mBonesPerInstance;
+                    mResult->mBonesPerInstance += node.skin->joints_count;
+                }
+            }
+            if (mResult->mBonesPerInstance > 0) {
+                mResult->mSkinningBuffer = SkinningBuffer::Builder()
+                        .boneCount(uint32_t(mResult->mBonesPerInstance * numInstances))
+                        .initialize()
+                        .build(*mEngine);
+                mResult->mSkinningBufferInstances = numInstances;
+            }
+        }
+
         // Create a separate entity hierarchy for each instance. Note that MeshCache (vertex
         // buffers and index buffers) and MatInstanceCache (materials and textures) help avoid
         // needless duplication of resources.
@@ -347,6 +558,13 @@ FFilamentInstance* FAssetLoader::createInstance(FFilamentAsset* primary,
     instance->owner = primary;
     primary->mInstances.push_back(instance);
 
+    // Claim a region of the shared SkinningBuffer if there is room left; dynamically added
+    // instances beyond the initial count fall back to classic per-renderable bones.
+    const size_t instanceIndex = primary->mInstances.size() - 1;
+    if (primary->mSkinningBuffer && instanceIndex < primary->mSkinningBufferInstances) {
+        instance->skinningBufferBase = instanceIndex * primary->mBonesPerInstance;
+    }
+
     // For each scene root, recursively create all entities.
     for (cgltf_size i = 0, len = scene->nodes_count; i < len; ++i) {
         cgltf_node** nodes = scene->nodes;
@@ -405,7 +623,7 @@ void FAssetLoader::createEntity(const cgltf_data* srcAsset, const cgltf_node* no
 
     // If the node has a mesh, then create a renderable component.
     if (node->mesh) {
-        createRenderable(srcAsset, node, entity, name);
+        createRenderable(srcAsset, node, entity, name, instance);
     }
 
     if (node->light && enableLight) {
@@ -422,7 +640,7 @@ void FAssetLoader::createEntity(const cgltf_data* srcAsset, const cgltf_node* no
 }
 
 void FAssetLoader::createRenderable(const cgltf_data* srcAsset, const cgltf_node* node,
-        Entity entity, const char* name) {
+        Entity entity, const char* name, FFilamentInstance* instance) {
     const cgltf_mesh* mesh = node->mesh;
 
     // Compute the transform relative to the root.
@@ -509,7 +727,15 @@ void FAssetLoader::createRenderable(const cgltf_data* srcAsset, const cgltf_node
     mResult->mBoundingBox.max = max(mResult->mBoundingBox.max, transformed.max);
 
     if (node->skin) {
-       builder.skinning(node->skin->joints_count);
+        if (instance && instance->skinningBufferBase != SIZE_MAX) {
+            // The bones for this renderable live in a region of the asset's shared
+            // SkinningBuffer; the animator updates that region directly.
+            builder.enableSkinningBuffers();
+            builder.skinning(mResult->mSkinningBuffer, node->skin->joints_count,
+                    instance->skinningBufferBase + mResult->mBoneOffsets.at(node));
+        } else {
+            builder.skinning(node->skin->joints_count);
+        }
     }
 
     // Per the spec, glTF models must have valid mix / max annotations for position attributes.
@@ -580,6 +806,7 @@ bool FAssetLoader::createPrimitive(const cgltf_primitive* inPrim, Primitive* out
 
         BufferSlot slot = { accessor };
         slot.indexBuffer = indices;
+        slot.triangleIndices = inPrim->type == cgltf_primitive_type_triangles;
         addBufferSlot(slot);
     } else if (inPrim->attributes_count > 0) {
         // If a primitive does not have an index buffer, generate a trivial one now.
@@ -691,6 +918,25 @@ bool FAssetLoader::createPrimitive(const cgltf_primitive* inPrim, Primitive* out
         }
         const int stride = (fatype == actualType) ? accessor->stride : 0;
 
+        // Narrow float32 texture coordinates to half precision when requested and when the
+        // accessor declares bounds proving that the data fits. The bounds are optional in glTF
+        // for texture coordinates, so accessors without them stay at full precision. The
+        // conversion itself is done at upload time, in ResourceLoader.
+        auto fitsInHalf = [](const cgltf_float* v) {
+            return v[0] >= -65504.0f && v[0] <= 65504.0f && v[1] >= -65504.0f && v[1] <= 65504.0f;
+        };
+        if (mQuantizeAttributes && atype == cgltf_attribute_type_texcoord &&
+                accessor->type == cgltf_type_vec2 &&
+                accessor->component_type == cgltf_component_type_r_32f && !accessor->is_sparse &&
+                accessor->has_min && accessor->has_max &&
+                fitsInHalf(accessor->min) && fitsInHalf(accessor->max)) {
+            vbb.attribute(semantic, slot, VertexBuffer::AttributeType::HALF2);
+            BufferSlot uvSlot = { accessor, atype, slot++ };
+            uvSlot.halfFloats = true;
+            addBufferSlot(uvSlot);
+            continue;
+        }
+
         // The cgltf library provides a stride value for all accessors, even though they do not
         // exist in the glTF file. It is computed from the type and the stride of the buffer view.
         // As a convenience, cgltf also replaces zero (default) stride with the actual stride.
@@ -1322,6 +1568,15 @@ FilamentAsset* AssetLoader::createAssetFromBinary(uint8_t const* bytes, uint32_t
     return upcast(this)->createAssetFromBinary(bytes, nbytes);
 }
 
+FilamentAsset* AssetLoader::createAssetFromFile(const char* path) {
+    return upcast(this)->createAssetFromFile(path);
+}
+
+size_t AssetLoader::createAssetsFromFiles(const char* const* paths, size_t count,
+        FilamentAsset** assets) {
+    return upcast(this)->createAssetsFromFiles(paths, count, assets);
+}
+
 FilamentAsset* AssetLoader::createInstancedAsset(const uint8_t* bytes, uint32_t numBytes,
         FilamentInstance** instances, size_t numInstances) {
     return upcast(this)->createInstancedAsset(bytes, numBytes, instances, numInstances);
@@ -76,37 +76,63 @@ void DependencyGraph::refinalize() {
 
 void DependencyGraph::addEdge(Texture* texture, MaterialInstance* material, const char* parameter) {
     assert(mFinalized);
-    mTextureToMaterial[texture].insert(material);
-    mMaterialToTexture.at(material).params.at(parameter) = getStatus(texture);
-}
+    TextureNode* node = getStatus(texture);
+    MaterialNode& materialNode = mMaterialToTexture.at(material);
+    TextureNode*& slot = materialNode.params.at(parameter);
+    if (slot == node) {
+        return;
+    }
 
-void DependencyGraph::checkReadiness(Material* material) {
-    auto& status = mMaterialToTexture.at(material);
+    // If the parameter is being re-bound, undo the old texture's contribution to the counts.
+    if (slot) {
+        auto& oldMaterials = mTextureToMaterial.at(slot->texture);
+        auto iter = oldMaterials.find(material);
+        assert(iter != oldMaterials.end());
+        if (--iter.value() == 0) {
+            oldMaterials.erase(iter);
+        }
+        if (slot->ready) {
+            --materialNode.numReadyParams;
+        }
+    }
 
-    // Check this material's texture parameters, there are 5 in the worst case.
-    bool materialIsReady = true;
-    for (auto pair : status.params) {
-        if (!pair.second->ready) {
-            materialIsReady = false;
-            break;
+    slot = node;
+    mTextureToMaterial[texture][material]++;
+    if (node->ready) {
+        if (++materialNode.numReadyParams == materialNode.params.size()) {
+            markAsReady(material);
         }
     }
+}
 
-    // If all of its textures are ready, then the material has become ready.
-    if (materialIsReady) {
+void DependencyGraph::checkReadiness(Material* material) {
+    // The per-material ready count is maintained incrementally as textures complete, so this
+    // is a simple comparison; parameters that are not bound to a texture yet keep it unequal.
+    auto& status = mMaterialToTexture.at(material);
+    if (status.numReadyParams == status.params.size()) {
         markAsReady(material);
     }
 }
 
 void DependencyGraph::markAsReady(Texture* texture) {
     assert(texture && mFinalized);
-    mTextureNodes.at(texture)->ready = true;
+    TextureNode* node = mTextureNodes.at(texture).get();
+    if (node->ready) {
+        return;
+    }
+    node->ready = true;
 
-    // Iterate over the materials associated with this texture to check if any have become ready.
-    // This is O(n2) but the inner loop is always small.
+    // Bump the ready count of each material bound to this texture by the number of parameter
+    // slots it binds, making the whole propagation O(1) per affected material rather than a
+    // rescan of its parameters.
     auto& materials = mTextureToMaterial.at(texture);
-    for (auto material : materials) {
-        checkReadiness(material);
+    for (auto pair : materials) {
+        MaterialNode& materialNode = mMaterialToTexture.at(pair.first);
+        materialNode.numReadyParams += pair.second;
+        assert(materialNode.numReadyParams <= materialNode.params.size());
+        if (materialNode.numReadyParams == materialNode.params.size()) {
+            markAsReady(pair.first);
+        }
     }
 }
 
@@ -114,11 +140,12 @@ void DependencyGraph::markAsReady(MaterialInstance* material) {
     auto& entities = mMaterialToEntity.at(material);
     for (auto entity : entities) {
         auto& status = mEntityToMaterial.at(entity);
-        assert(status.numReadyMaterials <= status.materials.size());
-        if (status.numReadyMaterials == status.materials.size()) {
-            continue;
-        }
-        if (++status.numReadyMaterials == status.materials.size()) {
+        assert(status.readyMaterials.size() <= status.materials.size());
+
+        // The readiness of a given material must be counted exactly once per entity, even when
+        // refinalize() re-examines materials that were already ready.
+        if (status.readyMaterials.insert(material).second &&
+                status.readyMaterials.size() == status.materials.size()) {
             mReadyRenderables.push(entity);
         }
     }
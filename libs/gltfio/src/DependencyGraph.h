@@ -91,22 +91,33 @@ private:
 
     struct MaterialNode {
         tsl::robin_map<std::string, TextureNode*> params;
+
+        // Number of parameter slots whose texture has finished decoding. Maintained
+        // incrementally so that readiness checks never need to re-scan the params map.
+        size_t numReadyParams = 0;
     };
 
     struct EntityNode {
         tsl::robin_set<Material*> materials;
-        size_t numReadyMaterials = 0;
+
+        // Materials whose readiness has already been counted for this entity. A set rather
+        // than a plain count because refinalize() can re-examine materials that are already
+        // ready (e.g. when an instance adds new entities), and each material must be counted
+        // exactly once.
+        tsl::robin_set<Material*> readyMaterials;
     };
 
     void checkReadiness(Material* material);
     void markAsReady(Material* material);
     TextureNode* getStatus(filament::Texture* texture);
 
-    // The following maps contain the directed edges in the graph.
+    // The following maps contain the directed edges in the graph. The texture-to-material map
+    // counts how many parameter slots of each material are bound to the texture, so that a
+    // completion event can bump the material's ready count without scanning its params.
     tsl::robin_map<Entity, EntityNode> mEntityToMaterial;
     tsl::robin_map<Material*, tsl::robin_set<Entity>> mMaterialToEntity;
     tsl::robin_map<Material*, MaterialNode> mMaterialToTexture;
-    tsl::robin_map<filament::Texture*, tsl::robin_set<Material*>> mTextureToMaterial;
+    tsl::robin_map<filament::Texture*, tsl::robin_map<Material*, size_t>> mTextureToMaterial;
 
     // Each texture (and its readiness flag) can be referenced from multiple nodes, so we own
     // a collection of wrapper objects in the following map. This uses std::unique_ptr to allow
@@ -20,6 +20,7 @@
 #include <draco/compression/decode.h>
 #endif
 
+#include <utils/JobSystem.h>
 #include <utils/Log.h>
 
 #include <memory>
@@ -32,6 +33,36 @@ using namespace utils;
 
 namespace gltfio {
 
+void DracoCache::decodeMeshes(JobSystem& js, const cgltf_buffer_view* const* keys, size_t count) {
+    // Create the cache slots for all missing keys up front, then decode into them in parallel.
+    // Each job writes only to its own pre-existing slot, so the map is never mutated while the
+    // jobs are running and no locking is needed. Failed decodes leave a null slot, just like
+    // findOrCreateMesh().
+    vector<const cgltf_buffer_view*> missing;
+    missing.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        const cgltf_buffer_view* key = keys[i];
+        if (mCache.find(key) == mCache.end()) {
+            mCache.emplace(key, nullptr);
+            missing.push_back(key);
+        }
+    }
+    if (missing.empty()) {
+        return;
+    }
+    JobSystem::Job* parent = js.createJob();
+    for (const cgltf_buffer_view* key : missing) {
+        unique_ptr<DracoMesh>* slot = &mCache.find(key).value();
+        JobSystem::Job* job = jobs::createJob(js, parent, [key, slot] {
+            assert(key->buffer && key->buffer->data);
+            const uint8_t* compressedData = key->offset + (uint8_t*) key->buffer->data;
+            slot->reset(DracoMesh::decode(compressedData, key->size));
+        });
+        js.run(job);
+    }
+    js.runAndWait(parent);
+}
+
 DracoMesh* DracoCache::findOrCreateMesh(const cgltf_buffer_view* key) {
     auto iter = mCache.find(key);
     if (iter != mCache.end()) {
@@ -27,6 +27,10 @@
 #define GLTFIO_DRACO_SUPPORTED 0
 #endif
 
+namespace utils {
+    class JobSystem;
+}
+
 namespace gltfio {
 
 class DracoMesh;
@@ -37,6 +41,11 @@ class DracoMesh;
 // avoid duplicated work when a single Draco mesh is referenced from multiple primitives.
 class DracoCache {
 public:
+    // Decodes all not-yet-cached meshes for the given keys as parallel jobs, so that
+    // subsequent findOrCreateMesh() calls are cache hits. Blocks until decoding completes;
+    // the calling thread participates in the work.
+    void decodeMeshes(utils::JobSystem& js, const cgltf_buffer_view* const* keys, size_t count);
+
     DracoMesh* findOrCreateMesh(const cgltf_buffer_view* key);
 private:
     tsl::robin_map<const cgltf_buffer_view*, std::unique_ptr<DracoMesh>> mCache;
@@ -42,6 +42,7 @@
 #include "DependencyGraph.h"
 #include "DracoCache.h"
 #include "FFilamentInstance.h"
+#include "LoadArena.h"
 
 #include <tsl/robin_map.h>
 #include <tsl/htrie_map.h>
@@ -56,6 +57,14 @@
 #define GLTFIO_WARN(msg) slog.w << msg << io::endl
 #endif
 
+// Platforms where AssetLoader::createAssetFromFile can memory-map the source file instead of
+// copying it to the heap.
+#if defined(__EMSCRIPTEN__) || defined(WIN32)
+#define GLTFIO_USE_MMAP 0
+#else
+#define GLTFIO_USE_MMAP 1
+#endif
+
 namespace utils {
     class NameComponentManager;
     class EntityManager;
@@ -74,6 +83,8 @@ struct BufferSlot {
     filament::VertexBuffer* vertexBuffer;
     filament::IndexBuffer* indexBuffer;
     filament::MorphTargetBuffer* morphTargetBuffer;
+    bool triangleIndices; // for index buffer only: primitive topology is triangles
+    bool halfFloats; // for texcoord attribute only: narrow the float32 source data to half
 };
 
 // Encapsulates a connection between Texture and MaterialInstance.
@@ -244,6 +255,13 @@ struct FFilamentAsset : public FilamentAsset {
     utils::Entity mRoot;
     std::vector<FFilamentInstance*> mInstances;
     SkinVector mSkins; // unused for instanced assets
+
+    // For instanced assets, bone transforms for all instances are pooled into a single shared
+    // SkinningBuffer with per-instance offsets, rather than one bone UBO per renderable.
+    // Instances created after the pool is full fall back to classic per-renderable bones.
+    filament::SkinningBuffer* mSkinningBuffer = nullptr;
+    size_t mBonesPerInstance = 0;
+    size_t mSkinningBufferInstances = 0;
     Animator* mAnimator = nullptr;
     Wireframe* mWireframe = nullptr;
     bool mResourcesLoaded = false;
@@ -260,10 +278,21 @@ struct FFilamentAsset : public FilamentAsset {
     // Encapsulates reference-counted source data, which includes the cgltf hierachy
     // and potentially also includes buffer data that can be uploaded to the GPU.
     struct SourceAsset {
-        ~SourceAsset() { cgltf_free(hierarchy); }
+        ~SourceAsset();
         cgltf_data* hierarchy;
         DracoCache dracoCache;
         utils::FixedCapacityVector<uint8_t> glbData;
+
+        // Non-null when the source file is memory-mapped rather than heap-copied (see
+        // AssetLoader::createAssetFromFile). cgltf points straight into the mapping, which is
+        // released along with the rest of the source data once all uploads have completed.
+        void* mappedData = nullptr;
+        size_t mappedSize = 0;
+
+        // Arena backing all cgltf allocations (the hierarchy and loaded buffer blobs),
+        // released in one shot when the source data is destroyed. cgltf_free() runs in the
+        // destructor body, i.e. before the arena member is destroyed.
+        std::unique_ptr<LoadArena> arena;
     };
 
     // We used shared ownership for the raw cgltf data in order to permit ResourceLoader to
@@ -277,6 +306,7 @@ struct FFilamentAsset : public FilamentAsset {
     std::vector<TextureSlot> mTextureSlots;
     std::vector<const char*> mResourceUris;
     NodeMap mNodeMap; // unused for instanced assets
+    tsl::robin_map<const cgltf_node*, size_t> mBoneOffsets; // see mSkinningBuffer
     std::vector<std::pair<const cgltf_primitive*, filament::VertexBuffer*> > mPrimitives;
     MatInstanceCache mMatInstanceCache;
     MeshCache mMeshCache;
@@ -25,6 +25,7 @@
 
 #include <tsl/robin_map.h>
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -42,6 +43,10 @@ struct Skin {
     std::vector<filament::math::mat4f> inverseBindMatrices;
     std::vector<utils::Entity> joints;
     std::vector<utils::Entity> targets;
+
+    // Offset of each target's bones within an instance's region of the shared SkinningBuffer,
+    // parallel to "targets". Unused when the owning asset has no shared SkinningBuffer.
+    std::vector<size_t> boneOffsets;
 };
 
 using SkinVector = std::vector<Skin>;
@@ -54,6 +59,11 @@ struct FFilamentInstance : public FilamentInstance {
     FFilamentAsset* owner;
     SkinVector skins;
     NodeMap nodeMap;
+
+    // Offset of this instance's bone pool in the owner's shared SkinningBuffer, or SIZE_MAX
+    // when this instance uses classic per-renderable bones.
+    size_t skinningBufferBase = SIZE_MAX;
+
     Animator* getAnimator() noexcept;
 };
 
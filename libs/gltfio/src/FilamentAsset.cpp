@@ -24,11 +24,24 @@
 
 #include "Wireframe.h"
 
+#if GLTFIO_USE_MMAP
+#include <sys/mman.h>
+#endif
+
 using namespace filament;
 using namespace utils;
 
 namespace gltfio {
 
+FFilamentAsset::SourceAsset::~SourceAsset() {
+    cgltf_free(hierarchy);
+#if GLTFIO_USE_MMAP
+    if (mappedData) {
+        munmap(mappedData, mappedSize);
+    }
+#endif
+}
+
 FFilamentAsset::~FFilamentAsset() {
     releaseSourceData();
 
@@ -73,6 +86,9 @@ FFilamentAsset::~FFilamentAsset() {
     for (auto tb : mMorphTargetBuffers) {
         mEngine->destroy(tb);
     }
+    if (mSkinningBuffer) {
+        mEngine->destroy(mSkinningBuffer);
+    }
 }
 
 const char* FFilamentAsset::getExtras(utils::Entity entity) const noexcept {
@@ -132,6 +148,7 @@ void FFilamentAsset::releaseSourceData() noexcept {
     mMeshCache = {};
     mResourceUris = {};
     mNodeMap = {};
+    mBoneOffsets = {};
     mPrimitives = {};
     mBufferSlots = {};
     mTextureSlots = {};
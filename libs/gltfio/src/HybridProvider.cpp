@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gltfio/MaterialProvider.h>
+
+#include <filament/Engine.h>
+#include <filament/Material.h>
+#include <filament/MaterialInstance.h>
+
+#include <utils/Hash.h>
+
+#include <tsl/robin_map.h>
+
+#include <vector>
+
+using namespace filament;
+using namespace gltfio;
+using namespace utils;
+
+namespace {
+
+class HybridProvider : public HybridMaterialProvider {
+public:
+    HybridProvider(Engine* engine, bool optimizeShaders) :
+            mEngine(engine),
+            mUbershaders(createUbershaderLoader(engine)),
+            mGenerator(createMaterialGenerator(engine, optimizeShaders)) {}
+
+    ~HybridProvider() override {
+        delete mGenerator;
+        delete mUbershaders;
+    }
+
+    MaterialInstance* createMaterialInstance(MaterialKey* config, UvMap* uvmap,
+            const char* label, const char* extras) override {
+        // Diagnostics are supported only by generated shaders.
+        if (config->enableDiagnostics) {
+            return mGenerator->createMaterialInstance(config, uvmap, label, extras);
+        }
+
+        // If this configuration has already been specialized, the generator serves it from its
+        // material cache, so the instance is cheap to create and uses the streamlined shader.
+        if (mSpecialized.find(*config) != mSpecialized.end()) {
+            return mGenerator->createMaterialInstance(config, uvmap, label, extras);
+        }
+
+        // Otherwise hand out an ubershader instance for instant display, and queue the
+        // configuration (before it gets constrained) for later specialization.
+        if (mPending.find(*config) == mPending.end()) {
+            mPending.insert({*config, true});
+            mQueue.push_back(*config);
+        }
+        return mUbershaders->createMaterialInstance(config, uvmap, label, extras);
+    }
+
+    size_t specializeMaterials(size_t maxCount) override {
+        while (maxCount-- > 0 && mQueueHead < mQueue.size()) {
+            const MaterialKey original = mQueue[mQueueHead++];
+
+            // Create and immediately destroy a throwaway instance; what we are really after is
+            // the compiled Material that this leaves in the generator's cache, which all
+            // subsequently created instances of this configuration will share.
+            MaterialKey config = original;
+            UvMap uvmap {};
+            MaterialInstance* mi = mGenerator->createMaterialInstance(&config, &uvmap,
+                    "specialized", nullptr);
+            if (mi) {
+                mEngine->destroy(mi);
+            }
+            mSpecialized.insert({original, true});
+        }
+        return mQueue.size() - mQueueHead;
+    }
+
+    size_t getMaterialsCount() const noexcept override {
+        return mUbershaders->getMaterialsCount() + mGenerator->getMaterialsCount();
+    }
+
+    const Material* const* getMaterials() const noexcept override {
+        mCombined.clear();
+        const Material* const* ubershaders = mUbershaders->getMaterials();
+        for (size_t i = 0, n = mUbershaders->getMaterialsCount(); i < n; ++i) {
+            mCombined.push_back(ubershaders[i]);
+        }
+        const Material* const* generated = mGenerator->getMaterials();
+        for (size_t i = 0, n = mGenerator->getMaterialsCount(); i < n; ++i) {
+            mCombined.push_back(generated[i]);
+        }
+        return mCombined.data();
+    }
+
+    void destroyMaterials() override {
+        mGenerator->destroyMaterials();
+        mUbershaders->destroyMaterials();
+        mSpecialized.clear();
+        mPending.clear();
+        mQueue.clear();
+        mQueueHead = 0;
+    }
+
+    bool needsDummyData(VertexAttribute attrib) const noexcept override {
+        // The ubershaders need dummy attributes; the extra attributes are simply unused by the
+        // specialized materials, so the superset is always safe to request.
+        return mUbershaders->needsDummyData(attrib);
+    }
+
+private:
+    using HashFn = hash::MurmurHashFn<MaterialKey>;
+
+    Engine* const mEngine;
+    MaterialProvider* const mUbershaders;
+    MaterialProvider* const mGenerator;
+    tsl::robin_map<MaterialKey, bool, HashFn> mSpecialized;
+    tsl::robin_map<MaterialKey, bool, HashFn> mPending;
+    std::vector<MaterialKey> mQueue;
+    size_t mQueueHead = 0;
+    mutable std::vector<const Material*> mCombined;
+};
+
+} // anonymous namespace
+
+namespace gltfio {
+
+HybridMaterialProvider* createHybridProvider(filament::Engine* engine, bool optimizeShaders) {
+    return new HybridProvider(engine, optimizeShaders);
+}
+
+} // namespace gltfio
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef GLTFIO_LOADARENA_H
+#define GLTFIO_LOADARENA_H
+
+#include <utils/Allocator.h>
+#include <utils/compiler.h>
+
+#include <cgltf.h>
+
+#include <algorithm>
+#include <list>
+
+namespace gltfio {
+
+/**
+ * Per-asset bump allocator for load-time data.
+ *
+ * Parsing a large glTF performs thousands of small allocations (nodes, accessors, name
+ * strings, buffer blobs) that are otherwise released one by one when the source data is
+ * destroyed. Routing them through a chain of utils::LinearAllocator slabs makes each
+ * allocation a pointer bump and releases everything with a handful of free() calls.
+ *
+ * Individual frees are no-ops, so the arena must own all allocations made through it and
+ * must outlive them; it is stashed in FFilamentAsset::SourceAsset next to the cgltf
+ * hierarchy it backs.
+ */
+class LoadArena {
+public:
+    LoadArena() noexcept = default;
+
+    LoadArena(LoadArena const&) = delete;
+    LoadArena& operator=(LoadArena const&) = delete;
+
+    void* alloc(size_t size, size_t alignment = alignof(std::max_align_t)) noexcept {
+        if (UTILS_LIKELY(!mSlabs.empty())) {
+            if (void* p = mAllocator.alloc(size, alignment)) {
+                return p;
+            }
+        }
+        // start a new slab; oversized requests (e.g. whole buffer blobs) get a dedicated one
+        const size_t slabSize = std::max(size_t(SLAB_SIZE), size + alignment);
+        mSlabs.emplace_back(slabSize);
+        utils::AreaPolicy::HeapArea const& slab = mSlabs.back();
+        mAllocator = utils::LinearAllocator(slab.begin(), slab.end());
+        return mAllocator.alloc(size, alignment);
+    }
+
+    // cgltf_memory_options shims; the whole arena is released at once when the asset's
+    // source data is destroyed, so freeing individual blocks is a no-op.
+    static void* cgltfAlloc(void* user, cgltf_size size) {
+        return static_cast<LoadArena*>(user)->alloc(size);
+    }
+    static void cgltfFree(void*, void*) {}
+
+private:
+    static constexpr size_t SLAB_SIZE = 1u << 20u;
+    std::list<utils::AreaPolicy::HeapArea> mSlabs;
+    utils::LinearAllocator mAllocator{ nullptr, nullptr };
+};
+
+} // namespace gltfio
+
+#endif // GLTFIO_LOADARENA_H
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gltfio/MaterialArchive.h>
+
+#include <filament/Material.h>
+#include <filament/MaterialInstance.h>
+
+#include <utils/Hash.h>
+#include <utils/Log.h>
+
+#include <tsl/robin_map.h>
+
+#include <vector>
+
+using namespace filament;
+using namespace gltfio;
+using namespace utils;
+
+namespace {
+
+class ArchiveLoader : public MaterialProvider {
+public:
+    ArchiveLoader(Engine* engine, const void* archiveData, size_t archiveSize);
+    ~ArchiveLoader() override {}
+
+    MaterialInstance* createMaterialInstance(MaterialKey* config, UvMap* uvmap,
+            const char* label, const char* extras) override;
+
+    size_t getMaterialsCount() const noexcept override;
+    const Material* const* getMaterials() const noexcept override;
+    void destroyMaterials() override;
+
+    bool needsDummyData(VertexAttribute attrib) const noexcept override {
+        return false;
+    }
+
+    bool isValid() const noexcept { return !mEntries.empty(); }
+
+    using HashFn = hash::MurmurHashFn<MaterialKey>;
+    tsl::robin_map<MaterialKey, const MaterialArchiveEntry*, HashFn> mEntries;
+    tsl::robin_map<MaterialKey, Material*, HashFn> mCache;
+    std::vector<Material*> mMaterials;
+    const uint8_t* const mArchiveData;
+    Engine* const mEngine;
+};
+
+ArchiveLoader::ArchiveLoader(Engine* engine, const void* archiveData, size_t archiveSize) :
+        mArchiveData(static_cast<const uint8_t*>(archiveData)), mEngine(engine) {
+    if (archiveData == nullptr || archiveSize < sizeof(MaterialArchiveHeader)) {
+        slog.e << "Material archive is truncated." << io::endl;
+        return;
+    }
+    const auto* header = reinterpret_cast<const MaterialArchiveHeader*>(mArchiveData);
+    if (header->magic != MaterialArchiveHeader::MAGIC) {
+        slog.e << "Material archive has an invalid magic number." << io::endl;
+        return;
+    }
+    if (header->version != MaterialArchiveHeader::VERSION) {
+        slog.e << "Material archive version " << header->version << " is not supported."
+                << io::endl;
+        return;
+    }
+    const size_t indexEnd = sizeof(MaterialArchiveHeader) +
+            sizeof(MaterialArchiveEntry) * header->entryCount;
+    if (indexEnd > archiveSize) {
+        slog.e << "Material archive is truncated." << io::endl;
+        return;
+    }
+    const auto* entries = reinterpret_cast<const MaterialArchiveEntry*>(
+            mArchiveData + sizeof(MaterialArchiveHeader));
+    for (uint32_t i = 0; i < header->entryCount; ++i) {
+        const MaterialArchiveEntry& entry = entries[i];
+        if (entry.offset < indexEnd || size_t(entry.offset) + entry.size > archiveSize) {
+            slog.e << "Material archive entry " << i << " is out of bounds." << io::endl;
+            mEntries.clear();
+            return;
+        }
+        mEntries[entry.key] = &entry;
+    }
+}
+
+MaterialInstance* ArchiveLoader::createMaterialInstance(MaterialKey* config, UvMap* uvmap,
+        const char* label, const char* extras) {
+    constrainMaterial(config, uvmap);
+    auto cached = mCache.find(*config);
+    if (cached != mCache.end()) {
+        return cached->second->createInstance(label);
+    }
+    auto indexed = mEntries.find(*config);
+    if (indexed == mEntries.end()) {
+        slog.w << "Material archive does not cover the configuration requested by '"
+                << label << "'." << io::endl;
+        return nullptr;
+    }
+    const MaterialArchiveEntry* entry = indexed->second;
+    Material* mat = Material::Builder()
+            .package(mArchiveData + entry->offset, entry->size)
+            .build(*mEngine);
+    mCache.emplace(std::make_pair(*config, mat));
+    mMaterials.push_back(mat);
+    return mat->createInstance(label);
+}
+
+size_t ArchiveLoader::getMaterialsCount() const noexcept {
+    return mMaterials.size();
+}
+
+const Material* const* ArchiveLoader::getMaterials() const noexcept {
+    return mMaterials.data();
+}
+
+void ArchiveLoader::destroyMaterials() {
+    for (auto& iter : mCache) {
+        mEngine->destroy(iter.second);
+    }
+    mMaterials.clear();
+    mCache.clear();
+}
+
+} // anonymous namespace
+
+namespace gltfio {
+
+MaterialProvider* createArchiveLoader(filament::Engine* engine, const void* archiveData,
+        size_t archiveSize) {
+    ArchiveLoader* loader = new ArchiveLoader(engine, archiveData, archiveSize);
+    if (!loader->isValid()) {
+        delete loader;
+        return nullptr;
+    }
+    return loader;
+}
+
+} // namespace gltfio
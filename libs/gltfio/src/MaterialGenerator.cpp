@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <gltfio/MaterialArchive.h>
 #include <gltfio/MaterialProvider.h>
 
 #include <filamat/MaterialBuilder.h>
@@ -22,6 +23,8 @@
 
 #include <tsl/robin_map.h>
 
+#include <cstdlib>
+#include <cstring>
 #include <string>
 
 using namespace filamat;
@@ -309,7 +312,7 @@ std::string shaderFromKey(const MaterialKey& config) {
     return shader;
 }
 
-static Material* createMaterial(Engine* engine, const MaterialKey& config, const UvMap& uvmap,
+static Package createPackage(Engine* engine, const MaterialKey& config, const UvMap& uvmap,
         const char* name, bool optimizeShaders) {
     std::string shader = shaderFromKey(config);
     processShaderString(&shader, uvmap, config);
@@ -528,7 +531,12 @@ static Material* createMaterial(Engine* engine, const MaterialKey& config, const
         builder.shading(Shading::LIT);
     }
 
-    Package pkg = builder.build(engine->getJobSystem());
+    return builder.build(engine->getJobSystem());
+}
+
+static Material* createMaterial(Engine* engine, const MaterialKey& config, const UvMap& uvmap,
+        const char* name, bool optimizeShaders) {
+    Package pkg = createPackage(engine, config, uvmap, name, optimizeShaders);
     return Material::Builder().package(pkg.getData(), pkg.getSize()).build(*engine);
 }
 
@@ -559,4 +567,72 @@ MaterialProvider* createMaterialGenerator(filament::Engine* engine, bool optimiz
     return new MaterialGenerator(engine, optimizeShaders);
 }
 
+size_t buildMaterialArchive(filament::Engine* engine, const MaterialKey* requirements,
+        size_t count, void** archiveData, bool optimizeShaders) {
+    MaterialBuilder::init();
+
+    // Constrain each requirement set the same way the generator would, then fold duplicates
+    // so the archive holds exactly one package per unique configuration.
+    using HashFn = hash::MurmurHashFn<MaterialKey>;
+    tsl::robin_map<MaterialKey, bool, HashFn> seen;
+    std::vector<std::pair<MaterialKey, UvMap>> configs;
+    configs.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        MaterialKey config = requirements[i];
+        UvMap uvmap {};
+        constrainMaterial(&config, &uvmap);
+        if (seen.find(config) == seen.end()) {
+            seen.insert({config, true});
+            configs.emplace_back(config, uvmap);
+        }
+    }
+
+    std::vector<Package> packages;
+    packages.reserve(configs.size());
+    for (const auto& pair : configs) {
+        Package pkg = createPackage(engine, pair.first, pair.second, "archive", optimizeShaders);
+        if (!pkg.isValid()) {
+            MaterialBuilder::shutdown();
+            return 0;
+        }
+        packages.push_back(std::move(pkg));
+    }
+    MaterialBuilder::shutdown();
+
+    // Lay out the index followed by the payload, with each package 8-byte aligned so that a
+    // memory-mapped archive can be consumed in place.
+    const auto align = [](size_t offset) { return (offset + 7) & ~size_t(7); };
+    size_t totalSize = sizeof(MaterialArchiveHeader) +
+            sizeof(MaterialArchiveEntry) * configs.size();
+    std::vector<size_t> offsets(packages.size());
+    for (size_t i = 0; i < packages.size(); ++i) {
+        totalSize = align(totalSize);
+        offsets[i] = totalSize;
+        totalSize += packages[i].getSize();
+    }
+
+    uint8_t* archive = static_cast<uint8_t*>(malloc(totalSize));
+    if (archive == nullptr) {
+        return 0;
+    }
+    memset(archive, 0, totalSize);
+
+    auto* header = reinterpret_cast<MaterialArchiveHeader*>(archive);
+    header->magic = MaterialArchiveHeader::MAGIC;
+    header->version = MaterialArchiveHeader::VERSION;
+    header->entryCount = uint32_t(configs.size());
+
+    auto* entries = reinterpret_cast<MaterialArchiveEntry*>(
+            archive + sizeof(MaterialArchiveHeader));
+    for (size_t i = 0; i < packages.size(); ++i) {
+        entries[i].key = configs[i].first;
+        entries[i].offset = uint32_t(offsets[i]);
+        entries[i].size = uint32_t(packages[i].getSize());
+        memcpy(archive + offsets[i], packages[i].getData(), packages[i].getSize());
+    }
+
+    *archiveData = archive;
+    return totalSize;
+}
+
 } // namespace gltfio
@@ -32,19 +32,28 @@
 
 #include <geometry/Transcoder.h>
 
+#include <meshoptimizer.h>
+
+#include <utils/Hash.h>
 #include <utils/JobSystem.h>
 #include <utils/Log.h>
 #include <utils/Systrace.h>
 
 #include <cgltf.h>
 
+#include <math/half.h>
 #include <math/quat.h>
 #include <math/vec3.h>
 #include <math/vec4.h>
 
 #include <tsl/robin_map.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
 #include <string>
+#include <vector>
 
 #if defined(__EMSCRIPTEN__) || defined(__ANDROID__) || defined(IOS)
 #define USE_FILESYSTEM 0
@@ -72,11 +81,228 @@ namespace {
         int numComponents;
         bool srgb;
         bool completed;
+
+        // Number of texture slots that reference this image; used to decode and upload the
+        // most-used textures first, so that prominent materials become ready early.
+        int refCount;
+
+        // Source of the image bytes: a pointer into the glTF's buffer data, or (when the
+        // pointer is null) a URI.
+        const uint8_t* sourceBuffer;
+        std::string uri;
+
+        // Mip levels below level 0, each a separately malloc'ed RGBA8 image. These are produced
+        // on the CPU when the transcode cache is enabled (see decodeWithTranscodeCache below) and
+        // must be populated by the decode job before texels is set.
+        std::vector<uint8_t*> mips;
     };
 
     using BufferTextureCache = tsl::robin_map<const void*, std::unique_ptr<TextureCacheEntry>>;
     using UriTextureCache = tsl::robin_map<std::string, std::unique_ptr<TextureCacheEntry>>;
     using UriDataCache = tsl::robin_map<std::string, gltfio::ResourceLoader::BufferDescriptor>;
+
+#if USE_FILESYSTEM
+
+    uint32_t computeMipLevelCount(uint32_t width, uint32_t height) {
+        uint32_t levels = 1;
+        while (width > 1 || height > 1) {
+            width = std::max(1u, width >> 1u);
+            height = std::max(1u, height >> 1u);
+            levels++;
+        }
+        return levels;
+    }
+
+    // On-disk cache of decoded, mip-mapped texel blobs, keyed by a hash of the source image
+    // bytes (see ResourceConfiguration::textureCacheFolder). A cache hit skips both the
+    // PNG / JPEG decode and mipmap generation for the texture.
+    struct TranscodeCacheHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t width;
+        uint32_t height;
+        uint32_t levels;
+        uint32_t srgb;
+    };
+
+    constexpr uint32_t TRANSCODE_CACHE_MAGIC = 'G' | ('T' << 8u) | ('X' << 16u) | ('C' << 24u);
+    constexpr uint32_t TRANSCODE_CACHE_VERSION = 1;
+
+    uint32_t computeSourceHash(const uint8_t* data, size_t size) {
+        // the source bytes are not necessarily word-aligned, so hash via an aligned bounce buffer
+        uint32_t chunk[1024];
+        uint32_t hash = uint32_t(size);
+        while (size >= sizeof(uint32_t)) {
+            const size_t wordCount = std::min(size, sizeof(chunk)) / sizeof(uint32_t);
+            memcpy(chunk, data, wordCount * sizeof(uint32_t));
+            hash = utils::hash::murmur3(chunk, wordCount, hash);
+            data += wordCount * sizeof(uint32_t);
+            size -= wordCount * sizeof(uint32_t);
+        }
+        if (size) {
+            uint32_t tail = 0;
+            memcpy(&tail, data, size);
+            hash = utils::hash::murmur3(&tail, 1, hash);
+        }
+        return hash;
+    }
+
+    std::string getTranscodeCachePath(const std::string& folder, const uint8_t* data,
+            size_t size, bool srgb) {
+        char name[48];
+        snprintf(name, sizeof(name), "%08x-%zx-%d.texblob",
+                computeSourceHash(data, size), size, int(srgb));
+        return (Path(folder) + name).getPath();
+    }
+
+    // Box-filters a mip level into the next one. For sRGB textures the color channels are
+    // averaged in linear space, matching what the GPU does when generating mips of an sRGB
+    // texture; alpha is always averaged linearly.
+    void generateMipLevel(const uint8_t* src, uint32_t srcWidth, uint32_t srcHeight,
+            uint8_t* dst, uint32_t dstWidth, uint32_t dstHeight, bool srgb) {
+        auto toLinear = [](uint8_t v) -> float {
+            static const std::array<float, 256> lut = [] {
+                std::array<float, 256> table{};
+                for (size_t i = 0; i < table.size(); i++) {
+                    const float f = float(i) * (1.0f / 255.0f);
+                    table[i] = f <= 0.04045f ? f * (1.0f / 12.92f)
+                                             : std::pow((f + 0.055f) * (1.0f / 1.055f), 2.4f);
+                }
+                return table;
+            }();
+            return lut[v];
+        };
+        auto toSrgb = [](float v) -> uint8_t {
+            v = v <= 0.0031308f ? v * 12.92f : 1.055f * std::pow(v, 1.0f / 2.4f) - 0.055f;
+            return uint8_t(std::lround(std::min(1.0f, std::max(0.0f, v)) * 255.0f));
+        };
+        for (uint32_t y = 0; y < dstHeight; y++) {
+            const uint32_t y0 = std::min(2 * y + 0, srcHeight - 1);
+            const uint32_t y1 = std::min(2 * y + 1, srcHeight - 1);
+            for (uint32_t x = 0; x < dstWidth; x++) {
+                const uint32_t x0 = std::min(2 * x + 0, srcWidth - 1);
+                const uint32_t x1 = std::min(2 * x + 1, srcWidth - 1);
+                const uint8_t* p00 = src + 4 * (y0 * srcWidth + x0);
+                const uint8_t* p01 = src + 4 * (y0 * srcWidth + x1);
+                const uint8_t* p10 = src + 4 * (y1 * srcWidth + x0);
+                const uint8_t* p11 = src + 4 * (y1 * srcWidth + x1);
+                uint8_t* texel = dst + 4 * (y * dstWidth + x);
+                if (srgb) {
+                    for (int c = 0; c < 3; c++) {
+                        texel[c] = toSrgb(0.25f * (toLinear(p00[c]) + toLinear(p01[c]) +
+                                toLinear(p10[c]) + toLinear(p11[c])));
+                    }
+                } else {
+                    for (int c = 0; c < 3; c++) {
+                        texel[c] = uint8_t((p00[c] + p01[c] + p10[c] + p11[c] + 2) / 4);
+                    }
+                }
+                texel[3] = uint8_t((p00[3] + p01[3] + p10[3] + p11[3] + 2) / 4);
+            }
+        }
+    }
+
+    bool loadCachedTexels(const std::string& path, TextureCacheEntry* entry) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (!file) {
+            return false;
+        }
+        TranscodeCacheHeader header;
+        bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+                header.magic == TRANSCODE_CACHE_MAGIC &&
+                header.version == TRANSCODE_CACHE_VERSION &&
+                header.width == uint32_t(entry->width) &&
+                header.height == uint32_t(entry->height) &&
+                header.srgb == uint32_t(entry->srgb) &&
+                header.levels == computeMipLevelCount(header.width, header.height);
+        stbi_uc* texels = nullptr;
+        if (ok) {
+            uint32_t w = header.width;
+            uint32_t h = header.height;
+            texels = (stbi_uc*) malloc(size_t(w) * h * 4);
+            ok = fread(texels, size_t(w) * h * 4, 1, file) == 1;
+            for (uint32_t level = 1; ok && level < header.levels; level++) {
+                w = std::max(1u, w >> 1u);
+                h = std::max(1u, h >> 1u);
+                uint8_t* mip = (uint8_t*) malloc(size_t(w) * h * 4);
+                ok = fread(mip, size_t(w) * h * 4, 1, file) == 1;
+                entry->mips.push_back(mip);
+            }
+        }
+        fclose(file);
+        if (!ok) {
+            free(texels);
+            for (uint8_t* mip : entry->mips) {
+                free(mip);
+            }
+            entry->mips.clear();
+            return false;
+        }
+        entry->texels = texels;
+        return true;
+    }
+
+    void saveCachedTexels(const std::string& path, const TextureCacheEntry* entry,
+            const uint8_t* texels, uint32_t width, uint32_t height) {
+        // write to a temporary file first, so that a partially written blob is never picked up
+        const std::string tmp = path + ".tmp";
+        FILE* file = fopen(tmp.c_str(), "wb");
+        if (!file) {
+            return;     // the cache folder might not exist or be writable, this is not an error
+        }
+        const TranscodeCacheHeader header = { TRANSCODE_CACHE_MAGIC, TRANSCODE_CACHE_VERSION,
+                width, height, uint32_t(entry->mips.size() + 1), uint32_t(entry->srgb) };
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                fwrite(texels, size_t(width) * height * 4, 1, file) == 1;
+        uint32_t w = width;
+        uint32_t h = height;
+        for (const uint8_t* mip : entry->mips) {
+            w = std::max(1u, w >> 1u);
+            h = std::max(1u, h >> 1u);
+            ok = ok && fwrite(mip, size_t(w) * h * 4, 1, file) == 1;
+        }
+        fclose(file);
+        if (ok) {
+            rename(tmp.c_str(), path.c_str());
+        } else {
+            remove(tmp.c_str());
+        }
+    }
+
+    // Fetches a decoded, mip-mapped blob from the transcode cache, or decodes the source image
+    // and populates the cache for the next load. In both cases the entry ends up with level 0
+    // in texels and the rest of the mip chain in mips, so the upload step does no GPU mipgen.
+    bool decodeWithTranscodeCache(const std::string& folder, const uint8_t* sourceData,
+            size_t sourceSize, TextureCacheEntry* entry) {
+        const std::string path = getTranscodeCachePath(folder, sourceData, sourceSize, entry->srgb);
+        if (loadCachedTexels(path, entry)) {
+            return true;
+        }
+        int width, height, comp;
+        stbi_uc* texels = stbi_load_from_memory(sourceData, int(sourceSize),
+                &width, &height, &comp, 4);
+        if (!texels) {
+            return false;
+        }
+        uint32_t w = width;
+        uint32_t h = height;
+        const uint8_t* prev = texels;
+        while (w > 1 || h > 1) {
+            const uint32_t mw = std::max(1u, w >> 1u);
+            const uint32_t mh = std::max(1u, h >> 1u);
+            uint8_t* mip = (uint8_t*) malloc(size_t(mw) * mh * 4);
+            generateMipLevel(prev, w, h, mip, mw, mh, entry->srgb);
+            entry->mips.push_back(mip);
+            prev = mip;
+            w = mw;
+            h = mh;
+        }
+        saveCachedTexels(path, entry, texels, uint32_t(width), uint32_t(height));
+        entry->texels = texels;     // set last, this is what signals completion
+        return true;
+    }
+
+#endif // USE_FILESYSTEM
 }
 
 namespace gltfio {
@@ -88,13 +314,17 @@ struct ResourceLoader::Impl {
         mNormalizeSkinningWeights = config.normalizeSkinningWeights;
         mRecomputeBoundingBoxes = config.recomputeBoundingBoxes;
         mIgnoreBindTransform = config.ignoreBindTransform;
+        mOptimizeIndexBuffers = config.optimizeIndexBuffers;
+        mTextureCacheFolder = std::string(config.textureCacheFolder ? config.textureCacheFolder : "");
     }
 
     Engine* mEngine;
     bool mNormalizeSkinningWeights;
     bool mRecomputeBoundingBoxes;
     bool mIgnoreBindTransform;
+    bool mOptimizeIndexBuffers;
     std::string mGltfPath;
+    std::string mTextureCacheFolder;
 
     // This is used to calculate skinIndex when updateBoundingBoxes, so that the correspondency between
     // cgltf_node* and FFilamentInstance::Skin can be retrieved. This pointer doesn't need to be freed.
@@ -110,6 +340,12 @@ struct ResourceLoader::Impl {
     // two caches: one for URI-based textures and one for buffer-based textures.
     BufferTextureCache mBufferTextureCache;
     UriTextureCache mUriTextureCache;
+
+    // All texture cache entries, sorted by decreasing reference count. Decode jobs are kicked
+    // off and finished textures are uploaded in this order. Rebuilt by createTextures(), the
+    // pointers belong to the caches above.
+    std::vector<TextureCacheEntry*> mOrderedEntries;
+
     int mNumDecoderTasks;
     int mNumDecoderTasksFinished;
     JobSystem::Job* mDecoderRootJob = nullptr;
@@ -121,7 +357,11 @@ struct ResourceLoader::Impl {
     void addTextureCacheEntry(const TextureSlot& tb);
     void bindTextureToMaterial(const TextureSlot& tb);
     void decodeSingleTexture();
-    void uploadPendingTextures();
+    void decodeEntry(TextureCacheEntry* entry, const uint8_t* sourceData, size_t sourceSize);
+#if USE_FILESYSTEM
+    void decodeEntryFromFile(TextureCacheEntry* entry, const utils::Path& fullpath);
+#endif
+    void uploadPendingTextures(size_t byteBudget = SIZE_MAX);
     void releasePendingTextures();
     ~Impl();
 };
@@ -146,12 +386,18 @@ static void uploadCallback(void* buffer, size_t size, void* user) {
 
 void importSkins(const cgltf_data* gltf, const NodeMap& nodeMap, SkinVector& dstSkins) {
     dstSkins.resize(gltf->skins_count);
+    size_t boneOffset = 0;
     for (cgltf_size i = 0, len = gltf->nodes_count; i < len; ++i) {
         const cgltf_node& node = gltf->nodes[i];
         if (node.skin) {
             int skinIndex = node.skin - &gltf->skins[0];
             Entity entity = nodeMap.at(&node);
             dstSkins[skinIndex].targets.push_back(entity);
+
+            // Record where this target's bones live within an instance's region of the shared
+            // SkinningBuffer. This enumeration must match FAssetLoader::createAsset().
+            dstSkins[skinIndex].boneOffsets.push_back(boneOffset);
+            boneOffset += node.skin->joints_count;
         }
     }
     for (cgltf_size i = 0, len = gltf->skins_count; i < len; ++i) {
@@ -198,6 +444,37 @@ static void convertBytesToShorts(uint16_t* dst, const uint8_t* src, size_t count
     }
 }
 
+// Narrows strided float32 elements to tightly packed half-precision floats. AssetLoader has
+// already checked the accessor bounds, so every value is representable.
+static void convertFloatsToHalfs(half* dst, const uint8_t* src, size_t count, size_t dim,
+        size_t stride) {
+    for (size_t i = 0; i < count; ++i, src += stride) {
+        const float* element = (const float*) src;
+        for (size_t d = 0; d < dim; ++d) {
+            *dst++ = half(element[d]);
+        }
+    }
+}
+
+// Reorders a triangle list in place for post-transform vertex cache locality and logs the
+// average cache miss ratio (transformed vertices per triangle; worst case 3.0, optimum
+// around 0.5). The vertex count is derived from the indices since the index accessor does
+// not know it.
+template<typename INDEX>
+static void optimizeIndices(INDEX* indices, size_t indexCount) {
+    size_t vertexCount = 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        vertexCount = std::max(vertexCount, size_t(indices[i]) + 1);
+    }
+    const float before = meshopt_analyzeVertexCache(indices, indexCount, vertexCount,
+            32, 0, 0).acmr;
+    meshopt_optimizeVertexCache(indices, indices, indexCount, vertexCount);
+    const float after = meshopt_analyzeVertexCache(indices, indexCount, vertexCount,
+            32, 0, 0).acmr;
+    slog.i << "Optimized " << indexCount / 3 << " triangles for the vertex cache, ACMR "
+            << before << " -> " << after << io::endl;
+}
+
 static ComponentType getComponentType(const cgltf_accessor* accessor) {
     switch (accessor->component_type) {
         case cgltf_component_type_r_8: return ComponentType::BYTE;
@@ -225,9 +502,24 @@ static void convertToFloats(float* dest, const cgltf_accessor* accessor) {
     transcode(dest, source, accessor->count);
 }
 
-static void decodeDracoMeshes(FFilamentAsset* asset) {
+static void decodeDracoMeshes(JobSystem& js, FFilamentAsset* asset) {
     DracoCache* dracoCache = &asset->mSourceAsset->dracoCache;
 
+    // Fan the decodes out as parallel jobs before the serial conversion pass below. Decoding
+    // dominates the cost for Draco-heavy assets and each compressed mesh is independent; the
+    // conversions stay serial because primitives can share meshes and accessors.
+    std::vector<const cgltf_buffer_view*> dracoViews;
+    dracoViews.reserve(asset->mPrimitives.size());
+    for (auto& pair : asset->mPrimitives) {
+        const cgltf_primitive* prim = pair.first;
+        if (prim->has_draco_mesh_compression) {
+            dracoViews.push_back(prim->draco_mesh_compression.buffer_view);
+        }
+    }
+    if (!dracoViews.empty()) {
+        dracoCache->decodeMeshes(js, dracoViews.data(), dracoViews.size());
+    }
+
     // For a given primitive and attribute, find the corresponding accessor.
     auto findAccessor = [](const cgltf_primitive* prim, cgltf_attribute_type type, cgltf_int idx) {
         for (cgltf_size i = 0; i < prim->attributes_count; i++) {
@@ -365,6 +657,14 @@ bool ResourceLoader::loadResources(FFilamentAsset* asset, bool async) {
     const cgltf_data* gltf = asset->mSourceAsset->hierarchy;
     cgltf_options options {};
 
+    // Buffer blobs loaded here are freed by cgltf_free() through the memory callbacks that
+    // the hierarchy was parsed with, so they must come from the same per-asset arena.
+    if (LoadArena* const arena = asset->mSourceAsset->arena.get()) {
+        options.memory.alloc = LoadArena::cgltfAlloc;
+        options.memory.free = LoadArena::cgltfFree;
+        options.memory.user_data = arena;
+    }
+
     // For emscripten and Android builds we have a custom implementation of cgltf_load_buffers which
     // looks inside a cache of externally-supplied data blobs, rather than loading from the
     // filesystem.
@@ -445,7 +745,7 @@ bool ResourceLoader::loadResources(FFilamentAsset* asset, bool async) {
 
     // Decompress Draco meshes early on, which allows us to exploit subsequent processing such as
     // tangent generation.
-    decodeDracoMeshes(asset);
+    decodeDracoMeshes(pImpl->mEngine->getJobSystem(), asset);
 
     // Normalize skinning weights, then "import" each skin into the asset by building a mapping of
     // skins to their affected entities.
@@ -485,6 +785,17 @@ bool ResourceLoader::loadResources(FFilamentAsset* asset, bool async) {
         const uint8_t* data = computeBindingOffset(accessor) + bufferData;
         const uint32_t size = computeBindingSize(accessor);
         if (slot.vertexBuffer) {
+            if (slot.halfFloats) {
+                const size_t dim = cgltf_num_components(accessor->type);
+                const size_t halfsSize = accessor->count * sizeof(half) * dim;
+                half* halfsData = (half*) malloc(halfsSize);
+                convertFloatsToHalfs(halfsData, data, accessor->count, dim, accessor->stride);
+                BufferObject* bo = BufferObject::Builder().size(halfsSize).build(engine);
+                asset->mBufferObjects.push_back(bo);
+                bo->setBuffer(engine, BufferDescriptor(halfsData, halfsSize, FREE_CALLBACK));
+                slot.vertexBuffer->setBufferObjectAt(engine, slot.bufferIndex, bo);
+                continue;
+            }
             if (requiresConversion(accessor->type, accessor->component_type)) {
                 const size_t dim = cgltf_num_components(accessor->type);
                 const size_t floatsSize = accessor->count * sizeof(float) * dim;
@@ -503,14 +814,34 @@ bool ResourceLoader::loadResources(FFilamentAsset* asset, bool async) {
             slot.vertexBuffer->setBufferObjectAt(engine, slot.bufferIndex, bo);
             continue;
         } else if (slot.indexBuffer) {
+            const size_t indexCount = accessor->count;
+            const bool optimize = pImpl->mOptimizeIndexBuffers && slot.triangleIndices &&
+                    indexCount >= 3 && indexCount % 3 == 0;
             if (accessor->component_type == cgltf_component_type_r_8u) {
                 const size_t size16 = size * 2;
                 uint16_t* data16 = (uint16_t*) malloc(size16);
                 convertBytesToShorts(data16, data, size);
+                if (optimize) {
+                    optimizeIndices(data16, indexCount);
+                }
                 IndexBuffer::BufferDescriptor bd(data16, size16, FREE_CALLBACK);
                 slot.indexBuffer->setBuffer(engine, std::move(bd));
                 continue;
             }
+            if (optimize) {
+                // The source buffer might be shared with other accessors, so reorder a copy
+                // and free it after the upload.
+                uint8_t* copy = (uint8_t*) malloc(size);
+                memcpy(copy, data, size);
+                if (accessor->component_type == cgltf_component_type_r_16u) {
+                    optimizeIndices((uint16_t*) copy, indexCount);
+                } else {
+                    optimizeIndices((uint32_t*) copy, indexCount);
+                }
+                IndexBuffer::BufferDescriptor bd(copy, size, FREE_CALLBACK);
+                slot.indexBuffer->setBuffer(engine, std::move(bd));
+                continue;
+            }
             IndexBuffer::BufferDescriptor bd(data, size, uploadCallback, uploadUserdata(asset));
             slot.indexBuffer->setBuffer(engine, std::move(bd));
             continue;
@@ -558,74 +889,133 @@ float ResourceLoader::asyncGetLoadProgress() const {
 }
 
 void ResourceLoader::asyncUpdateLoad() {
+    // Bounds the main-thread cost of a single update; textures that don't fit within the
+    // budget are uploaded by subsequent calls, so large scenes stream in over several frames
+    // instead of hitching on the first one where everything happens to be decoded.
+    constexpr size_t UPLOAD_BUDGET_PER_UPDATE = 16u * 1024u * 1024u;
     if (!UTILS_HAS_THREADING) {
         pImpl->decodeSingleTexture();
     }
-    pImpl->uploadPendingTextures();
+    pImpl->uploadPendingTextures(UPLOAD_BUDGET_PER_UPDATE);
 }
 
 void ResourceLoader::Impl::decodeSingleTexture() {
     assert(!UTILS_HAS_THREADING);
-    int w, h, c;
 
-    // Check if any buffer-based textures haven't been decoded yet.
-    for (auto& pair : mBufferTextureCache) {
-        const uint8_t* sourceData = (const uint8_t*) pair.first;
-        TextureCacheEntry* entry = pair.second.get();
-        if (entry->texels) {
+    // Decode the highest-priority texture that hasn't been decoded yet.
+    for (TextureCacheEntry* entry : mOrderedEntries) {
+        if (entry->texels || entry->completed) {
             continue;
         }
-        entry->texels = stbi_load_from_memory(sourceData, entry->bufferSize, &w, &h, &c, 4);
-        return;
-    }
 
-    // Check if any URI-based textures haven't been decoded yet.
-    for (auto& pair : mUriTextureCache) {
-        auto uri = pair.first;
-        TextureCacheEntry* entry = pair.second.get();
-        if (entry->texels) {
-            continue;
+        // Check if this is a buffer-based texture.
+        if (entry->sourceBuffer) {
+            decodeEntry(entry, entry->sourceBuffer, entry->bufferSize);
+            return;
         }
 
-        // First, check the user-supplied resource cache for this URI.
-        auto iter = mUriDataCache.find(uri);
+        // Otherwise it is URI-based; first check the user-supplied resource cache.
+        auto iter = mUriDataCache.find(entry->uri);
         if (iter != mUriDataCache.end()) {
             const uint8_t* sourceData = (const uint8_t*) iter->second.buffer;
-            entry->texels = stbi_load_from_memory(sourceData, iter->second.size, &w, &h, &c, 4);
+            decodeEntry(entry, sourceData, iter->second.size);
             return;
         }
 
         // Otherwise load it from the file system if this platform supports it.
         #if !USE_FILESYSTEM
-            slog.e << "Unable to load texture: " << uri << io::endl;
+            slog.e << "Unable to load texture: " << entry->uri << io::endl;
             entry->completed = true;
             mNumDecoderTasksFinished++;
             return;
         #else
-            Path fullpath = Path(mGltfPath).getParent() + uri;
-            entry->texels = stbi_load(fullpath.c_str(), &w, &h, &c, 4);
+            Path fullpath = Path(mGltfPath).getParent() + entry->uri;
+            decodeEntryFromFile(entry, fullpath);
             return;
         #endif
     }
 }
 
-void ResourceLoader::Impl::uploadPendingTextures() {
-    auto upload = [this](TextureCacheEntry* entry, Engine& engine) {
+void ResourceLoader::Impl::decodeEntry(TextureCacheEntry* entry, const uint8_t* sourceData,
+        size_t sourceSize) {
+    // TODO: support KHR_texture_basisu here by transcoding KTX2/BasisU payloads to the best
+    //       native compressed format (ASTC / ETC2 / BC) on these same decode jobs. This needs
+    //       the basis_universal transcoder to be brought into third_party first; the upload
+    //       side already supports compressed pixel data.
+#if USE_FILESYSTEM
+    if (!mTextureCacheFolder.empty()) {
+        decodeWithTranscodeCache(mTextureCacheFolder, sourceData, sourceSize, entry);
+        return;
+    }
+#endif
+    int width, height, comp;
+    entry->texels = stbi_load_from_memory(sourceData, int(sourceSize), &width, &height, &comp, 4);
+}
+
+#if USE_FILESYSTEM
+void ResourceLoader::Impl::decodeEntryFromFile(TextureCacheEntry* entry, const Path& fullpath) {
+    if (!mTextureCacheFolder.empty()) {
+        // read the whole file so its bytes can be hashed for the transcode cache key
+        if (FILE* file = fopen(fullpath.c_str(), "rb")) {
+            fseek(file, 0, SEEK_END);
+            const long fileSize = ftell(file);
+            fseek(file, 0, SEEK_SET);
+            uint8_t* sourceData = (uint8_t*) malloc(fileSize);
+            const bool ok = fread(sourceData, fileSize, 1, file) == 1;
+            fclose(file);
+            if (ok) {
+                decodeWithTranscodeCache(mTextureCacheFolder, sourceData, fileSize, entry);
+                free(sourceData);
+                return;
+            }
+            free(sourceData);
+        }
+    }
+    int width, height, comp;
+    entry->texels = stbi_load(fullpath.c_str(), &width, &height, &comp, 4);
+}
+#endif
+
+void ResourceLoader::Impl::uploadPendingTextures(size_t byteBudget) {
+    size_t uploadedBytes = 0;
+    auto upload = [this, &uploadedBytes](TextureCacheEntry* entry, Engine& engine) {
         Texture* texture = entry->texture;
         uint8_t* texels = entry->texels;
         if (texture && texels && !entry->completed) {
-            Texture::PixelBufferDescriptor pbd(texels,
-                    texture->getWidth() * texture->getHeight() * 4,
+            const size_t size = texture->getWidth() * texture->getHeight() * 4;
+            Texture::PixelBufferDescriptor pbd(texels, size,
                     Texture::Format::RGBA, Texture::Type::UBYTE, FREE_CALLBACK);
             texture->setImage(engine, 0, std::move(pbd));
-            texture->generateMipmaps(engine);
+            uploadedBytes += size;
+            if (entry->mips.empty()) {
+                texture->generateMipmaps(engine);
+            } else {
+                // the decode job produced the whole mip chain on the CPU (transcode cache path)
+                for (size_t level = 1; level <= entry->mips.size(); level++) {
+                    uint8_t* mip = entry->mips[level - 1];
+                    const size_t mipSize =
+                            texture->getWidth(level) * texture->getHeight(level) * 4;
+                    Texture::PixelBufferDescriptor mbd(mip, mipSize,
+                            Texture::Format::RGBA, Texture::Type::UBYTE, FREE_CALLBACK);
+                    texture->setImage(engine, level, std::move(mbd));
+                    uploadedBytes += mipSize;
+                }
+                entry->mips.clear();
+            }
             entry->completed = true;
             mNumDecoderTasksFinished++;
             mCurrentAsset->mDependencyGraph.markAsReady(texture);
         }
     };
-    for (auto& pair : mBufferTextureCache) upload(pair.second.get(), *mEngine);
-    for (auto& pair : mUriTextureCache) upload(pair.second.get(), *mEngine);
+    // The budget bounds the amount of texel data handed to the backend per call; entries over
+    // budget are simply picked up by a later call. At least one texture is always uploaded so
+    // progress cannot stall.
+    for (TextureCacheEntry* entry : mOrderedEntries) {
+        if (uploadedBytes >= byteBudget) {
+            break;
+        }
+        upload(entry, *mEngine);
+    }
 }
 
 void ResourceLoader::Impl::releasePendingTextures() {
@@ -636,6 +1026,10 @@ void ResourceLoader::Impl::releasePendingTextures() {
             // Normally the ownership of these texels is transferred to PixelBufferDescriptor, but
             // if uploads have been cancelled then we need to free them explicitly.
             free(texels);
+            for (uint8_t* mip : entry->mips) {
+                free(mip);
+            }
+            entry->mips.clear();
         }
     };
     for (auto& pair : mBufferTextureCache) release(pair.second.get(), *mEngine);
@@ -657,10 +1051,13 @@ void ResourceLoader::Impl::addTextureCacheEntry(const TextureSlot& tb) {
         const uint8_t* sourceData = offset + (const uint8_t*) *data;
         entry = mBufferTextureCache[sourceData] ? mBufferTextureCache[sourceData].get() : nullptr;
         if (entry) {
+            entry->refCount++;
             return;
         }
         entry = (mBufferTextureCache[sourceData] = std::make_unique<TextureCacheEntry>()).get();
         entry->srgb = tb.srgb;
+        entry->refCount = 1;
+        entry->sourceBuffer = sourceData;
         if (!stbi_info_from_memory(sourceData, totalSize, &entry->width, &entry->height,
                 &entry->numComponents)) {
             slog.e << "Unable to decode BufferView texture: " << stbi_failure_reason() << io::endl;
@@ -674,11 +1071,14 @@ void ResourceLoader::Impl::addTextureCacheEntry(const TextureSlot& tb) {
     // Check if we already created a Texture object for this URI.
     entry = mUriTextureCache[uri] ? mUriTextureCache[uri].get() : nullptr;
     if (entry) {
+        entry->refCount++;
         return;
     }
 
     entry = (mUriTextureCache[uri] = std::make_unique<TextureCacheEntry>()).get();
     entry->srgb = tb.srgb;
+    entry->refCount = 1;
+    entry->uri = uri;
 
     // Check if this is a data URI. We don't care about the MIME type since stb can infer it.
     std::string mimeType;
@@ -749,6 +1149,7 @@ void ResourceLoader::Impl::cancelTextureDecoding() {
         mDecoderRootJob = nullptr;
     }
     releasePendingTextures();
+    mOrderedEntries.clear();
     mBufferTextureCache.clear();
     mUriTextureCache.clear();
     mCurrentAsset = nullptr;
@@ -766,6 +1167,7 @@ bool ResourceLoader::Impl::createTextures(bool async) {
 
     mBufferTextureCache.clear();
     mUriTextureCache.clear();
+    mOrderedEntries.clear();
 
     // First, determine texture dimensions and create texture cache entries.
     FFilamentAsset* asset = mCurrentAsset;
@@ -802,6 +1204,16 @@ bool ResourceLoader::Impl::createTextures(bool async) {
         bindTextureToMaterial(slot);
     }
 
+    // Sort the entries so that the most-referenced textures are decoded and uploaded first;
+    // those tend to belong to the most prominent materials of the scene.
+    mOrderedEntries.reserve(mNumDecoderTasks);
+    for (auto& pair : mBufferTextureCache) mOrderedEntries.push_back(pair.second.get());
+    for (auto& pair : mUriTextureCache) mOrderedEntries.push_back(pair.second.get());
+    std::stable_sort(mOrderedEntries.begin(), mOrderedEntries.end(),
+            [](TextureCacheEntry const* lhs, TextureCacheEntry const* rhs) {
+                return lhs->refCount > rhs->refCount;
+            });
+
     // Before creating jobs for PNG / JPEG decoding, we might need to return early. On single
     // threaded systems, it is usually fine to create jobs because the job system will simply
     // execute serially. However if the client requests async behavior, then we need to wait
@@ -816,31 +1228,26 @@ bool ResourceLoader::Impl::createTextures(bool async) {
     // the texture decoding process.
     FFilamentAsset::SourceHandle retainSourceAsset = asset->mSourceAsset;
 
-    // Kick off jobs that decode texels from buffer pointers.
-    for (auto& pair : mBufferTextureCache) {
-        const uint8_t* sourceData = (const uint8_t*) pair.first;
-        TextureCacheEntry* entry = pair.second.get();
-        JobSystem::Job* decode = jobs::createJob(*js, parent, [retainSourceAsset, entry, sourceData] {
-            int width, height, comp;
-            entry->texels = stbi_load_from_memory(sourceData, entry->bufferSize,
-                    &width, &height, &comp, 4);
-        });
-        js->run(decode);
-    }
-
-    // Kick off jobs that decode texels from URI strings.
-    for (auto& pair : mUriTextureCache) {
-        auto uri = pair.first;
-        TextureCacheEntry* entry = pair.second.get();
+    // Kick off decode jobs in priority order; the job system dequeues in roughly submission
+    // order, so the most-referenced textures are likely to become ready first.
+    for (TextureCacheEntry* entry : mOrderedEntries) {
+        // Check if this is a buffer-based texture.
+        if (const uint8_t* sourceData = entry->sourceBuffer; sourceData) {
+            JobSystem::Job* decode = jobs::createJob(*js, parent,
+                    [this, retainSourceAsset, entry, sourceData] {
+                decodeEntry(entry, sourceData, entry->bufferSize);
+            });
+            js->run(decode);
+            continue;
+        }
 
-        // First, check the user-supplied resource cache for this URI.
-        auto iter = mUriDataCache.find(uri);
+        // Otherwise it is URI-based; first check the user-supplied resource cache.
+        auto iter = mUriDataCache.find(entry->uri);
         if (iter != mUriDataCache.end()) {
             const uint8_t* sourceData = (const uint8_t*) iter->second.buffer;
-            JobSystem::Job* decode = jobs::createJob(*js, parent, [retainSourceAsset, entry, sourceData, iter] {
-                int width, height, comp;
-                entry->texels = stbi_load_from_memory(sourceData, iter->second.size, &width,
-                        &height, &comp, 4);
+            JobSystem::Job* decode = jobs::createJob(*js, parent,
+                    [this, retainSourceAsset, entry, sourceData, iter] {
+                decodeEntry(entry, sourceData, iter->second.size);
             });
             js->run(decode);
             continue;
@@ -848,13 +1255,13 @@ bool ResourceLoader::Impl::createTextures(bool async) {
 
         // Otherwise load it from the file system if this platform supports it.
         #if !USE_FILESYSTEM
-            slog.e << "Unable to load texture: " << uri << io::endl;
+            slog.e << "Unable to load texture: " << entry->uri << io::endl;
             return false;
         #else
-            Path fullpath = Path(mGltfPath).getParent() + uri;
-            JobSystem::Job* decode = jobs::createJob(*js, parent, [retainSourceAsset, entry, fullpath] {
-                int width, height, comp;
-                entry->texels = stbi_load(fullpath.c_str(), &width, &height, &comp, 4);
+            Path fullpath = Path(mGltfPath).getParent() + entry->uri;
+            JobSystem::Job* decode = jobs::createJob(*js, parent,
+                    [this, retainSourceAsset, entry, fullpath] {
+                decodeEntryFromFile(entry, fullpath);
             });
             js->run(decode);
         #endif
@@ -940,12 +1347,29 @@ void ResourceLoader::Impl::computeTangents(FFilamentAsset* asset) {
         }
     }
 
-    // Kick off jobs for computing tangent frames.
+    // Kick off jobs for computing tangent frames. Consecutive small primitives are folded into
+    // a single job to amortize scheduling overhead; assets made of many tiny meshes would
+    // otherwise spend more time in the job system than in the tangent math itself. Primitives
+    // at or above the threshold still get a job of their own.
+    constexpr size_t MIN_VERTICES_PER_JOB = 4096;
     JobSystem* js = &mEngine->getJobSystem();
     JobSystem::Job* parent = js->createJob();
-    for (Params& params : jobParams) {
-        Params* pptr = &params;
-        js->run(jobs::createJob(*js, parent, [pptr] { TangentsJob::run(pptr); }));
+    for (size_t first = 0, jobCount = jobParams.size(); first < jobCount;) {
+        size_t last = first;
+        size_t vertices = 0;
+        do {
+            const cgltf_primitive* prim = jobParams[last].in.prim;
+            vertices += prim->attributes_count > 0 ? prim->attributes[0].data->count : 0;
+            ++last;
+        } while (last < jobCount && vertices < MIN_VERTICES_PER_JOB);
+        Params* pptr = jobParams.data() + first;
+        const size_t n = last - first;
+        js->run(jobs::createJob(*js, parent, [pptr, n] {
+            for (size_t i = 0; i < n; ++i) {
+                TangentsJob::run(pptr + i);
+            }
+        }));
+        first = last;
     }
     js->runAndWait(parent);
 
@@ -22,6 +22,8 @@
 
 #include <filament/Texture.h>
 
+#include <math/vec3.h>
+
 namespace filament {
 class Engine;
 class View;
@@ -225,6 +227,50 @@ public:
         uint8_t mLevelCount = 1u;
     };
 
+    /**
+     * SHProjection computes the 3-bands spherical harmonics coefficients of an environment
+     * cubemap entirely on the GPU. Only the nine resulting coefficients are read back, which
+     * replaces the full-size cubemap readback and CPU projection otherwise needed when
+     * swapping environments at runtime.
+     */
+    class SHProjection {
+    public:
+        /**
+         * Creates a SHProjection processor.
+         * @param context IBLPrefilterContext to use
+         */
+        explicit SHProjection(IBLPrefilterContext& context);
+
+        /**
+         * Destroys all GPU resources created during initialization.
+         */
+        ~SHProjection() noexcept;
+
+        SHProjection(SHProjection const&) = delete;
+        SHProjection& operator=(SHProjection const&) = delete;
+        SHProjection(SHProjection&& rhs) noexcept;
+        SHProjection& operator=(SHProjection&& rhs) noexcept;
+
+        /**
+         * Computes the spherical harmonics coefficients of an environment cubemap.
+         * This call is synchronous, it waits for the GPU to complete the projection and
+         * the readback of the coefficients.
+         * @param environmentCubemap    Environment cubemap (input). Can't be null.
+         *                              This cubemap must be SAMPLEABLE and must have all its
+         *                              levels allocated; the mipmap chain is regenerated and
+         *                              used as the reduction pyramid of the projection.
+         * @param outSh                 Receives the nine math::float3 coefficients of the
+         *                              radiance, suitable for IndirectLight::Builder::radiance().
+         */
+        void operator()(filament::Texture const* environmentCubemap,
+                filament::math::float3 outSh[9]);
+
+    private:
+        IBLPrefilterContext& mContext;
+        filament::Material* mShMaterial = nullptr;
+        filament::Texture* mShTexture = nullptr;
+    };
+
 private:
     friend class Filter;
     filament::Engine& mEngine;
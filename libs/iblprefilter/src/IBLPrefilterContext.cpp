@@ -474,3 +474,108 @@ Texture* IBLPrefilterContext::SpecularFilter::operator()(
 
     return outReflectionsTexture;
 }
+
+// ------------------------------------------------------------------------------------------------
+
+IBLPrefilterContext::SHProjection::SHProjection(IBLPrefilterContext& context)
+        : mContext(context) {
+    Engine& engine = mContext.mEngine;
+
+    mShMaterial = Material::Builder().package(
+            IBLPREFILTER_MATERIALS_SHPROJECTION_DATA,
+            IBLPREFILTER_MATERIALS_SHPROJECTION_SIZE).build(engine);
+
+    // one pixel per SH coefficient
+    mShTexture = Texture::Builder()
+            .sampler(Texture::Sampler::SAMPLER_2D)
+            .format(Texture::InternalFormat::RGBA32F)
+            .usage(Texture::Usage::COLOR_ATTACHMENT)
+            .width(9).height(1)
+            .build(engine);
+}
+
+IBLPrefilterContext::SHProjection::~SHProjection() noexcept {
+    Engine& engine = mContext.mEngine;
+    engine.destroy(mShTexture);
+    engine.destroy(mShMaterial);
+}
+
+IBLPrefilterContext::SHProjection::SHProjection(SHProjection&& rhs) noexcept
+        : mContext(rhs.mContext) {
+    this->operator=(std::move(rhs));
+}
+
+IBLPrefilterContext::SHProjection&
+IBLPrefilterContext::SHProjection::operator=(SHProjection&& rhs) noexcept {
+    using std::swap;
+    if (this != &rhs) {
+        swap(mShMaterial, rhs.mShMaterial);
+        swap(mShTexture, rhs.mShTexture);
+    }
+    return *this;
+}
+
+void IBLPrefilterContext::SHProjection::operator()(
+        Texture const* environmentCubemap, float3 outSh[9]) {
+    SYSTRACE_CALL();
+    using namespace backend;
+
+    ASSERT_PRECONDITION(environmentCubemap != nullptr, "environmentCubemap is null!");
+
+    ASSERT_PRECONDITION(environmentCubemap->getTarget() == Texture::Sampler::SAMPLER_CUBEMAP,
+            "environmentCubemap must be a cubemap.");
+
+    UTILS_UNUSED_IN_RELEASE
+    const uint8_t maxLevelCount = uint8_t(std::log2(environmentCubemap->getWidth()) + 0.5f) + 1u;
+
+    ASSERT_PRECONDITION(environmentCubemap->getLevels() == maxLevelCount,
+            "environmentCubemap must have %u mipmap levels allocated.", +maxLevelCount);
+
+    Engine& engine = mContext.mEngine;
+    View* const view = mContext.mView;
+    Renderer* const renderer = mContext.mRenderer;
+    MaterialInstance* const mi = mShMaterial->getDefaultInstance();
+
+    RenderableManager& rcm = engine.getRenderableManager();
+    rcm.setMaterialInstanceAt(
+            rcm.getInstance(mContext.mFullScreenQuadEntity), 0, mi);
+
+    // The mipmap chain is our reduction pyramid: band 0-2 SH are very low frequency, so we
+    // can project a small box-filtered mip instead of the full resolution environment.
+    environmentCubemap->generateMipmaps(engine);
+
+    const uint32_t width = environmentCubemap->getWidth();
+    const uint32_t sampleDim = std::min(32u, width);
+
+    TextureSampler environmentSampler;
+    environmentSampler.setMagFilter(SamplerMagFilter::LINEAR);
+    environmentSampler.setMinFilter(SamplerMinFilter::LINEAR_MIPMAP_LINEAR);
+
+    mi->setParameter("environment", environmentCubemap, environmentSampler);
+    mi->setParameter("lod", std::log2(float(width) / float(sampleDim)));
+    mi->setParameter("sampleDim", int32_t(sampleDim));
+
+    RenderTarget* const rt = RenderTarget::Builder()
+            .texture(RenderTarget::AttachmentPoint::COLOR0, mShTexture)
+            .build(engine);
+
+    view->setRenderTarget(rt);
+    view->setViewport({ 0, 0, 9, 1 });
+
+    renderer->renderStandaloneView(view);
+
+    float4 coefficients[9];
+    renderer->readPixels(rt, 0, 0, 9, 1,
+            Texture::PixelBufferDescriptor{
+                    coefficients, sizeof(coefficients),
+                    Texture::Format::RGBA, Texture::Type::FLOAT });
+
+    // wait for the readback -- this is where the synchronous nature of this call comes from
+    engine.flushAndWait();
+
+    engine.destroy(rt);
+
+    for (size_t i = 0; i < 9; i++) {
+        outSh[i] = coefficients[i].xyz;
+    }
+}
@@ -21,6 +21,10 @@
 
 #include <utils/compiler.h>
 
+namespace utils {
+class JobSystem;
+} // namespace utils
+
 namespace image {
 
 /**
@@ -114,6 +118,19 @@ UTILS_PUBLIC
 LinearImage resampleImage(const LinearImage& source, uint32_t width, uint32_t height,
         Filter filter = Filter::DEFAULT);
 
+/**
+ * Same as resampleImage, but distributes rows over the given JobSystem. The result is identical
+ * to the single-threaded version.
+ */
+UTILS_PUBLIC
+LinearImage resampleImage(utils::JobSystem& js, const LinearImage& source,
+        uint32_t width, uint32_t height, const ImageSampler& sampler);
+
+/** \copydoc resampleImage(utils::JobSystem&, const LinearImage&, uint32_t, uint32_t, const ImageSampler&) */
+UTILS_PUBLIC
+LinearImage resampleImage(utils::JobSystem& js, const LinearImage& source,
+        uint32_t width, uint32_t height, Filter filter = Filter::DEFAULT);
+
 /**
  * Computes a single sample for the given texture coordinate and writes the resulting color
  * components into the given output holder.
@@ -145,6 +162,13 @@ void computeSingleSample(const LinearImage& source, float x, float y, SingleSamp
 UTILS_PUBLIC
 void generateMipmaps(const LinearImage& source, Filter, LinearImage* result, uint32_t mipCount);
 
+/**
+ * Same as generateMipmaps, but distributes the resampling work over the given JobSystem.
+ */
+UTILS_PUBLIC
+void generateMipmaps(utils::JobSystem& js, const LinearImage& source, Filter,
+        LinearImage* result, uint32_t mipCount);
+
 /**
  * Returns the number of miplevels it would take to downsample the given image down to 1x1. This
  * number does not include the original image (i.e. mip 0).
@@ -73,6 +73,14 @@ public:
      */
     KtxBundle(uint32_t numMipLevels, uint32_t arrayLength, bool isCubemap);
 
+    /**
+     * Memory ownership policy for the deserializing constructor.
+     */
+    enum class Ownership {
+        COPY,      //!< blob data is copied into heap storage owned by the bundle
+        REFERENCE, //!< blob data stays in the caller's buffer, getBlob() returns views into it
+    };
+
     /**
      * Creates a new bundle by deserializing the given data.
      *
@@ -80,6 +88,17 @@ public:
      */
     KtxBundle(uint8_t const* bytes, uint32_t nbytes);
 
+    /**
+     * Creates a new bundle by deserializing the given data, with the given ownership policy.
+     *
+     * With Ownership::REFERENCE the bundle never copies the texture payload: getBlob() returns
+     * pointers directly into the given buffer, which is typically a read-only mapping of a KTX
+     * file. The caller must keep the buffer alive and unchanged for the lifetime of the bundle,
+     * and must not write through the returned pointers. Bundles created this way are immutable,
+     * setBlob() and allocateBlob() fail.
+     */
+    KtxBundle(uint8_t const* bytes, uint32_t nbytes, Ownership ownership);
+
     /**
      * Serializes the bundle into the given target memory. Returns false if there's not enough
      * memory.
@@ -146,6 +165,15 @@ public:
      */
     bool allocateBlob(KtxBlobIndex index, uint32_t size);
 
+    /**
+     * Discards the data of a single blob, typically after it has been consumed (e.g. uploaded to
+     * the GPU). In owning bundles the underlying storage is compacted, so releasing each miplevel
+     * after its upload keeps peak residency close to the largest remaining level instead of the
+     * whole bundle. Subsequent calls to getBlob() for this index fail. Returns false if the given
+     * blob index is out of bounds.
+     */
+    bool releaseBlob(KtxBlobIndex index);
+
     // The following constants help clients populate the "info" struct. Most of them have corollary
     // constants in the OpenGL headers.
 
@@ -274,6 +302,15 @@ private:
     std::unique_ptr<KtxMetadata> mMetadata;
 };
 
+/**
+ * Converts a bundle's uncompressed HALF or FLOAT, RGB or RGBA pixel data to packed
+ * R11F_G11F_B10F in place, shrinking HDR environment data 2x to 4x. The alpha channel,
+ * if present, is discarded; negative values clamp to zero. The precision loss is not
+ * visible on typical skybox / IBL content. Returns false (leaving the bundle untouched)
+ * if the bundle holds any other format, or is an immutable Ownership::REFERENCE bundle.
+ */
+UTILS_PUBLIC bool packHdrTo101111(KtxBundle& bundle);
+
 } // namespace image
 
 #endif /* IMAGE_KTXBUNDLE_H */
@@ -22,6 +22,8 @@
 
 #include <image/KtxBundle.h>
 
+#include <vector>
+
 namespace image {
 
 /**
@@ -152,6 +154,88 @@ namespace ktx {
         return createTexture(engine, *ktx, srgb, freeKtx, ktx);
     }
 
+    namespace details {
+        // Refcounted cache of textures created with createSharedTexture(), keyed by a hash
+        // of the bundle contents. A function-local static keeps this header-only.
+        struct SharedTextureCache {
+            struct Entry {
+                Engine* engine;
+                Texture* texture;
+                uint64_t key;
+                uint32_t refs;
+            };
+            std::vector<Entry> entries;
+        };
+
+        inline SharedTextureCache& sharedTextureCache() {
+            static SharedTextureCache cache;
+            return cache;
+        }
+
+        // FNV-1a, seedable so the bundle info and payload can be hashed in sequence
+        inline uint64_t hashBytes(void const* data, size_t size, uint64_t hash) {
+            uint8_t const* p = (uint8_t const*) data;
+            for (size_t i = 0; i < size; ++i) {
+                hash = (hash ^ p[i]) * 0x100000001b3ull;
+            }
+            return hash;
+        }
+    } // namespace details
+
+    /**
+     * Same as createTexture() but deduplicated: if a texture with identical content was
+     * already created through this function (and not yet released), it is returned and the
+     * bundle is destroyed immediately. This lets an IndirectLight and a Skybox built from
+     * the same environment share one cubemap. Textures obtained here must be released with
+     * releaseTexture() instead of Engine::destroy().
+     *
+     * @param engine Used to create the Filament Texture
+     * @param ktx In-memory representation of a KTX file, destroyed by this call
+     * @param srgb Forces the KTX-specified format into an SRGB format if possible
+     */
+    inline Texture* createSharedTexture(Engine* engine, KtxBundle* ktx, bool srgb) {
+        uint64_t key = 0xcbf29ce484222325ull;
+        key = details::hashBytes(&ktx->getInfo(), sizeof(KtxInfo), key);
+        uint8_t const nfaces = ktx->isCubemap() ? 6 : 1;
+        key = details::hashBytes(&nfaces, 1, key);
+        key = details::hashBytes(&srgb, 1, key);
+        uint8_t* data;
+        uint32_t size;
+        if (ktx->getBlob({0, 0, 0}, &data, &size)) {
+            key = details::hashBytes(data, size_t(size) * nfaces, key);
+        }
+        auto& cache = details::sharedTextureCache();
+        for (auto& entry : cache.entries) {
+            if (entry.key == key && entry.engine == engine) {
+                ++entry.refs;
+                delete ktx;
+                return entry.texture;
+            }
+        }
+        Texture* texture = createTexture(engine, ktx, srgb);
+        cache.entries.push_back({engine, texture, key, 1});
+        return texture;
+    }
+
+    /**
+     * Releases a texture obtained from createSharedTexture(); it is destroyed when its last
+     * reference goes away. Textures unknown to the cache (e.g. from createTexture()) are
+     * destroyed immediately, so this is always a safe replacement for Engine::destroy().
+     */
+    inline void releaseTexture(Engine* engine, Texture* texture) {
+        auto& cache = details::sharedTextureCache();
+        for (auto it = cache.entries.begin(); it != cache.entries.end(); ++it) {
+            if (it->texture == texture && it->engine == engine) {
+                if (--it->refs == 0) {
+                    cache.entries.erase(it);
+                    engine->destroy(texture);
+                }
+                return;
+            }
+        }
+        engine->destroy(texture);
+    }
+
     template<typename T>
     T toCompressedFilamentEnum(uint32_t format) {
         switch (format) {
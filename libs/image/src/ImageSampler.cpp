@@ -23,6 +23,7 @@
 
 #include <utils/Panic.h>
 #include <utils/CString.h>
+#include <utils/JobSystem.h>
 
 #include <memory>
 #include <vector>
@@ -172,22 +173,64 @@ void generateMadProgram(uint32_t ntarget, uint32_t nsource, float left, float ri
     }
 }
 
-// Transforms a MAD program intended for single-channel data into a program intended for
-// multi-channel data.
-void expandMadProgram(uint32_t nchannels, MadProgram* program) {
-    if (nchannels == 1) {
-        return;
+// Executes the MAD program over the given range of rows. The instruction indices are in units
+// of whole pixels; each instruction is applied to all channels at once, which lets the compiler
+// vectorize the loads and multiply-adds for the common channel counts.
+template<uint32_t NCHAN>
+void executeMadProgram(const MadProgram& program, float const* UTILS_RESTRICT source,
+        float* UTILS_RESTRICT target, uint32_t swidth, uint32_t twidth,
+        uint32_t rowBegin, uint32_t rowCount) {
+    float const* sourceRow = source + size_t(rowBegin) * swidth * NCHAN;
+    float* targetRow = target + size_t(rowBegin) * twidth * NCHAN;
+    for (uint32_t row = 0; row < rowCount; ++row) {
+        for (auto mad : program) {
+            float const* const s = sourceRow + mad.sourceIndex * int32_t(NCHAN);
+            float* const t = targetRow + mad.targetIndex * NCHAN;
+            for (uint32_t c = 0; c < NCHAN; ++c) {
+                t[c] += s[c] * mad.weight;
+            }
+        }
+        targetRow += twidth * NCHAN;
+        sourceRow += swidth * NCHAN;
     }
-    MadProgram result;
-    result.reserve(program->size() * nchannels);
-    for (auto mad : *program) {
-        mad.sourceIndex *= nchannels;
-        mad.targetIndex *= nchannels;
-        for (uint32_t j = 0; j < nchannels; ++j, ++mad.sourceIndex, ++mad.targetIndex) {
-            result.push_back(mad);
+}
+
+// Same as executeMadProgram for channel counts without a specialization.
+void executeMadProgramGeneric(const MadProgram& program, float const* UTILS_RESTRICT source,
+        float* UTILS_RESTRICT target, uint32_t swidth, uint32_t twidth, uint32_t nchan,
+        uint32_t rowBegin, uint32_t rowCount) {
+    float const* sourceRow = source + size_t(rowBegin) * swidth * nchan;
+    float* targetRow = target + size_t(rowBegin) * twidth * nchan;
+    for (uint32_t row = 0; row < rowCount; ++row) {
+        for (auto mad : program) {
+            float const* const s = sourceRow + mad.sourceIndex * int32_t(nchan);
+            float* const t = targetRow + mad.targetIndex * nchan;
+            for (uint32_t c = 0; c < nchan; ++c) {
+                t[c] += s[c] * mad.weight;
+            }
+        }
+        targetRow += twidth * nchan;
+        sourceRow += swidth * nchan;
+    }
+}
+
+// The MIN filter is special because it starts with non-zero values and ignores filter weights.
+void executeMinProgram(const MadProgram& program, float const* UTILS_RESTRICT source,
+        float* UTILS_RESTRICT target, uint32_t swidth, uint32_t twidth, uint32_t nchan,
+        uint32_t rowBegin, uint32_t rowCount) {
+    float const* sourceRow = source + size_t(rowBegin) * swidth * nchan;
+    float* targetRow = target + size_t(rowBegin) * twidth * nchan;
+    for (uint32_t row = 0; row < rowCount; ++row) {
+        for (auto mad : program) {
+            float const* const s = sourceRow + mad.sourceIndex * int32_t(nchan);
+            float* const t = targetRow + mad.targetIndex * nchan;
+            for (uint32_t c = 0; c < nchan; ++c) {
+                t[c] = std::min(s[c], t[c]);
+            }
         }
+        targetRow += twidth * nchan;
+        sourceRow += swidth * nchan;
     }
-    program->swap(result);
 }
 
 FilterFunction createFilterFunction(Filter ftype) {
@@ -227,7 +270,8 @@ void normalize(LinearImage& image) {
 }
 
 LinearImage resampleImage1D(const LinearImage& source, MadProgram* program,
-        uint32_t twidth, Filter filter, float left, float right, float filterRadiusMultiplier) {
+        uint32_t twidth, Filter filter, float left, float right, float filterRadiusMultiplier,
+        utils::JobSystem* js) {
     const uint32_t swidth = source.getWidth();
     const uint32_t sheight = source.getHeight();
     const uint32_t nchan = source.getChannels();
@@ -235,40 +279,52 @@ LinearImage resampleImage1D(const LinearImage& source, MadProgram* program,
     if (filter == Filter::DEFAULT) filter = mag ? Filter::MITCHELL : Filter::LANCZOS;
     const FilterFunction hfn = createFilterFunction(filter);
 
-    // Generate a flat list of multiply-add (MAD) instructions.
+    // Generate a flat list of multiply-add (MAD) instructions. The instructions address whole
+    // pixels, the row execution kernels apply them to each channel.
     program->clear();
     generateMadProgram(twidth, swidth, left, right, hfn, filterRadiusMultiplier, program);
-    expandMadProgram(nchan, program);
 
     // Allocate the target image.
     LinearImage result(twidth, sheight, nchan);
-    float const* sourceRow = source.getPixelRef();
-    float* targetRow = result.getPixelRef();
+    float const* const sourcePixels = source.getPixelRef();
+    float* const targetPixels = result.getPixelRef();
 
-    // The MIN filter is special because it starts with non-zero values and ignores filter weights.
     if (filter == Filter::MINIMUM) {
         for (uint32_t n = 0; n < twidth * sheight * nchan; ++n) {
-            targetRow[n] = std::numeric_limits<float>::max();
+            targetPixels[n] = std::numeric_limits<float>::max();
         }
-        for (uint32_t row = 0; row < sheight; ++row) {
-            for (auto mad : *program) {
-                const float a = sourceRow[mad.sourceIndex];
-                const float b = targetRow[mad.targetIndex];
-                targetRow[mad.targetIndex] = std::min(a, b);
-            }
-            targetRow += twidth * nchan;
-            sourceRow += swidth * nchan;
-        }
-        return result;
     }
 
     // Resize the image horizontally by executing the MAD instructions over each row.
-    for (uint32_t row = 0; row < sheight; ++row) {
-        for (auto mad : *program) {
-            targetRow[mad.targetIndex] += sourceRow[mad.sourceIndex] * mad.weight;
+    auto processRows = [&](uint32_t rowBegin, uint32_t rowCount) {
+        if (filter == Filter::MINIMUM) {
+            executeMinProgram(*program, sourcePixels, targetPixels,
+                    swidth, twidth, nchan, rowBegin, rowCount);
+            return;
         }
-        targetRow += twidth * nchan;
-        sourceRow += swidth * nchan;
+        switch (nchan) {
+            case 1: executeMadProgram<1>(*program, sourcePixels, targetPixels,
+                            swidth, twidth, rowBegin, rowCount); break;
+            case 2: executeMadProgram<2>(*program, sourcePixels, targetPixels,
+                            swidth, twidth, rowBegin, rowCount); break;
+            case 3: executeMadProgram<3>(*program, sourcePixels, targetPixels,
+                            swidth, twidth, rowBegin, rowCount); break;
+            case 4: executeMadProgram<4>(*program, sourcePixels, targetPixels,
+                            swidth, twidth, rowBegin, rowCount); break;
+            default: executeMadProgramGeneric(*program, sourcePixels, targetPixels,
+                            swidth, twidth, nchan, rowBegin, rowCount); break;
+        }
+    };
+
+    // Rows are independent, so they can be distributed over the JobSystem. Small images are
+    // processed in place -- the overhead of launching jobs would prevail.
+    if (js && sheight >= 64) {
+        using namespace utils;
+        auto* job = jobs::parallel_for(*js, nullptr, 0, sheight,
+                std::cref(processRows), jobs::CountSplitter<32>());
+        js->runAndWait(job);
+    } else {
+        processRows(0, sheight);
     }
 
     // Perform post processing for the current pass.
@@ -286,8 +342,8 @@ SingleSample::~SingleSample() {
     delete[] data;
 }
 
-LinearImage resampleImage(const LinearImage& source, uint32_t width, uint32_t height,
-        const ImageSampler& sampler) {
+static LinearImage resampleImageImpl(const LinearImage& source, uint32_t width, uint32_t height,
+        const ImageSampler& sampler, utils::JobSystem* js) {
     ASSERT_PRECONDITION(
         sampler.east.mode == Boundary::EXCLUDE &&
         sampler.north.mode == Boundary::EXCLUDE &&
@@ -302,11 +358,16 @@ LinearImage resampleImage(const LinearImage& source, uint32_t width, uint32_t he
     const float bottom = sampler.sourceRegion.bottom;
     MadProgram program;
     LinearImage result;
-    result = transpose(resampleImage1D(source, &program, width, hfilter, left, right, radius));
-    result = transpose(resampleImage1D(result, &program, height, vfilter, top, bottom, radius));
+    result = transpose(resampleImage1D(source, &program, width, hfilter, left, right, radius, js));
+    result = transpose(resampleImage1D(result, &program, height, vfilter, top, bottom, radius, js));
     return result;
 }
 
+LinearImage resampleImage(const LinearImage& source, uint32_t width, uint32_t height,
+        const ImageSampler& sampler) {
+    return resampleImageImpl(source, width, height, sampler, nullptr);
+}
+
 LinearImage resampleImage(const LinearImage& source, uint32_t width, uint32_t height,
         Filter filter) {
     return resampleImage(source, width, height, ImageSampler {
@@ -315,6 +376,19 @@ LinearImage resampleImage(const LinearImage& source, uint32_t width, uint32_t he
     });
 }
 
+LinearImage resampleImage(utils::JobSystem& js, const LinearImage& source,
+        uint32_t width, uint32_t height, const ImageSampler& sampler) {
+    return resampleImageImpl(source, width, height, sampler, &js);
+}
+
+LinearImage resampleImage(utils::JobSystem& js, const LinearImage& source,
+        uint32_t width, uint32_t height, Filter filter) {
+    return resampleImage(js, source, width, height, ImageSampler {
+        .horizontalFilter = filter,
+        .verticalFilter = filter
+    });
+}
+
 void computeSingleSample(const LinearImage& source, float x, float y, SingleSample* result,
         Filter filter) {
     const float radius = 1.0f;
@@ -323,8 +397,9 @@ void computeSingleSample(const LinearImage& source, float x, float y, SingleSamp
     const float right = x + radius / source.getWidth();
     const float bottom = y + radius / source.getHeight();
     MadProgram program;
-    LinearImage row = transpose(resampleImage1D(source, &program, 1, filter, left, right, radius));
-    row = resampleImage1D(row, &program, 1, filter, top, bottom, radius);
+    LinearImage row = transpose(
+            resampleImage1D(source, &program, 1, filter, left, right, radius, nullptr));
+    row = resampleImage1D(row, &program, 1, filter, top, bottom, radius, nullptr);
     if (!result->data) {
         result->data = new float[source.getChannels()];
     }
@@ -348,6 +423,18 @@ void generateMipmaps(const LinearImage& source, Filter filter, LinearImage* resu
     }
 }
 
+void generateMipmaps(utils::JobSystem& js, const LinearImage& source, Filter filter,
+        LinearImage* result, uint32_t mips) {
+    mips = std::min(mips, getMipmapCount(source));
+    uint32_t width = source.getWidth();
+    uint32_t height = source.getHeight();
+    for (uint32_t n = 0; n < mips; ++n) {
+        width = std::max(width >> 1u, 1u);
+        height = std::max(height >> 1u, 1u);
+        result[n] = resampleImage(js, source, width, height, filter);
+    }
+}
+
 uint32_t getMipmapCount(const LinearImage& source) {
     uint32_t width = source.getWidth();
     uint32_t height = source.getHeight();
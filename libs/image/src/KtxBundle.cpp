@@ -16,6 +16,8 @@
 
 #include <image/KtxBundle.h>
 
+#include <math/half.h>
+
 #include <utils/Panic.h>
 #include <utils/string.h>
 
@@ -61,6 +63,10 @@ struct KtxBlobList {
     std::vector<uint8_t> blobs;
     std::vector<uint32_t> sizes;
 
+    // Non-empty only for bundles created with Ownership::REFERENCE, in which case each entry
+    // points into the caller's buffer and "blobs" above stays empty.
+    std::vector<uint8_t const*> views;
+
     // Obtains a pointer to the given blob.
     uint8_t* get(uint32_t blobIndex) {
         uint8_t* result = blobs.data();
@@ -108,6 +114,9 @@ KtxBundle::KtxBundle(uint32_t numMipLevels, uint32_t arrayLength, bool isCubemap
 }
 
 KtxBundle::KtxBundle(uint8_t const* bytes, uint32_t nbytes) :
+        KtxBundle(bytes, nbytes, Ownership::COPY) {}
+
+KtxBundle::KtxBundle(uint8_t const* bytes, uint32_t nbytes, Ownership ownership) :
         mBlobs(new KtxBlobList), mMetadata(new KtxMetadata) {
     ASSERT_PRECONDITION(sizeof(SerializationHeader) <= nbytes, "KTX buffer is too small");
 
@@ -150,18 +159,29 @@ KtxBundle::KtxBundle(uint8_t const* bytes, uint32_t nbytes) :
     const bool isNonArrayCube = mNumCubeFaces > 1 && mArrayLength == 1;
     const uint32_t facesPerMip = mArrayLength * mNumCubeFaces;
 
-    // Extract blobs from the serialized byte stream.
-    const uint32_t totalSize = nbytes - (pdata - bytes);
-    mBlobs->blobs.resize(totalSize);
+    // Extract blobs from the serialized byte stream. In COPY mode the payload is copied into
+    // contiguous heap storage; in REFERENCE mode we only record views into the given buffer.
+    if (ownership == Ownership::COPY) {
+        const uint32_t totalSize = nbytes - (pdata - bytes);
+        mBlobs->blobs.resize(totalSize);
+    } else {
+        mBlobs->views.resize(mBlobs->sizes.size());
+    }
     for (uint32_t mipmap = 0; mipmap < mNumMipLevels; ++mipmap) {
         const uint32_t imageSize = *((uint32_t const*) pdata);
         const uint32_t faceSize = isNonArrayCube ? imageSize : (imageSize / facesPerMip);
         const uint32_t levelSize = faceSize * mNumCubeFaces * mArrayLength;
         pdata += sizeof(uint32_t);
-        memcpy(mBlobs->get(flatten(this, {mipmap, 0, 0})), pdata, levelSize);
+        if (ownership == Ownership::COPY) {
+            memcpy(mBlobs->get(flatten(this, {mipmap, 0, 0})), pdata, levelSize);
+        }
         for (uint32_t layer = 0; layer < mArrayLength; ++layer) {
             for (uint32_t face = 0; face < mNumCubeFaces; ++face) {
-                mBlobs->sizes[flatten(this, {mipmap, layer, face})] = faceSize;
+                const size_t flatIndex = flatten(this, {mipmap, layer, face});
+                mBlobs->sizes[flatIndex] = faceSize;
+                if (ownership == Ownership::REFERENCE) {
+                    mBlobs->views[flatIndex] = pdata;
+                }
                 pdata += faceSize;
                 pdata += cubePadding;
             }
@@ -315,6 +335,12 @@ bool KtxBundle::getBlob(KtxBlobIndex index, uint8_t** data, uint32_t* size) cons
     if (blobSize == 0) {
         return false;
     }
+    if (!mBlobs->views.empty()) {
+        // REFERENCE mode; clients must not write through this pointer.
+        *data = const_cast<uint8_t*>(mBlobs->views[flatIndex]);
+        *size = blobSize;
+        return *data != nullptr;
+    }
     *data = mBlobs->get(flatIndex);
     *size = blobSize;
     return true;
@@ -322,7 +348,7 @@ bool KtxBundle::getBlob(KtxBlobIndex index, uint8_t** data, uint32_t* size) cons
 
 bool KtxBundle::setBlob(KtxBlobIndex index, uint8_t const* data, uint32_t size) {
     if (index.mipLevel >= mNumMipLevels || index.arrayIndex >= mArrayLength ||
-            index.cubeFace >= mNumCubeFaces) {
+            index.cubeFace >= mNumCubeFaces || !mBlobs->views.empty()) {
         return false;
     }
     uint32_t flatIndex = flatten(this, index);
@@ -336,7 +362,7 @@ bool KtxBundle::setBlob(KtxBlobIndex index, uint8_t const* data, uint32_t size)
 
 bool KtxBundle::allocateBlob(KtxBlobIndex index, uint32_t size) {
     if (index.mipLevel >= mNumMipLevels || index.arrayIndex >= mArrayLength ||
-            index.cubeFace >= mNumCubeFaces) {
+            index.cubeFace >= mNumCubeFaces || !mBlobs->views.empty()) {
         return false;
     }
     uint32_t flatIndex = flatten(this, index);
@@ -344,4 +370,97 @@ bool KtxBundle::allocateBlob(KtxBlobIndex index, uint32_t size) {
     return true;
 }
 
+// Packs a positive float into an unsigned small float with 5 exponent bits and the given
+// number of mantissa bits, going through half (5 exponent, 10 mantissa bits) so we don't
+// have to deal with denormals and overflow ourselves.
+static uint32_t packSmallFloat(float value, uint32_t mantissaBits) {
+    filament::math::half const h(value);
+    uint16_t bits = getBits(h);     // found through ADL, it's a friend of half
+    if (bits & 0x8000u) {
+        return 0;   // negative values (including -0) clamp to zero
+    }
+    uint32_t const shift = 10 - mantissaBits;
+    if ((bits & 0x7c00u) != 0x7c00u) {
+        // finite: round to nearest; a mantissa carry into the exponent is correct in
+        // IEEE bit patterns, and saturates to infinity at the top of the range
+        bits += 1u << (shift - 1);
+    }
+    return (bits >> shift) & ((1u << (5 + mantissaBits)) - 1u);
+}
+
+static uint32_t pack101111(float r, float g, float b) {
+    return packSmallFloat(r, 6) | (packSmallFloat(g, 6) << 11) | (packSmallFloat(b, 5) << 22);
+}
+
+bool packHdrTo101111(KtxBundle& bundle) {
+    auto const& info = bundle.getInfo();
+    if (info.glFormat != KtxBundle::RGB && info.glFormat != KtxBundle::RGBA) {
+        return false;
+    }
+    if (info.glType != KtxBundle::HALF_FLOAT && info.glType != KtxBundle::FLOAT) {
+        return false;
+    }
+    uint32_t const channels = info.glFormat == KtxBundle::RGBA ? 4 : 3;
+    bool const half = info.glType == KtxBundle::HALF_FLOAT;
+    uint32_t const srcPixelSize = channels * (half ? 2 : 4);
+    uint32_t const numFaces = bundle.isCubemap() ? 6 : 1;
+    std::vector<uint32_t> packed;
+    for (uint32_t mip = 0; mip < bundle.getNumMipLevels(); ++mip) {
+        for (uint32_t layer = 0; layer < bundle.getArrayLength(); ++layer) {
+            for (uint32_t face = 0; face < numFaces; ++face) {
+                uint8_t* data;
+                uint32_t size;
+                if (!bundle.getBlob({mip, layer, face}, &data, &size)) {
+                    continue;
+                }
+                uint32_t const count = size / srcPixelSize;
+                packed.resize(count);
+                for (uint32_t i = 0; i < count; ++i) {
+                    float rgb[3];
+                    if (half) {
+                        uint16_t const* src = (uint16_t const*) (data + i * srcPixelSize);
+                        for (int c = 0; c < 3; ++c) {
+                            rgb[c] = float(filament::math::makeHalf(src[c]));
+                        }
+                    } else {
+                        memcpy(rgb, data + i * srcPixelSize, sizeof(rgb));
+                    }
+                    packed[i] = pack101111(rgb[0], rgb[1], rgb[2]);
+                }
+                if (!bundle.setBlob({mip, layer, face},
+                        (uint8_t const*) packed.data(), count * sizeof(uint32_t))) {
+                    // setBlob only fails here for immutable REFERENCE bundles, in which
+                    // case it fails on the very first blob and nothing has been mutated
+                    return false;
+                }
+            }
+        }
+    }
+    // note: the spec mandates an unsized glFormat, but glType matches what cmgen has
+    // historically written and what KtxUtility.h expects
+    KtxInfo& mutableInfo = bundle.info();
+    mutableInfo.glType = KtxBundle::R11F_G11F_B10F;
+    mutableInfo.glTypeSize = 4;
+    mutableInfo.glFormat = KtxBundle::RGB;
+    mutableInfo.glInternalFormat = KtxBundle::R11F_G11F_B10F;
+    mutableInfo.glBaseInternalFormat = KtxBundle::RGB;
+    return true;
+}
+
+bool KtxBundle::releaseBlob(KtxBlobIndex index) {
+    if (index.mipLevel >= mNumMipLevels || index.arrayIndex >= mArrayLength ||
+            index.cubeFace >= mNumCubeFaces) {
+        return false;
+    }
+    uint32_t flatIndex = flatten(this, index);
+    if (!mBlobs->views.empty()) {
+        // nothing to free, the caller owns the underlying buffer
+        mBlobs->views[flatIndex] = nullptr;
+        mBlobs->sizes[flatIndex] = 0;
+        return true;
+    }
+    mBlobs->resize(flatIndex, 0);
+    return true;
+}
+
 }  // namespace image
@@ -29,9 +29,12 @@
 #include <utils/Panic.h>
 #include <utils/Path.h>
 
+#include <math/half.h>
 #include <math/vec3.h>
 #include <math/vec4.h>
 
+#include <cmath>
+
 #include <fstream>
 #include <string>
 #include <sstream>
@@ -427,6 +430,116 @@ TEST_F(ImageTest, Ktx) { // NOLINT
     }
 }
 
+TEST_F(ImageTest, KtxReference) { // NOLINT
+    uint8_t texels[] = {1, 2, 3, 4};
+    uint8_t* data;
+    uint32_t size;
+    KtxBundle original(1, 1, false);
+    ASSERT_TRUE(original.setBlob({0, 0, 0}, texels, sizeof(texels)));
+    vector<uint8_t> buffer(original.getSerializedLength());
+    ASSERT_TRUE(original.serialize(buffer.data(), buffer.size()));
+
+    KtxBundle reference(buffer.data(), buffer.size(), KtxBundle::Ownership::REFERENCE);
+    ASSERT_TRUE(reference.getBlob({0, 0, 0}, &data, &size));
+    ASSERT_EQ(size, sizeof(texels));
+    ASSERT_EQ(0, memcmp(data, texels, sizeof(texels)));
+
+    // the blob is a view into the serialized buffer, not a copy
+    ASSERT_GE(data, buffer.data());
+    ASSERT_LE(data + size, buffer.data() + buffer.size());
+
+    // reference bundles are immutable
+    ASSERT_FALSE(reference.setBlob({0, 0, 0}, texels, sizeof(texels)));
+    ASSERT_FALSE(reference.allocateBlob({0, 0, 0}, sizeof(texels)));
+
+    // blobs can be released individually once consumed
+    ASSERT_TRUE(reference.releaseBlob({0, 0, 0}));
+    ASSERT_FALSE(reference.getBlob({0, 0, 0}, &data, &size));
+}
+
+TEST_F(ImageTest, KtxPackHdr) { // NOLINT
+    using filament::math::half;
+    // getBits() is a friend of half, only found through ADL
+    auto halfBits = [](float f) { half h(f); return getBits(h); };
+
+    // decodes one unsigned small float (5 exponent bits) out of a packed 11.11.10 word
+    auto unpack = [](uint32_t word, uint32_t shift, uint32_t mbits) -> float {
+        uint32_t v = (word >> shift) & ((1u << (5 + mbits)) - 1u);
+        uint32_t e = v >> mbits;
+        uint32_t m = v & ((1u << mbits) - 1u);
+        if (e == 0) {
+            return float(m) / (1u << mbits) * std::pow(2.0f, -14.0f);
+        }
+        return std::pow(2.0f, float(e) - 15.0f) * (1.0f + float(m) / (1u << mbits));
+    };
+
+    const float pixels[2][4] = {
+        { 1.0f,  0.5f,   2.0f, 1.0f },
+        {-1.0f,  0.25f, 80.0f, 0.0f },
+    };
+
+    // half RGBA input, the alpha channel is dropped
+    uint16_t halfPixels[2][4];
+    for (int p = 0; p < 2; ++p) {
+        for (int c = 0; c < 4; ++c) {
+            halfPixels[p][c] = halfBits(pixels[p][c]);
+        }
+    }
+    KtxBundle halfBundle(1, 1, false);
+    halfBundle.info() = { 0, KtxBundle::HALF_FLOAT, 2, KtxBundle::RGBA, KtxBundle::RGBA16F,
+            KtxBundle::RGBA, 2, 1, 0 };
+    ASSERT_TRUE(halfBundle.setBlob({0, 0, 0}, (uint8_t const*) halfPixels, sizeof(halfPixels)));
+    ASSERT_TRUE(packHdrTo101111(halfBundle));
+    ASSERT_EQ(halfBundle.getInfo().glType, KtxBundle::R11F_G11F_B10F);
+    ASSERT_EQ(halfBundle.getInfo().glFormat, KtxBundle::RGB);
+    ASSERT_EQ(halfBundle.getInfo().glInternalFormat, KtxBundle::R11F_G11F_B10F);
+
+    uint8_t* data;
+    uint32_t size;
+    ASSERT_TRUE(halfBundle.getBlob({0, 0, 0}, &data, &size));
+    ASSERT_EQ(size, 2 * sizeof(uint32_t));
+    uint32_t words[2];
+    memcpy(words, data, sizeof(words));
+    EXPECT_FLOAT_EQ(unpack(words[0],  0, 6), 1.0f);
+    EXPECT_FLOAT_EQ(unpack(words[0], 11, 6), 0.5f);
+    EXPECT_FLOAT_EQ(unpack(words[0], 22, 5), 2.0f);
+    EXPECT_FLOAT_EQ(unpack(words[1],  0, 6), 0.0f);  // negative clamps to zero
+    EXPECT_FLOAT_EQ(unpack(words[1], 11, 6), 0.25f);
+    EXPECT_NEAR(unpack(words[1], 22, 5), 80.0f, 80.0f / 32.0f);
+
+    // float RGB input
+    float floatPixels[2][3];
+    for (int p = 0; p < 2; ++p) {
+        for (int c = 0; c < 3; ++c) {
+            floatPixels[p][c] = pixels[p][c];
+        }
+    }
+    KtxBundle floatBundle(1, 1, false);
+    floatBundle.info() = { 0, KtxBundle::FLOAT, 4, KtxBundle::RGB, KtxBundle::RGB32F,
+            KtxBundle::RGB, 2, 1, 0 };
+    ASSERT_TRUE(floatBundle.setBlob({0, 0, 0}, (uint8_t const*) floatPixels, sizeof(floatPixels)));
+    ASSERT_TRUE(packHdrTo101111(floatBundle));
+    ASSERT_TRUE(floatBundle.getBlob({0, 0, 0}, &data, &size));
+    ASSERT_EQ(size, 2 * sizeof(uint32_t));
+    ASSERT_EQ(0, memcmp(data, words, sizeof(words)));
+
+    // unsupported formats and immutable bundles are left untouched
+    KtxBundle byteBundle(1, 1, false);
+    byteBundle.info() = { 0, KtxBundle::UNSIGNED_BYTE, 1, KtxBundle::RGBA, KtxBundle::RGBA8,
+            KtxBundle::RGBA, 2, 1, 0 };
+    ASSERT_FALSE(packHdrTo101111(byteBundle));
+
+    KtxBundle source(1, 1, false);
+    source.info() = { 0, KtxBundle::HALF_FLOAT, 2, KtxBundle::RGBA, KtxBundle::RGBA16F,
+            KtxBundle::RGBA, 2, 1, 0 };
+    ASSERT_TRUE(source.setBlob({0, 0, 0}, (uint8_t const*) halfPixels, sizeof(halfPixels)));
+    vector<uint8_t> serialized(source.getSerializedLength());
+    ASSERT_TRUE(source.serialize(serialized.data(), serialized.size()));
+    KtxBundle reference(serialized.data(), serialized.size(), KtxBundle::Ownership::REFERENCE);
+    ASSERT_FALSE(packHdrTo101111(reference));
+    ASSERT_EQ(reference.getInfo().glType, KtxBundle::HALF_FLOAT);
+}
+
 TEST_F(ImageTest, getSphericalHarmonics) {
     KtxBundle ktx(2, 1, true);
 
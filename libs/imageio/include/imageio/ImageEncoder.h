@@ -24,6 +24,10 @@
 
 #include <utils/compiler.h>
 
+namespace utils {
+class JobSystem;
+} // namespace utils
+
 namespace image {
 
 class UTILS_PUBLIC ImageEncoder {
@@ -49,6 +53,20 @@ public:
     static bool encode(std::ostream& stream, Format format, const LinearImage& image,
             const std::string& compression, const std::string& destName);
 
+    /**
+     * Same as encode(), but distributes the per-row work (pixel conversion, filtering and
+     * compression) over the given JobSystem, streaming each compressed chunk to the output
+     * as soon as it and all of its predecessors are done. The calling thread participates in
+     * the wait and must be adopted by the JobSystem.
+     *
+     * Currently the PNG-based formats are encoded chunk-parallel; the other formats fall
+     * back to the single-threaded path. Parallel PNG output is not byte-identical to the
+     * serial path (row chunks are compressed independently) but decodes to the same pixels.
+     */
+    static bool encode(utils::JobSystem& js, std::ostream& stream, Format format,
+            const LinearImage& image, const std::string& compression,
+            const std::string& destName);
+
     static Format chooseFormat(const std::string& name, bool forceLinear = false);
     static std::string chooseExtension(Format format);
 
@@ -56,6 +74,10 @@ public:
     public:
         virtual bool encode(const LinearImage& image) = 0;
         virtual ~Encoder() = default;
+    protected:
+        // set when the caller provides a JobSystem; encoders that can parallelize use it
+        utils::JobSystem* mJobSystem = nullptr;
+        friend class ImageEncoder;
     };
 };
 
@@ -22,6 +22,7 @@
 #include <functional>
 #include <limits>
 #include <memory>
+#include <vector>
 #include <iostream> // for cerr
 
 #if defined(WIN32)
@@ -35,11 +36,14 @@
 
 #include <tinyexr.h>
 
+#include <zlib.h>
+
 #include <math/half.h>
 #include <math/vec3.h>
 #include <math/vec4.h>
 
 #include <utils/compiler.h>
+#include <utils/JobSystem.h>
 
 #include <image/ColorTransform.h>
 
@@ -70,6 +74,13 @@ private:
     // ImageEncoder::Encoder interface
     bool encode(const LinearImage& image) override;
 
+    // converts the linear image to the 8-bit representation selected by mFormat
+    std::unique_ptr<uint8_t[]> convert(const LinearImage& image, uint32_t dstChannels) const;
+
+    // row-chunk-parallel variant of encode(), writes the PNG container directly and streams
+    // each independently deflated chunk as soon as it and its predecessors are done
+    bool encodeParallel(const LinearImage& image, utils::JobSystem& js);
+
     int chooseColorType(const LinearImage& image) const;
     uint32_t getChannelsCount(int colorType) const;
 
@@ -188,9 +199,10 @@ private:
 
 // ------------------------------------------------------------------------------------------------
 
-bool ImageEncoder::encode(std::ostream& stream, Format format, const LinearImage& image,
-        const std::string& compression, const std::string& destName) {
-    std::unique_ptr<Encoder> encoder;
+static std::unique_ptr<ImageEncoder::Encoder> createEncoder(std::ostream& stream,
+        ImageEncoder::Format format, const std::string& compression, const std::string& destName) {
+    using Format = ImageEncoder::Format;
+    std::unique_ptr<ImageEncoder::Encoder> encoder;
     switch(format) {
         case Format::PNG:
             encoder.reset(PNGEncoder::create(stream));
@@ -220,6 +232,18 @@ bool ImageEncoder::encode(std::ostream& stream, Format format, const LinearImage
             encoder.reset(DDSEncoder::create(stream, compression, DDSEncoder::PixelFormat::LINEAR_RGB));
             break;
     }
+    return encoder;
+}
+
+bool ImageEncoder::encode(std::ostream& stream, Format format, const LinearImage& image,
+        const std::string& compression, const std::string& destName) {
+    return createEncoder(stream, format, compression, destName)->encode(image);
+}
+
+bool ImageEncoder::encode(utils::JobSystem& js, std::ostream& stream, Format format,
+        const LinearImage& image, const std::string& compression, const std::string& destName) {
+    std::unique_ptr<Encoder> encoder = createEncoder(stream, format, compression, destName);
+    encoder->mJobSystem = &js;
     return encoder->encode(image);
 }
 
@@ -329,6 +353,32 @@ uint32_t PNGEncoder::getChannelsCount(int colorType) const {
     }
 }
 
+std::unique_ptr<uint8_t[]> PNGEncoder::convert(const LinearImage& image,
+        uint32_t dstChannels) const {
+    if (image.getChannels() == 1) {
+        return fromLinearToGrayscale<uint8_t>(image);
+    }
+    switch (mFormat) {
+        case PixelFormat::RGBM:
+            return fromLinearToRGBM<uint8_t>(image);
+        case PixelFormat::RGB_10_11_11_REV:
+            return fromLinearToRGB_10_11_11_REV(image);
+        case PixelFormat::sRGB:
+            if (dstChannels == 4) {
+                return fromLinearTosRGB<uint8_t, 4>(image);
+            } else {
+                return fromLinearTosRGB<uint8_t, 3>(image);
+            }
+        case PixelFormat::LINEAR_RGB:
+            if (dstChannels == 4) {
+                return fromLinearToRGB<uint8_t, 4>(image);
+            } else {
+                return fromLinearToRGB<uint8_t, 3>(image);
+            }
+    }
+    return nullptr;
+}
+
 bool PNGEncoder::encode(const LinearImage& image) {
     size_t srcChannels = image.getChannels();
 
@@ -348,6 +398,10 @@ bool PNGEncoder::encode(const LinearImage& image) {
             break;
     }
 
+    if (mJobSystem) {
+        return encodeParallel(image, *mJobSystem);
+    }
+
     try {
         mInfo = png_create_info_struct(mPNG);
 
@@ -371,35 +425,8 @@ bool PNGEncoder::encode(const LinearImage& image) {
         std::unique_ptr<png_bytep[]> row_pointers(new png_bytep[height]);
         std::unique_ptr<uint8_t[]> data;
 
-        uint32_t dstChannels;
-        if (srcChannels == 1) {
-            dstChannels = 1;
-            data = fromLinearToGrayscale<uint8_t>(image);
-        } else {
-            dstChannels = getChannelsCount(colorType);
-            switch (mFormat) {
-                case PixelFormat::RGBM:
-                    data = fromLinearToRGBM<uint8_t>(image);
-                    break;
-                case PixelFormat::RGB_10_11_11_REV:
-                    data = fromLinearToRGB_10_11_11_REV(image);
-                    break;
-                case PixelFormat::sRGB:
-                    if (dstChannels == 4) {
-                        data = fromLinearTosRGB<uint8_t, 4>(image);
-                    } else {
-                        data = fromLinearTosRGB<uint8_t, 3>(image);
-                    }
-                    break;
-                case PixelFormat::LINEAR_RGB:
-                    if (dstChannels == 4) {
-                        data = fromLinearToRGB<uint8_t, 4>(image);
-                    } else {
-                        data = fromLinearToRGB<uint8_t, 3>(image);
-                    }
-                    break;
-            }
-        }
+        uint32_t dstChannels = srcChannels == 1 ? 1 : getChannelsCount(colorType);
+        data = convert(image, dstChannels);
 
         for (size_t y = 0; y < height; y++) {
             row_pointers[y] = reinterpret_cast<png_bytep>
@@ -418,6 +445,242 @@ bool PNGEncoder::encode(const LinearImage& image) {
     return true;
 }
 
+// writes one PNG chunk: big-endian length, 4-byte tag, payload, CRC over tag and payload
+static void writePNGChunk(std::ostream& out, const char tag[4],
+        uint8_t const* data, uint32_t size) {
+    uint32_t word = htonl(size);
+    out.write(reinterpret_cast<char*>(&word), 4);
+    out.write(tag, 4);
+    if (size) {
+        out.write(reinterpret_cast<char const*>(data), size);
+    }
+    uLong crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, reinterpret_cast<Bytef const*>(tag), 4);
+    if (size) {
+        crc = crc32(crc, data, size);
+    }
+    word = htonl(uint32_t(crc));
+    out.write(reinterpret_cast<char*>(&word), 4);
+}
+
+static inline uint8_t paethPredictor(uint8_t a, uint8_t b, uint8_t c) {
+    const int p = int(a) + int(b) - int(c);
+    const int pa = std::abs(p - int(a));
+    const int pb = std::abs(p - int(b));
+    const int pc = std::abs(p - int(c));
+    if (pa <= pb && pa <= pc) return a;
+    if (pb <= pc) return b;
+    return c;
+}
+
+// Applies the PNG scanline filter minimizing the sum of absolute differences (the same
+// heuristic libpng defaults to for 8-bit images) and writes the filter-type byte followed
+// by the filtered bytes to dst. scratch must hold 4 * rowBytes. prev is the previous
+// scanline, or all zeroes for the first scanline of the image.
+static void filterRow(uint8_t* dst, uint8_t* scratch, uint8_t const* row, uint8_t const* prev,
+        size_t rowBytes, size_t bpp) {
+    uint8_t* const sub = scratch;
+    uint8_t* const up = scratch + rowBytes;
+    uint8_t* const avg = scratch + 2 * rowBytes;
+    uint8_t* const pae = scratch + 3 * rowBytes;
+    for (size_t i = 0; i < rowBytes; i++) {
+        const uint8_t x = row[i];
+        const uint8_t a = i >= bpp ? row[i - bpp] : 0;      // left
+        const uint8_t b = prev[i];                          // above
+        const uint8_t c = i >= bpp ? prev[i - bpp] : 0;     // above-left
+        sub[i] = uint8_t(x - a);
+        up[i]  = uint8_t(x - b);
+        avg[i] = uint8_t(x - uint8_t((unsigned(a) + unsigned(b)) / 2));
+        pae[i] = uint8_t(x - paethPredictor(a, b, c));
+    }
+    uint8_t const* const candidates[5] = { row, sub, up, avg, pae };
+    size_t best = 0;
+    uint64_t bestSum = std::numeric_limits<uint64_t>::max();
+    for (size_t f = 0; f < 5; f++) {
+        uint64_t sum = 0;
+        uint8_t const* const candidate = candidates[f];
+        for (size_t i = 0; i < rowBytes; i++) {
+            // filtered bytes are interpreted as signed deltas
+            const uint8_t v = candidate[i];
+            sum += v < 128 ? v : 256u - v;
+        }
+        if (sum < bestSum) {
+            bestSum = sum;
+            best = f;
+        }
+    }
+    dst[0] = uint8_t(best);
+    memcpy(dst + 1, candidates[best], rowBytes);
+}
+
+bool PNGEncoder::encodeParallel(const LinearImage& image, utils::JobSystem& js) {
+    using namespace utils;
+
+    const uint32_t width = image.getWidth();
+    const uint32_t height = image.getHeight();
+    const uint32_t srcChannels = image.getChannels();
+    const int colorType = chooseColorType(image);
+    const uint32_t dstChannels = srcChannels == 1 ? 1 : getChannelsCount(colorType);
+    const size_t rowBytes = size_t(width) * dstChannels;
+
+    // target roughly 256 KiB of filtered scanline data per chunk, enough to keep the
+    // per-chunk deflate dictionary effective and the job overhead negligible
+    const uint32_t rowsPerChunk = uint32_t(std::min(size_t(height),
+            std::max(size_t(8), (256u * 1024u) / (rowBytes + 1))));
+    const uint32_t chunkCount = (height + rowsPerChunk - 1) / rowsPerChunk;
+
+    // Each chunk is deflated into an independent raw stream: intermediate chunks end with a
+    // byte-aligned non-final block (Z_FULL_FLUSH), the last one with Z_FINISH, so their
+    // concatenation forms one valid deflate stream.
+    struct Chunk {
+        uint32_t firstRow;
+        uint32_t rowCount;
+        std::vector<uint8_t> compressed;
+        uLong adler = 0;
+        bool ok = false;
+        JobSystem::Job* job = nullptr;
+    };
+    std::vector<Chunk> chunks(chunkCount);
+
+    auto encodeChunk = [this, &image, width, srcChannels, dstChannels, rowBytes,
+            height](Chunk& chunk) {
+        const uint32_t rows = chunk.rowCount;
+        const bool hasPrev = chunk.firstRow > 0;
+
+        // copy this chunk's rows -- plus the predecessor row its first filter needs -- into
+        // a sub-image, so the whole-image converters can be reused per chunk
+        const uint32_t copyCount = rows + (hasPrev ? 1 : 0);
+        LinearImage sub(width, copyCount, srcChannels);
+        memcpy(sub.getPixelRef(), image.getPixelRef(0, chunk.firstRow - (hasPrev ? 1 : 0)),
+                size_t(width) * copyCount * srcChannels * sizeof(float));
+        const std::unique_ptr<uint8_t[]> data = convert(sub, dstChannels);
+
+        const size_t filteredBytes = rows * (1 + rowBytes);
+        std::unique_ptr<uint8_t[]> filtered(new uint8_t[filteredBytes]);
+        std::unique_ptr<uint8_t[]> scratch(new uint8_t[4 * rowBytes]);
+        std::unique_ptr<uint8_t[]> zeroRow;
+        uint8_t const* prev;
+        if (hasPrev) {
+            prev = &data[0];
+        } else {
+            zeroRow.reset(new uint8_t[rowBytes]());
+            prev = zeroRow.get();
+        }
+        uint8_t const* row = &data[(hasPrev ? 1 : 0) * rowBytes];
+        for (uint32_t y = 0; y < rows; y++) {
+            filterRow(&filtered[y * (1 + rowBytes)], scratch.get(), row, prev,
+                    rowBytes, dstChannels);
+            prev = row;
+            row += rowBytes;
+        }
+        chunk.adler = adler32(adler32(0L, Z_NULL, 0), filtered.get(), uInt(filteredBytes));
+
+        z_stream zs = {};
+        if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            return;
+        }
+        const bool last = chunk.firstRow + rows == height;
+        chunk.compressed.resize(deflateBound(&zs, uLong(filteredBytes)) + 64);
+        zs.next_in = filtered.get();
+        zs.avail_in = uInt(filteredBytes);
+        zs.next_out = chunk.compressed.data();
+        zs.avail_out = uInt(chunk.compressed.size());
+        const int result = deflate(&zs, last ? Z_FINISH : Z_FULL_FLUSH);
+        chunk.ok = last ? (result == Z_STREAM_END) : (result == Z_OK && zs.avail_in == 0);
+        chunk.compressed.resize(chunk.compressed.size() - zs.avail_out);
+        deflateEnd(&zs);
+    };
+
+    try {
+        // signature and IHDR
+        static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', 0x0D, 0x0A, 0x1A, 0x0A };
+        mStream.write(reinterpret_cast<char const*>(signature), sizeof(signature));
+        uint8_t ihdr[13];
+        const uint32_t beWidth = htonl(width);
+        const uint32_t beHeight = htonl(height);
+        memcpy(ihdr + 0, &beWidth, 4);
+        memcpy(ihdr + 4, &beHeight, 4);
+        ihdr[8] = 8;                     // bit depth
+        ihdr[9] = uint8_t(colorType);
+        ihdr[10] = 0;                    // compression method (deflate)
+        ihdr[11] = 0;                    // filter method (adaptive)
+        ihdr[12] = 0;                    // no interlacing
+        writePNGChunk(mStream, "IHDR", ihdr, sizeof(ihdr));
+
+        // same colorimetry chunks the serial path asks libpng for
+        if (mFormat == PixelFormat::LINEAR_RGB || mFormat == PixelFormat::RGB_10_11_11_REV) {
+            const uint32_t gama = htonl(100000);    // gamma 1.0
+            writePNGChunk(mStream, "gAMA", reinterpret_cast<uint8_t const*>(&gama), 4);
+        } else {
+            const uint8_t intent = 0;               // perceptual
+            writePNGChunk(mStream, "sRGB", &intent, 1);
+            const uint32_t gama = htonl(45455);     // gamma 1/2.2
+            writePNGChunk(mStream, "gAMA", reinterpret_cast<uint8_t const*>(&gama), 4);
+            const uint32_t chrm[8] = {
+                    htonl(31270), htonl(32900),     // white point
+                    htonl(64000), htonl(33000),     // red
+                    htonl(30000), htonl(60000),     // green
+                    htonl(15000), htonl(6000),      // blue
+            };
+            writePNGChunk(mStream, "cHRM", reinterpret_cast<uint8_t const*>(chrm), 32);
+        }
+
+        // spawn one job per chunk...
+        for (uint32_t i = 0; i < chunkCount; i++) {
+            chunks[i].firstRow = i * rowsPerChunk;
+            chunks[i].rowCount = std::min(rowsPerChunk, height - chunks[i].firstRow);
+        }
+        for (Chunk& chunk : chunks) {
+            chunk.job = js.runAndRetain(jobs::createJob(js, nullptr,
+                    std::cref(encodeChunk), std::ref(chunk)));
+        }
+
+        // ...and stream them out in order as they complete, while later chunks are still
+        // compressing on the worker threads
+        static const uint8_t zlibHeader[2] = { 0x78, 0x9C };
+        writePNGChunk(mStream, "IDAT", zlibHeader, 2);
+        uLong adler = adler32(0L, Z_NULL, 0);
+        bool failed = false;
+        for (Chunk& chunk : chunks) {
+            js.waitAndRelease(chunk.job);
+            if (failed) {
+                continue;   // the remaining jobs must still be waited on
+            }
+            if (!chunk.ok) {
+                failed = true;
+                continue;
+            }
+            writePNGChunk(mStream, "IDAT", chunk.compressed.data(),
+                    uint32_t(chunk.compressed.size()));
+            adler = adler32_combine(adler, chunk.adler,
+                    z_off_t(chunk.rowCount * (1 + rowBytes)));
+            chunk.compressed = std::vector<uint8_t>();  // release the memory early
+            if (!mStream.good()) {
+                failed = true;
+            }
+        }
+        if (failed) {
+            throw std::runtime_error("Problem while encoding PNG chunks.");
+        }
+
+        // the zlib checksum of the whole filtered stream closes the last IDAT
+        const uint32_t beAdler = htonl(uint32_t(adler));
+        writePNGChunk(mStream, "IDAT", reinterpret_cast<uint8_t const*>(&beAdler), 4);
+        writePNGChunk(mStream, "IEND", nullptr, 0);
+        mStream.flush();
+        if (!mStream.good()) {
+            throw std::runtime_error("Problem with the PNG stream.");
+        }
+    } catch (std::runtime_error& e) {
+        // reset the stream, like we found it
+        std::cerr << "Runtime error while encoding PNG: " << e.what() << std::endl;
+        mStream.seekp(mStreamStartPos);
+        return false;
+    }
+    return true;
+}
+
 void PNGEncoder::cb_stream(png_structp png, png_bytep buffer, png_size_t size) {
     PNGEncoder* that = static_cast<PNGEncoder*>(png_get_io_ptr(png));
     that->stream(buffer, size);
@@ -17,6 +17,7 @@
 #ifndef MATDBG_DEBUGSERVER_H
 #define MATDBG_DEBUGSERVER_H
 
+#include <utils/compiler.h>
 #include <utils/CString.h>
 
 #include <backend/DriverEnums.h>
@@ -25,6 +26,9 @@
 
 #include <tsl/robin_map.h>
 
+#include <atomic>
+#include <chrono>
+
 class CivetServer;
 
 namespace filament {
@@ -73,7 +77,33 @@ public:
 
     bool isReady() const { return mServer; }
 
+    /**
+     * Records a material/shader switch into the capture ring buffer. Called by the engine for
+     * every program access, so it must stay cheap enough for production use: one relaxed
+     * fetch_add and three stores, no locks. The ring holds the most recent CAPTURE_EVENT_COUNT
+     * events and can be dumped at any time with GET /api/capture. A concurrent dump can observe
+     * a torn event that is being overwritten, which is acceptable for diagnostics.
+     */
+    void captureSwitch(MaterialKey material, uint8_t variant) noexcept {
+        if (UTILS_LIKELY(mCaptureEnabled.load(std::memory_order_relaxed))) {
+            uint32_t const slot = mCaptureHead.fetch_add(1, std::memory_order_relaxed);
+            CaptureEvent& event = mCaptureRing[slot % CAPTURE_EVENT_COUNT];
+            event.timestamp = std::chrono::steady_clock::now().time_since_epoch().count();
+            event.material = material;
+            event.variant = variant;
+        }
+    }
+
 private:
+    struct CaptureEvent {
+        int64_t timestamp;      // steady_clock ticks
+        MaterialKey material;
+        uint8_t variant;
+    };
+
+    // ~128 KiB, enough for several frames of switches in heavy scenes
+    static constexpr uint32_t CAPTURE_EVENT_COUNT = 8192;
+
     struct MaterialRecord {
         void* userdata;
         const uint8_t* package;
@@ -108,6 +138,10 @@ private:
     EditCallback mEditCallback = nullptr;
     QueryCallback mQueryCallback = nullptr;
 
+    std::atomic<uint32_t> mCaptureHead = { 0 };
+    std::atomic<bool> mCaptureEnabled = { true };
+    CaptureEvent mCaptureRing[CAPTURE_EVENT_COUNT] = {};
+
     class FileRequestHandler* mFileHandler = nullptr;
     class RestRequestHandler* mRestHandler = nullptr;
     class WebSocketHandler* mWebSocketHandler = nullptr;
@@ -134,6 +134,7 @@ private:
 //    GET /api/material?matid={id}
 //    GET /api/shader?matid={id}&type=[glsl|spirv]&[glindex|vkindex|metalindex]={index}
 //    GET /api/active
+//    GET /api/capture[?enabled={0|1}]
 //
 class RestRequestHandler : public CivetHandler {
 public:
@@ -179,6 +180,30 @@ public:
             return true;
         }
 
+        if (uri == "/api/capture") {
+            // ?enabled={0|1} toggles the steady-state capture without dumping
+            char enabled[4] = {};
+            if (request->query_string && mg_get_var(request->query_string,
+                    strlen(request->query_string), "enabled", enabled, sizeof(enabled)) >= 0) {
+                mServer->mCaptureEnabled.store(enabled[0] != '0');
+            }
+            // the ring is read without stopping writers; an event overwritten while we
+            // serialize can be torn, which is acceptable for a diagnostic dump
+            const uint32_t head = mServer->mCaptureHead.load(std::memory_order_relaxed);
+            const uint32_t count = std::min(head, DebugServer::CAPTURE_EVENT_COUNT);
+            mg_printf(conn, kSuccessHeader.c_str(), "application/json");
+            mg_printf(conn, "[");
+            for (uint32_t i = 0; i < count; i++) {
+                const auto& event = mServer->mCaptureRing[
+                        (head - count + i) % DebugServer::CAPTURE_EVENT_COUNT];
+                mg_printf(conn, "{\"matid\": \"%8.8x\", \"variant\": %u, \"time\": %lld}%s",
+                        event.material, event.variant, (long long) event.timestamp,
+                        (i + 1) == count ? "" : ",");
+            }
+            mg_printf(conn, "]");
+            return true;
+        }
+
         if (uri == "/api/matids") {
             mg_printf(conn, kSuccessHeader.c_str(), "application/json");
             mg_printf(conn, "[");
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TNT_RESIDENCY_RESIDENCYMANAGER_H
+#define TNT_RESIDENCY_RESIDENCYMANAGER_H
+
+#include <utils/compiler.h>
+
+#include <tsl/robin_map.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace filament {
+
+class Engine;
+class Texture;
+
+namespace residency {
+
+/**
+ * ResidencyManager streams texture mip levels in and out under a byte budget, so that scenes
+ * whose full-resolution textures exceed the available memory can still render, at reduced
+ * sharpness where the budget forces it.
+ *
+ * Each managed texture keeps a permanently resident tail of its coarsest mip levels. The
+ * caller reports a desired level per texture (typically from camera distance or screen
+ * coverage, see computeDesiredLevel()), and commit() grants the finer levels to the textures
+ * that need them most, staying within the budget. Newly granted levels are requested through
+ * a caller-supplied loader, which owns the source data and uploads it with
+ * Texture::setImage(); evicted levels are simply excluded from sampling with
+ * Texture::setMinMaxLevels() and their contents become undefined until they are streamed in
+ * again.
+ *
+ * Textures must therefore be created with their full mip pyramid; the savings come from
+ * never holding the fine levels' payload for distant objects. Note that with immutable
+ * texture storage the GPU allocation itself is not shrunk by eviction; the budget bounds the
+ * resident (sampleable) payload, which is what the driver must keep in fast memory.
+ *
+ * Usage Example:
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * ResidencyManager manager(*engine);
+ * manager.setBudget(400 * 1024 * 1024);
+ * manager.add(texture, 4, loadMipLevel, &myAsset);
+ * // each frame, or whenever the camera has moved significantly:
+ * uint8_t level = ResidencyManager::computeDesiredLevel(
+ *         distance, radius, texture->getWidth(), viewportHeight, fovDegrees);
+ * manager.setDesiredLevel(texture, level);
+ * manager.commit();
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ */
+class UTILS_PUBLIC ResidencyManager {
+public:
+    /**
+     * Called from add() and commit() for each mip level whose contents must be (re)uploaded,
+     * from coarsest to finest. The callee uploads the level with Texture::setImage().
+     */
+    using LoadCallback = void(*)(void* user, Texture* texture, uint8_t level);
+
+    explicit ResidencyManager(Engine& engine);
+    ~ResidencyManager() noexcept;
+
+    ResidencyManager(ResidencyManager const&) = delete;
+    ResidencyManager& operator=(ResidencyManager const&) = delete;
+
+    /**
+     * Sets the resident payload budget in bytes. The tails of all managed textures are always
+     * resident, even if they alone exceed the budget. Takes effect at the next commit().
+     */
+    void setBudget(size_t budgetBytes) noexcept;
+
+    /**
+     * Places a texture under management and synchronously streams in its tail.
+     *
+     * @param texture        A mipmapped texture created with its full level count.
+     * @param tailLevels     Number of coarsest levels that stay resident at all times.
+     * @param baseLevelBytes Payload size of mip level 0 in bytes; finer-grained than the
+     *                       manager can derive itself for compressed formats.
+     * @param loader         Invoked for each level to upload, now and from commit().
+     * @param user           Arbitrary pointer passed through to the loader.
+     */
+    void add(Texture* texture, uint8_t tailLevels, size_t baseLevelBytes,
+            LoadCallback loader, void* user);
+
+    /**
+     * Removes a texture from management. Its sampling clamp is reset to the full mip range,
+     * so the caller should only sample it again after re-uploading the fine levels.
+     */
+    void remove(Texture* texture);
+
+    /**
+     * Reports the finest mip level the texture needs for the current view. Unmanaged
+     * textures are ignored.
+     */
+    void setDesiredLevel(Texture* texture, uint8_t level) noexcept;
+
+    /**
+     * Computes the finest useful mip level for a texture on an object of the given bounding
+     * sphere radius at the given distance, i.e. the level whose resolution matches the
+     * object's screen coverage.
+     *
+     * @param distance         Distance from the camera to the object, in world units.
+     * @param boundingRadius   Radius of the object's bounding sphere, in world units.
+     * @param textureDimension Largest dimension of the texture's level 0, in texels.
+     * @param viewportHeight   Height of the viewport, in pixels.
+     * @param fovDegrees       Vertical field of view of the camera, in degrees.
+     */
+    static uint8_t computeDesiredLevel(float distance, float boundingRadius,
+            size_t textureDimension, uint32_t viewportHeight, float fovDegrees) noexcept;
+
+    /**
+     * Applies the desired levels under the budget: streams newly granted levels in through
+     * the loaders and clamps sampling of evicted ones. When the budget is exceeded, the
+     * textures holding the most payload lose their finest resident level first.
+     *
+     * @return the resident payload in bytes after the update.
+     */
+    size_t commit();
+
+    //! Returns the resident payload in bytes as of the last commit().
+    size_t getResidentBytes() const noexcept { return mResidentBytes; }
+
+private:
+    struct Entry {
+        uint8_t levelCount;
+        uint8_t tailLevels;
+        uint8_t desiredLevel;   // finest level the caller wants resident
+        uint8_t residentLevel;  // finest level currently resident
+        size_t baseLevelBytes;
+        LoadCallback loader;
+        void* user;
+    };
+
+    // Payload of levels [minLevel, levelCount) assuming each level is a quarter of the next
+    // finer one, which holds for 2D textures of any format.
+    static size_t residentBytes(Entry const& entry, uint8_t minLevel) noexcept;
+
+    void streamIn(Texture* texture, Entry& entry, uint8_t minLevel);
+
+    Engine& mEngine;
+    tsl::robin_map<Texture*, Entry> mEntries;
+    size_t mBudgetBytes = SIZE_MAX;
+    size_t mResidentBytes = 0;
+};
+
+} // namespace residency
+} // namespace filament
+
+#endif // TNT_RESIDENCY_RESIDENCYMANAGER_H
@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <residency/ResidencyManager.h>
+
+#include <filament/Texture.h>
+
+#include <math/scalar.h>
+
+#include <utils/Log.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace utils;
+
+namespace filament {
+namespace residency {
+
+ResidencyManager::ResidencyManager(Engine& engine) : mEngine(engine) {}
+
+ResidencyManager::~ResidencyManager() noexcept = default;
+
+void ResidencyManager::setBudget(size_t budgetBytes) noexcept {
+    mBudgetBytes = budgetBytes;
+}
+
+size_t ResidencyManager::residentBytes(Entry const& entry, uint8_t minLevel) noexcept {
+    size_t bytes = 0;
+    for (uint8_t level = minLevel; level < entry.levelCount; ++level) {
+        bytes += std::max(size_t(1), entry.baseLevelBytes >> (2u * level));
+    }
+    return bytes;
+}
+
+void ResidencyManager::streamIn(Texture* texture, Entry& entry, uint8_t minLevel) {
+    for (uint8_t level = entry.residentLevel; level > minLevel;) {
+        --level;
+        entry.loader(entry.user, texture, level);
+    }
+    entry.residentLevel = minLevel;
+}
+
+void ResidencyManager::add(Texture* texture, uint8_t tailLevels, size_t baseLevelBytes,
+        LoadCallback loader, void* user) {
+    const uint8_t levelCount = uint8_t(texture->getLevels());
+    if (levelCount < 2 || loader == nullptr) {
+        slog.w << "ResidencyManager: texture is not streamable, ignored." << io::endl;
+        return;
+    }
+    tailLevels = std::min(std::max(tailLevels, uint8_t(1)), levelCount);
+
+    Entry entry = {};
+    entry.levelCount = levelCount;
+    entry.tailLevels = tailLevels;
+    entry.desiredLevel = uint8_t(levelCount - tailLevels);
+    entry.residentLevel = levelCount; // nothing resident until the tail is streamed in below
+    entry.baseLevelBytes = baseLevelBytes;
+    entry.loader = loader;
+    entry.user = user;
+
+    // The tail is resident from the start, so the texture is always safe to sample.
+    streamIn(texture, entry, uint8_t(levelCount - tailLevels));
+    texture->setMinMaxLevels(mEngine, entry.residentLevel, uint8_t(levelCount - 1u));
+    mResidentBytes += residentBytes(entry, entry.residentLevel);
+
+    mEntries[texture] = entry;
+}
+
+void ResidencyManager::remove(Texture* texture) {
+    const auto pos = mEntries.find(texture);
+    if (pos == mEntries.end()) {
+        return;
+    }
+    Entry const& entry = pos->second;
+    mResidentBytes -= residentBytes(entry, entry.residentLevel);
+    // Reset the clamp; the fine levels hold stale data, so the caller is expected to
+    // re-upload them before sampling the texture again.
+    texture->setMinMaxLevels(mEngine, 0, uint8_t(entry.levelCount - 1u));
+    mEntries.erase(pos);
+}
+
+void ResidencyManager::setDesiredLevel(Texture* texture, uint8_t level) noexcept {
+    auto pos = mEntries.find(texture);
+    if (pos == mEntries.end()) {
+        return;
+    }
+    Entry& entry = pos.value();
+    entry.desiredLevel = std::min(level, uint8_t(entry.levelCount - entry.tailLevels));
+}
+
+uint8_t ResidencyManager::computeDesiredLevel(float distance, float boundingRadius,
+        size_t textureDimension, uint32_t viewportHeight, float fovDegrees) noexcept {
+    if (distance <= boundingRadius) {
+        return 0; // the camera is inside (or touching) the bounding sphere
+    }
+    // Project the bounding sphere's diameter onto the viewport, then pick the level whose
+    // resolution most closely matches the number of pixels it covers.
+    const float fovRadians = fovDegrees * math::F_PI / 180.0f;
+    const float pixelsPerUnit = float(viewportHeight) / (2.0f * std::tan(fovRadians * 0.5f));
+    const float coveredPixels = (2.0f * boundingRadius / distance) * pixelsPerUnit;
+    if (coveredPixels <= 0.0f) {
+        return UINT8_MAX; // commit() clamps this to the tail
+    }
+    const float texelsPerPixel = float(textureDimension) / coveredPixels;
+    const float level = std::floor(std::log2(std::max(texelsPerPixel, 1.0f)));
+    return uint8_t(std::min(level, float(UINT8_MAX)));
+}
+
+size_t ResidencyManager::commit() {
+    // Start from the desired levels (the tail is always granted) and compute the payload.
+    tsl::robin_map<Texture*, uint8_t> targets;
+    targets.reserve(mEntries.size());
+    size_t total = 0;
+    for (auto const& [texture, entry] : mEntries) {
+        const uint8_t target = std::min(entry.desiredLevel,
+                uint8_t(entry.levelCount - entry.tailLevels));
+        targets[texture] = target;
+        total += residentBytes(entry, target);
+    }
+
+    // While over budget, evict the finest resident level of the texture holding the most
+    // payload; that frees the largest amount per step and degrades the sharpest texture,
+    // which is the one most likely to be oversampled anyway.
+    while (total > mBudgetBytes) {
+        Texture* victim = nullptr;
+        size_t victimBytes = 0;
+        for (auto const& [texture, target] : targets) {
+            Entry const& entry = mEntries.at(texture);
+            if (target >= entry.levelCount - entry.tailLevels) {
+                continue; // already down to the tail
+            }
+            const size_t bytes = residentBytes(entry, target);
+            if (bytes > victimBytes) {
+                victim = texture;
+                victimBytes = bytes;
+            }
+        }
+        if (victim == nullptr) {
+            break; // the tails alone exceed the budget
+        }
+        const uint8_t degraded = uint8_t(targets[victim] + 1u);
+        Entry const& entry = mEntries.at(victim);
+        total -= residentBytes(entry, targets[victim]) - residentBytes(entry, degraded);
+        targets[victim] = degraded;
+    }
+
+    // Apply: stream in newly granted levels, clamp sampling of evicted ones.
+    for (auto const& [texture, target] : targets) {
+        Entry& entry = mEntries.at(texture);
+        if (target == entry.residentLevel) {
+            continue;
+        }
+        if (target < entry.residentLevel) {
+            streamIn(texture, entry, target);
+        } else {
+            entry.residentLevel = target;
+        }
+        texture->setMinMaxLevels(mEngine, entry.residentLevel, uint8_t(entry.levelCount - 1u));
+    }
+
+    mResidentBytes = total;
+    return total;
+}
+
+} // namespace residency
+} // namespace filament
@@ -27,6 +27,22 @@ using namespace utils;
 static void emptyJob(void*, JobSystem&, JobSystem::Job*) {
 }
 
+// aggregates the per-worker counters into benchmark counters, per iteration
+static void reportWorkerStats(benchmark::State& state, JobSystem& js) {
+    JobSystem::WorkerStats total;
+    // the pool's workers, plus the adopted (benchmark) thread
+    for (size_t i = 0, n = js.getThreadCount() + 1; i < n; i++) {
+        JobSystem::WorkerStats const s = js.getWorkerStats(i);
+        total.steals += s.steals;
+        total.failedSteals += s.failedSteals;
+        total.parks += s.parks;
+    }
+    using benchmark::Counter;
+    state.counters["steals"] = Counter(double(total.steals), Counter::kAvgIterations);
+    state.counters["failedSteals"] = Counter(double(total.failedSteals), Counter::kAvgIterations);
+    state.counters["parks"] = Counter(double(total.parks), Counter::kAvgIterations);
+}
+
 static void BM_JobSystem(benchmark::State& state) {
     JobSystem js;
     js.adopt();
@@ -79,6 +95,88 @@ static void BM_JobSystemParallelFor(benchmark::State& state) {
 }
 
 
+/*
+ * The benchmarks below sweep the worker pool size (the argument; the pool is capped
+ * at 32 workers internally) and report the steal/park counters, to expose steal
+ * contention on high core-count machines.
+ */
+
+// steal-heavy: every job is enqueued on the benchmark thread's queue, so the pool's
+// workers can only obtain work by stealing from it (and from each other's leftovers)
+static void BM_JobSystemStealHeavy(benchmark::State& state) {
+    JobSystem js(size_t(state.range(0)));
+    js.adopt();
+
+    {
+        PerformanceCounters pc(state);
+        for (auto _ : state) {
+            auto root = js.create(nullptr, &emptyJob);
+            for (size_t i = 0; i < 4095; i++) {
+                js.run(js.create(root, &emptyJob));
+            }
+            js.runAndWait(root);
+        }
+    }
+    state.SetItemsProcessed((int64_t)state.iterations() * 4096);
+    reportWorkerStats(state, js);
+
+    js.emancipate();
+}
+
+// fork-join: a binary tree of jobs where each node spawns its two children, so work
+// is produced from all the workers' queues instead of a single producer
+static void BM_JobSystemForkJoin(benchmark::State& state) {
+    struct ForkJoin {
+        uint8_t depth;
+        void operator()(JobSystem& js, JobSystem::Job* job) {
+            if (depth > 0) {
+                ForkJoin const child{ uint8_t(depth - 1) };
+                js.run(js.createJob(job, child));
+                js.run(js.createJob(job, child));
+            }
+        }
+    };
+
+    JobSystem js(size_t(state.range(0)));
+    js.adopt();
+
+    // a tree of depth 12 is 8191 jobs, half of MAX_JOB_COUNT
+    constexpr uint8_t DEPTH = 12;
+    constexpr int64_t JOB_COUNT = (1 << (DEPTH + 1)) - 1;
+
+    {
+        PerformanceCounters pc(state);
+        for (auto _ : state) {
+            js.runAndWait(js.createJob(nullptr, ForkJoin{ DEPTH }));
+        }
+    }
+    state.SetItemsProcessed((int64_t)state.iterations() * JOB_COUNT);
+    reportWorkerStats(state, js);
+
+    js.emancipate();
+}
+
+static void BM_JobSystemParallelForThreads(benchmark::State& state) {
+    JobSystem js(size_t(state.range(0)));
+    js.adopt();
+
+    {
+        PerformanceCounters pc(state);
+        for (auto _ : state) {
+            auto job = jobs::parallel_for(js, nullptr, 0, 4096,
+                    [](uint32_t start, uint32_t count) { }, jobs::CountSplitter<1>());
+            js.runAndWait(job);
+        }
+    }
+    state.SetItemsProcessed((int64_t)state.iterations() * 4096);
+    reportWorkerStats(state, js);
+
+    js.emancipate();
+}
+
 BENCHMARK(BM_JobSystem);
 BENCHMARK(BM_JobSystemAsChildren4k);
 BENCHMARK(BM_JobSystemParallelFor);
+BENCHMARK(BM_JobSystemStealHeavy)->RangeMultiplier(2)->Range(2, 64);
+BENCHMARK(BM_JobSystemForkJoin)->RangeMultiplier(2)->Range(2, 64);
+BENCHMARK(BM_JobSystemParallelForThreads)->RangeMultiplier(2)->Range(2, 64);
@@ -181,6 +181,9 @@ public:
     FreeList(FreeList&& rhs) noexcept = default;
     FreeList& operator=(FreeList&& rhs) noexcept = default;
 
+    // Adds the memory range [begin, end) to the freelist. Existing nodes never move.
+    void grow(void* begin, void* end, size_t elementSize, size_t alignment, size_t extra) noexcept;
+
     void* pop() noexcept {
         Node* const head = mHead;
         mHead = head ? head->next : nullptr;
@@ -227,6 +230,14 @@ public:
     AtomicFreeList(const FreeList& rhs) = delete;
     AtomicFreeList& operator=(const FreeList& rhs) = delete;
 
+    // Adds the memory range [begin, end) to the freelist. Existing nodes never move, and
+    // concurrent pop()/push() remain lock-free while the new range is spliced in; calls to
+    // grow() itself however must be serialized by the caller. Because HeadPtr stores a 32-bit
+    // node offset, every range must lie within int32_t nodes of the first one -- in practice,
+    // all ranges must come from a single contiguous reservation such as
+    // AreaPolicy::ReservedArea.
+    void grow(void* begin, void* end, size_t elementSize, size_t alignment, size_t extra) noexcept;
+
     void* pop() noexcept {
         Node* const storage = mStorage;
 
@@ -367,6 +378,16 @@ public:
         return mFreeList.getFirst();
     }
 
+    // Adds the memory range [begin, end) to the pool, typically pages freshly committed from
+    // an AreaPolicy::ReservedArea. Existing elements never move. See FREELIST::grow() for the
+    // concurrency guarantees and the constraints on the range. A null or empty range -- e.g.
+    // what ReservedArea::grow() yields once the reservation is exhausted -- is a no-op.
+    void grow(void* begin, void* end) noexcept {
+        if (UTILS_LIKELY(begin && begin < end)) {
+            mFreeList.grow(begin, end, ELEMENT_SIZE, ALIGNMENT, OFFSET);
+        }
+    }
+
 private:
     FREELIST mFreeList;
 };
@@ -457,6 +478,48 @@ private:
     void* mEnd = nullptr;
 };
 
+/*
+ * ReservedArea reserves a fixed range of address space up front but only commits physical
+ * pages on demand, via grow(). Because the reservation never moves, pools built on top of it
+ * can grow without relocating live objects -- in particular AtomicFreeList's 32-bit node
+ * offsets stay valid across growth. This lets pools that must be sized for a worst case that
+ * rarely materializes start small instead of paying for the worst case in physical memory.
+ */
+class ReservedArea {
+public:
+    ReservedArea() noexcept = default;
+
+    // Reserves maxSize bytes of address space (rounded up to the page size). No physical
+    // memory is committed until grow() is called.
+    explicit ReservedArea(size_t maxSize) noexcept;
+
+    ~ReservedArea() noexcept;
+
+    ReservedArea(const ReservedArea& rhs) = delete;
+    ReservedArea& operator=(const ReservedArea& rhs) = delete;
+    ReservedArea(ReservedArea&& rhs) noexcept = delete;
+    ReservedArea& operator=(ReservedArea&& rhs) noexcept = delete;
+
+    void* data() const noexcept { return mBegin; }
+    void* begin() const noexcept { return mBegin; }
+
+    // End of the committed region; advances as grow() commits more pages.
+    void* end() const noexcept { return pointermath::add(mBegin, mCommittedSize); }
+    size_t size() const noexcept { return mCommittedSize; }
+    size_t getReservedSize() const noexcept { return mReservedSize; }
+
+    // Commits at least sizeIncrement more bytes (rounded up to the page size) at the end of
+    // the committed region. Returns the beginning of the newly committed range, or nullptr
+    // when the reservation is exhausted or the commit fails.
+    void* grow(size_t sizeIncrement) noexcept;
+
+private:
+    void* mBegin = nullptr;
+    size_t mReservedSize = 0;
+    size_t mCommittedSize = 0;
+    size_t mPageSize = 0;
+};
+
 } // namespace AreaPolicy
 
 // ------------------------------------------------------------------------------------------------
@@ -803,6 +866,8 @@ public:
         mArena.free(p, n * sizeof(TYPE));
     }
 
+    ARENA& getArena() const noexcept { return mArena; }
+
     // these should be out-of-class friends, but this doesn't seem to work with some compilers
     // which complain about multiple definition each time a STLAllocator<> is instantiated.
     template <typename U, typename A>
@@ -20,6 +20,7 @@
 #include <utils/compressed_pair.h>
 #include <utils/Panic.h>
 
+#include <algorithm>
 #include <limits>
 #include <memory>
 #include <type_traits>
@@ -37,6 +38,53 @@
 
 namespace utils {
 
+/**
+ * An allocator for FixedCapacityVector that embeds storage for up to N elements directly in the
+ * vector object, falling back to the heap only for larger capacities. This eliminates heap
+ * allocations for the common case where a vector's worst-case size is small and known up front
+ * (see SmallVector below).
+ *
+ * The embedded storage belongs to a single vector; it is intentionally not copied or swapped
+ * with the allocator, the container moves the elements instead.
+ */
+template<typename T, size_t N>
+class InlineAllocator {
+public:
+    using value_type = T;
+
+    static constexpr size_t inline_capacity = N;
+
+    InlineAllocator() noexcept = default;
+    InlineAllocator(InlineAllocator const&) noexcept { }
+    InlineAllocator(InlineAllocator&&) noexcept { }
+    InlineAllocator& operator=(InlineAllocator const&) noexcept { return *this; }
+    InlineAllocator& operator=(InlineAllocator&&) noexcept { return *this; }
+
+    T* allocate(size_t n) {
+        return n <= N ? inline_data() : std::allocator<T>{}.allocate(n);
+    }
+
+    // Discriminating on the size rather than on the pointer keeps this correct even after the
+    // owning vectors have been swapped (heap storage implies a capacity greater than N).
+    void deallocate(T* p, size_t n) {
+        if (n > N) {
+            std::allocator<T>{}.deallocate(p, n);
+        }
+    }
+
+    T* inline_data() noexcept { return reinterpret_cast<T*>(mStorage); }
+
+private:
+    alignas(alignof(T)) char mStorage[sizeof(T) * N];
+};
+
+template<typename ALLOCATOR, typename = void>
+struct is_inline_allocator : std::false_type {};
+
+template<typename ALLOCATOR>
+struct is_inline_allocator<ALLOCATOR,
+        std::void_t<decltype(std::declval<ALLOCATOR&>().inline_data())>> : std::true_type {};
+
 /**
  * FixedCapacityVector is (almost) a drop-in replacement for std::vector<> except it has a
  * fixed capacity decided at runtime. The vector storage is never reallocated unless reserve()
@@ -78,10 +126,13 @@ public:
         return FixedCapacityVector(construct_with_capacity, capacity, allocator);
     }
 
-    FixedCapacityVector() = default;
+    FixedCapacityVector() noexcept {
+        initInlineStorage();
+    }
 
     explicit FixedCapacityVector(const allocator_type& allocator) noexcept
-            : mCapacityAllocator({}, allocator) {
+            : mCapacityAllocator(SizeTypeWrapper<size_type>{}, allocator) {
+        initInlineStorage();
     }
 
     explicit FixedCapacityVector(size_type size, const allocator_type& allocator = allocator_type())
@@ -107,7 +158,9 @@ public:
         std::uninitialized_copy(rhs.begin(), rhs.end(), begin());
     }
 
-    FixedCapacityVector(FixedCapacityVector&& rhs) noexcept {
+    FixedCapacityVector(FixedCapacityVector&& rhs) noexcept
+            : mCapacityAllocator(SizeTypeWrapper<size_type>{}, rhs.allocator()) {
+        initInlineStorage();
         this->swap(rhs);
     }
 
@@ -272,10 +325,21 @@ public:
     }
 
     void swap(FixedCapacityVector& other) {
-        using std::swap;
-        swap(mData, other.mData);
-        swap(mSize, other.mSize);
-        mCapacityAllocator.swap(other.mCapacityAllocator);
+        if constexpr (is_inline_allocator<allocator_type>::value) {
+            swapInline(other);
+        } else {
+            using std::swap;
+            swap(mData, other.mData);
+            swap(mSize, other.mSize);
+            if constexpr (std::is_swappable_v<allocator_type>) {
+                mCapacityAllocator.swap(other.mCapacityAllocator);
+            } else {
+                // e.g. arena allocators holding a reference: swap only the capacity
+                static_assert(storage_traits::is_always_equal::value,
+                        "a non-swappable stateful allocator cannot be swapped");
+                swap(mCapacityAllocator.first(), other.mCapacityAllocator.first());
+            }
+        }
     }
 
     UTILS_NOINLINE
@@ -297,6 +361,41 @@ private:
         mData = this->allocator().allocate(this->capacity());
     }
 
+    // points mData at the embedded storage when the allocator provides one
+    void initInlineStorage() noexcept {
+        if constexpr (is_inline_allocator<allocator_type>::value) {
+            mData = allocator().inline_data();
+            mCapacityAllocator.first() = size_type(allocator_type::inline_capacity);
+        }
+    }
+
+    // Embedded storage cannot change hands by pointer, so swapping moves elements instead.
+    UTILS_NOINLINE
+    void swapInline(FixedCapacityVector& other) {
+        bool const thisInline = data() == allocator().inline_data();
+        bool const otherInline = other.data() == other.allocator().inline_data();
+        if (!thisInline && !otherInline) {
+            std::swap(mData, other.mData);
+        } else if (thisInline && otherInline) {
+            // swap the common prefix, then move the tail over to the smaller side
+            FixedCapacityVector& s = size() <= other.size() ? *this : other;
+            FixedCapacityVector& l = size() <= other.size() ? other : *this;
+            std::swap_ranges(s.begin(), s.end(), l.begin());
+            std::uninitialized_move(l.begin() + s.size(), l.end(), s.end());
+            destroy(l.begin() + s.size(), l.end());
+        } else {
+            // hand the heap block over and move the inline elements into the freed storage
+            FixedCapacityVector& inl = thisInline ? *this : other;
+            FixedCapacityVector& heap = thisInline ? other : *this;
+            std::uninitialized_move(inl.begin(), inl.end(), heap.allocator().inline_data());
+            destroy(inl.begin(), inl.end());
+            inl.mData = heap.mData;
+            heap.mData = heap.allocator().inline_data();
+        }
+        std::swap(mSize, other.mSize);
+        std::swap(mCapacityAllocator.first(), other.mCapacityAllocator.first());
+    }
+
     allocator_type& allocator() noexcept {
         return mCapacityAllocator.second();
     }
@@ -405,6 +504,15 @@ private:
     compressed_pair<SizeTypeWrapper<size_type>, allocator_type> mCapacityAllocator{};
 };
 
+/**
+ * A FixedCapacityVector with embedded storage for up to N elements. A default-constructed
+ * SmallVector has a capacity of N and performs no heap allocation; reserve() beyond N falls
+ * back to the heap. Intended for hot per-frame paths where the worst-case element count is
+ * small and known.
+ */
+template<typename T, size_t N, bool CapacityCheck = true>
+using SmallVector = FixedCapacityVector<T, InlineAllocator<T, N>, CapacityCheck>;
+
 } // namespace utils
 
 #endif // TNT_UTILS_FIXEDCAPACITYVECTOR_H
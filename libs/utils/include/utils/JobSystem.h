@@ -19,6 +19,7 @@
 
 #include <assert.h>
 
+#include <algorithm>
 #include <atomic>
 #include <functional>
 #include <thread>
@@ -72,7 +73,8 @@ public:
         uint16_t parent;                                        //  2 |  2
         std::atomic<uint16_t> runningJobCount = { 1 };          //  2 |  2
         mutable std::atomic<uint16_t> refCount = { 1 };         //  2 |  2
-                                                                //  6 |  2 (padding)
+        std::atomic<uint16_t> predecessorCount = { 0 };         //  2 |  2
+                                                                //  4 |  0 (padding)
                                                                 // 64 | 64
     };
 
@@ -281,6 +283,19 @@ public:
         runAndWait(p);
     }
 
+    /*
+     * Makes successor runnable only after predecessor has finished, including all of its
+     * children. This expresses DAG-shaped dependencies that the parent-child tree can't:
+     * a job can have several successors and a successor several predecessors, so
+     * independent pipeline stages overlap and join only where a true dependency exists.
+     *
+     * Must be called before either job is submitted. The successor is submitted
+     * automatically when its last predecessor finishes -- never call run() on it.
+     * To wait on a successor, retain() it first and use waitAndRelease() on the
+     * retained reference.
+     */
+    void runAfter(Job* predecessor, Job* successor) noexcept;
+
     // for debugging
     friend utils::io::ostream& operator << (utils::io::ostream& out, JobSystem const& js);
 
@@ -299,10 +314,49 @@ public:
     static void setThreadPriority(Priority priority) noexcept;
     static void setThreadAffinityById(size_t id) noexcept;
 
+    // pins the calling thread to the given set of CPUs (bit i selects CPU i)
+    static void setThreadAffinityByMask(uint32_t cpuMask) noexcept;
+
+    /*
+     * Restricts all worker threads to the given set of CPUs (bit i selects CPU i), e.g.
+     * the big cluster of a big.LITTLE device, instead of the default
+     * one-worker-per-core pinning. A mask of 0 restores the default. The mask is
+     * applied lazily, the next time each worker re-pins itself.
+     */
+    void setWorkerAffinity(uint32_t cpuMask) noexcept;
+
     size_t getParallelSplitCount() const noexcept {
         return mParallelSplitCount;
     }
 
+    size_t getThreadCount() const noexcept {
+        return mThreadCount;
+    }
+
+    /*
+     * Keeps up to workerCount workers from fully parking while in effect: when they run
+     * out of work they keep yielding to the OS instead of blocking on the condition
+     * variable, so bursts of sub-millisecond jobs don't pay the park/wake latency.
+     * Calls nest, each beginBurst() must be matched by an endBurst(); typically these
+     * bracket a frame. Burst workers consume (some) CPU even when there is no work, so
+     * don't leave this enabled while idle.
+     */
+    void beginBurst(uint16_t workerCount) noexcept;
+    void endBurst() noexcept;
+
+    // per-worker counters, updated by the owning worker without synchronization, so the
+    // values are approximate. Useful to tune the back-off policy for a given workload.
+    struct WorkerStats {
+        uint64_t jobsExecuted = 0;  // jobs run by this worker
+        uint64_t steals = 0;        // successful steals from another worker's queue
+        uint64_t failedSteals = 0;  // steal attempts that found the victim's queue empty
+        uint64_t spinWakeups = 0;   // back-offs resolved during the spin phase
+        uint64_t yieldWakeups = 0;  // back-offs resolved during the yield phase
+        uint64_t parks = 0;         // times this worker blocked on the condition variable
+    };
+
+    WorkerStats getWorkerStats(size_t worker) const noexcept;
+
 private:
     // this is just to avoid using std::default_random_engine, since we're in a public header.
     class default_random_engine {
@@ -321,6 +375,11 @@ private:
         // make sure storage is cache-line aligned
         WorkQueue workQueue;
 
+        // these are written by the owning worker thread only
+        alignas(CACHELINE_SIZE)
+        uint32_t spinBudget;        // current spin-phase budget (see backoff())
+        WorkerStats stats;
+
         // these are not accessed by the worker threads
         alignas(CACHELINE_SIZE)     // this causes 56-bytes padding
         JobSystem* js;
@@ -345,8 +404,23 @@ private:
     bool exitRequested() const noexcept;
     bool hasActiveJobs() const noexcept;
 
+    // bounds of the adaptive back-off, in iterations of each phase
+    static constexpr uint32_t SPIN_BUDGET_MIN = 32;
+    static constexpr uint32_t SPIN_BUDGET_MAX = 4096;
+    static constexpr uint32_t YIELD_COUNT = 16;
+
+    // the top bit of Job::parent flags jobs with registered successors (parent indices
+    // only need 15 bits, see MAX_JOB_COUNT)
+    static constexpr uint16_t PARENT_HAS_SUCCESSORS = 0x8000;
+    static constexpr uint16_t PARENT_INDEX_MASK = 0x7FFF;
+
+    void signalSuccessors(Job* job) noexcept;
+
     void loop(ThreadState* state) noexcept;
+    void applyThreadAffinity(ThreadState const& state) const noexcept;
     bool execute(JobSystem::ThreadState& state) noexcept;
+    bool backoff(ThreadState& state) noexcept;
+    bool isBurstWorker(ThreadState const& state) const noexcept;
     Job* steal(JobSystem::ThreadState& state) noexcept;
     void finish(Job* job) noexcept;
 
@@ -393,6 +467,9 @@ private:
     aligned_vector<ThreadState> mThreadStates;          // actual data is stored offline
     std::atomic<bool> mExitRequested = { false };       // this one is almost never written
     std::atomic<uint16_t> mAdoptedThreads = { 0 };      // this one is almost never written
+    std::atomic<uint16_t> mBurstDepth = { 0 };          // written a few times per frame at most
+    std::atomic<uint16_t> mBurstWorkers = { 0 };        // # of workers kept from parking
+    std::atomic<uint32_t> mWorkerAffinityMask = { 0 };  // 0 = pin each worker to its own core
     Job* const mJobStorageBase;                         // Base for conversion to indices
     uint16_t mThreadCount = 0;                          // total # of threads in the pool
     uint8_t mParallelSplitCount = 0;                    // # of split allowable in parallel_for
@@ -400,6 +477,11 @@ private:
 
     utils::SpinLock mThreadMapLock; // this should have very little contention
     tsl::robin_map<std::thread::id, ThreadState *> mThreadMap;
+
+    // successor lists of runAfter(); only touched for jobs that have DAG edges, so
+    // contention is limited to graph construction and the predecessors' completion
+    utils::SpinLock mSuccessorLock;
+    tsl::robin_map<Job const*, std::vector<Job*>> mSuccessorMap;
 };
 
 // -------------------------------------------------------------------------------------------------
@@ -499,6 +581,73 @@ private:
     SplitterType splitter;      // 1
 };
 
+template<typename F>
+struct ParallelForStaticJobData {
+    using Functor = F;
+    using size_type = uint32_t;
+
+    ParallelForStaticJobData(size_type start, size_type count, size_type chunkCount,
+            Functor functor) noexcept
+            : start(start), count(count),
+              chunkCount(chunkCount),
+              functor(std::move(functor)) {
+    }
+
+    void parallelWithJobs(JobSystem& js, JobSystem::Job* parent) noexcept {
+        assert(parent);
+
+        struct ChunkData {
+            size_type start;
+            size_type count;
+            Functor functor;
+            void run(JobSystem&, JobSystem::Job*) noexcept {
+                functor(start, count);
+            }
+        };
+
+        // by default use one chunk per worker thread, plus one for the thread running us
+        size_type chunks = chunkCount ? chunkCount : size_type(js.getThreadCount() + 1);
+        chunks = std::min(chunks, count);
+        if (chunks <= 1) {
+            if (count) {
+                functor(start, count);
+            }
+            return;
+        }
+
+        // spread the remainder over the first chunks, so all chunks are within one
+        // element of each other
+        size_type const chunkSize = count / chunks;
+        size_type const remainder = count % chunks;
+
+        // spawn every chunk but the first one, which we run ourselves below
+        size_type const c0 = chunkSize + size_type(remainder > 0);
+        size_type s = start + c0;
+        for (size_type i = 1; i < chunks; i++) {
+            size_type const c = chunkSize + size_type(i < remainder);
+            JobSystem::Job* job = js.createJob<ChunkData, &ChunkData::run>(parent,
+                    ChunkData{ s, c, functor });
+            if (UTILS_UNLIKELY(job == nullptr)) {
+                // couldn't create a job, run that chunk in place
+                functor(s, c);
+            } else {
+                js.run(job);
+            }
+            s += c;
+        }
+        assert(s == start + count);
+
+        // run the first chunk on this thread while the others are being picked up
+        functor(start, c0);
+    }
+
+private:
+    size_type start;            // 4
+    size_type count;            // 4
+    size_type chunkCount;       // 4
+    Functor functor;            // ?
+};
+
 } // namespace details
 
 
@@ -531,6 +680,44 @@ JobSystem::Job* parallel_for(JobSystem& js, JobSystem::Job* parent,
 }
 
 
+/*
+ * Statically partitioned parallel jobs: the range is pre-split into exactly chunkCount
+ * contiguous ranges of (nearly) equal size, one job each, instead of the recursive
+ * splitting performed by parallel_for(). Best suited to uniform workloads, where it cuts
+ * job allocation churn considerably. A chunkCount of 0 selects one chunk per worker
+ * thread, plus one for the calling thread.
+ */
+
+// statically partitioned parallel jobs with start/count indices
+template<typename F>
+JobSystem::Job* parallel_for_static(JobSystem& js, JobSystem::Job* parent,
+        uint32_t start, uint32_t count, uint32_t chunkCount, F functor) noexcept {
+    using JobData = details::ParallelForStaticJobData<F>;
+    JobData jobData(start, count, chunkCount, std::move(functor));
+    return js.createJob<JobData, &JobData::parallelWithJobs>(parent, std::move(jobData));
+}
+
+// statically partitioned parallel jobs with pointer/count
+template<typename T, typename F>
+JobSystem::Job* parallel_for_static(JobSystem& js, JobSystem::Job* parent,
+        T* data, uint32_t count, uint32_t chunkCount, F functor) noexcept {
+    auto user = [data, f = std::move(functor)](uint32_t s, uint32_t c) {
+        f(data + s, c);
+    };
+    using JobData = details::ParallelForStaticJobData<decltype(user)>;
+    JobData jobData(0, count, chunkCount, std::move(user));
+    return js.createJob<JobData, &JobData::parallelWithJobs>(parent, std::move(jobData));
+}
+
+// statically partitioned parallel jobs on a Slice<>
+template<typename T, typename F>
+JobSystem::Job* parallel_for_static(JobSystem& js, JobSystem::Job* parent,
+        utils::Slice<T> slice, uint32_t chunkCount, F functor) noexcept {
+    return parallel_for_static(js, parent, slice.data(), slice.size(), chunkCount,
+            std::move(functor));
+}
+
+
 template <size_t COUNT, size_t MAX_SPLITS = 12>
 class CountSplitter {
 public:
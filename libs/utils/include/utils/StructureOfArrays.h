@@ -17,6 +17,7 @@
 #ifndef TNT_UTILS_STRUCTUREOFARRAYS_H
 #define TNT_UTILS_STRUCTUREOFARRAYS_H
 
+#include <algorithm>
 #include <array>        // note: this is safe, see how std::array is used below (inline / private)
 #include <cstddef>
 #include <functional>
@@ -34,17 +35,53 @@
 
 namespace utils {
 
+/*
+ * Declares a minimum alignment for one array of a StructureOfArraysBase, e.g.:
+ *      StructureOfArrays<float3, Aligned<float3, 32>> soa;
+ * The second array is then guaranteed to start on a 32-byte boundary, which lets SIMD
+ * consumers (e.g. Culler) use aligned loads. ALIGNMENT must be a power of two.
+ */
+template <typename T, size_t ALIGNMENT>
+struct Aligned {
+    static_assert(ALIGNMENT && !(ALIGNMENT & (ALIGNMENT - 1)),
+            "alignment must be a power of two");
+    static_assert(ALIGNMENT >= alignof(T),
+            "declared alignment is smaller than the type's natural alignment");
+};
+
+namespace details {
+// unwraps Aligned<> array declarations into the element type and its alignment
+template <typename T>
+struct SoaArrayTraits {
+    using Type = T;
+    // we guarantee at least the alignment provided by malloc for all arrays
+    static constexpr size_t alignment =
+            alignof(T) > alignof(std::max_align_t) ? alignof(T) : alignof(std::max_align_t);
+};
+template <typename T, size_t ALIGNMENT>
+struct SoaArrayTraits<Aligned<T, ALIGNMENT>> {
+    using Type = T;
+    static constexpr size_t alignment =
+            ALIGNMENT > SoaArrayTraits<T>::alignment ? ALIGNMENT : SoaArrayTraits<T>::alignment;
+};
+} // namespace details
+
 template <typename Allocator, typename ... Elements>
 class StructureOfArraysBase {
     // number of elements
     static constexpr const size_t kArrayCount = sizeof...(Elements);
 
+    // alignment the whole allocation must honor (the largest of all declared alignments)
+    static constexpr const size_t kAllocationAlignment =
+            std::max({ details::SoaArrayTraits<Elements>::alignment... });
+
 public:
     using SoA = StructureOfArraysBase<Allocator, Elements ...>;
 
     // Type of the Nth array
     template<size_t N>
-    using TypeAt = typename std::tuple_element<N, std::tuple<Elements...>>::type;
+    using TypeAt = typename std::tuple_element<N,
+            std::tuple<typename details::SoaArrayTraits<Elements>::Type...>>::type;
 
     // Number of arrays
     static constexpr size_t getArrayCount() noexcept { return kArrayCount; }
@@ -125,7 +162,8 @@ public:
         friend class StructureRef;
         friend iterator;
         friend const_iterator;
-        using Type = std::tuple<typename std::decay<Elements>::type...>;
+        using Type = std::tuple<
+                typename std::decay<typename details::SoaArrayTraits<Elements>::Type>::type...>;
         Type elements;
 
         template<size_t ... Is>
@@ -270,7 +308,7 @@ public:
         // capacity cannot change when optional storage is specified
         if (capacity >= mSize) {
             const size_t sizeNeeded = getNeededSize(capacity);
-            void* buffer = mAllocator.alloc(sizeNeeded);
+            void* buffer = mAllocator.alloc(sizeNeeded, kAllocationAlignment);
 
             // move all the items (one array at a time) from the old allocation to the new
             // this also update the array pointers
@@ -332,29 +370,37 @@ public:
         return *this;
     }
 
-    StructureOfArraysBase& push_back(Elements const& ... args) noexcept {
+    StructureOfArraysBase& push_back(
+            typename details::SoaArrayTraits<Elements>::Type const& ... args) noexcept {
         ensureCapacity(mSize + 1);
         return push_back_unsafe(args...);
     }
 
-    StructureOfArraysBase& push_back(Elements&& ... args) noexcept {
+    StructureOfArraysBase& push_back(
+            typename details::SoaArrayTraits<Elements>::Type&& ... args) noexcept {
         ensureCapacity(mSize + 1);
-        return push_back_unsafe(std::forward<Elements>(args)...);
+        return push_back_unsafe(std::forward<typename details::SoaArrayTraits<Elements>::Type>(args)...);
     }
 
-    StructureOfArraysBase& push_back_unsafe(Elements const& ... args) noexcept {
+    StructureOfArraysBase& push_back_unsafe(
+            typename details::SoaArrayTraits<Elements>::Type const& ... args) noexcept {
         const size_t last = mSize++;
         size_t i = 0;
         int UTILS_UNUSED dummy[] = {
-                (new(getArray<Elements>(i) + last)Elements(args), i++, 0)... };
+                (new(getArray<typename details::SoaArrayTraits<Elements>::Type>(i) + last)
+                        typename details::SoaArrayTraits<Elements>::Type(args), i++, 0)... };
         return *this;
     }
 
-    StructureOfArraysBase& push_back_unsafe(Elements&& ... args) noexcept {
+    StructureOfArraysBase& push_back_unsafe(
+            typename details::SoaArrayTraits<Elements>::Type&& ... args) noexcept {
         const size_t last = mSize++;
         size_t i = 0;
         int UTILS_UNUSED dummy[] = {
-                (new(getArray<Elements>(i) + last)Elements(std::forward<Elements>(args)), i++, 0)... };
+                (new(getArray<typename details::SoaArrayTraits<Elements>::Type>(i) + last)
+                        typename details::SoaArrayTraits<Elements>::Type(
+                                std::forward<typename details::SoaArrayTraits<Elements>::Type>(args)),
+                        i++, 0)... };
         return *this;
     }
 
@@ -362,7 +408,24 @@ public:
     void forEach(F&& f, ARGS&& ... args) {
         size_t i = 0;
         int UTILS_UNUSED dummy[] = {
-                (f(getArray<Elements>(i), std::forward<ARGS>(args)...), i++, 0)... };
+                (f(getArray<typename details::SoaArrayTraits<Elements>::Type>(i),
+                        std::forward<ARGS>(args)...), i++, 0)... };
+    }
+
+    /*
+     * Iterates the given arrays in lockstep, calling f(index, TypeAt<Es>&...) for each
+     * element in [0, size()). The next few rows are prefetched ahead of the current one,
+     * which helps traversals that touch several wide columns per element (e.g. FScene's
+     * per-renderable loops), where the working set per row spans multiple cache lines.
+     */
+    template<size_t ... Es, typename F>
+    void forEachZip(F&& f) noexcept {
+        forEachZipImpl(std::forward<F>(f), mSize, data<Es>()...);
+    }
+
+    template<size_t ... Es, typename F>
+    void forEachZip(F&& f) const noexcept {
+        forEachZipImpl(std::forward<F>(f), mSize, data<Es>()...);
     }
 
     // return a pointer to the first element of the ElementIndex]th array
@@ -486,6 +549,25 @@ public:
     };
 
 private:
+    template<typename T>
+    static UTILS_ALWAYS_INLINE void prefetch(T const* p) noexcept {
+        UTILS_PREFETCH(p);
+    }
+
+    template<typename F, typename ... Ts>
+    static void forEachZipImpl(F&& f, size_t size, Ts* UTILS_RESTRICT ... arrays) noexcept {
+        // how many rows ahead of the current one we prefetch; enough to cover the memory
+        // latency without evicting the lines we're about to use
+        constexpr size_t PREFETCH_DISTANCE = 8;
+        for (size_t i = 0; i < size; i++) {
+            if (UTILS_LIKELY(i + PREFETCH_DISTANCE < size)) {
+                int UTILS_UNUSED dummy[] = {
+                        (prefetch(arrays + i + PREFETCH_DISTANCE), 0)... };
+            }
+            f(i, arrays[i]...);
+        }
+    }
+
     template<typename T>
     T const* getArray(size_t arrayIndex) const {
         return static_cast<T const*>(mArrayOffset[arrayIndex]);
@@ -517,19 +599,21 @@ private:
 
     static inline std::array<size_t, kArrayCount> getOffsets(size_t capacity) noexcept {
         // compute the required size of each array
-        const size_t sizes[] = { (sizeof(Elements) * capacity)... };
+        const size_t sizes[] = {
+                (sizeof(typename details::SoaArrayTraits<Elements>::Type) * capacity)... };
 
-        // we align each array to the same alignment guaranteed by malloc
-        const size_t align = alignof(std::max_align_t);
+        // each array gets its declared alignment (at least the one guaranteed by malloc);
+        // the allocation itself is aligned to the largest of these, so aligning the offsets
+        // is enough to align the arrays
+        const size_t aligns[] = { details::SoaArrayTraits<Elements>::alignment... };
 
         // hopefully most of this gets unrolled and inlined
         std::array<size_t, kArrayCount> offsets;
         offsets[0] = 0;
         #pragma unroll
         for (size_t i = 1; i < kArrayCount; i++) {
-            size_t unalignment = sizes[i - 1] % align;
-            size_t alignment = unalignment ? (align - unalignment) : 0;
-            offsets[i] = offsets[i - 1] + (sizes[i - 1] + alignment);
+            const size_t align = aligns[i];
+            offsets[i] = (offsets[i - 1] + sizes[i - 1] + align - 1) & ~(align - 1);
         }
         return offsets;
     }
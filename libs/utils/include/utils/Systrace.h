@@ -258,7 +258,138 @@ private:
 } // namespace utils
 
 // ------------------------------------------------------------------------------------------------
-#else // !ANDROID
+#elif defined(__linux__) || defined(__APPLE__) || defined(WIN32)
+// ------------------------------------------------------------------------------------------------
+
+/*
+ * On desktop platforms the same macros record scoped events into per-thread buffers,
+ * written out as a chrome://tracing "Trace Event Format" JSON file when tracing is
+ * disabled or the process exits. The file loads in ui.perfetto.dev (or chrome://tracing)
+ * and shows the same flame traces we get from atrace on device, one track per thread --
+ * JobSystem workers and the backend driver thread tag their tracks through
+ * JobSystem::setThreadName(). Timestamps are nanosecond resolution.
+ *
+ * Capture is opt-in: set the FILAMENT_TRACE environment variable to the output path
+ * (or to "1" for the default "filament-trace.json"). Without it, SYSTRACE_ENABLE() is
+ * a no-op and each macro only costs a relaxed atomic load.
+ */
+
+#include <atomic>
+
+#include <stdint.h>
+
+#include <utils/compiler.h>
+
+#define UTILS_SYSTRACE_HAS_CHROME_TRACE 1
+
+#ifndef SYSTRACE_TAG
+#define SYSTRACE_TAG (SYSTRACE_TAG_ALWAYS)
+#endif
+
+#define SYSTRACE_ENABLE() ::utils::details::ChromeTrace::enable(SYSTRACE_TAG)
+
+#define SYSTRACE_DISABLE() ::utils::details::ChromeTrace::disable(SYSTRACE_TAG)
+
+// everything is static, no per-scope context is needed
+#define SYSTRACE_CONTEXT()
+
+#define SYSTRACE_NAME(name) ::utils::details::ChromeScopedTrace ___tracer(SYSTRACE_TAG, name)
+
+// SYSTRACE_CALL is an SYSTRACE_NAME that uses the current function name.
+#define SYSTRACE_CALL() SYSTRACE_NAME(__FUNCTION__)
+
+#define SYSTRACE_NAME_BEGIN(name) \
+        ::utils::details::ChromeTrace::beginSection(SYSTRACE_TAG, name)
+
+#define SYSTRACE_NAME_END() \
+        ::utils::details::ChromeTrace::endSection(SYSTRACE_TAG)
+
+#define SYSTRACE_ASYNC_BEGIN(name, cookie) \
+        ::utils::details::ChromeTrace::beginAsync(SYSTRACE_TAG, name, cookie)
+
+#define SYSTRACE_ASYNC_END(name, cookie) \
+        ::utils::details::ChromeTrace::endAsync(SYSTRACE_TAG, name, cookie)
+
+#define SYSTRACE_VALUE32(name, val) \
+        ::utils::details::ChromeTrace::setCounter(SYSTRACE_TAG, name, int64_t(val))
+
+#define SYSTRACE_VALUE64(name, val) \
+        ::utils::details::ChromeTrace::setCounter(SYSTRACE_TAG, name, int64_t(val))
+
+// ------------------------------------------------------------------------------------------------
+// No user serviceable code below...
+// ------------------------------------------------------------------------------------------------
+
+namespace utils {
+namespace details {
+
+class ChromeTrace {
+public:
+    static void enable(uint32_t tags) noexcept;
+    static void disable(uint32_t tags) noexcept;
+
+    // names the calling thread's track in the trace. Called by JobSystem::setThreadName().
+    static void setThreadName(const char* name) noexcept;
+
+    static inline bool isEnabled(uint32_t tag) noexcept {
+        return tag && UTILS_UNLIKELY(sEnabledTags.load(std::memory_order_relaxed) & tag);
+    }
+
+    // the names must be string literals (or otherwise outlive the capture), they're
+    // not copied -- which is the case for all the SYSTRACE_ macros.
+    static inline void beginSection(uint32_t tag, const char* name) noexcept {
+        if (isEnabled(tag)) { record('B', name, 0); }
+    }
+
+    static inline void endSection(uint32_t tag) noexcept {
+        if (isEnabled(tag)) { record('E', nullptr, 0); }
+    }
+
+    static inline void beginAsync(uint32_t tag, const char* name, int32_t cookie) noexcept {
+        if (isEnabled(tag)) { record('S', name, cookie); }
+    }
+
+    static inline void endAsync(uint32_t tag, const char* name, int32_t cookie) noexcept {
+        if (isEnabled(tag)) { record('F', name, cookie); }
+    }
+
+    static inline void setCounter(uint32_t tag, const char* name, int64_t value) noexcept {
+        if (isEnabled(tag)) { record('C', name, value); }
+    }
+
+private:
+    static void record(char phase, const char* name, int64_t value) noexcept;
+    static void flush() noexcept;
+    static std::atomic<uint32_t> sEnabledTags;
+};
+
+class ChromeScopedTrace {
+public:
+    ChromeScopedTrace(uint32_t tag, const char* name) noexcept : mTag(tag) {
+        ChromeTrace::beginSection(tag, name);
+    }
+
+    inline ~ChromeScopedTrace() noexcept {
+        ChromeTrace::endSection(mTag);
+    }
+
+    inline void value(uint32_t tag, const char* name, int32_t v) noexcept {
+        ChromeTrace::setCounter(tag, name, int64_t(v));
+    }
+
+    inline void value(uint32_t tag, const char* name, int64_t v) noexcept {
+        ChromeTrace::setCounter(tag, name, v);
+    }
+
+private:
+    const uint32_t mTag;
+};
+
+} // namespace details
+} // namespace utils
+
+// ------------------------------------------------------------------------------------------------
+#else // no tracing support on this platform
 // ------------------------------------------------------------------------------------------------
 
 #define SYSTRACE_ENABLE()
@@ -116,7 +116,9 @@
 #   define UTILS_HAS_HYPER_THREADING 0
 #endif
 
-#if defined(__EMSCRIPTEN__) || defined(FILAMENT_SINGLE_THREADED)
+// With emscripten, threads are available only when building with -pthread (wasm workers +
+// SharedArrayBuffer); whether the page is actually cross-origin isolated is checked at runtime.
+#if (defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)) || defined(FILAMENT_SINGLE_THREADED)
 #   define UTILS_HAS_THREADING 0
 #else
 #   define UTILS_HAS_THREADING 1
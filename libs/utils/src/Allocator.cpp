@@ -19,11 +19,19 @@
 #include <utils/Log.h>
 
 #include <algorithm>
+#include <limits>
 
 #include <stdlib.h>
 #include <assert.h>
 #include <string.h>
 
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 namespace utils {
 
 // ------------------------------------------------------------------------------------------------
@@ -92,6 +100,25 @@ FreeList::FreeList(void* begin, void* end,
 {
 }
 
+void FreeList::grow(void* begin, void* end,
+        size_t elementSize, size_t alignment, size_t extra) noexcept {
+    // a null or empty range (e.g. an exhausted ReservedArea) grows the list by nothing
+    if (UTILS_UNLIKELY(!begin || begin >= end)) {
+        return;
+    }
+    Node* const head = init(begin, end, elementSize, alignment, extra);
+    Node* tail = head;
+    while (tail->next) {
+        tail = tail->next;
+    }
+    tail->next = mHead;
+    mHead = head;
+#ifndef NDEBUG
+    if (!mBegin || begin < mBegin) { mBegin = begin; }
+    if (end > mEnd) { mEnd = end; }
+#endif
+}
+
 AtomicFreeList::AtomicFreeList(void* begin, void* end,
         size_t elementSize, size_t alignment, size_t extra) noexcept
 {
@@ -99,7 +126,15 @@ AtomicFreeList::AtomicFreeList(void* begin, void* end,
     // on some platform (e.g. web) this returns false. we really only care about mobile though.
     assert(mHead.is_lock_free());
 #endif
+    grow(begin, end, elementSize, alignment, extra);
+}
 
+void AtomicFreeList::grow(void* begin, void* end,
+        size_t elementSize, size_t alignment, size_t extra) noexcept {
+    // a null or empty range (e.g. an exhausted ReservedArea) grows the list by nothing
+    if (UTILS_UNLIKELY(!begin || begin >= end)) {
+        return;
+    }
     void* const p = pointermath::align(begin, alignment, extra);
     void* const n = pointermath::align(pointermath::add(p, elementSize), alignment, extra);
     assert(p >= begin && p < end);
@@ -109,23 +144,105 @@ AtomicFreeList::AtomicFreeList(void* begin, void* end,
     const size_t num = (uintptr_t(end) - uintptr_t(p)) / d;
 
     // set first entry
-    Node* head = static_cast<Node*>(p);
-    mStorage = head;
+    Node* const head = static_cast<Node*>(p);
+
+    // The very first range establishes the storage base that HeadPtr offsets are relative to.
+    // This must happen before the freelist is used concurrently, i.e. the initial range is
+    // provided either by the constructor or by a grow() call made before the freelist is
+    // shared with other threads.
+    const bool first = (mStorage == nullptr);
+    if (first) {
+        mStorage = head;
+    }
+    Node* const storage = mStorage;
+    // all ranges must be within reach of the 32-bit node offset stored in HeadPtr
+    assert(head >= storage);
+    assert(size_t(uintptr_t(end) - uintptr_t(storage)) / sizeof(Node)
+            <= size_t(std::numeric_limits<int32_t>::max()));
 
     // next entry
     Node* cur = head;
     for (size_t i = 1; i < num; ++i) {
         Node* next = pointermath::add(cur, d);
-        cur->next = next;
+        cur->next.store(next, std::memory_order_relaxed);
         cur = next;
     }
     assert(cur < end);
     assert(pointermath::add(cur, d) <= end);
-    cur->next = nullptr;
 
-    mHead.store({ int32_t(head - mStorage), 0 });
+    if (first) {
+        cur->next.store(nullptr, std::memory_order_relaxed);
+        mHead.store({ int32_t(head - storage), 0 });
+        return;
+    }
+
+    // Splice the new chain in front of the current head. Existing nodes never move, and
+    // concurrent pop()/push() stay lock-free throughout: they see either the old head or the
+    // new chain. Concurrent calls to grow() itself must be serialized by the caller.
+    HeadPtr currentHead = mHead.load();
+    HeadPtr newHead = { int32_t(head - storage), currentHead.tag + 1 };
+    do {
+        newHead.tag = currentHead.tag + 1;
+        Node* const next = (currentHead.offset >= 0) ? (storage + currentHead.offset) : nullptr;
+        cur->next.store(next, std::memory_order_relaxed);
+    } while (!mHead.compare_exchange_weak(currentHead, newHead));
+}
+
+// ------------------------------------------------------------------------------------------------
+// Areas
+// ------------------------------------------------------------------------------------------------
+
+namespace AreaPolicy {
+
+ReservedArea::ReservedArea(size_t maxSize) noexcept {
+    if (maxSize) {
+#if defined(WIN32)
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        mPageSize = size_t(info.dwPageSize);
+        maxSize = (maxSize + mPageSize - 1) & ~(mPageSize - 1);
+        mBegin = VirtualAlloc(nullptr, maxSize, MEM_RESERVE, PAGE_NOACCESS);
+#else
+        mPageSize = size_t(sysconf(_SC_PAGESIZE));
+        maxSize = (maxSize + mPageSize - 1) & ~(mPageSize - 1);
+        void* const p = mmap(nullptr, maxSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        mBegin = (p == MAP_FAILED) ? nullptr : p;
+#endif
+        mReservedSize = mBegin ? maxSize : 0;
+    }
 }
 
+ReservedArea::~ReservedArea() noexcept {
+    if (mBegin) {
+#if defined(WIN32)
+        VirtualFree(mBegin, 0, MEM_RELEASE);
+#else
+        munmap(mBegin, mReservedSize);
+#endif
+    }
+}
+
+void* ReservedArea::grow(size_t sizeIncrement) noexcept {
+    sizeIncrement = (sizeIncrement + mPageSize - 1) & ~(mPageSize - 1);
+    if (!mBegin || !sizeIncrement || mCommittedSize + sizeIncrement > mReservedSize) {
+        return nullptr;
+    }
+    void* const p = pointermath::add(mBegin, mCommittedSize);
+#if defined(WIN32)
+    if (!VirtualAlloc(p, sizeIncrement, MEM_COMMIT, PAGE_READWRITE)) {
+        return nullptr;
+    }
+#else
+    if (mprotect(p, sizeIncrement, PROT_READ | PROT_WRITE) != 0) {
+        return nullptr;
+    }
+#endif
+    mCommittedSize += sizeIncrement;
+    return p;
+}
+
+} // namespace AreaPolicy
+
 // ------------------------------------------------------------------------------------------------
 
 void TrackingPolicy::HighWatermark::onAlloc(
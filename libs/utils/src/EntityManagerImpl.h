@@ -31,6 +31,8 @@
 #include <tsl/robin_map.h>
 #endif
 
+#include <algorithm>
+#include <atomic>
 #include <deque>
 #include <mutex> // for std::lock_guard
 #include <vector>
@@ -40,6 +42,11 @@ namespace utils {
 
 static constexpr const size_t MIN_FREE_INDICES = 1024;
 
+// Number of free-list shards; must be a power of two. Each shard has its own lock, so
+// threads destroying (and later recycling) unrelated entities don't serialize on a single
+// mutex. Freed indices are distributed across shards by their low bits.
+static constexpr const size_t FREE_LIST_SHARD_COUNT = 8;
+
 class UTILS_PRIVATE EntityManagerImpl : public EntityManager {
 public:
     using EntityManager::getGeneration;
@@ -49,48 +56,60 @@ public:
     using EntityManager::destroy;
 
     void create(size_t n, Entity* entities) {
-        Entity::Type index{};
-        auto& freeList = mFreeList;
         uint8_t* const gens = mGens;
+        size_t i = 0;
+
+        // If more than a certain number of freed indices have accumulated, recycle them
+        // first. This is a trade-off between how often we recycle indices and how large the
+        // free lists can grow. The count is approximate (relaxed), which only affects when
+        // we cross the threshold, not correctness.
+        if (UTILS_UNLIKELY(
+                mFreeIndicesCount.load(std::memory_order_relaxed) >= MIN_FREE_INDICES)) {
+            i = createFromFreeLists(n, entities, i);
+        }
 
-        // this must be thread-safe, acquire the free-list mutex
-        std::lock_guard<Mutex> lock(mFreeListLock);
-        Entity::Type currentIndex = mCurrentIndex;
-        for (size_t i = 0; i < n; i++) {
-            // If we have more than a certain number of freed indices, get one from the list.
-            // this is a trade-off between how often we recycle indices and how large the free list
-            // can grow.
-            if (UTILS_UNLIKELY(currentIndex >= RAW_INDEX_COUNT || freeList.size() >= MIN_FREE_INDICES)) {
-
-                // this could only happen if we had gone through all the indices at least once
-                if (UTILS_UNLIKELY(freeList.empty())) {
-                    // return the null entity
-                    entities[i] = {};
-                    continue;
+        // In the common case -- in particular for the whole of a loading burst -- we claim a
+        // range of fresh indices with a single atomic add and never take a lock. This works
+        // only until all indices have been used once, at which point we're always in the
+        // recycling case. The idea is that we have enough indices that it doesn't happen in
+        // practice.
+        if (UTILS_LIKELY(i < n)) {
+            Entity::Type first = mCurrentIndex.load(std::memory_order_relaxed);
+            Entity::Type count;
+            do {
+                count = Entity::Type(std::min(n - i,
+                        first < RAW_INDEX_COUNT ? size_t(RAW_INDEX_COUNT - first) : size_t(0)));
+                if (count == 0) {
+                    break;
                 }
+            } while (!mCurrentIndex.compare_exchange_weak(first, first + count,
+                    std::memory_order_relaxed));
+            for (Entity::Type c = 0; c < count; ++c, ++i) {
+                entities[i] = Entity{ makeIdentity(gens[first + c], first + c) };
+            }
+        }
 
-                index = freeList.front();
-                freeList.pop_front();
-            } else {
-                // In the common case, we just grab the next index.
-                // This works only until all indices have been used once, at which point
-                // we're always in the slower case above. The idea is that we have enough indices
-                // that it doesn't happen in practice.
-                index = currentIndex++;
+        // Fresh indices are exhausted: recycle whatever is available, and return the null
+        // entity for the remainder.
+        if (UTILS_UNLIKELY(i < n)) {
+            i = createFromFreeLists(n, entities, i);
+            while (i < n) {
+                entities[i++] = {};
             }
-            entities[i] = Entity{ makeIdentity(gens[index], index) };
+        }
+
 #if FILAMENT_UTILS_TRACK_ENTITIES
-            mDebugActiveEntities.emplace(entities[i], CallStack::unwind(5));
-#endif
+        std::lock_guard<Mutex> lock(mTrackerLock);
+        for (size_t j = 0; j < n; j++) {
+            if (entities[j]) {
+                mDebugActiveEntities.emplace(entities[j], CallStack::unwind(5));
+            }
         }
-        mCurrentIndex = currentIndex;
+#endif
     }
 
     void destroy(size_t n, Entity* entities) noexcept {
-        auto& freeList = mFreeList;
         uint8_t* const gens = mGens;
-
-        std::unique_lock<Mutex> lock(mFreeListLock);
         for (size_t i = 0; i < n; i++) {
             if (!entities[i]) {
                 // behave like free(), ok to free null Entity.
@@ -105,20 +124,25 @@ public:
             // will be called.
             if (isAlive(entities[i])) {
                 Entity::Type index = getIndex(entities[i]);
-                freeList.push_back(index);
-
-                // The generation update doesn't require the lock because it's only used for isAlive()
-                // and entities work as weak references -- it just means that isAlive() could return
-                // true a little longer than expected in some other threads.
-                // We do need a memory fence though, it is provided by the mFreeListLock.unlock() below.
-                gens[index]++;
+                Shard& shard = mShards[index & (FREE_LIST_SHARD_COUNT - 1)];
+                {
+                    std::lock_guard<Mutex> guard(shard.lock);
+                    shard.freeList.push_back(index);
+
+                    // The generation update is only used for isAlive() and entities work as
+                    // weak references -- a stale read just means that isAlive() could return
+                    // true a little longer than expected in some other threads. The memory
+                    // fence needed for the recycling path is provided by the shard lock.
+                    gens[index]++;
+                }
+                mFreeIndicesCount.fetch_add(1, std::memory_order_relaxed);
 
 #if FILAMENT_UTILS_TRACK_ENTITIES
+                std::lock_guard<Mutex> lock(mTrackerLock);
                 mDebugActiveEntities.erase(entities[i]);
 #endif
             }
         }
-        lock.unlock();
 
         // notify our listeners that some entities are being destroyed
         auto listeners = getListeners();
@@ -166,16 +190,42 @@ public:
 #endif
 
 private:
-    uint32_t mCurrentIndex = 1;
+    // pops recycled indices from the sharded free lists, locking one shard at a time
+    size_t createFromFreeLists(size_t n, Entity* entities, size_t i) noexcept {
+        uint8_t* const gens = mGens;
+        for (size_t s = 0; s < FREE_LIST_SHARD_COUNT && i < n; s++) {
+            Shard& shard = mShards[s];
+            std::lock_guard<Mutex> guard(shard.lock);
+            auto& freeList = shard.freeList;
+            while (i < n && !freeList.empty()) {
+                Entity::Type index = freeList.front();
+                freeList.pop_front();
+                mFreeIndicesCount.fetch_sub(1, std::memory_order_relaxed);
+                entities[i++] = Entity{ makeIdentity(gens[index], index) };
+            }
+        }
+        return i;
+    }
+
+    // next index that has never been handed out; advanced with a single atomic add even
+    // for bulk creations
+    std::atomic<Entity::Type> mCurrentIndex = { 1 };
+
+    // total number of indices currently sitting in the free lists (approximate)
+    std::atomic<uint32_t> mFreeIndicesCount = { 0 };
 
-    // stores indices that got freed
-    mutable Mutex mFreeListLock;
-    std::deque<Entity::Type> mFreeList;
+    // stores indices that got freed, sharded by the low bits of the index
+    struct Shard {
+        mutable Mutex lock;
+        std::deque<Entity::Type> freeList;
+    };
+    Shard mShards[FREE_LIST_SHARD_COUNT];
 
     mutable Mutex mListenerLock;
     tsl::robin_set<Listener*> mListeners;
 
 #if FILAMENT_UTILS_TRACK_ENTITIES
+    mutable Mutex mTrackerLock;
     tsl::robin_map<Entity, CallStack> mDebugActiveEntities;
 #endif
 };
@@ -39,6 +39,10 @@ static constexpr bool DEBUG_FINISH_HANGS = false;
 #    include <pthread.h>
 #endif
 
+#if defined(__EMSCRIPTEN_PTHREADS__)
+#    include <emscripten/threading.h>
+#endif
+
 #ifdef __ANDROID__
 #    include <sys/time.h>
 #    include <sys/resource.h>
@@ -78,6 +82,10 @@ void JobSystem::setThreadName(const char* name) noexcept {
 #else
 // TODO: implement setting thread name on WIN32
 #endif
+#ifdef UTILS_SYSTRACE_HAS_CHROME_TRACE
+    // also names this thread's track in desktop traces
+    details::ChromeTrace::setThreadName(name);
+#endif
 }
 
 void JobSystem::setThreadPriority(Priority priority) noexcept {
@@ -107,6 +115,36 @@ void JobSystem::setThreadAffinityById(size_t id) noexcept {
 #endif
 }
 
+void JobSystem::setThreadAffinityByMask(uint32_t cpuMask) noexcept {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (size_t cpu = 0; cpu < 32; cpu++) {
+        if (cpuMask & (1u << cpu)) {
+            CPU_SET(cpu, &set);
+        }
+    }
+    if (CPU_COUNT(&set)) {
+        sched_setaffinity(gettid(), sizeof(set), &set);
+    }
+#endif
+}
+
+void JobSystem::setWorkerAffinity(uint32_t cpuMask) noexcept {
+    mWorkerAffinityMask.store(cpuMask, std::memory_order_relaxed);
+    // wake everybody up, so parked workers re-pin themselves promptly
+    wakeAll();
+}
+
+inline void JobSystem::applyThreadAffinity(ThreadState const& state) const noexcept {
+    uint32_t const mask = mWorkerAffinityMask.load(std::memory_order_relaxed);
+    if (UTILS_UNLIKELY(mask)) {
+        setThreadAffinityByMask(mask);
+    } else {
+        setThreadAffinityById(state.id);
+    }
+}
+
 JobSystem::JobSystem(const size_t userThreadCount, const size_t adoptableThreadsCount) noexcept
     : mJobPool("JobSystem Job pool", MAX_JOB_COUNT * sizeof(Job)),
       mJobStorageBase(static_cast<Job *>(mJobPool.getAllocator().getCurrent()))
@@ -131,6 +169,14 @@ JobSystem::JobSystem(const size_t userThreadCount, const size_t adoptableThreads
     // and also limit the pool to 32 threads
     threadPoolCount = std::min(UTILS_HAS_THREADING ? 32 : 0, threadPoolCount);
 
+#if defined(__EMSCRIPTEN_PTHREADS__)
+    // Wasm threads need SharedArrayBuffer, which browsers only expose to cross-origin
+    // isolated pages (COOP/COEP headers); fall back to single-threaded operation otherwise.
+    if (!emscripten_has_threading_support()) {
+        threadPoolCount = 0;
+    }
+#endif
+
     mThreadStates = aligned_vector<ThreadState>(threadPoolCount + adoptableThreadsCount);
     mThreadCount = uint16_t(threadPoolCount);
     mParallelSplitCount = (uint8_t)std::ceil((std::log2f(threadPoolCount + adoptableThreadsCount)));
@@ -148,6 +194,8 @@ JobSystem::JobSystem(const size_t userThreadCount, const size_t adoptableThreads
         state.rndGen = default_random_engine(rd());
         state.id = (uint32_t)i;
         state.js = this;
+        state.spinBudget = SPIN_BUDGET_MIN;
+        state.stats = {};
         if (i < hardwareThreadCount) {
             // don't start a thread of adoptable thread slots
             state.thread = std::thread(&JobSystem::loop, this, &state);
@@ -304,6 +352,13 @@ JobSystem::Job* JobSystem::steal(JobSystem::ThreadState& state) noexcept {
         ThreadState* const stateToStealFrom = getStateToStealFrom(state);
         if (UTILS_LIKELY(stateToStealFrom)) {
             job = steal(stateToStealFrom->workQueue);
+            if (job) {
+                state.stats.steals++;
+            } else {
+                // either the victim's queue was empty, or we lost the race for its
+                // last entry -- both are contention from this worker's point of view
+                state.stats.failedSteals++;
+            }
         }
         // nullptr -> nothing to steal in that queue either, if there are active jobs,
         // continue to try stealing one.
@@ -323,6 +378,8 @@ bool JobSystem::execute(JobSystem::ThreadState& state) noexcept {
     if (job) {
         assert(job->runningJobCount.load(std::memory_order_relaxed) >= 1);
 
+        state.stats.jobsExecuted++;
+
         UTILS_UNUSED_IN_RELEASE
         uint32_t activeJobs = mActiveJobs.fetch_sub(1, std::memory_order_relaxed);
         assert(activeJobs); // whoops, we were already at 0
@@ -337,13 +394,50 @@ bool JobSystem::execute(JobSystem::ThreadState& state) noexcept {
     return job != nullptr;
 }
 
+inline bool JobSystem::isBurstWorker(ThreadState const& state) const noexcept {
+    // memory_order_relaxed is safe: a stale value only causes one extra back-off
+    // iteration or an unnecessary park, both of which are benign.
+    return mBurstDepth.load(std::memory_order_relaxed) != 0
+            && state.id < mBurstWorkers.load(std::memory_order_relaxed);
+}
+
+UTILS_NOINLINE
+bool JobSystem::backoff(ThreadState& state) noexcept {
+    // Spin phase: ~ns-scale reaction time and keeps the core hot. The budget adapts to
+    // the workload: it grows when spinning pays off and shrinks when we end up parking,
+    // so steady bursts spin longer and an idle system falls through quickly.
+    uint32_t const spinBudget = state.spinBudget;
+    for (uint32_t i = 0; i < spinBudget; i++) {
+        UTILS_PAUSE();
+        if (UTILS_UNLIKELY(hasActiveJobs() || exitRequested())) {
+            state.spinBudget = std::min(spinBudget * 2u, SPIN_BUDGET_MAX);
+            state.stats.spinWakeups++;
+            return true;
+        }
+    }
+
+    // Yield phase: gives the core away but still avoids the park/wake round-trip.
+    // Burst workers never leave this phase (see beginBurst()).
+    for (uint32_t i = 0; i < YIELD_COUNT || isBurstWorker(state); i++) {
+        std::this_thread::yield();
+        if (hasActiveJobs() || exitRequested()) {
+            state.stats.yieldWakeups++;
+            return true;
+        }
+    }
+
+    // nothing showed up, spin less next time and let the caller park us
+    state.spinBudget = std::max(spinBudget / 2u, SPIN_BUDGET_MIN);
+    return false;
+}
+
 void JobSystem::loop(ThreadState* state) noexcept {
     setThreadName("JobSystem::loop");
     setThreadPriority(Priority::DISPLAY);
 
     // set a CPU affinity on each of our JobSystem thread to prevent them from jumping from core
     // to core. On Android, it looks like the affinity needs to be reset from time to time.
-    setThreadAffinityById(state->id);
+    applyThreadAffinity(*state);
 
     // record our work queue
     mThreadMapLock.lock();
@@ -354,10 +448,16 @@ void JobSystem::loop(ThreadState* state) noexcept {
     // run our main loop...
     do {
         if (!execute(*state)) {
-            std::unique_lock<Mutex> lock(mWaiterLock);
-            while (!exitRequested() && !hasActiveJobs()) {
-                wait(lock);
-                setThreadAffinityById(state->id);
+            // all queues are empty; back off (spin, then yield) before parking, a
+            // park/wake round-trip costs orders of magnitude more than a back-off
+            // iteration, which matters for bursts of sub-millisecond jobs.
+            if (UTILS_UNLIKELY(!backoff(*state))) {
+                std::unique_lock<Mutex> lock(mWaiterLock);
+                while (!exitRequested() && !hasActiveJobs() && !isBurstWorker(*state)) {
+                    state->stats.parks++;
+                    wait(lock);
+                    applyThreadAffinity(*state);
+                }
             }
         }
     } while (!exitRequested());
@@ -379,7 +479,11 @@ void JobSystem::finish(Job* job) noexcept {
         if (runningJobCount == 1) {
             // no more work, destroy this job and notify its parent
             notify = true;
-            Job* const parent = job->parent == 0x7FFF ? nullptr : &storage[job->parent];
+            uint16_t const parentIndex = job->parent & PARENT_INDEX_MASK;
+            Job* const parent = parentIndex == 0x7FFF ? nullptr : &storage[parentIndex];
+            if (UTILS_UNLIKELY(job->parent & PARENT_HAS_SUCCESSORS)) {
+                signalSuccessors(job);
+            }
             decRef(job);
             job = parent;
         } else {
@@ -441,6 +545,33 @@ void JobSystem::signal() noexcept {
     wakeAll();
 }
 
+void JobSystem::beginBurst(uint16_t workerCount) noexcept {
+    workerCount = std::min(workerCount, mThreadCount);
+    // nested bursts keep the largest requested worker set
+    uint16_t current = mBurstWorkers.load(std::memory_order_relaxed);
+    while (current < workerCount
+            && !mBurstWorkers.compare_exchange_weak(current, workerCount,
+                    std::memory_order_relaxed)) {
+    }
+    mBurstDepth.fetch_add(1, std::memory_order_relaxed);
+    // parked burst workers need to wake up and start yielding instead
+    wakeAll();
+}
+
+void JobSystem::endBurst() noexcept {
+    auto depth = mBurstDepth.fetch_sub(1, std::memory_order_relaxed);
+    assert(depth > 0);
+    if (depth == 1) {
+        mBurstWorkers.store(0, std::memory_order_relaxed);
+    }
+}
+
+JobSystem::WorkerStats JobSystem::getWorkerStats(size_t worker) const noexcept {
+    assert(worker < mThreadStates.size());
+    // the worker updates its counters without synchronization, values are approximate
+    return mThreadStates[worker].stats;
+}
+
 void JobSystem::run(Job*& job) noexcept {
     HEAVY_SYSTRACE_CALL();
 
@@ -462,6 +593,43 @@ void JobSystem::run(Job*& job) noexcept {
     job = nullptr;
 }
 
+void JobSystem::runAfter(Job* predecessor, Job* successor) noexcept {
+    assert(predecessor && successor);
+    // neither job may have been submitted yet
+    assert(predecessor->runningJobCount.load(std::memory_order_relaxed) >= 1);
+    assert(successor->runningJobCount.load(std::memory_order_relaxed) >= 1);
+
+    // memory_order_relaxed is safe: the count only gates submission, and the edges are
+    // published to the workers by the predecessor's run() below.
+    successor->predecessorCount.fetch_add(1, std::memory_order_relaxed);
+
+    std::lock_guard<SpinLock> lock(mSuccessorLock);
+    predecessor->parent |= PARENT_HAS_SUCCESSORS;
+    mSuccessorMap[predecessor].push_back(successor);
+}
+
+UTILS_NOINLINE
+void JobSystem::signalSuccessors(Job* job) noexcept {
+    std::vector<Job*> successors;
+    {
+        std::lock_guard<SpinLock> lock(mSuccessorLock);
+        auto pos = mSuccessorMap.find(job);
+        if (pos != mSuccessorMap.end()) {
+            successors = std::move(pos.value());
+            mSuccessorMap.erase(pos);
+        }
+    }
+    for (Job* successor : successors) {
+        // memory_order_acq_rel so the last predecessor to finish sees the writes of all
+        // the others before the successor is submitted
+        auto count = successor->predecessorCount.fetch_sub(1, std::memory_order_acq_rel);
+        assert(count >= 1);
+        if (count == 1) {
+            run(successor);
+        }
+    }
+}
+
 JobSystem::Job* JobSystem::runAndRetain(Job* job) noexcept {
     JobSystem::Job* retained = retain(job);
     run(job);
@@ -220,4 +220,188 @@ void Systrace::int64_body(int fd, int pid, const char* name, int64_t value) noex
 } // namespace details
 } // namespace utils
 
+#elif defined(__linux__) || defined(__APPLE__) || defined(WIN32)
+
+#include <utils/Mutex.h>
+#include <utils/SpinLock.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace utils {
+namespace details {
+
+std::atomic<uint32_t> ChromeTrace::sEnabledTags = { 0 };
+
+namespace {
+
+struct TraceEvent {
+    const char* name;       // owned by the caller, must outlive the capture
+    uint64_t timestamp;     // steady clock, nanoseconds
+    int64_t value;          // counter value, or async event cookie
+    char phase;             // trace event format phase ('B', 'E', 'S', 'F', 'C')
+};
+
+struct ThreadBuffer {
+    // per-thread cap so a long capture can't OOM the process (24 MiB / thread)
+    static constexpr size_t MAX_EVENT_COUNT = 1u << 20;
+    utils::SpinLock lock;   // uncontended, except briefly during flush
+    std::vector<TraceEvent> events;
+    char name[32] = {};
+    uint32_t tid = 0;
+    uint64_t dropped = 0;
+};
+
+struct Registry {
+    utils::Mutex lock;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    const char* path = nullptr;
+    bool atExitRegistered = false;
+};
+
+Registry& getRegistry() noexcept {
+    static Registry sRegistry;
+    return sRegistry;
+}
+
+// buffers are owned by the registry, so they survive their thread and get flushed
+ThreadBuffer& getThreadBuffer() noexcept {
+    static thread_local ThreadBuffer* const sBuffer = []() {
+        Registry& registry = getRegistry();
+        std::lock_guard<utils::Mutex> guard(registry.lock);
+        registry.buffers.push_back(std::make_unique<ThreadBuffer>());
+        ThreadBuffer* const buffer = registry.buffers.back().get();
+        buffer->tid = uint32_t(registry.buffers.size());
+        return buffer;
+    }();
+    return *sBuffer;
+}
+
+uint64_t now() noexcept {
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // anonymous namespace
+
+void ChromeTrace::enable(uint32_t tags) noexcept {
+    Registry& registry = getRegistry();
+    {
+        std::lock_guard<utils::Mutex> guard(registry.lock);
+        if (!registry.path) {
+            const char* const env = getenv("FILAMENT_TRACE");
+            if (!env || !env[0]) {
+                return; // capture not requested
+            }
+            registry.path = (env[0] == '1' && !env[1]) ? "filament-trace.json" : env;
+        }
+        if (!registry.atExitRegistered) {
+            registry.atExitRegistered = true;
+            atexit([]() { ChromeTrace::disable(~0u); });
+        }
+    }
+    sEnabledTags.fetch_or(tags, std::memory_order_relaxed);
+}
+
+void ChromeTrace::disable(uint32_t tags) noexcept {
+    uint32_t const previous = sEnabledTags.fetch_and(~tags, std::memory_order_relaxed);
+    if (previous && !(previous & ~tags)) {
+        // the last enabled tag was just disabled, write the capture out
+        flush();
+    }
+}
+
+void ChromeTrace::setThreadName(const char* name) noexcept {
+    ThreadBuffer& buffer = getThreadBuffer();
+    std::lock_guard<utils::SpinLock> guard(buffer.lock);
+    strncpy(buffer.name, name, sizeof(buffer.name) - 1);
+}
+
+void ChromeTrace::record(char phase, const char* name, int64_t value) noexcept {
+    ThreadBuffer& buffer = getThreadBuffer();
+    std::lock_guard<utils::SpinLock> guard(buffer.lock);
+    if (UTILS_UNLIKELY(buffer.events.size() >= ThreadBuffer::MAX_EVENT_COUNT)) {
+        buffer.dropped++;
+        return;
+    }
+    buffer.events.push_back({ name, now(), value, phase });
+}
+
+void ChromeTrace::flush() noexcept {
+    Registry& registry = getRegistry();
+    std::lock_guard<utils::Mutex> guard(registry.lock);
+    if (!registry.path) {
+        return;
+    }
+
+    FILE* const out = fopen(registry.path, "w");
+    if (!out) {
+        slog.e << "ChromeTrace: can't write \"" << registry.path << "\"" << io::endl;
+        return;
+    }
+
+    fprintf(out, "{\"traceEvents\":[");
+    const char* separator = "\n";
+    size_t eventCount = 0;
+    for (auto const& item : registry.buffers) {
+        ThreadBuffer& buffer = *item;
+        std::lock_guard<utils::SpinLock> bufferGuard(buffer.lock);
+        if (buffer.name[0]) {
+            fprintf(out, "%s{\"ph\":\"M\",\"pid\":1,\"tid\":%u,"
+                         "\"name\":\"thread_name\",\"args\":{\"name\":\"%s\"}}",
+                    separator, buffer.tid, buffer.name);
+            separator = ",\n";
+        }
+        for (TraceEvent const& e : buffer.events) {
+            // "ts" is in microseconds; keep the nanosecond digits as a fraction
+            double const ts = double(e.timestamp) * 1e-3;
+            switch (e.phase) {
+                case 'B':
+                    fprintf(out, "%s{\"ph\":\"B\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,"
+                                 "\"name\":\"%s\"}", separator, buffer.tid, ts, e.name);
+                    break;
+                case 'E':
+                    fprintf(out, "%s{\"ph\":\"E\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}",
+                            separator, buffer.tid, ts);
+                    break;
+                case 'S':
+                case 'F':
+                    fprintf(out, "%s{\"ph\":\"%c\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,"
+                                 "\"name\":\"%s\",\"id\":%lld}",
+                            separator, e.phase, buffer.tid, ts, e.name, (long long)e.value);
+                    break;
+                case 'C':
+                    fprintf(out, "%s{\"ph\":\"C\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,"
+                                 "\"name\":\"%s\",\"args\":{\"value\":%lld}}",
+                            separator, buffer.tid, ts, e.name, (long long)e.value);
+                    break;
+                default:
+                    continue;
+            }
+            separator = ",\n";
+            eventCount++;
+        }
+        if (buffer.dropped) {
+            slog.w << "ChromeTrace: dropped " << buffer.dropped
+                   << " events on thread " << buffer.tid << io::endl;
+        }
+        buffer.events.clear();
+        buffer.dropped = 0;
+    }
+    fprintf(out, "\n]}\n");
+    fclose(out);
+
+    slog.d << "ChromeTrace: wrote " << eventCount << " events to \""
+           << registry.path << "\"" << io::endl;
+}
+
+} // namespace details
+} // namespace utils
+
 #endif // ANDROID
@@ -153,6 +153,54 @@ TEST(AllocatorTest, PoolAllocator) {
     }
 }
 
+TEST(AllocatorTest, PoolAllocatorGrowth) {
+    // reserve plenty of address space -- each grow() below commits at least a whole page,
+    // and the test needs room for two separate page-granular commits
+    AreaPolicy::ReservedArea area(1024 * 1024);
+    EXPECT_NE(nullptr, area.begin());
+    EXPECT_EQ(0u, area.size());
+
+    PoolAllocator<64, 32, 0, AtomicFreeList> pa;
+    void* const slab0 = area.grow(4 * 64);
+    EXPECT_NE(nullptr, slab0);
+    pa.grow(slab0, area.end());
+
+    // the first slab was rounded up to the page size, drain it entirely
+    size_t count = 0;
+    std::vector<void*> allocated;
+    for (void* p = pa.alloc(); p; p = pa.alloc()) {
+        EXPECT_EQ(0, uintptr_t(p) & 31);
+        allocated.push_back(p);
+        ++count;
+    }
+    EXPECT_GE(count, 4u);
+
+    // grow the pool with a second slab, previous allocations must remain valid
+    void* const slab1 = area.grow(4 * 64);
+    EXPECT_NE(nullptr, slab1);
+    EXPECT_GT(slab1, slab0);
+    pa.grow(slab1, area.end());
+
+    void* const p = pa.alloc();
+    EXPECT_NE(nullptr, p);
+    EXPECT_GE(p, slab1);
+    pa.free(p);
+
+    // growing by a null or empty range -- what ReservedArea::grow() yields once the
+    // reservation is exhausted -- must be a harmless no-op
+    pa.grow(nullptr, area.end());
+    pa.grow(area.end(), area.end());
+
+    for (void* q : allocated) {
+        memset(q, 0xaa, 64);
+        pa.free(q);
+    }
+
+    // everything freed is available again
+    for (size_t i = 0; i < count; i++) {
+        EXPECT_NE(nullptr, pa.alloc());
+    }
+}
 
 TEST(AllocatorTest, CppAllocator) {
     struct Tracking {
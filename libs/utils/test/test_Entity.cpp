@@ -93,8 +93,11 @@ TEST(EntityTest, Free) {
     // using a new generation
 
     Entity e = em.create();
-    // generation=1, index=1
-    EXPECT_EQ(EntityManagerImpl::makeIdentity(1, 1), e.getId());
+    // the index comes from the free lists (which shard is implementation defined),
+    // with generation=1
+    EXPECT_EQ(1u, EntityManagerImpl::getGeneration(e));
+    EXPECT_GE(EntityManagerImpl::getIndex(e), 1u);
+    EXPECT_LE(EntityManagerImpl::getIndex(e), 1024u);
 }
 
 TEST(EntityTest, Lots) {
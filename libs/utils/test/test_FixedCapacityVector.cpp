@@ -255,3 +255,63 @@ TEST(FixedCapacityVectorTest, Insertions) {
     EXPECT_EQ(v.size(), 0);
 }
 
+
+TEST(SmallVectorTest, InlineStorage) {
+    SmallVector<int, 4> v;
+
+    // a default-constructed SmallVector has its inline capacity available
+    EXPECT_EQ(v.capacity(), 4);
+    EXPECT_EQ(v.size(), 0);
+
+    const int* inlineData = v.data();
+    v.push_back(1);
+    v.push_back(2);
+    v.push_back(3);
+    v.push_back(4);
+
+    // no reallocation happened
+    EXPECT_EQ(v.data(), inlineData);
+    EXPECT_EQ(v.size(), 4);
+
+    // growing past the inline capacity falls back to the heap
+    v.reserve(8);
+    EXPECT_NE(v.data(), inlineData);
+    EXPECT_EQ(v.capacity(), 8);
+    v.push_back(5);
+    EXPECT_EQ(v.size(), 5);
+    for (int i = 0; i < 5; i++) {
+        EXPECT_EQ(v[i], i + 1);
+    }
+}
+
+TEST(SmallVectorTest, SwapAndMove) {
+    SmallVector<std::string, 4> a;
+    a.push_back("Hello");
+    a.push_back("World");
+
+    // inline <-> inline
+    SmallVector<std::string, 4> b;
+    b.push_back("!");
+    a.swap(b);
+    EXPECT_EQ(a.size(), 1);
+    EXPECT_EQ(a[0], "!");
+    EXPECT_EQ(b.size(), 2);
+    EXPECT_EQ(b[0], "Hello");
+    EXPECT_EQ(b[1], "World");
+
+    // inline <-> heap
+    SmallVector<std::string, 4> c;
+    c.reserve(16);
+    c.push_back("Bonjour");
+    c.swap(b);
+    EXPECT_EQ(c.size(), 2);
+    EXPECT_EQ(c[1], "World");
+    EXPECT_EQ(b.size(), 1);
+    EXPECT_EQ(b[0], "Bonjour");
+
+    // moved-from elements end up in the new vector's own storage
+    SmallVector<std::string, 4> d(std::move(c));
+    EXPECT_EQ(d.size(), 2);
+    EXPECT_EQ(d[0], "Hello");
+    EXPECT_EQ(d[1], "World");
+}
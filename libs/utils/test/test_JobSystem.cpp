@@ -342,5 +342,88 @@ TEST(JobSystem, JobSystemDelegates) {
     EXPECT_EQ(4, functor.result);
 
 
+    js.emancipate();
+}
+
+TEST(JobSystem, JobSystemRunAfter) {
+    JobSystem js;
+    js.adopt();
+
+    std::atomic_int stamp = {0};
+    int a = 0, b = 0, c = 0;
+
+    JobSystem::Job* jobA = jobs::createJob(js, nullptr, [&] { a = ++stamp; });
+    JobSystem::Job* jobB = jobs::createJob(js, nullptr, [&] { b = ++stamp; });
+    JobSystem::Job* jobC = jobs::createJob(js, nullptr, [&] { c = ++stamp; });
+
+    js.runAfter(jobA, jobB);
+    js.runAfter(jobB, jobC);
+
+    JobSystem::Job* retained = js.retain(jobC);
+    js.run(jobA);
+    js.waitAndRelease(retained);
+
+    EXPECT_EQ(1, a);
+    EXPECT_EQ(2, b);
+    EXPECT_EQ(3, c);
+
+    js.emancipate();
+}
+
+TEST(JobSystem, JobSystemRunAfterFanInFanOut) {
+    JobSystem js;
+    js.adopt();
+
+    std::atomic_int produced = {0};
+    std::atomic_int observedByJoin = {-1};
+
+    JobSystem::Job* source = jobs::createJob(js, nullptr, [&] { produced++; });
+    JobSystem::Job* left   = jobs::createJob(js, nullptr, [&] { produced++; });
+    JobSystem::Job* right  = jobs::createJob(js, nullptr, [&] { produced++; });
+    JobSystem::Job* join   = jobs::createJob(js, nullptr, [&] {
+        observedByJoin = produced.load();
+    });
+
+    js.runAfter(source, left);
+    js.runAfter(source, right);
+    js.runAfter(left, join);
+    js.runAfter(right, join);
+
+    JobSystem::Job* retained = js.retain(join);
+    js.run(source);
+    js.waitAndRelease(retained);
+
+    EXPECT_EQ(3, observedByJoin.load());
+
+    js.emancipate();
+}
+
+TEST(JobSystem, JobSystemRunAfterWaitsForChildren) {
+    JobSystem js;
+    js.adopt();
+
+    std::atomic_int children = {0};
+    int childrenSeen = -1;
+
+    JobSystem::Job* parent = js.createJob(nullptr);
+    for (int i = 0; i < 64; i++) {
+        JobSystem::Job* child = jobs::createJob(js, parent, [&children] {
+            std::this_thread::yield();
+            children++;
+        });
+        js.run(child);
+    }
+
+    JobSystem::Job* successor = jobs::createJob(js, nullptr, [&] {
+        childrenSeen = children.load();
+    });
+    js.runAfter(parent, successor);
+
+    JobSystem::Job* retained = js.retain(successor);
+    js.run(parent);
+    js.waitAndRelease(retained);
+
+    EXPECT_EQ(64, childrenSeen);
+
     js.emancipate();
 }
@@ -173,3 +173,63 @@ TEST(StructureOfArraysTest, Simple) {
     soa.push_back(0.0f, 1.0, std::move(destroyedFloat4));
 }
 
+TEST(StructureOfArraysTest, DeclaredAlignment) {
+    StructureOfArrays<uint8_t, Aligned<float4, 64>, Aligned<float, 32>> soa;
+
+    // use an odd capacity so the padding between arrays is exercised
+    soa.setCapacity(13);
+    soa.resize(13);
+
+    // arrays with a declared alignment must honor it...
+    EXPECT_EQ(0, uintptr_t(soa.data<1>()) % 64);
+    EXPECT_EQ(0, uintptr_t(soa.data<2>()) % 32);
+    // ... and the others still get at least the alignment guaranteed by malloc
+    EXPECT_EQ(0, uintptr_t(soa.data<0>()) % alignof(std::max_align_t));
+
+    // check that the declared alignment survives a reallocation, and that the
+    // content is moved correctly
+    for (size_t i = 0; i < 13; i++) {
+        soa.elementAt<0>(i) = uint8_t(i);
+        soa.elementAt<1>(i) = float4{ float(i) };
+        soa.elementAt<2>(i) = float(i) * 2;
+    }
+    soa.setCapacity(31);
+    EXPECT_EQ(0, uintptr_t(soa.data<1>()) % 64);
+    EXPECT_EQ(0, uintptr_t(soa.data<2>()) % 32);
+    for (size_t i = 0; i < 13; i++) {
+        EXPECT_EQ(uint8_t(i), soa.elementAt<0>(i));
+        EXPECT_EQ(float4{ float(i) }, soa.elementAt<1>(i));
+        EXPECT_EQ(float(i) * 2, soa.elementAt<2>(i));
+    }
+
+    // the element type is the wrapped type
+    soa.push_back(uint8_t(42), float4{ 1, 2, 3, 4 }, 7.0f);
+    EXPECT_EQ(14, soa.size());
+    EXPECT_EQ((float4{ 1, 2, 3, 4 }), soa.elementAt<1>(13));
+}
+
+TEST(StructureOfArraysTest, ForEachZip) {
+    StructureOfArrays<float, double, TestFloat4> soa;
+    soa.resize(100);
+
+    for (size_t i = 0; i < 100; i++) {
+        soa.elementAt<0>(i) = float(i);
+    }
+
+    // write through a zipped traversal (larger than the prefetch distance)
+    soa.forEachZip<0, 1>([](size_t i, float const& f, double& d) {
+        d = f * 2 + double(i);
+    });
+    for (size_t i = 0; i < 100; i++) {
+        EXPECT_EQ(double(i) * 3, soa.elementAt<1>(i));
+    }
+
+    // const traversal
+    StructureOfArrays<float, double, TestFloat4> const& csoa = soa;
+    double sum = 0;
+    csoa.forEachZip<1>([&sum](size_t, double const& d) {
+        sum += d;
+    });
+    EXPECT_EQ(3 * 99 * 100 / 2, sum);
+}
+
@@ -19,6 +19,9 @@
 
 #include <viewer/AutomationSpec.h>
 
+#include <string>
+#include <vector>
+
 namespace filament {
 
 class ColorGrading;
@@ -45,6 +48,10 @@ namespace viewer {
  * The time to sleep between tests is configurable and can be set to zero. Automation also waits a
  * specified minimum number of frames between tests.
  *
+ * In benchmark mode (see Options::benchmark), automation instead holds each permutation for a
+ * fixed number of warmup and measurement frames, collects frame times and per-pass GPU timings,
+ * and can export the aggregated results as CSV or JSON after the last test.
+ *
  * Batch mode is meant for non-interactive applications. In batch mode, automation defers applying
  * the first test case until the client unblocks it via signalBatchMode(). This is useful when
  * waiting for a large model file to become fully loaded. Batch mode also offers a query
@@ -82,6 +89,38 @@ public:
          * If true, the tick function writes out a settings JSON file before advancing.
          */
         bool exportSettings = false;
+
+        /**
+         * If true, automation runs as a benchmark rather than a screenshot test: each
+         * permutation is held for a fixed number of warmup and measurement frames, frame
+         * times and per-pass GPU timings are collected, and a report can be exported after
+         * the last test. The sleepDuration and minFrameCount fields are ignored.
+         */
+        bool benchmark = false;
+
+        /**
+         * Number of frames discarded after applying each permutation, giving shader
+         * compilation and dynamic resolution a chance to settle before measuring.
+         */
+        int benchmarkWarmupFrames = 30;
+
+        /**
+         * Number of frame-time samples collected per permutation after warmup. The GPU
+         * pass timings aggregate the renderer's trailing sample history, so the sum of
+         * warmup and measurement frames should not be lowered below that history size
+         * (64 frames) or GPU stats will bleed across permutations.
+         */
+        int benchmarkFrameCount = 60;
+
+        /**
+         * If true, the benchmark report is written to "benchmark.csv" after the last test.
+         */
+        bool exportBenchmarkCSV = true;
+
+        /**
+         * If true, the benchmark report is written to "benchmark.json" after the last test.
+         */
+        bool exportBenchmarkJSON = false;
     };
 
     /**
@@ -100,6 +139,22 @@ public:
         size_t assetLightCount;
     };
 
+    /**
+     * Aggregated timings for a single settings permutation, collected in benchmark mode.
+     * All times are in milliseconds.
+     */
+    struct BenchmarkResult {
+        struct Series {
+            std::string name;   //!< "frame" for the host frame time, otherwise the GPU pass name
+            uint32_t samples;   //!< number of frames aggregated in the values below
+            float median;
+            float p95;
+            float max;
+        };
+        std::string name;              //!< test name and index, matches the screenshot prefix
+        std::vector<Series> series;    //!< host frame time first, then one entry per GPU pass
+    };
+
     /**
      * Creates an automation engine and places it in an idle state.
      *
@@ -200,6 +255,19 @@ public:
      */
     void stopRunning() { mIsRunning = false; }
 
+    /**
+     * Forgets the last-applied settings snapshot so that the next apply pushes everything.
+     *
+     * Settings application diffs against the previously applied values and skips unchanged
+     * setters, some of which trigger expensive rebuilds inside the engine. Call this after
+     * swapping scene content (e.g. loading a new asset), whose fresh Filament objects have
+     * not received the current settings yet.
+     */
+    void invalidateAppliedSettings() {
+        mHasAppliedViewSettings = false;
+        mHasAppliedSceneSettings = false;
+    }
+
     /**
      * Signals that the application is closing, so all pending screenshots should be cancelled.
      */
@@ -224,6 +292,31 @@ public:
      */
     static void exportSettings(const Settings& settings, const char* filename);
 
+    /**
+     * Convenience function that writes benchmark results to a CSV file, one row per
+     * (test, series) pair.
+     *
+     * @param results  Results to serialize, usually obtained from getBenchmarkResults().
+     * @param filename Desired CSV filename.
+     */
+    static void exportBenchmarkCSV(const std::vector<BenchmarkResult>& results,
+            const char* filename);
+
+    /**
+     * Convenience function that writes benchmark results to a JSON file.
+     *
+     * @param results  Results to serialize, usually obtained from getBenchmarkResults().
+     * @param filename Desired JSON filename.
+     */
+    static void exportBenchmarkJSON(const std::vector<BenchmarkResult>& results,
+            const char* filename);
+
+    /**
+     * Returns the benchmark results collected so far. Empty unless Options::benchmark is
+     * set; cleared when a new automation session starts.
+     */
+    const std::vector<BenchmarkResult>& getBenchmarkResults() const { return mBenchmarkResults; }
+
     Options getOptions() const { return mOptions; }
     bool isRunning() const { return mIsRunning; }
     size_t currentTest() const { return mCurrentTest; }
@@ -241,6 +334,19 @@ private:
     ColorGrading* mColorGrading = nullptr;
     ColorGradingSettings mColorGradingSettings = {};
 
+    void collectBenchmarkResult(Renderer* renderer, const std::string& name);
+
+    std::vector<BenchmarkResult> mBenchmarkResults;
+    std::vector<float> mFrameTimeSamples;
+
+    // Snapshot of the settings that were last pushed to Filament, used to skip setters
+    // whose values have not changed. The view/material and lighting/viewer parts are
+    // tracked separately because tick() only applies the former. See
+    // invalidateAppliedSettings().
+    Settings mAppliedSettings;
+    bool mHasAppliedViewSettings = false;
+    bool mHasAppliedSceneSettings = false;
+
     size_t mCurrentTest;
     float mElapsedTime;
     int mElapsedFrames;
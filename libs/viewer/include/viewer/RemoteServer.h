@@ -64,6 +64,15 @@ public:
      */
     char const* peekIncomingLabel() const;
 
+    /**
+     * Returns the progress of the current download as a fraction in [0, 1].
+     *
+     * This is only meaningful for clients that announce the payload size in the label part
+     * of the message (see MessageReceiver). Returns 0 if nothing is being downloaded or if
+     * the client did not announce a size.
+     */
+    float peekIncomingProgress() const;
+
     /**
      * Pops a message off the incoming queue or returns null if there are no unread messages.
      *
@@ -85,12 +94,15 @@ public:
 private:
     void enqueueReceivedMessage(ReceivedMessage* message);
     void setIncomingMessage(ReceivedMessage* message);
+    void updateIncomingProgress(size_t receivedBytes, size_t totalBytes);
     MessageSender* mMessageSender = nullptr;
     MessageReceiver* mMessageReceiver = nullptr;
     size_t mNextMessageUid = 0;
     static const size_t kMessageCapacity = 4;
     ReceivedMessage* mReceivedMessages[kMessageCapacity] = {};
     ReceivedMessage* mIncomingMessage = nullptr;
+    size_t mIncomingBytesReceived = 0;
+    size_t mIncomingBytesTotal = 0;
     JsonSerializer mSerializer;
     mutable std::mutex mReceivedMessagesMutex;
     friend class MessageReceiver;
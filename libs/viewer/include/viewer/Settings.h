@@ -75,12 +75,20 @@ using VsmShadowOptions = filament::View::VsmShadowOptions;
 using LightManager = filament::LightManager;
 
 // These functions push all editable property values to their respective Filament objects.
-void applySettings(const ViewSettings& settings, View* dest);
-void applySettings(const MaterialSettings& settings, MaterialInstance* dest);
+//
+// When "previous" is non-null it is assumed to hold the settings that were last applied to the
+// same objects, and only the mutated setters are invoked. This matters because some setters
+// (shadow options, MSAA, ...) trigger expensive internal rebuilds even when handed unchanged
+// values. Pass null to force-apply everything, e.g. after the target objects have been replaced.
+void applySettings(const ViewSettings& settings, View* dest,
+        const ViewSettings* previous = nullptr);
+void applySettings(const MaterialSettings& settings, MaterialInstance* dest,
+        const MaterialSettings* previous = nullptr);
 void applySettings(const LightSettings& settings, IndirectLight* ibl, utils::Entity sunlight,
-        utils::Entity* sceneLights, size_t sceneLightCount, LightManager* lm, Scene* scene, View* view);
+        utils::Entity* sceneLights, size_t sceneLightCount, LightManager* lm, Scene* scene, View* view,
+        const LightSettings* previous = nullptr);
 void applySettings(const ViewerOptions& settings, Camera* camera, Skybox* skybox,
-        Renderer* renderer);
+        Renderer* renderer, const ViewerOptions* previous = nullptr);
 
 // Creates a new ColorGrading object based on the given settings.
 UTILS_PUBLIC
@@ -198,6 +206,8 @@ struct LightSettings {
     math::float3 sunlightColor = filament::Color::toLinear<filament::ACCURATE>({ 0.98, 0.92, 0.89});
     float iblIntensity = 30000.0f;
     float iblRotation = 0.0f;
+    bool operator!=(const LightSettings &rhs) const { return !(rhs == *this); }
+    bool operator==(const LightSettings &rhs) const;
 };
 
 struct ViewerOptions {
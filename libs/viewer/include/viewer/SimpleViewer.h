@@ -241,6 +241,12 @@ private:
     bool mEnableWireframe = false;
     int mVsmMsaaSamplesLog2 = 1;
     Settings mSettings;
+
+    // Settings that were last pushed to Filament, used to skip unchanged setters. The
+    // snapshot is dropped when a new asset is populated so its objects get everything.
+    ViewSettings mAppliedView;
+    LightSettings mAppliedLighting;
+    bool mHasAppliedSettings = false;
     int mSidebarWidth;
     uint32_t mFlags;
     utils::Entity mCurrentMorphingEntity;
@@ -26,6 +26,7 @@
 #include <utils/Log.h>
 #include <utils/Path.h>
 
+#include <algorithm>
 #include <iomanip>
 #include <fstream>
 #include <sstream>
@@ -154,6 +155,88 @@ void AutomationEngine::exportSettings(const Settings& settings, const char* file
     gStatus = "Exported to '" + std::string(filename) + "' in the current folder.";
 }
 
+// Sorts the samples in place and reduces them to the same set of statistics that
+// Renderer::PassTiming reports, so frame times and GPU pass times read the same way.
+static AutomationEngine::BenchmarkResult::Series summarize(std::string name,
+        std::vector<float>& samples) {
+    std::sort(samples.begin(), samples.end());
+    const size_t n = samples.size();
+    if (n == 0) {
+        return { std::move(name), 0, 0.0f, 0.0f, 0.0f };
+    }
+    return {
+        std::move(name),
+        (uint32_t) n,
+        samples[n / 2],
+        samples[std::min(n - 1, (n * 95) / 100)],
+        samples[n - 1],
+    };
+}
+
+void AutomationEngine::collectBenchmarkResult(Renderer* renderer, const std::string& name) {
+    BenchmarkResult result;
+    result.name = name;
+    result.series.push_back(summarize("frame", mFrameTimeSamples));
+    mFrameTimeSamples.clear();
+
+    // The GPU stats aggregate the renderer's trailing sample history; with the default
+    // warmup and measurement frame counts, the history only spans the current test.
+    Renderer::PassTiming timings[32];
+    const size_t count = renderer->getPassTimings(timings, 32);
+    for (size_t i = 0; i < count; i++) {
+        const Renderer::PassTiming& pass = timings[i];
+        result.series.push_back({ pass.name, pass.samples, pass.median, pass.p95, pass.max });
+    }
+
+    if (mOptions.verbose) {
+        const auto& frame = result.series[0];
+        slog.i << "Benchmarked " << name.c_str() << ": median frame time "
+                << frame.median << " ms (p95 " << frame.p95 << " ms)" << io::endl;
+    }
+    mBenchmarkResults.push_back(std::move(result));
+}
+
+void AutomationEngine::exportBenchmarkCSV(const std::vector<BenchmarkResult>& results,
+        const char* filename) {
+    std::ofstream out(filename);
+    if (!out) {
+        gStatus = "Failed to export benchmark file.";
+        return;
+    }
+    out << "test,series,samples,median_ms,p95_ms,max_ms\n";
+    for (const auto& result : results) {
+        for (const auto& series : result.series) {
+            out << result.name << "," << series.name << "," << series.samples << ","
+                    << series.median << "," << series.p95 << "," << series.max << "\n";
+        }
+    }
+    gStatus = "Exported to '" + std::string(filename) + "' in the current folder.";
+}
+
+void AutomationEngine::exportBenchmarkJSON(const std::vector<BenchmarkResult>& results,
+        const char* filename) {
+    std::ofstream out(filename);
+    if (!out) {
+        gStatus = "Failed to export benchmark file.";
+        return;
+    }
+    out << "[\n";
+    for (size_t t = 0; t < results.size(); t++) {
+        const auto& result = results[t];
+        out << "  {\n    \"test\": \"" << result.name << "\",\n    \"series\": [\n";
+        for (size_t s = 0; s < result.series.size(); s++) {
+            const auto& series = result.series[s];
+            out << "      { \"name\": \"" << series.name << "\", \"samples\": " << series.samples
+                    << ", \"median\": " << series.median << ", \"p95\": " << series.p95
+                    << ", \"max\": " << series.max << " }"
+                    << (s + 1 < result.series.size() ? "," : "") << "\n";
+        }
+        out << "    ]\n  }" << (t + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "]\n";
+    gStatus = "Exported to '" + std::string(filename) + "' in the current folder.";
+}
+
 void AutomationEngine::applySettings(const char* json, size_t jsonLength,
         const ViewerContent& content) {
     JsonSerializer serializer;
@@ -162,15 +245,22 @@ void AutomationEngine::applySettings(const char* json, size_t jsonLength,
         slog.e << "Badly formed JSON:\n" << jsonWithTerminator.c_str() << io::endl;
         return;
     }
-    viewer::applySettings(mSettings->view, content.view);
+    viewer::applySettings(mSettings->view, content.view,
+            mHasAppliedViewSettings ? &mAppliedSettings.view : nullptr);
     for (size_t i = 0; i < content.materialCount; i++) {
-        viewer::applySettings(mSettings->material, content.materials[i]);
+        viewer::applySettings(mSettings->material, content.materials[i],
+                mHasAppliedViewSettings ? &mAppliedSettings.material : nullptr);
     }
     viewer::applySettings(mSettings->lighting, content.indirectLight, content.sunlight,
-            content.assetLights, content.assetLightCount, content.lightManager, content.scene, content.view);
+            content.assetLights, content.assetLightCount, content.lightManager, content.scene,
+            content.view, mHasAppliedSceneSettings ? &mAppliedSettings.lighting : nullptr);
     Camera* camera = &content.view->getCamera();
     Skybox* skybox = content.scene->getSkybox();
-    viewer::applySettings(mSettings->viewer, camera, skybox, content.renderer);
+    viewer::applySettings(mSettings->viewer, camera, skybox, content.renderer,
+            mHasAppliedSceneSettings ? &mAppliedSettings.viewer : nullptr);
+    mAppliedSettings = *mSettings;
+    mHasAppliedViewSettings = true;
+    mHasAppliedSceneSettings = true;
 }
 
 ColorGrading* AutomationEngine::getColorGrading(Engine* engine) {
@@ -202,10 +292,15 @@ void AutomationEngine::tick(const ViewerContent& content, float deltaTime) {
         mElapsedTime = 0;
         mElapsedFrames = 0;
         mSpec->get(mCurrentTest, mSettings);
-        viewer::applySettings(mSettings->view, content.view);
+        viewer::applySettings(mSettings->view, content.view,
+                mHasAppliedViewSettings ? &mAppliedSettings.view : nullptr);
         for (size_t i = 0; i < content.materialCount; i++) {
-            viewer::applySettings(mSettings->material, content.materials[i]);
+            viewer::applySettings(mSettings->material, content.materials[i],
+                    mHasAppliedViewSettings ? &mAppliedSettings.material : nullptr);
         }
+        mAppliedSettings.view = mSettings->view;
+        mAppliedSettings.material = mSettings->material;
+        mHasAppliedViewSettings = true;
         if (mOptions.verbose) {
             utils::slog.i << "Running test " << mCurrentTest << utils::io::endl;
         }
@@ -217,6 +312,11 @@ void AutomationEngine::tick(const ViewerContent& content, float deltaTime) {
                 mIsRunning = true;
                 mRequestStart = false;
                 mCurrentTest = 0;
+                mBenchmarkResults.clear();
+                mFrameTimeSamples.clear();
+                if (mOptions.benchmark) {
+                    content.renderer->setPassProfilingEnabled(true);
+                }
                 activateTest();
             }
         }
@@ -226,7 +326,17 @@ void AutomationEngine::tick(const ViewerContent& content, float deltaTime) {
     mElapsedTime += deltaTime;
     mElapsedFrames++;
 
-    if (mElapsedTime < mOptions.sleepDuration || mElapsedFrames < mOptions.minFrameCount) {
+    if (mOptions.benchmark) {
+        // The first frames after a settings change are discarded: they include shader
+        // compilation and are not representative of steady state.
+        if (mElapsedFrames <= mOptions.benchmarkWarmupFrames) {
+            return;
+        }
+        mFrameTimeSamples.push_back(deltaTime * 1000.0f);
+        if (mFrameTimeSamples.size() < (size_t) mOptions.benchmarkFrameCount) {
+            return;
+        }
+    } else if (mElapsedTime < mOptions.sleepDuration || mElapsedFrames < mOptions.minFrameCount) {
         return;
     }
 
@@ -238,6 +348,10 @@ void AutomationEngine::tick(const ViewerContent& content, float deltaTime) {
             << std::setfill('0') << std::setw(digits) << mCurrentTest;
     std::string prefix = stringStream.str();
 
+    if (mOptions.benchmark) {
+        collectBenchmarkResult(content.renderer, prefix);
+    }
+
     if (mOptions.exportSettings) {
         std::string filename = prefix + ".json";
         exportSettings(*mSettings, filename.c_str());
@@ -249,6 +363,15 @@ void AutomationEngine::tick(const ViewerContent& content, float deltaTime) {
 
     if (isLastTest) {
         mIsRunning = false;
+        if (mOptions.benchmark) {
+            content.renderer->setPassProfilingEnabled(false);
+            if (mOptions.exportBenchmarkCSV) {
+                exportBenchmarkCSV(mBenchmarkResults, "benchmark.csv");
+            }
+            if (mOptions.exportBenchmarkJSON) {
+                exportBenchmarkJSON(mBenchmarkResults, "benchmark.json");
+            }
+        }
         if (mBatchModeEnabled && !mOptions.exportScreenshots) {
             mShouldClose = true;
         }
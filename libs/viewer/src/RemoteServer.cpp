@@ -20,6 +20,10 @@
 
 #include <utils/Log.h>
 
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
 #include <vector>
 
@@ -34,15 +38,34 @@ public:
     void sendMessage(const char* label, const char* buffer, size_t bufsize);
 };
 
+// Receives two-part messages from the web client. Part 1 is the label, optionally followed by
+// a NUL separator and the decimal count of uncompressed payload bytes. Part 2 is the payload,
+// either raw or a zlib stream (detected from its header).
+//
+// When the size is announced, the payload is written straight into its final buffer as frames
+// arrive, instead of being accumulated and copied at the end; this halves the peak memory
+// needed to receive a large model. Compressed payloads are inflated incrementally on the
+// CivetWeb thread, overlapping decompression with the network transfer.
 class MessageReceiver : public CivetWebSocketHandler {
    public:
     MessageReceiver(RemoteServer* server) : mServer(server) {}
-    ~MessageReceiver() { delete mReceivedMessage; }
+    ~MessageReceiver() { releaseInflator(); delete mReceivedMessage; }
     bool handleData(CivetServer* server, struct mg_connection*, int, char* , size_t) override;
    private:
+    void beginPayload(const char* data, size_t size);
+    bool appendToPayload(const char* data, size_t size);
+    bool growPayloadBuffer(size_t needed);
+    void releaseInflator();
+    void discardMessage();
     RemoteServer* mServer;
     std::vector<char> mChunk;
     ReceivedMessage* mReceivedMessage = nullptr;
+    z_stream mInflator = {};
+    bool mInflating = false;
+    bool mPayloadStarted = false;
+    size_t mAnnouncedByteCount = 0;
+    size_t mPayloadCapacity = 0;
+    size_t mPayloadWritten = 0;
 };
 
 RemoteServer::RemoteServer(int port) {
@@ -80,6 +103,20 @@ char const * RemoteServer::peekIncomingLabel() const {
     return mIncomingMessage ? mIncomingMessage->label : nullptr;
 }
 
+float RemoteServer::peekIncomingProgress() const {
+    std::lock_guard lock(mReceivedMessagesMutex);
+    if (!mIncomingMessage || mIncomingBytesTotal == 0) {
+        return 0.0f;
+    }
+    return float(mIncomingBytesReceived) / float(mIncomingBytesTotal);
+}
+
+void RemoteServer::updateIncomingProgress(size_t receivedBytes, size_t totalBytes) {
+    std::lock_guard lock(mReceivedMessagesMutex);
+    mIncomingBytesReceived = receivedBytes;
+    mIncomingBytesTotal = totalBytes;
+}
+
 ReceivedMessage const * RemoteServer::peekReceivedMessage() const {
     std::lock_guard lock(mReceivedMessagesMutex);
 
@@ -117,6 +154,8 @@ ReceivedMessage const * RemoteServer::acquireReceivedMessage() {
 void RemoteServer::setIncomingMessage(ReceivedMessage* message) {
     std::lock_guard lock(mReceivedMessagesMutex);
     mIncomingMessage = message;
+    mIncomingBytesReceived = 0;
+    mIncomingBytesTotal = 0;
 }
 
 void RemoteServer::enqueueReceivedMessage(ReceivedMessage* message) {
@@ -166,6 +205,91 @@ void RemoteServer::sendMessage(const char* label, const char* buffer, size_t buf
     mMessageSender->sendMessage(label, buffer, bufsize);
 }
 
+void MessageReceiver::beginPayload(const char* data, size_t size) {
+    mPayloadStarted = true;
+    mPayloadWritten = 0;
+
+    // A zlib stream is detected from its 2-byte header: the deflate method in the low
+    // nibble of the first byte, and a header checksum that is a multiple of 31.
+    mInflating = size >= 2 && (data[0] & 0x0f) == Z_DEFLATED &&
+            (((uint32_t(uint8_t(data[0])) << 8) | uint8_t(data[1])) % 31) == 0;
+    if (mInflating) {
+        mInflator = {};
+        inflateInit(&mInflator);
+    }
+
+    mPayloadCapacity = mAnnouncedByteCount;
+    if (mPayloadCapacity == 0) {
+        // The client did not announce a size; start with a guess and grow as needed.
+        mPayloadCapacity = mInflating ? std::max(size_t(1) << 20, size * 4) : size;
+    }
+    mReceivedMessage->buffer = new char[mPayloadCapacity];
+}
+
+bool MessageReceiver::growPayloadBuffer(size_t needed) {
+    if (needed <= mPayloadCapacity) {
+        return true;
+    }
+    const size_t capacity = std::max(mPayloadCapacity * 2, needed);
+    char* grown = new char[capacity];
+    memcpy(grown, mReceivedMessage->buffer, mPayloadWritten);
+    delete[] mReceivedMessage->buffer;
+    mReceivedMessage->buffer = grown;
+    mPayloadCapacity = capacity;
+    return true;
+}
+
+bool MessageReceiver::appendToPayload(const char* data, size_t size) {
+    if (!mInflating) {
+        if (!growPayloadBuffer(mPayloadWritten + size)) {
+            return false;
+        }
+        memcpy(mReceivedMessage->buffer + mPayloadWritten, data, size);
+        mPayloadWritten += size;
+        return true;
+    }
+
+    // Inflate this frame into the destination buffer. Decompression happens here, on the
+    // CivetWeb thread, so it overlaps with the network transfer of subsequent frames.
+    mInflator.next_in = (Bytef*) data;
+    mInflator.avail_in = (uInt) size;
+    while (mInflator.avail_in) {
+        if (mPayloadWritten == mPayloadCapacity && !growPayloadBuffer(mPayloadCapacity + 1)) {
+            return false;
+        }
+        mInflator.next_out = (Bytef*) (mReceivedMessage->buffer + mPayloadWritten);
+        mInflator.avail_out = (uInt) (mPayloadCapacity - mPayloadWritten);
+        const int status = inflate(&mInflator, Z_NO_FLUSH);
+        mPayloadWritten = mPayloadCapacity - mInflator.avail_out;
+        if (status == Z_STREAM_END) {
+            return true;
+        }
+        if (status != Z_OK) {
+            slog.e << "Error inflating received message (status = " << status << ")." << io::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void MessageReceiver::releaseInflator() {
+    if (mInflating) {
+        inflateEnd(&mInflator);
+        mInflating = false;
+    }
+}
+
+void MessageReceiver::discardMessage() {
+    releaseInflator();
+    mServer->setIncomingMessage(nullptr);
+    mServer->releaseReceivedMessage(mReceivedMessage);
+    mReceivedMessage = nullptr;
+    mPayloadStarted = false;
+    mAnnouncedByteCount = 0;
+    mPayloadCapacity = 0;
+    mPayloadWritten = 0;
+}
+
 // NOTE: This is invoked off the main thread.
 bool MessageReceiver::handleData(CivetServer* server, struct mg_connection* conn, int bits,
                                   char* data, size_t size) {
@@ -175,34 +299,49 @@ bool MessageReceiver::handleData(CivetServer* server, struct mg_connection* conn
         return true;
     }
 
-    // Append this frame to the aggregated chunk.
-    mChunk.insert(mChunk.end(), data, data + size);
-
-    // If this message part still has outstanding frames, return early.
-    if (!final) {
-        return true;
-    }
-
-    // Part 1 of the message is the label.
+    // Part 1 of the message is the label, optionally followed by a NUL separator and the
+    // decimal count of uncompressed payload bytes. Announcing the size lets the payload be
+    // written straight into its final buffer and makes download progress queryable.
     if (mReceivedMessage == nullptr) {
+        mChunk.insert(mChunk.end(), data, data + size);
+        if (!final) {
+            return true;
+        }
         mReceivedMessage = new ReceivedMessage({});
         mReceivedMessage->label = new char[mChunk.size() + 1]{};
         memcpy(mReceivedMessage->label, mChunk.data(), mChunk.size());
+        const size_t labelLength = strlen(mReceivedMessage->label);
+        mAnnouncedByteCount = (labelLength + 1 < mChunk.size())
+                ? strtoull(mReceivedMessage->label + labelLength + 1, nullptr, 10) : 0;
         mServer->setIncomingMessage(mReceivedMessage);
         mChunk.clear();
         return true;
     }
 
-    // Part 2 of the message is the buffer.
-    auto message = mReceivedMessage;
-    message->bufferByteCount = mChunk.size();
-    message->buffer = new char[message->bufferByteCount];
-    memcpy(message->buffer, mChunk.data(), message->bufferByteCount);
-    mChunk.clear();
+    // Part 2 of the message is the payload; each frame is consumed as it arrives.
+    if (!mPayloadStarted) {
+        beginPayload(data, size);
+    }
+    if (!appendToPayload(data, size)) {
+        // The payload is corrupt; drop the message and close the connection so the client
+        // can start over.
+        discardMessage();
+        return false;
+    }
+    mServer->updateIncomingProgress(mPayloadWritten, mAnnouncedByteCount);
+    if (!final) {
+        return true;
+    }
 
     // We have all parts, so go ahead and enqueue the incoming message.
+    releaseInflator();
+    mReceivedMessage->bufferByteCount = mPayloadWritten;
     mServer->enqueueReceivedMessage(mReceivedMessage);
     mReceivedMessage = nullptr;
+    mPayloadStarted = false;
+    mAnnouncedByteCount = 0;
+    mPayloadCapacity = 0;
+    mPayloadWritten = 0;
     return true;
 }
 
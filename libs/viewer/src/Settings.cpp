@@ -28,6 +28,7 @@
 
 #include <sstream>
 #include <string>
+#include <type_traits>
 
 #include <assert.h>
 #include <string.h>
@@ -1034,66 +1035,136 @@ int parse(jsmntok_t const* tokens, int i, const char* jsonChunk, Settings* out)
     return i;
 }
 
-void applySettings(const ViewSettings& settings, View* dest) {
-    dest->setAntiAliasing(settings.antiAliasing);
-    dest->setTemporalAntiAliasingOptions(settings.taa);
-    dest->setMultiSampleAntiAliasingOptions(settings.msaa);
-    dest->setDynamicResolutionOptions(settings.dsr);
-    dest->setAmbientOcclusionOptions(settings.ssao);
-    dest->setScreenSpaceReflectionsOptions(settings.screenSpaceReflections);
-    dest->setBloomOptions(settings.bloom);
-    dest->setFogOptions(settings.fog);
-    dest->setDepthOfFieldOptions(settings.dof);
-    dest->setVignetteOptions(settings.vignette);
-    dest->setDithering(settings.dithering);
-    dest->setRenderQuality(settings.renderQuality);
-    dest->setDynamicLightingOptions(settings.dynamicLighting.zLightNear,
-            settings.dynamicLighting.zLightFar);
-    dest->setShadowType(settings.shadowType);
-    dest->setVsmShadowOptions(settings.vsmShadowOptions);
-    dest->setPostProcessingEnabled(settings.postProcessingEnabled);
+// Compares option structs that do not provide operator==. Padding bytes can make two logically
+// equal values compare as different, which merely costs a redundant setter call; an actual
+// change is never missed.
+template <typename T>
+static bool isDifferent(const T& lhs, const T& rhs) {
+    static_assert(std::is_trivially_copyable<T>::value, "isDifferent requires a POD-like type");
+    return memcmp(&lhs, &rhs, sizeof(T)) != 0;
+}
+
+void applySettings(const ViewSettings& settings, View* dest, const ViewSettings* previous) {
+    const bool force = previous == nullptr;
+    if (force || settings.antiAliasing != previous->antiAliasing) {
+        dest->setAntiAliasing(settings.antiAliasing);
+    }
+    if (force || isDifferent(settings.taa, previous->taa)) {
+        dest->setTemporalAntiAliasingOptions(settings.taa);
+    }
+    if (force || isDifferent(settings.msaa, previous->msaa)) {
+        dest->setMultiSampleAntiAliasingOptions(settings.msaa);
+    }
+    if (force || isDifferent(settings.dsr, previous->dsr)) {
+        dest->setDynamicResolutionOptions(settings.dsr);
+    }
+    if (force || isDifferent(settings.ssao, previous->ssao)) {
+        dest->setAmbientOcclusionOptions(settings.ssao);
+    }
+    if (force || isDifferent(settings.screenSpaceReflections, previous->screenSpaceReflections)) {
+        dest->setScreenSpaceReflectionsOptions(settings.screenSpaceReflections);
+    }
+    if (force || isDifferent(settings.bloom, previous->bloom)) {
+        dest->setBloomOptions(settings.bloom);
+    }
+    if (force || isDifferent(settings.fog, previous->fog)) {
+        dest->setFogOptions(settings.fog);
+    }
+    if (force || isDifferent(settings.dof, previous->dof)) {
+        dest->setDepthOfFieldOptions(settings.dof);
+    }
+    if (force || isDifferent(settings.vignette, previous->vignette)) {
+        dest->setVignetteOptions(settings.vignette);
+    }
+    if (force || settings.dithering != previous->dithering) {
+        dest->setDithering(settings.dithering);
+    }
+    if (force || isDifferent(settings.renderQuality, previous->renderQuality)) {
+        dest->setRenderQuality(settings.renderQuality);
+    }
+    if (force || isDifferent(settings.dynamicLighting, previous->dynamicLighting)) {
+        dest->setDynamicLightingOptions(settings.dynamicLighting.zLightNear,
+                settings.dynamicLighting.zLightFar);
+    }
+    if (force || settings.shadowType != previous->shadowType) {
+        dest->setShadowType(settings.shadowType);
+    }
+    if (force || isDifferent(settings.vsmShadowOptions, previous->vsmShadowOptions)) {
+        dest->setVsmShadowOptions(settings.vsmShadowOptions);
+    }
+    if (force || settings.postProcessingEnabled != previous->postProcessingEnabled) {
+        dest->setPostProcessingEnabled(settings.postProcessingEnabled);
+    }
 }
 
 template <typename T>
-static void apply(MaterialProperty<T> prop, MaterialInstance* dest) {
-    if (!prop.name.empty()) {
+static void apply(const MaterialProperty<T>& prop, MaterialInstance* dest,
+        const MaterialProperty<T>* previous) {
+    if (!prop.name.empty() &&
+            (!previous || previous->name != prop.name || previous->value != prop.value)) {
         dest->setParameter(prop.name.c_str(), prop.value);
     }
 }
 
-void applySettings(const MaterialSettings& settings, MaterialInstance* dest) {
-    for (const auto& prop : settings.scalar) { apply(prop, dest); }
-    for (const auto& prop : settings.float3) { apply(prop, dest); }
-    for (const auto& prop : settings.float4) { apply(prop, dest); }
+void applySettings(const MaterialSettings& settings, MaterialInstance* dest,
+        const MaterialSettings* previous) {
+    for (size_t i = 0; i < MaterialSettings::MAX_COUNT; i++) {
+        apply(settings.scalar[i], dest, previous ? &previous->scalar[i] : nullptr);
+        apply(settings.float3[i], dest, previous ? &previous->float3[i] : nullptr);
+        apply(settings.float4[i], dest, previous ? &previous->float4[i] : nullptr);
+    }
 }
 
 void applySettings(const LightSettings& settings, IndirectLight* ibl, utils::Entity sunlight,
-        utils::Entity* sceneLights, size_t sceneLightCount, LightManager* lm, Scene* scene, View* view) {
+        utils::Entity* sceneLights, size_t sceneLightCount, LightManager* lm, Scene* scene, View* view,
+        const LightSettings* previous) {
+    const bool force = previous == nullptr;
     auto light = lm->getInstance(sunlight);
     if (light) {
-        if (settings.enableSunlight) {
-            scene->addEntity(sunlight);
-        } else {
-            scene->remove(sunlight);
+        if (force || settings.enableSunlight != previous->enableSunlight) {
+            if (settings.enableSunlight) {
+                scene->addEntity(sunlight);
+            } else {
+                scene->remove(sunlight);
+            }
+        }
+        if (force || settings.sunlightIntensity != previous->sunlightIntensity) {
+            lm->setIntensity(light, settings.sunlightIntensity);
+        }
+        if (force || settings.sunlightDirection != previous->sunlightDirection) {
+            lm->setDirection(light, normalize(settings.sunlightDirection));
+        }
+        if (force || settings.sunlightColor != previous->sunlightColor) {
+            lm->setColor(light, settings.sunlightColor);
+        }
+        if (force || settings.enableShadows != previous->enableShadows) {
+            lm->setShadowCaster(light, settings.enableShadows);
+        }
+        if (force || isDifferent(settings.shadowOptions, previous->shadowOptions)) {
+            lm->setShadowOptions(light, settings.shadowOptions);
         }
-        lm->setIntensity(light, settings.sunlightIntensity);
-        lm->setDirection(light, normalize(settings.sunlightDirection));
-        lm->setColor(light, settings.sunlightColor);
-        lm->setShadowCaster(light, settings.enableShadows);
-        lm->setShadowOptions(light, settings.shadowOptions);
     }
     if (ibl) {
-        ibl->setIntensity(settings.iblIntensity);
-        ibl->setRotation(math::mat3f::rotation(settings.iblRotation, math::float3 { 0, 1, 0 }));
+        if (force || settings.iblIntensity != previous->iblIntensity) {
+            ibl->setIntensity(settings.iblIntensity);
+        }
+        if (force || settings.iblRotation != previous->iblRotation) {
+            ibl->setRotation(math::mat3f::rotation(settings.iblRotation, math::float3 { 0, 1, 0 }));
+        }
     }
-    for (size_t i = 0; i < sceneLightCount; i++) {
-        light = lm->getInstance(sceneLights[i]);
-        if (lm->isSpotLight(light)) {
-            lm->setShadowCaster(light, settings.enableShadows);
+    if (force || settings.enableShadows != previous->enableShadows ||
+            isDifferent(settings.shadowOptions, previous->shadowOptions)) {
+        for (size_t i = 0; i < sceneLightCount; i++) {
+            light = lm->getInstance(sceneLights[i]);
+            if (lm->isSpotLight(light)) {
+                lm->setShadowCaster(light, settings.enableShadows);
+            }
+            lm->setShadowOptions(light, settings.shadowOptions);
         }
-        lm->setShadowOptions(light, settings.shadowOptions);
     }
-    view->setSoftShadowOptions(settings.softShadowOptions);
+    if (force || isDifferent(settings.softShadowOptions, previous->softShadowOptions)) {
+        view->setSoftShadowOptions(settings.softShadowOptions);
+    }
 }
 
 static LinearColor inverseTonemapSRGB(sRGBColor x) {
@@ -1101,8 +1172,9 @@ static LinearColor inverseTonemapSRGB(sRGBColor x) {
 }
 
 void applySettings(const ViewerOptions& settings, Camera* camera, Skybox* skybox,
-        Renderer* renderer) {
-    if (renderer) {
+        Renderer* renderer, const ViewerOptions* previous) {
+    const bool force = previous == nullptr;
+    if (renderer && (force || settings.backgroundColor != previous->backgroundColor)) {
         // we have to clear because the side-bar doesn't have a background, we cannot use
         // a skybox on the ui scene, because the ui view is always full screen.
         renderer->setClearOptions({
@@ -1110,16 +1182,21 @@ void applySettings(const ViewerOptions& settings, Camera* camera, Skybox* skybox
                 .clear = true
         });
     }
-    if (skybox) {
+    if (skybox && (force || settings.skyboxEnabled != previous->skyboxEnabled)) {
         skybox->setLayerMask(0xff, settings.skyboxEnabled ? 0xff : 0x00);
     }
     if (camera) {
-        camera->setExposure(
-                settings.cameraAperture,
-                1.0f / settings.cameraSpeed,
-                settings.cameraISO);
-
-        camera->setFocusDistance(settings.cameraFocusDistance);
+        if (force || settings.cameraAperture != previous->cameraAperture ||
+                settings.cameraSpeed != previous->cameraSpeed ||
+                settings.cameraISO != previous->cameraISO) {
+            camera->setExposure(
+                    settings.cameraAperture,
+                    1.0f / settings.cameraSpeed,
+                    settings.cameraISO);
+        }
+        if (force || settings.cameraFocusDistance != previous->cameraFocusDistance) {
+            camera->setFocusDistance(settings.cameraFocusDistance);
+        }
     }
 }
 
@@ -1623,6 +1700,18 @@ bool ColorGradingSettings::operator==(const ColorGradingSettings &rhs) const {
             scale == rhs.scale;
 }
 
+bool LightSettings::operator==(const LightSettings &rhs) const {
+    return enableShadows == rhs.enableShadows &&
+            enableSunlight == rhs.enableSunlight &&
+            !isDifferent(shadowOptions, rhs.shadowOptions) &&
+            !isDifferent(softShadowOptions, rhs.softShadowOptions) &&
+            sunlightIntensity == rhs.sunlightIntensity &&
+            sunlightDirection == rhs.sunlightDirection &&
+            sunlightColor == rhs.sunlightColor &&
+            iblIntensity == rhs.iblIntensity &&
+            iblRotation == rhs.iblRotation;
+}
+
 class JsonSerializer::Context {
   public:
     const std::string& writeJson(const Settings& in) {
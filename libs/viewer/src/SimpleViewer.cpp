@@ -407,6 +407,9 @@ void SimpleViewer::populateScene(FilamentAsset* asset,  FilamentInstance* instan
         mAnimator = instanceToAnimate ? instanceToAnimate->getAnimator() : asset->getAnimator();
         updateRootTransform();
         mScene->addEntities(asset->getLightEntities(), asset->getLightEntityCount());
+        // The new asset's lights have not seen the current settings yet, so the next UI
+        // update must push everything.
+        mHasAppliedSettings = false;
     }
 
     auto& tcm = mEngine->getRenderableManager();
@@ -941,26 +944,34 @@ void SimpleViewer::updateUserInterface() {
 
     // At this point, all View settings have been modified,
     //  so we can now push them into the Filament View.
-    applySettings(mSettings.view, mView);
-
-    mView->setSoftShadowOptions(mSettings.lighting.softShadowOptions);
+    applySettings(mSettings.view, mView, mHasAppliedSettings ? &mAppliedView : nullptr);
+
+    // Light setters can trigger expensive rebuilds (e.g. shadow map reallocation), so
+    // they are skipped entirely unless a light setting changed since the last frame.
+    if (!mHasAppliedSettings || mAppliedLighting != light) {
+        mView->setSoftShadowOptions(light.softShadowOptions);
+
+        if (light.enableSunlight) {
+            mScene->addEntity(mSunlight);
+            auto sun = lm.getInstance(mSunlight);
+            lm.setIntensity(sun, light.sunlightIntensity);
+            lm.setDirection(sun, normalize(light.sunlightDirection));
+            lm.setColor(sun, light.sunlightColor);
+            lm.setShadowCaster(sun, light.enableShadows);
+            lm.setShadowOptions(sun, light.shadowOptions);
+        } else {
+            mScene->remove(mSunlight);
+        }
 
-    if (light.enableSunlight) {
-        mScene->addEntity(mSunlight);
-        auto sun = lm.getInstance(mSunlight);
-        lm.setIntensity(sun, light.sunlightIntensity);
-        lm.setDirection(sun, normalize(light.sunlightDirection));
-        lm.setColor(sun, light.sunlightColor);
-        lm.setShadowCaster(sun, light.enableShadows);
-        lm.setShadowOptions(sun, light.shadowOptions);
-    } else {
-        mScene->remove(mSunlight);
+        lm.forEachComponent([this, &lm, &light](utils::Entity e, LightManager::Instance ci) {
+            lm.setShadowOptions(ci, light.shadowOptions);
+            lm.setShadowCaster(ci, light.enableShadows);
+        });
     }
 
-    lm.forEachComponent([this, &lm, &light](utils::Entity e, LightManager::Instance ci) {
-        lm.setShadowOptions(ci, light.shadowOptions);
-        lm.setShadowCaster(ci, light.enableShadows);
-    });
+    mAppliedView = mSettings.view;
+    mAppliedLighting = light;
+    mHasAppliedSettings = true;
 
     if (mAsset != nullptr) {
         if (ImGui::CollapsingHeader("Hierarchy")) {
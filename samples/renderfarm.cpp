@@ -0,0 +1,296 @@
+/*
+ * Copyright (C) 2021 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+//
+// renderfarm: headless multi-Engine batch-rendering benchmark.
+//
+// This sample demonstrates (and measures) running several Engines in a single process, the
+// way a server-side thumbnail farm would, instead of paying process startup for every batch.
+// Each Engine lives entirely on its own thread, with its own backend context, driver thread
+// and headless swap chain; the OS driver arbitrates the GPU between them. There is no window
+// nor windowing dependency -- the only output is the measured throughput (and, with -r, the
+// pixel readbacks a real farm would perform).
+//
+
+#include <filament/Camera.h>
+#include <filament/Engine.h>
+#include <filament/IndexBuffer.h>
+#include <filament/Material.h>
+#include <filament/MaterialInstance.h>
+#include <filament/RenderableManager.h>
+#include <filament/Renderer.h>
+#include <filament/Scene.h>
+#include <filament/Skybox.h>
+#include <filament/SwapChain.h>
+#include <filament/TransformManager.h>
+#include <filament/VertexBuffer.h>
+#include <filament/View.h>
+#include <filament/Viewport.h>
+
+#include <backend/PixelBufferDescriptor.h>
+
+#include <utils/EntityManager.h>
+#include <utils/Path.h>
+
+#include <getopt/getopt.h>
+
+#include <math/mat4.h>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "generated/resources/resources.h"
+
+using namespace filament;
+using namespace filament::math;
+using utils::Entity;
+using utils::EntityManager;
+using utils::Path;
+
+static Engine::Backend g_backend = Engine::Backend::DEFAULT;
+static uint32_t g_engineCount = 2;
+static uint32_t g_renderCount = 1000;
+static uint32_t g_thumbnailSize = 256;
+static bool g_readback = false;
+
+struct Vertex {
+    float2 position;
+    uint32_t color;
+};
+
+static const Vertex TRIANGLE_VERTICES[3] = {
+    {{1, 0}, 0xffff0000u},
+    {{cos(M_PI * 2 / 3), sin(M_PI * 2 / 3)}, 0xff00ff00u},
+    {{cos(M_PI * 4 / 3), sin(M_PI * 4 / 3)}, 0xff0000ffu},
+};
+
+static constexpr uint16_t TRIANGLE_INDICES[3] = { 0, 1, 2 };
+
+static void printUsage(char* name) {
+    std::string exec_name(Path(name).getName());
+    std::string usage(
+            "RENDERFARM measures batch-rendering throughput with several Engines per process\n"
+            "Usage:\n"
+            "    RENDERFARM [options]\n"
+            "\n"
+            "Each engine runs headless on its own thread with its own context and renders\n"
+            "thumbnails from a shared work queue; the total renders/second is reported.\n"
+            "Compare -n 1 with -n 2 or more to evaluate GPU sharing on your driver.\n"
+            "\n"
+            "Options:\n"
+            "   --help, -h\n"
+            "       Prints this message\n\n"
+            "   --api, -a\n"
+            "       Specify the backend API: opengl (default) or vulkan\n\n"
+            "   --engines=[integer > 0], -n [integer > 0]\n"
+            "       Number of Engines sharing the process (default 2)\n\n"
+            "   --count=[integer > 0], -c [integer > 0]\n"
+            "       Total number of thumbnails to render (default 1000)\n\n"
+            "   --size=[pixels], -s [pixels]\n"
+            "       Thumbnail width and height (default 256)\n\n"
+            "   --readback, -r\n"
+            "       Read each thumbnail back to the CPU, like a real farm would\n\n"
+    );
+    const std::string from("RENDERFARM");
+    for (size_t pos = usage.find(from); pos != std::string::npos; pos = usage.find(from, pos)) {
+        usage.replace(pos, from.length(), exec_name);
+    }
+    std::cout << usage;
+}
+
+static int handleCommandLineArgments(int argc, char* argv[]) {
+    static constexpr const char* OPTSTR = "ha:n:c:s:r";
+    static const struct option OPTIONS[] = {
+            { "help",     no_argument,       nullptr, 'h' },
+            { "api",      required_argument, nullptr, 'a' },
+            { "engines",  required_argument, nullptr, 'n' },
+            { "count",    required_argument, nullptr, 'c' },
+            { "size",     required_argument, nullptr, 's' },
+            { "readback", no_argument,       nullptr, 'r' },
+            { nullptr, 0, nullptr, 0 }  // termination of the option list
+    };
+    int opt;
+    int option_index = 0;
+    while ((opt = getopt_long(argc, argv, OPTSTR, OPTIONS, &option_index)) >= 0) {
+        std::string arg(optarg ? optarg : "");
+        switch (opt) {
+            default:
+            case 'h':
+                printUsage(argv[0]);
+                exit(0);
+            case 'a':
+                if (arg == "opengl") {
+                    g_backend = Engine::Backend::OPENGL;
+                } else if (arg == "vulkan") {
+                    g_backend = Engine::Backend::VULKAN;
+                } else {
+                    std::cerr << "Unrecognized backend. Must be 'opengl'|'vulkan'." << std::endl;
+                }
+                break;
+            case 'n':
+                g_engineCount = std::max(1, std::stoi(arg));
+                break;
+            case 'c':
+                g_renderCount = std::max(1, std::stoi(arg));
+                break;
+            case 's':
+                g_thumbnailSize = std::max(16, std::stoi(arg));
+                break;
+            case 'r':
+                g_readback = true;
+                break;
+        }
+    }
+    return optind;
+}
+
+// number of thumbnails not yet claimed by a worker; shared work queue
+static std::atomic<int32_t> g_remaining;
+
+// Renders thumbnails on a dedicated Engine until the shared queue is exhausted.
+// Everything -- including Engine::create() -- happens on this thread, so the
+// single-thread-per-Engine API requirement holds naturally.
+static uint32_t farmWorker(uint32_t workerIndex) {
+    Engine* engine = Engine::create(g_backend);
+    SwapChain* swapChain = engine->createSwapChain(g_thumbnailSize, g_thumbnailSize);
+    Renderer* renderer = engine->createRenderer();
+    Scene* scene = engine->createScene();
+    View* view = engine->createView();
+
+    Skybox* skybox = Skybox::Builder().color({0.1, 0.125, 0.25, 1.0}).build(*engine);
+    scene->setSkybox(skybox);
+    view->setPostProcessingEnabled(false);
+    view->setViewport({ 0, 0, g_thumbnailSize, g_thumbnailSize });
+    view->setScene(scene);
+
+    VertexBuffer* vb = VertexBuffer::Builder()
+            .vertexCount(3)
+            .bufferCount(1)
+            .attribute(VertexAttribute::POSITION, 0, VertexBuffer::AttributeType::FLOAT2, 0, 12)
+            .attribute(VertexAttribute::COLOR, 0, VertexBuffer::AttributeType::UBYTE4, 8, 12)
+            .normalized(VertexAttribute::COLOR)
+            .build(*engine);
+    vb->setBufferAt(*engine, 0, VertexBuffer::BufferDescriptor(TRIANGLE_VERTICES, 36, nullptr));
+    IndexBuffer* ib = IndexBuffer::Builder()
+            .indexCount(3)
+            .bufferType(IndexBuffer::IndexType::USHORT)
+            .build(*engine);
+    ib->setBuffer(*engine, IndexBuffer::BufferDescriptor(TRIANGLE_INDICES, 6, nullptr));
+    Material* mat = Material::Builder()
+            .package(RESOURCES_BAKEDCOLOR_DATA, RESOURCES_BAKEDCOLOR_SIZE)
+            .build(*engine);
+
+    Entity renderable = EntityManager::get().create();
+    RenderableManager::Builder(1)
+            .boundingBox({{ -1, -1, -1 }, { 1, 1, 1 }})
+            .material(0, mat->getDefaultInstance())
+            .geometry(0, RenderableManager::PrimitiveType::TRIANGLES, vb, ib, 0, 3)
+            .culling(false)
+            .receiveShadows(false)
+            .castShadows(false)
+            .build(*engine, renderable);
+    scene->addEntity(renderable);
+
+    Entity cameraEntity = EntityManager::get().create();
+    Camera* camera = engine->createCamera(cameraEntity);
+    camera->setProjection(Camera::Projection::ORTHO, -1.5, 1.5, -1.5, 1.5, 0, 1);
+    view->setCamera(camera);
+
+    // the readback target is reused; a real farm would encode it before reusing it, but
+    // for throughput purposes issuing the transfer is what matters
+    std::vector<uint8_t> pixels;
+    if (g_readback) {
+        pixels.resize(size_t(g_thumbnailSize) * g_thumbnailSize * 4);
+    }
+
+    auto& tcm = engine->getTransformManager();
+    uint32_t rendered = 0;
+    while (g_remaining.fetch_sub(1, std::memory_order_relaxed) > 0) {
+        // vary the content a little, as distinct thumbnails would
+        tcm.setTransform(tcm.getInstance(renderable),
+                mat4f::rotation(float(rendered + workerIndex) * 0.05f, float3{ 0, 0, 1 }));
+        if (renderer->beginFrame(swapChain)) {
+            renderer->render(view);
+            if (g_readback) {
+                renderer->readPixels(0, 0, g_thumbnailSize, g_thumbnailSize,
+                        backend::PixelBufferDescriptor(pixels.data(), pixels.size(),
+                                backend::PixelDataFormat::RGBA, backend::PixelDataType::UBYTE));
+            }
+            renderer->endFrame();
+        }
+        rendered++;
+    }
+
+    // wait for the GPU to be done before tearing down
+    engine->flushAndWait();
+
+    engine->destroy(skybox);
+    engine->destroy(renderable);
+    engine->destroy(mat);
+    engine->destroy(vb);
+    engine->destroy(ib);
+    engine->destroyCameraComponent(cameraEntity);
+    EntityManager::get().destroy(cameraEntity);
+    EntityManager::get().destroy(renderable);
+    engine->destroy(view);
+    engine->destroy(scene);
+    engine->destroy(renderer);
+    engine->destroy(swapChain);
+    Engine::destroy(&engine);
+
+    return rendered;
+}
+
+int main(int argc, char** argv) {
+    handleCommandLineArgments(argc, argv);
+
+    std::cout << "Rendering " << g_renderCount << " thumbnails of "
+              << g_thumbnailSize << "x" << g_thumbnailSize
+              << " with " << g_engineCount << " engine(s)"
+              << (g_readback ? ", with readback" : "") << std::endl;
+
+    g_remaining.store(int32_t(g_renderCount));
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    std::vector<uint32_t> rendered(g_engineCount, 0);
+    workers.reserve(g_engineCount);
+    for (uint32_t i = 0; i < g_engineCount; i++) {
+        workers.emplace_back([i, &rendered] { rendered[i] = farmWorker(i); });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    uint32_t total = 0;
+    for (uint32_t i = 0; i < g_engineCount; i++) {
+        std::cout << "  engine " << i << ": " << rendered[i] << " renders" << std::endl;
+        total += rendered[i];
+    }
+    std::cout << total << " renders in " << elapsed.count() << " s, "
+              << double(total) / elapsed.count() << " renders/s"
+              << " (includes per-engine startup/teardown)" << std::endl;
+
+    return 0;
+}
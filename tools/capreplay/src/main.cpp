@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2022 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <backend/DriverEnums.h>
+#include <backend/Platform.h>
+
+#include <private/backend/CaptureStream.h>
+#include <private/backend/CommandBufferQueue.h>
+#include <private/backend/CommandStream.h>
+
+#include <utils/Path.h>
+
+#include <getopt/getopt.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+
+using namespace filament::backend;
+using namespace utils;
+
+static constexpr size_t CONFIG_MIN_COMMAND_BUFFERS_SIZE = 1 * 1024 * 1024;
+static constexpr size_t CONFIG_COMMAND_BUFFERS_SIZE     = 3 * CONFIG_MIN_COMMAND_BUFFERS_SIZE;
+
+static Backend g_backend = Backend::DEFAULT;
+static uint32_t g_maxFrames = 0;
+static uint32_t g_width = 1920;
+static uint32_t g_height = 1080;
+
+static void printUsage(const char* name) {
+    std::string execName(Path(name).getName());
+    std::string usage(
+            "CAPREPLAY replays a Filament command-stream capture against a backend.\n"
+            "Captures are recorded by setting the FILAMENT_CAPTURE environment variable\n"
+            "to a file path before running any Filament application (see also\n"
+            "FILAMENT_CAPTURE_FRAMES to limit the number of recorded frames).\n"
+            "\n"
+            "Usage:\n"
+            "    CAPREPLAY [options] <capture file>\n"
+            "\n"
+            "Options:\n"
+            "   --help, -h\n"
+            "       Print this message\n\n"
+            "   --license\n"
+            "       Print copyright and license information\n\n"
+            "   --api=[opengl|vulkan|metal|noop], -a [opengl|vulkan|metal|noop]\n"
+            "       Backend to replay against, the platform default if omitted\n\n"
+            "   --frames=N, -n N\n"
+            "       Stop after replaying N frames, the whole capture if omitted\n\n"
+            "   --size=WxH, -s WxH\n"
+            "       Size of the headless swap chain, 1920x1080 if omitted\n\n"
+    );
+
+    const std::string from("CAPREPLAY");
+    for (size_t pos = usage.find(from); pos != std::string::npos; pos = usage.find(from, pos)) {
+        usage.replace(pos, from.length(), execName);
+    }
+    printf("%s", usage.c_str());
+}
+
+static void license() {
+    static const char* license[] = {
+        #include "licenses/licenses.inc"
+        nullptr
+    };
+
+    const char** p = &license[0];
+    while (*p)
+        std::cout << *p++ << std::endl;
+}
+
+static int handleArguments(int argc, char* argv[]) {
+    static constexpr const char* OPTSTR = "ha:n:s:";
+    static const struct option OPTIONS[] = {
+            { "help",    no_argument,       nullptr, 'h' },
+            { "license", no_argument,       nullptr, 'l' },
+            { "api",     required_argument, nullptr, 'a' },
+            { "frames",  required_argument, nullptr, 'n' },
+            { "size",    required_argument, nullptr, 's' },
+            { nullptr, 0, nullptr, 0 }
+    };
+
+    int opt;
+    int optionIndex = 0;
+
+    while ((opt = getopt_long(argc, argv, OPTSTR, OPTIONS, &optionIndex)) >= 0) {
+        std::string arg(optarg ? optarg : "");
+        switch (opt) {
+            default:
+            case 'h':
+                printUsage(argv[0]);
+                exit(0);
+            case 'l':
+                license();
+                exit(0);
+            case 'a':
+                if (arg == "opengl") {
+                    g_backend = Backend::OPENGL;
+                } else if (arg == "vulkan") {
+                    g_backend = Backend::VULKAN;
+                } else if (arg == "metal") {
+                    g_backend = Backend::METAL;
+                } else if (arg == "noop") {
+                    g_backend = Backend::NOOP;
+                } else {
+                    std::cerr << "Unrecognized backend: '" << arg << "'" << std::endl;
+                    exit(1);
+                }
+                break;
+            case 'n':
+                g_maxFrames = uint32_t(std::stoul(arg));
+                break;
+            case 's':
+                if (sscanf(arg.c_str(), "%ux%u", &g_width, &g_height) != 2) { // NOLINT
+                    std::cerr << "Invalid size: '" << arg << "'" << std::endl;
+                    exit(1);
+                }
+                break;
+        }
+    }
+
+    return optind;
+}
+
+int main(int argc, char* argv[]) {
+    const int optionIndex = handleArguments(argc, argv);
+    const int numArgs = argc - optionIndex;
+    if (numArgs < 1) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    const char* const capturePath = argv[optionIndex];
+
+    CaptureReplayer replayer;
+    replayer.setHeadlessSize(g_width, g_height);
+    if (!replayer.open(capturePath)) {
+        return 1;
+    }
+
+    // Bring up a backend the same way the engine does, except that commands are executed
+    // on this thread rather than on a dedicated driver thread: replay is driven by the
+    // capture, so there is nothing to gain from pipelining here, and single-threaded
+    // execution keeps the frame times comparable between runs.
+    Backend backend = g_backend;
+    DefaultPlatform* platform = DefaultPlatform::create(&backend);
+    if (platform == nullptr) {
+        std::cerr << "Selected backend not supported in this build." << std::endl;
+        return 1;
+    }
+    Driver* driver = platform->createDriver(nullptr);
+    if (driver == nullptr) {
+        std::cerr << "The driver could not be initialized." << std::endl;
+        return 1;
+    }
+    CommandBufferQueue commandBufferQueue(
+            CONFIG_MIN_COMMAND_BUFFERS_SIZE, CONFIG_COMMAND_BUFFERS_SIZE);
+    CommandStream driverApi(*driver, commandBufferQueue.getCircularBuffer());
+
+    auto executeCommands = [&]() {
+        commandBufferQueue.flush();
+        auto buffers = commandBufferQueue.waitForCommands();
+        for (auto& item : buffers) {
+            if (UTILS_LIKELY(item.begin)) {
+                driverApi.execute(item.begin);
+                commandBufferQueue.releaseBuffer(item);
+            }
+        }
+    };
+
+    using clock = std::chrono::steady_clock;
+    std::vector<double> frameTimes;
+    bool more = true;
+    while (more && (g_maxFrames == 0 || replayer.getReplayedFrameCount() < g_maxFrames)) {
+        auto const start = clock::now();
+        more = replayer.replayFrame(driverApi);
+        executeCommands();
+        auto const stop = clock::now();
+        if (more) {
+            frameTimes.push_back(std::chrono::duration<double, std::milli>(stop - start).count());
+        }
+    }
+
+    driverApi.finish();
+    executeCommands();
+    driverApi.terminate();
+    delete driver;
+    DefaultPlatform::destroy(&platform);
+
+    if (frameTimes.empty()) {
+        std::cerr << "No frames replayed." << std::endl;
+        return 1;
+    }
+
+    std::sort(frameTimes.begin(), frameTimes.end());
+    double total = 0.0;
+    for (double t : frameTimes) {
+        total += t;
+    }
+    const size_t n = frameTimes.size();
+    printf("%zu frames replayed in %.2f s (%.1f fps)\n", n, total / 1000.0, n / (total / 1000.0));
+    printf("frame time: min %.3f ms, median %.3f ms, p95 %.3f ms, max %.3f ms\n",
+            frameTimes.front(),
+            frameTimes[n / 2],
+            frameTimes[std::min(n - 1, (n * 95) / 100)],
+            frameTimes.back());
+
+    return 0;
+}
@@ -20,6 +20,9 @@
 
 #include <meshoptimizer.h>
 
+#include <algorithm>
+#include <cmath>
+
 using namespace filamesh;
 using namespace filament::math;
 using namespace std;
@@ -44,8 +47,16 @@ void MeshWriter::optimize(Mesh& mesh) {
     // First, re-order triangles to improve cache locality and reduce the number of VS invocations.
     // Note that assimp already has aiProcess_ImproveCacheLocality, but MeshWriter doesn't know
     // about assimp, and it doesn't hurt to do it again here since this generally runs offline.
+    const float acmrBefore = meshopt_analyzeVertexCache(mesh.indices.data(), mesh.indices.size(),
+                mesh.vertexCount, 32, 0, 0).acmr;
     meshopt_optimizeVertexCache(mesh.indices.data(), mesh.indices.data(), mesh.indices.size(),
                 mesh.vertexCount);
+    const float acmrAfter = meshopt_analyzeVertexCache(mesh.indices.data(), mesh.indices.size(),
+                mesh.vertexCount, 32, 0, 0).acmr;
+
+    // Average cache miss ratio: transformed vertices per triangle, worst case 3.0 and around 0.5
+    // at the optimum for a regular mesh.
+    cout << "Vertex cache ACMR: " << acmrBefore << " -> " << acmrAfter << endl;
 
     // At this point, triangle order has been established but we still need to shuffle vertices to
     // optimize the fetch. This makes it so that lower-numbered indices generally come before
@@ -88,6 +99,63 @@ void MeshWriter::optimize(Mesh& mesh) {
     // e.g. we already (potentially) use snorm16 for uvs, half-floats for tangents, etc.
 }
 
+// Computes the bounding cone of a part, for cluster backface culling (see
+// RenderableManager::Builder::boundingCone). This is the same math as
+// meshopt_computeClusterBounds(), which we can't use directly because it is limited to
+// 256 triangles per cluster. The cone is conservative: the part is culled when
+// dot(center - camera, axis) >= cutoff * |center - camera| + radius.
+static PartCone computePartCone(const Part& part,
+        const decltype(Vertex::position)* positions, size_t stride,
+        const uint32_t* indices) {
+    auto positionAt = [positions, stride](uint32_t index) -> float3 {
+        auto const* p = (const decltype(Vertex::position)*)
+                ((const uint8_t*) positions + stride * index);
+        return float3(p->xyz);
+    };
+
+    // area-weighted average of the triangle normals gives us the cone axis
+    float3 axis{ 0.0f };
+    for (uint32_t i = part.offset; i < part.offset + part.indexCount; i += 3) {
+        float3 const p0 = positionAt(indices[i + 0]);
+        float3 const p1 = positionAt(indices[i + 1]);
+        float3 const p2 = positionAt(indices[i + 2]);
+        axis += cross(p1 - p0, p2 - p0);
+    }
+
+    Box const& aabb = part.aabb;
+    PartCone cone = {
+            .centerRadius = { aabb.center, length(aabb.halfExtent) },
+            .axisCutoff = { 0.0f, 0.0f, 0.0f, 1.0f }  // cutoff >= 1 disables the test
+    };
+
+    float const axisLength = length(axis);
+    if (axisLength == 0.0f) {
+        return cone;
+    }
+    axis /= axisLength;
+
+    // the cone half-angle is the largest angle between the axis and a triangle normal
+    float mindp = 1.0f;
+    for (uint32_t i = part.offset; i < part.offset + part.indexCount; i += 3) {
+        float3 const p0 = positionAt(indices[i + 0]);
+        float3 const p1 = positionAt(indices[i + 1]);
+        float3 const p2 = positionAt(indices[i + 2]);
+        float3 const n = cross(p1 - p0, p2 - p0);
+        float const area = length(n);
+        if (area > 0.0f) {
+            mindp = std::min(mindp, float(dot(n / area, axis)));
+        }
+    }
+
+    // a normal cone wider than ~168 degrees can never reject anything; leave it disabled
+    if (mindp > 0.1f) {
+        // add 90 degrees on both sides and invert the cone:
+        // -cos(a + 90) = sin(a) = sqrt(1 - cos^2(a))
+        cone.axisCutoff = { axis, sqrtf(1.0f - mindp * mindp) };
+    }
+    return cone;
+}
+
 bool MeshWriter::serialize(ostream& out, Mesh& mesh) {
     const bool hasIndex16 = mesh.vertexCount <= numeric_limits<uint16_t>::max();
     const bool hasUV1 = !mesh.uv1.empty();
@@ -106,6 +174,20 @@ bool MeshWriter::serialize(ostream& out, Mesh& mesh) {
     // It's safe to optimize the mesh regardless of the compression setting.
     optimize(mesh);
 
+    // Compute per-part bounding cones for cluster backface culling. Quantized positions are
+    // skipped: the mesh's object space is then the quantized space, whose non-uniform scale
+    // would break the cone test.
+    vector<PartCone> partCones;
+    if (!(mFlags & POSITION_SNORM16)) {
+        const size_t stride = (mFlags & INTERLEAVED) ? sizeof(Vertex) : sizeof(Vertex::position);
+        const decltype(Vertex::position)* positions = (mFlags & INTERLEAVED)
+                ? &mesh.vertices.data()->position : mesh.positions.data();
+        partCones.reserve(mesh.parts.size());
+        for (const auto& part : mesh.parts) {
+            partCones.push_back(computePartCone(part, positions, stride, mesh.indices.data()));
+        }
+    }
+
     // Perform compression of vertex data if it has been requested.
     CompressionHeader cheader {};
     vector<unsigned char> compressedVertices;
@@ -171,7 +253,7 @@ bool MeshWriter::serialize(ostream& out, Mesh& mesh) {
     header.version = VERSION;
     header.parts = uint32_t(mesh.parts.size());
     header.aabb = aabb;
-    header.flags = mFlags;
+    header.flags = mFlags | (partCones.empty() ? 0 : PART_CONES);
     if (mFlags & INTERLEAVED) {
         header.offsetPosition = offsetof(Vertex, position);
         header.offsetTangents = offsetof(Vertex, tangents);
@@ -213,6 +295,10 @@ bool MeshWriter::serialize(ostream& out, Mesh& mesh) {
 
     write(out, header);
 
+    if (mFlags & POSITION_SNORM16) {
+        write(out, mQuantization);
+    }
+
     if (mFlags & COMPRESSION) {
         write(out, &cheader, 1);
         write(out, compressedVertices.data(), compressedVertices.size());
@@ -243,6 +329,10 @@ bool MeshWriter::serialize(ostream& out, Mesh& mesh) {
 
     write(out, mesh.parts.data(), header.parts);
 
+    if (!partCones.empty()) {
+        write(out, partCones.data(), header.parts);
+    }
+
     write(out, uint32_t(mesh.materials.size()));
     for (const auto& name : mesh.materials) {
         write(out, uint32_t(name.size()));
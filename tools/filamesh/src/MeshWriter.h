@@ -57,9 +57,12 @@ struct Mesh {
 
 class MeshWriter {
     uint32_t mFlags;
+    QuantizationHeader mQuantization = {};
     void optimize(Mesh& mesh);
 public:
     MeshWriter(uint32_t flags) : mFlags(flags) {}
+    MeshWriter(uint32_t flags, const QuantizationHeader& quantization)
+            : mFlags(flags), mQuantization(quantization) {}
     bool serialize(std::ostream&, Mesh& mesh);
 };
 
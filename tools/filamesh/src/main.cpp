@@ -47,10 +47,15 @@ using Assimp::Importer;
 bool g_interleaved = false;
 bool g_snormUVs = false;
 bool g_compression = false;
+bool g_quantizedPositions = false;
 
 Mesh g_mesh;
 float2 g_minUV = float2(std::numeric_limits<float>::max());
 float2 g_maxUV = float2(std::numeric_limits<float>::lowest());
+float3 g_minPos = float3(std::numeric_limits<float>::max());
+float3 g_maxPos = float3(std::numeric_limits<float>::lowest());
+float3 g_qCenter;
+float3 g_qExtent;
 
 template<bool SNORMUVS>
 static ushort2 convertUV(float2 uv) {
@@ -63,6 +68,16 @@ static ushort2 convertUV(float2 uv) {
     }
 }
 
+// When positions are quantized, the snorm16 values are stored bit-cast into the half4
+// position slot; the file layout is unchanged since both encodings are 8 bytes per vertex.
+static half4 convertPosition(float3 p) {
+    if (g_quantizedPositions) {
+        short4 pshort(packSnorm16(float4((p - g_qCenter) / g_qExtent, 1.0f)));
+        return bit_cast<half4>(pshort);
+    }
+    return half4(p, 1.0_h);
+}
+
 template<typename VECTOR, typename INDEX>
 static Box computeAABB(VECTOR const* positions, INDEX const* indices,
         size_t count, size_t stride) noexcept {
@@ -78,6 +93,23 @@ static Box computeAABB(VECTOR const* positions, INDEX const* indices,
     return Box().set(bmin, bmax);
 }
 
+// Variant of computeAABB for quantized positions; the resulting box is in quantized space,
+// matching what the loader's dequantization transform expects.
+template<typename INDEX>
+static Box computeQuantizedAABB(half4 const* positions, INDEX const* indices,
+        size_t count, size_t stride) noexcept {
+    filament::math::float3 bmin(std::numeric_limits<float>::max());
+    filament::math::float3 bmax(std::numeric_limits<float>::lowest());
+    for (size_t i = 0; i < count; ++i) {
+        half4 const* p = reinterpret_cast<half4 const*>(
+                (char const*) positions + indices[i] * stride);
+        const filament::math::float3 v(unpackSnorm16(bit_cast<short4>(*p)).xyz);
+        bmin = min(bmin, v);
+        bmax = max(bmax, v);
+    }
+    return Box().set(bmin, bmax);
+}
+
 void preprocessNode(const aiScene* scene, const aiNode* node) {
     for (size_t i = 0; i < node->mNumMeshes; ++i) {
         const aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
@@ -85,6 +117,11 @@ void preprocessNode(const aiScene* scene, const aiNode* node) {
             std::cerr << "Error: mesh " << i <<  " does not have normals" << std::endl;
             continue;
         }
+        const float3* vertices = reinterpret_cast<const float3*>(mesh->mVertices);
+        for (size_t j = 0; j < mesh->mNumVertices; j++) {
+            g_minPos = min(vertices[j], g_minPos);
+            g_maxPos = max(vertices[j], g_maxPos);
+        }
         if (!mesh->HasTextureCoords(0)) {
             std::cerr << "Warning: mesh " << i <<  " does not have texture coordinates"
                     << std::endl;
@@ -167,7 +204,7 @@ void processNode(const aiScene* scene, const aiNode* node, std::vector<Part>& me
                     }
                     color = colors ? colors[j] : float4(1.0f);
                     Vertex vertex {
-                        .position = half4(vertices[j], 1.0_h),
+                        .position = convertPosition(vertices[j]),
                         .tangents = short4(filament::math::packSnorm16(q.xyzw)),
                         .color = ubyte4(clamp(color, 0.0f, 1.0f) * 255.0f),
                         .uv0 = uv0 ? convertUV<SNORMUVS>(uv0[j].xy) : ushort2(0),
@@ -200,8 +237,11 @@ void processNode(const aiScene* scene, const aiNode* node, std::vector<Part>& me
                 size_t stride = INTERLEAVED ? sizeof(Vertex) : sizeof(Vertex::position);
                 const decltype(Vertex::position)* positions =
                         INTERLEAVED ? &g_mesh.vertices.data()->position : g_mesh.positions.data();
-                const Box aabb(computeAABB(positions,
-                        g_mesh.indices.data() + indexBufferOffset, indicesCount, stride));
+                const Box aabb(g_quantizedPositions
+                        ? computeQuantizedAABB(positions,
+                                g_mesh.indices.data() + indexBufferOffset, indicesCount, stride)
+                        : computeAABB(positions,
+                                g_mesh.indices.data() + indexBufferOffset, indicesCount, stride));
 
                 meshes.emplace_back(Part {
                     .offset = indexBufferOffset,
@@ -241,6 +281,8 @@ static void printUsage(const char* name) {
                     "       interleaves mesh attributes\n\n"
                     "   --compress, -c\n"
                     "       enable compression\n\n"
+                    "   --quantize, -q\n"
+                    "       store positions as snorm16 with a per-mesh dequantization transform\n\n"
     );
 
     const std::string from("FILAMESH");
@@ -262,12 +304,13 @@ static void license() {
 }
 
 static int handleArguments(int argc, char* argv[]) {
-    static constexpr const char* OPTSTR = "hilc";
+    static constexpr const char* OPTSTR = "hilcq";
     static const struct option OPTIONS[] = {
             { "help",        no_argument, 0, 'h' },
             { "license",     no_argument, 0, 'l' },
             { "interleaved", no_argument, 0, 'i' },
             { "compress",    no_argument, 0, 'c' },
+            { "quantize",    no_argument, 0, 'q' },
             { 0, 0, 0, 0 }  // termination of the option list
     };
 
@@ -292,6 +335,9 @@ static int handleArguments(int argc, char* argv[]) {
             case 'c':
                 g_compression = true;
                 break;
+            case 'q':
+                g_quantizedPositions = true;
+                break;
         }
     }
 
@@ -346,6 +392,12 @@ int main(int argc, char* argv[]) {
     g_snormUVs = g_minUV.x >= -1.0f && g_minUV.x <= 1.0f && g_maxUV.x >= -1.0f && g_maxUV.x <= 1.0f &&
                  g_minUV.y >= -1.0f && g_minUV.y <= 1.0f && g_maxUV.y >= -1.0f && g_maxUV.y <= 1.0f;
 
+    if (g_quantizedPositions) {
+        g_qCenter = (g_minPos + g_maxPos) * 0.5f;
+        // Avoid a division by zero on degenerate (flat) meshes.
+        g_qExtent = max((g_maxPos - g_minPos) * 0.5f, float3(1e-5f));
+    }
+
     // Consume assimp data and produce filamesh data.
     if (g_interleaved) {
         if (g_snormUVs) {
@@ -399,7 +451,10 @@ int main(int argc, char* argv[]) {
     if (g_compression) {
         flags |= filamesh::COMPRESSION;
     }
-    MeshWriter(flags).serialize(out, g_mesh);
+    if (g_quantizedPositions) {
+        flags |= filamesh::POSITION_SNORM16;
+    }
+    MeshWriter(flags, QuantizationHeader { g_qExtent, g_qCenter }).serialize(out, g_mesh);
 
     out.flush();
     out.close();
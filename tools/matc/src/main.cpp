@@ -16,8 +16,14 @@
 
 #include <stdlib.h>
 
+#include <sys/stat.h>
+
+#include <chrono>
 #include <iostream>
 #include <memory>
+#include <thread>
+
+#include <filamat/MaterialBuilder.h>
 
 #include "matc/Compiler.h"
 #include "matc/CommandlineConfig.h"
@@ -25,6 +31,38 @@
 
 using namespace matc;
 
+static time_t getModifiedTime(const char* path) noexcept {
+    struct stat st = {};
+    return stat(path, &st) == 0 ? st.st_mtime : 0;
+}
+
+// Recompile the input file each time it changes, without ever exiting. The expensive
+// toolchain initialization (glslang, spirv-tools) is paid once for the lifetime of the
+// process instead of once per compilation.
+static int watch(Compiler& compiler, CommandlineConfig& parameters) {
+    // Hold an extra reference on the toolchain so that the init()/shutdown() pair done
+    // by each compilation never tears it down.
+    filamat::MaterialBuilder::init();
+
+    const char* path = parameters.getInput()->getName();
+    time_t lastModified = 0;
+    for (;;) {
+        const time_t modified = getModifiedTime(path);
+        if (modified != lastModified) {
+            lastModified = modified;
+            if (compiler.start(parameters)) {
+                std::cout << "Compiled " << path << ", watching for changes..." << std::endl;
+            } else {
+                std::cerr << "Compilation of " << path << " failed, watching for changes..."
+                        << std::endl;
+            }
+            // the input must be closed so the next iteration can reopen it
+            parameters.getInput()->close();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    }
+}
+
 int main(int argc, char** argv) {
     CommandlineConfig parameters(argc, argv);
     if (!parameters.isValid()) {
@@ -34,6 +72,10 @@ int main(int argc, char** argv) {
 
     const std::unique_ptr<Compiler> compiler = std::make_unique<MaterialCompiler>();
 
+    if (parameters.isWatchMode() && parameters.getInput() != nullptr) {
+        return watch(*compiler, parameters);
+    }
+
     if (!compiler->start(parameters)) {
         return EXIT_FAILURE;
     }
@@ -61,10 +61,29 @@ static void usage(char* name) {
             "           MATC -Dfoo=1 -Dbar -Dbuzz=100 ...\n\n"
             "   --reflect, -r\n"
             "       Reflect the specified metadata as JSON: parameters\n\n"
+            "   --cache-dir, -c\n"
+            "       Cache compiled packages in the given directory, keyed on the content of the\n"
+            "       input and the compiler flags; unchanged materials are copied from the cache\n"
+            "       instead of being recompiled\n\n"
+            "   --watch, -W\n"
+            "       Keep running after compilation, watch the input file and recompile it\n"
+            "       whenever it changes. The shader toolchain stays initialized between\n"
+            "       recompilations, which makes iterating on a material much faster.\n"
+            "       Files pulled in by the material are not watched\n\n"
             "   --variant-filter=<filter>, -V <filter>\n"
             "       Filter out specified comma-separated variants:\n"
             "           directionalLighting, dynamicLighting, shadowReceiver, skinning, vsm, fog\n"
             "       This variant filter is merged with the filter from the material, if any\n\n"
+            "   --used-variants=<file>, -u <file>\n"
+            "       Strip variants absent from the given variant-usage dump, produced at\n"
+            "       runtime by the engine's d.materials.dump_variant_usage debug property.\n"
+            "       The entry matching the material's name is applied; a material without\n"
+            "       an entry keeps all its variants\n\n"
+            "   --depth-variants, -k\n"
+            "       Keep the depth-only variants even when the material has no custom depth\n"
+            "       code. By default those variants are pruned because the engine uses the\n"
+            "       default material's depth programs instead; the default material itself\n"
+            "       must be compiled with this flag\n\n"
             "   --version, -v\n"
             "       Print the material version number\n\n"
             "Internal use and debugging only:\n"
@@ -153,7 +172,7 @@ static void parseDefine(std::string defineString,
 }
 
 bool CommandlineConfig::parse() {
-    static constexpr const char* OPTSTR = "hlxo:f:dm:a:p:D:OSEr:vV:gtw";
+    static constexpr const char* OPTSTR = "hlxo:f:dm:a:p:c:D:OSEr:u:vV:gtwWk";
     static const struct option OPTIONS[] = {
             { "help",                    no_argument, nullptr, 'h' },
             { "license",                 no_argument, nullptr, 'l' },
@@ -161,7 +180,10 @@ bool CommandlineConfig::parse() {
             { "output-format",     required_argument, nullptr, 'f' },
             { "debug",                   no_argument, nullptr, 'd' },
             { "variant-filter",    required_argument, nullptr, 'V' },
+            { "used-variants",     required_argument, nullptr, 'u' },
+            { "depth-variants",          no_argument, nullptr, 'k' },
             { "platform",          required_argument, nullptr, 'p' },
+            { "cache-dir",         required_argument, nullptr, 'c' },
             { "optimize",                no_argument, nullptr, 'x' }, // for backward compatibility
             { "optimize",                no_argument, nullptr, 'O' }, // for backward compatibility
             { "optimize-size",           no_argument, nullptr, 'S' },
@@ -173,6 +195,7 @@ bool CommandlineConfig::parse() {
             { "print",                   no_argument, nullptr, 't' },
             { "version",                 no_argument, nullptr, 'v' },
             { "raw",                     no_argument, nullptr, 'w' },
+            { "watch",                   no_argument, nullptr, 'W' },
             { nullptr, 0, nullptr, 0 }  // termination of the option list
     };
 
@@ -221,6 +244,9 @@ bool CommandlineConfig::parse() {
                     return false;
                 }
                 break;
+            case 'c':
+                mCacheDir = arg;
+                break;
             case 'a':
                 if (arg == "opengl") {
                     mTargetApi |= TargetApi::OPENGL;
@@ -248,6 +274,9 @@ bool CommandlineConfig::parse() {
             case 'V':
                 mVariantFilter = parseVariantFilter(arg);
                 break;
+            case 'u':
+                mUsedVariantsPath = arg;
+                break;
             // These 2 flags are supported for backward compatibility
             case 'O':
             case 'x':
@@ -271,6 +300,12 @@ bool CommandlineConfig::parse() {
             case 'w':
                 mRawShaderMode = true;
                 break;
+            case 'W':
+                mWatchMode = true;
+                break;
+            case 'k':
+                mKeepDepthVariants = true;
+                break;
         }
     }
 
@@ -118,17 +118,37 @@ public:
         return mDefines;
     }
 
+    const std::string& getCacheDir() const noexcept {
+        return mCacheDir;
+    }
+
+    const std::string& getUsedVariantsPath() const noexcept {
+        return mUsedVariantsPath;
+    }
+
+    bool isWatchMode() const noexcept {
+        return mWatchMode;
+    }
+
+    bool keepDepthVariants() const noexcept {
+        return mKeepDepthVariants;
+    }
+
 protected:
     bool mDebug = false;
     bool mIsValid = true;
     bool mPrintShaders = false;
     bool mRawShaderMode = false;
+    bool mWatchMode = false;
+    bool mKeepDepthVariants = false;
     Optimization mOptimizationLevel = Optimization::PERFORMANCE;
     Metadata mReflectionTarget = Metadata::NONE;
     Platform mPlatform = Platform::ALL;
     OutputFormat mOutputFormat = OutputFormat::BLOB;
     TargetApi mTargetApi = (TargetApi) 0;
     std::unordered_map<std::string, std::string> mDefines;
+    std::string mCacheDir;
+    std::string mUsedVariantsPath;
     uint8_t mVariantFilter = 0;
 };
 
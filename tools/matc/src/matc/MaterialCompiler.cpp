@@ -16,8 +16,17 @@
 
 #include "MaterialCompiler.h"
 
+#include <fstream>
 #include <memory>
 #include <iostream>
+#include <vector>
+
+#include <cinttypes>
+#include <cstring>
+
+#include <filament/MaterialEnums.h>
+
+#include <utils/Path.h>
 
 #include <filamat/MaterialBuilder.h>
 
@@ -257,6 +266,51 @@ bool MaterialCompiler::isValidJsonStart(const char* buffer, size_t size) const n
     return c == 'n' && (end - buffer) > 3 && strncmp(buffer, "null", 5) != 0;
 }
 
+// FNV-1a, 64 bits; good enough for cache keys
+static uint64_t hashBytes(const char* data, size_t size,
+        uint64_t hash = 14695981039346656037ull) noexcept {
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ uint8_t(data[i])) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// Parses the engine's variant-usage dump -- lines of the form
+//     variant-usage "<material name>" <32 hex chars>
+// possibly embedded in log output -- and restricts the builder to the recorded variants
+// of the entry matching the material's name, if there is one.
+static void applyVariantUsage(const std::string& path, filamat::MaterialBuilder& builder) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Could not open variant-usage file: " << path << std::endl;
+        return;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        const size_t pos = line.find("variant-usage \"");
+        if (pos == std::string::npos) {
+            continue;
+        }
+        char name[256];
+        char mask[33];
+        if (sscanf(line.c_str() + pos, "variant-usage \"%255[^\"]\" %32[0-9a-fA-F]",
+                name, mask) != 2 || strlen(mask) != 32) {
+            continue;
+        }
+        if (strcmp(name, builder.getName()) != 0) {
+            continue;
+        }
+        // the mask is dumped most significant word first
+        utils::bitset<uint64_t, 2> used;
+        used.getBitsAt(1) = strtoull(std::string(mask, 16).c_str(), nullptr, 16);
+        used.getBitsAt(0) = strtoull(mask + 16, nullptr, 16);
+        builder.usedVariants(used);
+        return;
+    }
+    std::cerr << "No variant-usage entry for material \"" << builder.getName()
+              << "\" in " << path << ", keeping all variants" << std::endl;
+}
+
 bool MaterialCompiler::run(const Config& config) {
     Config::Input* input = config.getInput();
     ssize_t size = input->open();
@@ -278,6 +332,40 @@ bool MaterialCompiler::run(const Config& config) {
         return success;
     }
 
+    // Content-hash object cache: the key covers the input content, the compiler flags
+    // and the material format version. On a hit the cached package is written out as-is
+    // and compilation is skipped entirely.
+    utils::Path cachedPackage;
+    if (!config.getCacheDir().empty() &&
+            config.getReflectionTarget() == Config::Metadata::NONE) {
+        uint64_t key = hashBytes(buffer.get(), size_t(size));
+        const std::string configString = config.toString();
+        key = hashBytes(configString.data(), configString.size(), key);
+        key = (key ^ filament::MATERIAL_VERSION) * 1099511628211ull;
+        if (!config.getUsedVariantsPath().empty()) {
+            // the dump's content changes the output, so it's part of the key
+            std::ifstream in(config.getUsedVariantsPath());
+            const std::string dump((std::istreambuf_iterator<char>(in)),
+                    std::istreambuf_iterator<char>());
+            key = hashBytes(dump.data(), dump.size(), key);
+        }
+
+        char entryName[32];
+        snprintf(entryName, sizeof(entryName), "%016" PRIx64 ".matcache", key);
+        cachedPackage = utils::Path(config.getCacheDir()) + entryName;
+        if (cachedPackage.isFile()) {
+            std::ifstream in(cachedPackage.getPath(), std::ios::binary | std::ios::ate);
+            if (in) {
+                std::vector<char> blob(size_t(in.tellg()));
+                in.seekg(0);
+                if (in.read(blob.data(), std::streamsize(blob.size()))) {
+                    Package package(blob.data(), blob.size());
+                    return writePackage(package, config);
+                }
+            }
+        }
+    }
+
     MaterialBuilder::init();
     MaterialBuilder builder;
     // Before attempting an expensive lex, let's find out if we were sent pure JSON.
@@ -311,12 +399,17 @@ bool MaterialCompiler::run(const Config& config) {
         .optimization(config.getOptimizationLevel())
         .printShaders(config.printShaders())
         .generateDebugInfo(config.isDebug())
-        .variantFilter(config.getVariantFilter() | builder.getVariantFilter());
+        .variantFilter(config.getVariantFilter() | builder.getVariantFilter())
+        .keepDepthVariants(config.keepDepthVariants());
 
     for (const auto& define : config.getDefines()) {
         builder.shaderDefine(define.first.c_str(), define.second.c_str());
     }
 
+    if (!config.getUsedVariantsPath().empty()) {
+        applyVariantUsage(config.getUsedVariantsPath(), builder);
+    }
+
     JobSystem js;
     js.adopt();
 
@@ -330,6 +423,17 @@ bool MaterialCompiler::run(const Config& config) {
         std::cerr << "Could not compile material " << input->getName() << std::endl;
         return false;
     }
+
+    if (!cachedPackage.isEmpty()) {
+        // populate the cache; a failure here only means the next build won't hit it
+        utils::Path(config.getCacheDir()).mkdirRecursive();
+        std::ofstream out(cachedPackage.getPath(), std::ios::binary | std::ios::trunc);
+        if (out) {
+            out.write(reinterpret_cast<const char*>(package.getData()),
+                    std::streamsize(package.getSize()));
+        }
+    }
+
     return writePackage(package, config);
 }
 
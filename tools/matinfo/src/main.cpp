@@ -56,6 +56,7 @@ struct Config {
     bool transpile = false;
     bool binary = false;
     bool analyze = false;
+    bool batch = false;
     uint64_t shaderIndex;
     int serverPort = 0;
 };
@@ -88,6 +89,9 @@ static void printUsage(const char* name) {
             "       Serve a web page at the given port (e.g. 8080)\n\n"
             "   --dump-binary=[index], -b\n"
             "       Dump binary SPIRV for the nth Vulkan shader to 'out.spv'\n\n"
+            "   --batch, -B\n"
+            "       Scan a directory of material files and print per-variant SPIR-V statistics\n"
+            "       (instructions, register pressure estimate, texture fetches, bytes) as CSV\n\n"
             "   --license\n"
             "       Print copyright and license information\n\n"
             "   --analyze-spirv=[index], -a\n"
@@ -113,9 +117,10 @@ static void license() {
 }
 
 static int handleArguments(int argc, char* argv[], Config* config) {
-    static constexpr const char* OPTSTR = "hla:g:s:v:b:m:b:w:xyz";
+    static constexpr const char* OPTSTR = "hla:g:s:v:b:m:b:w:xyzB";
     static const struct option OPTIONS[] = {
             { "help",            no_argument,       0, 'h' },
+            { "batch",           no_argument,       0, 'B' },
             { "license",         no_argument,       0, 'l' },
             { "analyze-spirv",   required_argument, 0, 'a' },
             { "print-glsl",      required_argument, 0, 'g' },
@@ -182,6 +187,9 @@ static int handleArguments(int argc, char* argv[], Config* config) {
             case 'z':
                 config->printDictionarySPIRV = true;
                 break;
+            case 'B':
+                config->batch = true;
+                break;
         }
     }
 
@@ -376,6 +384,199 @@ static void dumpSpirvBinary(const std::vector<uint32_t>& spirv, std::string file
     std::cout << "Binary SPIR-V dumped to " << filename << std::endl;
 }
 
+// ------------------------------------------------------------------------------------------------
+// Batch analysis: scans a directory of filamat packages and emits per-variant statistics as CSV,
+// so the most expensive shaders of a large material library can be found without opening each
+// package interactively.
+// ------------------------------------------------------------------------------------------------
+
+struct ShaderStats {
+    uint32_t instructions = 0;
+    uint32_t textureFetches = 0;
+    uint32_t registerPressure = 0;  // peak number of live SSA values, a register-pressure proxy
+};
+
+struct SpirvAnalysis {
+    std::map<uint32_t, size_t> definition;  // result id => defining instruction index
+    std::map<uint32_t, size_t> lastUse;     // result id => last instruction index using it
+    size_t instructionIndex = 0;
+    ShaderStats stats;
+};
+
+static spv_result_t analyzeInstruction(void* userData, const spv_parsed_instruction_t* inst) {
+    SpirvAnalysis& analysis = *static_cast<SpirvAnalysis*>(userData);
+    analysis.stats.instructions++;
+    switch (spv::Op(inst->opcode)) {
+        case spv::OpImageSampleImplicitLod:
+        case spv::OpImageSampleExplicitLod:
+        case spv::OpImageSampleDrefImplicitLod:
+        case spv::OpImageSampleDrefExplicitLod:
+        case spv::OpImageSampleProjImplicitLod:
+        case spv::OpImageSampleProjExplicitLod:
+        case spv::OpImageSampleProjDrefImplicitLod:
+        case spv::OpImageSampleProjDrefExplicitLod:
+        case spv::OpImageFetch:
+        case spv::OpImageGather:
+        case spv::OpImageDrefGather:
+        case spv::OpImageRead:
+            analysis.stats.textureFetches++;
+            break;
+        default:
+            break;
+    }
+    if (inst->result_id) {
+        analysis.definition[inst->result_id] = analysis.instructionIndex;
+    }
+    for (uint16_t i = 0; i < inst->num_operands; i++) {
+        const spv_parsed_operand_t& operand = inst->operands[i];
+        if (operand.type == SPV_OPERAND_TYPE_ID) {
+            analysis.lastUse[inst->words[operand.offset]] = analysis.instructionIndex;
+        }
+    }
+    analysis.instructionIndex++;
+    return SPV_SUCCESS;
+}
+
+static bool computeShaderStats(const std::vector<uint32_t>& spirv, ShaderStats* stats) {
+    SpirvAnalysis analysis;
+    spv_context context = spvContextCreate(SPV_ENV_UNIVERSAL_1_0);
+    spv_result_t result = spvBinaryParse(context, &analysis, spirv.data(), spirv.size(),
+            nullptr, analyzeInstruction, nullptr);
+    spvContextDestroy(context);
+    if (result != SPV_SUCCESS) {
+        return false;
+    }
+
+    // Estimate register pressure as the peak number of simultaneously live SSA values,
+    // using each value's [definition, last use] interval as its lifetime. This ignores
+    // control flow, but ranks shaders the same way a per-block analysis would.
+    std::vector<int32_t> delta(analysis.instructionIndex + 1, 0);
+    for (const auto& def : analysis.definition) {
+        const auto last = analysis.lastUse.find(def.first);
+        if (last != analysis.lastUse.end() && last->second > def.second) {
+            delta[def.second]++;
+            delta[last->second]--;
+        }
+    }
+    int32_t live = 0, peak = 0;
+    for (int32_t d : delta) {
+        live += d;
+        peak = std::max(peak, live);
+    }
+    analysis.stats.registerPressure = uint32_t(peak);
+
+    *stats = analysis.stats;
+    return true;
+}
+
+static const char* toString(filament::backend::ShaderModel model) {
+    switch (model) {
+        case filament::backend::ShaderModel::GL_ES_30:   return "gles30";
+        case filament::backend::ShaderModel::GL_CORE_41: return "glcore41";
+        default:                                         return "unknown";
+    }
+}
+
+static std::string variantToString(filament::Variant variant) {
+    using filament::Variant;
+    std::string s;
+    if (variant.key & Variant::DIR) s += "DIR|";
+    if (variant.key & Variant::DYN) s += "DYN|";
+    if (variant.key & Variant::SRE) s += "SRE|";
+    if (variant.key & Variant::SKN) s += "SKN|";
+    if (variant.key & Variant::DEP) s += "DEP|";
+    if (variant.key & Variant::FOG) s += "FOG|";
+    if (variant.key & Variant::VSM) s += "VSM|";
+    if (s.empty()) {
+        return "DEFAULT";
+    }
+    s.pop_back();
+    return s;
+}
+
+static bool batchAnalyzeFile(const Path& path) {
+    long fileSize = static_cast<long>(getFileSize(path.c_str()));
+    if (fileSize <= 0) {
+        return false;
+    }
+    std::ifstream in(path.c_str(), std::ifstream::in | std::ios::binary);
+    std::vector<char> buffer(static_cast<unsigned long>(fileSize));
+    if (!in.read(buffer.data(), fileSize)) {
+        return false;
+    }
+
+    ChunkContainer container(buffer.data(), buffer.size());
+    if (!container.parse()) {
+        return false;
+    }
+
+    utils::CString name;
+    if (!read(container, filamat::MaterialName, &name)) {
+        name = utils::CString("<unknown>");
+    }
+
+    ShaderExtractor parser(Backend::VULKAN, buffer.data(), buffer.size());
+    if (!parser.parse()) {
+        // GLSL-only package, there's no SPIR-V to analyze
+        return false;
+    }
+
+    std::vector<ShaderInfo> info(getShaderCount(container, filamat::ChunkType::MaterialSpirv));
+    if (!getVkShaderInfo(container, info.data())) {
+        return false;
+    }
+
+    for (const auto& item : info) {
+        filaflat::ShaderBuilder builder;
+        parser.getShader(item.shaderModel, item.variant, item.pipelineStage, builder);
+
+        uint32_t const* words = reinterpret_cast<uint32_t const*>(builder.data());
+        assert(0 == (builder.size() % 4));
+        const std::vector<uint32_t> spirv(words, words + builder.size() / 4);
+
+        ShaderStats stats;
+        if (!computeShaderStats(spirv, &stats)) {
+            continue;
+        }
+
+        std::cout << path.getName() << ','
+                << name.c_str() << ','
+                << toString(item.shaderModel) << ','
+                << (item.pipelineStage == filament::backend::VERTEX ? "vertex" : "fragment") << ','
+                << variantToString(item.variant) << ','
+                << stats.instructions << ','
+                << stats.registerPressure << ','
+                << stats.textureFetches << ','
+                << builder.size() << '\n';
+    }
+    return true;
+}
+
+static void batchAnalyzeDirectory(const Path& directory, size_t* analyzed, size_t* skipped) {
+    for (const auto& entry : directory.listContents()) {
+        if (entry.isDirectory()) {
+            batchAnalyzeDirectory(entry, analyzed, skipped);
+        } else if (entry.getExtension() == "filamat") {
+            if (batchAnalyzeFile(entry)) {
+                (*analyzed)++;
+            } else {
+                std::cerr << "Skipped " << entry << " (no SPIR-V chunk or not a valid package)."
+                        << std::endl;
+                (*skipped)++;
+            }
+        }
+    }
+}
+
+static bool batchAnalyze(const Path& directory) {
+    std::cout << "file,material,model,stage,variant,"
+            "instructions,registerPressure,textureFetches,bytes\n";
+    size_t analyzed = 0, skipped = 0;
+    batchAnalyzeDirectory(directory, &analyzed, &skipped);
+    std::cerr << "Analyzed " << analyzed << " materials, skipped " << skipped << "." << std::endl;
+    return analyzed > 0;
+}
+
 static bool parseChunks(Config config, void* data, size_t size) {
     using namespace filament::matdbg;
     ChunkContainer container(data, size);
@@ -563,6 +764,14 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    if (config.batch) {
+        if (!src.isDirectory()) {
+            std::cerr << "The batch source " << src << " is not a directory." << std::endl;
+            return 1;
+        }
+        return batchAnalyze(src) ? 0 : 1;
+    }
+
     long fileSize = static_cast<long>(getFileSize(src.c_str()));
     if (fileSize <= 0) {
         std::cerr << "The source material " << src << " is invalid." << std::endl;
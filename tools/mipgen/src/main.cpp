@@ -27,6 +27,7 @@
 #include <imageio/ImageDecoder.h>
 #include <imageio/ImageEncoder.h>
 
+#include <utils/JobSystem.h>
 #include <utils/Path.h>
 
 #include <getopt/getopt.h>
@@ -316,7 +317,11 @@ int main(int argc, char* argv[]) {
     uint32_t count = getMipmapCount(sourceImage);
     count = g_mipLevelCount == 0 ? count : min(g_mipLevelCount - 1, count);
     vector<LinearImage> miplevels(count);
-    generateMipmaps(sourceImage, g_filter, miplevels.data(), count);
+
+    utils::JobSystem js;
+    js.adopt();
+    generateMipmaps(js, sourceImage, g_filter, miplevels.data(), count);
+    js.emancipate();
 
     if (g_ktxContainer) {
         if (!g_quietMode) {
@@ -354,15 +354,16 @@ int main(int argc, char* argv[]) {
     const size_t height = hasRoughnessMap ? roughnessImage.getHeight() : normalImage.getHeight();
     const size_t mipLevels = size_t(std::log2f(width)) + 1;
 
+    JobSystem js;
+    js.adopt();
+
     if (hasRoughnessMap) {
         mipImages.resize(mipLevels);
         mipImages[0] = roughnessImage;
-        image::generateMipmaps(roughnessImage, image::Filter::BOX, &mipImages[1], mipLevels - 1);
+        image::generateMipmaps(js, roughnessImage, image::Filter::BOX,
+                &mipImages[1], mipLevels - 1);
     }
 
-    JobSystem js;
-    js.adopt();
-
     // For thread safety, we allocate each KTX blob now, before invoking the job system.
     image::KtxBundle bundle(mipLevels, 1, false);
     if (g_ktxContainer) {